@@ -34,7 +34,9 @@
 #include "JSClassRef.h"
 #include "JSGlobalObject.h"
 #include "JSObject.h"
+#include "JSRunLoopTimer.h"
 #include "JSCInlines.h"
+#include "ProfileCache.h"
 #include "SourceProvider.h"
 #include "StackVisitor.h"
 #include "Watchdog.h"
@@ -112,6 +114,56 @@ void JSContextGroupClearExecutionTimeLimit(JSContextGroupRef group)
         vm.watchdog()->setTimeLimit(Watchdog::noTimeLimit);
 }
 
+void JSContextGroupSetHeapLimits(JSContextGroupRef group, size_t softLimit, size_t hardLimit, JSHeapLimitCallback callback, void* context)
+{
+    VM& vm = *toJS(group);
+    JSLockHolder locker(&vm);
+    vm.heap.setHeapLimits(softLimit, hardLimit);
+    if (!callback) {
+        vm.heap.setHardHeapLimitCallback(nullptr);
+        return;
+    }
+    vm.heap.setHardHeapLimitCallback([callback, context] (ExecState* exec) {
+        return callback(toRef(exec), exec->vm().heap.heapSizeForLimits(), context);
+    });
+}
+
+size_t JSContextGroupGetHeapSize(JSContextGroupRef group)
+{
+    VM& vm = *toJS(group);
+    JSLockHolder locker(&vm);
+    return vm.heap.heapSizeForLimits();
+}
+
+size_t JSContextGroupShrinkFootprint(JSContextGroupRef group)
+{
+    VM& vm = *toJS(group);
+    JSLockHolder locker(&vm);
+    if (vm.entryScope) {
+        vm.shrinkFootprintWhenIdle();
+        return 0;
+    }
+    return vm.shrinkFootprint();
+}
+
+double JSContextGroupFireDueTimers(JSContextGroupRef group)
+{
+#if USE(CF)
+    UNUSED_PARAM(group);
+    return 0;
+#else
+    return JSRunLoopTimer::fireDueTimers(*toJS(group)).seconds();
+#endif
+}
+
+void JSContextGroupWriteProfileCache(JSContextGroupRef group)
+{
+    VM& vm = *toJS(group);
+    JSLockHolder locker(&vm);
+    if (ProfileCache* profileCache = vm.profileCache())
+        profileCache->write(vm);
+}
+
 // From the API's perspective, a global context remains alive iff it has been JSGlobalContextRetained.
 
 JSGlobalContextRef JSGlobalContextCreate(JSClassRef globalObjectClass)
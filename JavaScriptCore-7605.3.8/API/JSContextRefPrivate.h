@@ -94,6 +94,76 @@ JS_EXPORT void JSContextGroupSetExecutionTimeLimit(JSContextGroupRef group, doub
 */
 JS_EXPORT void JSContextGroupClearExecutionTimeLimit(JSContextGroupRef group) CF_AVAILABLE(10_6, 7_0);
 
+/*!
+@typedef JSHeapLimitCallback
+@abstract The callback invoked when a full garbage collection leaves more live memory than the
+ hard limit previously specified via JSContextGroupSetHeapLimits.
+@param ctx The execution context to use.
+@param heapSize The size of the heap in bytes, as compared against the limits.
+@param context User specified context data previously passed to JSContextGroupSetHeapLimits.
+@discussion If you return true, the running script will terminate. If you return false after
+ raising the limits with JSContextGroupSetHeapLimits, the script keeps running. Otherwise, the
+ script gets an OutOfMemoryError, which it can catch.
+*/
+typedef bool
+(*JSHeapLimitCallback) (JSContextRef ctx, size_t heapSize, void* context);
+
+/*!
+@function
+@abstract Sets the heap budget of a context group.
+@param group The JavaScript context group that these limits apply to.
+@param softLimit The heap size in bytes that the garbage collector tries to stay under by collecting
+ more often. Pass 0 for no soft limit.
+@param hardLimit The heap size in bytes that the live objects may not exceed. Pass 0 for no hard limit.
+@param callback The callback function that will be invoked when the hard limit has been exceeded.
+ If you pass a NULL callback, the running script gets an OutOfMemoryError.
+@param context User data that you can provide to be passed back to you in your callback.
+@discussion The heap size includes the objects themselves, their property and element storage,
+ and the memory that objects such as ArrayBuffers report to the garbage collector.
+*/
+JS_EXPORT void JSContextGroupSetHeapLimits(JSContextGroupRef group, size_t softLimit, size_t hardLimit, JSHeapLimitCallback callback, void* context);
+
+/*!
+@function
+@abstract Gets the heap size of a context group, as it is compared against the heap limits.
+@param group The JavaScript context group whose heap size you want to get.
+@result The size of the heap in bytes.
+*/
+JS_EXPORT size_t JSContextGroupGetHeapSize(JSContextGroupRef group);
+
+/*!
+@function
+@abstract Releases as much of the memory used by a context group as possible.
+@param group The JavaScript context group whose memory should be released.
+@result The number of bytes that were returned to the system.
+@discussion Throws away compiled code, bytecode and caches, all of which get recreated on demand,
+ then runs a full garbage collection and returns the freed memory to the system. If a script is
+ running in the group, the work is deferred until it returns and this function returns 0.
+*/
+JS_EXPORT size_t JSContextGroupShrinkFootprint(JSContextGroupRef group);
+
+/*!
+@function
+@abstract Runs the garbage collection and sweeping timers of a context group that are due.
+@param group The JavaScript context group whose timers should run.
+@result The number of seconds until the next timer of the group is due.
+@discussion Only embedders that set the useManualJSRunLoopTimers option need to call this.
+ Otherwise the timers fire on their own, either from the RunLoop of the thread that created
+ the group or from the timer thread when the useJSRunLoopTimerThread option is set. This
+ function always returns 0 on platforms that use CoreFoundation.
+*/
+JS_EXPORT double JSContextGroupFireDueTimers(JSContextGroupRef group);
+
+/*!
+@function
+@abstract Writes the profiles of the hot functions in a context group to the profile cache.
+@param group The JavaScript context group whose profiles should be written.
+@discussion Does nothing unless the profileCachePath option is set. The cache is also written when
+ the group is destroyed; embedders that are usually terminated instead can call this once they
+ have warmed up, so that the next process can tier up those functions early.
+*/
+JS_EXPORT void JSContextGroupWriteProfileCache(JSContextGroupRef group);
+
 /*!
 @function
 @abstract Gets a whether or not remote inspection is enabled on the context.
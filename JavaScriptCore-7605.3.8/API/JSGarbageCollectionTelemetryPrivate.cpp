@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2018 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "JSGarbageCollectionTelemetryPrivate.h"
+
+#include "APICast.h"
+#include "JSCInlines.h"
+
+using namespace JSC;
+
+bool JSContextGroupGetLastGarbageCollectionStatistics(JSContextGroupRef group, JSGarbageCollectionStatistics* statistics)
+{
+    VM* vm = toJS(group);
+    JSLockHolder locker(vm);
+    std::optional<GCTelemetry::Collection> collection = vm->heap.telemetry().lastCollection();
+    if (!collection)
+        return false;
+    *statistics = collection->statistics();
+    return true;
+}
+
+void JSContextGroupCopyGarbageCollectionHistogram(JSContextGroupRef group, JSGarbageCollectionHistogram kind, size_t* counts, bool reset)
+{
+    VM* vm = toJS(group);
+    JSLockHolder locker(vm);
+    GCTelemetry::Histogram histogram = vm->heap.telemetry().histogram(kind, reset);
+    for (unsigned bucket = 0; bucket < GCTelemetry::Histogram::numberOfBuckets; ++bucket)
+        counts[bucket] = histogram.count(bucket);
+}
+
+void JSContextGroupSetGarbageCollectionCallback(JSContextGroupRef group, JSGarbageCollectionCallback callback, void* userData)
+{
+    VM* vm = toJS(group);
+    JSLockHolder locker(vm);
+    vm->heap.telemetry().setCallback(callback, userData);
+}
+
+void JSContextGroupSetGarbageCollectionLatencyTarget(JSContextGroupRef group, double maximumPause, double minimumMutatorUtilization, double window)
+{
+    VM* vm = toJS(group);
+    JSLockHolder locker(vm);
+    if (!(maximumPause > 0)) {
+        vm->heap.setLatencyTarget(std::nullopt);
+        return;
+    }
+    vm->heap.setLatencyTarget(GCLatencyTarget { Seconds(maximumPause), minimumMutatorUtilization, Seconds(window) });
+}
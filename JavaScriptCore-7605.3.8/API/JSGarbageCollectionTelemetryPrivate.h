@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2018 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef JSGarbageCollectionTelemetryPrivate_h
+#define JSGarbageCollectionTelemetryPrivate_h
+
+#include <JavaScriptCore/JSContextRef.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!
+@struct JSGarbageCollectionStatistics
+@abstract What the garbage collector did during one collection. All durations are in seconds.
+@field isFullCollection Whether this was a full collection, as opposed to an eden collection.
+@field duration The time from the start of the collection to its end.
+@field beginPhaseDuration The time spent getting ready to mark.
+@field fixpointPhaseDuration The time spent marking and running marking constraints with the
+ world stopped.
+@field concurrentPhaseDuration The time spent marking while the mutator was running.
+@field reloopPhaseDuration The time spent deciding whether to stop the world again.
+@field endPhaseDuration The time spent finishing the collection with the world stopped.
+@field mutatorStoppedDuration The total time the mutator was stopped.
+@field maximumPauseDuration The longest single time the mutator was stopped.
+@field constraintSolvingDuration The time spent executing marking constraints.
+@field bytesVisited The number of bytes the collector visited.
+@field heapSizeBefore The size of the heap when the collection started, in bytes.
+@field heapSizeAfter The size of the heap when the collection ended, in bytes.
+@field pauseTargetViolationCount The number of pauses that were longer than the maximum pause of
+ the latency target set with JSContextGroupSetGarbageCollectionLatencyTarget.
+@field mutatorUtilizationViolationCount The number of pauses that left the mutator with less than
+ the minimum utilization of the latency target over the window that ended with the pause.
+@field minimumMutatorUtilization The lowest mutator utilization over a window of the latency target
+ that ended with one of the pauses, or 1 if there is no latency target.
+*/
+typedef struct {
+    bool isFullCollection;
+    double duration;
+    double beginPhaseDuration;
+    double fixpointPhaseDuration;
+    double concurrentPhaseDuration;
+    double reloopPhaseDuration;
+    double endPhaseDuration;
+    double mutatorStoppedDuration;
+    double maximumPauseDuration;
+    double constraintSolvingDuration;
+    size_t bytesVisited;
+    size_t heapSizeBefore;
+    size_t heapSizeAfter;
+    unsigned pauseTargetViolationCount;
+    unsigned mutatorUtilizationViolationCount;
+    double minimumMutatorUtilization;
+} JSGarbageCollectionStatistics;
+
+/*!
+@enum JSGarbageCollectionHistogram
+@constant kJSGarbageCollectionHistogramPauses The times the mutator was stopped.
+@constant kJSGarbageCollectionHistogramEdenCollections The durations of eden collections.
+@constant kJSGarbageCollectionHistogramFullCollections The durations of full collections.
+*/
+typedef enum {
+    kJSGarbageCollectionHistogramPauses,
+    kJSGarbageCollectionHistogramEdenCollections,
+    kJSGarbageCollectionHistogramFullCollections
+} JSGarbageCollectionHistogram;
+
+/*!
+@constant kJSGarbageCollectionHistogramBucketCount The number of buckets in a histogram. Bucket 0
+ counts durations under one microsecond and bucket i counts durations of at least 2^(i-1) and
+ under 2^i microseconds. The last bucket also counts everything that is longer.
+*/
+#define kJSGarbageCollectionHistogramBucketCount 24
+
+/*!
+@typedef JSGarbageCollectionCallback
+@abstract The callback invoked after garbage collections.
+@param group The context group whose heap was collected.
+@param statistics What the collector did during the most recent collection.
+@param userData The data passed to JSContextGroupSetGarbageCollectionCallback.
+@discussion The callback runs on the thread that holds the API lock, once the collector has
+ handed the heap back to it, so it must be quick. If several collections finish before that
+ thread gets to run it, only the last one is reported, but the histograms count all of them.
+*/
+typedef void (*JSGarbageCollectionCallback)(JSContextGroupRef group, const JSGarbageCollectionStatistics* statistics, void* userData);
+
+/*!
+@function
+@abstract Gets what the garbage collector did during the most recent collection.
+@param group The context group whose heap you are interested in.
+@param statistics The structure that is filled in.
+@result false if the heap has not been collected yet, in which case statistics is left alone.
+*/
+JS_EXPORT bool JSContextGroupGetLastGarbageCollectionStatistics(JSContextGroupRef group, JSGarbageCollectionStatistics* statistics);
+
+/*!
+@function
+@abstract Copies one of the latency histograms that the garbage collector keeps.
+@param group The context group whose heap you are interested in.
+@param histogram The histogram to copy.
+@param counts The array of kJSGarbageCollectionHistogramBucketCount counts that is filled in.
+@param reset If true, the histogram starts over after being copied. Copying with reset at a
+ regular interval gives a histogram for each interval.
+*/
+JS_EXPORT void JSContextGroupCopyGarbageCollectionHistogram(JSContextGroupRef group, JSGarbageCollectionHistogram histogram, size_t* counts, bool reset);
+
+/*!
+@function
+@abstract Sets the callback that is invoked after garbage collections.
+@param group The context group whose heap you are interested in.
+@param callback The callback, or NULL to remove the current one.
+@param userData The data to pass to the callback.
+*/
+JS_EXPORT void JSContextGroupSetGarbageCollectionCallback(JSContextGroupRef group, JSGarbageCollectionCallback callback, void* userData);
+
+/*!
+@function
+@abstract Sets the latency that the concurrent garbage collector schedules its pauses for.
+@param group The context group whose heap you are interested in.
+@param maximumPause The longest that the collector should stop the mutator for at a time, in
+ seconds. Pass 0 to go back to the default scheduling.
+@param minimumMutatorUtilization The share of every window, between 0 and 1, that the mutator
+ should get to run for while the collector is running.
+@param window The length of the windows that the mutator utilization is measured over, in seconds.
+@discussion The collector makes its pauses shorter and starts collecting earlier to meet the
+ target, but if the mutator allocates faster than the collector can keep up with, it stops the
+ mutator until the collection is done. JSGarbageCollectionStatistics reports the pauses that missed
+ the target. The new target takes effect when the next collection starts.
+*/
+JS_EXPORT void JSContextGroupSetGarbageCollectionLatencyTarget(JSContextGroupRef group, double maximumPause, double minimumMutatorUtilization, double window);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // JSGarbageCollectionTelemetryPrivate_h
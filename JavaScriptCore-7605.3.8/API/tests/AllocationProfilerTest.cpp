@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2018 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "AllocationProfilerTest.h"
+
+#include "APICast.h"
+#include "AllocationProfiler.h"
+#include "JSCInlines.h"
+#include "JavaScript.h"
+#include "Options.h"
+#include <stdio.h>
+
+#if ENABLE(SAMPLING_PROFILER)
+
+extern "C" void JSSynchronousGarbageCollectForDebugging(JSContextRef);
+
+using namespace JSC;
+
+static const unsigned sampleInterval = 16 * 1024;
+
+// These behave like the jsc shell functions of the same names.
+static JSValueRef startAllocationProfiler(JSContextRef context, JSObjectRef, JSObjectRef, size_t, const JSValueRef[], JSValueRef*)
+{
+    ExecState* exec = toJS(context);
+    JSLockHolder locker(exec);
+    exec->vm().ensureAllocationProfiler();
+    return JSValueMakeUndefined(context);
+}
+
+static JSValueRef allocationProfilerCallTree(JSContextRef context, JSObjectRef, JSObjectRef, size_t, const JSValueRef[], JSValueRef*)
+{
+    String json;
+    {
+        ExecState* exec = toJS(context);
+        JSLockHolder locker(exec);
+        if (AllocationProfiler* profiler = exec->vm().allocationProfiler())
+            json = profiler->callTreeAsJSON();
+    }
+    if (json.isNull())
+        return JSValueMakeNull(context);
+    JSStringRef string = JSStringCreateWithUTF8CString(json.utf8().data());
+    JSValueRef result = JSValueMakeFromJSONString(context, string);
+    JSStringRelease(string);
+    return result;
+}
+
+// Starts the profiler from a running script, the way a jsc user would, so the hot function only gets
+// compiled afterwards. Every twentieth result stays alive.
+static const char* const workloadScript =
+    "startAllocationProfiler();\n"
+    "function hotAllocator(count) {\n"
+    "    var result = [];\n"
+    "    for (var i = 0; i < count; ++i)\n"
+    "        result.push({ value: i, other: [i] });\n"
+    "    return result;\n"
+    "}\n"
+    "function coldAllocator() {\n"
+    "    return { cold: true };\n"
+    "}\n"
+    "var kept = [];\n"
+    "for (var i = 0; i < 200; ++i) {\n"
+    "    var result = hotAllocator(5000);\n"
+    "    if (!(i % 20))\n"
+    "        kept.push(result);\n"
+    "    coldAllocator();\n"
+    "}\n"
+    "kept.length === 10";
+
+// hotAllocator makes a million objects and arrays of at least 48 bytes together, and far fewer than a
+// kilobyte, so its estimated bytes have to fall in between.
+static const char* const callTreeScript =
+    "function nodes(node, name, result) {"
+    "    if (!name || node.functionName === name)"
+    "        result.push(node);"
+    "    node.children.forEach(function(child) { nodes(child, name, result); });"
+    "    return result;"
+    "}"
+    "function total(nodes, field) {"
+    "    var result = 0;"
+    "    nodes.forEach(function(node) { node.types.forEach(function(type) { result += type[field]; }); });"
+    "    return result;"
+    "}"
+    "var tree = allocationProfilerCallTree();"
+    "var hot = nodes(tree.root, 'hotAllocator', []);"
+    "var cold = nodes(tree.root, 'coldAllocator', []);"
+    "var hotBytes = total(hot, 'bytes');"
+    "var hotLiveBytes = total(hot, 'liveBytes');"
+    "tree.sampleInterval === 16384"
+    "    && tree.root.functionName === '(root)'"
+    "    && hot.length > 0"
+    "    && hot.every(function(node) { return node.url === 'allocation-profiler-test.js' && node.lineNumber >= 2 && node.lineNumber <= 6; })"
+    "    && hot.some(function(node) { return node.types.some(function(type) { return type.name === 'Object' && type.samples > 0; }); })"
+    "    && hotBytes > 1000000 * 48 / 2 && hotBytes < 1000000 * 1024"
+    "    && hotBytes > total(nodes(tree.root, null, []), 'bytes') / 2"
+    "    && hotBytes > 10 * total(cold, 'bytes')"
+    "    && hotLiveBytes > 0 && hotLiveBytes < hotBytes / 2";
+
+static bool evaluateScriptReturnsTrue(JSContextRef context, const char* source, const char* url)
+{
+    JSStringRef script = JSStringCreateWithUTF8CString(source);
+    JSStringRef sourceURL = url ? JSStringCreateWithUTF8CString(url) : nullptr;
+    JSValueRef exception = nullptr;
+    JSValueRef result = JSEvaluateScript(context, script, nullptr, sourceURL, 1, &exception);
+    JSStringRelease(script);
+    if (sourceURL)
+        JSStringRelease(sourceURL);
+    return !exception && JSValueIsBoolean(context, result) && JSValueToBoolean(context, result);
+}
+
+#endif // ENABLE(SAMPLING_PROFILER)
+
+int testAllocationProfiler()
+{
+    bool overallResult = true;
+    auto test = [&] (const char* description, bool currentResult) {
+        printf("    %s: %s\n", description, currentResult ? "PASS" : "FAIL");
+        overallResult &= currentResult;
+    };
+
+    printf("AllocationProfilerTest:\n");
+
+#if ENABLE(SAMPLING_PROFILER)
+    Options::initialize(); // Ensure options is initialized first.
+    unsigned oldSampleInterval = Options::allocationProfilerSampleInterval();
+    Options::allocationProfilerSampleInterval() = sampleInterval;
+
+    JSGlobalContextRef context = JSGlobalContextCreateInGroup(nullptr, nullptr);
+    JSObjectRef globalObject = JSContextGetGlobalObject(context);
+    JSStringRef name = JSStringCreateWithUTF8CString("startAllocationProfiler");
+    JSObjectSetProperty(context, globalObject, name, JSObjectMakeFunctionWithCallback(context, name, startAllocationProfiler), kJSPropertyAttributeNone, nullptr);
+    JSStringRelease(name);
+    name = JSStringCreateWithUTF8CString("allocationProfilerCallTree");
+    JSObjectSetProperty(context, globalObject, name, JSObjectMakeFunctionWithCallback(context, name, allocationProfilerCallTree), kJSPropertyAttributeNone, nullptr);
+    JSStringRelease(name);
+
+    test("no call tree before the profiler starts", evaluateScriptReturnsTrue(context, "allocationProfilerCallTree() === null", nullptr));
+    test("workload runs with the profiler started from a script", evaluateScriptReturnsTrue(context, workloadScript, "allocation-profiler-test.js"));
+
+    // Liveness is only brought up to date by a collection.
+    JSSynchronousGarbageCollectForDebugging(context);
+    test("the hot allocating function dominates the call tree", evaluateScriptReturnsTrue(context, callTreeScript, nullptr));
+
+    JSGlobalContextRelease(context);
+    Options::allocationProfilerSampleInterval() = oldSampleInterval;
+#endif
+
+    printf("AllocationProfilerTest: %s\n", overallResult ? "PASS" : "FAIL");
+    return !overallResult;
+}
@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2018 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "BytecodeCacheTest.h"
+
+#if OS(UNIX)
+
+#include "InitializeThreading.h"
+#include "JavaScript.h"
+#include "Options.h"
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using JSC::Options;
+
+static const char* bytecodeCacheTestScript =
+    "class Point {" "\n"
+    "    constructor(x, y) { this.x = x; this.y = y; }" "\n"
+    "    get length() { return Math.sqrt(this.x * this.x + this.y * this.y); }" "\n"
+    "}" "\n"
+    "function* count(n) { for (let i = 0; i < n; ++i) yield i; }" "\n"
+    "function classify(s) {" "\n"
+    "    switch (s) {" "\n"
+    "    case 'a': return 1;" "\n"
+    "    case 'b': return 2;" "\n"
+    "    default: return /^c+$/.test(s) ? 3 : 4;" "\n"
+    "    }" "\n"
+    "}" "\n"
+    "function run() {" "\n"
+    "    let total = 0;" "\n"
+    "    for (let i of count(5))" "\n"
+    "        total += i;" "\n"
+    "    total += new Point(3, 4).length;" "\n"
+    "    total += ['a', 'b', 'ccc', 'd'].map(classify).reduce((a, b) => a + b);" "\n"
+    "    try { null.x; } catch (e) { total += 100; }" "\n"
+    "    const tag = (strings) => strings.raw.join('|');" "\n"
+    "    return `${total}:${tag`x${1}y`}`;" "\n"
+    "}" "\n"
+    "run();";
+
+static const char* bytecodeCacheTestExpectedResult = "125:x|y";
+
+static bool evaluateBytecodeCacheTestScript()
+{
+    JSGlobalContextRef context = JSGlobalContextCreateInGroup(nullptr, nullptr);
+
+    JSStringRef script = JSStringCreateWithUTF8CString(bytecodeCacheTestScript);
+    JSValueRef exception = nullptr;
+    JSValueRef resultRef = JSEvaluateScript(context, script, nullptr, nullptr, 1, &exception);
+    JSStringRelease(script);
+
+    JSStringRef functionBody = JSStringCreateWithUTF8CString("return a * b;");
+    JSStringRef parameterNames[] = { JSStringCreateWithUTF8CString("a"), JSStringCreateWithUTF8CString("b") };
+    JSObjectRef function = JSObjectMakeFunction(context, nullptr, 2, parameterNames, functionBody, nullptr, 1, &exception);
+    JSStringRelease(functionBody);
+    JSStringRelease(parameterNames[0]);
+    JSStringRelease(parameterNames[1]);
+
+    bool succeeded = !exception && resultRef && JSValueIsString(context, resultRef);
+    if (succeeded) {
+        JSStringRef resultString = JSValueToStringCopy(context, resultRef, nullptr);
+        succeeded = JSStringIsEqualToUTF8CString(resultString, bytecodeCacheTestExpectedResult);
+        JSStringRelease(resultString);
+    }
+
+    if (succeeded && function) {
+        JSValueRef arguments[] = { JSValueMakeNumber(context, 6), JSValueMakeNumber(context, 7) };
+        JSValueRef product = JSObjectCallAsFunction(context, function, nullptr, 2, arguments, &exception);
+        succeeded = !exception && product && JSValueToNumber(context, product, nullptr) == 42;
+    } else
+        succeeded = false;
+
+    // Releasing the last context in the group destroys the VM, which flushes its code cache.
+    JSGlobalContextRelease(context);
+    return succeeded;
+}
+
+static unsigned countAndRemoveCacheFiles(const char* path, bool remove)
+{
+    unsigned count = 0;
+    DIR* directory = opendir(path);
+    if (!directory)
+        return 0;
+    while (struct dirent* entry = readdir(directory)) {
+        std::string name = entry->d_name;
+        if (name == "." || name == "..")
+            continue;
+        ++count;
+        if (remove)
+            unlink((std::string(path) + "/" + name).c_str());
+    }
+    closedir(directory);
+    return count;
+}
+
+int testBytecodeCache()
+{
+    bool failed = false;
+
+    JSC::initializeThreading();
+    Options::initialize(); // Ensure options is initialized first.
+
+    char directoryTemplate[] = "/tmp/testapi-bytecode-cache-XXXXXX";
+    char* directory = mkdtemp(directoryTemplate);
+    if (!directory) {
+        printf("FAIL: bytecode cache tests: could not create a cache directory.\n");
+        return true;
+    }
+
+    const char* oldDiskCachePath = Options::diskCachePath();
+    Options::diskCachePath() = directory;
+
+    // The first run populates the cache; the second must produce the same results from it.
+    if (!evaluateBytecodeCacheTestScript())
+        failed = true;
+    if (!countAndRemoveCacheFiles(directory, false))
+        failed = true;
+    if (!evaluateBytecodeCacheTestScript())
+        failed = true;
+
+    // A truncated cache file must be rejected rather than trusted.
+    if (DIR* cacheDirectory = opendir(directory)) {
+        while (struct dirent* entry = readdir(cacheDirectory)) {
+            std::string name = entry->d_name;
+            if (name == "." || name == "..")
+                continue;
+            std::string path = std::string(directory) + "/" + name;
+            struct stat fileStat;
+            if (!stat(path.c_str(), &fileStat))
+                truncate(path.c_str(), fileStat.st_size / 2);
+        }
+        closedir(cacheDirectory);
+    }
+    if (!evaluateBytecodeCacheTestScript())
+        failed = true;
+
+    countAndRemoveCacheFiles(directory, true);
+    rmdir(directory);
+    Options::diskCachePath() = oldDiskCachePath;
+
+    printf("%s: bytecode cache tests.\n", failed ? "FAIL" : "PASS");
+
+    return failed;
+}
+
+#endif // OS(UNIX)
@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2018 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "FireDueTimersTest.h"
+
+#include "JSContextRefPrivate.h"
+#include "JavaScript.h"
+#include "Options.h"
+#include <wtf/MonotonicTime.h>
+#include <wtf/Seconds.h>
+
+using namespace JSC;
+
+#if !USE(CF)
+
+static const unsigned numberOfFinalizableObjects = 1000;
+static unsigned finalizedObjectCount;
+
+static void finalize(JSObjectRef)
+{
+    finalizedObjectCount++;
+}
+
+static JSContextGroupRef createGroupWithManualTimers()
+{
+    bool oldUseManualJSRunLoopTimers = Options::useManualJSRunLoopTimers();
+    Options::useManualJSRunLoopTimers() = true;
+    JSContextGroupRef group = JSContextGroupCreate();
+    Options::useManualJSRunLoopTimers() = oldUseManualJSRunLoopTimers;
+    return group;
+}
+
+static void allocateGarbage(JSGlobalContextRef context, JSClassRef finalizableClass)
+{
+    // Enough garbage to get the eden timer scheduled soon, followed by objects whose finalizers only run once
+    // a collection has found them dead and the sweeper has swept their blocks.
+    JSStringRef script = JSStringCreateWithUTF8CString("(function() { for (var i = 0; i < 200; ++i) new Array(10000).fill(i); })()");
+    JSEvaluateScript(context, script, nullptr, nullptr, 1, nullptr);
+    JSStringRelease(script);
+
+    for (unsigned i = 0; i < numberOfFinalizableObjects; ++i)
+        JSObjectMake(context, finalizableClass, nullptr);
+}
+
+#endif // !USE(CF)
+
+int testFireDueTimers()
+{
+    bool overallResult = true;
+    auto test = [&] (const char* description, bool currentResult) {
+        printf("    %s: %s\n", description, currentResult ? "PASS" : "FAIL");
+        overallResult &= currentResult;
+    };
+
+    printf("FireDueTimersTest:\n");
+
+    Options::initialize(); // Ensure options is initialized first.
+
+#if USE(CF)
+    {
+        JSContextGroupRef group = JSContextGroupCreate();
+        test("timers are driven by the RunLoop", !JSContextGroupFireDueTimers(group));
+        JSContextGroupRelease(group);
+    }
+#else
+    JSClassDefinition definition = kJSClassDefinitionEmpty;
+    definition.className = "Finalizable";
+    definition.finalize = finalize;
+    JSClassRef finalizableClass = JSClassCreate(&definition);
+
+    {
+        JSContextGroupRef group = createGroupWithManualTimers();
+        JSGlobalContextRef context = JSGlobalContextCreateInGroup(group, nullptr);
+
+        finalizedObjectCount = 0;
+        allocateGarbage(context, finalizableClass);
+
+        // Nothing else runs the timers, so the GC timers have to collect the objects and the sweeper has to run their finalizers.
+        bool timeUntilNextTimerWasNeverNegative = true;
+        MonotonicTime deadline = MonotonicTime::now() + 20_s;
+        while (finalizedObjectCount < numberOfFinalizableObjects / 2 && MonotonicTime::now() < deadline) {
+            Seconds timeUntilNextTimer = Seconds(JSContextGroupFireDueTimers(group));
+            timeUntilNextTimerWasNeverNegative &= timeUntilNextTimer >= 0_s;
+            sleep(std::min(timeUntilNextTimer, 10_ms));
+        }
+        test("GC and sweeper timers ran the finalizers", finalizedObjectCount >= numberOfFinalizableObjects / 2);
+        test("time until the next timer is not negative", timeUntilNextTimerWasNeverNegative);
+
+        JSGlobalContextRelease(context);
+        JSContextGroupRelease(group);
+    }
+
+    {
+        // Destroy a group while its timers are still scheduled. Its timers must leave the queue before they are
+        // destroyed, since firing the timers of another group looks at every timer in the queue.
+        JSContextGroupRef group = createGroupWithManualTimers();
+        JSGlobalContextRef context = JSGlobalContextCreateInGroup(group, nullptr);
+        allocateGarbage(context, finalizableClass);
+        JSGlobalContextRelease(context);
+        JSContextGroupRelease(group);
+
+        JSContextGroupRef otherGroup = createGroupWithManualTimers();
+        JSGlobalContextRef otherContext = JSGlobalContextCreateInGroup(otherGroup, nullptr);
+        allocateGarbage(otherContext, finalizableClass);
+        test("firing timers after a group with scheduled timers was destroyed", JSContextGroupFireDueTimers(otherGroup) >= 0);
+        JSGlobalContextRelease(otherContext);
+        JSContextGroupRelease(otherGroup);
+    }
+
+    JSClassRelease(finalizableClass);
+#endif
+
+    printf("FireDueTimersTest: %s\n", overallResult ? "PASS" : "FAIL");
+    return !overallResult;
+}
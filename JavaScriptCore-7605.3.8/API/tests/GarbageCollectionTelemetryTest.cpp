@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2018 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "GarbageCollectionTelemetryTest.h"
+
+#include "JSGarbageCollectionTelemetryPrivate.h"
+#include "JavaScript.h"
+#include <stdio.h>
+
+extern "C" void JSSynchronousGarbageCollectForDebugging(JSContextRef);
+extern "C" void JSSynchronousEdenCollectForDebugging(JSContextRef);
+
+struct CallbackData {
+    JSContextGroupRef group;
+    unsigned callCount;
+    bool calledWithRightGroup;
+    JSGarbageCollectionStatistics lastStatistics;
+};
+
+static void garbageCollectionCallback(JSContextGroupRef group, const JSGarbageCollectionStatistics* statistics, void* userData)
+{
+    CallbackData* data = static_cast<CallbackData*>(userData);
+    data->callCount++;
+    data->calledWithRightGroup &= group == data->group;
+    data->lastStatistics = *statistics;
+}
+
+static size_t histogramTotal(JSContextGroupRef group, JSGarbageCollectionHistogram histogram, bool reset)
+{
+    size_t counts[kJSGarbageCollectionHistogramBucketCount];
+    JSContextGroupCopyGarbageCollectionHistogram(group, histogram, counts, reset);
+    size_t total = 0;
+    for (size_t count : counts)
+        total += count;
+    return total;
+}
+
+int testGarbageCollectionTelemetry()
+{
+    bool overallResult = true;
+    auto test = [&] (const char* description, bool currentResult) {
+        printf("    %s: %s\n", description, currentResult ? "PASS" : "FAIL");
+        overallResult &= currentResult;
+    };
+
+    printf("GarbageCollectionTelemetryTest:\n");
+
+    JSContextGroupRef group = JSContextGroupCreate();
+    JSGlobalContextRef context = JSGlobalContextCreateInGroup(group, nullptr);
+
+    {
+        JSGarbageCollectionStatistics statistics;
+        statistics.duration = -1;
+        bool hasStatistics = JSContextGroupGetLastGarbageCollectionStatistics(group, &statistics);
+        test("no statistics before the first collection", !hasStatistics && statistics.duration == -1);
+        test("empty histograms before the first collection", !histogramTotal(group, kJSGarbageCollectionHistogramPauses, false)
+            && !histogramTotal(group, kJSGarbageCollectionHistogramEdenCollections, false)
+            && !histogramTotal(group, kJSGarbageCollectionHistogramFullCollections, false));
+    }
+
+    CallbackData data { group, 0, true, { } };
+    JSContextGroupSetGarbageCollectionCallback(group, garbageCollectionCallback, &data);
+
+    JSSynchronousGarbageCollectForDebugging(context);
+    {
+        JSGarbageCollectionStatistics statistics;
+        bool hasStatistics = JSContextGroupGetLastGarbageCollectionStatistics(group, &statistics);
+        test("statistics after a full collection", hasStatistics && statistics.isFullCollection);
+        test("callback called once for a full collection", data.callCount == 1 && data.calledWithRightGroup && data.lastStatistics.isFullCollection);
+        test("callback gets the last statistics", hasStatistics && data.lastStatistics.duration == statistics.duration && data.lastStatistics.bytesVisited == statistics.bytesVisited);
+        test("collection took time and visited the heap", statistics.duration > 0 && statistics.bytesVisited > 0 && statistics.heapSizeBefore > 0 && statistics.heapSizeAfter > 0);
+        test("longest pause is part of the stopped time", statistics.mutatorStoppedDuration > 0 && statistics.maximumPauseDuration <= statistics.mutatorStoppedDuration);
+        test("no latency target violations without a target", !statistics.pauseTargetViolationCount && !statistics.mutatorUtilizationViolationCount && statistics.minimumMutatorUtilization == 1);
+    }
+
+    JSSynchronousEdenCollectForDebugging(context);
+    {
+        JSGarbageCollectionStatistics statistics;
+        bool hasStatistics = JSContextGroupGetLastGarbageCollectionStatistics(group, &statistics);
+        test("statistics after an eden collection", hasStatistics && !statistics.isFullCollection);
+        test("callback called once for an eden collection", data.callCount == 2 && data.calledWithRightGroup && !data.lastStatistics.isFullCollection);
+    }
+
+    test("full collection histogram", histogramTotal(group, kJSGarbageCollectionHistogramFullCollections, false) == 1);
+    test("eden collection histogram", histogramTotal(group, kJSGarbageCollectionHistogramEdenCollections, false) == 1);
+    test("every collection pauses at least once", histogramTotal(group, kJSGarbageCollectionHistogramPauses, false) >= 2);
+
+    test("copying with reset returns the counts", histogramTotal(group, kJSGarbageCollectionHistogramFullCollections, true) == 1);
+    test("histogram is empty after a reset", !histogramTotal(group, kJSGarbageCollectionHistogramFullCollections, false));
+    test("reset leaves the other histograms alone", histogramTotal(group, kJSGarbageCollectionHistogramEdenCollections, false) == 1);
+    JSSynchronousGarbageCollectForDebugging(context);
+    test("histogram counts again after a reset", histogramTotal(group, kJSGarbageCollectionHistogramFullCollections, false) == 1);
+
+    histogramTotal(group, kJSGarbageCollectionHistogramPauses, true);
+    test("pause histogram is empty after a reset", !histogramTotal(group, kJSGarbageCollectionHistogramPauses, false));
+    JSSynchronousEdenCollectForDebugging(context);
+    test("pause histogram counts again after a reset", histogramTotal(group, kJSGarbageCollectionHistogramPauses, false) >= 1);
+
+    unsigned callCountBeforeRemoval = data.callCount;
+    JSContextGroupSetGarbageCollectionCallback(group, nullptr, nullptr);
+    JSSynchronousGarbageCollectForDebugging(context);
+    test("callback not called after it is removed", data.callCount == callCountBeforeRemoval);
+
+    // Every pause misses a target this strict, both because it is too long and because it leaves the mutator
+    // with none of the window.
+    JSContextGroupSetGarbageCollectionLatencyTarget(group, 1e-6, 0.95, 1e-6);
+    histogramTotal(group, kJSGarbageCollectionHistogramPauses, true);
+    JSSynchronousGarbageCollectForDebugging(context);
+    {
+        JSGarbageCollectionStatistics statistics;
+        JSContextGroupGetLastGarbageCollectionStatistics(group, &statistics);
+        size_t pauseCount = histogramTotal(group, kJSGarbageCollectionHistogramPauses, false);
+        test("pauses over the maximum pause are violations", statistics.pauseTargetViolationCount >= 1 && statistics.pauseTargetViolationCount <= pauseCount);
+        test("pauses under the minimum utilization are violations", statistics.mutatorUtilizationViolationCount >= 1 && statistics.mutatorUtilizationViolationCount <= pauseCount);
+        test("minimum utilization is below the target", statistics.minimumMutatorUtilization < 0.95);
+    }
+
+    JSContextGroupSetGarbageCollectionLatencyTarget(group, 60, 0, 60);
+    JSSynchronousGarbageCollectForDebugging(context);
+    {
+        JSGarbageCollectionStatistics statistics;
+        JSContextGroupGetLastGarbageCollectionStatistics(group, &statistics);
+        test("no violations of a lenient target", !statistics.pauseTargetViolationCount && !statistics.mutatorUtilizationViolationCount);
+        test("utilization is measured with a lenient target", statistics.minimumMutatorUtilization > 0.5 && statistics.minimumMutatorUtilization < 1);
+    }
+
+    JSContextGroupSetGarbageCollectionLatencyTarget(group, 0, 0, 0);
+    JSSynchronousGarbageCollectForDebugging(context);
+    {
+        JSGarbageCollectionStatistics statistics;
+        JSContextGroupGetLastGarbageCollectionStatistics(group, &statistics);
+        test("no violations once the target is cleared", !statistics.pauseTargetViolationCount && !statistics.mutatorUtilizationViolationCount && statistics.minimumMutatorUtilization == 1);
+    }
+
+    JSGlobalContextRelease(context);
+    JSContextGroupRelease(group);
+
+    printf("GarbageCollectionTelemetryTest: %s\n", overallResult ? "PASS" : "FAIL");
+    return !overallResult;
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2018 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "HeapSnapshotStreamingTest.h"
+
+#include "APICast.h"
+#include "HeapProfiler.h"
+#include "HeapSnapshotBuilder.h"
+#include "JSCInlines.h"
+#include "JavaScript.h"
+#include "Options.h"
+#include <stdio.h>
+#include <wtf/text/StringBuilder.h>
+
+using namespace JSC;
+
+static unsigned chunkCount;
+
+// Writes one snapshot to a file, to a callback, and with json(), and returns the three results.
+static JSValueRef writeSnapshots(JSContextRef context, JSObjectRef, JSObjectRef, size_t, const JSValueRef[], JSValueRef* exception)
+{
+    ExecState* exec = toJS(context);
+    VM& vm = exec->vm();
+    JSLockHolder locker(vm);
+
+    HeapSnapshotBuilder snapshotBuilder(vm.ensureHeapProfiler());
+    snapshotBuilder.buildSnapshot();
+
+    FILE* file = tmpfile();
+    if (!file || !snapshotBuilder.writeJSON(file, [] (const HeapSnapshotNode&) { return true; })) {
+        if (file)
+            fclose(file);
+        return JSValueMakeUndefined(context);
+    }
+    Vector<char> utf8;
+    utf8.grow(ftell(file));
+    rewind(file);
+    bool readFile = fread(utf8.data(), 1, utf8.size(), file) == utf8.size();
+    fclose(file);
+    if (!readFile)
+        return JSValueMakeUndefined(context);
+
+    StringBuilder chunks;
+    chunkCount = 0;
+    snapshotBuilder.writeJSON([&] (const String& chunk) {
+        chunks.append(chunk);
+        chunkCount++;
+    }, [] (const HeapSnapshotNode&) { return true; });
+
+    JSValueRef results[] = {
+        toRef(exec, jsString(&vm, String::fromUTF8(utf8.data(), utf8.size()))),
+        toRef(exec, jsString(&vm, chunks.toString())),
+        toRef(exec, jsString(&vm, snapshotBuilder.json())),
+    };
+    return JSObjectMakeArray(context, 3, results, exception);
+}
+
+// Edges from the same node can be written in any order, and edge names are numbered in the order they
+// are first used, so compare the edges as a sorted list with their names filled in.
+static const char* const snapshotScript =
+    "var objects = [];"
+    "for (var i = 0; i < 5000; ++i) {"
+    "    var object = { index: i, π: 'π' + i, 日本: [i, 'ω'] };"
+    "    object['p' + (i % 100)] = object;"
+    "    objects.push(object);"
+    "}"
+    "function canonicalEdges(snapshot) {"
+    "    var edges = [];"
+    "    for (var i = 0; i < snapshot.edges.length; i += 4) {"
+    "        var type = snapshot.edgeTypes[snapshot.edges[i + 2]];"
+    "        var data = type === 'Property' || type === 'Variable' ? snapshot.edgeNames[snapshot.edges[i + 3]] : snapshot.edges[i + 3];"
+    "        edges.push([snapshot.edges[i], snapshot.edges[i + 1], type, data].join());"
+    "    }"
+    "    return edges.sort();"
+    "}"
+    "function sameSnapshot(a, b) {"
+    "    return a.version === b.version"
+    "        && JSON.stringify(a.nodes) === JSON.stringify(b.nodes)"
+    "        && JSON.stringify(a.nodeClassNames) === JSON.stringify(b.nodeClassNames)"
+    "        && JSON.stringify(a.edgeTypes) === JSON.stringify(b.edgeTypes)"
+    "        && JSON.stringify(canonicalEdges(a)) === JSON.stringify(canonicalEdges(b));"
+    "}"
+    "var snapshots = writeSnapshots();"
+    "var fromFile = JSON.parse(snapshots[0]);"
+    "var fromChunks = JSON.parse(snapshots[1]);"
+    "var fromString = JSON.parse(snapshots[2]);";
+
+int testHeapSnapshotStreaming()
+{
+    Options::initialize(); // Ensure options is initialized first.
+
+    bool overallResult = true;
+    auto test = [&] (const char* description, bool currentResult) {
+        printf("    %s: %s\n", description, currentResult ? "PASS" : "FAIL");
+        overallResult &= currentResult;
+    };
+
+    auto evaluate = [] (JSContextRef context, const char* source) {
+        JSStringRef script = JSStringCreateWithUTF8CString(source);
+        JSValueRef exception = nullptr;
+        JSValueRef result = JSEvaluateScript(context, script, nullptr, nullptr, 1, &exception);
+        JSStringRelease(script);
+        return !exception && JSValueToBoolean(context, result);
+    };
+
+    printf("HeapSnapshotStreamingTest:\n");
+
+    JSGlobalContextRef context = JSGlobalContextCreateInGroup(nullptr, nullptr);
+    JSStringRef name = JSStringCreateWithUTF8CString("writeSnapshots");
+    JSObjectSetProperty(context, JSContextGetGlobalObject(context), name, JSObjectMakeFunctionWithCallback(context, name, writeSnapshots), kJSPropertyAttributeNone, nullptr);
+    JSStringRelease(name);
+
+    test("the snapshot is written", evaluate(context, snapshotScript));
+    test("the snapshot is written in more than one chunk", chunkCount > 1);
+    test("the snapshot has non-ASCII edge names", evaluate(context, "fromString.edgeNames.indexOf('π') >= 0 && fromString.edgeNames.indexOf('日本') >= 0"));
+    test("writing to a file matches json()", evaluate(context, "sameSnapshot(fromFile, fromString)"));
+    test("writing in chunks matches json()", evaluate(context, "sameSnapshot(fromChunks, fromString)"));
+
+    JSGlobalContextRelease(context);
+
+    printf("HeapSnapshotStreamingTest: %s\n", overallResult ? "PASS" : "FAIL");
+    return !overallResult;
+}
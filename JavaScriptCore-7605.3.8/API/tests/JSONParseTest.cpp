@@ -29,11 +29,77 @@
 #include "JSCInlines.h"
 #include "JSGlobalObject.h"
 #include "JSONObject.h"
+#include "JavaScript.h"
 #include "VM.h"
 #include <wtf/RefPtr.h>
 
 using namespace JSC;
 
+struct JSONParseTestCase {
+    const char* description;
+    const char* script;
+};
+
+// LiteralParser builds objects whose keys match an earlier object straight from the earlier object's
+// structure. Each script returns true if the parsed objects are correct.
+static const JSONParseTestCase objectShapeTests[] = {
+    { "reused object shape", "var a = JSON.parse('[{\"x\":1,\"y\":\"s\"},{\"x\":2,\"y\":\"t\"},{\"x\":3,\"y\":\"u\"}]');"
+        "a.every((o, i) => o.x === i + 1 && Object.keys(o).join() === 'x,y') && a[1].y === 't'" },
+    { "same keys in a different order", "var a = JSON.parse('[{\"x\":1,\"y\":2},{\"y\":3,\"x\":4}]');"
+        "Object.keys(a[1]).join() === 'y,x' && a[1].x === 4 && a[1].y === 3" },
+    { "shape that is a prefix of an earlier shape", "var a = JSON.parse('[{\"x\":1,\"y\":2},{\"x\":3}]');"
+        "Object.keys(a[1]).join() === 'x' && a[1].x === 3" },
+    { "nested objects with the same keys", "var a = JSON.parse('[{\"a\":{\"a\":1,\"b\":2},\"b\":3},{\"a\":{\"a\":4,\"b\":5},\"b\":6}]');"
+        "a[1].a.a === 4 && a[1].a.b === 5 && a[1].b === 6 && a[0].a.b === 2" },
+    { "out-of-line properties", "var keys = []; for (var i = 0; i < 20; ++i) keys.push('p' + i);"
+        "var object = '{' + keys.map((k, i) => '\"' + k + '\":' + i).join() + '}';"
+        "var a = JSON.parse('[' + object + ',' + object + ',' + object + ']');"
+        "a.every(o => keys.every((k, i) => o[k] === i) && Object.keys(o).join() === keys.join())" },
+    { "__proto__ keys", "var a = JSON.parse('[{\"__proto__\":1,\"x\":2},{\"__proto__\":3,\"x\":4}]');"
+        "a.every(o => Object.getPrototypeOf(o) === Object.prototype && Object.keys(o).join() === '__proto__,x')"
+        "&& Object.getOwnPropertyDescriptor(a[1], '__proto__').value === 3 && a[1].x === 4" },
+    { "duplicate keys", "var a = JSON.parse('[{\"x\":1,\"y\":2},{\"x\":3,\"x\":4},{\"x\":5,\"y\":6,\"x\":7}]');"
+        "Object.keys(a[1]).join() === 'x' && a[1].x === 4 && Object.keys(a[2]).join() === 'x,y' && a[2].x === 7 && a[2].y === 6" },
+    { "repeated duplicate keys", "var a = JSON.parse('[{\"x\":1,\"x\":2},{\"x\":3,\"x\":4}]');"
+        "Object.keys(a[1]).join() === 'x' && a[0].x === 2 && a[1].x === 4" },
+    { "index keys", "var a = JSON.parse('[{\"0\":1,\"x\":2},{\"0\":3,\"x\":4}]');"
+        "a[1][0] === 3 && a[1].x === 4 && Object.keys(a[1]).join() === '0,x'" },
+    // The objects built by make() share their structure with the parsed objects. The DFG compiles
+    // getX() assuming that x is always an int32, so the parsed strings have to invalidate that.
+    { "inferred property types", "function make(x, y) { var o = new Object(); o.x = x; o.y = y; return o; }"
+        "function getX(o) { return o.x; }"
+        "for (var i = 0; i < 100000; ++i) getX(make(i, i));"
+        "var a = JSON.parse('[{\"x\":\"a\",\"y\":1},{\"x\":\"b\",\"y\":2}]');"
+        "var result = true; for (var i = 0; i < 100000; ++i) { if (getX(make(i, i)) !== i || getX(a[1]) !== 'b') result = false; }"
+        "result && a.map(getX).join() === 'a,b'" },
+};
+
+static bool evaluatesToTrue(JSGlobalContextRef context, const char* script)
+{
+    JSStringRef scriptString = JSStringCreateWithUTF8CString(script);
+    JSValueRef exception = nullptr;
+    JSValueRef result = JSEvaluateScript(context, scriptString, nullptr, nullptr, 1, &exception);
+    JSStringRelease(scriptString);
+    return !exception && JSValueIsBoolean(context, result) && JSValueToBoolean(context, result);
+}
+
+static int testJSONParseObjectShapes()
+{
+    bool failed = false;
+
+    for (const JSONParseTestCase& testCase : objectShapeTests) {
+        // Use a fresh context each time, so that no structures are shared between the tests.
+        JSGlobalContextRef context = JSGlobalContextCreate(nullptr);
+        bool passed = evaluatesToTrue(context, testCase.script);
+        JSGlobalContextRelease(context);
+
+        printf("%s: JSONParse %s test.\n", passed ? "PASS" : "FAIL", testCase.description);
+        failed = failed || !passed;
+    }
+
+    return failed;
+}
+
 int testJSONParse()
 {
     bool failed = false;
@@ -65,5 +131,7 @@ int testJSONParse()
     else
         printf("PASS: JSONParse String test.\n");
 
+    failed = testJSONParseObjectShapes() || failed;
+
     return failed;
 }
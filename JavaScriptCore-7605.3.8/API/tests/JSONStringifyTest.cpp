@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2018 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "JSONStringifyTest.h"
+
+#include "JavaScript.h"
+#include "Options.h"
+#include <wtf/text/CString.h>
+
+using JSC::Options;
+
+struct JSONStringifyTestCase {
+    const char* description;
+    const char* script;
+    const char* expected;
+};
+
+// Checks every character that JSON.stringify escapes, and a few that it doesn't, at each offset within
+// and across a 16-byte stride, in both 8-bit and 16-bit strings.
+static const char* const escapingScript =
+    "function escape(string) {"
+    "    var result = '\"';"
+    "    for (var i = 0; i < string.length; ++i) {"
+    "        var c = string.charCodeAt(i);"
+    "        var named = { 8: '\\\\b', 9: '\\\\t', 10: '\\\\n', 12: '\\\\f', 13: '\\\\r', 34: '\\\\\"', 92: '\\\\\\\\' }[c];"
+    "        if (named)"
+    "            result += named;"
+    "        else if (c < 0x20)"
+    "            result += '\\\\u' + c.toString(16).padStart(4, '0');"
+    "        else"
+    "            result += string[i];"
+    "    }"
+    "    return result + '\"';"
+    "}"
+    "var characters = ['\"', '\\\\', '\\b', '\\t', '\\n', '\\f', '\\r', '\\u0000', '\\u0001', '\\u001f', ' ', '/', '\\u007f', '\\u0080', '\\u00ff', '\\u0394', '\\u2028', '\\uffff'];"
+    "var result = true;"
+    "for (var padding of ['a', '\\u03b1']) {"
+    "    for (var character of characters) {"
+    "        for (var n = 0; n < 40; ++n) {"
+    "            var string = padding.repeat(n) + character + padding.repeat(40 - n);"
+    "            if (JSON.stringify(string) !== escape(string) || JSON.stringify([string]) !== '[' + escape(string) + ']'"
+    "                || JSON.stringify({ [string]: 0 }) !== '{' + escape(string) + ':0}')"
+    "                result = false;"
+    "            var run = character.repeat(n);"
+    "            if (JSON.stringify(run) !== escape(run))"
+    "                result = false;"
+    "        }"
+    "    }"
+    "}"
+    "String(result)";
+
+static const JSONStringifyTestCase stringifyTests[] = {
+    { "escaping", escapingScript, "true" },
+    { "8-bit and 16-bit strings", "JSON.stringify({ 'k\\u00e9y': 'v\\u00e9', 'k\\u0394': ['v\\u0394', 'a'.repeat(20) + '\\u0394'] })",
+        "{\"k\xc3\xa9y\":\"v\xc3\xa9\",\"k\xce\x94\":[\"v\xce\x94\",\"aaaaaaaaaaaaaaaaaaaa\xce\x94\"]}" },
+    { "numbers", "JSON.stringify([0, -0, 1.5, NaN, Infinity, -1e21, 1e-7, 2147483648, -2147483648])",
+        "[0,0,1.5,null,null,-1e+21,1e-7,2147483648,-2147483648]" },
+    { "objects with different shapes", "JSON.stringify([{ a: 1 }, { b: 2 }, { a: 3 }, { a: 4, b: { a: 5 } }])",
+        "[{\"a\":1},{\"b\":2},{\"a\":3},{\"a\":4,\"b\":{\"a\":5}}]" },
+    { "skipped property values", "JSON.stringify({ a: undefined, b: Symbol(), c: function() { }, d: 1, e: null })", "{\"d\":1,\"e\":null}" },
+    { "array elements written as null", "JSON.stringify([undefined, Symbol(), function() { }, null])", "[null,null,null,null]" },
+    { "deep nesting", "String(JSON.stringify(JSON.parse('['.repeat(1000) + ']'.repeat(1000))) === '['.repeat(1000) + ']'.repeat(1000))", "true" },
+    { "cycle", "(() => { var a = { b: [] }; a.b.push(a); try { JSON.stringify(a); } catch (e) { return String(e instanceof TypeError); } })()", "true" },
+
+    { "int32 array with holes", "JSON.stringify([1, , 3, , ])", "[1,null,3,null]" },
+    { "double array with holes", "JSON.stringify([1.5, , 3.5])", "[1.5,null,3.5]" },
+    { "contiguous array with holes", "JSON.stringify(['a', , {}])", "[\"a\",null,{}]" },
+    { "array of only holes", "JSON.stringify(new Array(3))", "[null,null,null]" },
+    { "array with trailing elements past a gap", "(() => { var a = [1, 2, 3]; a[6] = 4; return JSON.stringify(a); })()", "[1,2,3,null,null,null,4]" },
+    { "sparse array", "(() => { var a = []; a[100000] = 1; var json = JSON.stringify(a); return json.length + json.slice(-8); })()", "500003,null,1]" },
+    { "holes with an element on Array.prototype", "(() => { Array.prototype[1] = 'p'; return JSON.stringify([0, , 2]); })()", "[0,\"p\",2]" },
+    { "holes with an element on Object.prototype", "(() => { Object.prototype[1] = 'p'; return JSON.stringify([0.5, , 2.5]); })()", "[0.5,\"p\",2.5]" },
+
+    { "getter", "JSON.stringify({ a: 1, get b() { return 2; }, c: 3 })", "{\"a\":1,\"b\":2,\"c\":3}" },
+    { "getter on a nested object", "JSON.stringify([{ a: 1 }, { get a() { return 2; } }])", "[{\"a\":1},{\"a\":2}]" },
+    { "own toJSON", "JSON.stringify({ a: 1, b: { toJSON() { return 'x'; } } })", "{\"a\":1,\"b\":\"x\"}" },
+    { "toJSON on Object.prototype", "(() => { Object.prototype.toJSON = function() { return 'p'; }; return JSON.stringify([{ a: 1 }]); })()", "\"p\"" },
+    { "toJSON on Array.prototype", "(() => { Array.prototype.toJSON = function() { return 'p'; }; return JSON.stringify({ a: [1] }); })()", "{\"a\":\"p\"}" },
+    { "Date", "JSON.stringify({ d: new Date(0) })", "{\"d\":\"1970-01-01T00:00:00.000Z\"}" },
+    { "proxy", "JSON.stringify([new Proxy({ a: 1 }, { }), new Proxy({ a: 1 }, { get: () => 2 }), new Proxy([1, 2], { })])", "[{\"a\":1},{\"a\":2},[1,2]]" },
+    { "non-enumerable property", "JSON.stringify(Object.defineProperty({ a: 1, c: 3 }, 'b', { value: 2, enumerable: false }))", "{\"a\":1,\"c\":3}" },
+    { "indexed properties", "JSON.stringify({ b: 1, 2: 'x', 1: 'y', a: 2 })", "{\"1\":\"y\",\"2\":\"x\",\"b\":1,\"a\":2}" },
+    { "null prototype", "JSON.stringify(Object.assign(Object.create(null), { a: 1 }))", "{\"a\":1}" },
+    { "inherited enumerable property", "JSON.stringify(Object.assign(Object.create({ inherited: 1 }), { own: 2 }))", "{\"own\":2}" },
+    { "array with a named property", "JSON.stringify(Object.assign([1, 2], { x: 3 }))", "[1,2]" },
+    { "array subclass", "(() => { class A extends Array { } return JSON.stringify(A.of(1, 2)); })()", "[1,2]" },
+    { "boxed primitives", "JSON.stringify([new Number(1), new String('s'), new Boolean(false)])", "[1,\"s\",false]" },
+};
+
+static CString evaluateToString(JSGlobalContextRef context, const char* script)
+{
+    JSStringRef scriptString = JSStringCreateWithUTF8CString(script);
+    JSValueRef exception = nullptr;
+    JSValueRef result = JSEvaluateScript(context, scriptString, nullptr, nullptr, 1, &exception);
+    JSStringRelease(scriptString);
+    if (exception || !JSValueIsString(context, result))
+        return CString();
+
+    JSStringRef resultString = JSValueToStringCopy(context, result, nullptr);
+    size_t bufferSize = JSStringGetMaximumUTF8CStringSize(resultString);
+    auto buffer = std::make_unique<char[]>(bufferSize);
+    JSStringGetUTF8CString(resultString, buffer.get(), bufferSize);
+    JSStringRelease(resultString);
+    return CString(buffer.get());
+}
+
+int testJSONStringify()
+{
+    bool overallResult = true;
+
+    printf("JSONStringifyTest:\n");
+
+    Options::initialize(); // Ensure options is initialized first.
+    bool oldUseJSONFastStringify = Options::useJSONFastStringify();
+
+    for (const JSONStringifyTestCase& testCase : stringifyTests) {
+        // The fast path and the generic path have to produce the same result. Each run gets a fresh
+        // context, since some tests change the built-in prototypes.
+        bool currentResult = true;
+        for (bool useJSONFastStringify : { true, false }) {
+            Options::useJSONFastStringify() = useJSONFastStringify;
+            JSGlobalContextRef context = JSGlobalContextCreate(nullptr);
+            CString result = evaluateToString(context, testCase.script);
+            JSGlobalContextRelease(context);
+            currentResult &= !result.isNull() && !strcmp(result.data(), testCase.expected);
+        }
+        printf("    %s: %s\n", testCase.description, currentResult ? "PASS" : "FAIL");
+        overallResult &= currentResult;
+    }
+
+    Options::useJSONFastStringify() = oldUseJSONFastStringify;
+
+    printf("JSONStringifyTest: %s\n", overallResult ? "PASS" : "FAIL");
+    return !overallResult;
+}
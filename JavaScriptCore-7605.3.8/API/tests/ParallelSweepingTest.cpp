@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2018 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "ParallelSweepingTest.h"
+
+#include "APICast.h"
+#include "JSCInlines.h"
+#include "JSWeakObjectMapRefPrivate.h"
+#include "JavaScript.h"
+#include "Options.h"
+#include <stdio.h>
+#include <thread>
+
+extern "C" void JSSynchronousGarbageCollectForDebugging(JSContextRef);
+
+using namespace JSC;
+
+static const unsigned roundCount = 20;
+static const unsigned weakObjectsPerRound = 200;
+
+// Every round leaves a quarter of its objects alive, scattered among dead ones, so that most blocks are
+// neither full nor empty afterwards. Oversize typed arrays add weak finalizers that read their dead cells.
+static const char* const setupScript =
+    "var live = [];"
+    "function churn(round) {"
+    "    var garbage = [];"
+    "    for (var i = 0; i < 20000; ++i) {"
+    "        var object = { round: round, index: i, payload: [i, round] };"
+    "        if (i % 4)"
+    "            garbage.push(object);"
+    "        else"
+    "            live.push(object);"
+    "        if (!(i % 50)) {"
+    "            var array = new Float64Array(256);"
+    "            array[255] = round * 100000 + i;"
+    "            if (i % 100)"
+    "                garbage.push(array);"
+    "            else"
+    "                live.push(array);"
+    "        }"
+    "    }"
+    "    return garbage.length;"
+    "}"
+    "function verify(roundCount) {"
+    "    if (live.length !== roundCount * 5200)"
+    "        return false;"
+    "    for (var i = 0; i < live.length; ++i) {"
+    "        var value = live[i];"
+    "        if (value instanceof Float64Array) {"
+    "            if (value.length !== 256 || value[255] % 100 || value[0])"
+    "                return false;"
+    "        } else if (value.index % 4 || value.payload[0] !== value.index || value.payload[1] !== value.round)"
+    "            return false;"
+    "    }"
+    "    return true;"
+    "}";
+
+static double evaluateNumber(JSContextRef context, const char* source)
+{
+    JSStringRef script = JSStringCreateWithUTF8CString(source);
+    JSValueRef result = JSEvaluateScript(context, script, nullptr, nullptr, 1, nullptr);
+    JSStringRelease(script);
+    return result ? JSValueToNumber(context, result, nullptr) : -1;
+}
+
+static void* weakKey(unsigned index)
+{
+    return reinterpret_cast<void*>(static_cast<uintptr_t>(index + 1));
+}
+
+int testParallelSweeping()
+{
+    bool overallResult = true;
+    auto test = [&] (const char* description, bool currentResult) {
+        printf("    %s: %s\n", description, currentResult ? "PASS" : "FAIL");
+        overallResult &= currentResult;
+    };
+
+    printf("ParallelSweepingTest:\n");
+
+    Options::initialize(); // Ensure options is initialized first.
+    bool oldUseParallelSweeping = Options::useParallelSweeping();
+    bool oldScribbleFreeCells = Options::scribbleFreeCells();
+    Options::useParallelSweeping() = true;
+    // Helpers scribble over the dead cells they put on free lists, so anything that still reads one fails loudly.
+    Options::scribbleFreeCells() = true;
+
+    JSGlobalContextRef context = JSGlobalContextCreateInGroup(nullptr, nullptr);
+    VM& vm = toJS(context)->vm();
+    evaluateNumber(context, setupScript);
+    JSWeakObjectMapRef weakMap = JSWeakObjectMapCreate(context, nullptr, nullptr);
+    JSStringRef idName = JSStringCreateWithUTF8CString("id");
+
+    // Objects made through the API are plain objects, so they share blocks with the script's objects and
+    // put weak handles into them.
+    Vector<JSObjectRef> protectedObjects;
+    size_t blocksToPresweep = 0;
+    bool churned = true;
+    bool weakHandlesToLiveObjectsSurvive = true;
+    for (unsigned round = 0; round < roundCount; ++round) {
+        for (unsigned i = 0; i < weakObjectsPerRound; ++i) {
+            unsigned index = round * weakObjectsPerRound + i;
+            JSObjectRef object = JSObjectMake(context, nullptr, nullptr);
+            JSObjectSetProperty(context, object, idName, JSValueMakeNumber(context, index), kJSPropertyAttributeNone, nullptr);
+            JSWeakObjectMapSet(context, weakMap, weakKey(index), object);
+            if (!(i % 2)) {
+                JSValueProtect(context, object);
+                protectedObjects.append(object);
+            }
+        }
+
+        char source[32];
+        snprintf(source, sizeof(source), "churn(%u)", round);
+        churned &= evaluateNumber(context, source) == 15200;
+
+        JSSynchronousGarbageCollectForDebugging(context);
+        {
+            JSLockHolder locker(vm);
+            blocksToPresweep += vm.heap.objectSpace().numberOfBlocksToPresweep();
+        }
+
+        // On odd rounds the helpers get a head start, so the allocators mostly take finished free lists.
+        // On even rounds the script allocates right away, racing the helpers for the same blocks.
+        if (round % 2)
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+        for (size_t i = 0; i < protectedObjects.size(); ++i) {
+            JSObjectRef object = protectedObjects[i];
+            weakHandlesToLiveObjectsSurvive &= JSWeakObjectMapGet(context, weakMap, weakKey(2 * i)) == object
+                && JSValueToNumber(context, JSObjectGetProperty(context, object, idName, nullptr), nullptr) == 2 * i;
+        }
+    }
+
+    test("helper threads are given blocks to sweep", Options::numberOfGCMarkers() <= 1 || blocksToPresweep);
+    test("scripts allocate while helper threads sweep", churned);
+
+    char source[32];
+    snprintf(source, sizeof(source), "verify(%u)", roundCount);
+    test("live objects are intact", evaluateNumber(context, source) == 1);
+    test("weak handles to live objects survive", weakHandlesToLiveObjectsSurvive);
+
+    for (JSObjectRef object : protectedObjects)
+        JSValueUnprotect(context, object);
+    protectedObjects.clear();
+    JSSynchronousGarbageCollectForDebugging(context);
+    unsigned clearedCount = 0;
+    for (unsigned index = 0; index < roundCount * weakObjectsPerRound; ++index)
+        clearedCount += !JSWeakObjectMapGet(context, weakMap, weakKey(index));
+    test("weak handles to dead objects are cleared", clearedCount > roundCount * weakObjectsPerRound / 2);
+    test("live objects are intact after a final collection", evaluateNumber(context, source) == 1);
+
+    JSStringRelease(idName);
+    JSGlobalContextRelease(context);
+    Options::useParallelSweeping() = oldUseParallelSweeping;
+    Options::scribbleFreeCells() = oldScribbleFreeCells;
+
+    printf("ParallelSweepingTest: %s\n", overallResult ? "PASS" : "FAIL");
+    return !overallResult;
+}
@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2018 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "PretenuringTest.h"
+
+#include "APICast.h"
+#include "JSCInlines.h"
+#include "JavaScript.h"
+#include "Options.h"
+#include <stdio.h>
+
+extern "C" void JSSynchronousGarbageCollectForDebugging(JSContextRef);
+extern "C" void JSSynchronousEdenCollectForDebugging(JSContextRef);
+
+using namespace JSC;
+
+static JSValueRef edenGC(JSContextRef context, JSObjectRef, JSObjectRef, size_t, const JSValueRef[], JSValueRef*)
+{
+    JSSynchronousEdenCollectForDebugging(context);
+    return JSValueMakeUndefined(context);
+}
+
+static JSValueRef fullGC(JSContextRef context, JSObjectRef, JSObjectRef, size_t, const JSValueRef[], JSValueRef*)
+{
+    JSSynchronousGarbageCollectForDebugging(context);
+    return JSValueMakeUndefined(context);
+}
+
+// Objects start out in eden, so an object that is already PossiblyBlack before any collection saw it
+// was pretenured.
+static JSValueRef isOld(JSContextRef context, JSObjectRef, JSObjectRef, size_t argumentCount, const JSValueRef arguments[], JSValueRef*)
+{
+    ExecState* exec = toJS(context);
+    JSLockHolder locker(exec);
+    JSValue value = argumentCount ? toJS(exec, arguments[0]) : jsUndefined();
+    return JSValueMakeBoolean(context, value.isCell() && value.asCell()->cellState() == CellState::PossiblyBlack);
+}
+
+static void addFunction(JSContextRef context, const char* name, JSObjectCallAsFunctionCallback callback)
+{
+    JSStringRef string = JSStringCreateWithUTF8CString(name);
+    JSObjectRef function = JSObjectMakeFunctionWithCallback(context, string, callback);
+    JSObjectSetProperty(context, JSContextGetGlobalObject(context), string, function, kJSPropertyAttributeNone, nullptr);
+    JSStringRelease(string);
+}
+
+static JSValueRef evaluate(JSContextRef context, const char* source)
+{
+    JSStringRef script = JSStringCreateWithUTF8CString(source);
+    JSValueRef exception = nullptr;
+    JSValueRef result = JSEvaluateScript(context, script, nullptr, nullptr, 1, &exception);
+    JSStringRelease(script);
+    return exception ? nullptr : result;
+}
+
+static bool evaluatesToTrue(JSContextRef context, const char* source)
+{
+    JSValueRef result = evaluate(context, source);
+    return result && JSValueIsBoolean(context, result) && JSValueToBoolean(context, result);
+}
+
+// make() is the allocation site. Every object it returns is retained, so its samples survive and the
+// optimizing JITs pretenure it. Each object points at a young object that was allocated before it,
+// and at another one stored right after it was allocated, which is where the barrier could be elided.
+static const char* const setupScript =
+    "var retained = [];"
+    "var garbage;"
+    "function make(value) { var object = { value: value, next: null }; object.next = { value: -value }; return object; }"
+    "function allocate(count) {"
+    "    for (var i = 0; i < count; ++i) {"
+    "        retained.push(make(retained.length));"
+    "        garbage = { value: i };"
+    "    }"
+    "}"
+    "function check() {"
+    "    for (var i = 0; i < retained.length; ++i) {"
+    "        if (retained[i].value !== i || retained[i].next.value !== -i)"
+    "            return false;"
+    "    }"
+    "    return true;"
+    "}"
+    "allocate(10);"
+    "edenGC();"
+    "edenGC();"
+    "for (var round = 0; round < 20; ++round) {"
+    "    allocate(1000);"
+    "    edenGC();"
+    "}"
+    "var pretenuredCount = 0;"
+    "for (var i = 0; i < 1000; ++i) {"
+    "    var object = make(retained.length);"
+    "    if (isOld(object))"
+    "        pretenuredCount++;"
+    "    retained.push(object);"
+    "}"
+    "check()";
+
+// Old objects, pretenured or not, now point at young objects that only the remembered set knows about.
+// The garbage reuses the memory of anything that an eden collection wrongly freed.
+static const char* const storeYoungIntoOldScript =
+    "for (var i = 0; i < retained.length; i += 2)"
+    "    retained[i].next = { value: -i };"
+    "edenGC();"
+    "for (var i = 0; i < 100000; ++i)"
+    "    garbage = { value: 0, next: null };"
+    "edenGC();"
+    "check()";
+
+int testPretenuring()
+{
+    bool overallResult = true;
+    auto test = [&] (const char* description, bool currentResult) {
+        printf("    %s: %s\n", description, currentResult ? "PASS" : "FAIL");
+        overallResult &= currentResult;
+    };
+
+    printf("PretenuringTest:\n");
+
+    Options::initialize(); // Ensure options is initialized first.
+    test("pretenuring is off by default", !Options::usePretenuring());
+
+    bool oldUsePretenuring = Options::usePretenuring();
+    unsigned oldAllocationSiteSamplingInterval = Options::allocationSiteSamplingInterval();
+    unsigned oldPretenuringSampleWindow = Options::pretenuringSampleWindow();
+    Options::usePretenuring() = true;
+    Options::allocationSiteSamplingInterval() = 0;
+    Options::pretenuringSampleWindow() = 1;
+
+    JSGlobalContextRef context = JSGlobalContextCreateInGroup(nullptr, nullptr);
+    addFunction(context, "edenGC", edenGC);
+    addFunction(context, "fullGC", fullGC);
+    addFunction(context, "isOld", isOld);
+
+    test("objects survive eden collections", evaluatesToTrue(context, setupScript));
+    if (Options::useJIT())
+        test("a site whose objects survive gets pretenured", evaluatesToTrue(context, "pretenuredCount > 0"));
+    test("young objects stored into old ones survive eden collections", evaluatesToTrue(context, storeYoungIntoOldScript));
+    test("objects survive a full collection", evaluatesToTrue(context, "fullGC(); check()"));
+    test("objects survive an eden collection after a full one", evaluatesToTrue(context, "allocate(1000); edenGC(); fullGC(); edenGC(); check()"));
+
+    JSGlobalContextRelease(context);
+
+    Options::usePretenuring() = oldUsePretenuring;
+    Options::allocationSiteSamplingInterval() = oldAllocationSiteSamplingInterval;
+    Options::pretenuringSampleWindow() = oldPretenuringSampleWindow;
+
+    printf("PretenuringTest: %s\n", overallResult ? "PASS" : "FAIL");
+    return !overallResult;
+}
@@ -0,0 +1,221 @@
+/*
+ * Copyright (C) 2018 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "RegExpMatchingTest.h"
+
+#include "APICast.h"
+#include "JSCInlines.h"
+#include "JavaScript.h"
+#include "Options.h"
+#include <wtf/text/StringConcatenate.h>
+
+using namespace JSC;
+
+struct RegExpTestCase {
+    const char* description;
+    const char* match;
+    const char* expected;
+};
+
+// Backreferences and quantified groups that used to run in the interpreter.
+static const RegExpTestCase jitCompiledPatternTests[] = {
+    { "backreference", "/(a)\\1/.exec('xaab')", "['aa', 'a']" },
+    { "backreference before its group", "/\\1(a)/.exec('ba')", "['a', 'a']" },
+    { "backreference to a group that didn't participate", "/(?:(a)|b)\\1c/.exec('bc')", "['bc', undefined]" },
+    { "case-insensitive backreference", "/(abc)\\1/i.exec('xabcABCx')", "['abcABC', 'abc']" },
+    { "case-insensitive non-ASCII backreference", "/(\\u00e9)\\1/i.exec('\\u00e9\\u00c9')", "['\\u00e9\\u00c9', '\\u00e9']" },
+    { "unicode backreference", "/(\\u{1F600}+)\\1/u.exec('\\u{1F600}'.repeat(4))", "['\\u{1F600}'.repeat(4), '\\u{1F600}'.repeat(2)]" },
+    { "unicode case-insensitive backreference", "/(\\u212a)\\1/ui.exec('x\\u212ak')", "['\\u212ak', '\\u212a']" },
+    { "greedy quantified backreference", "/(a|b)\\1+c/.exec('abbbc')", "['bbbc', 'b']" },
+    { "non-greedy quantified backreference", "/(a)\\1*?b/.exec('aaab')", "['aaab', 'a']" },
+    { "fixed count backreference", "/(ab)\\1{2}/.exec('abababab')", "['ababab', 'ab']" },
+    { "named backreference", "/(?<x>o)\\k<x>/.exec('foo')", "['oo', 'o']" },
+    { "backreference in a quantified group", "/((\\w)\\2)+/.exec('aabbcd')", "['aabb', 'bb', 'b']" },
+    { "nested quantified groups", "/(z)((a+)?(b+)?(c))*/.exec('zaacbbbcac')", "['zaacbbbcac', 'z', 'ac', 'a', undefined, 'c']" },
+    { "captures cleared between iterations", "/(?:(a)|b){2,}/.exec('abab')", "['abab', undefined]" },
+    { "non-greedy group with a minimum count", "/(a+?){2,3}?/.exec('aaaa')", "['aa', 'a']" },
+    { "non-greedy group inside a greedy group", "/((a|b){2,3}?c)+/.exec('abcbbac')", "['abcbbac', 'bbac', 'a']" },
+    { "non-greedy star group", "/(?:(\\d+)-)*?(\\d+)$/.exec('1-22-333')", "['1-22-333', '22', '333']" },
+};
+
+// Patterns whose JIT code scans ahead for a required literal or for the characters a match can start with.
+static const RegExpTestCase literalScanTests[] = {
+    { "required literal after generic parentheses", "/(\\w+\\s)*ERROR: /.exec('word '.repeat(2000) + 'ERROR: ')", "['word '.repeat(2000) + 'ERROR: ', 'word ']" },
+    { "missing required literal after generic parentheses", "/(\\w+\\s)*ERROR: /.exec('word '.repeat(2000))", "null" },
+    { "required literal after generic parentheses, 16-bit", "/(\\w+\\s)*\\u0394RROR: /.exec('word '.repeat(2000) + '\\u0394RROR: ').index", "0" },
+    { "required literal preceded by a partial literal", "/\\d+ERROR/.exec('1'.repeat(50) + 'ERRO 2ERROR')", "['2ERROR']" },
+    { "required literal at the end of the input", "/a(b|c)*xyz/.exec('abcbxyz')", "['abcbxyz', 'b']" },
+    { "required literal after lastIndex", "(r => { r.lastIndex = 5; return r.exec('xyz12xyz3'); })(/xyz\\d/g)", "['xyz3']" },
+    { "required literal before lastIndex", "(r => { r.lastIndex = 5; return r.exec('xyz12'); })(/xyz\\d/g)", "null" },
+    { "leading character", "/x\\d+/.exec('a'.repeat(100) + 'x12').index", "100" },
+    { "leading character, 16-bit", "/x\\d+/.exec('\\u0100'.repeat(100) + 'x12').index", "100" },
+    { "non-Latin-1 leading character", "/\\u0394\\d/.exec('a'.repeat(50) + '\\u03945').index", "50" },
+    { "two leading characters", "/(?:ab|cd)e/.exec('x'.repeat(40) + 'abxcde').index", "43" },
+    { "leading character around 16-byte boundaries", "[0, 1, 14, 15, 16, 17, 31, 32, 33].every(n => /q\\d/.exec('z'.repeat(n) + 'q1').index === n)", "true" },
+    { "leading character around 16-byte boundaries, 16-bit", "[0, 1, 6, 7, 8, 9, 15, 16, 17].every(n => /q\\d/.exec('\\u0100'.repeat(n) + 'q1').index === n)", "true" },
+    { "leading character in a run of partial matches", "/qr/.exec('q'.repeat(20) + 'qr').index", "20" },
+    { "leading character with sticky flag", "/x\\d/y.exec('ax1')", "null" },
+    { "leading character with sticky flag and lastIndex", "(r => { r.lastIndex = 1; return r.exec('ax1'); })(/x\\d/y)", "['x1']" },
+    { "leading character with multiline flag", "/^x\\d/m.exec('aaa\\nbbb\\nx1').index", "8" },
+    { "leading character not at a line start", "/^x/m.exec('ax\\nx').index", "3" },
+};
+
+// Patterns that exhaust the backtracking budget, so that the match is rerun by the linear matcher.
+static const RegExpTestCase catastrophicPatternTests[] = {
+    { "nested plus without a match", "/(a+)+b/.exec('a'.repeat(40))", "null" },
+    { "nested plus matching late", "/(a+)+b/.exec('a'.repeat(30) + 'cab')", "['ab', 'a']" },
+    { "nested plus with two atoms", "/(x+x+)+y/.exec('x'.repeat(32))", "null" },
+    { "overlapping alternatives", "/((a|aa)+)c/.exec('a'.repeat(40) + 'bac')", "['ac', 'a', 'a']" },
+    { "words and optional spaces", "/(?:(\\w+)\\s?)*;/.exec('word '.repeat(20) + 'x!word word;')", "['word word;', 'word']" },
+    { "case-insensitive nested plus", "/(A+)+B/i.exec('a'.repeat(30) + 'cab')", "['ab', 'a']" },
+    { "unicode nested plus", "/(\\u{1F600}+)+!/u.exec('\\u{1F600}'.repeat(30) + '?\\u{1F600}!')", "['\\u{1F600}!', '\\u{1F600}']" },
+    { "anchored nested star", "/^(\\w+\\s?)*$/.exec('hello world '.repeat(10) + '!')", "null" },
+};
+
+// Matches that both engines handle quickly. The linear matcher must agree with the backtracking engines on
+// these, or refuse to compile the pattern.
+static const char* const linearMatcherComparisons[] = {
+    "/(a)?(b)?c/.exec('xbc')",
+    "/(?:(a)|(b))+/.exec('ab')",
+    "/((a)|b)+?c/.exec('abac')",
+    "/(a|ab)(c|bcd)(d*)/.exec('abcd')",
+    "/(z)((a+)?(b+)?(c))*/.exec('zaacbbbcac')",
+    "/((\\w)\\w?){2,3}?x/.exec('abcdx')",
+    "/\\bfoo\\b/.exec('a foo b')",
+    "/^b+$/m.exec('aaa\\nbbb\\nccc')",
+    "/(\\w+)\\s(\\w+)?/.exec('one ')",
+    "/[a-c]{2}(d)?/i.exec('xABd')",
+    "/\\B\\u{1F600}/u.exec('a\\u{1F600}')",
+    "/\\u{1F600}\\b/u.exec('\\u{1F600}a')",
+    "/^.{2}$/u.exec('\\u{1F600}\\u{1F600}')",
+    "/[^x]{3}/u.exec('\\u{1F600}ab')",
+    "/(\\u{1F600}|a)+b/u.exec('a\\u{1F600}ab')",
+};
+
+static bool evaluatesToTrue(JSGlobalContextRef context, const CString& script)
+{
+    JSStringRef scriptString = JSStringCreateWithUTF8CString(script.data());
+    JSValueRef exception = nullptr;
+    JSValueRef result = JSEvaluateScript(context, scriptString, nullptr, nullptr, 1, &exception);
+    JSStringRelease(scriptString);
+    return !exception && JSValueIsBoolean(context, result) && JSValueToBoolean(context, result);
+}
+
+static JSStringRef evaluateToJSON(JSGlobalContextRef context, const char* expression)
+{
+    JSStringRef scriptString = JSStringCreateWithUTF8CString(makeString("JSON.stringify(", expression, ")").utf8().data());
+    JSValueRef exception = nullptr;
+    JSValueRef result = JSEvaluateScript(context, scriptString, nullptr, nullptr, 1, &exception);
+    JSStringRelease(scriptString);
+    if (exception)
+        return nullptr;
+    return JSValueToStringCopy(context, result, nullptr);
+}
+
+static bool matchesExpected(JSGlobalContextRef context, const RegExpTestCase& testCase)
+{
+    return evaluatesToTrue(context, makeString("JSON.stringify(", testCase.match, ") === JSON.stringify(", testCase.expected, ")").utf8());
+}
+
+int testRegExpMatching()
+{
+    bool overallResult = true;
+
+    printf("RegExpMatchingTest:\n");
+
+    auto test = [&] (const char* description, bool currentResult) {
+        printf("    %s: %s\n", description, currentResult ? "PASS" : "FAIL");
+        overallResult &= currentResult;
+    };
+
+    {
+        JSContextGroupRef group = JSContextGroupCreate();
+        JSGlobalContextRef context = JSGlobalContextCreateInGroup(group, nullptr);
+        VM& vm = *toJS(group);
+        unsigned fallbacksBefore = vm.regExpInterpreterFallbackCount;
+
+        for (const RegExpTestCase& testCase : jitCompiledPatternTests)
+            test(testCase.description, matchesExpected(context, testCase));
+        for (const RegExpTestCase& testCase : literalScanTests)
+            test(testCase.description, matchesExpected(context, testCase));
+
+#if ENABLE(YARR_JIT) && (CPU(X86_64) || CPU(ARM64))
+        if (VM::canUseRegExpJIT())
+            test("backreferences and quantified groups don't fall back to the interpreter", vm.regExpInterpreterFallbackCount == fallbacksBefore);
+#else
+        UNUSED_PARAM(fallbacksBefore);
+#endif
+
+        JSGlobalContextRelease(context);
+        JSContextGroupRelease(group);
+    }
+
+    Options::initialize(); // Ensure options is initialized first.
+    bool oldForceLinearRegExpMatcher = Options::forceLinearRegExpMatcher();
+
+    // Each context group has its own VM, so the two groups don't share compiled RegExps.
+    Options::forceLinearRegExpMatcher() = false;
+    JSContextGroupRef backtrackingGroup = JSContextGroupCreate();
+    JSGlobalContextRef backtrackingContext = JSGlobalContextCreateInGroup(backtrackingGroup, nullptr);
+    Options::forceLinearRegExpMatcher() = true;
+    JSContextGroupRef linearGroup = JSContextGroupCreate();
+    JSGlobalContextRef linearContext = JSGlobalContextCreateInGroup(linearGroup, nullptr);
+
+    auto compareEngines = [&] (const char* description, const char* expression, const char* expected) {
+        Options::forceLinearRegExpMatcher() = false;
+        JSStringRef backtrackingResult = evaluateToJSON(backtrackingContext, expression);
+        Options::forceLinearRegExpMatcher() = true;
+        JSStringRef linearResult = evaluateToJSON(linearContext, expression);
+
+        bool result = backtrackingResult && linearResult && JSStringIsEqual(backtrackingResult, linearResult);
+        if (result && expected) {
+            JSStringRef expectedResult = evaluateToJSON(linearContext, expected);
+            result = expectedResult && JSStringIsEqual(linearResult, expectedResult);
+            if (expectedResult)
+                JSStringRelease(expectedResult);
+        }
+        test(description, result);
+
+        if (backtrackingResult)
+            JSStringRelease(backtrackingResult);
+        if (linearResult)
+            JSStringRelease(linearResult);
+    };
+
+    for (const RegExpTestCase& testCase : catastrophicPatternTests)
+        compareEngines(testCase.description, testCase.match, testCase.expected);
+    for (const char* expression : linearMatcherComparisons)
+        compareEngines(expression, expression, nullptr);
+
+    Options::forceLinearRegExpMatcher() = oldForceLinearRegExpMatcher;
+    JSGlobalContextRelease(linearContext);
+    JSContextGroupRelease(linearGroup);
+    JSGlobalContextRelease(backtrackingContext);
+    JSContextGroupRelease(backtrackingGroup);
+
+    printf("RegExpMatchingTest: %s\n", overallResult ? "PASS" : "FAIL");
+    return !overallResult;
+}
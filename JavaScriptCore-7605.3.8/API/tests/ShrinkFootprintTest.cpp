@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2018 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "ShrinkFootprintTest.h"
+
+#include "JSContextRefPrivate.h"
+#include "JSGarbageCollectionTelemetryPrivate.h"
+#include "JavaScript.h"
+#include <stdio.h>
+#include <wtf/MemoryPressureHandler.h>
+
+static unsigned fullCollectionCount;
+static unsigned fullCollectionCountDuringScript;
+
+static void countFullCollections(JSContextGroupRef, const JSGarbageCollectionStatistics* statistics, void*)
+{
+    if (statistics->isFullCollection)
+        fullCollectionCount++;
+}
+
+static JSValueRef shrinkFootprint(JSContextRef context, JSObjectRef, JSObjectRef, size_t, const JSValueRef[], JSValueRef*)
+{
+    size_t result = JSContextGroupShrinkFootprint(JSContextGetGroup(context));
+    fullCollectionCountDuringScript = fullCollectionCount;
+    return JSValueMakeNumber(context, result);
+}
+
+static JSValueRef simulateLowMemory(JSContextRef context, JSObjectRef, JSObjectRef, size_t, const JSValueRef[], JSValueRef*)
+{
+    WTF::MemoryPressureHandler::singleton().releaseMemory(WTF::Critical::Yes, WTF::Synchronous::Yes);
+    fullCollectionCountDuringScript = fullCollectionCount;
+    return JSValueMakeUndefined(context);
+}
+
+static JSValueRef evaluate(JSContextRef context, const char* source)
+{
+    JSStringRef script = JSStringCreateWithUTF8CString(source);
+    JSValueRef exception = nullptr;
+    JSValueRef result = JSEvaluateScript(context, script, nullptr, nullptr, 1, &exception);
+    JSStringRelease(script);
+    return exception ? nullptr : result;
+}
+
+static bool evaluatesToNumber(JSContextRef context, const char* source, double expected)
+{
+    JSValueRef result = evaluate(context, source);
+    return result && JSValueIsNumber(context, result) && JSValueToNumber(context, result, nullptr) == expected;
+}
+
+int testShrinkFootprint()
+{
+    bool overallResult = true;
+    auto test = [&] (const char* description, bool currentResult) {
+        printf("    %s: %s\n", description, currentResult ? "PASS" : "FAIL");
+        overallResult &= currentResult;
+    };
+
+    printf("ShrinkFootprintTest:\n");
+
+    JSContextGroupRef group = JSContextGroupCreate();
+    JSGlobalContextRef context = JSGlobalContextCreateInGroup(group, nullptr);
+    JSContextGroupSetGarbageCollectionCallback(group, countFullCollections, nullptr);
+
+    JSStringRef shrinkName = JSStringCreateWithUTF8CString("shrinkFootprint");
+    JSObjectRef shrinkFunction = JSObjectMakeFunctionWithCallback(context, shrinkName, shrinkFootprint);
+    JSObjectSetProperty(context, JSContextGetGlobalObject(context), shrinkName, shrinkFunction, kJSPropertyAttributeNone, nullptr);
+    JSStringRelease(shrinkName);
+
+    JSStringRef lowMemoryName = JSStringCreateWithUTF8CString("simulateLowMemory");
+    JSObjectRef lowMemoryFunction = JSObjectMakeFunctionWithCallback(context, lowMemoryName, simulateLowMemory);
+    JSObjectSetProperty(context, JSContextGetGlobalObject(context), lowMemoryName, lowMemoryFunction, kJSPropertyAttributeNone, nullptr);
+    JSStringRelease(lowMemoryName);
+
+    // Keep about 64MB alive until just before shrinking, so that it can't have been collected and decommitted already.
+    test("setup", evaluatesToNumber(context,
+        "function sum(array) { var result = 0; for (var i = 0; i < array.length; ++i) result += array[i]; return result; }"
+        "for (var i = 0; i < 1000; ++i) sum([1, 2, 3]);"
+        "var retained = [];"
+        "for (var i = 0; i < 64; ++i) retained.push(new Array(128 * 1024).fill(i + 0.5));"
+        "retained.length", 64));
+    evaluate(context, "retained = null");
+
+    fullCollectionCount = 0;
+    size_t reclaimed = JSContextGroupShrinkFootprint(group);
+    test("shrinking reclaims the memory of dead objects", reclaimed > 0);
+    test("shrinking runs a full collection", fullCollectionCount == 1);
+    test("code still runs after its bytecode was thrown away", evaluatesToNumber(context, "sum([1, 2, 3, 4])", 10));
+
+    // Shrinking while a script is running has to wait until the script returns.
+    fullCollectionCount = 0;
+    test("shrinking from a running script returns 0", evaluatesToNumber(context, "shrinkFootprint() + shrinkFootprint()", 0));
+    test("shrinking is deferred while a script is running", !fullCollectionCountDuringScript);
+    test("deferred shrink runs once the script returns", fullCollectionCount == 1);
+    test("code still runs after a deferred shrink", evaluatesToNumber(context, "sum([5, 6])", 11));
+
+    // JSC installs a low memory handler when it initializes.
+    fullCollectionCount = 0;
+    WTF::MemoryPressureHandler::singleton().releaseMemory(WTF::Critical::Yes, WTF::Synchronous::Yes);
+    test("low memory shrinks an idle VM", fullCollectionCount == 1);
+
+    fullCollectionCount = 0;
+    test("low memory during a script", evaluatesToNumber(context, "simulateLowMemory(); sum([1, 2])", 3));
+    test("low memory defers shrinking while a script is running", !fullCollectionCountDuringScript);
+    test("deferred low memory shrink runs once the script returns", fullCollectionCount == 1);
+
+    JSContextGroupSetGarbageCollectionCallback(group, nullptr, nullptr);
+    JSGlobalContextRelease(context);
+    JSContextGroupRelease(group);
+
+    printf("ShrinkFootprintTest: %s\n", overallResult ? "PASS" : "FAIL");
+    return !overallResult;
+}
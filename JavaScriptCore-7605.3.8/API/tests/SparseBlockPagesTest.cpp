@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2018 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "SparseBlockPagesTest.h"
+
+#include "APICast.h"
+#include "JSCInlines.h"
+#include "JSContextRefPrivate.h"
+#include "JavaScript.h"
+#include "MarkedBlock.h"
+#include "Options.h"
+#include <stdio.h>
+#include <wtf/PageBlock.h>
+
+extern "C" void JSSynchronousGarbageCollectForDebugging(JSContextRef);
+
+using namespace JSC;
+
+// Objects are allocated in address order into fresh blocks, so keeping 64 out of every 512 leaves blocks
+// that are at most about a quarter full, with whole pages of dead cells between the survivors.
+static const char* const setupScript =
+    "function makeObject(index) {"
+    "    return { index: index, check: index * 3 };"
+    "}"
+    "var survivors = [];"
+    "for (var i = 0; i < 204800; ++i) {"
+    "    var object = makeObject(i);"
+    "    if (!(Math.floor(i / 64) % 8))"
+    "        survivors.push(object);"
+    "}"
+    "function verify() {"
+    "    for (var k = 0; k < survivors.length; ++k) {"
+    "        var object = survivors[k];"
+    "        if (object.index !== Math.floor(k / 64) * 512 + k % 64 || object.check !== object.index * 3)"
+    "            return false;"
+    "    }"
+    "    return true;"
+    "}"
+    "survivors.length";
+
+// Allocates more objects of the same size than the released blocks have room for, so the allocators have
+// to sweep those blocks and build free lists in their released pages.
+static const char* const refillScript =
+    "var refill = [];"
+    "for (var i = 0; i < 200000; ++i)"
+    "    refill.push(makeObject(i));"
+    "var refillIntact = true;"
+    "for (var i = 0; i < refill.length; ++i) {"
+    "    if (refill[i].index !== i || refill[i].check !== i * 3)"
+    "        refillIntact = false;"
+    "}"
+    "refill = null;"
+    "refillIntact && verify()";
+
+static JSValueRef evaluate(JSContextRef context, const char* source)
+{
+    JSStringRef script = JSStringCreateWithUTF8CString(source);
+    JSValueRef result = JSEvaluateScript(context, script, nullptr, nullptr, 1, nullptr);
+    JSStringRelease(script);
+    return result;
+}
+
+static bool evaluatesToTrue(JSContextRef context, const char* source)
+{
+    JSValueRef result = evaluate(context, source);
+    return result && JSValueIsBoolean(context, result) && JSValueToBoolean(context, result);
+}
+
+int testSparseBlockPages()
+{
+    bool overallResult = true;
+    auto test = [&] (const char* description, bool currentResult) {
+        printf("    %s: %s\n", description, currentResult ? "PASS" : "FAIL");
+        overallResult &= currentResult;
+    };
+
+    printf("SparseBlockPagesTest:\n");
+
+    Options::initialize(); // Ensure options is initialized first.
+    JSContextGroupRef group = JSContextGroupCreate();
+    JSGlobalContextRef context = JSGlobalContextCreateInGroup(group, nullptr);
+    VM& vm = toJS(context)->vm();
+
+    JSValueRef survivorCount = evaluate(context, setupScript);
+    test("setup", survivorCount && JSValueToNumber(context, survivorCount, nullptr) == 25600);
+
+    // The collection sweeps every block, which is what makes their dead pages releasable.
+    JSSynchronousGarbageCollectForDebugging(context);
+    size_t released;
+    size_t releasedAgain;
+    {
+        JSLockHolder locker(vm);
+        released = vm.heap.objectSpace().releaseFreePagesInSparseBlocks();
+        releasedAgain = vm.heap.objectSpace().releaseFreePagesInSparseBlocks();
+    }
+    // Blocks that fit in a single page only have the page that holds their footer.
+    bool blocksHaveSeveralPages = WTF::pageSize() < MarkedBlock::blockSize;
+    test("sparse blocks release whole pages", (released > 0 || !blocksHaveSeveralPages) && !(released % WTF::pageSize()));
+    test("releasing again finds the same pages", releasedAgain == released);
+    test("survivors are intact after their blocks released pages", evaluatesToTrue(context, "verify()"));
+
+    test("allocating into the released pages", evaluatesToTrue(context, refillScript));
+    JSSynchronousGarbageCollectForDebugging(context);
+    test("sweeping the refilled blocks again", evaluatesToTrue(context, "verify()"));
+
+    // The same thing through the public entry point, which also collects and sweeps first.
+    evaluate(context, "for (var i = 0; i < 200000; ++i) makeObject(i);");
+    JSContextGroupShrinkFootprint(group);
+    test("allocating and sweeping after shrinking the footprint", evaluatesToTrue(context, refillScript));
+    JSSynchronousGarbageCollectForDebugging(context);
+    test("survivors are intact after everything", evaluatesToTrue(context, "verify()"));
+
+    JSGlobalContextRelease(context);
+    JSContextGroupRelease(group);
+
+    printf("SparseBlockPagesTest: %s\n", overallResult ? "PASS" : "FAIL");
+    return !overallResult;
+}
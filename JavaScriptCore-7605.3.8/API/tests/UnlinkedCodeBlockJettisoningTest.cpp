@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2018 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "UnlinkedCodeBlockJettisoningTest.h"
+
+#include "APICast.h"
+#include "JSCInlines.h"
+#include "JavaScript.h"
+#include "Options.h"
+#include "UnlinkedFunctionExecutable.h"
+#include <stdio.h>
+
+extern "C" void JSSynchronousGarbageCollectForDebugging(JSContextRef);
+
+using namespace JSC;
+
+// More full collections than unlinkedCodeBlockMaxAge, so idle functions lose their bytecode.
+static const unsigned numberOfCollections = 4;
+static bool runningFunctionHadBytecode;
+static bool idleFunctionHadBytecode;
+
+static bool hasBytecode(JSContextRef context, const char* functionName)
+{
+    JSStringRef name = JSStringCreateWithUTF8CString(functionName);
+    JSValueRef value = JSObjectGetProperty(context, JSContextGetGlobalObject(context), name, nullptr);
+    JSStringRelease(name);
+
+    ExecState* exec = toJS(context);
+    JSFunction* function = jsCast<JSFunction*>(toJS(exec, value));
+    return function->jsExecutable()->unlinkedExecutable()->existingUnlinkedCodeBlockFor(CodeForCall);
+}
+
+static JSValueRef collectWhileRunning(JSContextRef context, JSObjectRef, JSObjectRef, size_t, const JSValueRef[], JSValueRef*)
+{
+    for (unsigned i = 0; i < numberOfCollections; ++i)
+        JSSynchronousGarbageCollectForDebugging(context);
+    runningFunctionHadBytecode = hasBytecode(context, "running");
+    idleFunctionHadBytecode = hasBytecode(context, "idle");
+    return JSValueMakeUndefined(context);
+}
+
+static bool evaluatesToNumber(JSContextRef context, const char* source, double expected)
+{
+    JSStringRef script = JSStringCreateWithUTF8CString(source);
+    JSValueRef exception = nullptr;
+    JSValueRef result = JSEvaluateScript(context, script, nullptr, nullptr, 1, &exception);
+    JSStringRelease(script);
+    return !exception && JSValueIsNumber(context, result) && JSValueToNumber(context, result, nullptr) == expected;
+}
+
+int testUnlinkedCodeBlockJettisoning()
+{
+    bool overallResult = true;
+    auto test = [&] (const char* description, bool currentResult) {
+        printf("    %s: %s\n", description, currentResult ? "PASS" : "FAIL");
+        overallResult &= currentResult;
+    };
+
+    printf("UnlinkedCodeBlockJettisoningTest:\n");
+
+    Options::initialize(); // Ensure options is initialized first.
+    bool oldUseUnlinkedCodeBlockJettisoning = Options::useUnlinkedCodeBlockJettisoning();
+    unsigned oldUnlinkedCodeBlockMaxAge = Options::unlinkedCodeBlockMaxAge();
+    bool oldForceCodeBlockToJettisonDueToOldAge = Options::forceCodeBlockToJettisonDueToOldAge();
+    Options::useUnlinkedCodeBlockJettisoning() = true;
+    Options::unlinkedCodeBlockMaxAge() = 2;
+    // Linked CodeBlocks that nothing but their executable marks die right away, so that only the
+    // unlinked side decides whether the bytecode survives.
+    Options::forceCodeBlockToJettisonDueToOldAge() = true;
+
+    JSGlobalContextRef context = JSGlobalContextCreateInGroup(nullptr, nullptr);
+    JSStringRef collectName = JSStringCreateWithUTF8CString("collectWhileRunning");
+    JSObjectRef collectFunction = JSObjectMakeFunctionWithCallback(context, collectName, collectWhileRunning);
+    JSObjectSetProperty(context, JSContextGetGlobalObject(context), collectName, collectFunction, kJSPropertyAttributeNone, nullptr);
+    JSStringRelease(collectName);
+
+    test("setup", evaluatesToNumber(context,
+        "function idle() { return 1; }"
+        "function running() { var result = 0; for (var i = 0; i < 10; ++i) result += i; collectWhileRunning(); return result + i; }"
+        "idle() + running()", 56));
+    test("a running function keeps its bytecode", runningFunctionHadBytecode);
+    test("an idle function loses its bytecode", !idleFunctionHadBytecode);
+
+    // Being found on the stack reset the age of running(), so it outlives its linked CodeBlock for a while.
+    JSSynchronousGarbageCollectForDebugging(context);
+    test("a function that ran recently keeps its bytecode", hasBytecode(context, "running"));
+
+    test("functions still run after losing their bytecode", evaluatesToNumber(context, "idle() + running()", 56));
+
+    JSGlobalContextRelease(context);
+
+    Options::useUnlinkedCodeBlockJettisoning() = oldUseUnlinkedCodeBlockJettisoning;
+    Options::unlinkedCodeBlockMaxAge() = oldUnlinkedCodeBlockMaxAge;
+    Options::forceCodeBlockToJettisonDueToOldAge() = oldForceCodeBlockToJettisonDueToOldAge;
+
+    printf("UnlinkedCodeBlockJettisoningTest: %s\n", overallResult ? "PASS" : "FAIL");
+    return !overallResult;
+}
@@ -0,0 +1,290 @@
+/*
+ * Copyright (C) 2018 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "WasmAtomicsTest.h"
+
+#include "APICast.h"
+#include "JSCInlines.h"
+#include "JSWebAssemblyMemory.h"
+#include "JavaScript.h"
+#include "Options.h"
+#include "WasmModuleBuilder.h"
+#include <stdio.h>
+#include <thread>
+
+#if ENABLE(WEBASSEMBLY)
+
+using namespace JSC;
+
+// The opcodes that follow the 0xfe prefix.
+enum AtomicOpcode : uint32_t {
+    MemoryAtomicNotify = 0,
+    MemoryAtomicWait32 = 1,
+    AtomicFence = 3,
+    I32AtomicLoad = 16,
+    I32AtomicLoad16U = 19,
+    I32AtomicStore = 23,
+    I32AtomicRmwAdd = 30,
+    I64AtomicRmwAdd = 31,
+    I32AtomicRmw8AddU = 32,
+    I32AtomicRmwSub = 37,
+    I32AtomicRmwAnd = 44,
+    I32AtomicRmwOr = 51,
+    I32AtomicRmwXor = 58,
+    I32AtomicRmwXchg = 65,
+    I32AtomicRmwCmpxchg = 72,
+    I32AtomicRmw16CmpxchgU = 75,
+};
+
+// Atomic accesses must give their natural alignment.
+static WasmCode& atomicAccess(WasmCode& code, AtomicOpcode opcode, uint32_t alignment)
+{
+    return code.atomic(opcode).u32(alignment).u32(0);
+}
+
+static Vector<uint8_t> makeAtomicsModule(bool sharedMemory)
+{
+    WasmModuleBuilder builder;
+    uint32_t i32ToI32 = builder.addType({ WasmType::I32 }, { WasmType::I32 });
+    uint32_t i32I32ToI32 = builder.addType({ WasmType::I32, WasmType::I32 }, { WasmType::I32 });
+    uint32_t i32I32ToVoid = builder.addType({ WasmType::I32, WasmType::I32 }, { });
+    uint32_t i32I32I32ToI32 = builder.addType({ WasmType::I32, WasmType::I32, WasmType::I32 }, { WasmType::I32 });
+    uint32_t toI32 = builder.addType({ }, { WasmType::I32 });
+    if (sharedMemory)
+        builder.importMemory("env", "memory", 1, 2, true);
+    else
+        builder.setMemory(1, 2);
+
+    auto addUnary = [&] (const char* name, AtomicOpcode opcode, uint32_t alignment) {
+        WasmCode code;
+        code.localGet(0);
+        builder.exportFunction(name, builder.addFunction(i32ToI32, { }, atomicAccess(code, opcode, alignment)));
+    };
+    auto addBinary = [&] (const char* name, AtomicOpcode opcode, uint32_t alignment) {
+        WasmCode code;
+        code.localGet(0).localGet(1);
+        builder.exportFunction(name, builder.addFunction(i32I32ToI32, { }, atomicAccess(code, opcode, alignment)));
+    };
+    auto addCompareExchange = [&] (const char* name, AtomicOpcode opcode, uint32_t alignment) {
+        WasmCode code;
+        code.localGet(0).localGet(1).localGet(2);
+        builder.exportFunction(name, builder.addFunction(i32I32I32ToI32, { }, atomicAccess(code, opcode, alignment)));
+    };
+    auto addWait = [&] (const char* name, int64_t timeout) {
+        WasmCode code;
+        code.localGet(0).localGet(1).i64Const(timeout);
+        builder.exportFunction(name, builder.addFunction(i32I32ToI32, { }, atomicAccess(code, MemoryAtomicWait32, 2)));
+    };
+
+    addUnary("load32", I32AtomicLoad, 2);
+    addUnary("load16U", I32AtomicLoad16U, 1);
+    WasmCode store32;
+    store32.localGet(0).localGet(1);
+    builder.exportFunction("store32", builder.addFunction(i32I32ToVoid, { }, atomicAccess(store32, I32AtomicStore, 2)));
+    addBinary("add32", I32AtomicRmwAdd, 2);
+    addBinary("sub32", I32AtomicRmwSub, 2);
+    addBinary("and32", I32AtomicRmwAnd, 2);
+    addBinary("or32", I32AtomicRmwOr, 2);
+    addBinary("xor32", I32AtomicRmwXor, 2);
+    addBinary("xchg32", I32AtomicRmwXchg, 2);
+    addBinary("add8", I32AtomicRmw8AddU, 0);
+    addCompareExchange("cmpxchg32", I32AtomicRmwCmpxchg, 2);
+    addCompareExchange("cmpxchg16", I32AtomicRmw16CmpxchgU, 1);
+
+    // Adds value to the upper half of an i64, and returns the upper half of the old value.
+    WasmCode add64High;
+    add64High.localGet(0).localGet(1).op(WasmOp::I64ExtendUI32).i64Const(32).op(WasmOp::I64Shl);
+    atomicAccess(add64High, I64AtomicRmwAdd, 3);
+    add64High.i64Const(32).op(WasmOp::I64ShrS).op(WasmOp::I32WrapI64);
+    builder.exportFunction("add64High", builder.addFunction(i32I32ToI32, { }, add64High));
+
+    addWait("wait32", 0);
+    addWait("waitTenSeconds", 10000000000);
+    addBinary("notify", MemoryAtomicNotify, 2);
+    builder.exportFunction("fence", builder.addFunction(toI32, { }, WasmCode().atomic(AtomicFence).op(0).i32Const(1)));
+
+    builder.exportFunction("size", builder.addFunction(toI32, { }, WasmCode().memorySize()));
+    builder.exportFunction("grow", builder.addFunction(i32ToI32, { }, WasmCode().localGet(0).memoryGrow()));
+    return builder.build();
+}
+
+static const char* const setupScript =
+    "function traps(f) { try { f(); } catch (error) { return error instanceof WebAssembly.RuntimeError; } return false; }"
+    "var memory = new WebAssembly.Memory({ initial: 1, maximum: 2, shared: true });"
+    "var e = new WebAssembly.Instance(new WebAssembly.Module(atomicsModule), { env: { memory: memory } }).exports;"
+    "var view = new Int32Array(memory.buffer);"
+    "memory.buffer instanceof SharedArrayBuffer";
+
+static const char* const operationsScript =
+    "e.store32(8, 5);"
+    "view[3] = 0xff;"
+    "view[4] = 0x1ffff;"
+    "view[7] = 1;"
+    "e.load32(8) === 5 && view[2] === 5"
+    "    && e.add32(8, 3) === 5 && e.sub32(8, 1) === 8 && e.and32(8, 6) === 7"
+    "    && e.or32(8, 9) === 6 && e.xor32(8, 3) === 15 && e.xchg32(8, 100) === 12 && e.load32(8) === 100"
+    "    && e.cmpxchg32(8, 1, 2) === 100 && e.load32(8) === 100"
+    "    && e.cmpxchg32(8, 100, 2) === 100 && e.load32(8) === 2"
+    // Subword operations wrap within their width, and zero extend what they return.
+    "    && e.add8(12, 1) === 0xff && view[3] === 0"
+    "    && e.cmpxchg16(16, 0xffff, 7) === 0xffff && view[4] === 0x10007 && e.load16U(16) === 7"
+    "    && e.cmpxchg16(16, -1, 9) === 7 && e.load16U(16) === 7"
+    "    && e.add64High(24, 2) === 1 && view[6] === 0 && view[7] === 3"
+    "    && e.fence() === 1";
+
+static const char* const trapsScript =
+    "traps(function() { e.load32(1); })"
+    "    && traps(function() { e.load16U(1); })"
+    "    && traps(function() { e.store32(2, 0); })"
+    "    && traps(function() { e.add32(3, 1); })"
+    "    && traps(function() { e.cmpxchg32(2, 0, 0); })"
+    "    && traps(function() { e.cmpxchg16(1, 0, 0); })"
+    "    && traps(function() { e.add64High(4, 0); })"
+    "    && traps(function() { e.wait32(2, 0); })"
+    "    && traps(function() { e.notify(1, 1); })"
+    "    && e.load32(65532) === 0"
+    "    && traps(function() { e.load32(65536); })"
+    "    && traps(function() { e.add32(65536, 1); })"
+    "    && traps(function() { e.load16U(65536); })"
+    "    && traps(function() { e.notify(65536, 1); })"
+    "    && traps(function() { e.load32(-4); })";
+
+static const char* const unsharedScript =
+    "var unshared = new WebAssembly.Instance(new WebAssembly.Module(unsharedAtomicsModule)).exports;"
+    "var linkError = false;"
+    "try {"
+    "    new WebAssembly.Instance(new WebAssembly.Module(atomicsModule), { env: { memory: new WebAssembly.Memory({ initial: 1, maximum: 2 }) } });"
+    "} catch (error) {"
+    "    linkError = error instanceof WebAssembly.LinkError;"
+    "}"
+    "linkError"
+    "    && unshared.add32(0, 5) === 0 && unshared.add32(0, 1) === 5"
+    "    && traps(function() { unshared.wait32(0, 0); })"
+    "    && unshared.notify(0, 1) === 0"
+    "    && unshared.grow(1) === 1 && unshared.size() === 2";
+
+static const char* const growScript =
+    "var buffer = memory.buffer;"
+    "var rangeError = false;"
+    "try {"
+    "    memory.grow(1);"
+    "} catch (error) {"
+    "    rangeError = error instanceof RangeError;"
+    "}"
+    "rangeError && memory.grow(0) === 1 && memory.buffer === buffer && buffer.byteLength === 65536"
+    "    && e.grow(1) === -1 && e.grow(0) === 1 && e.size() === 1";
+
+// Runs in another VM, on its own thread, which shares the memory the way an embedder posting it to a worker would.
+static const char* const waiterScript =
+    "var e = new WebAssembly.Instance(new WebAssembly.Module(atomicsModule), { env: { memory: memory } }).exports;"
+    "var grew = true;"
+    "try {"
+    "    memory.grow(1);"
+    "} catch (error) {"
+    "    grew = false;"
+    "}"
+    "!grew && e.grow(1) === -1 && e.size() === 1"
+    "    && e.waitTenSeconds(32, 0) === 0 && e.load32(36) === 42";
+
+static double evaluateNumber(JSContextRef context, const char* source)
+{
+    JSStringRef script = JSStringCreateWithUTF8CString(source);
+    JSValueRef result = JSEvaluateScript(context, script, nullptr, nullptr, 1, nullptr);
+    JSStringRelease(script);
+    return result ? JSValueToNumber(context, result, nullptr) : -1;
+}
+
+#endif // ENABLE(WEBASSEMBLY)
+
+int testWasmAtomics()
+{
+    bool overallResult = true;
+    auto test = [&] (const char* description, bool currentResult) {
+        printf("    %s: %s\n", description, currentResult ? "PASS" : "FAIL");
+        overallResult &= currentResult;
+    };
+
+    printf("WasmAtomicsTest:\n");
+
+#if ENABLE(WEBASSEMBLY)
+    Options::initialize(); // Ensure options is initialized first.
+    bool oldUseWebAssemblyThreads = Options::useWebAssemblyThreads();
+    Options::useWebAssemblyThreads() = true;
+
+    Vector<uint8_t> module = makeAtomicsModule(true);
+    JSGlobalContextRef context = JSGlobalContextCreateInGroup(nullptr, nullptr);
+    setWasmModuleBytes(context, "atomicsModule", module);
+    setWasmModuleBytes(context, "unsharedAtomicsModule", makeAtomicsModule(false));
+
+    test("shared memories have a SharedArrayBuffer", wasmTestScriptReturnsTrue(context, setupScript));
+    test("atomic operations", wasmTestScriptReturnsTrue(context, operationsScript));
+    test("alignment and bounds traps", wasmTestScriptReturnsTrue(context, trapsScript));
+    test("wait and notify without waiters", wasmTestScriptReturnsTrue(context, "e.wait32(0, 1) === 1 && e.wait32(0, 0) === 2 && e.notify(0, 1) === 0"));
+    test("atomics on unshared memories", wasmTestScriptReturnsTrue(context, unsharedScript));
+    test("shared memories don't grow", wasmTestScriptReturnsTrue(context, growScript));
+
+    RefPtr<Wasm::Memory> sharedMemory;
+    {
+        ExecState* exec = toJS(context);
+        JSLockHolder locker(exec->vm());
+        JSValue memory = exec->lexicalGlobalObject()->get(exec, Identifier::fromString(exec, "memory"));
+        sharedMemory = &jsCast<JSWebAssemblyMemory*>(memory)->memory();
+    }
+
+    bool waiterResult = false;
+    std::thread waiter([&] {
+        JSGlobalContextRef otherContext = JSGlobalContextCreateInGroup(nullptr, nullptr);
+        {
+            ExecState* exec = toJS(otherContext);
+            VM& vm = exec->vm();
+            JSLockHolder locker(vm);
+            JSWebAssemblyMemory* otherMemory = JSWebAssemblyMemory::create(exec, vm, exec->lexicalGlobalObject()->WebAssemblyMemoryStructure());
+            otherMemory->adopt(sharedMemory.releaseNonNull());
+            exec->lexicalGlobalObject()->putDirect(vm, Identifier::fromString(&vm, "memory"), otherMemory);
+        }
+        setWasmModuleBytes(otherContext, "atomicsModule", module);
+        waiterResult = wasmTestScriptReturnsTrue(otherContext, waiterScript);
+        JSGlobalContextRelease(otherContext);
+    });
+
+    // Keep notifying until the other thread has parked and been woken, or a few seconds have passed.
+    evaluateNumber(context, "e.store32(36, 42)");
+    bool woken = false;
+    for (unsigned i = 0; i < 5000 && !woken; ++i) {
+        woken = evaluateNumber(context, "e.notify(32, 1)") == 1;
+        if (!woken)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    waiter.join();
+    test("another agent can't grow the memory, sees stores, and is woken by notify", woken && waiterResult);
+
+    JSGlobalContextRelease(context);
+    Options::useWebAssemblyThreads() = oldUseWebAssemblyThreads;
+#endif
+
+    printf("WasmAtomicsTest: %s\n", overallResult ? "PASS" : "FAIL");
+    return !overallResult;
+}
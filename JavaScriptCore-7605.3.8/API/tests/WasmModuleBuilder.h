@@ -0,0 +1,366 @@
+/*
+ * Copyright (C) 2018 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#if ENABLE(WEBASSEMBLY)
+
+#include "JavaScript.h"
+#include <initializer_list>
+#include <stdio.h>
+#include <string.h>
+#include <wtf/Optional.h>
+#include <wtf/Vector.h>
+#include <wtf/text/CString.h>
+
+// A small assembler for the WebAssembly binary format, so that the API tests can build the modules they need.
+
+enum class WasmType : uint8_t {
+    I32 = 0x7f,
+    I64 = 0x7e,
+    F32 = 0x7d,
+    F64 = 0x7c,
+    V128 = 0x7b,
+    Void = 0x40,
+};
+
+namespace WasmOp {
+static constexpr uint8_t I32Load = 0x28;
+static constexpr uint8_t I64Load = 0x29;
+static constexpr uint8_t F32Load = 0x2a;
+static constexpr uint8_t F64Load = 0x2b;
+static constexpr uint8_t I32Load8S = 0x2c;
+static constexpr uint8_t I32Load8U = 0x2d;
+static constexpr uint8_t I32Load16S = 0x2e;
+static constexpr uint8_t I32Load16U = 0x2f;
+static constexpr uint8_t I64Load32S = 0x34;
+static constexpr uint8_t I32Store = 0x36;
+static constexpr uint8_t I64Store = 0x37;
+static constexpr uint8_t F32Store = 0x38;
+static constexpr uint8_t F64Store = 0x39;
+static constexpr uint8_t I32Store8 = 0x3a;
+static constexpr uint8_t I32Store16 = 0x3b;
+static constexpr uint8_t I64Store32 = 0x3e;
+static constexpr uint8_t I32Eqz = 0x45;
+static constexpr uint8_t I32Eq = 0x46;
+static constexpr uint8_t I32Ne = 0x47;
+static constexpr uint8_t I32LtS = 0x48;
+static constexpr uint8_t I32LtU = 0x49;
+static constexpr uint8_t I32GtS = 0x4a;
+static constexpr uint8_t I32GeS = 0x4e;
+static constexpr uint8_t I32Clz = 0x67;
+static constexpr uint8_t I32Ctz = 0x68;
+static constexpr uint8_t I32Popcnt = 0x69;
+static constexpr uint8_t I32Add = 0x6a;
+static constexpr uint8_t I32Sub = 0x6b;
+static constexpr uint8_t I32Mul = 0x6c;
+static constexpr uint8_t I32DivS = 0x6d;
+static constexpr uint8_t I32RemS = 0x6f;
+static constexpr uint8_t I32And = 0x71;
+static constexpr uint8_t I32Or = 0x72;
+static constexpr uint8_t I32Xor = 0x73;
+static constexpr uint8_t I32Shl = 0x74;
+static constexpr uint8_t I64Popcnt = 0x7b;
+static constexpr uint8_t I64Add = 0x7c;
+static constexpr uint8_t I64Mul = 0x7e;
+static constexpr uint8_t I64Or = 0x84;
+static constexpr uint8_t I64Shl = 0x86;
+static constexpr uint8_t I64ShrS = 0x87;
+static constexpr uint8_t F64Add = 0xa0;
+static constexpr uint8_t F64Mul = 0xa2;
+static constexpr uint8_t I32WrapI64 = 0xa7;
+static constexpr uint8_t I64ExtendUI32 = 0xad;
+} // namespace WasmOp
+
+inline void appendUnsignedLEB128(Vector<uint8_t>& bytes, uint64_t value)
+{
+    do {
+        uint8_t byte = value & 0x7f;
+        value >>= 7;
+        if (value)
+            byte |= 0x80;
+        bytes.append(byte);
+    } while (value);
+}
+
+inline void appendSignedLEB128(Vector<uint8_t>& bytes, int64_t value)
+{
+    while (true) {
+        uint8_t byte = value & 0x7f;
+        value >>= 7;
+        bool done = (!value && !(byte & 0x40)) || (value == -1 && (byte & 0x40));
+        if (!done)
+            byte |= 0x80;
+        bytes.append(byte);
+        if (done)
+            return;
+    }
+}
+
+// The body of one function, written an instruction at a time.
+class WasmCode {
+public:
+    WasmCode& op(uint8_t opcode) { m_bytes.append(opcode); return *this; }
+    WasmCode& u32(uint32_t value) { appendUnsignedLEB128(m_bytes, value); return *this; }
+    WasmCode& bytes(std::initializer_list<uint8_t> bytes)
+    {
+        for (uint8_t byte : bytes)
+            m_bytes.append(byte);
+        return *this;
+    }
+
+    WasmCode& unreachable() { return op(0x00); }
+    WasmCode& block(WasmType type = WasmType::Void) { return op(0x02).op(static_cast<uint8_t>(type)); }
+    WasmCode& loop(WasmType type = WasmType::Void) { return op(0x03).op(static_cast<uint8_t>(type)); }
+    WasmCode& ifBlock(WasmType type = WasmType::Void) { return op(0x04).op(static_cast<uint8_t>(type)); }
+    WasmCode& elseBlock() { return op(0x05); }
+    WasmCode& end() { return op(0x0b); }
+    WasmCode& br(uint32_t depth) { return op(0x0c).u32(depth); }
+    WasmCode& brIf(uint32_t depth) { return op(0x0d).u32(depth); }
+    WasmCode& brTable(std::initializer_list<uint32_t> targets, uint32_t defaultTarget)
+    {
+        op(0x0e).u32(targets.size());
+        for (uint32_t target : targets)
+            u32(target);
+        return u32(defaultTarget);
+    }
+    WasmCode& ret() { return op(0x0f); }
+    WasmCode& call(uint32_t functionIndex) { return op(0x10).u32(functionIndex); }
+    WasmCode& callIndirect(uint32_t typeIndex) { return op(0x11).u32(typeIndex).op(0x00); }
+    WasmCode& drop() { return op(0x1a); }
+    WasmCode& select() { return op(0x1b); }
+    WasmCode& localGet(uint32_t index) { return op(0x20).u32(index); }
+    WasmCode& localSet(uint32_t index) { return op(0x21).u32(index); }
+    WasmCode& localTee(uint32_t index) { return op(0x22).u32(index); }
+    // Loads and stores take the log2 of their alignment.
+    WasmCode& memoryAccess(uint8_t opcode, uint32_t alignment, uint32_t offset = 0) { return op(opcode).u32(alignment).u32(offset); }
+    WasmCode& memorySize() { return op(0x3f).op(0x00); }
+    WasmCode& memoryGrow() { return op(0x40).op(0x00); }
+    WasmCode& i32Const(int32_t value) { op(0x41); appendSignedLEB128(m_bytes, value); return *this; }
+    WasmCode& i64Const(int64_t value) { op(0x42); appendSignedLEB128(m_bytes, value); return *this; }
+    WasmCode& f32Const(float value) { op(0x43); appendValue(value); return *this; }
+    WasmCode& f64Const(double value) { op(0x44); appendValue(value); return *this; }
+    WasmCode& simd(uint32_t opcode) { return op(0xfd).u32(opcode); }
+    WasmCode& atomic(uint32_t opcode) { return op(0xfe).u32(opcode); }
+
+    const Vector<uint8_t>& data() const { return m_bytes; }
+
+private:
+    template<typename T>
+    void appendValue(T value)
+    {
+        uint8_t bytes[sizeof(T)];
+        memcpy(bytes, &value, sizeof(T));
+        m_bytes.append(bytes, sizeof(T));
+    }
+
+    Vector<uint8_t> m_bytes;
+};
+
+class WasmModuleBuilder {
+public:
+    uint32_t addType(std::initializer_list<WasmType> parameters, std::initializer_list<WasmType> results)
+    {
+        m_types.append(0x60);
+        appendUnsignedLEB128(m_types, parameters.size());
+        for (WasmType type : parameters)
+            m_types.append(static_cast<uint8_t>(type));
+        appendUnsignedLEB128(m_types, results.size());
+        for (WasmType type : results)
+            m_types.append(static_cast<uint8_t>(type));
+        return m_typeCount++;
+    }
+
+    // Imported functions come first in the function index space, so import them before adding functions.
+    uint32_t importFunction(const char* module, const char* field, uint32_t typeIndex)
+    {
+        RELEASE_ASSERT(!m_functionCount);
+        appendImportName(module, field);
+        m_imports.append(0x00);
+        appendUnsignedLEB128(m_imports, typeIndex);
+        return m_importedFunctionCount++;
+    }
+
+    void importMemory(const char* module, const char* field, uint32_t initialPages, std::optional<uint32_t> maximumPages = std::nullopt, bool shared = false)
+    {
+        appendImportName(module, field);
+        m_imports.append(0x02);
+        appendLimits(m_imports, initialPages, maximumPages, shared);
+    }
+
+    void setMemory(uint32_t initialPages, std::optional<uint32_t> maximumPages = std::nullopt, bool shared = false)
+    {
+        m_memory.clear();
+        appendUnsignedLEB128(m_memory, 1);
+        appendLimits(m_memory, initialPages, maximumPages, shared);
+    }
+
+    void setTable(uint32_t size)
+    {
+        m_table.clear();
+        appendUnsignedLEB128(m_table, 1);
+        m_table.append(0x70);
+        appendLimits(m_table, size, std::nullopt, false);
+    }
+
+    uint32_t addFunction(uint32_t typeIndex, std::initializer_list<std::pair<uint32_t, WasmType>> locals, const WasmCode& code)
+    {
+        appendUnsignedLEB128(m_functions, typeIndex);
+
+        Vector<uint8_t> body;
+        appendUnsignedLEB128(body, locals.size());
+        for (auto& local : locals) {
+            appendUnsignedLEB128(body, local.first);
+            body.append(static_cast<uint8_t>(local.second));
+        }
+        body.appendVector(code.data());
+        body.append(0x0b);
+
+        appendUnsignedLEB128(m_code, body.size());
+        m_code.appendVector(body);
+        return m_importedFunctionCount + m_functionCount++;
+    }
+
+    void exportFunction(const char* name, uint32_t functionIndex) { appendExport(name, 0x00, functionIndex); }
+    void exportMemory(const char* name) { appendExport(name, 0x02, 0); }
+
+    void addElements(uint32_t offset, std::initializer_list<uint32_t> functionIndices)
+    {
+        appendUnsignedLEB128(m_elements, 0);
+        m_elements.append(0x41);
+        appendSignedLEB128(m_elements, offset);
+        m_elements.append(0x0b);
+        appendUnsignedLEB128(m_elements, functionIndices.size());
+        for (uint32_t index : functionIndices)
+            appendUnsignedLEB128(m_elements, index);
+        m_elementCount++;
+    }
+
+    Vector<uint8_t> build() const
+    {
+        Vector<uint8_t> result;
+        result.append(reinterpret_cast<const uint8_t*>("\0asm\1\0\0\0"), 8);
+        appendSection(result, 1, m_typeCount, m_types);
+        appendSection(result, 2, m_importCount, m_imports);
+        appendSection(result, 3, m_functionCount, m_functions);
+        appendSection(result, 4, 0, m_table);
+        appendSection(result, 5, 0, m_memory);
+        appendSection(result, 7, m_exportCount, m_exports);
+        appendSection(result, 9, m_elementCount, m_elements);
+        appendSection(result, 10, m_functionCount, m_code);
+        return result;
+    }
+
+private:
+    static void appendName(Vector<uint8_t>& bytes, const char* name)
+    {
+        size_t length = strlen(name);
+        appendUnsignedLEB128(bytes, length);
+        bytes.append(reinterpret_cast<const uint8_t*>(name), length);
+    }
+
+    static void appendLimits(Vector<uint8_t>& bytes, uint32_t initial, std::optional<uint32_t> maximum, bool shared)
+    {
+        bytes.append((maximum ? 1 : 0) | (shared ? 2 : 0));
+        appendUnsignedLEB128(bytes, initial);
+        if (maximum)
+            appendUnsignedLEB128(bytes, *maximum);
+    }
+
+    // Sections whose contents are a vector get their count prepended. The table and memory sections
+    // already contain theirs.
+    static void appendSection(Vector<uint8_t>& result, uint8_t id, uint32_t count, const Vector<uint8_t>& contents)
+    {
+        if (contents.isEmpty())
+            return;
+        Vector<uint8_t> section;
+        if (id != 4 && id != 5)
+            appendUnsignedLEB128(section, count);
+        section.appendVector(contents);
+        result.append(id);
+        appendUnsignedLEB128(result, section.size());
+        result.appendVector(section);
+    }
+
+    void appendImportName(const char* module, const char* field)
+    {
+        appendName(m_imports, module);
+        appendName(m_imports, field);
+        m_importCount++;
+    }
+
+    void appendExport(const char* name, uint8_t kind, uint32_t index)
+    {
+        appendName(m_exports, name);
+        m_exports.append(kind);
+        appendUnsignedLEB128(m_exports, index);
+        m_exportCount++;
+    }
+
+    Vector<uint8_t> m_types;
+    Vector<uint8_t> m_imports;
+    Vector<uint8_t> m_functions;
+    Vector<uint8_t> m_table;
+    Vector<uint8_t> m_memory;
+    Vector<uint8_t> m_exports;
+    Vector<uint8_t> m_elements;
+    Vector<uint8_t> m_code;
+    uint32_t m_typeCount { 0 };
+    uint32_t m_importCount { 0 };
+    uint32_t m_importedFunctionCount { 0 };
+    uint32_t m_functionCount { 0 };
+    uint32_t m_exportCount { 0 };
+    uint32_t m_elementCount { 0 };
+};
+
+// Makes the bytes available to scripts as a Uint8Array in the given global variable.
+inline void setWasmModuleBytes(JSContextRef context, const char* name, const Vector<uint8_t>& bytes)
+{
+    JSObjectRef array = JSObjectMakeTypedArray(context, kJSTypedArrayTypeUint8Array, bytes.size(), nullptr);
+    memcpy(JSObjectGetTypedArrayBytesPtr(context, array, nullptr), bytes.data(), bytes.size());
+    JSStringRef string = JSStringCreateWithUTF8CString(name);
+    JSObjectSetProperty(context, JSContextGetGlobalObject(context), string, array, kJSPropertyAttributeNone, nullptr);
+    JSStringRelease(string);
+}
+
+// Returns whether the script evaluated to true. Exceptions are logged, since they usually explain a failure.
+inline bool wasmTestScriptReturnsTrue(JSContextRef context, const char* source)
+{
+    JSStringRef script = JSStringCreateWithUTF8CString(source);
+    JSValueRef exception = nullptr;
+    JSValueRef result = JSEvaluateScript(context, script, nullptr, nullptr, 1, &exception);
+    JSStringRelease(script);
+    if (exception) {
+        JSStringRef string = JSValueToStringCopy(context, exception, nullptr);
+        Vector<char> buffer(JSStringGetMaximumUTF8CStringSize(string));
+        JSStringGetUTF8CString(string, buffer.data(), buffer.size());
+        printf("    exception: %s\n", buffer.data());
+        JSStringRelease(string);
+        return false;
+    }
+    return JSValueIsBoolean(context, result) && JSValueToBoolean(context, result);
+}
+
+#endif // ENABLE(WEBASSEMBLY)
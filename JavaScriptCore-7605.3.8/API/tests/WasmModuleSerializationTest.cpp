@@ -0,0 +1,260 @@
+/*
+ * Copyright (C) 2018 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "WasmModuleSerializationTest.h"
+
+#include "APICast.h"
+#include "CatchScope.h"
+#include "Exception.h"
+#include "JSCInlines.h"
+#include "JSToWasm.h"
+#include "JSWebAssemblyModule.h"
+#include "JavaScript.h"
+#include "MacroAssembler.h"
+#include "Options.h"
+#include "WasmModuleBuilder.h"
+#include "WasmModuleSerialization.h"
+#include "WasmToJS.h"
+#include <stdio.h>
+
+#if ENABLE(WEBASSEMBLY)
+
+using namespace JSC;
+
+#if CPU(X86_64)
+static const bool pointersArePatchedBackwards = true;
+#else
+static const bool pointersArePatchedBackwards = false;
+#endif
+
+static JSValueRef makeError(JSContextRef context, const String& message)
+{
+    JSStringRef string = JSStringCreateWithUTF8CString(message.utf8().data());
+    JSValueRef argument = JSValueMakeString(context, string);
+    JSStringRelease(string);
+    return JSObjectMakeError(context, 1, &argument, nullptr);
+}
+
+static JSValueRef serializeModule(JSContextRef context, JSObjectRef, JSObjectRef, size_t argumentCount, const JSValueRef arguments[], JSValueRef* exception)
+{
+    ExecState* exec = toJS(context);
+    VM& vm = exec->vm();
+    JSLockHolder locker(vm);
+    auto* module = argumentCount ? jsDynamicCast<JSWebAssemblyModule*>(vm, toJS(exec, arguments[0])) : nullptr;
+    if (!module) {
+        *exception = makeError(context, "serializeModule expects a WebAssembly.Module");
+        return nullptr;
+    }
+
+    auto serialized = Wasm::serializeModule(module->module());
+    if (!serialized) {
+        *exception = makeError(context, serialized.error());
+        return nullptr;
+    }
+    JSObjectRef result = JSObjectMakeTypedArray(context, kJSTypedArrayTypeUint8Array, serialized->size(), exception);
+    memcpy(JSObjectGetTypedArrayBytesPtr(context, result, exception), serialized->data(), serialized->size());
+    return result;
+}
+
+static JSValueRef deserializeModule(JSContextRef context, JSObjectRef, JSObjectRef, size_t argumentCount, const JSValueRef arguments[], JSValueRef* exception)
+{
+    if (!argumentCount || JSValueGetTypedArrayType(context, arguments[0], nullptr) != kJSTypedArrayTypeUint8Array) {
+        *exception = makeError(context, "deserializeModule expects a Uint8Array");
+        return nullptr;
+    }
+    JSObjectRef array = JSValueToObject(context, arguments[0], exception);
+    const uint8_t* data = static_cast<const uint8_t*>(JSObjectGetTypedArrayBytesPtr(context, array, exception));
+    size_t size = JSObjectGetTypedArrayByteLength(context, array, exception);
+
+    ExecState* exec = toJS(context);
+    VM& vm = exec->vm();
+    JSLockHolder locker(vm);
+    auto scope = DECLARE_CATCH_SCOPE(vm);
+    auto result = Wasm::deserializeModule(&vm.wasmContext, data, size, &Wasm::createJSToWasmWrapper, &Wasm::wasmToJSException);
+    JSWebAssemblyModule* module = JSWebAssemblyModule::createStub(vm, exec, exec->lexicalGlobalObject()->WebAssemblyModuleStructure(), WTFMove(result));
+    if (UNLIKELY(scope.exception())) {
+        *exception = toRef(exec, scope.exception()->value());
+        scope.clearException();
+        return nullptr;
+    }
+    return toRef(module);
+}
+
+// One function per kind of relocation: direct and indirect calls, memory growth, popcount, traps, and
+// the tier up check of a loop.
+static Vector<uint8_t> makeModule()
+{
+    WasmModuleBuilder builder;
+    uint32_t i32ToI32 = builder.addType({ WasmType::I32 }, { WasmType::I32 });
+    uint32_t i32I32ToI32 = builder.addType({ WasmType::I32, WasmType::I32 }, { WasmType::I32 });
+    uint32_t toI32 = builder.addType({ }, { WasmType::I32 });
+    builder.setMemory(1, 10);
+    builder.setTable(2);
+
+    uint32_t doubleIndex = builder.addFunction(i32ToI32, { }, WasmCode().localGet(0).i32Const(2).op(WasmOp::I32Mul));
+    uint32_t squareIndex = builder.addFunction(i32ToI32, { }, WasmCode().localGet(0).localGet(0).op(WasmOp::I32Mul));
+    builder.addElements(0, { doubleIndex, squareIndex });
+    builder.exportFunction("double", doubleIndex);
+    builder.exportFunction("callDirect", builder.addFunction(i32ToI32, { }, WasmCode().localGet(0).call(doubleIndex).i32Const(1).op(WasmOp::I32Add)));
+    builder.exportFunction("callIndirect", builder.addFunction(i32I32ToI32, { }, WasmCode().localGet(0).localGet(1).callIndirect(i32ToI32)));
+    builder.exportFunction("storeLoad", builder.addFunction(i32ToI32, { },
+        WasmCode().i32Const(8).localGet(0).memoryAccess(WasmOp::I32Store, 2).i32Const(8).memoryAccess(WasmOp::I32Load, 2)));
+    builder.exportFunction("grow", builder.addFunction(i32ToI32, { }, WasmCode().localGet(0).memoryGrow()));
+    builder.exportFunction("popcnt", builder.addFunction(i32ToI32, { }, WasmCode().localGet(0).op(WasmOp::I32Popcnt)));
+    builder.exportFunction("divide", builder.addFunction(i32I32ToI32, { }, WasmCode().localGet(0).localGet(1).op(WasmOp::I32DivS)));
+    builder.exportFunction("unreachable", builder.addFunction(toI32, { }, WasmCode().unreachable()));
+
+    // Sums the integers below n.
+    WasmCode loop;
+    loop.block().loop();
+    loop.localGet(1).localGet(0).op(WasmOp::I32GeS).brIf(1);
+    loop.localGet(2).localGet(1).op(WasmOp::I32Add).localSet(2);
+    loop.localGet(1).i32Const(1).op(WasmOp::I32Add).localSet(1);
+    loop.br(0).end().end();
+    loop.localGet(2);
+    builder.exportFunction("sum", builder.addFunction(i32ToI32, { { 2, WasmType::I32 } }, loop));
+
+    return builder.build();
+}
+
+static const char* const roundTripScript =
+    "function traps(f) { try { f(); } catch (e) { return e instanceof WebAssembly.RuntimeError; } return false; }"
+    "function exercise(module) {"
+    "    var e = new WebAssembly.Instance(module).exports;"
+    "    var result = e.double(21) === 42"
+    "        && e.callDirect(20) === 41"
+    "        && e.callIndirect(5, 0) === 10"
+    "        && e.callIndirect(5, 1) === 25"
+    "        && traps(function() { e.callIndirect(5, 2); })"
+    "        && e.storeLoad(1234) === 1234"
+    "        && e.grow(1) === 1"
+    "        && e.grow(0) === 2"
+    "        && e.popcnt(0xff00ff) === 16"
+    "        && e.divide(7, 2) === 3"
+    "        && traps(function() { e.divide(1, 0); })"
+    "        && traps(function() { e.unreachable(); });"
+    // Enough iterations to tier up the loop while it runs, and enough calls to tier up the callees.
+    "    for (var i = 0; i < 100; ++i) {"
+    "        if (e.sum(10000) !== 49995000 || e.callDirect(i) !== 2 * i + 1)"
+    "            result = false;"
+    "    }"
+    "    return result;"
+    "}"
+    "var module = new WebAssembly.Module(moduleBytes);"
+    "var original = exercise(module);"
+    "var serialized = serializeModule(module);"
+    "var deserialized = deserializeModule(serialized);"
+    "var reserialized = serializeModule(deserialized);"
+    "original";
+
+// Finds the relocation for the Callee that the prologue of the first function in a serialized module
+// stores, which patches a pointer.
+static const char* const corruptionScript =
+    "function calleeRelocation(bytes) {"
+    "    var view = new DataView(bytes.buffer);"
+    "    var cursor = 8;"
+    "    cursor += 4 + view.getUint32(cursor, true);"
+    "    cursor += 2;"
+    "    var codeSize = view.getUint32(cursor, true);"
+    "    cursor += 4 + codeSize + 1;"
+    "    var relocationCount = view.getUint32(cursor, true);"
+    "    for (cursor += 4; relocationCount--; cursor += 9) {"
+    "        if (!view.getUint8(cursor + 4))"
+    "            return { codeSize: codeSize, offsetPosition: cursor };"
+    "    }"
+    "    return null;"
+    "}"
+    "function rejects(bytes) {"
+    "    try { deserializeModule(bytes); } catch (e) { return e instanceof WebAssembly.CompileError; }"
+    "    return false;"
+    "}"
+    "var relocation = calleeRelocation(serialized);"
+    "var outOfBounds = new Uint8Array(serialized);"
+    // A pointer is patched in front of its location on x86-64, and after it elsewhere.
+    "new DataView(outOfBounds.buffer).setUint32(relocation.offsetPosition, patchedBackwards ? 2 : relocation.codeSize - 2, true);"
+    "var wrongVersion = new Uint8Array(serialized);"
+    "wrongVersion[4] ^= 1;"
+    "relocation"
+    "    && rejects(outOfBounds)"
+    "    && rejects(wrongVersion)"
+    "    && rejects(serialized.slice(0, serialized.length - 1))"
+    "    && rejects(new Uint8Array(0))";
+
+#endif // ENABLE(WEBASSEMBLY)
+
+int testWasmModuleSerialization()
+{
+    bool overallResult = true;
+    auto test = [&] (const char* description, bool currentResult) {
+        printf("    %s: %s\n", description, currentResult ? "PASS" : "FAIL");
+        overallResult &= currentResult;
+    };
+
+    printf("WasmModuleSerializationTest:\n");
+
+#if ENABLE(WEBASSEMBLY)
+    Options::initialize(); // Ensure options is initialized first.
+    Vector<uint8_t> module = makeModule();
+
+    JSGlobalContextRef context = JSGlobalContextCreateInGroup(nullptr, nullptr);
+    setWasmModuleBytes(context, "moduleBytes", module);
+    JSObjectRef globalObject = JSContextGetGlobalObject(context);
+    JSStringRef name = JSStringCreateWithUTF8CString("serializeModule");
+    JSObjectSetProperty(context, globalObject, name, JSObjectMakeFunctionWithCallback(context, name, serializeModule), kJSPropertyAttributeNone, nullptr);
+    JSStringRelease(name);
+    name = JSStringCreateWithUTF8CString("deserializeModule");
+    JSObjectSetProperty(context, globalObject, name, JSObjectMakeFunctionWithCallback(context, name, deserializeModule), kJSPropertyAttributeNone, nullptr);
+    JSStringRelease(name);
+    name = JSStringCreateWithUTF8CString("patchedBackwards");
+    JSObjectSetProperty(context, globalObject, name, JSValueMakeBoolean(context, pointersArePatchedBackwards), kJSPropertyAttributeNone, nullptr);
+    JSStringRelease(name);
+
+    test("BBQ code is not relocatable by default", !Options::useRelocatableBBQCode() && wasmTestScriptReturnsTrue(context,
+        "var unrelocatable = new WebAssembly.Module(moduleBytes);"
+        "new WebAssembly.Instance(unrelocatable);"
+        "try { serializeModule(unrelocatable); false; } catch (e) { String(e).indexOf('without relocations') >= 0; }"));
+
+    if (MacroAssembler::supportsFloatingPointRounding()) {
+        bool oldUseRelocatableBBQCode = Options::useRelocatableBBQCode();
+        Options::useRelocatableBBQCode() = true;
+
+        test("the original module runs", wasmTestScriptReturnsTrue(context, roundTripScript));
+        test("a deserialized module runs, and tiers up", wasmTestScriptReturnsTrue(context, "exercise(deserialized)"));
+        // The patched pointers differ between the two copies, but nothing else should.
+        test("a deserialized module serializes again",
+            wasmTestScriptReturnsTrue(context, "reserialized.length === serialized.length && exercise(deserializeModule(reserialized))"));
+        test("corrupted modules are rejected", wasmTestScriptReturnsTrue(context, corruptionScript));
+
+        Options::useRelocatableBBQCode() = oldUseRelocatableBBQCode;
+    } else
+        printf("    Skipping serialization, since this CPU doesn't have floating point rounding instructions.\n");
+
+    JSGlobalContextRelease(context);
+#endif
+
+    printf("WasmModuleSerializationTest: %s\n", overallResult ? "PASS" : "FAIL");
+    return !overallResult;
+}
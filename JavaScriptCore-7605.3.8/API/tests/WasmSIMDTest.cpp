@@ -0,0 +1,264 @@
+/*
+ * Copyright (C) 2018 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "WasmSIMDTest.h"
+
+#include "JavaScript.h"
+#include "MacroAssembler.h"
+#include "Options.h"
+#include "WasmModuleBuilder.h"
+#include <stdio.h>
+
+#if ENABLE(WEBASSEMBLY) && CPU(X86_64)
+
+using JSC::MacroAssembler;
+using JSC::Options;
+
+// The opcodes that follow the 0xfd prefix.
+enum SIMDOpcode : uint32_t {
+    V128Load = 0,
+    V128Store = 11,
+    V128Const = 12,
+    I8x16Splat = 15,
+    I16x8Splat = 16,
+    I32x4Splat = 17,
+    I64x2Splat = 18,
+    F32x4Splat = 19,
+    F64x2Splat = 20,
+    I32x4ExtractLane = 27,
+    I32x4ReplaceLane = 28,
+    I64x2ExtractLane = 29,
+    F32x4ExtractLane = 31,
+    F64x2ExtractLane = 33,
+    F64x2ReplaceLane = 34,
+    V128Not = 77,
+    V128And = 78,
+    V128Andnot = 79,
+    V128Or = 80,
+    V128Xor = 81,
+    I8x16Add = 110,
+    I16x8Mul = 149,
+    I32x4Add = 174,
+    I32x4Mul = 181,
+    I64x2Add = 206,
+    F32x4Sqrt = 227,
+    F64x2Add = 240,
+    F64x2Div = 243,
+};
+
+static const uint8_t I64Eq = 0x51;
+
+// The bytes 0 to 15, so lane i of an i32x4 view is 0x(4i+3)(4i+2)(4i+1)(4i).
+static WasmCode& ascendingBytes(WasmCode& code)
+{
+    return code.simd(V128Const).bytes({ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 });
+}
+
+static Vector<uint8_t> makeSIMDModule()
+{
+    WasmModuleBuilder builder;
+    uint32_t i32ToI32 = builder.addType({ WasmType::I32 }, { WasmType::I32 });
+    uint32_t f64ToF64 = builder.addType({ WasmType::F64 }, { WasmType::F64 });
+    uint32_t toI32 = builder.addType({ }, { WasmType::I32 });
+    uint32_t toF32 = builder.addType({ }, { WasmType::F32 });
+    uint32_t toF64 = builder.addType({ }, { WasmType::F64 });
+    builder.setMemory(1);
+
+    auto addFunction = [&] (const char* name, uint32_t type, std::initializer_list<std::pair<uint32_t, WasmType>> locals, const WasmCode& code) {
+        builder.exportFunction(name, builder.addFunction(type, locals, code));
+    };
+
+    // Accumulates [7, 7, 7, 11] n times. The vectors stay live across the loop's tier up check, and the
+    // last lane is in the upper half of the register.
+    {
+        WasmCode code;
+        code.i32Const(7).simd(I32x4Splat).i32Const(11).simd(I32x4ReplaceLane).op(3).localSet(2);
+        code.loop();
+        code.localGet(1).localGet(2).simd(I32x4Add).localSet(1);
+        code.localGet(3).i32Const(1).op(WasmOp::I32Add).localTee(3).localGet(0).op(WasmOp::I32LtS).brIf(0);
+        code.end();
+        code.localGet(1).simd(I32x4ExtractLane).op(3);
+        addFunction("i32x4AcrossTierUp", i32ToI32, { { 2, WasmType::V128 }, { 1, WasmType::I32 } }, code);
+    }
+
+    // Adds [x, 2x] up 100 times and returns the upper lane.
+    {
+        WasmCode code;
+        code.localGet(0).simd(F64x2Splat).localGet(0).localGet(0).op(WasmOp::F64Add).simd(F64x2ReplaceLane).op(1).localSet(2);
+        code.loop();
+        code.localGet(1).localGet(2).simd(F64x2Add).localSet(1);
+        code.localGet(3).i32Const(1).op(WasmOp::I32Add).localTee(3).i32Const(100).op(WasmOp::I32LtS).brIf(0);
+        code.end();
+        code.localGet(1).simd(F64x2ExtractLane).op(1);
+        addFunction("f64x2AcrossTierUp", f64ToF64, { { 2, WasmType::V128 }, { 1, WasmType::I32 } }, code);
+    }
+
+    {
+        WasmCode code;
+        ascendingBytes(code).i32Const(0x0f0f0f0f).simd(I32x4Splat).simd(V128And).simd(I32x4ExtractLane).op(1);
+        addFunction("and", toI32, { }, code);
+    }
+    {
+        WasmCode code;
+        ascendingBytes(code).i32Const(0x0f0f0f0f).simd(I32x4Splat).simd(V128Or).simd(I32x4ExtractLane).op(2);
+        addFunction("or", toI32, { }, code);
+    }
+    {
+        WasmCode code;
+        ascendingBytes(code).i32Const(0x0f0f0f0f).simd(I32x4Splat).simd(V128Xor).simd(I32x4ExtractLane).op(3);
+        addFunction("xor", toI32, { }, code);
+    }
+    {
+        WasmCode code;
+        ascendingBytes(code).simd(V128Not).simd(I32x4ExtractLane).op(0);
+        addFunction("not", toI32, { }, code);
+    }
+    {
+        WasmCode code;
+        ascendingBytes(code).i32Const(0xffff).simd(I32x4Splat).simd(V128Andnot).simd(I32x4ExtractLane).op(3);
+        addFunction("andnot", toI32, { }, code);
+    }
+    {
+        WasmCode code;
+        code.i32Const(200).simd(I8x16Splat).i32Const(100).simd(I8x16Splat).simd(I8x16Add).simd(I32x4ExtractLane).op(2);
+        addFunction("i8x16AddWraps", toI32, { }, code);
+    }
+    {
+        WasmCode code;
+        code.i32Const(300).simd(I16x8Splat).i32Const(300).simd(I16x8Splat).simd(I16x8Mul).simd(I32x4ExtractLane).op(1);
+        addFunction("i16x8MulWraps", toI32, { }, code);
+    }
+    {
+        WasmCode code;
+        code.i32Const(3).simd(I32x4Splat);
+        ascendingBytes(code).simd(I32x4Mul).simd(I32x4ExtractLane).op(2);
+        addFunction("i32x4Mul", toI32, { }, code);
+    }
+    {
+        WasmCode code;
+        code.i64Const(0x100000000).simd(I64x2Splat).i64Const(0xffffffff).simd(I64x2Splat).simd(I64x2Add).simd(I64x2ExtractLane).op(1);
+        code.i64Const(0x1ffffffff).op(I64Eq);
+        addFunction("i64x2Add", toI32, { }, code);
+    }
+    {
+        WasmCode code;
+        code.f32Const(16).simd(F32x4Splat).simd(F32x4Sqrt).simd(F32x4ExtractLane).op(3);
+        addFunction("f32x4Sqrt", toF32, { }, code);
+    }
+    {
+        WasmCode code;
+        code.f64Const(1).simd(F64x2Splat).f64Const(4).simd(F64x2Splat).simd(F64x2Div).simd(F64x2ExtractLane).op(1);
+        addFunction("f64x2Div", toF64, { }, code);
+    }
+
+    // Stores a vector at 16, loads it back and returns its last lane, which ends at byte 31.
+    {
+        WasmCode code;
+        code.i32Const(16);
+        ascendingBytes(code).simd(V128Store).u32(4).u32(0);
+        code.i32Const(16).simd(V128Load).u32(4).u32(0).simd(I32x4ExtractLane).op(3);
+        code.i32Const(28).memoryAccess(WasmOp::I32Load, 2).op(WasmOp::I32Eq);
+        addFunction("memory", toI32, { }, code);
+    }
+
+    {
+        WasmCode code;
+        ascendingBytes(code).i32Const(-1).simd(I32x4Splat).localGet(0).select().simd(I32x4ExtractLane).op(3);
+        addFunction("select", i32ToI32, { }, code);
+    }
+
+    return builder.build();
+}
+
+static const char* const simdScript =
+    "var instance = new WebAssembly.Instance(new WebAssembly.Module(simdModule));"
+    "var exports = instance.exports;"
+    "var result = true;"
+    "for (var i = 0; i < 50; ++i) {"
+    "    if (exports.i32x4AcrossTierUp(1000) !== 11000 || exports.f64x2AcrossTierUp(1.5) !== 300)"
+    "        result = false;"
+    "}"
+    "result = result"
+    "    && exports.and() === 0x07060504"
+    "    && exports.or() === 0x0f0f0f0f"
+    "    && exports.xor() === 0x00010203"
+    "    && exports.not() === ~0x03020100"
+    "    && exports.andnot() === 0x0f0e0000"
+    "    && exports.i8x16AddWraps() === 0x2c2c2c2c"
+    "    && exports.i16x8MulWraps() === 0x5f905f90"
+    "    && exports.i32x4Mul() === 0x211e1b18"
+    "    && exports.i64x2Add() === 1"
+    "    && exports.f32x4Sqrt() === 4"
+    "    && exports.f64x2Div() === 0.25"
+    "    && exports.memory() === 1"
+    "    && exports.select(1) === 0x0f0e0d0c"
+    "    && exports.select(0) === -1;"
+    "result";
+
+#endif // ENABLE(WEBASSEMBLY) && CPU(X86_64)
+
+int testWasmSIMD()
+{
+    bool overallResult = true;
+    auto test = [&] (const char* description, bool currentResult) {
+        printf("    %s: %s\n", description, currentResult ? "PASS" : "FAIL");
+        overallResult &= currentResult;
+    };
+
+    printf("WasmSIMDTest:\n");
+
+#if ENABLE(WEBASSEMBLY) && CPU(X86_64)
+    Options::initialize(); // Ensure options is initialized first.
+    Vector<uint8_t> module = makeSIMDModule();
+
+    {
+        JSGlobalContextRef context = JSGlobalContextCreateInGroup(nullptr, nullptr);
+        setWasmModuleBytes(context, "simdModule", module);
+        test("SIMD is off by default", !Options::useWebAssemblySIMD() && wasmTestScriptReturnsTrue(context, "!WebAssembly.validate(simdModule)"));
+        JSGlobalContextRelease(context);
+    }
+
+    if (MacroAssembler::supportsVectorOperations()) {
+        bool oldUseWebAssemblySIMD = Options::useWebAssemblySIMD();
+        unsigned oldOMGTierUpCount = Options::webAssemblyOMGTierUpCount();
+        Options::useWebAssemblySIMD() = true;
+        // Tier up early, while the loops still have vectors live.
+        Options::webAssemblyOMGTierUpCount() = 100;
+
+        JSGlobalContextRef context = JSGlobalContextCreateInGroup(nullptr, nullptr);
+        setWasmModuleBytes(context, "simdModule", module);
+        test("SIMD instructions", wasmTestScriptReturnsTrue(context, simdScript));
+        JSGlobalContextRelease(context);
+
+        Options::useWebAssemblySIMD() = oldUseWebAssemblySIMD;
+        Options::webAssemblyOMGTierUpCount() = oldOMGTierUpCount;
+    } else
+        printf("    Skipping SIMD instructions, since this CPU doesn't support them.\n");
+#endif
+
+    printf("WasmSIMDTest: %s\n", overallResult ? "PASS" : "FAIL");
+    return !overallResult;
+}
@@ -0,0 +1,321 @@
+/*
+ * Copyright (C) 2018 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "WasmSinglePassTest.h"
+
+#include "APICast.h"
+#include "JSCInlines.h"
+#include "JSWebAssemblyModule.h"
+#include "JavaScript.h"
+#include "MacroAssembler.h"
+#include "Options.h"
+#include "WasmModuleBuilder.h"
+#include "WasmModuleSerialization.h"
+#include <stdio.h>
+
+#if ENABLE(WEBASSEMBLY) && CPU(X86_64)
+
+using namespace JSC;
+
+// Single-pass code doesn't record relocations, so an instantiated module that has any of it can't be
+// serialized, even with useRelocatableBBQCode on. Serializing needs SSE4.1 before it gets that far.
+static JSValueRef compiledInSinglePass(JSContextRef context, JSObjectRef, JSObjectRef, size_t argumentCount, const JSValueRef arguments[], JSValueRef*)
+{
+    ExecState* exec = toJS(context);
+    VM& vm = exec->vm();
+    JSLockHolder locker(vm);
+    auto* module = argumentCount ? jsDynamicCast<JSWebAssemblyModule*>(vm, toJS(exec, arguments[0])) : nullptr;
+    if (!module)
+        return JSValueMakeBoolean(context, false);
+    if (!MacroAssembler::supportsFloatingPointRounding())
+        return JSValueMakeBoolean(context, true);
+    auto serialized = Wasm::serializeModule(module->module());
+    return JSValueMakeBoolean(context, !serialized && serialized.error().contains("without relocations"));
+}
+
+static Vector<uint8_t> makeBrTableModule()
+{
+    WasmModuleBuilder builder;
+    uint32_t i32ToI32 = builder.addType({ WasmType::I32 }, { WasmType::I32 });
+
+    WasmCode dispatch;
+    dispatch.block().block().block().block();
+    dispatch.localGet(0).brTable({ 0, 1, 2 }, 3);
+    dispatch.end().i32Const(10).ret();
+    dispatch.end().i32Const(11).ret();
+    dispatch.end().i32Const(12).ret();
+    dispatch.end().i32Const(13);
+    builder.exportFunction("dispatch", builder.addFunction(i32ToI32, { }, dispatch));
+
+    // Branches carry 7 out of either block.
+    WasmCode carry;
+    carry.block(WasmType::I32).block(WasmType::I32);
+    carry.i32Const(7).localGet(0).brTable({ 0 }, 1);
+    carry.end().i32Const(1).op(WasmOp::I32Add);
+    carry.end();
+    builder.exportFunction("carry", builder.addFunction(i32ToI32, { }, carry));
+
+    // Counts down to zero, using br_table to either leave or go around the loop.
+    WasmCode countDown;
+    countDown.block().loop();
+    countDown.localGet(1).i32Const(1).op(WasmOp::I32Add).localSet(1);
+    countDown.localGet(0).i32Const(1).op(WasmOp::I32Sub).localTee(0);
+    countDown.brTable({ 1 }, 0);
+    countDown.end().end();
+    countDown.localGet(1);
+    builder.exportFunction("countDown", builder.addFunction(i32ToI32, { { 1, WasmType::I32 } }, countDown));
+
+    return builder.build();
+}
+
+static Vector<uint8_t> makeCallIndirectModule()
+{
+    WasmModuleBuilder builder;
+    uint32_t i32ToI32 = builder.addType({ WasmType::I32 }, { WasmType::I32 });
+    uint32_t i32I32ToI32 = builder.addType({ WasmType::I32, WasmType::I32 }, { WasmType::I32 });
+    uint32_t add1Index = builder.importFunction("env", "add1", i32ToI32);
+    builder.setTable(5);
+
+    uint32_t doubleIndex = builder.addFunction(i32ToI32, { }, WasmCode().localGet(0).i32Const(2).op(WasmOp::I32Mul));
+    uint32_t squareIndex = builder.addFunction(i32ToI32, { }, WasmCode().localGet(0).localGet(0).op(WasmOp::I32Mul));
+    uint32_t addIndex = builder.addFunction(i32I32ToI32, { }, WasmCode().localGet(0).localGet(1).op(WasmOp::I32Add));
+    // The last entry of the table is left empty.
+    builder.addElements(0, { doubleIndex, squareIndex, addIndex, add1Index });
+
+    builder.exportFunction("callIndirect", builder.addFunction(i32I32ToI32, { }, WasmCode().localGet(0).localGet(1).callIndirect(i32ToI32)));
+    builder.exportFunction("callImport", builder.addFunction(i32ToI32, { }, WasmCode().localGet(0).call(add1Index).i32Const(1).op(WasmOp::I32Add)));
+    return builder.build();
+}
+
+static Vector<uint8_t> makeTierUpModule()
+{
+    WasmModuleBuilder builder;
+    uint32_t i32ToI32 = builder.addType({ WasmType::I32 }, { WasmType::I32 });
+    uint32_t incIndex = builder.addFunction(i32ToI32, { }, WasmCode().localGet(0).i32Const(1).op(WasmOp::I32Add));
+
+    // Adds up i * (i + 1) for the i below n in an i64, which is live across the tier up checks at the
+    // loop header and the calls.
+    WasmCode sum;
+    sum.block().loop();
+    sum.localGet(1).localGet(0).op(WasmOp::I32GeS).brIf(1);
+    sum.localGet(2);
+    sum.localGet(1).call(incIndex).op(WasmOp::I64ExtendUI32);
+    sum.localGet(1).op(WasmOp::I64ExtendUI32).op(WasmOp::I64Mul);
+    sum.op(WasmOp::I64Add).localSet(2);
+    sum.localGet(1).call(incIndex).localSet(1);
+    sum.br(0).end().end();
+    sum.localGet(2).op(WasmOp::I32WrapI64);
+    builder.exportFunction("sum", builder.addFunction(i32ToI32, { { 1, WasmType::I32 }, { 1, WasmType::I64 } }, sum));
+    return builder.build();
+}
+
+static Vector<uint8_t> makeMemoryModule()
+{
+    WasmModuleBuilder builder;
+    uint32_t i32ToI32 = builder.addType({ WasmType::I32 }, { WasmType::I32 });
+    uint32_t i32I32ToVoid = builder.addType({ WasmType::I32, WasmType::I32 }, { });
+    uint32_t toI32 = builder.addType({ }, { WasmType::I32 });
+    uint32_t toF32 = builder.addType({ }, { WasmType::F32 });
+    uint32_t toF64 = builder.addType({ }, { WasmType::F64 });
+    builder.setMemory(1, 3);
+    builder.exportMemory("memory");
+
+    auto addLoad = [&] (const char* name, uint8_t op, uint32_t alignment, uint32_t offset = 0) {
+        builder.exportFunction(name, builder.addFunction(i32ToI32, { }, WasmCode().localGet(0).memoryAccess(op, alignment, offset)));
+    };
+    addLoad("load8S", WasmOp::I32Load8S, 0);
+    addLoad("load8U", WasmOp::I32Load8U, 0);
+    addLoad("load16S", WasmOp::I32Load16S, 1);
+    addLoad("load16U", WasmOp::I32Load16U, 1);
+    addLoad("load32", WasmOp::I32Load, 2);
+    // The offset alone is out of bounds of any memory.
+    addLoad("loadWithHugeOffset", WasmOp::I32Load, 2, 0xffffffff);
+
+    auto addStore = [&] (const char* name, uint8_t op, uint32_t alignment) {
+        builder.exportFunction(name, builder.addFunction(i32I32ToVoid, { }, WasmCode().localGet(0).localGet(1).memoryAccess(op, alignment)));
+    };
+    addStore("store8", WasmOp::I32Store8, 0);
+    addStore("store16", WasmOp::I32Store16, 1);
+    addStore("store32", WasmOp::I32Store, 2);
+
+    // Stores value in both halves of an i64.
+    WasmCode store64;
+    store64.localGet(0);
+    store64.localGet(1).op(WasmOp::I64ExtendUI32).i64Const(32).op(WasmOp::I64Shl);
+    store64.localGet(1).op(WasmOp::I64ExtendUI32).op(WasmOp::I64Or);
+    store64.memoryAccess(WasmOp::I64Store, 3);
+    builder.exportFunction("store64", builder.addFunction(i32I32ToVoid, { }, store64));
+    builder.exportFunction("store32From64", builder.addFunction(i32I32ToVoid, { },
+        WasmCode().localGet(0).i64Const(0x123456789).memoryAccess(WasmOp::I64Store32, 2)));
+    builder.exportFunction("load64Low", builder.addFunction(i32ToI32, { }, WasmCode().localGet(0).memoryAccess(WasmOp::I64Load, 3).op(WasmOp::I32WrapI64)));
+    // The upper half of a sign extended load, so -1 for negative values and 0 otherwise.
+    builder.exportFunction("load32S64High", builder.addFunction(i32ToI32, { },
+        WasmCode().localGet(0).memoryAccess(WasmOp::I64Load32S, 2).i64Const(32).op(WasmOp::I64ShrS).op(WasmOp::I32WrapI64)));
+
+    builder.exportFunction("f32RoundTrip", builder.addFunction(toF32, { },
+        WasmCode().i32Const(16).f32Const(1.5).memoryAccess(WasmOp::F32Store, 2).i32Const(16).memoryAccess(WasmOp::F32Load, 2)));
+    builder.exportFunction("f64RoundTrip", builder.addFunction(toF64, { },
+        WasmCode().i32Const(24).f64Const(0.1).memoryAccess(WasmOp::F64Store, 3).i32Const(24).memoryAccess(WasmOp::F64Load, 3)));
+
+    builder.exportFunction("popcnt32", builder.addFunction(i32ToI32, { }, WasmCode().localGet(0).op(WasmOp::I32Popcnt)));
+    WasmCode popcnt64;
+    popcnt64.localGet(0).op(WasmOp::I64ExtendUI32).i64Const(32).op(WasmOp::I64Shl);
+    popcnt64.localGet(0).op(WasmOp::I64ExtendUI32).op(WasmOp::I64Or);
+    popcnt64.op(WasmOp::I64Popcnt).op(WasmOp::I32WrapI64);
+    builder.exportFunction("popcnt64", builder.addFunction(i32ToI32, { }, popcnt64));
+
+    builder.exportFunction("size", builder.addFunction(toI32, { }, WasmCode().memorySize()));
+    builder.exportFunction("grow", builder.addFunction(i32ToI32, { }, WasmCode().localGet(0).memoryGrow()));
+    return builder.build();
+}
+
+static const char* const brTableScript =
+    "var module = new WebAssembly.Module(brTableModule);"
+    "var e = new WebAssembly.Instance(module).exports;"
+    "compiledInSinglePass(module)"
+    "    && e.dispatch(0) === 10 && e.dispatch(1) === 11 && e.dispatch(2) === 12"
+    "    && e.dispatch(3) === 13 && e.dispatch(-1) === 13 && e.dispatch(1000) === 13"
+    "    && e.carry(0) === 8 && e.carry(1) === 7 && e.carry(-1) === 7"
+    "    && e.countDown(1) === 1 && e.countDown(100) === 100";
+
+static const char* const callIndirectScript =
+    "function traps(f) { try { f(); } catch (e) { return e instanceof WebAssembly.RuntimeError; } return false; }"
+    "var module = new WebAssembly.Module(callIndirectModule);"
+    "var e = new WebAssembly.Instance(module, { env: { add1: function(x) { return x + 1; } } }).exports;"
+    "compiledInSinglePass(module)"
+    "    && e.callIndirect(5, 0) === 10"
+    "    && e.callIndirect(5, 1) === 25"
+    "    && traps(function() { e.callIndirect(5, 2); })"
+    "    && e.callIndirect(5, 3) === 6"
+    "    && traps(function() { e.callIndirect(5, 4); })"
+    "    && traps(function() { e.callIndirect(5, 5); })"
+    "    && traps(function() { e.callIndirect(5, -1); })"
+    "    && e.callImport(5) === 7";
+
+static const char* const tierUpScript =
+    "function expectedSum(n) {"
+    "    var sum = 0;"
+    "    for (var i = 0; i < n; ++i)"
+    "        sum = (sum + i * (i + 1)) % 0x100000000;"
+    "    return sum | 0;"
+    "}"
+    "var module = new WebAssembly.Module(tierUpModule);"
+    "var e = new WebAssembly.Instance(module).exports;"
+    "var result = compiledInSinglePass(module);"
+    "var expected = expectedSum(10000);"
+    "for (var i = 0; i < 50; ++i) {"
+    "    if (e.sum(10000) !== expected || e.sum(i) !== expectedSum(i))"
+    "        result = false;"
+    "}"
+    "result";
+
+static const char* const memoryScript =
+    "function traps(f) { try { f(); } catch (e) { return e instanceof WebAssembly.RuntimeError; } return false; }"
+    "var module = new WebAssembly.Module(memoryModule);"
+    "var e = new WebAssembly.Instance(module).exports;"
+    "var view = new DataView(e.memory.buffer);"
+    "view.setUint16(0, 0xff80, true);"
+    "view.setInt32(40, -5, true);"
+    "e.store8(4, 0x1234);"
+    "e.store16(8, 0x12345678);"
+    "e.store32(65532, 7);"
+    "e.store64(32, 0x01020304);"
+    "view.setUint32(52, 0xffffffff, true);"
+    "e.store32From64(48, 0);"
+    "compiledInSinglePass(module)"
+    "    && e.load8S(0) === -128 && e.load8U(0) === 0x80"
+    "    && e.load16S(0) === -128 && e.load16U(0) === 0xff80"
+    "    && view.getUint8(4) === 0x34 && view.getUint8(5) === 0"
+    "    && view.getUint16(8, true) === 0x5678 && view.getUint16(10, true) === 0"
+    "    && e.load32(65532) === 7"
+    "    && view.getUint32(32, true) === 0x01020304 && view.getUint32(36, true) === 0x01020304 && e.load64Low(40) === -5"
+    "    && e.load32S64High(40) === -1 && e.load32S64High(32) === 0"
+    "    && view.getUint32(48, true) === 0x23456789 && view.getUint32(52, true) === 0xffffffff"
+    "    && e.f32RoundTrip() === 1.5 && e.f64RoundTrip() === 0.1"
+    "    && e.popcnt32(0xff00ff) === 16 && e.popcnt32(-1) === 32 && e.popcnt32(0) === 0"
+    "    && e.popcnt64(0xff00ff) === 32 && e.popcnt64(-1) === 64"
+    "    && traps(function() { e.load32(65533); })"
+    "    && traps(function() { e.store32(65533, 1); })"
+    "    && traps(function() { e.load8U(65536); })"
+    "    && traps(function() { e.load32(-1); })"
+    "    && traps(function() { e.loadWithHugeOffset(0); })"
+    "    && e.size() === 1 && e.grow(1) === 1 && e.size() === 2"
+    "    && e.load32(65536 + 8) === 0"
+    "    && (e.store32(65536 + 8, 5), e.load32(65536 + 8) === 5)"
+    "    && e.grow(5) === -1"
+    "    && traps(function() { e.load32(2 * 65536); })";
+
+#endif // ENABLE(WEBASSEMBLY) && CPU(X86_64)
+
+int testWasmSinglePass()
+{
+    bool overallResult = true;
+    auto test = [&] (const char* description, bool currentResult) {
+        printf("    %s: %s\n", description, currentResult ? "PASS" : "FAIL");
+        overallResult &= currentResult;
+    };
+
+    printf("WasmSinglePassTest:\n");
+
+#if ENABLE(WEBASSEMBLY) && CPU(X86_64)
+    Options::initialize(); // Ensure options is initialized first.
+    bool oldUseWebAssemblySinglePassTier = Options::useWebAssemblySinglePassTier();
+    bool oldUseRelocatableBBQCode = Options::useRelocatableBBQCode();
+    unsigned oldOMGTierUpCount = Options::webAssemblyOMGTierUpCount();
+    Options::useRelocatableBBQCode() = true;
+    // Tier up during the first call, while the loop is running.
+    Options::webAssemblyOMGTierUpCount() = 100;
+
+    JSGlobalContextRef context = JSGlobalContextCreateInGroup(nullptr, nullptr);
+    setWasmModuleBytes(context, "brTableModule", makeBrTableModule());
+    setWasmModuleBytes(context, "callIndirectModule", makeCallIndirectModule());
+    setWasmModuleBytes(context, "tierUpModule", makeTierUpModule());
+    setWasmModuleBytes(context, "memoryModule", makeMemoryModule());
+    JSStringRef name = JSStringCreateWithUTF8CString("compiledInSinglePass");
+    JSObjectSetProperty(context, JSContextGetGlobalObject(context), name, JSObjectMakeFunctionWithCallback(context, name, compiledInSinglePass), kJSPropertyAttributeNone, nullptr);
+    JSStringRelease(name);
+
+    Options::useWebAssemblySinglePassTier() = false;
+    test("BBQ code is told apart from single-pass code", !MacroAssembler::supportsFloatingPointRounding() || wasmTestScriptReturnsTrue(context,
+        "var bbqModule = new WebAssembly.Module(memoryModule);"
+        "new WebAssembly.Instance(bbqModule);"
+        "!compiledInSinglePass(bbqModule)"));
+
+    Options::useWebAssemblySinglePassTier() = true;
+    test("br_table", wasmTestScriptReturnsTrue(context, brTableScript));
+    test("call_indirect and calls to imports", wasmTestScriptReturnsTrue(context, callIndirectScript));
+    test("tier up to OMG", wasmTestScriptReturnsTrue(context, tierUpScript));
+    test("memory accesses, bounds checks and growth", wasmTestScriptReturnsTrue(context, memoryScript));
+
+    JSGlobalContextRelease(context);
+    Options::useWebAssemblySinglePassTier() = oldUseWebAssemblySinglePassTier;
+    Options::useRelocatableBBQCode() = oldUseRelocatableBBQCode;
+    Options::webAssemblyOMGTierUpCount() = oldOMGTierUpCount;
+#endif
+
+    printf("WasmSinglePassTest: %s\n", overallResult ? "PASS" : "FAIL");
+    return !overallResult;
+}
@@ -0,0 +1,351 @@
+/*
+ * Copyright (C) 2018 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "WasmStreamingTest.h"
+
+#include "APICast.h"
+#include "CatchScope.h"
+#include "Exception.h"
+#include "JSCInlines.h"
+#include "JSWebAssemblyModule.h"
+#include "JavaScript.h"
+#include "Options.h"
+#include "WasmModule.h"
+#include "WasmModuleBuilder.h"
+#include "WasmModuleInformation.h"
+#include "WasmStreamingParser.h"
+#include "WasmStreamingPlan.h"
+#include <stdio.h>
+#include <wtf/Condition.h>
+#include <wtf/Lock.h>
+
+#if ENABLE(WEBASSEMBLY)
+
+using namespace JSC;
+
+// Imports a function, so that the Code section's indices don't start at zero, and has a body that
+// is long enough for its size to take two bytes. With invalidFunction, the second body doesn't validate.
+static Vector<uint8_t> makeModule(bool invalidFunction = false)
+{
+    WasmModuleBuilder builder;
+    uint32_t i32I32ToI32 = builder.addType({ WasmType::I32, WasmType::I32 }, { WasmType::I32 });
+    uint32_t i32ToI32 = builder.addType({ WasmType::I32 }, { WasmType::I32 });
+    uint32_t toI32 = builder.addType({ }, { WasmType::I32 });
+    uint32_t twiceIndex = builder.importFunction("env", "twice", i32ToI32);
+    builder.setMemory(1);
+
+    builder.exportFunction("add", builder.addFunction(i32I32ToI32, { }, WasmCode().localGet(0).localGet(1).op(WasmOp::I32Add)));
+
+    WasmCode bigConstant;
+    if (invalidFunction)
+        bigConstant.op(WasmOp::I32Add);
+    else {
+        bigConstant.i32Const(1000000);
+        for (unsigned i = 1; i < 40; ++i)
+            bigConstant.i32Const(1000000).op(WasmOp::I32Add);
+    }
+    builder.exportFunction("bigConstant", builder.addFunction(toI32, { }, bigConstant));
+
+    builder.exportFunction("callImport", builder.addFunction(i32ToI32, { }, WasmCode().localGet(0).call(twiceIndex).i32Const(1).op(WasmOp::I32Add)));
+    return builder.build();
+}
+
+static Vector<uint8_t> moduleWithSections(std::initializer_list<std::initializer_list<uint8_t>> sections)
+{
+    Vector<uint8_t> result;
+    result.append(reinterpret_cast<const uint8_t*>("\0asm\1\0\0\0"), 8);
+    for (auto& section : sections)
+        result.append(section.begin(), section.size());
+    return result;
+}
+
+// A type section with one () -> () signature, a function section using it, and a Code section with an empty body.
+static const std::initializer_list<uint8_t> typeSection = { 0x01, 0x04, 0x01, 0x60, 0x00, 0x00 };
+static const std::initializer_list<uint8_t> functionSection = { 0x03, 0x02, 0x01, 0x00 };
+static const std::initializer_list<uint8_t> codeSection = { 0x0a, 0x04, 0x01, 0x02, 0x00, 0x0b };
+
+class RecordingClient final : public Wasm::StreamingParserClient {
+public:
+    void didStartCodeSection(uint32_t functionCount) override
+    {
+        startedCodeSection = true;
+        declaredFunctionCount = functionCount;
+    }
+
+    void didReceiveFunctionData(uint32_t functionIndex, Vector<uint8_t>&& functionBody) override
+    {
+        inOrder &= functionIndex == bodies.size();
+        bodies.append(WTFMove(functionBody));
+        bytesFedOnArrival.append(bytesFed);
+    }
+
+    size_t bytesFed { 0 };
+    bool startedCodeSection { false };
+    uint32_t declaredFunctionCount { 0 };
+    bool inOrder { true };
+    Vector<Vector<uint8_t>> bodies;
+    Vector<size_t> bytesFedOnArrival;
+};
+
+struct StreamingParse {
+    StreamingParse()
+        : info(adoptRef(*new Wasm::ModuleInformation(Vector<uint8_t>())))
+        , parser(info.get(), client)
+    {
+    }
+
+    Ref<Wasm::ModuleInformation> info;
+    RecordingClient client;
+    Wasm::StreamingParser parser;
+    // How many bytes had been fed when the parser first reported an error.
+    size_t failedAfter { 0 };
+};
+
+// Feeds every byte, in chunks whose sizes cycle through chunkSizes, even after an error, then finalizes.
+static Wasm::StreamingParser::State parseInChunks(StreamingParse& parse, const Vector<uint8_t>& bytes, std::initializer_list<size_t> chunkSizes)
+{
+    auto chunkSize = chunkSizes.begin();
+    for (size_t offset = 0; offset < bytes.size();) {
+        size_t length = std::min(*chunkSize, bytes.size() - offset);
+        parse.client.bytesFed = offset + length;
+        if (parse.parser.addBytes(bytes.data() + offset, length) == Wasm::StreamingParser::State::FatalError && !parse.failedAfter)
+            parse.failedAfter = offset + length;
+        offset += length;
+        if (++chunkSize == chunkSizes.end())
+            chunkSize = chunkSizes.begin();
+    }
+    return parse.parser.finalize();
+}
+
+// Checks that parsing in chunks ends up with what parsing everything at once does, and that each function
+// body reaches the client as soon as its last byte has.
+static bool parsesInChunks(const Vector<uint8_t>& bytes, std::initializer_list<size_t> chunkSizes)
+{
+    StreamingParse whole;
+    StreamingParse parse;
+    if (parseInChunks(whole, bytes, { bytes.size() }) != Wasm::StreamingParser::State::Finished
+        || parseInChunks(parse, bytes, chunkSizes) != Wasm::StreamingParser::State::Finished)
+        return false;
+
+    const Wasm::ModuleInformation& info = parse.info.get();
+    if (info.source != bytes
+        || info.importFunctionCount() != 1
+        || info.internalFunctionCount() != 3
+        || info.exports.size() != whole.info->exports.size()
+        || !info.memory
+        || !parse.client.startedCodeSection
+        || parse.client.declaredFunctionCount != 3
+        || !parse.client.inOrder
+        || parse.client.bodies.size() != 3)
+        return false;
+
+    for (size_t i = 0; i < parse.client.bodies.size(); ++i) {
+        const auto& location = info.functionLocationInBinary[i];
+        if (location.start != whole.info->functionLocationInBinary[i].start || location.end != whole.info->functionLocationInBinary[i].end)
+            return false;
+        Vector<uint8_t> expectedBody;
+        expectedBody.append(bytes.data() + location.start, location.end - location.start);
+        if (parse.client.bodies[i] != expectedBody || parse.client.bodies[i] != whole.client.bodies[i])
+            return false;
+        if (*chunkSizes.begin() == 1 && chunkSizes.size() == 1 && parse.client.bytesFedOnArrival[i] != location.end)
+            return false;
+    }
+    return true;
+}
+
+// Feeds the bytes one at a time, and checks that the parser gives up right after failedAfter bytes, stays failed
+// while more bytes arrive, and reports an error mentioning the given text.
+static bool failsAfter(const Vector<uint8_t>& bytes, size_t failedAfter, const char* message)
+{
+    StreamingParse parse;
+    Vector<uint8_t> withTrailingBytes = bytes;
+    withTrailingBytes.appendVector(moduleWithSections({ typeSection, functionSection, codeSection }));
+    bool failed = parseInChunks(parse, withTrailingBytes, { 1 }) == Wasm::StreamingParser::State::FatalError;
+    if (!failed || parse.failedAfter != failedAfter || parse.parser.errorMessage().find(message) == notFound) {
+        printf("    unexpected error after %zu bytes: %s\n", parse.failedAfter, parse.parser.errorMessage().utf8().data());
+        return false;
+    }
+    return true;
+}
+
+static bool failsToFinalize(const Vector<uint8_t>& bytes, const char* message)
+{
+    StreamingParse parse;
+    bool failed = parseInChunks(parse, bytes, { 3 }) == Wasm::StreamingParser::State::FatalError;
+    if (!failed || parse.failedAfter || parse.parser.errorMessage().find(message) == notFound) {
+        printf("    unexpected error after %zu bytes: %s\n", parse.failedAfter, parse.parser.errorMessage().utf8().data());
+        return false;
+    }
+    return true;
+}
+
+class StreamingCompletion : public ThreadSafeRefCounted<StreamingCompletion> {
+public:
+    void complete(Wasm::Module::ValidationResult&& result)
+    {
+        auto locker = holdLock(m_lock);
+        m_result = WTFMove(result);
+        m_condition.notifyAll();
+    }
+
+    Wasm::Module::ValidationResult wait()
+    {
+        auto locker = holdLock(m_lock);
+        m_condition.wait(m_lock, [&] { return !!m_result; });
+        return WTFMove(*m_result);
+    }
+
+private:
+    Lock m_lock;
+    Condition m_condition;
+    std::optional<Wasm::Module::ValidationResult> m_result;
+};
+
+static JSValueRef makeError(JSContextRef context, const char* message)
+{
+    JSStringRef string = JSStringCreateWithUTF8CString(message);
+    JSValueRef argument = JSValueMakeString(context, string);
+    JSStringRelease(string);
+    return JSObjectMakeError(context, 1, &argument, nullptr);
+}
+
+// streamModule(bytes, chunkSize, cancelAfter) feeds a StreamingPlan in chunks and waits for it to validate, the way
+// an embedder's network callbacks would. It returns a WebAssembly.Module, or throws the CompileError that a
+// compileStreaming promise would have been rejected with. The plan is cancelled instead of finalized once
+// cancelAfter bytes have been fed.
+static JSValueRef streamModule(JSContextRef context, JSObjectRef, JSObjectRef, size_t argumentCount, const JSValueRef arguments[], JSValueRef* exception)
+{
+    if (argumentCount < 2 || JSValueGetTypedArrayType(context, arguments[0], nullptr) != kJSTypedArrayTypeUint8Array) {
+        *exception = makeError(context, "streamModule expects a Uint8Array and a chunk size");
+        return nullptr;
+    }
+    JSObjectRef array = JSValueToObject(context, arguments[0], exception);
+    const uint8_t* data = static_cast<const uint8_t*>(JSObjectGetTypedArrayBytesPtr(context, array, exception));
+    size_t size = JSObjectGetTypedArrayByteLength(context, array, exception);
+    size_t chunkSize = std::max(1., JSValueToNumber(context, arguments[1], exception));
+    size_t cancelAfter = argumentCount > 2 ? JSValueToNumber(context, arguments[2], exception) : size + 1;
+
+    ExecState* exec = toJS(context);
+    VM& vm = exec->vm();
+    JSLockHolder locker(vm);
+    Ref<StreamingCompletion> completion = adoptRef(*new StreamingCompletion);
+    Ref<Wasm::StreamingPlan> plan = Wasm::Module::validateStreaming(&vm.wasmContext, createSharedTask<Wasm::Module::CallbackType>([completion = completion.copyRef()] (Wasm::Module::ValidationResult&& result) {
+        completion->complete(WTFMove(result));
+    }));
+
+    size_t offset = 0;
+    for (; offset < size && offset < cancelAfter; offset += chunkSize)
+        plan->addBytes(data + offset, std::min(chunkSize, size - offset));
+    if (offset >= cancelAfter)
+        plan->cancel();
+    else
+        plan->finalize();
+
+    auto scope = DECLARE_CATCH_SCOPE(vm);
+    JSWebAssemblyModule* module = JSWebAssemblyModule::createStub(vm, exec, exec->lexicalGlobalObject()->WebAssemblyModuleStructure(), completion->wait());
+    if (UNLIKELY(scope.exception())) {
+        *exception = toRef(exec, scope.exception()->value());
+        scope.clearException();
+        return nullptr;
+    }
+    return toRef(module);
+}
+
+static const char* const planScript =
+    "function compileError(f, message) {"
+    "    try { f(); } catch (e) { return e instanceof WebAssembly.CompileError && e.message.indexOf(message) >= 0; }"
+    "    return false;"
+    "}"
+    "function runs(module) {"
+    "    var e = new WebAssembly.Instance(module, { env: { twice: function(x) { return 2 * x; } } }).exports;"
+    "    return e.add(2, 3) === 5 && e.bigConstant() === 40000000 && e.callImport(20) === 41;"
+    "}"
+    "var truncated = moduleBytes.slice(0, moduleBytes.length - 2);"
+    "var badMagic = moduleBytes.slice();"
+    "badMagic[1] = 0;"
+    "[1, 2, 3, 7, 64, moduleBytes.length].every(function(chunkSize) {"
+    "    return runs(streamModule(moduleBytes, chunkSize))"
+    "        && compileError(function() { streamModule(invalidModuleBytes, chunkSize); }, 'in function at index 1')"
+    "        && compileError(function() { streamModule(truncated, chunkSize); }, 'module ended in the middle of its Code section')"
+    "        && compileError(function() { streamModule(badMagic, chunkSize); }, \"doesn't start with\")"
+    "        && compileError(function() { streamModule(moduleBytes, chunkSize, moduleBytes.length - 1); }, 'was cancelled');"
+    "})";
+
+#endif // ENABLE(WEBASSEMBLY)
+
+int testWasmStreaming()
+{
+    bool overallResult = true;
+    auto test = [&] (const char* description, bool currentResult) {
+        printf("    %s: %s\n", description, currentResult ? "PASS" : "FAIL");
+        overallResult &= currentResult;
+    };
+
+    printf("WasmStreamingTest:\n");
+
+#if ENABLE(WEBASSEMBLY)
+    Options::initialize(); // Ensure options is initialized first.
+    Vector<uint8_t> module = makeModule();
+
+    test("parsing one byte at a time", parsesInChunks(module, { 1 }));
+    test("parsing in uneven chunks", parsesInChunks(module, { 2, 3, 5, 7, 11 }) && parsesInChunks(module, { 9, 1 }) && parsesInChunks(module, { 64 }));
+
+
+    Vector<uint8_t> badMagic = moduleWithSections({ typeSection });
+    badMagic[1] = 'b';
+    Vector<uint8_t> badVersion = moduleWithSections({ typeSection });
+    badVersion[4] = 2;
+    test("a bad header fails once it is complete", failsAfter(badMagic, 8, "doesn't start with '\\0asm'") && failsAfter(badVersion, 8, "unexpected version number 2"));
+    test("sections out of order fail at the section ID", failsAfter(moduleWithSections({ { 0x03, 0x01, 0x00 }, typeSection }), 12, "invalid section order, Function followed by Type"));
+    test("a malformed section fails once its payload is complete", failsAfter(moduleWithSections({ { 0x01, 0x04, 0x01, 0x50, 0x00, 0x00 }, functionSection, codeSection }), 14, "in Type section"));
+    test("a Code section with the wrong count fails before its bodies arrive",
+        failsAfter(moduleWithSections({ typeSection, functionSection, { 0x0a, 0x07, 0x02, 0x02, 0x00, 0x0b, 0x02, 0x00, 0x0b } }), 21, "Code section count 2 doesn't match the declared number of functions 1"));
+    test("a function running past its Code section fails at its size",
+        failsAfter(moduleWithSections({ typeSection, functionSection, { 0x0a, 0x04, 0x01, 0x09, 0x00, 0x0b } }), 22, "exceeds the Code section's remaining size"));
+
+    Vector<uint8_t> truncatedHeader;
+    truncatedHeader.append(module.data(), 5);
+    Vector<uint8_t> truncatedCode;
+    truncatedCode.append(module.data(), module.size() - 2);
+    Vector<uint8_t> truncatedSectionSize = moduleWithSections({ typeSection, { 0x03 } });
+    test("a truncated module fails to finalize", failsToFinalize(truncatedHeader, "expected a module of at least 8 bytes")
+        && failsToFinalize(truncatedSectionSize, "module ended in the middle of its Function section")
+        && failsToFinalize(truncatedCode, "module ended in the middle of its Code section")
+        && failsToFinalize(moduleWithSections({ typeSection, functionSection }), "module declares 1 functions but only defines 0"));
+
+    JSGlobalContextRef context = JSGlobalContextCreateInGroup(nullptr, nullptr);
+    setWasmModuleBytes(context, "moduleBytes", module);
+    setWasmModuleBytes(context, "invalidModuleBytes", makeModule(true));
+    JSStringRef name = JSStringCreateWithUTF8CString("streamModule");
+    JSObjectSetProperty(context, JSContextGetGlobalObject(context), name, JSObjectMakeFunctionWithCallback(context, name, streamModule), kJSPropertyAttributeNone, nullptr);
+    JSStringRelease(name);
+    test("streaming plans validate chunked modules, and reject invalid bodies, truncation and cancellation", wasmTestScriptReturnsTrue(context, planScript));
+    JSGlobalContextRelease(context);
+#endif
+
+    printf("WasmStreamingTest: %s\n", overallResult ? "PASS" : "FAIL");
+    return !overallResult;
+}
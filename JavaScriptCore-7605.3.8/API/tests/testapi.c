@@ -51,16 +51,33 @@
 #include <windows.h>
 #endif
 
+#include "AllocationProfilerTest.h"
+#include "BytecodeCacheTest.h"
 #include "CompareAndSwapTest.h"
 #include "CustomGlobalObjectClassTest.h"
 #include "ExecutionTimeLimitTest.h"
+#include "FireDueTimersTest.h"
 #include "FunctionOverridesTest.h"
+#include "GarbageCollectionTelemetryTest.h"
 #include "GlobalContextWithFinalizerTest.h"
+#include "HeapSnapshotStreamingTest.h"
 #include "JSONParseTest.h"
+#include "JSONStringifyTest.h"
 #include "JSObjectGetProxyTargetTest.h"
 #include "MultithreadedMultiVMExecutionTest.h"
+#include "ParallelSweepingTest.h"
 #include "PingPongStackOverflowTest.h"
+#include "PretenuringTest.h"
+#include "RegExpMatchingTest.h"
+#include "ShrinkFootprintTest.h"
+#include "SparseBlockPagesTest.h"
 #include "TypedArrayCTest.h"
+#include "UnlinkedCodeBlockJettisoningTest.h"
+#include "WasmAtomicsTest.h"
+#include "WasmModuleSerializationTest.h"
+#include "WasmSIMDTest.h"
+#include "WasmSinglePassTest.h"
+#include "WasmStreamingTest.h"
 
 #if JSC_OBJC_API_ENABLED
 void testObjectiveCAPI(void);
@@ -1243,6 +1260,86 @@ static void testMarkingConstraintsAndHeapFinalizers(void)
     printf("PASS: Marking Constraints and Heap Finalizers.\n");
 }
 
+static const size_t testHardHeapLimit = 16 * 1024 * 1024;
+static unsigned heapLimitCallbackCount;
+
+// Keeps about 200MB of int32 arrays alive, and returns how many it made.
+static const char* heapLimitScript =
+    "function allocate() {"
+    "    var arrays = [];"
+    "    for (var i = 0; i < 250; ++i)"
+    "        arrays.push(new Array(100000).fill(i));"
+    "    return arrays.length;"
+    "}";
+
+static bool terminateOnHeapLimit(JSContextRef ctx, size_t heapSize, void* context)
+{
+    UNUSED_PARAM(ctx);
+    assertTrue(context == &heapLimitCallbackCount, "Correct context was passed to the heap limit callback");
+    assertTrue(heapSize > testHardHeapLimit, "Heap limit callback only runs past the hard limit");
+    heapLimitCallbackCount++;
+    return true;
+}
+
+static bool raiseHeapLimit(JSContextRef ctx, size_t heapSize, void* context)
+{
+    assertTrue(heapSize > testHardHeapLimit, "Heap limit callback only runs past the hard limit");
+    heapLimitCallbackCount++;
+    JSContextGroupSetHeapLimits(JSContextGetGroup(ctx), 0, 1024 * 1024 * 1024, raiseHeapLimit, context);
+    return false;
+}
+
+static JSValueRef evaluateHeapLimitScript(JSContextRef context, const char* source, JSValueRef* exception)
+{
+    JSStringRef script = JSStringCreateWithUTF8CString(source);
+    JSValueRef result = JSEvaluateScript(context, script, NULL, NULL, 1, exception);
+    JSStringRelease(script);
+    return result;
+}
+
+static void testHeapLimits(void)
+{
+    JSContextGroupRef group;
+    JSGlobalContextRef context;
+    JSValueRef result;
+    JSValueRef exception;
+
+    printf("Testing Heap Limits.\n");
+
+    group = JSContextGroupCreate();
+    context = JSGlobalContextCreateInGroup(group, NULL);
+    evaluateHeapLimitScript(context, heapLimitScript, NULL);
+
+    // Without a callback, the script gets an OutOfMemoryError that it can catch.
+    JSContextGroupSetHeapLimits(group, 0, testHardHeapLimit, NULL, NULL);
+    exception = NULL;
+    result = evaluateHeapLimitScript(context, "try { allocate(); false; } catch (e) { String(e) === 'Error: Out of memory'; }", &exception);
+    assertTrue(!exception && result && JSValueToBoolean(context, result), "Script caught an OutOfMemoryError past the hard heap limit");
+
+    // A callback that returns true terminates the script, which can't catch that.
+    heapLimitCallbackCount = 0;
+    JSContextGroupSetHeapLimits(group, 0, testHardHeapLimit, terminateOnHeapLimit, &heapLimitCallbackCount);
+    exception = NULL;
+    result = evaluateHeapLimitScript(context, "try { allocate(); } catch (e) { 'caught'; }", &exception);
+    assertTrue(!result && exception, "Script was terminated past the hard heap limit");
+    assertTrue(heapLimitCallbackCount == 1, "Heap limit callback ran once before terminating");
+
+    // A callback that raises the limit lets the script run to completion.
+    heapLimitCallbackCount = 0;
+    JSContextGroupSetHeapLimits(group, 0, testHardHeapLimit, raiseHeapLimit, &heapLimitCallbackCount);
+    exception = NULL;
+    result = evaluateHeapLimitScript(context, "allocate()", &exception);
+    assertTrue(!exception && result && JSValueToNumber(context, result, NULL) == 250, "Script ran past the raised heap limit");
+    assertTrue(heapLimitCallbackCount >= 1, "Heap limit callback ran before raising the limit");
+    assertTrue(JSContextGroupGetHeapSize(group) > 0, "Heap size is reported");
+
+    JSContextGroupSetHeapLimits(group, 0, 0, NULL, NULL);
+    JSGlobalContextRelease(context);
+    JSContextGroupRelease(group);
+
+    printf("PASS: Heap Limits.\n");
+}
+
 #if USE(CF)
 static void testCFStrings(void)
 {
@@ -1377,6 +1474,7 @@ int main(int argc, char* argv[])
     ASSERT(Base_didFinalize);
 
     testMarkingConstraintsAndHeapFinalizers();
+    testHeapLimits();
 
 #if USE(CF)
     testCFStrings();
@@ -2059,10 +2157,29 @@ int main(int argc, char* argv[])
     failed = testTypedArrayCAPI() || failed;
     failed = testExecutionTimeLimit() || failed;
     failed = testFunctionOverrides() || failed;
+#if OS(UNIX)
+    failed = testBytecodeCache() || failed;
+#endif
     failed = testGlobalContextWithFinalizer() || failed;
     failed = testPingPongStackOverflow() || failed;
     failed = testJSONParse() || failed;
+    failed = testJSONStringify() || failed;
     failed = testJSObjectGetProxyTarget() || failed;
+    failed = testRegExpMatching() || failed;
+    failed = testFireDueTimers() || failed;
+    failed = testGarbageCollectionTelemetry() || failed;
+    failed = testShrinkFootprint() || failed;
+    failed = testWasmSIMD() || failed;
+    failed = testUnlinkedCodeBlockJettisoning() || failed;
+    failed = testPretenuring() || failed;
+    failed = testWasmModuleSerialization() || failed;
+    failed = testHeapSnapshotStreaming() || failed;
+    failed = testWasmSinglePass() || failed;
+    failed = testWasmAtomics() || failed;
+    failed = testWasmStreaming() || failed;
+    failed = testParallelSweeping() || failed;
+    failed = testAllocationProfiler() || failed;
+    failed = testSparseBlockPages() || failed;
 
     // Clear out local variables pointing at JSObjectRefs to allow their values to be collected
     function = NULL;
@@ -33,6 +33,7 @@
 #include "JITCode.h"
 #include "JSCInlines.h"
 #include "Options.h"
+#include "PerfLog.h"
 #include <wtf/CompilationThread.h>
 
 namespace JSC {
@@ -55,20 +56,24 @@ LinkBuffer::CodeRef LinkBuffer::finalizeCodeWithoutDisassembly()
     return CodeRef::createSelfManagedCodeRef(MacroAssemblerCodePtr(m_code));
 }
 
-LinkBuffer::CodeRef LinkBuffer::finalizeCodeWithDisassembly(const char* format, ...)
+LinkBuffer::CodeRef LinkBuffer::finalizeCodeWithDisassembly(bool dumpDisassembly, const char* format, ...)
 {
     CodeRef result = finalizeCodeWithoutDisassembly();
 
-    if (m_alreadyDisassembled)
-        return result;
-    
-    StringPrintStream out;
-    out.printf("Generated JIT code for ");
+    StringPrintStream name;
     va_list argList;
     va_start(argList, format);
-    out.vprintf(format, argList);
+    name.vprintf(format, argList);
     va_end(argList);
-    out.printf(":\n");
+
+    if (Options::logJITCodeForPerf())
+        PerfLog::log(name.toCString(), result.code().executableAddress(), m_size, m_codeBlockForPerfLog);
+
+    if (!dumpDisassembly || m_alreadyDisassembled)
+        return result;
+    
+    StringPrintStream out;
+    out.printf("Generated JIT code for %s:\n", name.toCString().data());
 
     out.printf("    Code at [%p, %p):\n", result.code().executableAddress(), result.code().executableAddress<char*>() + result.size());
     
@@ -36,6 +36,7 @@
 
 #include "JITCompilationEffort.h"
 #include "MacroAssembler.h"
+#include "Options.h"
 #include <wtf/DataLog.h>
 #include <wtf/FastMalloc.h>
 #include <wtf/Noncopyable.h>
@@ -233,7 +234,8 @@ public:
     // displaying disassembly.
     
     JS_EXPORT_PRIVATE CodeRef finalizeCodeWithoutDisassembly();
-    JS_EXPORT_PRIVATE CodeRef finalizeCodeWithDisassembly(const char* format, ...) WTF_ATTRIBUTE_PRINTF(2, 3);
+    // The heading also names the code in the perf map when Options::logJITCodeForPerf() is set.
+    JS_EXPORT_PRIVATE CodeRef finalizeCodeWithDisassembly(bool dumpDisassembly, const char* format, ...) WTF_ATTRIBUTE_PRINTF(3, 4);
 
     CodePtr trampolineAt(Label label)
     {
@@ -250,6 +252,9 @@ public:
     bool wasAlreadyDisassembled() const { return m_alreadyDisassembled; }
     void didAlreadyDisassemble() { m_alreadyDisassembled = true; }
 
+    // Lets the perf log attribute the code to the source of this CodeBlock.
+    void setCodeBlockForPerfLog(CodeBlock* codeBlock) { m_codeBlockForPerfLog = codeBlock; }
+
 private:
 #if ENABLE(BRANCH_COMPACTION)
     int executableOffsetFor(int location)
@@ -304,12 +309,15 @@ private:
     bool m_completed;
 #endif
     bool m_alreadyDisassembled { false };
+    CodeBlock* m_codeBlockForPerfLog { nullptr };
     Vector<RefPtr<SharedTask<void(LinkBuffer&)>>> m_linkTasks;
 };
 
+#define FINALIZE_CODE_HEADING_ARGUMENTS(...) __VA_ARGS__
+
 #define FINALIZE_CODE_IF(condition, linkBufferReference, dataLogFArgumentsForHeading)  \
-    (UNLIKELY((condition))                                              \
-     ? ((linkBufferReference).finalizeCodeWithDisassembly dataLogFArgumentsForHeading) \
+    (UNLIKELY((condition) || JSC::Options::logJITCodeForPerf())         \
+     ? ((linkBufferReference).finalizeCodeWithDisassembly((condition), FINALIZE_CODE_HEADING_ARGUMENTS dataLogFArgumentsForHeading)) \
      : (linkBufferReference).finalizeCodeWithoutDisassembly())
 
 bool shouldDumpDisassemblyFor(CodeBlock*);
@@ -331,7 +339,8 @@ bool shouldDumpDisassemblyFor(CodeBlock*);
 // ... and so on.
 //
 // Note that the dataLogFArgumentsForHeading are only evaluated when dumpDisassembly
-// is true, so you can hide expensive disassembly-only computations inside there.
+// or logJITCodeForPerf is true, so you can hide expensive disassembly-only computations
+// inside there.
 
 #define FINALIZE_CODE(linkBufferReference, dataLogFArgumentsForHeading)  \
     FINALIZE_CODE_IF(JSC::Options::asyncDisassembly() || JSC::Options::dumpDisassembly(), linkBufferReference, dataLogFArgumentsForHeading)
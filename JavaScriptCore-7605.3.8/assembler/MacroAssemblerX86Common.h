@@ -387,6 +387,12 @@ public:
         ctzAfterBsf<32>(dst);
     }
 
+    void countPopulation32(RegisterID src, RegisterID dst)
+    {
+        ASSERT(supportsCountPopulation());
+        m_assembler.popcnt_rr(src, dst);
+    }
+
     // Only used for testing purposes.
     void illegalInstruction()
     {
@@ -2094,6 +2100,269 @@ public:
         m_assembler.movd_rr(src, dst);
     }
 
+    // 128-bit vector operations. These treat the whole XMM register as a vector of lanes, and
+    // require SSE4.1. Check supportsVectorOperations() before using them.
+
+    void loadVector(Address address, FPRegisterID dest)
+    {
+        m_assembler.movups_mr(address.offset, address.base, dest);
+    }
+
+    void loadVector(BaseIndex address, FPRegisterID dest)
+    {
+        m_assembler.movups_mr(address.offset, address.base, address.index, address.scale, dest);
+    }
+
+    void storeVector(FPRegisterID src, Address address)
+    {
+        m_assembler.movups_rm(src, address.offset, address.base);
+    }
+
+    void storeVector(FPRegisterID src, BaseIndex address)
+    {
+        m_assembler.movups_rm(src, address.offset, address.base, address.index, address.scale);
+    }
+
+    void moveVector(FPRegisterID src, FPRegisterID dest)
+    {
+        if (src != dest)
+            m_assembler.movaps_rr(src, dest);
+    }
+
+    void moveVector(Address src, Address dest, FPRegisterID scratch)
+    {
+        loadVector(src, scratch);
+        storeVector(scratch, dest);
+    }
+
+    void moveZeroToVector(FPRegisterID reg)
+    {
+        m_assembler.xorps_rr(reg, reg);
+    }
+
+    void vectorAddInt8x16(FPRegisterID src, FPRegisterID dest)
+    {
+        m_assembler.paddb_rr(src, dest);
+    }
+
+    void vectorAddInt16x8(FPRegisterID src, FPRegisterID dest)
+    {
+        m_assembler.paddw_rr(src, dest);
+    }
+
+    void vectorAddInt32x4(FPRegisterID src, FPRegisterID dest)
+    {
+        m_assembler.paddd_rr(src, dest);
+    }
+
+    void vectorAddInt64x2(FPRegisterID src, FPRegisterID dest)
+    {
+        m_assembler.paddq_rr(src, dest);
+    }
+
+    void vectorAddFloat32x4(FPRegisterID src, FPRegisterID dest)
+    {
+        m_assembler.addps_rr(src, dest);
+    }
+
+    void vectorAddFloat64x2(FPRegisterID src, FPRegisterID dest)
+    {
+        m_assembler.addpd_rr(src, dest);
+    }
+
+    void vectorSubInt8x16(FPRegisterID src, FPRegisterID dest)
+    {
+        m_assembler.psubb_rr(src, dest);
+    }
+
+    void vectorSubInt16x8(FPRegisterID src, FPRegisterID dest)
+    {
+        m_assembler.psubw_rr(src, dest);
+    }
+
+    void vectorSubInt32x4(FPRegisterID src, FPRegisterID dest)
+    {
+        m_assembler.psubd_rr(src, dest);
+    }
+
+    void vectorSubInt64x2(FPRegisterID src, FPRegisterID dest)
+    {
+        m_assembler.psubq_rr(src, dest);
+    }
+
+    void vectorSubFloat32x4(FPRegisterID src, FPRegisterID dest)
+    {
+        m_assembler.subps_rr(src, dest);
+    }
+
+    void vectorSubFloat64x2(FPRegisterID src, FPRegisterID dest)
+    {
+        m_assembler.subpd_rr(src, dest);
+    }
+
+    void vectorMulInt16x8(FPRegisterID src, FPRegisterID dest)
+    {
+        m_assembler.pmullw_rr(src, dest);
+    }
+
+    void vectorMulInt32x4(FPRegisterID src, FPRegisterID dest)
+    {
+        m_assembler.pmulld_rr(src, dest);
+    }
+
+    void vectorMulFloat32x4(FPRegisterID src, FPRegisterID dest)
+    {
+        m_assembler.mulps_rr(src, dest);
+    }
+
+    void vectorMulFloat64x2(FPRegisterID src, FPRegisterID dest)
+    {
+        m_assembler.mulpd_rr(src, dest);
+    }
+
+    void vectorDivFloat32x4(FPRegisterID src, FPRegisterID dest)
+    {
+        m_assembler.divps_rr(src, dest);
+    }
+
+    void vectorDivFloat64x2(FPRegisterID src, FPRegisterID dest)
+    {
+        m_assembler.divpd_rr(src, dest);
+    }
+
+    void vectorAnd(FPRegisterID src, FPRegisterID dest)
+    {
+        m_assembler.pand_rr(src, dest);
+    }
+
+    void vectorOr(FPRegisterID src, FPRegisterID dest)
+    {
+        m_assembler.por_rr(src, dest);
+    }
+
+    void vectorXor(FPRegisterID src, FPRegisterID dest)
+    {
+        m_assembler.pxor_rr(src, dest);
+    }
+
+    // dest = ~dest & src.
+    void vectorAndnot(FPRegisterID src, FPRegisterID dest)
+    {
+        m_assembler.pandn_rr(src, dest);
+    }
+
+    // Sets each lane of dest to all ones if it equals the corresponding lane of src, and to zero otherwise.
+    void vectorEqualInt8x16(FPRegisterID src, FPRegisterID dest)
+    {
+        m_assembler.pcmpeqb_rr(src, dest);
+    }
+
+    void vectorEqualInt16x8(FPRegisterID src, FPRegisterID dest)
+    {
+        m_assembler.pcmpeqw_rr(src, dest);
+    }
+
+    // Gathers the top bit of each byte of src into the low 16 bits of dest.
+    void vectorMoveMaskInt8x16(FPRegisterID src, RegisterID dest)
+    {
+        m_assembler.pmovmskb_rr(src, dest);
+    }
+
+    void vectorNot(FPRegisterID src, FPRegisterID dest, FPRegisterID scratch)
+    {
+        m_assembler.pcmpeqd_rr(scratch, scratch);
+        moveVector(src, dest);
+        m_assembler.pxor_rr(scratch, dest);
+    }
+
+    void vectorSqrtFloat32x4(FPRegisterID src, FPRegisterID dest)
+    {
+        m_assembler.sqrtps_rr(src, dest);
+    }
+
+    void vectorSqrtFloat64x2(FPRegisterID src, FPRegisterID dest)
+    {
+        m_assembler.sqrtpd_rr(src, dest);
+    }
+
+    void vectorSplatInt8x16(RegisterID src, FPRegisterID dest)
+    {
+        m_assembler.movd_rr(src, dest);
+        m_assembler.punpcklbw_rr(dest, dest);
+        m_assembler.pshuflw_irr(0, dest, dest);
+        m_assembler.pshufd_irr(0, dest, dest);
+    }
+
+    void vectorSplatInt16x8(RegisterID src, FPRegisterID dest)
+    {
+        m_assembler.movd_rr(src, dest);
+        m_assembler.pshuflw_irr(0, dest, dest);
+        m_assembler.pshufd_irr(0, dest, dest);
+    }
+
+    void vectorSplatInt32x4(RegisterID src, FPRegisterID dest)
+    {
+        m_assembler.movd_rr(src, dest);
+        m_assembler.pshufd_irr(0, dest, dest);
+    }
+
+    void vectorSplatFloat32x4(FPRegisterID src, FPRegisterID dest)
+    {
+        m_assembler.pshufd_irr(0, src, dest);
+    }
+
+    void vectorSplatFloat64x2(FPRegisterID src, FPRegisterID dest)
+    {
+        // Selects dwords {0, 1, 0, 1}.
+        m_assembler.pshufd_irr(0x44, src, dest);
+    }
+
+    void vectorExtractLaneInt32x4(TrustedImm32 lane, FPRegisterID src, RegisterID dest)
+    {
+        ASSERT(lane.m_value >= 0 && lane.m_value < 4);
+        m_assembler.pextrd_irr(lane.m_value, src, dest);
+    }
+
+    // The lanes above the low one in dest are left undefined.
+    void vectorExtractLaneFloat32x4(TrustedImm32 lane, FPRegisterID src, FPRegisterID dest)
+    {
+        ASSERT(lane.m_value >= 0 && lane.m_value < 4);
+        m_assembler.pshufd_irr(lane.m_value, src, dest);
+    }
+
+    void vectorExtractLaneFloat64x2(TrustedImm32 lane, FPRegisterID src, FPRegisterID dest)
+    {
+        ASSERT(lane.m_value == 0 || lane.m_value == 1);
+        if (!lane.m_value) {
+            moveVector(src, dest);
+            return;
+        }
+        // Selects dwords {2, 3, 2, 3}.
+        m_assembler.pshufd_irr(0xee, src, dest);
+    }
+
+    void vectorReplaceLaneInt32x4(TrustedImm32 lane, RegisterID src, FPRegisterID dest)
+    {
+        ASSERT(lane.m_value >= 0 && lane.m_value < 4);
+        m_assembler.pinsrd_irr(lane.m_value, src, dest);
+    }
+
+    void vectorReplaceLaneFloat32x4(TrustedImm32 lane, FPRegisterID src, FPRegisterID dest)
+    {
+        ASSERT(lane.m_value >= 0 && lane.m_value < 4);
+        m_assembler.insertps_irr(lane.m_value << 4, src, dest);
+    }
+
+    void vectorReplaceLaneFloat64x2(TrustedImm32 lane, FPRegisterID src, FPRegisterID dest)
+    {
+        ASSERT(lane.m_value == 0 || lane.m_value == 1);
+        if (!lane.m_value) {
+            m_assembler.movsd_rr(src, dest);
+            return;
+        }
+        m_assembler.movlhps_rr(src, dest);
+    }
+
     // Stack manipulation operations:
     //
     // The ABI is assumed to provide a stack abstraction to memory,
@@ -3846,6 +4115,19 @@ public:
         return s_sse4_1CheckState == CPUIDCheckState::Set;
     }
 
+    static bool supportsVectorOperations()
+    {
+        // Everything we emit for 128-bit vectors is SSE4.1 or older.
+        return supportsFloatingPointRounding();
+    }
+
+    static bool supportsCountPopulation()
+    {
+        if (s_popcntCheckState == CPUIDCheckState::NotChecked)
+            updateEax1EcxFlags();
+        return s_popcntCheckState == CPUIDCheckState::Set;
+    }
+
     static bool supportsAVX()
     {
         // AVX still causes mysterious regressions and those regressions can be massive.
@@ -3884,6 +4166,7 @@ public:
 #endif // COMPILER(GCC_OR_CLANG)
         s_sse4_1CheckState = (flags & (1 << 19)) ? CPUIDCheckState::Set : CPUIDCheckState::Clear;
         s_avxCheckState = (flags & (1 << 28)) ? CPUIDCheckState::Set : CPUIDCheckState::Clear;
+        s_popcntCheckState = (flags & (1 << 23)) ? CPUIDCheckState::Set : CPUIDCheckState::Clear;
     }
 
     void lfence()
@@ -4236,6 +4519,7 @@ private:
     };
     JS_EXPORT_PRIVATE static CPUIDCheckState s_sse4_1CheckState;
     JS_EXPORT_PRIVATE static CPUIDCheckState s_avxCheckState;
+    static CPUIDCheckState s_popcntCheckState;
     static CPUIDCheckState s_bmi1CheckState;
     static CPUIDCheckState s_lzcntCheckState;
 };
@@ -468,6 +468,12 @@ public:
         ctzAfterBsf<64>(dst);
     }
 
+    void countPopulation64(RegisterID src, RegisterID dst)
+    {
+        ASSERT(supportsCountPopulation());
+        m_assembler.popcntq_rr(src, dst);
+    }
+
     void lshift64(TrustedImm32 imm, RegisterID dest)
     {
         m_assembler.shlq_i8r(imm.m_value, dest);
@@ -948,6 +954,24 @@ public:
         m_assembler.movq_rr(src, dest);
     }
 
+    void vectorSplatInt64x2(RegisterID src, FPRegisterID dest)
+    {
+        m_assembler.movq_rr(src, dest);
+        m_assembler.movlhps_rr(dest, dest);
+    }
+
+    void vectorExtractLaneInt64x2(TrustedImm32 lane, FPRegisterID src, RegisterID dest)
+    {
+        ASSERT(lane.m_value == 0 || lane.m_value == 1);
+        m_assembler.pextrq_irr(lane.m_value, src, dest);
+    }
+
+    void vectorReplaceLaneInt64x2(TrustedImm32 lane, RegisterID src, FPRegisterID dest)
+    {
+        ASSERT(lane.m_value == 0 || lane.m_value == 1);
+        m_assembler.pinsrq_irr(lane.m_value, src, dest);
+    }
+
     void compare64(RelationalCondition cond, RegisterID left, TrustedImm32 right, RegisterID dest)
     {
         if (!right.m_value) {
@@ -0,0 +1,294 @@
+/*
+ * Copyright (C) 2018 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "PerfLog.h"
+
+#if ENABLE(ASSEMBLER)
+
+#include "CodeBlock.h"
+#include "JSCInlines.h"
+#include "Options.h"
+#include <inttypes.h>
+#include <limits.h>
+#include <mutex>
+#include <wtf/DataLog.h>
+#include <wtf/NeverDestroyed.h>
+#include <wtf/PageBlock.h>
+
+#if OS(LINUX)
+#include <elf.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+namespace JSC {
+
+#if OS(LINUX)
+
+namespace PerfLogInternal {
+static const bool verbose = false;
+
+// See tools/perf/Documentation/jitdump-specification.txt in the Linux sources.
+static const uint32_t jitDumpMagic = 0x4A695444;
+static const uint32_t jitDumpVersion = 1;
+
+enum class JITDumpRecordType : uint32_t {
+    CodeLoad = 0,
+    CodeMove = 1,
+    CodeDebugInfo = 2,
+    CodeClose = 3,
+};
+
+struct JITDumpHeader {
+    uint32_t magic { jitDumpMagic };
+    uint32_t version { jitDumpVersion };
+    uint32_t totalSize { sizeof(JITDumpHeader) };
+    uint32_t elfMachine;
+    uint32_t padding { 0 };
+    uint32_t pid;
+    uint64_t timestamp;
+    uint64_t flags { 0 };
+};
+
+struct JITDumpRecordHeader {
+    JITDumpRecordType type;
+    uint32_t totalSize;
+    uint64_t timestamp;
+};
+
+struct JITDumpCodeLoadRecord {
+    JITDumpRecordHeader header;
+    uint32_t pid;
+    uint32_t tid;
+    uint64_t vma;
+    uint64_t codeAddress;
+    uint64_t codeSize;
+    uint64_t codeIndex;
+    // Followed by the NUL terminated name and the code.
+};
+
+struct JITDumpDebugInfoRecord {
+    JITDumpRecordHeader header;
+    uint64_t codeAddress;
+    uint64_t entryCount;
+    // Followed by the entries.
+};
+
+struct JITDumpDebugEntry {
+    uint64_t address;
+    int32_t line;
+    int32_t discriminator;
+    // Followed by the NUL terminated file name.
+};
+
+static uint32_t elfMachine()
+{
+#if CPU(X86_64)
+    return EM_X86_64;
+#elif CPU(X86)
+    return EM_386;
+#elif CPU(ARM64)
+    return EM_AARCH64;
+#elif CPU(ARM)
+    return EM_ARM;
+#elif CPU(MIPS)
+    return EM_MIPS;
+#else
+    return EM_NONE;
+#endif
+}
+
+// perf record has to be run with -k mono for the timestamps to line up with its own.
+static uint64_t timestamp()
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return static_cast<uint64_t>(time.tv_sec) * 1000000000 + time.tv_nsec;
+}
+
+static uint32_t currentThreadID()
+{
+    return static_cast<uint32_t>(syscall(__NR_gettid));
+}
+
+} // namespace PerfLogInternal
+
+using namespace PerfLogInternal;
+
+PerfLog::PerfLog()
+{
+    char fileName[PATH_MAX];
+    snprintf(fileName, sizeof(fileName), "/tmp/perf-%d.map", getpid());
+    m_mapFile = fopen(fileName, "a");
+    if (!m_mapFile)
+        dataLogLn("PerfLog: could not open ", fileName);
+
+    if (!Options::useJITDump())
+        return;
+
+    const char* directory = Options::jitDumpDirectory() ? Options::jitDumpDirectory() : ".";
+    snprintf(fileName, sizeof(fileName), "%s/jit-%d.dump", directory, getpid());
+    int fd = open(fileName, O_CREAT | O_TRUNC | O_RDWR, 0666);
+    if (fd == -1) {
+        dataLogLn("PerfLog: could not open ", fileName);
+        return;
+    }
+
+    // perf finds the dump through the mmap event this generates, so the mapping has to be executable and
+    // stay alive for as long as the process does.
+    void* marker = mmap(nullptr, pageSize(), PROT_READ | PROT_EXEC, MAP_PRIVATE, fd, 0);
+    if (marker == MAP_FAILED) {
+        dataLogLn("PerfLog: could not map ", fileName);
+        close(fd);
+        return;
+    }
+
+    m_jitDumpFile = fdopen(fd, "wb");
+    if (!m_jitDumpFile) {
+        close(fd);
+        return;
+    }
+
+    JITDumpHeader header;
+    header.elfMachine = elfMachine();
+    header.pid = getpid();
+    header.timestamp = timestamp();
+    write(&header, sizeof(header));
+    fflush(m_jitDumpFile);
+}
+
+PerfLog& PerfLog::singleton()
+{
+    static LazyNeverDestroyed<PerfLog> perfLog;
+    static std::once_flag onceKey;
+    std::call_once(onceKey, [] {
+        perfLog.construct();
+    });
+    return perfLog;
+}
+
+void PerfLog::write(const void* data, size_t size)
+{
+    if (fwrite(data, size, 1, m_jitDumpFile) != 1) {
+        dataLogLnIf(verbose, "PerfLog: failed to write to the jitdump file, disabling it");
+        fclose(m_jitDumpFile);
+        m_jitDumpFile = nullptr;
+    }
+}
+
+void PerfLog::writeMapEntry(const CString& name, const void* executableAddress, size_t size)
+{
+    if (!m_mapFile)
+        return;
+    fprintf(m_mapFile, "%" PRIxPTR " %zx %s\n", reinterpret_cast<uintptr_t>(executableAddress), size, name.data());
+    fflush(m_mapFile);
+}
+
+void PerfLog::writeJITDumpEntries(const CString& name, const void* executableAddress, size_t size, CodeBlock* codeBlock)
+{
+    if (!m_jitDumpFile)
+        return;
+
+    uint64_t now = timestamp();
+    uint64_t codeAddress = reinterpret_cast<uintptr_t>(executableAddress);
+
+    // The debug info has to come before the code it describes. We don't track where each bytecode went, so
+    // we point the whole code range at the start of the function.
+    if (codeBlock) {
+        const String& sourceURL = codeBlock->ownerScriptExecutable()->sourceURL();
+        CString fileName = sourceURL.isEmpty() ? CString("[anonymous]") : sourceURL.utf8();
+
+        JITDumpDebugInfoRecord record;
+        record.header.type = JITDumpRecordType::CodeDebugInfo;
+        record.header.totalSize = sizeof(JITDumpDebugInfoRecord) + sizeof(JITDumpDebugEntry) + fileName.length() + 1;
+        record.header.timestamp = now;
+        record.codeAddress = codeAddress;
+        record.entryCount = 1;
+
+        JITDumpDebugEntry entry;
+        entry.address = codeAddress;
+        entry.line = codeBlock->ownerScriptExecutable()->firstLine();
+        entry.discriminator = 0;
+
+        write(&record, sizeof(record));
+        if (!m_jitDumpFile)
+            return;
+        write(&entry, sizeof(entry));
+        if (!m_jitDumpFile)
+            return;
+        write(fileName.data(), fileName.length() + 1);
+        if (!m_jitDumpFile)
+            return;
+    }
+
+    JITDumpCodeLoadRecord record;
+    record.header.type = JITDumpRecordType::CodeLoad;
+    record.header.totalSize = sizeof(JITDumpCodeLoadRecord) + name.length() + 1 + size;
+    record.header.timestamp = now;
+    record.pid = getpid();
+    record.tid = currentThreadID();
+    record.vma = codeAddress;
+    record.codeAddress = codeAddress;
+    record.codeSize = size;
+    record.codeIndex = m_codeIndex++;
+
+    write(&record, sizeof(record));
+    if (!m_jitDumpFile)
+        return;
+    write(name.data(), name.length() + 1);
+    if (!m_jitDumpFile)
+        return;
+    write(executableAddress, size);
+    if (!m_jitDumpFile)
+        return;
+    fflush(m_jitDumpFile);
+}
+
+void PerfLog::log(const CString& name, const void* executableAddress, size_t size, CodeBlock* codeBlock)
+{
+    if (!size)
+        return;
+
+    PerfLog& perfLog = singleton();
+    auto locker = holdLock(perfLog.m_lock);
+    perfLog.writeMapEntry(name, executableAddress, size);
+    perfLog.writeJITDumpEntries(name, executableAddress, size, codeBlock);
+}
+
+#else // OS(LINUX)
+
+void PerfLog::log(const CString&, const void*, size_t, CodeBlock*)
+{
+}
+
+#endif // OS(LINUX)
+
+} // namespace JSC
+
+#endif // ENABLE(ASSEMBLER)
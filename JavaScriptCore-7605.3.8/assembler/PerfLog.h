@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2018 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#if ENABLE(ASSEMBLER)
+
+#include <wtf/Lock.h>
+#include <wtf/NeverDestroyed.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/text/CString.h>
+
+namespace JSC {
+
+class CodeBlock;
+
+// Lets Linux perf symbolize JIT code. With Options::logJITCodeForPerf(), LinkBuffer reports every piece of
+// code it finalizes here, and we append it to /tmp/perf-<pid>.map. With Options::useJITDump(), the code is
+// also written, with its machine code and source position, to the jit-<pid>.dump file that
+// `perf inject --jit` reads.
+class PerfLog {
+    WTF_MAKE_NONCOPYABLE(PerfLog);
+public:
+    static void log(const CString& name, const void* executableAddress, size_t, CodeBlock* = nullptr);
+
+private:
+    friend class LazyNeverDestroyed<PerfLog>;
+
+    PerfLog();
+    static PerfLog& singleton();
+
+    void writeMapEntry(const CString& name, const void* executableAddress, size_t);
+    void writeJITDumpEntries(const CString& name, const void* executableAddress, size_t, CodeBlock*);
+    void write(const void*, size_t);
+
+    Lock m_lock;
+    FILE* m_mapFile { nullptr };
+    FILE* m_jitDumpFile { nullptr };
+    uint64_t m_codeIndex { 0 };
+};
+
+} // namespace JSC
+
+#endif // ENABLE(ASSEMBLER)
@@ -295,6 +295,9 @@ private:
         OP2_MOVSD_WsdVsd    = 0x11,
         OP2_MOVSS_VsdWsd    = 0x10,
         OP2_MOVSS_WsdVsd    = 0x11,
+        OP2_MOVUPS_VpsWps   = 0x10,
+        OP2_MOVUPS_WpsVps   = 0x11,
+        OP2_MOVLHPS_VqUq    = 0x16,
         OP2_MOVAPD_VpdWpd   = 0x28,
         OP2_MOVAPS_VpdWpd   = 0x28,
         OP2_CVTSI2SD_VsdEd  = 0x2A,
@@ -302,6 +305,7 @@ private:
         OP2_CVTTSS2SI_GdWsd = 0x2C,
         OP2_UCOMISD_VsdWsd  = 0x2E,
         OP2_RDTSC           = 0x31,
+        OP2_3BYTE_ESCAPE_38 = 0x38,
         OP2_3BYTE_ESCAPE_3A = 0x3A,
         OP2_CMOVCC          = 0x40,
         OP2_ADDSD_VsdWsd    = 0x58,
@@ -316,7 +320,13 @@ private:
         OP2_ANDNPD_VpdWpd   = 0x55,
         OP2_ORPS_VpdWpd     = 0x56,
         OP2_XORPD_VpdWpd    = 0x57,
+        OP2_PUNPCKLBW_VdqWdq = 0x60,
         OP2_MOVD_VdEd       = 0x6E,
+        OP2_PSHUFD_VdqWdqIb = 0x70,
+        OP2_PSHUFLW_VdqWdqIb = 0x70,
+        OP2_PCMPEQB_VdqWdq  = 0x74,
+        OP2_PCMPEQW_VdqWdq  = 0x75,
+        OP2_PCMPEQD_VdqWdq  = 0x76,
         OP2_MOVD_EdVd       = 0x7E,
         OP2_JCC_rel32       = 0x80,
         OP_SETCC            = 0x90,
@@ -326,6 +336,7 @@ private:
         OP2_CMPXCHGb        = 0xB0,
         OP2_CMPXCHG         = 0xB1,
         OP2_MOVZX_GvEb      = 0xB6,
+        OP2_POPCNT          = 0xB8,
         OP2_BSF             = 0xBC,
         OP2_TZCNT           = 0xBC,
         OP2_BSR             = 0xBD,
@@ -338,12 +349,29 @@ private:
         OP2_PEXTRW_GdUdIb   = 0xC5,
         OP2_PSLLQ_UdqIb     = 0x73,
         OP2_PSRLQ_UdqIb     = 0x73,
+        OP2_PADDQ_VdqWdq    = 0xD4,
+        OP2_PMULLW_VdqWdq   = 0xD5,
+        OP2_PMOVMSKB_GdUdq  = 0xD7,
+        OP2_PAND_VdqWdq     = 0xDB,
+        OP2_PANDN_VdqWdq    = 0xDF,
+        OP2_PSUBB_VdqWdq    = 0xF8,
+        OP2_PSUBW_VdqWdq    = 0xF9,
+        OP2_PSUBD_VdqWdq    = 0xFA,
+        OP2_PSUBQ_VdqWdq    = 0xFB,
+        OP2_PADDB_VdqWdq    = 0xFC,
+        OP2_PADDW_VdqWdq    = 0xFD,
+        OP2_PADDD_VdqWdq    = 0xFE,
         OP2_POR_VdqWdq      = 0XEB,
+        OP2_PXOR_VdqWdq     = 0xEF,
     } TwoByteOpcodeID;
     
     typedef enum {
         OP3_ROUNDSS_VssWssIb = 0x0A,
         OP3_ROUNDSD_VsdWsdIb = 0x0B,
+        OP3_PEXTRD_EdVdqIb   = 0x16,
+        OP3_INSERTPS_VpsUpsIb = 0x21,
+        OP3_PINSRD_VdqEdIb   = 0x22,
+        OP3_PMULLD_VdqWdq    = 0x40,
         OP3_LFENCE           = 0xE8,
         OP3_MFENCE           = 0xF0,
         OP3_SFENCE           = 0xF8,
@@ -1603,6 +1631,20 @@ public:
     }
 #endif
 
+    void popcnt_rr(RegisterID src, RegisterID dst)
+    {
+        m_formatter.prefix(PRE_SSE_F3);
+        m_formatter.twoByteOp(OP2_POPCNT, dst, src);
+    }
+
+#if CPU(X86_64)
+    void popcntq_rr(RegisterID src, RegisterID dst)
+    {
+        m_formatter.prefix(PRE_SSE_F3);
+        m_formatter.twoByteOp64(OP2_POPCNT, dst, src);
+    }
+#endif
+
     void bsr_rr(RegisterID src, RegisterID dst)
     {
         m_formatter.twoByteOp(OP2_BSR, dst, src);
@@ -3419,6 +3461,247 @@ public:
         m_formatter.immediate8(static_cast<uint8_t>(rounding));
     }
 
+    // Packed SSE operations. These operate on all 128 bits of the XMM registers.
+
+    void movups_mr(int offset, RegisterID base, XMMRegisterID dst)
+    {
+        m_formatter.twoByteOp(OP2_MOVUPS_VpsWps, (RegisterID)dst, base, offset);
+    }
+
+    void movups_mr(int offset, RegisterID base, RegisterID index, int scale, XMMRegisterID dst)
+    {
+        m_formatter.twoByteOp(OP2_MOVUPS_VpsWps, dst, base, index, scale, offset);
+    }
+
+    void movups_rm(XMMRegisterID src, int offset, RegisterID base)
+    {
+        m_formatter.twoByteOp(OP2_MOVUPS_WpsVps, (RegisterID)src, base, offset);
+    }
+
+    void movups_rm(XMMRegisterID src, int offset, RegisterID base, RegisterID index, int scale)
+    {
+        m_formatter.twoByteOp(OP2_MOVUPS_WpsVps, src, base, index, scale, offset);
+    }
+
+    void paddb_rr(XMMRegisterID src, XMMRegisterID dst)
+    {
+        m_formatter.prefix(PRE_SSE_66);
+        m_formatter.twoByteOp(OP2_PADDB_VdqWdq, (RegisterID)dst, (RegisterID)src);
+    }
+
+    void paddw_rr(XMMRegisterID src, XMMRegisterID dst)
+    {
+        m_formatter.prefix(PRE_SSE_66);
+        m_formatter.twoByteOp(OP2_PADDW_VdqWdq, (RegisterID)dst, (RegisterID)src);
+    }
+
+    void paddd_rr(XMMRegisterID src, XMMRegisterID dst)
+    {
+        m_formatter.prefix(PRE_SSE_66);
+        m_formatter.twoByteOp(OP2_PADDD_VdqWdq, (RegisterID)dst, (RegisterID)src);
+    }
+
+    void paddq_rr(XMMRegisterID src, XMMRegisterID dst)
+    {
+        m_formatter.prefix(PRE_SSE_66);
+        m_formatter.twoByteOp(OP2_PADDQ_VdqWdq, (RegisterID)dst, (RegisterID)src);
+    }
+
+    void psubb_rr(XMMRegisterID src, XMMRegisterID dst)
+    {
+        m_formatter.prefix(PRE_SSE_66);
+        m_formatter.twoByteOp(OP2_PSUBB_VdqWdq, (RegisterID)dst, (RegisterID)src);
+    }
+
+    void psubw_rr(XMMRegisterID src, XMMRegisterID dst)
+    {
+        m_formatter.prefix(PRE_SSE_66);
+        m_formatter.twoByteOp(OP2_PSUBW_VdqWdq, (RegisterID)dst, (RegisterID)src);
+    }
+
+    void psubd_rr(XMMRegisterID src, XMMRegisterID dst)
+    {
+        m_formatter.prefix(PRE_SSE_66);
+        m_formatter.twoByteOp(OP2_PSUBD_VdqWdq, (RegisterID)dst, (RegisterID)src);
+    }
+
+    void psubq_rr(XMMRegisterID src, XMMRegisterID dst)
+    {
+        m_formatter.prefix(PRE_SSE_66);
+        m_formatter.twoByteOp(OP2_PSUBQ_VdqWdq, (RegisterID)dst, (RegisterID)src);
+    }
+
+    void pmullw_rr(XMMRegisterID src, XMMRegisterID dst)
+    {
+        m_formatter.prefix(PRE_SSE_66);
+        m_formatter.twoByteOp(OP2_PMULLW_VdqWdq, (RegisterID)dst, (RegisterID)src);
+    }
+
+    void pand_rr(XMMRegisterID src, XMMRegisterID dst)
+    {
+        m_formatter.prefix(PRE_SSE_66);
+        m_formatter.twoByteOp(OP2_PAND_VdqWdq, (RegisterID)dst, (RegisterID)src);
+    }
+
+    void pandn_rr(XMMRegisterID src, XMMRegisterID dst)
+    {
+        m_formatter.prefix(PRE_SSE_66);
+        m_formatter.twoByteOp(OP2_PANDN_VdqWdq, (RegisterID)dst, (RegisterID)src);
+    }
+
+    void pxor_rr(XMMRegisterID src, XMMRegisterID dst)
+    {
+        m_formatter.prefix(PRE_SSE_66);
+        m_formatter.twoByteOp(OP2_PXOR_VdqWdq, (RegisterID)dst, (RegisterID)src);
+    }
+
+    void pcmpeqb_rr(XMMRegisterID src, XMMRegisterID dst)
+    {
+        m_formatter.prefix(PRE_SSE_66);
+        m_formatter.twoByteOp(OP2_PCMPEQB_VdqWdq, (RegisterID)dst, (RegisterID)src);
+    }
+
+    void pcmpeqw_rr(XMMRegisterID src, XMMRegisterID dst)
+    {
+        m_formatter.prefix(PRE_SSE_66);
+        m_formatter.twoByteOp(OP2_PCMPEQW_VdqWdq, (RegisterID)dst, (RegisterID)src);
+    }
+
+    void pcmpeqd_rr(XMMRegisterID src, XMMRegisterID dst)
+    {
+        m_formatter.prefix(PRE_SSE_66);
+        m_formatter.twoByteOp(OP2_PCMPEQD_VdqWdq, (RegisterID)dst, (RegisterID)src);
+    }
+
+    void pmovmskb_rr(XMMRegisterID src, RegisterID dst)
+    {
+        m_formatter.prefix(PRE_SSE_66);
+        m_formatter.twoByteOp(OP2_PMOVMSKB_GdUdq, dst, (RegisterID)src);
+    }
+
+    void punpcklbw_rr(XMMRegisterID src, XMMRegisterID dst)
+    {
+        m_formatter.prefix(PRE_SSE_66);
+        m_formatter.twoByteOp(OP2_PUNPCKLBW_VdqWdq, (RegisterID)dst, (RegisterID)src);
+    }
+
+    void addps_rr(XMMRegisterID src, XMMRegisterID dst)
+    {
+        m_formatter.twoByteOp(OP2_ADDSD_VsdWsd, (RegisterID)dst, (RegisterID)src);
+    }
+
+    void addpd_rr(XMMRegisterID src, XMMRegisterID dst)
+    {
+        m_formatter.prefix(PRE_SSE_66);
+        m_formatter.twoByteOp(OP2_ADDSD_VsdWsd, (RegisterID)dst, (RegisterID)src);
+    }
+
+    void subps_rr(XMMRegisterID src, XMMRegisterID dst)
+    {
+        m_formatter.twoByteOp(OP2_SUBSD_VsdWsd, (RegisterID)dst, (RegisterID)src);
+    }
+
+    void subpd_rr(XMMRegisterID src, XMMRegisterID dst)
+    {
+        m_formatter.prefix(PRE_SSE_66);
+        m_formatter.twoByteOp(OP2_SUBSD_VsdWsd, (RegisterID)dst, (RegisterID)src);
+    }
+
+    void mulps_rr(XMMRegisterID src, XMMRegisterID dst)
+    {
+        m_formatter.twoByteOp(OP2_MULSD_VsdWsd, (RegisterID)dst, (RegisterID)src);
+    }
+
+    void mulpd_rr(XMMRegisterID src, XMMRegisterID dst)
+    {
+        m_formatter.prefix(PRE_SSE_66);
+        m_formatter.twoByteOp(OP2_MULSD_VsdWsd, (RegisterID)dst, (RegisterID)src);
+    }
+
+    void divps_rr(XMMRegisterID src, XMMRegisterID dst)
+    {
+        m_formatter.twoByteOp(OP2_DIVSD_VsdWsd, (RegisterID)dst, (RegisterID)src);
+    }
+
+    void divpd_rr(XMMRegisterID src, XMMRegisterID dst)
+    {
+        m_formatter.prefix(PRE_SSE_66);
+        m_formatter.twoByteOp(OP2_DIVSD_VsdWsd, (RegisterID)dst, (RegisterID)src);
+    }
+
+    void sqrtps_rr(XMMRegisterID src, XMMRegisterID dst)
+    {
+        m_formatter.twoByteOp(OP2_SQRTSD_VsdWsd, (RegisterID)dst, (RegisterID)src);
+    }
+
+    void sqrtpd_rr(XMMRegisterID src, XMMRegisterID dst)
+    {
+        m_formatter.prefix(PRE_SSE_66);
+        m_formatter.twoByteOp(OP2_SQRTSD_VsdWsd, (RegisterID)dst, (RegisterID)src);
+    }
+
+    void movlhps_rr(XMMRegisterID src, XMMRegisterID dst)
+    {
+        m_formatter.twoByteOp(OP2_MOVLHPS_VqUq, (RegisterID)dst, (RegisterID)src);
+    }
+
+    void pmulld_rr(XMMRegisterID src, XMMRegisterID dst)
+    {
+        m_formatter.prefix(PRE_SSE_66);
+        m_formatter.threeByteOp(OP2_3BYTE_ESCAPE_38, OP3_PMULLD_VdqWdq, (RegisterID)dst, (RegisterID)src);
+    }
+
+    void pshufd_irr(uint8_t order, XMMRegisterID src, XMMRegisterID dst)
+    {
+        m_formatter.prefix(PRE_SSE_66);
+        m_formatter.twoByteOp(OP2_PSHUFD_VdqWdqIb, (RegisterID)dst, (RegisterID)src);
+        m_formatter.immediate8(order);
+    }
+
+    void pshuflw_irr(uint8_t order, XMMRegisterID src, XMMRegisterID dst)
+    {
+        m_formatter.prefix(PRE_SSE_F2);
+        m_formatter.twoByteOp(OP2_PSHUFLW_VdqWdqIb, (RegisterID)dst, (RegisterID)src);
+        m_formatter.immediate8(order);
+    }
+
+    void pextrd_irr(uint8_t lane, XMMRegisterID src, RegisterID dst)
+    {
+        m_formatter.prefix(PRE_SSE_66);
+        m_formatter.threeByteOp(OP2_3BYTE_ESCAPE_3A, OP3_PEXTRD_EdVdqIb, (RegisterID)src, dst);
+        m_formatter.immediate8(lane);
+    }
+
+    void pinsrd_irr(uint8_t lane, RegisterID src, XMMRegisterID dst)
+    {
+        m_formatter.prefix(PRE_SSE_66);
+        m_formatter.threeByteOp(OP2_3BYTE_ESCAPE_3A, OP3_PINSRD_VdqEdIb, (RegisterID)dst, src);
+        m_formatter.immediate8(lane);
+    }
+
+#if CPU(X86_64)
+    void pextrq_irr(uint8_t lane, XMMRegisterID src, RegisterID dst)
+    {
+        m_formatter.prefix(PRE_SSE_66);
+        m_formatter.threeByteOp64(OP2_3BYTE_ESCAPE_3A, OP3_PEXTRD_EdVdqIb, (RegisterID)src, dst);
+        m_formatter.immediate8(lane);
+    }
+
+    void pinsrq_irr(uint8_t lane, RegisterID src, XMMRegisterID dst)
+    {
+        m_formatter.prefix(PRE_SSE_66);
+        m_formatter.threeByteOp64(OP2_3BYTE_ESCAPE_3A, OP3_PINSRD_VdqEdIb, (RegisterID)dst, src);
+        m_formatter.immediate8(lane);
+    }
+#endif
+
+    void insertps_irr(uint8_t control, XMMRegisterID src, XMMRegisterID dst)
+    {
+        m_formatter.prefix(PRE_SSE_66);
+        m_formatter.threeByteOp(OP2_3BYTE_ESCAPE_3A, OP3_INSERTPS_VpsUpsIb, (RegisterID)dst, (RegisterID)src);
+        m_formatter.immediate8(control);
+    }
+
     // Misc instructions:
 
     void int3()
@@ -4483,6 +4766,16 @@ private:
             writer.putByteUnchecked(opcode);
             writer.memoryModRM(reg, base, index, scale, offset);
         }
+
+        void threeByteOp64(TwoByteOpcodeID twoBytePrefix, ThreeByteOpcodeID opcode, int reg, RegisterID rm)
+        {
+            SingleInstructionBufferWriter writer(m_buffer);
+            writer.emitRexW(reg, 0, rm);
+            writer.putByteUnchecked(OP_2BYTE_ESCAPE);
+            writer.putByteUnchecked(twoBytePrefix);
+            writer.putByteUnchecked(opcode);
+            writer.registerModRM(reg, rm);
+        }
 #endif
 
         // Byte-operands:
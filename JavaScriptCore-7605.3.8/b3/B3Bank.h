@@ -56,6 +56,7 @@ inline Bank bankForType(Type type)
         return GP;
     case Float:
     case Double:
+    case V128:
         return FP;
     }
     ASSERT_NOT_REACHED();
@@ -441,7 +441,7 @@ private:
         // better than a binary switch.
         const unsigned minCasesForTable = 7;
         const unsigned densityLimit = 4;
-        if (end - start >= minCasesForTable) {
+        if (end - start >= minCasesForTable && !m_proc.needsRelocatableCode()) {
             int64_t firstValue = cases[start].caseValue();
             int64_t lastValue = cases[end - 1].caseValue();
             if ((lastValue - firstValue + 1) / (end - start) < densityLimit) {
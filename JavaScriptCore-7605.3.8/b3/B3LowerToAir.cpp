@@ -42,6 +42,7 @@
 #include "B3CCallValue.h"
 #include "B3CheckSpecial.h"
 #include "B3Commutativity.h"
+#include "B3Const128Value.h"
 #include "B3Dominators.h"
 #include "B3FenceValue.h"
 #include "B3MemoryValueInlines.h"
@@ -50,6 +51,7 @@
 #include "B3PhaseScope.h"
 #include "B3PhiChildren.h"
 #include "B3Procedure.h"
+#include "B3SIMDValue.h"
 #include "B3SlotBaseValue.h"
 #include "B3StackSlot.h"
 #include "B3UpsilonValue.h"
@@ -117,6 +119,8 @@ public:
             m_blockToBlock[block] = m_code.addBlock(block->frequency());
         
         for (Value* value : m_procedure.values()) {
+            if (value->type() == V128)
+                m_code.setUsesSIMD();
             switch (value->opcode()) {
             case Phi: {
                 m_phiToTmp[value] = m_code.newTmp(value->resultBank());
@@ -909,6 +913,55 @@ private:
         appendBinOp<opcode32, opcode64, Air::Oops, Air::Oops, commutativity>(left, right);
     }
 
+    // Vector instructions are selected by lane shape rather than by type, since every vector is V128.
+    Air::Opcode opcodeForLane(
+        SIMDLane lane, Air::Opcode opcodeInt8, Air::Opcode opcodeInt16, Air::Opcode opcodeInt32,
+        Air::Opcode opcodeInt64, Air::Opcode opcodeFloat, Air::Opcode opcodeDouble)
+    {
+        Air::Opcode opcode = Air::Oops;
+        switch (lane) {
+        case SIMDLane::i8x16:
+            opcode = opcodeInt8;
+            break;
+        case SIMDLane::i16x8:
+            opcode = opcodeInt16;
+            break;
+        case SIMDLane::i32x4:
+            opcode = opcodeInt32;
+            break;
+        case SIMDLane::i64x2:
+            opcode = opcodeInt64;
+            break;
+        case SIMDLane::f32x4:
+            opcode = opcodeFloat;
+            break;
+        case SIMDLane::f64x2:
+            opcode = opcodeDouble;
+            break;
+        case SIMDLane::v128:
+            break;
+        }
+        RELEASE_ASSERT(opcode != Air::Oops);
+        return opcode;
+    }
+
+    // Our vector instructions only have two-operand forms:
+    //     Op a, b
+    // means:
+    //     b = b Op a
+    void appendVectorBinOp(Air::Opcode opcode, Value* left, Value* right, Commutativity commutativity)
+    {
+        using namespace Air;
+        Tmp result = tmp(m_value);
+        if (commutativity == Commutative && left != right && preferRightForResult(left, right)) {
+            append(MoveVector, tmp(right), result);
+            append(opcode, tmp(left), result);
+            return;
+        }
+        append(MoveVector, tmp(left), result);
+        append(opcode, tmp(right), result);
+    }
+
     template<Air::Opcode opcode32, Air::Opcode opcode64>
     void appendShift(Value* value, Value* amount)
     {
@@ -1076,6 +1129,9 @@ private:
                 return MoveDouble;
             }
             break;
+        case Width128:
+            RELEASE_ASSERT(bank == FP);
+            return MoveVector;
         }
         RELEASE_ASSERT_NOT_REACHED();
     }
@@ -1121,6 +1177,8 @@ private:
             return MoveFloat;
         case Double:
             return MoveDouble;
+        case V128:
+            return MoveVector;
         case Void:
             break;
         }
@@ -1155,6 +1213,8 @@ private:
             return MoveFloat;
         case Double:
             return MoveDouble;
+        case V128:
+            return MoveVector;
         case Void:
             break;
         }
@@ -1810,6 +1870,8 @@ private:
                             left.consume(*this), right.consume(*this)));
                     }
                     return Inst();
+                case Width128:
+                    return Inst();
                 }
                 ASSERT_NOT_REACHED();
             },
@@ -1840,6 +1902,8 @@ private:
                             left.consume(*this), right.consume(*this)));
                     }
                     return Inst();
+                case Width128:
+                    return Inst();
                 }
                 ASSERT_NOT_REACHED();
             },
@@ -1888,6 +1952,8 @@ private:
                             left.consume(*this), right.consume(*this), tmp(m_value)));
                     }
                     return Inst();
+                case Width128:
+                    return Inst();
                 }
                 ASSERT_NOT_REACHED();
             },
@@ -1912,6 +1978,8 @@ private:
                             left.consume(*this), right.consume(*this), tmp(m_value)));
                     }
                     return Inst();
+                case Width128:
+                    return Inst();
                 }
                 ASSERT_NOT_REACHED();
             },
@@ -1979,6 +2047,8 @@ private:
                     return createSelectInstruction(config.moveConditionally32, relCond, left, right);
                 case Width64:
                     return createSelectInstruction(config.moveConditionally64, relCond, left, right);
+                case Width128:
+                    return Inst();
                 }
                 ASSERT_NOT_REACHED();
             },
@@ -1994,6 +2064,8 @@ private:
                     return createSelectInstruction(config.moveConditionallyTest32, resCond, left, right);
                 case Width64:
                     return createSelectInstruction(config.moveConditionallyTest64, resCond, left, right);
+                case Width128:
+                    return Inst();
                 }
                 ASSERT_NOT_REACHED();
             },
@@ -2407,6 +2479,9 @@ private:
             case Width64:
                 prepareOpcode = Move;
                 break;
+            case Width128:
+                RELEASE_ASSERT_NOT_REACHED();
+                break;
             }
         } else {
             RELEASE_ASSERT(isARM64());
@@ -3003,6 +3078,130 @@ private:
             return;
         }
 
+        case Const128: {
+            Const128Value* constant = m_value->as<Const128Value>();
+            if (constant->isZero()) {
+                append(MoveZeroToVector, tmp(m_value));
+                return;
+            }
+            if (m_procedure.needsRelocatableCode()) {
+                // Build the constant from immediates rather than loading it from a data section.
+                append(MoveZeroToVector, tmp(m_value));
+                Tmp lane = m_code.newTmp(GP);
+                for (unsigned i = 0; i < 2; ++i) {
+                    if (!constant->value().u64x2[i])
+                        continue;
+                    append(Move, Arg::bigImm(constant->value().u64x2[i]), lane);
+                    append(VectorReplaceLaneInt64x2, Arg::imm(i), lane, tmp(m_value));
+                }
+                return;
+            }
+            v128_t* data = static_cast<v128_t*>(m_procedure.addDataSection(sizeof(v128_t)));
+            *data = constant->value();
+            Tmp address = m_code.newTmp(GP);
+            append(Move, Arg::bigImm(bitwise_cast<intptr_t>(data)), address);
+            append(MoveVector, Arg::addr(address), tmp(m_value));
+            return;
+        }
+
+        case VectorSplat: {
+            SIMDValue* simd = m_value->as<SIMDValue>();
+            Air::Opcode opcode = opcodeForLane(
+                simd->lane(), VectorSplatInt8x16, VectorSplatInt16x8, VectorSplatInt32x4,
+                VectorSplatInt64x2, VectorSplatFloat32x4, VectorSplatFloat64x2);
+            append(opcode, tmp(simd->child(0)), tmp(m_value));
+            return;
+        }
+
+        case VectorExtractLane: {
+            SIMDValue* simd = m_value->as<SIMDValue>();
+            Air::Opcode opcode = opcodeForLane(
+                simd->lane(), Air::Oops, Air::Oops, VectorExtractLaneInt32x4,
+                VectorExtractLaneInt64x2, VectorExtractLaneFloat32x4, VectorExtractLaneFloat64x2);
+            append(opcode, Arg::imm(simd->immediate()), tmp(simd->child(0)), tmp(m_value));
+            return;
+        }
+
+        case VectorReplaceLane: {
+            SIMDValue* simd = m_value->as<SIMDValue>();
+            Air::Opcode opcode = opcodeForLane(
+                simd->lane(), Air::Oops, Air::Oops, VectorReplaceLaneInt32x4,
+                VectorReplaceLaneInt64x2, VectorReplaceLaneFloat32x4, VectorReplaceLaneFloat64x2);
+            append(MoveVector, tmp(simd->child(0)), tmp(m_value));
+            append(opcode, Arg::imm(simd->immediate()), tmp(simd->child(1)), tmp(m_value));
+            return;
+        }
+
+        case VectorAdd: {
+            SIMDValue* simd = m_value->as<SIMDValue>();
+            Air::Opcode opcode = opcodeForLane(
+                simd->lane(), VectorAddInt8x16, VectorAddInt16x8, VectorAddInt32x4,
+                VectorAddInt64x2, VectorAddFloat32x4, VectorAddFloat64x2);
+            appendVectorBinOp(opcode, simd->child(0), simd->child(1), Commutative);
+            return;
+        }
+
+        case VectorSub: {
+            SIMDValue* simd = m_value->as<SIMDValue>();
+            Air::Opcode opcode = opcodeForLane(
+                simd->lane(), VectorSubInt8x16, VectorSubInt16x8, VectorSubInt32x4,
+                VectorSubInt64x2, VectorSubFloat32x4, VectorSubFloat64x2);
+            appendVectorBinOp(opcode, simd->child(0), simd->child(1), NotCommutative);
+            return;
+        }
+
+        case VectorMul: {
+            SIMDValue* simd = m_value->as<SIMDValue>();
+            Air::Opcode opcode = opcodeForLane(
+                simd->lane(), Air::Oops, VectorMulInt16x8, VectorMulInt32x4,
+                Air::Oops, VectorMulFloat32x4, VectorMulFloat64x2);
+            appendVectorBinOp(opcode, simd->child(0), simd->child(1), Commutative);
+            return;
+        }
+
+        case VectorDiv: {
+            SIMDValue* simd = m_value->as<SIMDValue>();
+            Air::Opcode opcode = opcodeForLane(
+                simd->lane(), Air::Oops, Air::Oops, Air::Oops,
+                Air::Oops, VectorDivFloat32x4, VectorDivFloat64x2);
+            appendVectorBinOp(opcode, simd->child(0), simd->child(1), NotCommutative);
+            return;
+        }
+
+        case VectorSqrt: {
+            SIMDValue* simd = m_value->as<SIMDValue>();
+            Air::Opcode opcode = opcodeForLane(
+                simd->lane(), Air::Oops, Air::Oops, Air::Oops,
+                Air::Oops, VectorSqrtFloat32x4, VectorSqrtFloat64x2);
+            append(opcode, tmp(simd->child(0)), tmp(m_value));
+            return;
+        }
+
+        case B3::VectorNot: {
+            append(Air::VectorNot, tmp(m_value->child(0)), tmp(m_value), m_code.newTmp(FP));
+            return;
+        }
+
+        case B3::VectorAnd: {
+            appendVectorBinOp(Air::VectorAnd, m_value->child(0), m_value->child(1), Commutative);
+            return;
+        }
+
+        case B3::VectorAndnot: {
+            appendVectorBinOp(Air::VectorAndnot, m_value->child(0), m_value->child(1), NotCommutative);
+            return;
+        }
+
+        case B3::VectorOr: {
+            appendVectorBinOp(Air::VectorOr, m_value->child(0), m_value->child(1), Commutative);
+            return;
+        }
+
+        case B3::VectorXor: {
+            appendVectorBinOp(Air::VectorXor, m_value->child(0), m_value->child(1), Commutative);
+            return;
+        }
+
         case Select: {
             MoveConditionallyConfig config;
             if (isInt(m_value->type())) {
@@ -3407,6 +3606,10 @@ private:
                 append(MoveDouble, tmp(value), returnValueFPR);
                 append(RetDouble, returnValueFPR);
                 break;
+            case V128:
+                // There is no calling convention for vectors yet.
+                RELEASE_ASSERT_NOT_REACHED();
+                break;
             }
             return;
         }
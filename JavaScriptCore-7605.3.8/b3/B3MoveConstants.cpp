@@ -264,6 +264,11 @@ private:
 
     void lowerFPConstants()
     {
+        if (m_proc.needsRelocatableCode()) {
+            lowerFPConstantsToImmediates();
+            return;
+        }
+
         for (Value* value : m_proc.values()) {
             ValueKey key = value->key();
             if (goesInTable(key))
@@ -325,6 +330,32 @@ private:
         }
     }
 
+    void lowerFPConstantsToImmediates()
+    {
+        // Relocatable code cannot point at a constant table, so we move the bits through a GPR.
+        for (BasicBlock* block : m_proc) {
+            for (unsigned valueIndex = 0; valueIndex < block->size(); ++valueIndex) {
+                Value* value = block->at(valueIndex);
+                if (!goesInTable(value->key()))
+                    continue;
+
+                Value* bits;
+                if (value->opcode() == ConstDouble) {
+                    bits = m_insertionSet.insertIntConstant(
+                        valueIndex, value->origin(), Int64, bitwise_cast<int64_t>(value->asDouble()));
+                } else {
+                    bits = m_insertionSet.insertIntConstant(
+                        valueIndex, value->origin(), Int32, bitwise_cast<int32_t>(value->asFloat()));
+                }
+                Value* result = m_insertionSet.insert<Value>(
+                    valueIndex, BitwiseCast, value->origin(), bits);
+                value->replaceWithIdentity(result);
+            }
+
+            m_insertionSet.execute(block);
+        }
+    }
+
     bool goesInTable(const ValueKey& key)
     {
         return (key.opcode() == ConstDouble && key != doubleZero())
@@ -121,6 +121,9 @@ void printInternal(PrintStream& out, Opcode opcode)
     case ConstFloat:
         out.print("ConstFloat");
         return;
+    case Const128:
+        out.print("Const128");
+        return;
     case Get:
         out.print("Get");
         return;
@@ -265,6 +268,45 @@ void printInternal(PrintStream& out, Opcode opcode)
     case Select:
         out.print("Select");
         return;
+    case VectorSplat:
+        out.print("VectorSplat");
+        return;
+    case VectorExtractLane:
+        out.print("VectorExtractLane");
+        return;
+    case VectorReplaceLane:
+        out.print("VectorReplaceLane");
+        return;
+    case VectorAdd:
+        out.print("VectorAdd");
+        return;
+    case VectorSub:
+        out.print("VectorSub");
+        return;
+    case VectorMul:
+        out.print("VectorMul");
+        return;
+    case VectorDiv:
+        out.print("VectorDiv");
+        return;
+    case VectorSqrt:
+        out.print("VectorSqrt");
+        return;
+    case VectorNot:
+        out.print("VectorNot");
+        return;
+    case VectorAnd:
+        out.print("VectorAnd");
+        return;
+    case VectorAndnot:
+        out.print("VectorAndnot");
+        return;
+    case VectorOr:
+        out.print("VectorOr");
+        return;
+    case VectorXor:
+        out.print("VectorXor");
+        return;
     case Load8Z:
         out.print("Load8Z");
         return;
@@ -55,6 +55,8 @@ enum Opcode : int16_t {
     Const64,
     ConstDouble,
     ConstFloat,
+    // A 128-bit vector constant. Use the Const128Value class.
+    Const128,
 
     // B3 supports non-SSA variables. These are accessed using Get and Set opcodes. Use the
     // VariableValue class. It's a good idea to run fixSSA() to turn these into SSA. The
@@ -152,6 +154,25 @@ enum Opcode : int16_t {
     // is returned. Otherwise, the third child is returned.
     Select,
 
+    // Vector math on V128 values. These use the SIMDValue class, which says how the 128 bits are
+    // split into lanes. VectorSplat takes a scalar of the lane type and broadcasts it. The lane
+    // opcodes carry the lane index as an immediate: VectorExtractLane returns a scalar of the lane
+    // type and VectorReplaceLane takes the vector followed by the new lane value. The bitwise ops
+    // ignore the lane type. VectorAndnot computes ~left & right.
+    VectorSplat,
+    VectorExtractLane,
+    VectorReplaceLane,
+    VectorAdd,
+    VectorSub,
+    VectorMul,
+    VectorDiv,
+    VectorSqrt,
+    VectorNot,
+    VectorAnd,
+    VectorAndnot,
+    VectorOr,
+    VectorXor,
+
     // Memory loads. Opcode indicates how we load and the loaded type. These use MemoryValue.
     // These return Int32:
     Load8Z,
@@ -165,7 +186,7 @@ enum Opcode : int16_t {
     // These take an Int32 value:
     Store8,
     Store16,
-    // This is a polymorphic store for Int32, Int64, Float, and Double.
+    // This is a polymorphic store for Int32, Int64, Float, Double, and V128.
     Store,
     
     // Atomic compare and swap that returns a boolean. May choose to do nothing and return false. You can
@@ -35,6 +35,7 @@
 #include "B3BasicBlockUtils.h"
 #include "B3BlockWorklist.h"
 #include "B3CFG.h"
+#include "B3Const128Value.h"
 #include "B3DataSection.h"
 #include "B3Dominators.h"
 #include "B3NaturalLoops.h"
@@ -135,6 +136,8 @@ Value* Procedure::addConstant(Origin origin, Type type, uint64_t bits)
 
 Value* Procedure::addBottom(Origin origin, Type type)
 {
+    if (type == V128)
+        return add<Const128Value>(origin, v128_t());
     return addIntConstant(origin, type, 0);
 }
 
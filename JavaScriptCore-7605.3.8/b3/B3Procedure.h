@@ -248,6 +248,12 @@ public:
     void setNeedsUsedRegisters(bool value) { m_needsUsedRegisters = value; }
     bool needsUsedRegisters() const { return m_needsUsedRegisters; }
 
+    // Relocatable code does not point into data sections that B3 allocates on the client's behalf
+    // (FP constant tables, switch jump tables, vector constants), so the generated code can be
+    // copied elsewhere once the client has repatched its own absolute addresses.
+    void setNeedsRelocatableCode(bool value) { m_needsRelocatableCode = value; }
+    bool needsRelocatableCode() const { return m_needsRelocatableCode; }
+
     JS_EXPORT_PRIVATE unsigned frameSize() const;
     JS_EXPORT_PRIVATE RegisterAtOffsetList calleeSaveRegisterAtOffsetList() const;
 
@@ -290,6 +296,7 @@ private:
     PCToOriginMap m_pcToOriginMap;
     unsigned m_optLevel { defaultOptLevel() };
     bool m_needsUsedRegisters { true };
+    bool m_needsRelocatableCode { false };
     bool m_hasQuirks { false };
 };
 
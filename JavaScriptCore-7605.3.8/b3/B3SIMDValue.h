@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2018 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#if ENABLE(B3_JIT)
+
+#include "B3Value.h"
+
+namespace JSC { namespace B3 {
+
+// How a SIMDValue interprets the 128 bits of its V128 operands. v128 means that the lanes don't
+// matter, like for the bitwise operations.
+enum class SIMDLane : uint8_t {
+    v128,
+    i8x16,
+    i16x8,
+    i32x4,
+    i64x2,
+    f32x4,
+    f64x2
+};
+
+inline unsigned elementCount(SIMDLane lane)
+{
+    switch (lane) {
+    case SIMDLane::v128:
+        return 1;
+    case SIMDLane::i8x16:
+        return 16;
+    case SIMDLane::i16x8:
+        return 8;
+    case SIMDLane::i32x4:
+    case SIMDLane::f32x4:
+        return 4;
+    case SIMDLane::i64x2:
+    case SIMDLane::f64x2:
+        return 2;
+    }
+    RELEASE_ASSERT_NOT_REACHED();
+    return 0;
+}
+
+// The scalar type that a lane is extracted to or replaced from. Lanes narrower than 32 bits use
+// Int32, like wasm does.
+inline Type elementType(SIMDLane lane)
+{
+    switch (lane) {
+    case SIMDLane::i8x16:
+    case SIMDLane::i16x8:
+    case SIMDLane::i32x4:
+        return Int32;
+    case SIMDLane::i64x2:
+        return Int64;
+    case SIMDLane::f32x4:
+        return Float;
+    case SIMDLane::f64x2:
+        return Double;
+    case SIMDLane::v128:
+        break;
+    }
+    RELEASE_ASSERT_NOT_REACHED();
+    return Void;
+}
+
+inline bool isFloatingPointLane(SIMDLane lane)
+{
+    return lane == SIMDLane::f32x4 || lane == SIMDLane::f64x2;
+}
+
+class JS_EXPORT_PRIVATE SIMDValue : public Value {
+public:
+    static bool accepts(Kind kind)
+    {
+        switch (kind.opcode()) {
+        case VectorSplat:
+        case VectorExtractLane:
+        case VectorReplaceLane:
+        case VectorAdd:
+        case VectorSub:
+        case VectorMul:
+        case VectorDiv:
+        case VectorSqrt:
+        case VectorNot:
+        case VectorAnd:
+        case VectorAndnot:
+        case VectorOr:
+        case VectorXor:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    ~SIMDValue();
+
+    SIMDLane lane() const { return m_lane; }
+
+    // The lane index for VectorExtractLane and VectorReplaceLane.
+    uint8_t immediate() const { return m_immediate; }
+
+protected:
+    void dumpMeta(CommaPrinter&, PrintStream&) const override;
+
+    Value* cloneImpl() const override;
+
+private:
+    friend class Procedure;
+
+    SIMDValue(Origin origin, Kind kind, Type type, SIMDLane lane, Value* child)
+        : Value(CheckedOpcode, kind, type, origin, child)
+        , m_lane(lane)
+    {
+    }
+
+    SIMDValue(Origin origin, Kind kind, Type type, SIMDLane lane, Value* left, Value* right)
+        : Value(CheckedOpcode, kind, type, origin, left, right)
+        , m_lane(lane)
+    {
+    }
+
+    SIMDValue(Origin origin, Kind kind, Type type, SIMDLane lane, uint8_t immediate, Value* child)
+        : Value(CheckedOpcode, kind, type, origin, child)
+        , m_lane(lane)
+        , m_immediate(immediate)
+    {
+    }
+
+    SIMDValue(Origin origin, Kind kind, Type type, SIMDLane lane, uint8_t immediate, Value* vector, Value* scalar)
+        : Value(CheckedOpcode, kind, type, origin, vector, scalar)
+        , m_lane(lane)
+        , m_immediate(immediate)
+    {
+    }
+
+    SIMDLane m_lane;
+    uint8_t m_immediate { 0 };
+};
+
+} } // namespace JSC::B3
+
+namespace WTF {
+
+void printInternal(PrintStream&, JSC::B3::SIMDLane);
+
+} // namespace WTF
+
+#endif // ENABLE(B3_JIT)
@@ -43,6 +43,15 @@ enum Type : int8_t {
     Int64,
     Float,
     Double,
+    V128,
+};
+
+// The bits of a V128 value. B3 treats these as opaque; SIMDValue says how to interpret the lanes.
+struct v128_t {
+    uint64_t u64x2[2];
+
+    bool operator==(const v128_t& other) const { return u64x2[0] == other.u64x2[0] && u64x2[1] == other.u64x2[1]; }
+    bool operator!=(const v128_t& other) const { return !(*this == other); }
 };
 
 inline bool isInt(Type type)
@@ -55,6 +64,11 @@ inline bool isFloat(Type type)
     return type == Float || type == Double;
 }
 
+inline bool isVector(Type type)
+{
+    return type == V128;
+}
+
 inline Type pointerType()
 {
     if (is32Bit())
@@ -73,6 +87,8 @@ inline size_t sizeofType(Type type)
     case Int64:
     case Double:
         return 8;
+    case V128:
+        return 16;
     }
     ASSERT_NOT_REACHED();
 }
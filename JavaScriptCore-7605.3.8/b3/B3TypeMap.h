@@ -46,6 +46,7 @@ public:
         , m_int64()
         , m_float()
         , m_double()
+        , m_v128()
     {
     }
     
@@ -62,6 +63,8 @@ public:
             return m_float;
         case Double:
             return m_double;
+        case V128:
+            return m_v128;
         }
         ASSERT_NOT_REACHED();
     }
@@ -88,7 +91,8 @@ public:
             ", int32 = ", m_int32,
             ", int64 = ", m_int64,
             ", float = ", m_float,
-            ", double = ", m_double, "}");
+            ", double = ", m_double,
+            ", v128 = ", m_v128, "}");
     }
     
 private:
@@ -97,6 +101,7 @@ private:
     T m_int64;
     T m_float;
     T m_double;
+    T m_v128;
 };
 
 } } // namespace JSC::B3
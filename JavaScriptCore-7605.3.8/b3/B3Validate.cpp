@@ -35,6 +35,7 @@
 #include "B3Dominators.h"
 #include "B3MemoryValue.h"
 #include "B3Procedure.h"
+#include "B3SIMDValue.h"
 #include "B3SlotBaseValue.h"
 #include "B3StackSlot.h"
 #include "B3SwitchValue.h"
@@ -165,6 +166,11 @@ public:
                 VALIDATE(!value->numChildren(), ("At ", *value));
                 VALIDATE(value->type() == Float, ("At ", *value));
                 break;
+            case Const128:
+                VALIDATE(!value->kind().hasExtraBits(), ("At ", *value));
+                VALIDATE(!value->numChildren(), ("At ", *value));
+                VALIDATE(value->type() == V128, ("At ", *value));
+                break;
             case Set:
                 VALIDATE(!value->kind().hasExtraBits(), ("At ", *value));
                 VALIDATE(value->numChildren() == 1, ("At ", *value));
@@ -339,6 +345,67 @@ public:
                 VALIDATE(isInt(value->child(0)->type()), ("At ", *value));
                 VALIDATE(value->type() == value->child(1)->type(), ("At ", *value));
                 VALIDATE(value->type() == value->child(2)->type(), ("At ", *value));
+                // Air has no conditional vector moves.
+                VALIDATE(value->type() != V128, ("At ", *value));
+                break;
+            case VectorSplat:
+                VALIDATE(!value->kind().hasExtraBits(), ("At ", *value));
+                VALIDATE(value->numChildren() == 1, ("At ", *value));
+                VALIDATE(value->as<SIMDValue>()->lane() != SIMDLane::v128, ("At ", *value));
+                VALIDATE(value->child(0)->type() == elementType(value->as<SIMDValue>()->lane()), ("At ", *value));
+                VALIDATE(value->type() == V128, ("At ", *value));
+                break;
+            case VectorExtractLane:
+                VALIDATE(!value->kind().hasExtraBits(), ("At ", *value));
+                VALIDATE(value->numChildren() == 1, ("At ", *value));
+                VALIDATE(value->as<SIMDValue>()->lane() != SIMDLane::v128, ("At ", *value));
+                VALIDATE(value->as<SIMDValue>()->immediate() < elementCount(value->as<SIMDValue>()->lane()), ("At ", *value));
+                VALIDATE(value->child(0)->type() == V128, ("At ", *value));
+                VALIDATE(value->type() == elementType(value->as<SIMDValue>()->lane()), ("At ", *value));
+                break;
+            case VectorReplaceLane:
+                VALIDATE(!value->kind().hasExtraBits(), ("At ", *value));
+                VALIDATE(value->numChildren() == 2, ("At ", *value));
+                VALIDATE(value->as<SIMDValue>()->lane() != SIMDLane::v128, ("At ", *value));
+                VALIDATE(value->as<SIMDValue>()->immediate() < elementCount(value->as<SIMDValue>()->lane()), ("At ", *value));
+                VALIDATE(value->child(0)->type() == V128, ("At ", *value));
+                VALIDATE(value->child(1)->type() == elementType(value->as<SIMDValue>()->lane()), ("At ", *value));
+                VALIDATE(value->type() == V128, ("At ", *value));
+                break;
+            case VectorAdd:
+            case VectorSub:
+            case VectorMul:
+            case VectorDiv:
+                VALIDATE(!value->kind().hasExtraBits(), ("At ", *value));
+                VALIDATE(value->numChildren() == 2, ("At ", *value));
+                VALIDATE(value->as<SIMDValue>()->lane() != SIMDLane::v128, ("At ", *value));
+                VALIDATE(value->opcode() != VectorDiv || isFloatingPointLane(value->as<SIMDValue>()->lane()), ("At ", *value));
+                VALIDATE(value->child(0)->type() == V128, ("At ", *value));
+                VALIDATE(value->child(1)->type() == V128, ("At ", *value));
+                VALIDATE(value->type() == V128, ("At ", *value));
+                break;
+            case VectorSqrt:
+                VALIDATE(!value->kind().hasExtraBits(), ("At ", *value));
+                VALIDATE(value->numChildren() == 1, ("At ", *value));
+                VALIDATE(isFloatingPointLane(value->as<SIMDValue>()->lane()), ("At ", *value));
+                VALIDATE(value->child(0)->type() == V128, ("At ", *value));
+                VALIDATE(value->type() == V128, ("At ", *value));
+                break;
+            case VectorNot:
+                VALIDATE(!value->kind().hasExtraBits(), ("At ", *value));
+                VALIDATE(value->numChildren() == 1, ("At ", *value));
+                VALIDATE(value->child(0)->type() == V128, ("At ", *value));
+                VALIDATE(value->type() == V128, ("At ", *value));
+                break;
+            case VectorAnd:
+            case VectorAndnot:
+            case VectorOr:
+            case VectorXor:
+                VALIDATE(!value->kind().hasExtraBits(), ("At ", *value));
+                VALIDATE(value->numChildren() == 2, ("At ", *value));
+                VALIDATE(value->child(0)->type() == V128, ("At ", *value));
+                VALIDATE(value->child(1)->type() == V128, ("At ", *value));
+                VALIDATE(value->type() == V128, ("At ", *value));
                 break;
             case Load8Z:
             case Load8S:
@@ -497,6 +564,7 @@ public:
             case Return:
                 VALIDATE(!value->kind().hasExtraBits(), ("At ", *value));
                 VALIDATE(value->numChildren() <= 1, ("At ", *value));
+                VALIDATE(!value->numChildren() || value->child(0)->type() != V128, ("At ", *value));
                 VALIDATE(value->type() == Void, ("At ", *value));
                 VALIDATE(!valueOwner.get(value)->numSuccessors(), ("At ", *value));
                 break;
@@ -594,6 +594,20 @@ Effects Value::effects() const
     case EqualOrUnordered:
     case Select:
     case Depend:
+    case Const128:
+    case VectorSplat:
+    case VectorExtractLane:
+    case VectorReplaceLane:
+    case VectorAdd:
+    case VectorSub:
+    case VectorMul:
+    case VectorDiv:
+    case VectorSqrt:
+    case VectorNot:
+    case VectorAnd:
+    case VectorAndnot:
+    case VectorOr:
+    case VectorXor:
         break;
     case Div:
     case UDiv:
@@ -879,6 +893,7 @@ Type Value::typeFor(Kind kind, Value* firstChild, Value* secondChild)
         case Float:
             return Int32;
         case Void:
+        case V128:
             ASSERT_NOT_REACHED();
         }
         return Void;
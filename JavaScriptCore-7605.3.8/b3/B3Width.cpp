@@ -55,6 +55,9 @@ Type bestType(Bank bank, Width width)
         }
         RELEASE_ASSERT_NOT_REACHED();
         return Void;
+    case Width128:
+        RELEASE_ASSERT(bank == FP);
+        return V128;
     }
     RELEASE_ASSERT_NOT_REACHED();
     return Void;
@@ -79,6 +82,9 @@ void printInternal(PrintStream& out, JSC::B3::Width width)
     case JSC::B3::Width64:
         out.print("64");
         return;
+    case JSC::B3::Width128:
+        out.print("128");
+        return;
     }
 
     RELEASE_ASSERT_NOT_REACHED();
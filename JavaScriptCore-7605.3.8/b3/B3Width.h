@@ -41,7 +41,8 @@ enum Width : int8_t {
     Width8,
     Width16,
     Width32,
-    Width64
+    Width64,
+    Width128
 };
 
 inline Width pointerWidth()
@@ -70,6 +71,8 @@ inline Width widthForType(Type type)
     case Int64:
     case Double:
         return Width64;
+    case V128:
+        return Width128;
     }
     ASSERT_NOT_REACHED();
     return Width8;
@@ -113,8 +116,13 @@ inline Width widthForBytes(unsigned bytes)
     case 3:
     case 4:
         return Width32;
-    default:
+    case 5:
+    case 6:
+    case 7:
+    case 8:
         return Width64;
+    default:
+        return Width128;
     }
 }
 
@@ -128,6 +136,7 @@ inline uint64_t mask(Width width)
     case Width32:
         return 0x00000000ffffffffllu;
     case Width64:
+    case Width128:
         return 0xffffffffffffffffllu;
     }
     ASSERT_NOT_REACHED();
@@ -72,7 +72,7 @@ typedef Range<size_t> Interval;
 struct TmpData {
     void dump(PrintStream& out) const
     {
-        out.print("{interval = ", interval, ", spilled = ", pointerDump(spilled), ", assigned = ", assigned, ", isUnspillable = ", isUnspillable, ", possibleRegs = ", possibleRegs, ", didBuildPossibleRegs = ", didBuildPossibleRegs, "}");
+        out.print("{interval = ", interval, ", spilled = ", pointerDump(spilled), ", assigned = ", assigned, ", isUnspillable = ", isUnspillable, ", possibleRegs = ", possibleRegs, ", didBuildPossibleRegs = ", didBuildPossibleRegs, ", width = ", width, "}");
     }
     
     void validate()
@@ -87,6 +87,7 @@ struct TmpData {
     bool isUnspillable { false };
     bool didBuildPossibleRegs { false };
     unsigned spillIndex { 0 };
+    Width width { Width8 }; // The widest access to this tmp. Determines the spill slot size.
 };
 
 struct Clobber {
@@ -226,10 +227,12 @@ private:
                 // the next.
                 // https://bugs.webkit.org/show_bug.cgi?id=170850
                 inst.forEachTmp(
-                    [&] (Tmp& tmp, Arg::Role role, Bank, Width) {
+                    [&] (Tmp& tmp, Arg::Role role, Bank, Width width) {
                         if (tmp.isReg())
                             return;
-                        m_map[tmp].interval |= interval(indexOfEarly, Arg::timing(role));
+                        TmpData& entry = m_map[tmp];
+                        entry.interval |= interval(indexOfEarly, Arg::timing(role));
+                        entry.width = std::max(entry.width, width);
                     });
             }
 
@@ -511,7 +514,7 @@ private:
     {
         TmpData& entry = m_map[tmp];
         RELEASE_ASSERT(!entry.isUnspillable);
-        entry.spilled = m_code.addStackSlot(8, StackSlotKind::Spill);
+        entry.spilled = m_code.addStackSlot(entry.width == Width128 ? 16 : 8, StackSlotKind::Spill);
         entry.assigned = Reg();
         m_didSpill = true;
     }
@@ -548,6 +551,8 @@ private:
                         if (!spilled)
                             return;
                         Opcode move = bank == GP ? Move : MoveDouble;
+                        if (m_map[tmp].width == Width128)
+                            move = MoveVector;
                         tmp = addSpillTmpWithInterval(bank, interval(indexOfEarly, Arg::timing(role)));
                         if (role == Arg::Scratch)
                             return;
@@ -586,15 +591,21 @@ private:
                     break;
                 
                 m_active.removeFirst();
-                m_usedSpillSlots.clear(entry.spillIndex);
+                for (unsigned i = entry.spilled->byteSize() / 8; i--;)
+                    m_usedSpillSlots.clear(entry.spillIndex + i);
             }
             
+            // Spill slots are 8 bytes, except for vectors, which take two adjacent ones.
+            unsigned numSlots = entry.spilled->byteSize() / 8;
             entry.spillIndex = m_usedSpillSlots.findBit(0, false);
-            ptrdiff_t offset = -static_cast<ptrdiff_t>(m_code.frameSize()) - static_cast<ptrdiff_t>(entry.spillIndex) * 8 - 8;
+            while (numSlots > 1 && m_usedSpillSlots.get(entry.spillIndex + 1))
+                entry.spillIndex = m_usedSpillSlots.findBit(entry.spillIndex + 1, false);
+            ptrdiff_t offset = -static_cast<ptrdiff_t>(m_code.frameSize()) - static_cast<ptrdiff_t>(entry.spillIndex) * 8 - static_cast<ptrdiff_t>(entry.spilled->byteSize());
             if (verbose())
                 dataLog("  Assigning offset = ", offset, " to spill ", pointerDump(entry.spilled), " for ", tmp, "\n");
             entry.spilled->setOffsetFromFP(offset);
-            m_usedSpillSlots.set(entry.spillIndex);
+            for (unsigned i = numSlots; i--;)
+                m_usedSpillSlots.set(entry.spillIndex + i);
             m_active.append(tmp);
         }
     }
@@ -1737,6 +1737,7 @@ protected:
             switch (inst.kind.opcode) {
             case MoveFloat:
             case MoveDouble:
+            case MoveVector:
                 break;
             default:
                 return false;
@@ -1978,7 +1979,11 @@ private:
 
     static unsigned stackSlotMinimumWidth(Width width)
     {
-        return width <= Width32 ? 4 : 8;
+        if (width <= Width32)
+            return 4;
+        if (width <= Width64)
+            return 8;
+        return 16;
     }
 
     template<Bank bank, typename AllocatorType>
@@ -2039,6 +2044,7 @@ private:
                             case Move:
                             case MoveDouble:
                             case MoveFloat:
+                            case MoveVector:
                             case Move32: {
                                 unsigned argIndex = &arg - &inst.args[0];
                                 unsigned otherArgIndex = argIndex ^ 1;
@@ -2106,6 +2112,7 @@ private:
                         break;
                     case MoveDouble:
                     case MoveFloat:
+                    case MoveVector:
                         instBank = FP;
                         break;
                     default:
@@ -2156,6 +2163,10 @@ private:
                     case 8:
                         move = bank == GP ? Move : MoveDouble;
                         break;
+                    case 16:
+                        RELEASE_ASSERT(bank == FP);
+                        move = MoveVector;
+                        break;
                     default:
                         RELEASE_ASSERT_NOT_REACHED();
                         break;
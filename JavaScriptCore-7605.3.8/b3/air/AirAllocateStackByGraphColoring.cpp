@@ -116,6 +116,9 @@ void allocateStackByGraphColoring(Code& code)
         case MoveDouble:
             width = Width64;
             break;
+        case MoveVector:
+            width = Width128;
+            break;
         default:
             return false;
         }
@@ -888,6 +888,8 @@ public:
                 return B3::isRepresentableAs<int32_t>(value);
             case Width64:
                 return B3::isRepresentableAs<int64_t>(value);
+            case Width128:
+                return true;
             }
         case Unsigned:
             switch (width) {
@@ -899,6 +901,8 @@ public:
                 return B3::isRepresentableAs<uint32_t>(value);
             case Width64:
                 return B3::isRepresentableAs<uint64_t>(value);
+            case Width128:
+                return true;
             }
         }
         ASSERT_NOT_REACHED();
@@ -919,6 +923,8 @@ public:
                 return static_cast<int32_t>(value);
             case Width64:
                 return static_cast<int64_t>(value);
+            case Width128:
+                return value;
             }
         case Unsigned:
             switch (width) {
@@ -930,6 +936,8 @@ public:
                 return static_cast<uint32_t>(value);
             case Width64:
                 return static_cast<uint64_t>(value);
+            case Width128:
+                return value;
             }
         }
         ASSERT_NOT_REACHED();
@@ -1200,6 +1208,8 @@ public:
                 return isValidScaledUImm12<32>(offset);
             case Width64:
                 return isValidScaledUImm12<64>(offset);
+            case Width128:
+                return isValidScaledUImm12<128>(offset);
             }
         }
         return false;
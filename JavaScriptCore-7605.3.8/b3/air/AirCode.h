@@ -97,6 +97,18 @@ public:
     
     bool needsUsedRegisters() const;
 
+    // Set this if any Tmp may hold a 128-bit vector. Then anything that saves FP registers without
+    // knowing what they hold has to save all 128 bits.
+    void setUsesSIMD() { m_usesSIMD = true; }
+    bool usesSIMD() const { return m_usesSIMD; }
+
+    Width conservativeWidth(Bank bank) const
+    {
+        if (bank == FP && m_usesSIMD)
+            return Width128;
+        return B3::conservativeWidth(bank);
+    }
+
     JS_EXPORT_PRIVATE BasicBlock* addBlock(double frequency = 1);
 
     // Note that you can rely on stack slots always getting indices that are larger than the index
@@ -369,6 +381,7 @@ private:
     unsigned m_frameSize { 0 };
     unsigned m_callArgAreaSize { 0 };
     bool m_stackIsAllocated { false };
+    bool m_usesSIMD { false };
     RegisterAtOffsetList m_uncorrectedCalleeSaveRegisterAtOffsetList;
     RegisterSet m_calleeSaveRegisters;
     StackSlot* m_calleeSaveStackSlot { nullptr };
@@ -46,6 +46,9 @@ inline Opcode moveFor(Bank bank, Width width)
         return bank == GP ? Move32 : MoveFloat;
     case Width64:
         return bank == GP ? Move : MoveDouble;
+    case Width128:
+        RELEASE_ASSERT(bank == FP);
+        return MoveVector;
     default:
         RELEASE_ASSERT_NOT_REACHED();
         return Oops;
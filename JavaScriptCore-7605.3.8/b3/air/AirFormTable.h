@@ -36,12 +36,12 @@ static const uint8_t formRoleMask = 15;
 static const uint8_t formBankShift = 4;
 static const uint8_t formBankMask = 1;
 static const uint8_t formWidthShift = 5;
-static const uint8_t formWidthMask = 3;
-static const uint8_t formInvalidShift = 7;
+static const uint8_t formWidthMask = 7;
 
 #define ENCODE_INST_FORM(role, bank, width) (static_cast<uint8_t>(role) << formRoleShift | static_cast<uint8_t>(bank) << formBankShift | static_cast<uint8_t>(width) << formWidthShift)
 
-#define INVALID_INST_FORM (1 << formInvalidShift)
+// All of the bits are taken by valid forms, so we use a role that doesn't exist to mark invalid ones.
+#define INVALID_INST_FORM (formRoleMask << formRoleShift)
 
 JS_EXPORT_PRIVATE extern uint8_t g_formTable[];
 
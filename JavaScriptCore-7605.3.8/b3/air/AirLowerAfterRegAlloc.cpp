@@ -131,7 +131,7 @@ void lowerAfterRegAlloc(Code& code)
             if (!found) {
                 StackSlot*& slot = slots[bank][i];
                 if (!slot)
-                    slot = code.addStackSlot(bytes(conservativeWidth(bank)), StackSlotKind::Spill);
+                    slot = code.addStackSlot(bytes(code.conservativeWidth(bank)), StackSlotKind::Spill);
                 result[i] = Arg::stack(slots[bank][i]);
             }
         }
@@ -216,7 +216,7 @@ void lowerAfterRegAlloc(Code& code)
                     [&] (Reg reg) {
                         Tmp tmp(reg);
                         Arg arg(tmp);
-                        Width width = conservativeWidth(arg.bank());
+                        Width width = code.conservativeWidth(arg.bank());
                         StackSlot* stackSlot =
                             code.addStackSlot(bytes(width), StackSlotKind::Spill);
                         pairs.append(ShufflePair(arg, Arg::stack(stackSlot), width));
@@ -240,7 +240,7 @@ void lowerAfterRegAlloc(Code& code)
                     [&] (Reg reg) {
                         Tmp tmp(reg);
                         Arg arg(tmp);
-                        Width width = conservativeWidth(arg.bank());
+                        Width width = code.conservativeWidth(arg.bank());
                         StackSlot* stackSlot = stackSlots[stackSlotIndex++];
                         pairs.append(ShufflePair(Arg::stack(stackSlot), arg, width));
                     });
@@ -64,8 +64,8 @@ void TmpWidth::recompute(Code& code)
     auto assumeTheWorst = [&] (Tmp tmp) {
         Widths& widths = m_width.add(tmp, Widths()).iterator->value;
         Bank bank = Arg(tmp).bank();
-        widths.use = conservativeWidth(bank);
-        widths.def = conservativeWidth(bank);
+        widths.use = code.conservativeWidth(bank);
+        widths.def = code.conservativeWidth(bank);
     };
     
     // Assume the worst for registers.
@@ -125,7 +125,7 @@ void TmpWidth::recompute(Code& code)
                     if (Arg::isZDef(role))
                         widths.def = std::max(widths.def, width);
                     else if (Arg::isAnyDef(role))
-                        widths.def = conservativeWidth(bank);
+                        widths.def = code.conservativeWidth(bank);
                 });
         }
     }
@@ -237,7 +237,7 @@ def isArch(token)
 end
 
 def isWidth(token)
-    token =~ /\A((8)|(16)|(32)|(64)|(Ptr))\Z/
+    token =~ /\A((8)|(16)|(32)|(64)|(128)|(Ptr))\Z/
 end
 
 def isKeyword(token)
@@ -310,7 +310,7 @@ class Parser
 
     def consumeWidth
         result = token.string
-        parseError("Expected width (8, 16, 32, or 64)") unless isWidth(result)
+        parseError("Expected width (8, 16, 32, 64, or 128)") unless isWidth(result)
         advance
         result
     end
@@ -702,7 +702,7 @@ writeH("OpcodeUtils") {
     outp.puts "    uint8_t* formBase = g_formTable + kind.opcode * #{formTableWidth} + formOffset;"
     outp.puts "    for (size_t i = 0; i < numOperands; ++i) {"
     outp.puts "        uint8_t form = formBase[i];"
-    outp.puts "        ASSERT(!(form & (1 << formInvalidShift)));"
+    outp.puts "        ASSERT(form != INVALID_INST_FORM);"
     outp.puts "        func(args[i], decodeFormRole(form), decodeFormBank(form), decodeFormWidth(form));"
     outp.puts "    }"
     outp.puts "}"
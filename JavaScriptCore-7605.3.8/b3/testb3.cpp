@@ -36,6 +36,7 @@
 #include "B3Compilation.h"
 #include "B3Compile.h"
 #include "B3ComputeDivisionMagic.h"
+#include "B3Const128Value.h"
 #include "B3Const32Value.h"
 #include "B3ConstPtrValue.h"
 #include "B3Effects.h"
@@ -48,6 +49,7 @@
 #include "B3NativeTraits.h"
 #include "B3Procedure.h"
 #include "B3ReduceStrength.h"
+#include "B3SIMDValue.h"
 #include "B3SlotBaseValue.h"
 #include "B3StackSlot.h"
 #include "B3StackmapGenerationParams.h"
@@ -16211,6 +16213,121 @@ void testShuffleDoesntTrashCalleeSaves()
     fastFree(inputPtr);
 }
 
+void testVectorAddInt32x4()
+{
+    Procedure proc;
+    BasicBlock* root = proc.addBlock();
+    Value* left = root->appendNew<MemoryValue>(
+        proc, Load, V128, Origin(),
+        root->appendNew<ArgumentRegValue>(proc, Origin(), GPRInfo::argumentGPR0));
+    Value* right = root->appendNew<MemoryValue>(
+        proc, Load, V128, Origin(),
+        root->appendNew<ArgumentRegValue>(proc, Origin(), GPRInfo::argumentGPR1));
+    root->appendNew<MemoryValue>(
+        proc, Store, Origin(),
+        root->appendNew<SIMDValue>(proc, Origin(), VectorAdd, V128, SIMDLane::i32x4, left, right),
+        root->appendNew<ArgumentRegValue>(proc, Origin(), GPRInfo::argumentGPR2), 0);
+    root->appendNewControlValue(proc, Return, Origin());
+
+    int32_t a[4] = { 1, -2, std::numeric_limits<int32_t>::max(), 40 };
+    int32_t b[4] = { 10, 20, 1, -40 };
+    int32_t result[4];
+    compileAndRun<void>(proc, a, b, result);
+    for (unsigned i = 0; i < 4; ++i)
+        CHECK(result[i] == static_cast<int32_t>(static_cast<uint32_t>(a[i]) + static_cast<uint32_t>(b[i])));
+}
+
+void testVectorMulFloat64x2()
+{
+    Procedure proc;
+    BasicBlock* root = proc.addBlock();
+    Value* left = root->appendNew<MemoryValue>(
+        proc, Load, V128, Origin(),
+        root->appendNew<ArgumentRegValue>(proc, Origin(), GPRInfo::argumentGPR0));
+    Value* right = root->appendNew<MemoryValue>(
+        proc, Load, V128, Origin(),
+        root->appendNew<ArgumentRegValue>(proc, Origin(), GPRInfo::argumentGPR1));
+    root->appendNew<MemoryValue>(
+        proc, Store, Origin(),
+        root->appendNew<SIMDValue>(proc, Origin(), VectorMul, V128, SIMDLane::f64x2, left, right),
+        root->appendNew<ArgumentRegValue>(proc, Origin(), GPRInfo::argumentGPR2), 0);
+    root->appendNewControlValue(proc, Return, Origin());
+
+    double a[2] = { 1.5, -3 };
+    double b[2] = { 4, 0.25 };
+    double result[2];
+    compileAndRun<void>(proc, a, b, result);
+    CHECK(result[0] == 6);
+    CHECK(result[1] == -0.75);
+}
+
+void testVectorAndnot()
+{
+    Procedure proc;
+    BasicBlock* root = proc.addBlock();
+    Value* left = root->appendNew<MemoryValue>(
+        proc, Load, V128, Origin(),
+        root->appendNew<ArgumentRegValue>(proc, Origin(), GPRInfo::argumentGPR0));
+    Value* right = root->appendNew<MemoryValue>(
+        proc, Load, V128, Origin(),
+        root->appendNew<ArgumentRegValue>(proc, Origin(), GPRInfo::argumentGPR1));
+    root->appendNew<MemoryValue>(
+        proc, Store, Origin(),
+        root->appendNew<SIMDValue>(proc, Origin(), VectorAndnot, V128, SIMDLane::v128, left, right),
+        root->appendNew<ArgumentRegValue>(proc, Origin(), GPRInfo::argumentGPR2), 0);
+    root->appendNewControlValue(proc, Return, Origin());
+
+    uint64_t a[2] = { 0xff00ff00ff00ff00, 0x0123456789abcdef };
+    uint64_t b[2] = { 0xffffffff00000000, 0xffffffffffffffff };
+    uint64_t result[2];
+    compileAndRun<void>(proc, a, b, result);
+    CHECK(result[0] == (~a[0] & b[0]));
+    CHECK(result[1] == (~a[1] & b[1]));
+}
+
+void testVectorSplatExtractLane(int64_t value)
+{
+    Procedure proc;
+    BasicBlock* root = proc.addBlock();
+    Value* vector = root->appendNew<SIMDValue>(
+        proc, Origin(), VectorSplat, V128, SIMDLane::i64x2,
+        root->appendNew<ArgumentRegValue>(proc, Origin(), GPRInfo::argumentGPR0));
+    v128_t bits;
+    bits.u64x2[0] = 1;
+    bits.u64x2[1] = 2;
+    vector = root->appendNew<SIMDValue>(
+        proc, Origin(), VectorAdd, V128, SIMDLane::i64x2, vector,
+        root->appendNew<Const128Value>(proc, Origin(), bits));
+    root->appendNewControlValue(
+        proc, Return, Origin(),
+        root->appendNew<Value>(
+            proc, Sub, Origin(),
+            root->appendNew<SIMDValue>(proc, Origin(), VectorExtractLane, Int64, SIMDLane::i64x2, 1, vector),
+            root->appendNew<SIMDValue>(proc, Origin(), VectorExtractLane, Int64, SIMDLane::i64x2, 0, vector)));
+
+    CHECK(compileAndRun<int64_t>(proc, value) == 1);
+}
+
+void testVectorReplaceLaneFloat32x4(float value)
+{
+    Procedure proc;
+    BasicBlock* root = proc.addBlock();
+    Value* address = root->appendNew<ArgumentRegValue>(proc, Origin(), GPRInfo::argumentGPR0);
+    Value* vector = root->appendNew<MemoryValue>(proc, Load, V128, Origin(), address);
+    vector = root->appendNew<SIMDValue>(
+        proc, Origin(), VectorReplaceLane, V128, SIMDLane::f32x4, 2, vector,
+        root->appendNew<MemoryValue>(proc, Load, Float, Origin(), address, 16));
+    root->appendNew<MemoryValue>(proc, Store, Origin(), vector, address, 0);
+    root->appendNewControlValue(proc, Return, Origin());
+
+    float values[5] = { 1, 2, 3, 4, value };
+    compileAndRun<void>(proc, values);
+    CHECK(values[0] == 1);
+    CHECK(values[1] == 2);
+    CHECK(isIdentical(values[2], value));
+    CHECK(values[3] == 4);
+}
+
 // Make sure the compiler does not try to optimize anything out.
 NEVER_INLINE double zero()
 {
@@ -17783,6 +17900,18 @@ void run(const char* filter)
     
     RUN(testShuffleDoesntTrashCalleeSaves());
 
+#if CPU(X86_64)
+    if (MacroAssembler::supportsVectorOperations()) {
+        RUN(testVectorAddInt32x4());
+        RUN(testVectorMulFloat64x2());
+        RUN(testVectorAndnot());
+        RUN(testVectorSplatExtractLane(0));
+        RUN(testVectorSplatExtractLane(-1));
+        RUN(testVectorSplatExtractLane(std::numeric_limits<int64_t>::max()));
+        RUN_UNARY(testVectorReplaceLaneFloat32x4, floatingPointOperands<float>());
+    }
+#endif
+
     if (isX86()) {
         RUN(testBranchBitAndImmFusion(Identity, Int64, 1, Air::BranchTest32, Air::Arg::Tmp));
         RUN(testBranchBitAndImmFusion(Identity, Int64, 0xff, Air::BranchTest32, Air::Arg::Tmp));
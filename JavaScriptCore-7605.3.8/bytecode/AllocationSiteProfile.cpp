@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2018 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "AllocationSiteProfile.h"
+
+#include "JSCInlines.h"
+
+namespace JSC {
+
+void AllocationSiteProfile::didAllocate(VM& vm, JSObject* object)
+{
+    bool pretenured = m_shouldPretenure && vm.heap.tryPretenure(object);
+    if (LIKELY(m_allocationsUntilSample)) {
+        --m_allocationsUntilSample;
+        return;
+    }
+    noteAllocationSlow(vm, object, pretenured);
+}
+
+void AllocationSiteProfile::noteAllocationSlow(JSCell* cell)
+{
+    noteAllocationSlow(*cell->vm(), cell, false);
+}
+
+void AllocationSiteProfile::noteAllocationSlow(VM& vm, JSCell* cell, bool pretenured)
+{
+    m_allocationsUntilSample = Options::allocationSiteSamplingInterval();
+    if (!Options::usePretenuring() || m_numberOfUndos >= Options::maximumPretenuringUndos())
+        return;
+    vm.heap.addAllocationSiteSample(*this, cell, pretenured);
+}
+
+void AllocationSiteProfile::noteSurvival(bool survived, bool wasPretenured)
+{
+    // The decision changed since the sample was taken, so it tells us nothing about the current one.
+    if (wasPretenured != m_shouldPretenure)
+        return;
+
+    if (survived)
+        m_survivedSamples++;
+    else
+        m_diedSamples++;
+
+    unsigned window = std::max(Options::pretenuringSampleWindow(), 1u);
+    double survivalRate = Options::pretenuringSurvivalRate();
+    unsigned samples = m_survivedSamples + m_diedSamples;
+
+    if (m_shouldPretenure) {
+        // Every pretenured object that dies wastes old-generation memory until the next full
+        // collection, so undo the decision as soon as the deaths exceed what the rate allows.
+        if (m_diedSamples > (1 - survivalRate) * window) {
+            m_shouldPretenure = false;
+            m_numberOfUndos++;
+            m_survivedSamples = 0;
+            m_diedSamples = 0;
+            return;
+        }
+    } else if (samples >= window) {
+        if (m_survivedSamples >= survivalRate * samples)
+            m_shouldPretenure = true;
+    }
+
+    if (samples >= window) {
+        m_survivedSamples = 0;
+        m_diedSamples = 0;
+    }
+}
+
+} // namespace JSC
@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2018 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+namespace JSC {
+
+class Heap;
+class JSCell;
+class JSObject;
+class VM;
+
+// Tracks whether the objects allocated at one allocation site tend to survive their first
+// collection. Every so often an allocation is handed to the Heap as a sample; at the end of the
+// next collection the Heap tells us whether the sample was marked. Sites whose samples almost
+// always survive get pretenured: the optimizing JITs allocate their objects through
+// didAllocate(), which marks them so that eden collections never trace them. Pretenured samples
+// can only be judged by a full collection, and a site whose pretenured objects die goes back to
+// being allocated young.
+class AllocationSiteProfile {
+public:
+    bool shouldPretenure() const { return m_shouldPretenure; }
+    bool hasSample() const { return !!m_sample; }
+
+    void noteAllocation(JSCell* cell)
+    {
+        if (LIKELY(m_allocationsUntilSample)) {
+            --m_allocationsUntilSample;
+            return;
+        }
+        noteAllocationSlow(cell);
+    }
+
+    // For allocations made on behalf of a site that the optimizing JITs decided to pretenure.
+    void didAllocate(VM&, JSObject*);
+
+private:
+    friend class Heap;
+
+    JS_EXPORT_PRIVATE void noteAllocationSlow(JSCell*);
+    void noteAllocationSlow(VM&, JSCell*, bool pretenured);
+    void noteSurvival(bool survived, bool wasPretenured);
+
+    JSCell* m_sample { nullptr };
+    unsigned m_allocationsUntilSample { 0 };
+    uint8_t m_survivedSamples { 0 };
+    uint8_t m_diedSamples { 0 };
+    uint8_t m_numberOfUndos { 0 };
+    bool m_sampleIsPretenured { false };
+    bool m_shouldPretenure { false };
+};
+
+} // namespace JSC
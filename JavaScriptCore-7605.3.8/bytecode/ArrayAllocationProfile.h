@@ -25,6 +25,7 @@
 
 #pragma once
 
+#include "AllocationSiteProfile.h"
 #include "IndexingType.h"
 #include "JSArray.h"
 
@@ -52,8 +53,12 @@ public:
     JSArray* updateLastAllocation(JSArray* lastArray)
     {
         m_lastArray = lastArray;
+        if (lastArray)
+            m_allocationSiteProfile.noteAllocation(lastArray);
         return lastArray;
     }
+
+    AllocationSiteProfile& allocationSiteProfile() { return m_allocationSiteProfile; }
     
     JS_EXPORT_PRIVATE void updateProfile();
     
@@ -76,6 +81,7 @@ private:
     IndexingType m_currentIndexingType { ArrayWithUndecided };
     unsigned m_largestSeenVectorLength { 0 };
     JSArray* m_lastArray { nullptr };
+    AllocationSiteProfile m_allocationSiteProfile;
 };
 
 } // namespace JSC
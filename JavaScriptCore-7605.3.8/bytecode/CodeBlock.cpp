@@ -71,6 +71,7 @@
 #include "ObjectAllocationProfileInlines.h"
 #include "PCToCodeOriginMap.h"
 #include "PolymorphicAccess.h"
+#include "ProfileCache.h"
 #include "ProfilerDatabase.h"
 #include "ProgramCodeBlock.h"
 #include "ReduceWhitespace.h"
@@ -833,6 +834,9 @@ bool CodeBlock::finishCreation(VM& vm, ScriptExecutable* ownerExecutable, Unlink
 
     m_instructions = WTFMove(instructions);
 
+    if (ProfileCache* profileCache = vm.profileCache())
+        profileCache->seed(*this);
+
     // Set optimization thresholds only after m_instructions is initialized, since these
     // rely on the instruction count (and are in theory permitted to also inspect the
     // instruction stream to more accurate assess the cost of tier-up).
@@ -873,6 +877,11 @@ CodeBlock::~CodeBlock()
     dumpValueProfiles();
 #endif
 
+    for (auto& profile : m_objectAllocationProfiles)
+        vm.heap.removeAllocationSiteSample(profile.allocationSiteProfile());
+    for (auto& profile : m_arrayAllocationProfiles)
+        vm.heap.removeAllocationSiteSample(profile.allocationSiteProfile());
+
     // We may be destroyed before any CodeBlocks that refer to us are destroyed.
     // Consider that two CodeBlocks become unreachable at the same time. There
     // is no guarantee about the order in which the CodeBlocks are destroyed.
@@ -2362,7 +2371,7 @@ void CodeBlock::optimizeAfterWarmUp()
         dataLog(*this, ": Optimizing after warm-up.\n");
 #if ENABLE(DFG_JIT)
     m_jitExecuteCounter.setNewThreshold(
-        adjustedCounterValue(Options::thresholdForOptimizeAfterWarmUp()), this);
+        adjustedCounterValue(thresholdForProfileCacheTier(Options::thresholdForOptimizeAfterWarmUp(), JITCode::DFGJIT)), this);
 #endif
 }
 
@@ -3077,9 +3086,16 @@ int32_t CodeBlock::thresholdForJIT(int32_t threshold)
     return threshold;
 }
 
+int32_t CodeBlock::thresholdForProfileCacheTier(int32_t threshold, JITCode::JITType tier) const
+{
+    if (m_profileCacheTier < tier)
+        return threshold;
+    return static_cast<int32_t>(threshold * Options::profileCacheThresholdScale());
+}
+
 void CodeBlock::jitAfterWarmUp()
 {
-    m_llintExecuteCounter.setNewThreshold(thresholdForJIT(Options::thresholdForJITAfterWarmUp()), this);
+    m_llintExecuteCounter.setNewThreshold(thresholdForJIT(thresholdForProfileCacheTier(Options::thresholdForJITAfterWarmUp(), JITCode::BaselineJIT)), this);
 }
 
 void CodeBlock::jitSoon()
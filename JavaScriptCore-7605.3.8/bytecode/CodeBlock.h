@@ -620,6 +620,11 @@ public:
     void jitAfterWarmUp();
     void jitSoon();
 
+    // Lowers a warm-up threshold if the profile cache saw this code reach the given tier in an
+    // earlier run.
+    int32_t thresholdForProfileCacheTier(int32_t threshold, JITCode::JITType) const;
+    void setProfileCacheTier(JITCode::JITType tier) { m_profileCacheTier = tier; }
+
     const BaselineExecutionCounter& llintExecuteCounter() const
     {
         return m_llintExecuteCounter;
@@ -949,6 +954,7 @@ private:
     WriteBarrier<UnlinkedCodeBlock> m_unlinkedCode;
     int m_numParameters;
     int m_numberOfArgumentsToSkip { 0 };
+    JITCode::JITType m_profileCacheTier { JITCode::None };
     union {
         unsigned m_debuggerRequests;
         struct {
@@ -25,6 +25,7 @@
 
 #pragma once
 
+#include "AllocationSiteProfile.h"
 #include "VM.h"
 #include "JSGlobalObject.h"
 #include "ObjectPrototype.h"
@@ -60,6 +61,8 @@ public:
     }
     unsigned inlineCapacity() { return m_inlineCapacity; }
 
+    AllocationSiteProfile& allocationSiteProfile() { return m_allocationSiteProfile; }
+
     void clear()
     {
         m_allocator = Allocator();
@@ -79,6 +82,7 @@ private:
     Allocator m_allocator; // Precomputed to make things easier for generated code.
     WriteBarrier<Structure> m_structure;
     unsigned m_inlineCapacity;
+    AllocationSiteProfile m_allocationSiteProfile;
 };
 
 } // namespace JSC
@@ -410,6 +410,8 @@ protected:
 
 private:
     friend class BytecodeRewriter;
+    friend class CachedBytecodeEncoder;
+    friend class CachedBytecodeDecoder;
     void applyModification(BytecodeRewriter&, UnpackedInstructions&);
 
     void createRareDataIfNecessary()
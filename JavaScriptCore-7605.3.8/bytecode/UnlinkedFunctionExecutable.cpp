@@ -27,6 +27,7 @@
 #include "UnlinkedFunctionExecutable.h"
 
 #include "BytecodeGenerator.h"
+#include "CachedTypes.h"
 #include "ClassInfo.h"
 #include "CodeCache.h"
 #include "Debugger.h"
@@ -116,6 +117,15 @@ UnlinkedFunctionExecutable::UnlinkedFunctionExecutable(VM* vm, Structure* struct
     m_parentScopeTDZVariables.swap(parentScopeTDZVariables);
 }
 
+UnlinkedFunctionExecutable::UnlinkedFunctionExecutable(VM* vm, Structure* structure)
+    : Base(*vm, structure)
+{
+}
+
+UnlinkedFunctionExecutable::~UnlinkedFunctionExecutable()
+{
+}
+
 void UnlinkedFunctionExecutable::destroy(JSCell* cell)
 {
     static_cast<UnlinkedFunctionExecutable*>(cell)->~UnlinkedFunctionExecutable();
@@ -126,8 +136,45 @@ void UnlinkedFunctionExecutable::visitChildren(JSCell* cell, SlotVisitor& visito
     UnlinkedFunctionExecutable* thisObject = jsCast<UnlinkedFunctionExecutable*>(cell);
     ASSERT_GC_OBJECT_INHERITS(thisObject, info());
     Base::visitChildren(thisObject, visitor);
-    visitor.append(thisObject->m_unlinkedCodeBlockForCall);
-    visitor.append(thisObject->m_unlinkedCodeBlockForConstruct);
+    if (!thisObject->canJettisonCode()) {
+        visitor.append(thisObject->m_unlinkedCodeBlockForCall);
+        visitor.append(thisObject->m_unlinkedCodeBlockForConstruct);
+        return;
+    }
+
+    // Old code blocks survive only if something else, like a linked CodeBlock of a function that is
+    // still running or was recently called, keeps them alive. finalizeUnconditionally() does the aging.
+    if (thisObject->m_age.loadRelaxed() < Options::unlinkedCodeBlockMaxAge()) {
+        visitor.append(thisObject->m_unlinkedCodeBlockForCall);
+        visitor.append(thisObject->m_unlinkedCodeBlockForConstruct);
+    }
+    visitor.vm().unlinkedFunctionExecutablesWithFinalizers.add(thisObject);
+}
+
+bool UnlinkedFunctionExecutable::canJettisonCode() const
+{
+    if (!Options::useUnlinkedCodeBlockJettisoning())
+        return false;
+    if (!m_unlinkedCodeBlockForCall && !m_unlinkedCodeBlockForConstruct)
+        return false;
+    // A suspended generator or async function resumes at a bytecode offset in its existing code,
+    // so we never regenerate the body of one.
+    return !isGeneratorOrAsyncFunctionBodyParseMode(parseMode());
+}
+
+void UnlinkedFunctionExecutable::finalizeUnconditionally(VM& vm)
+{
+    unsigned age = m_age.loadRelaxed();
+    if (age >= Options::unlinkedCodeBlockMaxAge()) {
+        if (m_unlinkedCodeBlockForCall && !Heap::isMarked(m_unlinkedCodeBlockForCall.get()))
+            m_unlinkedCodeBlockForCall.clear();
+        if (m_unlinkedCodeBlockForConstruct && !Heap::isMarked(m_unlinkedCodeBlockForConstruct.get()))
+            m_unlinkedCodeBlockForConstruct.clear();
+    } else if (vm.heap.collectionScope() == CollectionScope::Full)
+        m_age.storeRelaxed(age + 1);
+
+    if (!m_unlinkedCodeBlockForCall && !m_unlinkedCodeBlockForConstruct)
+        vm.unlinkedFunctionExecutablesWithFinalizers.remove(this);
 }
 
 FunctionExecutable* UnlinkedFunctionExecutable::link(VM& vm, const SourceCode& passedParentSource, std::optional<int> overrideLineNumber, Intrinsic intrinsic)
@@ -195,6 +242,12 @@ UnlinkedFunctionCodeBlock* UnlinkedFunctionExecutable::unlinkedCodeBlockFor(
     VM& vm, const SourceCode& source, CodeSpecializationKind specializationKind, 
     DebuggerMode debuggerMode, ParserError& error, SourceParseMode parseMode)
 {
+    if (m_age.loadRelaxed()) {
+        // Revisit us, so that the GC marks our code blocks strongly again if it is running right now.
+        m_age.storeRelaxed(0);
+        vm.heap.writeBarrier(this);
+    }
+
     switch (specializationKind) {
     case CodeForCall:
         if (UnlinkedFunctionCodeBlock* codeBlock = m_unlinkedCodeBlockForCall.get())
@@ -206,6 +259,11 @@ UnlinkedFunctionCodeBlock* UnlinkedFunctionExecutable::unlinkedCodeBlockFor(
         break;
     }
 
+    if (UNLIKELY(m_cachedCodeBlocks)) {
+        if (UnlinkedFunctionCodeBlock* codeBlock = decodeCachedCodeBlockFor(vm, specializationKind, debuggerMode, parseMode))
+            return codeBlock;
+    }
+
     UnlinkedFunctionCodeBlock* result = generateUnlinkedFunctionCodeBlock(
         vm, this, source, specializationKind, debuggerMode, 
         isBuiltinFunction() ? UnlinkedBuiltinFunction : UnlinkedNormalFunction, 
@@ -225,6 +283,42 @@ UnlinkedFunctionCodeBlock* UnlinkedFunctionExecutable::unlinkedCodeBlockFor(
     return result;
 }
 
+void UnlinkedFunctionExecutable::clearCode()
+{
+    m_unlinkedCodeBlockForCall.clear();
+    m_unlinkedCodeBlockForConstruct.clear();
+    m_cachedCodeBlocks = nullptr;
+}
+
+UnlinkedFunctionCodeBlock* UnlinkedFunctionExecutable::decodeCachedCodeBlockFor(VM& vm, CodeSpecializationKind specializationKind, DebuggerMode debuggerMode, SourceParseMode parseMode)
+{
+    UnlinkedFunctionCodeBlock* codeBlock = decodeFunctionCodeBlock(vm, *m_cachedCodeBlocks, specializationKind);
+
+    // Whatever happens, we only get one shot at decoding each code block.
+    m_cachedCodeBlocks->offsetFor(specializationKind) = 0;
+    if (!m_cachedCodeBlocks->codeBlockForCallOffset && !m_cachedCodeBlocks->codeBlockForConstructOffset)
+        m_cachedCodeBlocks = nullptr;
+
+    if (!codeBlock)
+        return nullptr;
+
+    // The cached code block may have been generated with a different debugger state or for a
+    // different parse mode (e.g. a generator's body rather than its wrapper).
+    bool wantsDebuggingOpcodes = debuggerMode == DebuggerOn || Options::forceDebuggerBytecodeGeneration();
+    if (codeBlock->wasCompiledWithDebuggingOpcodes() != wantsDebuggingOpcodes || codeBlock->parseMode() != parseMode)
+        return nullptr;
+
+    switch (specializationKind) {
+    case CodeForCall:
+        m_unlinkedCodeBlockForCall.set(vm, this, codeBlock);
+        break;
+    case CodeForConstruct:
+        m_unlinkedCodeBlockForConstruct.set(vm, this, codeBlock);
+        break;
+    }
+    return codeBlock;
+}
+
 void UnlinkedFunctionExecutable::setInvalidTypeProfilingOffsets()
 {
     m_typeProfilingStartOffset = std::numeric_limits<unsigned>::max();
@@ -41,6 +41,7 @@ namespace JSC {
 
 class FunctionMetadataNode;
 class FunctionExecutable;
+struct CachedFunctionCodeBlocks;
 class ParserError;
 class SourceProvider;
 class UnlinkedFunctionCodeBlock;
@@ -54,10 +55,18 @@ class UnlinkedFunctionExecutable final : public JSCell {
 public:
     friend class CodeCache;
     friend class VM;
+    friend class CachedBytecodeEncoder;
+    friend class CachedBytecodeDecoder;
 
     typedef JSCell Base;
     static const unsigned StructureFlags = Base::StructureFlags | StructureIsImmortal;
 
+    template<typename CellType>
+    static IsoSubspace* subspaceFor(VM& vm)
+    {
+        return &vm.unlinkedFunctionExecutableSpace;
+    }
+
     static UnlinkedFunctionExecutable* create(VM* vm, const SourceCode& source, FunctionMetadataNode* node, UnlinkedFunctionKind unlinkedFunctionKind, ConstructAbility constructAbility, JSParserScriptMode scriptMode, VariableEnvironment& parentScopeTDZVariables, DerivedContextType derivedContextType, SourceCode&& parentSourceOverride = SourceCode())
     {
         UnlinkedFunctionExecutable* instance = new (NotNull, allocateCell<UnlinkedFunctionExecutable>(vm->heap))
@@ -105,10 +114,16 @@ public:
 
     JS_EXPORT_PRIVATE FunctionExecutable* link(VM&, const SourceCode& parentSource, std::optional<int> overrideLineNumber = std::nullopt, Intrinsic = NoIntrinsic);
 
-    void clearCode()
+    void clearCode();
+
+    void finalizeUnconditionally(VM&);
+
+    // Called by the GC, with the world stopped, for functions that it found running on the stack.
+    void didExecute() { m_age.storeRelaxed(0); }
+
+    UnlinkedFunctionCodeBlock* existingUnlinkedCodeBlockFor(CodeSpecializationKind kind) const
     {
-        m_unlinkedCodeBlockForCall.clear();
-        m_unlinkedCodeBlockForConstruct.clear();
+        return kind == CodeForCall ? m_unlinkedCodeBlockForCall.get() : m_unlinkedCodeBlockForConstruct.get();
     }
 
     void recordParse(CodeFeatures features, bool hasCapturedVariables)
@@ -140,6 +155,12 @@ public:
 
 private:
     UnlinkedFunctionExecutable(VM*, Structure*, const SourceCode&, SourceCode&& parentSourceOverride, FunctionMetadataNode*, UnlinkedFunctionKind, ConstructAbility, JSParserScriptMode, VariableEnvironment&,  JSC::DerivedContextType);
+    // Used by CachedBytecodeDecoder, which fills in every field itself.
+    UnlinkedFunctionExecutable(VM*, Structure*);
+    ~UnlinkedFunctionExecutable();
+
+    UnlinkedFunctionCodeBlock* decodeCachedCodeBlockFor(VM&, CodeSpecializationKind, DebuggerMode, SourceParseMode);
+    bool canJettisonCode() const;
 
     unsigned m_firstLineOffset;
     unsigned m_lineCount;
@@ -164,6 +185,11 @@ private:
     unsigned m_superBinding : 1;
     unsigned m_derivedContextType: 2;
 
+    // Number of full collections since our code blocks were last asked for or found running. Once this
+    // reaches Options::unlinkedCodeBlockMaxAge(), we only hold on to them weakly. The mutator resets it
+    // while concurrent marking may be reading it.
+    Atomic<unsigned> m_age { 0 };
+
     WriteBarrier<UnlinkedFunctionCodeBlock> m_unlinkedCodeBlockForCall;
     WriteBarrier<UnlinkedFunctionCodeBlock> m_unlinkedCodeBlockForConstruct;
 
@@ -178,6 +204,10 @@ private:
 
     VariableEnvironment m_parentScopeTDZVariables;
 
+    // Non-null if this executable was decoded from the bytecode cache and at least one of its
+    // code blocks has not been decoded yet.
+    std::unique_ptr<CachedFunctionCodeBlocks> m_cachedCodeBlocks;
+
 protected:
     static void visitChildren(JSCell*, SlotVisitor&);
 
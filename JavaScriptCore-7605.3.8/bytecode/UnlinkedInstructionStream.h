@@ -36,6 +36,11 @@ class UnlinkedInstructionStream {
     WTF_MAKE_FAST_ALLOCATED;
 public:
     explicit UnlinkedInstructionStream(const Vector<UnlinkedInstruction, 0, UnsafeVectorOverflow>&);
+    UnlinkedInstructionStream(RefCountedArray<unsigned char>&& data, unsigned instructionCount)
+        : m_data(WTFMove(data))
+        , m_instructionCount(instructionCount)
+    {
+    }
 
     unsigned count() const { return m_instructionCount; }
     size_t sizeInBytes() const;
@@ -62,6 +67,7 @@ public:
 
 private:
     friend class Reader;
+    friend class CachedBytecodeEncoder;
 
 #ifndef NDEBUG
     mutable RefCountedArray<UnlinkedInstruction> m_unpackedInstructionsForDebugging;
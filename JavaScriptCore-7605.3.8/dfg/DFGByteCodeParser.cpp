@@ -895,6 +895,13 @@ private:
     {
         return getArrayMode(profile, Array::Read);
     }
+
+    AllocationSiteProfile* pretenuringSiteFor(AllocationSiteProfile& site)
+    {
+        if (!Options::usePretenuring() || !site.shouldPretenure())
+            return nullptr;
+        return &site;
+    }
     
     Node* makeSafe(Node* node)
     {
@@ -4412,7 +4419,7 @@ void ByteCodeParser::parseBlock(unsigned limit)
                             m_graph.watchpoints().addLazily(rareData->allocationProfileWatchpointSet());
                             // The callee is still live up to this point.
                             addToGraph(Phantom, callee);
-                            set(VirtualRegister(bytecode.dst()), addToGraph(NewObject, OpInfo(m_graph.registerStructure(structure))));
+                            set(VirtualRegister(bytecode.dst()), addToGraph(NewObject, OpInfo(m_graph.registerStructure(structure)), OpInfo(pretenuringSiteFor(rareData->objectAllocationProfile()->allocationSiteProfile()))));
                             alreadyEmitted = true;
                         }
                     }
@@ -4426,9 +4433,11 @@ void ByteCodeParser::parseBlock(unsigned limit)
         }
 
         case op_new_object: {
+            ObjectAllocationProfile* profile = currentInstruction[3].u.objectAllocationProfile;
             set(VirtualRegister(currentInstruction[1].u.operand),
                 addToGraph(NewObject,
-                    OpInfo(m_graph.registerStructure(currentInstruction[3].u.objectAllocationProfile->structure()))));
+                    OpInfo(m_graph.registerStructure(profile->structure())),
+                    OpInfo(pretenuringSiteFor(profile->allocationSiteProfile()))));
             NEXT_OPCODE(op_new_object);
         }
             
@@ -4466,7 +4475,7 @@ void ByteCodeParser::parseBlock(unsigned limit)
         case op_new_array_with_size: {
             int lengthOperand = currentInstruction[2].u.operand;
             ArrayAllocationProfile* profile = currentInstruction[3].u.arrayAllocationProfile;
-            set(VirtualRegister(currentInstruction[1].u.operand), addToGraph(NewArrayWithSize, OpInfo(profile->selectIndexingType()), get(VirtualRegister(lengthOperand))));
+            set(VirtualRegister(currentInstruction[1].u.operand), addToGraph(NewArrayWithSize, OpInfo(profile->selectIndexingType()), OpInfo(pretenuringSiteFor(profile->allocationSiteProfile())), get(VirtualRegister(lengthOperand))));
             NEXT_OPCODE(op_new_array_with_size);
         }
             
@@ -150,7 +150,7 @@ void JITCode::optimizeAfterWarmUp(CodeBlock* codeBlock)
         dataLog(*codeBlock, ": FTL-optimizing after warm-up.\n");
     CodeBlock* baseline = codeBlock->baselineVersion();
     tierUpCounter.setNewThreshold(
-        baseline->adjustedCounterValue(Options::thresholdForFTLOptimizeAfterWarmUp()),
+        baseline->adjustedCounterValue(baseline->thresholdForProfileCacheTier(Options::thresholdForFTLOptimizeAfterWarmUp(), JITCode::FTLJIT)),
         baseline);
 }
 
@@ -43,6 +43,7 @@ JITFinalizer::JITFinalizer(Plan& plan, Ref<JITCode>&& jitCode, std::unique_ptr<L
     , m_linkBuffer(WTFMove(linkBuffer))
     , m_withArityCheck(withArityCheck)
 {
+    m_linkBuffer->setCodeBlockForPerfLog(m_plan.codeBlock);
 }
 
 JITFinalizer::~JITFinalizer()
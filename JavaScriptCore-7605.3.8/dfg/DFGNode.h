@@ -1788,6 +1788,24 @@ public:
         ASSERT(hasStructure());
         return m_opInfo.asRegisteredStructure();
     }
+
+    bool hasPretenuringSite()
+    {
+        switch (op()) {
+        case NewObject:
+        case NewArrayWithSize:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    // Non-null if the objects this node allocates should go straight into the old generation.
+    AllocationSiteProfile* pretenuringSite()
+    {
+        ASSERT(hasPretenuringSite());
+        return m_opInfo2.as<AllocationSiteProfile*>();
+    }
     
     bool hasStorageAccessData()
     {
@@ -1365,6 +1365,20 @@ char* JIT_OPERATION operationNewArrayWithSize(ExecState* exec, Structure* arrayS
     return bitwise_cast<char*>(result);
 }
 
+char* JIT_OPERATION operationNewArrayWithSizeAndAllocationSite(ExecState* exec, Structure* arrayStructure, int32_t size, AllocationSiteProfile* allocationSite)
+{
+    VM& vm = exec->vm();
+    NativeCallFrameTracer tracer(&vm, exec);
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    if (UNLIKELY(size < 0))
+        return bitwise_cast<char*>(throwException(exec, scope, createRangeError(exec, ASCIILiteral("Array size is not a small enough positive integer."))));
+
+    JSArray* result = JSArray::create(vm, arrayStructure, size);
+    allocationSite->didAllocate(vm, result);
+    return bitwise_cast<char*>(result);
+}
+
 char* JIT_OPERATION operationNewArrayWithSizeAndHint(ExecState* exec, Structure* arrayStructure, int32_t size, int32_t vectorLengthHint, Butterfly* butterfly)
 {
     VM& vm = exec->vm();
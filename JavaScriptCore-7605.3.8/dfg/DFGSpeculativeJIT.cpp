@@ -11399,7 +11399,8 @@ void SpeculativeJIT::compileStrCat(Node* node)
 void SpeculativeJIT::compileNewArrayWithSize(Node* node)
 {
     JSGlobalObject* globalObject = m_jit.graph().globalObjectFor(node->origin.semantic);
-    if (!globalObject->isHavingABadTime() && !hasAnyArrayStorage(node->indexingType())) {
+    AllocationSiteProfile* pretenuringSite = node->pretenuringSite();
+    if (!pretenuringSite && !globalObject->isHavingABadTime() && !hasAnyArrayStorage(node->indexingType())) {
         SpeculateStrictInt32Operand size(this, node->child1());
         GPRTemporary result(this);
 
@@ -11423,7 +11424,10 @@ void SpeculativeJIT::compileNewArrayWithSize(Node* node)
     bigLength.link(&m_jit);
     m_jit.move(TrustedImmPtr(m_jit.graph().registerStructure(globalObject->arrayStructureForIndexingTypeDuringAllocation(ArrayWithArrayStorage))), structureGPR);
     done.link(&m_jit);
-    callOperation(operationNewArrayWithSize, resultGPR, structureGPR, sizeGPR, nullptr);
+    if (pretenuringSite)
+        callOperation(operationNewArrayWithSizeAndAllocationSite, resultGPR, structureGPR, sizeGPR, pretenuringSite);
+    else
+        callOperation(operationNewArrayWithSize, resultGPR, structureGPR, sizeGPR, nullptr);
     m_jit.exceptionCheck();
     cellResult(resultGPR, node);
 }
@@ -11511,6 +11515,16 @@ void SpeculativeJIT::compileCreateThis(Node* node)
 
 void SpeculativeJIT::compileNewObject(Node* node)
 {
+    if (AllocationSiteProfile* pretenuringSite = node->pretenuringSite()) {
+        flushRegisters();
+        GPRFlushedCallResult result(this);
+        GPRReg resultGPR = result.gpr();
+        callOperation(operationNewObjectWithAllocationSite, resultGPR, node->structure(), pretenuringSite);
+        m_jit.exceptionCheck();
+        cellResult(resultGPR, node);
+        return;
+    }
+
     GPRTemporary result(this);
     GPRTemporary allocator(this);
     GPRTemporary scratch(this);
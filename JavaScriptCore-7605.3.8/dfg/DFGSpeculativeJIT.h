@@ -1059,6 +1059,11 @@ public:
         m_jit.setupArgumentsWithExecState(arg1, arg2, butterfly);
         return appendCallSetResult(operation, result);
     }
+    JITCompiler::Call callOperation(P_JITOperation_EStZAsp operation, GPRReg result, GPRReg arg1, GPRReg arg2, AllocationSiteProfile* allocationSite)
+    {
+        m_jit.setupArgumentsWithExecState(arg1, arg2, TrustedImmPtr(allocationSite));
+        return appendCallSetResult(operation, result);
+    }
     JITCompiler::Call callOperation(P_JITOperation_EStZB operation, GPRReg result, GPRReg arg1, GPRReg arg2, Butterfly* butterfly)
     {
         m_jit.setupArgumentsWithExecState(arg1, arg2, TrustedImmPtr(butterfly));
@@ -1114,6 +1119,11 @@ public:
         m_jit.setupArgumentsWithExecState(TrustedImmPtr(structure));
         return appendCallSetResult(operation, result);
     }
+    JITCompiler::Call callOperation(C_JITOperation_EStAsp operation, GPRReg result, RegisteredStructure structure, AllocationSiteProfile* allocationSite)
+    {
+        m_jit.setupArgumentsWithExecState(TrustedImmPtr(structure), TrustedImmPtr(allocationSite));
+        return appendCallSetResult(operation, result);
+    }
     JITCompiler::Call callOperation(C_JITOperation_EStCS operation, GPRReg result, RegisteredStructure structure, TrustedImmPtr pointer, size_t size)
     {
         m_jit.setupArgumentsWithExecState(TrustedImmPtr(structure), pointer, TrustedImmPtr(size));
@@ -320,8 +320,16 @@ private:
             
             switch (m_node->op()) {
             case NewObject:
-            case NewArray:
             case NewArrayWithSize:
+                // Pretenured objects are old from the start, so stores into them need barriers.
+                if (m_node->pretenuringSite()) {
+                    m_node->setEpoch(Epoch());
+                    break;
+                }
+                m_node->setEpoch(m_currentEpoch);
+                break;
+
+            case NewArray:
             case NewArrayBuffer:
             case NewTypedArray:
             case NewRegexp:
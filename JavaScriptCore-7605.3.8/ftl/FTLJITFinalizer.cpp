@@ -72,7 +72,8 @@ bool JITFinalizer::finalizeFunction()
 bool JITFinalizer::finalizeCommon()
 {
     bool dumpDisassembly = shouldDumpDisassembly() || Options::asyncDisassembly();
-    
+
+    b3CodeLinkBuffer->setCodeBlockForPerfLog(m_plan.codeBlock);
     jitCode->initializeB3Code(
         FINALIZE_CODE_IF(
             dumpDisassembly, *b3CodeLinkBuffer,
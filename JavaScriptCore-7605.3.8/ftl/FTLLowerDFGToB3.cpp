@@ -5085,6 +5085,13 @@ private:
     
     void compileNewObject()
     {
+        if (AllocationSiteProfile* pretenuringSite = m_node->pretenuringSite()) {
+            setJSValue(vmCall(
+                Int64, m_out.operation(operationNewObjectWithAllocationSite), m_callFrame,
+                weakStructure(m_node->structure()), m_out.constIntPtr(pretenuringSite)));
+            return;
+        }
+
         setJSValue(allocateObject(m_node->structure()));
         mutatorFence();
     }
@@ -5593,7 +5600,8 @@ private:
         RegisteredStructure structure = m_graph.registerStructure(globalObject->arrayStructureForIndexingTypeDuringAllocation(
             m_node->indexingType()));
         
-        if (!globalObject->isHavingABadTime() && !hasAnyArrayStorage(m_node->indexingType())) {
+        AllocationSiteProfile* pretenuringSite = m_node->pretenuringSite();
+        if (!pretenuringSite && !globalObject->isHavingABadTime() && !hasAnyArrayStorage(m_node->indexingType())) {
             IndexingType indexingType = m_node->indexingType();
             setJSValue(
                 allocateJSArray(
@@ -5606,6 +5614,10 @@ private:
             m_out.aboveOrEqual(publicLength, m_out.constInt32(MIN_ARRAY_STORAGE_CONSTRUCTION_LENGTH)),
             weakStructure(m_graph.registerStructure(globalObject->arrayStructureForIndexingTypeDuringAllocation(ArrayWithArrayStorage))),
             weakStructure(structure));
+        if (pretenuringSite) {
+            setJSValue(vmCall(Int64, m_out.operation(operationNewArrayWithSizeAndAllocationSite), m_callFrame, structureValue, publicLength, m_out.constIntPtr(pretenuringSite)));
+            return;
+        }
         setJSValue(vmCall(Int64, m_out.operation(operationNewArrayWithSize), m_callFrame, structureValue, publicLength, m_out.intPtrZero));
     }
 
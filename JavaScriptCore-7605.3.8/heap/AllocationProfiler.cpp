@@ -0,0 +1,252 @@
+/*
+ * Copyright (C) 2018 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "AllocationProfiler.h"
+
+#if ENABLE(SAMPLING_PROFILER)
+
+#include "CodeBlock.h"
+#include "JSCInlines.h"
+#include "SamplingProfiler.h"
+#include "StackVisitor.h"
+#include "VMEntryScope.h"
+#include <cmath>
+
+namespace JSC {
+
+AllocationProfiler::AllocationProfiler(VM& vm, unsigned sampleInterval)
+    : m_vm(vm)
+    , m_sampleInterval(std::max(sampleInterval, 1u))
+{
+    clearData();
+    auto locker = holdLock(m_lock);
+    m_largeBytesUntilSample = nextSampleInterval(locker);
+}
+
+AllocationProfiler::~AllocationProfiler()
+{
+}
+
+int32_t AllocationProfiler::nextSampleInterval(const AbstractLocker&)
+{
+    // 1 - get() is in (0, 1], so the logarithm is finite.
+    double interval = -std::log(1 - m_random.get()) * m_sampleInterval;
+    return static_cast<int32_t>(std::min(interval, static_cast<double>(std::numeric_limits<int32_t>::max())));
+}
+
+void AllocationProfiler::didAllocate(HeapCell* cell, size_t size, const char* subspaceName)
+{
+    auto locker = holdLock(m_lock);
+    recordSample(locker, cell, size, subspaceName);
+}
+
+void AllocationProfiler::didAllocateLargeCell(HeapCell* cell, size_t size, const char* subspaceName)
+{
+    auto locker = holdLock(m_lock);
+    m_largeBytesUntilSample -= size;
+    if (m_largeBytesUntilSample >= 0)
+        return;
+    m_largeBytesUntilSample = nextSampleInterval(locker);
+    recordSample(locker, cell, size, subspaceName);
+}
+
+void AllocationProfiler::recordSample(const AbstractLocker& locker, HeapCell* cell, size_t size, const char* subspaceName)
+{
+    // An allocation of this size gets sampled with a probability of 1 - e^(-size / interval), so this
+    // is how many allocated bytes the sample stands for.
+    double probability = -std::expm1(-static_cast<double>(size) / m_sampleInterval);
+    uint64_t bytes = static_cast<uint64_t>(size / probability);
+
+    m_liveSamples.append(Sample { cell, nodeForCurrentStack(locker), bytes, subspaceName, nullptr });
+}
+
+unsigned AllocationProfiler::nodeForCurrentStack(const AbstractLocker&)
+{
+    if (!m_vm.currentThreadIsHoldingAPILock() || !m_vm.entryScope || !m_vm.topCallFrame)
+        return rootNode;
+
+    struct Frame {
+        String functionName;
+        String url;
+        unsigned lineNumber;
+        unsigned columnNumber;
+    };
+
+    // We are in the middle of an allocation, so we only look at the stack and the executables. In
+    // particular, we cannot ask the callee for its name the way the SamplingProfiler does.
+    Vector<Frame, 16> frames;
+    StackVisitor::visit(m_vm.topCallFrame, &m_vm, [&] (StackVisitor& visitor) -> StackVisitor::Status {
+        if (frames.size() == maxStackDepth)
+            return StackVisitor::Done;
+
+        if (visitor->isWasmFrame()) {
+            frames.append(Frame { ASCIILiteral("(wasm)"), emptyString(), 0, 0 });
+            return StackVisitor::Continue;
+        }
+
+        unsigned lineNumber = 0;
+        unsigned columnNumber = 0;
+        SamplingProfiler::StackFrame stackFrame;
+        if (CodeBlock* codeBlock = visitor->codeBlock()) {
+            stackFrame = SamplingProfiler::StackFrame(codeBlock->ownerExecutable());
+            visitor->computeLineAndColumn(lineNumber, columnNumber);
+        } else if (visitor->callee().isCell()) {
+            if (JSFunction* function = jsDynamicCast<JSFunction*>(m_vm, visitor->callee().asCell()))
+                stackFrame = SamplingProfiler::StackFrame(function->executable());
+            else
+                stackFrame.frameType = SamplingProfiler::FrameType::Host;
+        }
+
+        String functionName = stackFrame.displayName(m_vm);
+        if (functionName.isEmpty())
+            functionName = ASCIILiteral("(anonymous function)");
+        frames.append(Frame { WTFMove(functionName), stackFrame.url(), lineNumber, columnNumber });
+        return StackVisitor::Continue;
+    });
+
+    unsigned node = rootNode;
+    for (unsigned i = frames.size(); i--;) {
+        Frame& frame = frames[i];
+        node = childNode(node, frame.functionName, frame.url, frame.lineNumber, frame.columnNumber);
+    }
+    return node;
+}
+
+unsigned AllocationProfiler::childNode(unsigned parent, const String& functionName, const String& url, unsigned lineNumber, unsigned columnNumber)
+{
+    for (unsigned child : m_nodes[parent].children) {
+        Node& node = m_nodes[child];
+        if (node.lineNumber == lineNumber && node.columnNumber == columnNumber && node.functionName == functionName && node.url == url)
+            return child;
+    }
+
+    unsigned child = m_nodes.size();
+    m_nodes.append(Node { parent, functionName, url, lineNumber, columnNumber, { }, { } });
+    m_nodes[parent].children.append(child);
+    return child;
+}
+
+void AllocationProfiler::resolveType(Sample& sample)
+{
+    // Cells get initialized before the next allocation, so by the time anybody asks, a sampled JSCell
+    // has its structure. Dead cells keep theirs until they get swept.
+    if (sample.cell->cellKind() == HeapCell::JSCell)
+        sample.typeName = static_cast<JSCell*>(sample.cell)->classInfo(m_vm)->className;
+    else
+        sample.typeName = sample.subspaceName;
+
+    m_nodes[sample.node].types.add(sample.typeName, TypeStatistics()).iterator->value.allocated.add(sample.bytes);
+}
+
+void AllocationProfiler::finalizeUnconditionally()
+{
+    auto locker = holdLock(m_lock);
+    m_liveSamples.removeAllMatching(
+        [&] (Sample& sample) -> bool {
+            if (!sample.typeName)
+                resolveType(sample);
+            return !Heap::isMarked(sample.cell);
+        });
+}
+
+void AllocationProfiler::clearData()
+{
+    auto locker = holdLock(m_lock);
+    m_liveSamples.clear();
+    m_nodes.clear();
+    m_nodes.append(Node { rootNode, ASCIILiteral("(root)"), emptyString(), 0, 0, { }, { } });
+}
+
+String AllocationProfiler::callTreeAsJSON()
+{
+    auto locker = holdLock(m_lock);
+
+    for (Node& node : m_nodes) {
+        for (auto& entry : node.types)
+            entry.value.live = Statistics();
+    }
+    for (Sample& sample : m_liveSamples) {
+        if (!sample.typeName)
+            resolveType(sample);
+        m_nodes[sample.node].types.find(sample.typeName)->value.live.add(sample.bytes);
+    }
+
+    StringBuilder json;
+    json.appendLiteral("{\"sampleInterval\":");
+    json.appendNumber(m_sampleInterval);
+    json.appendLiteral(",\"root\":");
+    appendNodeJSON(json, rootNode);
+    json.append('}');
+    return json.toString();
+}
+
+void AllocationProfiler::appendNodeJSON(StringBuilder& json, unsigned index)
+{
+    const Node& node = m_nodes[index];
+
+    json.appendLiteral("{\"functionName\":");
+    json.appendQuotedJSONString(node.functionName);
+    json.appendLiteral(",\"url\":");
+    json.appendQuotedJSONString(node.url);
+    json.appendLiteral(",\"lineNumber\":");
+    json.appendNumber(node.lineNumber);
+    json.appendLiteral(",\"columnNumber\":");
+    json.appendNumber(node.columnNumber);
+
+    // These only count the samples that this frame allocated itself.
+    json.appendLiteral(",\"types\":[");
+    bool first = true;
+    for (auto& entry : node.types) {
+        if (!first)
+            json.append(',');
+        first = false;
+        json.appendLiteral("{\"name\":");
+        json.appendQuotedJSONString(String(entry.key));
+        json.appendLiteral(",\"samples\":");
+        json.appendNumber(entry.value.allocated.samples);
+        json.appendLiteral(",\"bytes\":");
+        json.appendNumber(entry.value.allocated.bytes);
+        json.appendLiteral(",\"liveSamples\":");
+        json.appendNumber(entry.value.live.samples);
+        json.appendLiteral(",\"liveBytes\":");
+        json.appendNumber(entry.value.live.bytes);
+        json.append('}');
+    }
+
+    json.appendLiteral("],\"children\":[");
+    first = true;
+    for (unsigned child : node.children) {
+        if (!first)
+            json.append(',');
+        first = false;
+        appendNodeJSON(json, child);
+    }
+    json.appendLiteral("]}");
+}
+
+} // namespace JSC
+
+#endif // ENABLE(SAMPLING_PROFILER)
@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2018 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#if ENABLE(SAMPLING_PROFILER)
+
+#include "HeapCell.h"
+#include <wtf/HashMap.h>
+#include <wtf/Lock.h>
+#include <wtf/Vector.h>
+#include <wtf/WeakRandom.h>
+#include <wtf/text/StringBuilder.h>
+#include <wtf/text/WTFString.h>
+
+namespace JSC {
+
+class VM;
+
+// Samples allocations at random byte intervals, so that an allocation is sampled with a probability
+// proportional to its size, and attributes each sample to the JS stack that allocated it. Samples are
+// aggregated into a call tree whose nodes also know which of their samples are still live.
+//
+// Every LocalAllocator counts down the bytes until its next sample, both in its C++ fast path and in
+// the JIT's inline allocation sequences, and calls into the profiler once the count goes negative.
+class AllocationProfiler {
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    AllocationProfiler(VM&, unsigned sampleInterval);
+    ~AllocationProfiler();
+
+    // The number of bytes to allocate before taking the next sample, drawn from an exponential
+    // distribution around the sample interval.
+    int32_t nextSampleInterval()
+    {
+        auto locker = holdLock(m_lock);
+        return nextSampleInterval(locker);
+    }
+
+    void didAllocate(HeapCell*, size_t, const char* subspaceName);
+    void didAllocateLargeCell(HeapCell*, size_t, const char* subspaceName);
+
+    // Called after marking, before any cell gets swept.
+    void finalizeUnconditionally();
+
+    JS_EXPORT_PRIVATE String callTreeAsJSON();
+    JS_EXPORT_PRIVATE void clearData();
+
+private:
+    struct Statistics {
+        void add(uint64_t bytes)
+        {
+            samples++;
+            this->bytes += bytes;
+        }
+
+        uint64_t samples { 0 };
+        uint64_t bytes { 0 };
+    };
+
+    struct TypeStatistics {
+        Statistics allocated;
+        Statistics live;
+    };
+
+    struct Node {
+        unsigned parent;
+        String functionName;
+        String url;
+        unsigned lineNumber;
+        unsigned columnNumber;
+        Vector<unsigned> children;
+        // For the samples that were allocated by this frame itself, keyed by type name.
+        HashMap<const char*, TypeStatistics> types;
+    };
+
+    struct Sample {
+        HeapCell* cell;
+        unsigned node;
+        uint64_t bytes;
+        const char* subspaceName;
+        const char* typeName;
+    };
+
+    static const unsigned rootNode = 0;
+    static const unsigned maxStackDepth = 128;
+
+    int32_t nextSampleInterval(const AbstractLocker&);
+    void recordSample(const AbstractLocker&, HeapCell*, size_t, const char* subspaceName);
+    unsigned nodeForCurrentStack(const AbstractLocker&);
+    unsigned childNode(unsigned parent, const String& functionName, const String& url, unsigned lineNumber, unsigned columnNumber);
+    void resolveType(Sample&);
+    void appendNodeJSON(StringBuilder&, unsigned node);
+
+    VM& m_vm;
+    Lock m_lock;
+    WeakRandom m_random;
+    unsigned m_sampleInterval;
+    int64_t m_largeBytesUntilSample;
+    Vector<Node> m_nodes;
+    Vector<Sample> m_liveSamples;
+};
+
+} // namespace JSC
+
+#endif // ENABLE(SAMPLING_PROFILER)
@@ -233,6 +233,15 @@ void BlockDirectory::resumeAllocating()
         });
 }
 
+void BlockDirectory::resetAllocationSampling()
+{
+    auto locker = holdLock(m_localAllocatorsLock);
+    m_localAllocators.forEach(
+        [&] (LocalAllocator* allocator) {
+            allocator->resetAllocationSampling();
+        });
+}
+
 void BlockDirectory::beginMarkingForFullCollection()
 {
     // Mark bits are sticky and so is our summary of mark bits. We only clear these during full
@@ -300,6 +309,18 @@ void BlockDirectory::sweep()
         });
 }
 
+void BlockDirectory::appendBlocksToPresweep(Vector<MarkedBlock::Handle*>& blocks)
+{
+    if (needsDestruction())
+        return;
+    m_canAllocateButNotEmpty.forEachSetBit(
+        [&] (size_t index) {
+            MarkedBlock::Handle* block = m_blocks[index];
+            if (block->schedulePresweep())
+                blocks.append(block);
+        });
+}
+
 void BlockDirectory::shrink()
 {
     (m_empty & ~m_destructible).forEachSetBit(
@@ -88,11 +88,13 @@ public:
     void stopAllocating();
     void stopAllocatingForGood();
     void resumeAllocating();
+    void resetAllocationSampling();
     void beginMarkingForFullCollection();
     void endMarking();
     void snapshotUnsweptForEdenCollection();
     void snapshotUnsweptForFullCollection();
     void sweep();
+    void appendBlocksToPresweep(Vector<MarkedBlock::Handle*>&);
     void shrink();
     void assertNoUnswept();
     size_t cellSize() const { return m_cellSize; }
@@ -27,6 +27,7 @@
 #include "Subspace.h"
 
 #include "AlignedMemoryAllocator.h"
+#include "AllocationProfiler.h"
 #include "AllocatorInlines.h"
 #include "BlockDirectoryInlines.h"
 #include "JSCInlines.h"
@@ -146,6 +147,11 @@ void* CompleteSubspace::tryAllocateSlow(VM& vm, size_t size, GCDeferralContext*
     m_space.m_capacity += size;
     
     m_largeAllocations.append(allocation);
+
+#if ENABLE(SAMPLING_PROFILER)
+    if (AllocationProfiler* allocationProfiler = vm.allocationProfiler())
+        allocationProfiler->didAllocateLargeCell(allocation->cell(), size, name());
+#endif
         
     return allocation->cell();
 }
@@ -36,6 +36,11 @@ EdenGCActivityCallback::EdenGCActivityCallback(Heap* heap)
 {
 }
 
+EdenGCActivityCallback::~EdenGCActivityCallback()
+{
+    stop();
+}
+
 void EdenGCActivityCallback::doCollection()
 {
     m_vm->heap.collectAsync(CollectionScope::Eden);
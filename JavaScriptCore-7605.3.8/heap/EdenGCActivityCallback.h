@@ -32,6 +32,7 @@ namespace JSC {
 class JS_EXPORT_PRIVATE EdenGCActivityCallback : public GCActivityCallback {
 public:
     EdenGCActivityCallback(Heap*);
+    ~EdenGCActivityCallback();
 
     void doCollection() override;
 
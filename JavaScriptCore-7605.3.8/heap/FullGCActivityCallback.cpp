@@ -39,6 +39,11 @@ FullGCActivityCallback::FullGCActivityCallback(Heap* heap)
 {
 }
 
+FullGCActivityCallback::~FullGCActivityCallback()
+{
+    stop();
+}
+
 void FullGCActivityCallback::doCollection()
 {
     Heap& heap = m_vm->heap;
@@ -32,6 +32,7 @@ namespace JSC {
 class JS_EXPORT_PRIVATE FullGCActivityCallback : public GCActivityCallback {
 public:
     FullGCActivityCallback(Heap*);
+    ~FullGCActivityCallback();
 
     void doCollection() override;
 
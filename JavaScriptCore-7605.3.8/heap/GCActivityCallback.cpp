@@ -88,19 +88,18 @@ void GCActivityCallback::scheduleTimer(Seconds newDelay)
     Seconds delta = m_delay - newDelay;
     m_delay = newDelay;
 
-    Seconds secondsUntilFire = m_timer.secondsUntilFire();
-    m_timer.startOneShot(std::max<Seconds>(secondsUntilFire - delta, 0_s));
+    setSecondsUntilFire(std::max<Seconds>(secondsUntilFire() - delta, 0_s));
 }
 
 void GCActivityCallback::cancelTimer()
 {
     m_delay = s_decade;
-    m_timer.startOneShot(s_decade);
+    setSecondsUntilFire(s_decade);
 }
 
 MonotonicTime GCActivityCallback::nextFireTime()
 {
-    return MonotonicTime::now() + m_timer.secondsUntilFire();
+    return MonotonicTime::now() + secondsUntilFire();
 }
 #endif
 
@@ -0,0 +1,217 @@
+/*
+ * Copyright (C) 2018 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "GCTelemetry.h"
+
+#include "APICast.h"
+#include "VM.h"
+
+namespace JSC {
+
+JSGarbageCollectionStatistics GCTelemetry::Collection::statistics() const
+{
+    auto seconds = [&] (CollectorPhase phase) {
+        return phaseDurations[static_cast<unsigned>(phase)].seconds();
+    };
+
+    JSGarbageCollectionStatistics result;
+    result.isFullCollection = scope == CollectionScope::Full;
+    result.duration = duration.seconds();
+    result.beginPhaseDuration = seconds(CollectorPhase::Begin);
+    result.fixpointPhaseDuration = seconds(CollectorPhase::Fixpoint);
+    result.concurrentPhaseDuration = seconds(CollectorPhase::Concurrent);
+    result.reloopPhaseDuration = seconds(CollectorPhase::Reloop);
+    result.endPhaseDuration = seconds(CollectorPhase::End);
+    result.mutatorStoppedDuration = mutatorStoppedDuration.seconds();
+    result.maximumPauseDuration = maximumPauseDuration.seconds();
+    result.constraintSolvingDuration = constraintSolvingDuration.seconds();
+    result.bytesVisited = bytesVisited;
+    result.heapSizeBefore = heapSizeBefore;
+    result.heapSizeAfter = heapSizeAfter;
+    result.pauseTargetViolationCount = pauseTargetViolations;
+    result.mutatorUtilizationViolationCount = mutatorUtilizationViolations;
+    result.minimumMutatorUtilization = minimumMutatorUtilization;
+    return result;
+}
+
+void GCTelemetry::Histogram::add(Seconds duration)
+{
+    double microseconds = duration.microseconds();
+    unsigned bucket = 0;
+    for (double limit = 1; bucket < numberOfBuckets - 1 && microseconds >= limit; limit *= 2)
+        bucket++;
+    m_counts[bucket]++;
+}
+
+void GCTelemetry::willStartCollection(CollectionScope scope, size_t heapSize)
+{
+    m_currentCollection = Collection();
+    m_currentCollection.scope = scope;
+    m_currentCollection.heapSizeBefore = heapSize;
+}
+
+void GCTelemetry::didStopTheWorld()
+{
+    m_stopTime = MonotonicTime::now();
+    m_isWorldStopped = true;
+}
+
+void GCTelemetry::didResumeTheWorld()
+{
+    MonotonicTime now = MonotonicTime::now();
+    Seconds pause = now - m_stopTime;
+    m_currentCollection.mutatorStoppedDuration += pause;
+    m_currentCollection.maximumPauseDuration = std::max(m_currentCollection.maximumPauseDuration, pause);
+
+    auto locker = holdLock(m_lock);
+    m_pauses.add(pause);
+
+    m_isWorldStopped = false;
+    if (m_latencyTarget) {
+        m_recentPauses.append(Pause { m_stopTime, now });
+        while (m_recentPauses.first().end < now - m_latencyTarget->window)
+            m_recentPauses.removeFirst();
+
+        // The mutator's share of a window is the smallest for the windows that end with a pause.
+        if (pause > m_latencyTarget->maximumPause)
+            m_currentCollection.pauseTargetViolations++;
+        double utilization = 1 - stoppedDurationSince(now - m_latencyTarget->window) / m_latencyTarget->window;
+        if (utilization < m_latencyTarget->minimumMutatorUtilization)
+            m_currentCollection.mutatorUtilizationViolations++;
+        m_currentCollection.minimumMutatorUtilization = std::min(m_currentCollection.minimumMutatorUtilization, utilization);
+    }
+
+    if (!m_isFinishingCollection)
+        return;
+    m_isFinishingCollection = false;
+    if (m_currentCollection.scope == CollectionScope::Full)
+        m_fullCollections.add(m_currentCollection.duration);
+    else
+        m_edenCollections.add(m_currentCollection.duration);
+    m_lastCollection = m_currentCollection;
+    m_hasUnreportedCollection = true;
+}
+
+void GCTelemetry::didSolveConstraints(Seconds duration)
+{
+    m_currentCollection.constraintSolvingDuration += duration;
+}
+
+void GCTelemetry::didFinishCollection(size_t bytesVisited, size_t heapSize)
+{
+    m_currentCollection.bytesVisited = bytesVisited;
+    m_currentCollection.heapSizeAfter = heapSize;
+}
+
+void GCTelemetry::willChangePhase(CollectorPhase from, CollectorPhase to)
+{
+    MonotonicTime now = MonotonicTime::now();
+    if (from != CollectorPhase::NotRunning)
+        m_currentCollection.phaseDurations[static_cast<unsigned>(from)] += now - m_phaseStartTime;
+    m_phaseStartTime = now;
+
+    if (to != CollectorPhase::NotRunning)
+        return;
+
+    for (Seconds duration : m_currentCollection.phaseDurations)
+        m_currentCollection.duration += duration;
+    m_isFinishingCollection = true;
+}
+
+void GCTelemetry::runCallback(VM& vm)
+{
+    JSGarbageCollectionCallback callback;
+    void* userData;
+    std::optional<Collection> collection;
+    {
+        auto locker = holdLock(m_lock);
+        if (!m_callback || !m_hasUnreportedCollection)
+            return;
+        m_hasUnreportedCollection = false;
+        callback = m_callback;
+        userData = m_callbackUserData;
+        collection = m_lastCollection;
+    }
+
+    JSGarbageCollectionStatistics statistics = collection->statistics();
+    callback(toRef(&vm), &statistics, userData);
+}
+
+std::optional<GCTelemetry::Collection> GCTelemetry::lastCollection()
+{
+    auto locker = holdLock(m_lock);
+    return m_lastCollection;
+}
+
+GCTelemetry::Histogram GCTelemetry::histogram(JSGarbageCollectionHistogram kind, bool reset)
+{
+    auto locker = holdLock(m_lock);
+    Histogram* histogram = nullptr;
+    switch (kind) {
+    case kJSGarbageCollectionHistogramPauses:
+        histogram = &m_pauses;
+        break;
+    case kJSGarbageCollectionHistogramEdenCollections:
+        histogram = &m_edenCollections;
+        break;
+    case kJSGarbageCollectionHistogramFullCollections:
+        histogram = &m_fullCollections;
+        break;
+    }
+    RELEASE_ASSERT(histogram);
+    Histogram result = *histogram;
+    if (reset)
+        histogram->reset();
+    return result;
+}
+
+void GCTelemetry::setLatencyTarget(const std::optional<GCLatencyTarget>& latencyTarget)
+{
+    auto locker = holdLock(m_lock);
+    m_latencyTarget = latencyTarget;
+}
+
+Seconds GCTelemetry::stoppedDurationSince(MonotonicTime since)
+{
+    Seconds result;
+    for (const Pause& pause : m_recentPauses) {
+        if (pause.end > since)
+            result += pause.end - std::max(pause.start, since);
+    }
+    if (m_isWorldStopped)
+        result += MonotonicTime::now() - std::max(m_stopTime, since);
+    return result;
+}
+
+void GCTelemetry::setCallback(JSGarbageCollectionCallback callback, void* userData)
+{
+    auto locker = holdLock(m_lock);
+    m_callback = callback;
+    m_callbackUserData = userData;
+    m_hasUnreportedCollection = false;
+}
+
+} // namespace JSC
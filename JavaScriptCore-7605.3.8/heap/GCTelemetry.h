@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2018 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "CollectionScope.h"
+#include "CollectorPhase.h"
+#include "GCLatencyTarget.h"
+#include "JSGarbageCollectionTelemetryPrivate.h"
+#include <array>
+#include <wtf/Deque.h>
+#include <wtf/Lock.h>
+#include <wtf/MonotonicTime.h>
+#include <wtf/Optional.h>
+
+namespace JSC {
+
+class VM;
+
+// Records what the collector does in each collection, so that embedders can get at it without
+// parsing logGC output. Everything but the callback is updated by whichever thread has the conn.
+class GCTelemetry {
+    WTF_MAKE_NONCOPYABLE(GCTelemetry);
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    static constexpr unsigned numberOfPhases = static_cast<unsigned>(CollectorPhase::End) + 1;
+
+    struct Collection {
+        CollectionScope scope { CollectionScope::Eden };
+        Seconds duration;
+        std::array<Seconds, numberOfPhases> phaseDurations { };
+        Seconds mutatorStoppedDuration;
+        Seconds maximumPauseDuration;
+        Seconds constraintSolvingDuration;
+        size_t bytesVisited { 0 };
+        size_t heapSizeBefore { 0 };
+        size_t heapSizeAfter { 0 };
+        unsigned pauseTargetViolations { 0 };
+        unsigned mutatorUtilizationViolations { 0 };
+        double minimumMutatorUtilization { 1 };
+
+        JSGarbageCollectionStatistics statistics() const;
+    };
+
+    class Histogram {
+    public:
+        static constexpr unsigned numberOfBuckets = kJSGarbageCollectionHistogramBucketCount;
+
+        void add(Seconds);
+        size_t count(unsigned bucket) const { return m_counts[bucket]; }
+        void reset() { m_counts.fill(0); }
+
+    private:
+        std::array<size_t, numberOfBuckets> m_counts { };
+    };
+
+    GCTelemetry() = default;
+
+    void willStartCollection(CollectionScope, size_t heapSize);
+    void didStopTheWorld();
+    void didResumeTheWorld();
+    void didSolveConstraints(Seconds);
+    void didFinishCollection(size_t bytesVisited, size_t heapSize);
+    
+    // Called before the world gets stopped or resumed for the new phase. Going back to NotRunning
+    // always resumes the world, and that is when the collection gets reported, so that its last
+    // pause is included.
+    void willChangePhase(CollectorPhase from, CollectorPhase to);
+
+    // Runs the callback on the mutator, after the collector has handed the heap back.
+    void runCallback(VM&);
+
+    std::optional<Collection> lastCollection();
+    Histogram histogram(JSGarbageCollectionHistogram, bool reset);
+    void setCallback(JSGarbageCollectionCallback, void* userData);
+
+    // Pauses that go over the target are counted as violations in the collection they belong to.
+    void setLatencyTarget(const std::optional<GCLatencyTarget>&);
+
+    // How long the world has been stopped since the given time, including the current pause. Only
+    // pauses within the latency target's window are remembered.
+    Seconds stoppedDurationSince(MonotonicTime);
+
+private:
+    struct Pause {
+        MonotonicTime start;
+        MonotonicTime end;
+    };
+
+
+    Lock m_lock;
+    Collection m_currentCollection;
+    std::optional<Collection> m_lastCollection;
+    MonotonicTime m_phaseStartTime;
+    MonotonicTime m_stopTime;
+    bool m_isWorldStopped { false };
+    std::optional<GCLatencyTarget> m_latencyTarget;
+    Deque<Pause> m_recentPauses;
+    Histogram m_pauses;
+    Histogram m_edenCollections;
+    Histogram m_fullCollections;
+    JSGarbageCollectionCallback m_callback { nullptr };
+    void* m_callbackUserData { nullptr };
+    bool m_isFinishingCollection { false };
+    bool m_hasUnreportedCollection { false };
+};
+
+} // namespace JSC
@@ -21,6 +21,8 @@
 #include "config.h"
 #include "Heap.h"
 
+#include "AllocationProfiler.h"
+#include "AllocationSiteProfile.h"
 #include "BlockDirectoryInlines.h"
 #include "CodeBlock.h"
 #include "CodeBlockSetInlines.h"
@@ -54,6 +56,7 @@
 #include "JSWeakMap.h"
 #include "JSWeakSet.h"
 #include "JSWebAssemblyCodeBlock.h"
+#include "LatencyTargetedMutatorScheduler.h"
 #include "MachineStackMarker.h"
 #include "MarkStackMergingConstraint.h"
 #include "MarkedSpaceInlines.h"
@@ -317,15 +320,12 @@ Heap::Heap(VM* vm, HeapType heapType)
 {
     m_worldState.store(0);
     
-    if (Options::useConcurrentGC()) {
-        if (Options::useStochasticMutatorScheduler())
-            m_scheduler = std::make_unique<StochasticSpaceTimeMutatorScheduler>(*this);
-        else
-            m_scheduler = std::make_unique<SpaceTimeMutatorScheduler>(*this);
-    } else {
-        // We simulate turning off concurrent GC by making the scheduler say that the world
-        // should always be stopped when the collector is running.
-        m_scheduler = std::make_unique<SynchronousStopTheWorldMutatorScheduler>();
+    m_scheduler = createMutatorScheduler(std::nullopt);
+    if (Options::gcMaximumPauseMS() > 0) {
+        setLatencyTarget(GCLatencyTarget {
+            Seconds::fromMilliseconds(Options::gcMaximumPauseMS()),
+            Options::gcMinimumMutatorUtilization(),
+            Seconds::fromMilliseconds(Options::gcMutatorUtilizationWindowMS()) });
     }
     
     if (Options::verifyHeap())
@@ -513,6 +513,77 @@ bool Heap::overCriticalMemoryThreshold(MemoryThresholdCallType memoryThresholdCa
 #endif
 }
 
+void Heap::setHeapLimits(size_t softLimit, size_t hardLimit)
+{
+    m_softHeapLimit = softLimit;
+    m_hardHeapLimit = hardLimit;
+}
+
+void Heap::setLatencyTarget(std::optional<GCLatencyTarget> latencyTarget)
+{
+    if (latencyTarget) {
+        // The collector could never finish if the mutator had all of the time.
+        double& utilization = latencyTarget->minimumMutatorUtilization;
+        if (!(utilization >= 0))
+            utilization = 0;
+        if (!(utilization <= 0.95))
+            utilization = 0.95;
+        if (!(latencyTarget->window >= latencyTarget->maximumPause))
+            latencyTarget->window = latencyTarget->maximumPause;
+    }
+    
+    // The collector may be using the current scheduler right now.
+    std::unique_ptr<MutatorScheduler> scheduler = createMutatorScheduler(latencyTarget);
+    {
+        auto locker = holdLock(m_pendingSchedulerLock);
+        m_pendingScheduler = WTFMove(scheduler);
+    }
+    m_telemetry.setLatencyTarget(latencyTarget);
+}
+
+std::unique_ptr<MutatorScheduler> Heap::createMutatorScheduler(const std::optional<GCLatencyTarget>& latencyTarget)
+{
+    if (!Options::useConcurrentGC()) {
+        // We simulate turning off concurrent GC by making the scheduler say that the world
+        // should always be stopped when the collector is running.
+        return std::make_unique<SynchronousStopTheWorldMutatorScheduler>();
+    }
+    if (latencyTarget)
+        return std::make_unique<LatencyTargetedMutatorScheduler>(*this, *latencyTarget);
+    if (Options::useStochasticMutatorScheduler())
+        return std::make_unique<StochasticSpaceTimeMutatorScheduler>(*this);
+    return std::make_unique<SpaceTimeMutatorScheduler>(*this);
+}
+
+void Heap::setHardHeapLimitCallback(Function<bool(ExecState*)>&& callback)
+{
+    m_hardHeapLimitCallback = WTFMove(callback);
+}
+
+auto Heap::checkHardHeapLimit(ExecState* exec) -> HardHeapLimitAction
+{
+    auto isOverHardHeapLimit = [&] {
+        return m_hardHeapLimit && m_sizeAfterLastCollect > m_hardHeapLimit;
+    };
+    
+    if (!isOverHardHeapLimit())
+        return HardHeapLimitAction::Continue;
+    
+    if (m_hardHeapLimitCallback) {
+        // The callback is allowed to replace itself.
+        Function<bool(ExecState*)> callback = WTFMove(m_hardHeapLimitCallback);
+        bool shouldTerminate = callback(exec);
+        if (!m_hardHeapLimitCallback)
+            m_hardHeapLimitCallback = WTFMove(callback);
+        if (shouldTerminate)
+            return HardHeapLimitAction::Terminate;
+        if (!isOverHardHeapLimit())
+            return HardHeapLimitAction::Continue;
+    }
+    
+    return HardHeapLimitAction::ThrowOutOfMemoryError;
+}
+
 void Heap::reportAbandonedObjectGraph()
 {
     // Our clients don't know exactly how much memory they
@@ -578,8 +649,20 @@ void Heap::finalizeUnconditionalFinalizers()
             this->finalizeMarkedUnconditionalFinalizers<CodeBlock>(space.finalizerSet);
         });
     finalizeMarkedUnconditionalFinalizers<ExecutableToCodeBlockEdge>(vm()->executableToCodeBlockEdgesWithFinalizers);
+    // Functions that are running keep their bytecode young, even if they were linked long ago.
+    m_codeBlocks->iterateCurrentlyExecuting(
+        [&] (CodeBlock* codeBlock) {
+            if (FunctionExecutable* executable = jsDynamicCast<FunctionExecutable*>(*vm(), codeBlock->ownerExecutable()))
+                executable->unlinkedExecutable()->didExecute();
+        });
+    finalizeMarkedUnconditionalFinalizers<UnlinkedFunctionExecutable>(vm()->unlinkedFunctionExecutablesWithFinalizers);
     finalizeMarkedUnconditionalFinalizers<JSWeakSet>(vm()->weakSetSpace);
     finalizeMarkedUnconditionalFinalizers<JSWeakMap>(vm()->weakMapSpace);
+
+#if ENABLE(SAMPLING_PROFILER)
+    if (AllocationProfiler* allocationProfiler = vm()->allocationProfiler())
+        allocationProfiler->finalizeUnconditionally();
+#endif
     
     while (m_unconditionalFinalizers.hasNext()) {
         UnconditionalFinalizer* finalizer = m_unconditionalFinalizers.removeNext();
@@ -758,6 +841,12 @@ void Heap::updateObjectCounts()
     m_totalBytesVisitedThisCycle = bytesVisited();
     
     m_totalBytesVisited += m_totalBytesVisitedThisCycle;
+
+    // Pretenured objects were never visited, but they are as much a part of the old generation as
+    // what we just marked. A full collection has visited the ones that are still alive.
+    if (m_collectionScope == CollectionScope::Eden)
+        m_totalBytesVisited += m_bytesPretenuredThisCycle;
+    m_bytesPretenuredThisCycle = 0;
 }
 
 void Heap::endMarking()
@@ -1010,6 +1099,20 @@ void Heap::sweepSynchronously()
     }
 }
 
+size_t Heap::releaseFragmentedMemory()
+{
+    size_t capacityBefore = m_objectSpace.capacity();
+    collectNow(Sync, CollectionScope::Full);
+    
+    DeferGCForAWhile deferGC(*this);
+    size_t capacityAfter = m_objectSpace.capacity();
+    size_t releasedPageBytes = m_objectSpace.releaseFreePagesInSparseBlocks();
+    size_t result = releasedPageBytes + (capacityBefore > capacityAfter ? capacityBefore - capacityAfter : 0);
+    if (Options::logGC())
+        dataLog("[GC<", RawPointer(this), ">: released ", result / 1024, "kb, ", releasedPageBytes / 1024, "kb of it from sparse blocks]\n");
+    return result;
+}
+
 void Heap::collect(Synchronousness synchronousness, GCRequest request)
 {
     switch (synchronousness) {
@@ -1274,6 +1377,11 @@ NEVER_INLINE bool Heap::runBeginPhase(GCConductor conn)
 
     m_constraintSet->didStartMarking();
     
+    {
+        auto locker = holdLock(m_pendingSchedulerLock);
+        if (m_pendingScheduler)
+            m_scheduler = WTFMove(m_pendingScheduler);
+    }
     m_scheduler->beginCollection();
     if (Options::logGC())
         m_scheduler->log();
@@ -1335,7 +1443,9 @@ NEVER_INLINE bool Heap::runFixpointPhase(GCConductor conn)
             
         // Wondering what this does? Look at Heap::addCoreConstraints(). The DOM and others can also
         // add their own using Heap::addMarkingConstraint().
+        MonotonicTime beforeConstraints = MonotonicTime::now();
         bool converged = m_constraintSet->executeConvergence(slotVisitor);
+        m_telemetry.didSolveConstraints(MonotonicTime::now() - beforeConstraints);
         
         // FIXME: The slotVisitor.isEmpty() check is most likely not needed.
         // https://bugs.webkit.org/show_bug.cgi?id=180310
@@ -1461,6 +1571,7 @@ NEVER_INLINE bool Heap::runEndPhase(GCConductor conn)
     sweepArrayBuffers();
     snapshotUnswept();
     finalizeUnconditionalFinalizers();
+    updateAllocationSiteProfiles();
     removeDeadCompilerWorklistEntries();
     notifyIncrementalSweeper();
     
@@ -1532,6 +1643,7 @@ NEVER_INLINE bool Heap::finishChangingPhase(GCConductor conn)
         dataLog(conn, ": Going to phase: ", m_nextPhase, " (from ", m_currentPhase, ")\n");
     
     m_phaseVersion++;
+    m_telemetry.willChangePhase(m_currentPhase, m_nextPhase);
     
     bool suspendedBefore = worldShouldBeSuspended(m_currentPhase);
     bool suspendedAfter = worldShouldBeSuspended(m_nextPhase);
@@ -1605,6 +1717,7 @@ void Heap::stopThePeriphery(GCConductor conn)
     m_objectSpace.stopAllocating();
     
     m_stopTime = MonotonicTime::now();
+    m_telemetry.didStopTheWorld();
 }
 
 NEVER_INLINE void Heap::resumeThePeriphery()
@@ -1623,6 +1736,7 @@ NEVER_INLINE void Heap::resumeThePeriphery()
         RELEASE_ASSERT_NOT_REACHED();
     }
     m_worldIsStopped = false;
+    m_telemetry.didResumeTheWorld();
     
     // FIXME: This could be vastly improved: we want to grab the locks in the order in which they
     // become available. We basically want a lockAny() method that will lock whatever lock is available
@@ -2040,6 +2154,12 @@ void Heap::finalize()
     for (const HeapFinalizerCallback& callback : m_heapFinalizerCallbacks)
         callback.run(*vm());
     
+    m_telemetry.runCallback(*vm());
+    
+    // Only a full collection tells us how much of the heap is really live.
+    if (m_hardHeapLimit && m_lastCollectionScope == CollectionScope::Full && m_sizeAfterLastCollect > m_hardHeapLimit)
+        vm()->notifyNeedHeapLimitCheck();
+    
     if (Options::sweepSynchronously())
         sweepSynchronously();
 
@@ -2132,6 +2252,7 @@ void Heap::willStartCollection()
         ASSERT(m_collectionScope == CollectionScope::Eden);
         m_sizeBeforeLastEdenCollect = m_sizeAfterLastCollect + m_bytesAllocatedThisCycle;
     }
+    m_telemetry.willStartCollection(*m_collectionScope, m_sizeAfterLastCollect + m_bytesAllocatedThisCycle);
 
     if (m_edenActivityCallback)
         m_edenActivityCallback->willCollect();
@@ -2270,6 +2391,29 @@ void Heap::updateAllocationLimits()
     overCriticalMemoryThreshold(MemoryThresholdCallType::Direct);
 #endif
 
+    if (size_t heapLimit = m_softHeapLimit ? m_softHeapLimit : m_hardHeapLimit) {
+        // Collect before going past the limit, but once we are past it, leave enough room to do
+        // something other than collecting.
+        static const size_t minimumEdenSizeNearHeapLimit = 1 * MB;
+        size_t edenSizeUntilHeapLimit = heapLimit > currentHeapSize ? heapLimit - currentHeapSize : 0;
+        if (m_maxEdenSize > edenSizeUntilHeapLimit) {
+            m_maxEdenSize = std::max(edenSizeUntilHeapLimit, minimumEdenSizeNearHeapLimit);
+            m_maxHeapSize = currentHeapSize + m_maxEdenSize;
+            if (verbose)
+                dataLog("Near heap limit: maxEdenSize = ", m_maxEdenSize, "\n");
+        }
+        if (currentHeapSize > heapLimit)
+            m_shouldDoFullCollection = true;
+    }
+
+    // Start the next collection early enough that what the mutator allocates while it runs stays
+    // within the eden we just planned for. This leaves m_maxHeapSize alone, so it does not compound.
+    if (size_t bytesAllocatedDuringCollection = m_scheduler->expectedBytesAllocatedDuringCollection()) {
+        m_maxEdenSize -= std::min(bytesAllocatedDuringCollection, m_maxEdenSize / 2);
+        if (verbose)
+            dataLog("Collection head start: maxEdenSize = ", m_maxEdenSize, "\n");
+    }
+
     m_sizeAfterLastCollect = currentHeapSize;
     if (verbose)
         dataLog("sizeAfterLastCollect = ", m_sizeAfterLastCollect, "\n");
@@ -2303,6 +2447,7 @@ void Heap::didFinishCollection()
     RELEASE_ASSERT(m_collectionScope);
     m_lastCollectionScope = m_collectionScope;
     m_collectionScope = std::nullopt;
+    m_telemetry.didFinishCollection(m_totalBytesVisitedThisCycle, m_sizeAfterLastCollect);
 
     for (auto* observer : m_observers)
         observer->didGarbageCollect(scope);
@@ -2376,6 +2521,80 @@ void Heap::addExecutable(ExecutableBase* executable)
     m_executables.append(executable);
 }
 
+static bool marksAreCurrent(HeapVersion markingVersion, HeapCell* cell)
+{
+    if (cell->isLargeAllocation())
+        return true;
+    return !cell->markedBlock().areMarksStale(markingVersion);
+}
+
+bool Heap::tryPretenure(JSObject* object)
+{
+    // Outside of a collection, setting a mark bit is only safe in blocks whose marks are already
+    // current: bringing stale marks up to date is something only the collector gets to do.
+    if (m_collectionScope || !Options::useGenerationalGC())
+        return false;
+
+    HeapVersion markingVersion = m_objectSpace.markingVersion();
+    if (!marksAreCurrent(markingVersion, object))
+        return false;
+
+    HeapCell* base = nullptr;
+    if (Butterfly* butterfly = object->butterfly()) {
+        Structure* structure = object->structure(*vm());
+        size_t preCapacity = 0;
+        if (structure->hasIndexingHeader(object))
+            preCapacity = butterfly->indexingHeader()->preCapacity(structure);
+        base = bitwise_cast<HeapCell*>(butterfly->base(preCapacity, structure->outOfLineCapacity()));
+        if (!marksAreCurrent(markingVersion, base))
+            return false;
+    }
+
+    if (base && !testAndSetMarked(markingVersion, base))
+        m_bytesPretenuredThisCycle += cellSize(base);
+    if (!testAndSetMarked(markingVersion, object))
+        m_bytesPretenuredThisCycle += cellSize(object);
+
+    // The object is now black as far as the next eden collection is concerned, so any store that
+    // could make it point at a young object has to put it in the remembered set.
+    object->setCellState(CellState::PossiblyBlack);
+    return true;
+}
+
+void Heap::addAllocationSiteSample(AllocationSiteProfile& profile, JSCell* cell, bool pretenured)
+{
+    auto locker = holdLock(m_allocationSiteSamplesLock);
+    if (m_collectionScope || profile.hasSample())
+        return;
+    profile.m_sample = cell;
+    profile.m_sampleIsPretenured = pretenured;
+    m_allocationSitesWithSamples.add(&profile);
+}
+
+void Heap::removeAllocationSiteSample(AllocationSiteProfile& profile)
+{
+    if (!profile.hasSample())
+        return;
+    auto locker = holdLock(m_allocationSiteSamplesLock);
+    m_allocationSitesWithSamples.remove(&profile);
+    profile.m_sample = nullptr;
+}
+
+void Heap::updateAllocationSiteProfiles()
+{
+    auto locker = holdLock(m_allocationSiteSamplesLock);
+    m_allocationSitesWithSamples.removeIf(
+        [&] (AllocationSiteProfile* profile) -> bool {
+            // A pretenured object is marked from birth, so only a full collection can tell whether
+            // it is still alive.
+            if (profile->m_sampleIsPretenured && m_collectionScope != CollectionScope::Full)
+                return false;
+            profile->noteSurvival(isMarked(profile->m_sample), profile->m_sampleIsPretenured);
+            profile->m_sample = nullptr;
+            return true;
+        });
+}
+
 void Heap::collectNowFullIfNotDoneRecently(Synchronousness synchronousness)
 {
     if (!m_fullActivityCallback) {
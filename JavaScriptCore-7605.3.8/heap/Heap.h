@@ -29,6 +29,7 @@
 #include "GCConductor.h"
 #include "GCIncomingRefCountedSet.h"
 #include "GCRequest.h"
+#include "GCTelemetry.h"
 #include "HandleSet.h"
 #include "HeapFinalizerCallback.h"
 #include "HeapObserver.h"
@@ -45,6 +46,7 @@
 #include <wtf/AutomaticThread.h>
 #include <wtf/ConcurrentPtrHashSet.h>
 #include <wtf/Deque.h>
+#include <wtf/Function.h>
 #include <wtf/HashCountedSet.h>
 #include <wtf/HashSet.h>
 #include <wtf/ParallelHelperPool.h>
@@ -52,12 +54,14 @@
 
 namespace JSC {
 
+class AllocationSiteProfile;
 class CodeBlock;
 class CodeBlockSet;
 class CollectingScope;
 class ConservativeRoots;
 class GCDeferralContext;
 class EdenGCActivityCallback;
+class ExecState;
 class ExecutableBase;
 class FullGCActivityCallback;
 class GCActivityCallback;
@@ -69,6 +73,7 @@ class IncrementalSweeper;
 class JITStubRoutine;
 class JITStubRoutineSet;
 class JSCell;
+class JSObject;
 class JSValue;
 class LLIntOffsetsExtractor;
 class MachineThreads;
@@ -166,6 +171,16 @@ public:
     JS_EXPORT_PRIVATE void addFinalizer(JSCell*, Finalizer);
     void addExecutable(ExecutableBase*);
 
+    // Moves an object that was just allocated, along with its butterfly, into the old generation:
+    // eden collections neither trace nor free it, and stores into it take the write barrier slow
+    // path. Returns false if a collection is in progress, in which case the object stays young.
+    bool tryPretenure(JSObject*);
+
+    // The Heap holds on to at most one sampled allocation per site, and tells the site whether
+    // it was marked at the end of the next collection that can tell.
+    void addAllocationSiteSample(AllocationSiteProfile&, JSCell*, bool pretenured);
+    void removeAllocationSiteSample(AllocationSiteProfile&);
+
     void notifyIsSafeToCollect();
     bool isSafeToCollect() const { return m_isSafeToCollect; }
     
@@ -174,6 +189,13 @@ public:
     JS_EXPORT_PRIVATE bool isHeapSnapshotting() const;
 
     JS_EXPORT_PRIVATE void sweepSynchronously();
+    
+    GCTelemetry& telemetry() { return m_telemetry; }
+    
+    // Runs a full collection, frees the blocks that end up empty, and gives the OS back the pages
+    // of sparse blocks that only hold dead cells. Meant for memory pressure. Returns the number of
+    // bytes released.
+    JS_EXPORT_PRIVATE size_t releaseFragmentedMemory();
 
     bool shouldCollectHeuristic();
     
@@ -253,6 +275,27 @@ public:
     size_t sizeBeforeLastFullCollection() const { return m_sizeBeforeLastFullCollect; }
     size_t sizeAfterLastFullCollection() const { return m_sizeAfterLastFullCollect; }
 
+    // This is what the heap limits are compared against. Like the collection heuristics, it counts
+    // what was live after the last collection plus everything allocated since, including butterflies
+    // and the extra memory reported for ArrayBuffers and other objects.
+    size_t heapSizeForLimits() const { return m_sizeAfterLastCollect + m_bytesAllocatedThisCycle; }
+
+    // A VM can be given its own heap budget. Getting close to the soft limit makes collections
+    // more frequent, and going past it makes them full collections. If what is left after a
+    // collection is over the hard limit, the running script gets an OutOfMemoryError. If there is
+    // a callback, it gets to decide first: it can terminate the script by returning true, or raise
+    // the limits and return false. A limit of 0 means no limit.
+    enum class HardHeapLimitAction { Continue, ThrowOutOfMemoryError, Terminate };
+    JS_EXPORT_PRIVATE void setHeapLimits(size_t softLimit, size_t hardLimit);
+    JS_EXPORT_PRIVATE void setHardHeapLimitCallback(Function<bool(ExecState*)>&&);
+    size_t softHeapLimit() const { return m_softHeapLimit; }
+    size_t hardHeapLimit() const { return m_hardHeapLimit; }
+    HardHeapLimitAction checkHardHeapLimit(ExecState*);
+
+    // With a latency target, the concurrent collector schedules its pauses to meet it instead of
+    // following the global options. The new target takes effect when the next collection begins.
+    JS_EXPORT_PRIVATE void setLatencyTarget(std::optional<GCLatencyTarget>);
+
     void deleteAllCodeBlocks(DeleteAllCodeEffort);
     void deleteAllUnlinkedCodeBlocks(DeleteAllCodeEffort);
 
@@ -390,6 +433,7 @@ private:
     friend class HeapUtil;
     friend class HeapVerifier;
     friend class JITStubRoutine;
+    friend class LatencyTargetedMutatorScheduler;
     friend class LLIntOffsetsExtractor;
     friend class MarkStackMergingConstraint;
     friend class MarkedSpace;
@@ -504,11 +548,13 @@ private:
     void finalizeMarkedUnconditionalFinalizers(CellSet&);
 
     void finalizeUnconditionalFinalizers();
+    void updateAllocationSiteProfiles();
     
     void clearUnmarkedExecutables();
     void deleteUnmarkedCompiledCode();
     JS_EXPORT_PRIVATE void addToRememberedSet(const JSCell*);
     void updateAllocationLimits();
+    std::unique_ptr<MutatorScheduler> createMutatorScheduler(const std::optional<GCLatencyTarget>&);
     void didFinishCollection();
     void resumeCompilerThreads();
     void gatherExtraHeapSnapshotData(HeapProfiler&);
@@ -567,9 +613,13 @@ private:
     size_t m_maxEdenSize;
     size_t m_maxEdenSizeWhenCritical;
     size_t m_maxHeapSize;
+    size_t m_softHeapLimit { 0 };
+    size_t m_hardHeapLimit { 0 };
+    Function<bool(ExecState*)> m_hardHeapLimitCallback;
     bool m_shouldDoFullCollection;
     size_t m_totalBytesVisited;
     size_t m_totalBytesVisitedThisCycle;
+    size_t m_bytesPretenuredThisCycle { 0 };
     double m_incrementBalance { 0 };
     
     std::optional<CollectionScope> m_collectionScope;
@@ -634,6 +684,8 @@ private:
     
     Vector<HeapFinalizerCallback> m_heapFinalizerCallbacks;
     
+    GCTelemetry m_telemetry;
+    
     unsigned m_deferralDepth;
     bool m_didDeferGCWork { false };
 
@@ -645,6 +697,9 @@ private:
 #endif
 
     HashSet<WeakGCMapBase*> m_weakGCMaps;
+
+    Lock m_allocationSiteSamplesLock;
+    HashSet<AllocationSiteProfile*> m_allocationSitesWithSamples;
     
     Lock m_visitRaceLock;
 
@@ -672,6 +727,8 @@ private:
 #endif
     
     std::unique_ptr<MutatorScheduler> m_scheduler;
+    Lock m_pendingSchedulerLock;
+    std::unique_ptr<MutatorScheduler> m_pendingScheduler;
     
     static const unsigned mutatorHasConnBit = 1u << 0u; // Must also be protected by threadLock.
     static const unsigned stoppedBit = 1u << 1u; // Only set when !hasAccessBit
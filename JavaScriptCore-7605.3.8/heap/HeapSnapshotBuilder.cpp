@@ -98,9 +98,9 @@ void HeapSnapshotBuilder::appendPropertyNameEdge(JSCell* from, JSCell* to, Uniqu
     ASSERT(m_profiler.activeSnapshotBuilder() == this);
     ASSERT(to);
 
-    std::lock_guard<Lock> lock(m_buildingEdgeMutex);
+    auto locker = holdLock(m_buildingEdgeMutex);
 
-    m_edges.append(HeapSnapshotEdge(from, to, EdgeType::Property, propertyName));
+    m_edges.append(HeapSnapshotEdge(from, to, EdgeType::Property, edgeNameIndex(locker, propertyName)));
 }
 
 void HeapSnapshotBuilder::appendVariableNameEdge(JSCell* from, JSCell* to, UniquedStringImpl* variableName)
@@ -108,9 +108,9 @@ void HeapSnapshotBuilder::appendVariableNameEdge(JSCell* from, JSCell* to, Uniqu
     ASSERT(m_profiler.activeSnapshotBuilder() == this);
     ASSERT(to);
 
-    std::lock_guard<Lock> lock(m_buildingEdgeMutex);
+    auto locker = holdLock(m_buildingEdgeMutex);
 
-    m_edges.append(HeapSnapshotEdge(from, to, EdgeType::Variable, variableName));
+    m_edges.append(HeapSnapshotEdge(from, to, EdgeType::Variable, edgeNameIndex(locker, variableName)));
 }
 
 void HeapSnapshotBuilder::appendIndexEdge(JSCell* from, JSCell* to, uint32_t index)
@@ -123,6 +123,40 @@ void HeapSnapshotBuilder::appendIndexEdge(JSCell* from, JSCell* to, uint32_t ind
     m_edges.append(HeapSnapshotEdge(from, to, index));
 }
 
+void HeapSnapshotBuilder::appendNodes(const Vector<JSCell*>& cells)
+{
+    ASSERT(m_profiler.activeSnapshotBuilder() == this);
+
+    Vector<JSCell*> newCells;
+    newCells.reserveInitialCapacity(cells.size());
+    for (JSCell* cell : cells) {
+        ASSERT(Heap::isMarked(cell));
+        if (!hasExistingNodeForCell(cell))
+            newCells.uncheckedAppend(cell);
+    }
+
+    std::lock_guard<Lock> lock(m_buildingNodeMutex);
+
+    for (JSCell* cell : newCells)
+        m_snapshot->appendNode(HeapSnapshotNode(cell, getNextObjectIdentifier()));
+}
+
+void HeapSnapshotBuilder::appendEdges(const Vector<HeapSnapshotEdge>& edges)
+{
+    ASSERT(m_profiler.activeSnapshotBuilder() == this);
+
+    std::lock_guard<Lock> lock(m_buildingEdgeMutex);
+
+    for (const HeapSnapshotEdge& edge : edges) {
+        ASSERT(edge.type == EdgeType::Internal);
+        ASSERT(edge.to.cell);
+
+        // Avoid trivial edges.
+        if (edge.from.cell != edge.to.cell)
+            m_edges.append(edge);
+    }
+}
+
 bool HeapSnapshotBuilder::hasExistingNodeForCell(JSCell* cell)
 {
     if (!m_snapshot->previous())
@@ -131,6 +165,14 @@ bool HeapSnapshotBuilder::hasExistingNodeForCell(JSCell* cell)
     return !!m_snapshot->previous()->nodeForCell(cell);
 }
 
+unsigned HeapSnapshotBuilder::edgeNameIndex(const AbstractLocker&, UniquedStringImpl* name)
+{
+    auto result = m_edgeNameIndexes.add(name, m_edgeNames.size());
+    if (result.isNewEntry)
+        m_edgeNames.append(name);
+    return result.iterator->value;
+}
+
 
 // Heap Snapshot JSON Format:
 //
@@ -201,6 +243,28 @@ String HeapSnapshotBuilder::json()
 
 String HeapSnapshotBuilder::json(std::function<bool (const HeapSnapshotNode&)> allowNodeCallback)
 {
+    StringBuilder result;
+    writeJSON([&] (const String& chunk) { result.append(chunk); }, WTFMove(allowNodeCallback));
+    return result.toString();
+}
+
+bool HeapSnapshotBuilder::writeJSON(FILE* file, std::function<bool (const HeapSnapshotNode&)> allowNodeCallback)
+{
+    bool succeeded = true;
+    writeJSON([&] (const String& chunk) {
+        if (!succeeded)
+            return;
+        CString utf8 = chunk.utf8();
+        if (utf8.length() && fwrite(utf8.data(), utf8.length(), 1, file) != 1)
+            succeeded = false;
+    }, WTFMove(allowNodeCallback));
+    return succeeded && !fflush(file);
+}
+
+void HeapSnapshotBuilder::writeJSON(const std::function<void (const String&)>& writeChunk, std::function<bool (const HeapSnapshotNode&)> allowNodeCallback)
+{
+    static const unsigned chunkLength = 64 * KB;
+
     VM& vm = m_profiler.vm();
     DeferGCForAWhile deferGC(vm.heap);
 
@@ -212,12 +276,20 @@ String HeapSnapshotBuilder::json(std::function<bool (const HeapSnapshotNode&)> a
     classNameIndexes.set("<root>", 0);
     unsigned nextClassNameIndex = 1;
 
-    // Build a list of used edge names.
-    HashMap<UniquedStringImpl*, unsigned> edgeNameIndexes;
-    unsigned nextEdgeNameIndex = 0;
+    // Build a list of used edge names, mapping the indexes in m_edgeNames to the order in which
+    // the names are first used.
+    Vector<unsigned> edgeNameIndexes(m_edgeNames.size(), UINT_MAX);
+    Vector<UniquedStringImpl*> orderedEdgeNames;
 
     StringBuilder json;
 
+    auto flushIfNeeded = [&] {
+        if (json.length() < chunkLength)
+            return;
+        writeChunk(json.toString());
+        json.clear();
+    };
+
     auto appendNodeJSON = [&] (const HeapSnapshotNode& node) {
         // Let the client decide if they want to allow or disallow certain nodes.
         if (!allowNodeCallback(node))
@@ -245,6 +317,8 @@ String HeapSnapshotBuilder::json(std::function<bool (const HeapSnapshotNode&)> a
         json.appendNumber(classNameIndex);
         json.append(',');
         json.append(isInternal ? '1' : '0');
+
+        flushIfNeeded();
     };
 
     bool firstEdge = true;
@@ -263,10 +337,11 @@ String HeapSnapshotBuilder::json(std::function<bool (const HeapSnapshotNode&)> a
         switch (edge.type) {
         case EdgeType::Property:
         case EdgeType::Variable: {
-            auto result = edgeNameIndexes.add(edge.u.name, nextEdgeNameIndex);
-            if (result.isNewEntry)
-                nextEdgeNameIndex++;
-            unsigned edgeNameIndex = result.iterator->value;
+            unsigned& edgeNameIndex = edgeNameIndexes[edge.u.nameIndex];
+            if (edgeNameIndex == UINT_MAX) {
+                edgeNameIndex = orderedEdgeNames.size();
+                orderedEdgeNames.append(m_edgeNames[edge.u.nameIndex]);
+            }
             json.appendNumber(edgeNameIndex);
             break;
         }
@@ -278,6 +353,8 @@ String HeapSnapshotBuilder::json(std::function<bool (const HeapSnapshotNode&)> a
             json.append('0');
             break;
         }
+
+        flushIfNeeded();
     };
 
     json.append('{');
@@ -310,6 +387,7 @@ String HeapSnapshotBuilder::json(std::function<bool (const HeapSnapshotNode&)> a
             json.append(',');
         firstClassName = false;
         json.appendQuotedJSONString(className);
+        flushIfNeeded();
     }
     orderedClassNames.clear();
     json.append(']');
@@ -372,9 +450,6 @@ String HeapSnapshotBuilder::json(std::function<bool (const HeapSnapshotNode&)> a
     json.append(',');
     json.appendLiteral("\"edgeNames\":");
     json.append('[');
-    Vector<UniquedStringImpl*> orderedEdgeNames(edgeNameIndexes.size());
-    for (auto& entry : edgeNameIndexes)
-        orderedEdgeNames[entry.value] = entry.key;
     edgeNameIndexes.clear();
     bool firstEdgeName = true;
     for (auto& edgeName : orderedEdgeNames) {
@@ -382,12 +457,13 @@ String HeapSnapshotBuilder::json(std::function<bool (const HeapSnapshotNode&)> a
             json.append(',');
         firstEdgeName = false;
         json.appendQuotedJSONString(edgeName);
+        flushIfNeeded();
     }
     orderedEdgeNames.clear();
     json.append(']');
 
     json.append('}');
-    return json.toString();
+    writeChunk(json.toString());
 }
 
 } // namespace JSC
@@ -26,6 +26,8 @@
 #pragma once
 
 #include <functional>
+#include <stdio.h>
+#include <wtf/HashMap.h>
 #include <wtf/Lock.h>
 #include <wtf/Vector.h>
 #include <wtf/text/UniquedStringImpl.h>
@@ -63,13 +65,15 @@ struct HeapSnapshotEdge {
         to.cell = toCell;
     }
 
-    HeapSnapshotEdge(JSCell* fromCell, JSCell* toCell, EdgeType type, UniquedStringImpl* name)
+    // Property and Variable names are interned by the HeapSnapshotBuilder, so the edge only holds
+    // an index into its table of names.
+    HeapSnapshotEdge(JSCell* fromCell, JSCell* toCell, EdgeType type, unsigned nameIndex)
         : type(type)
     {
         ASSERT(type == EdgeType::Property || type == EdgeType::Variable);
         from.cell = fromCell;
         to.cell = toCell;
-        u.name = name;
+        u.nameIndex = nameIndex;
     }
 
     HeapSnapshotEdge(JSCell* fromCell, JSCell* toCell, uint32_t index)
@@ -91,7 +95,7 @@ struct HeapSnapshotEdge {
     } to;
 
     union {
-        UniquedStringImpl* name;
+        unsigned nameIndex;
         uint32_t index;
     } u;
 
@@ -120,14 +124,27 @@ public:
     void appendVariableNameEdge(JSCell* from, JSCell* to, UniquedStringImpl* variableName);
     void appendIndexEdge(JSCell* from, JSCell* to, uint32_t index);
 
+    // SlotVisitors buffer the nodes and edges they find and hand them over in batches, so that
+    // parallel marking does not serialize on the builder's locks.
+    void appendNodes(const Vector<JSCell*>&);
+    void appendEdges(const Vector<HeapSnapshotEdge>&);
+
     String json();
     String json(std::function<bool (const HeapSnapshotNode&)> allowNodeCallback);
 
+    // Writes the same JSON as json(), but hands it out in chunks as it goes rather than building
+    // one String for the whole snapshot. Edges to nodes that a callback disallows are dropped for
+    // good, so later calls on the same snapshot should not allow more nodes than earlier ones.
+    void writeJSON(const std::function<void (const String&)>& writeChunk, std::function<bool (const HeapSnapshotNode&)> allowNodeCallback);
+    bool writeJSON(FILE*, std::function<bool (const HeapSnapshotNode&)> allowNodeCallback);
+
 private:
     // Finalized snapshots are not modified during building. So searching them
     // for an existing node can be done concurrently without a lock.
     bool hasExistingNodeForCell(JSCell*);
 
+    unsigned edgeNameIndex(const AbstractLocker&, UniquedStringImpl*);
+
     HeapProfiler& m_profiler;
 
     // SlotVisitors run in parallel.
@@ -135,6 +152,8 @@ private:
     std::unique_ptr<HeapSnapshot> m_snapshot;
     Lock m_buildingEdgeMutex;
     Vector<HeapSnapshotEdge> m_edges;
+    HashMap<UniquedStringImpl*, unsigned> m_edgeNameIndexes;
+    Vector<UniquedStringImpl*> m_edgeNames;
 };
 
 } // namespace JSC
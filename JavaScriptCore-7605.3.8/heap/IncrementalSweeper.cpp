@@ -50,6 +50,11 @@ IncrementalSweeper::IncrementalSweeper(Heap* heap)
 {
 }
 
+IncrementalSweeper::~IncrementalSweeper()
+{
+    stop();
+}
+
 void IncrementalSweeper::doWork()
 {
     doSweep(MonotonicTime::now());
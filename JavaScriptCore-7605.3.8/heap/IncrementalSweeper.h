@@ -36,6 +36,7 @@ class IncrementalSweeper : public JSRunLoopTimer {
 public:
     using Base = JSRunLoopTimer;
     JS_EXPORT_PRIVATE explicit IncrementalSweeper(Heap*);
+    ~IncrementalSweeper();
 
     JS_EXPORT_PRIVATE void startSweeping();
     void freeFastMallocMemoryAfterSweeping() { m_shouldFreeFastMallocMemoryAfterSweeping = true; }
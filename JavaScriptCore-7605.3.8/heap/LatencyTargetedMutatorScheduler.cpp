@@ -0,0 +1,252 @@
+/*
+ * Copyright (C) 2018 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "LatencyTargetedMutatorScheduler.h"
+
+#include "JSCInlines.h"
+
+namespace JSC {
+
+LatencyTargetedMutatorScheduler::LatencyTargetedMutatorScheduler(Heap& heap, const GCLatencyTarget& target)
+    : m_heap(heap)
+    , m_target(target)
+    , m_minimumIncrement(std::min(Seconds::fromMilliseconds(Options::minimumGCPauseMS()), target.maximumPause / 2))
+{
+    RELEASE_ASSERT(m_target.maximumPause > 0_s);
+    RELEASE_ASSERT(m_target.minimumMutatorUtilization >= 0 && m_target.minimumMutatorUtilization < 1);
+    RELEASE_ASSERT(m_target.window >= m_target.maximumPause);
+}
+
+LatencyTargetedMutatorScheduler::~LatencyTargetedMutatorScheduler()
+{
+}
+
+MutatorScheduler::State LatencyTargetedMutatorScheduler::state() const
+{
+    return m_state;
+}
+
+void LatencyTargetedMutatorScheduler::beginCollection()
+{
+    RELEASE_ASSERT(m_state == Normal);
+    m_state = Stopped;
+    
+    MonotonicTime now = MonotonicTime::now();
+    m_collectionStartTime = now;
+    m_bytesAllocatedThisCycleAtTheBeginning = m_heap.m_bytesAllocatedThisCycle;
+    
+    // Leave the mutator at least as much headroom as the other schedulers do, and twice what it
+    // allocated during recent collections.
+    double headroom = std::max(
+        (Options::concurrentGCMaxHeadroom() - 1) * std::max<double>(m_bytesAllocatedThisCycleAtTheBeginning, m_heap.m_maxEdenSize),
+        2 * m_expectedBytesAllocatedDuringCollection);
+    m_bytesAllocatedThisCycleAtTheEnd = m_bytesAllocatedThisCycleAtTheBeginning + headroom;
+    
+    m_mutatorTimeThisCycle = Seconds();
+    m_bytesAllocatedWhileResumedThisCycle = 0;
+    
+    if (Options::logGC())
+        dataLog("ca=", m_bytesAllocatedThisCycleAtTheBeginning / 1024, "kb h=", headroom / 1024, "kb ");
+    
+    m_plannedResumeTime = planResume(now);
+}
+
+void LatencyTargetedMutatorScheduler::didStop()
+{
+    RELEASE_ASSERT(m_state == Stopped || m_state == Resumed);
+    MonotonicTime now = MonotonicTime::now();
+    if (m_state == Resumed) {
+        m_mutatorTimeThisCycle += now - m_resumeTime;
+        m_bytesAllocatedWhileResumedThisCycle += m_heap.m_bytesAllocatedThisCycle - m_bytesAllocatedThisCycleAtResume;
+    }
+    m_state = Stopped;
+    m_plannedResumeTime = planResume(now);
+}
+
+void LatencyTargetedMutatorScheduler::willResume()
+{
+    RELEASE_ASSERT(m_state == Stopped || m_state == Resumed);
+    MonotonicTime now = MonotonicTime::now();
+    m_state = Resumed;
+    m_resumeTime = now;
+    m_bytesAllocatedThisCycleAtResume = m_heap.m_bytesAllocatedThisCycle;
+    
+    // Let the mutator run long enough to make up for the pause it just had. If marking is further
+    // along than the mutator is into its headroom, it can run for up to four times as long.
+    double utilization = m_target.minimumMutatorUtilization;
+    Seconds run = (now - m_heap.m_stopTime) * (utilization / (1 - utilization));
+    double slack = (1 - headroomFullness()) / std::max(1 - markingProgress(), 0.25);
+    run *= std::min(std::max(slack, 1.0), 4.0);
+    
+    if (Options::logGC())
+        dataLog("r=", run.milliseconds(), "ms ");
+    
+    m_plannedStopTime = now + std::max(run, m_minimumIncrement);
+}
+
+void LatencyTargetedMutatorScheduler::didExecuteConstraints()
+{
+    // Constraints count against the pause, but there has to be some time left to drain what they
+    // found.
+    m_plannedResumeTime = planResume(MonotonicTime::now());
+}
+
+void LatencyTargetedMutatorScheduler::synchronousDrainingDidStall()
+{
+    // A mutator that has run out of headroom would have to stop again right away, so we might as
+    // well finish. This is the one case where we knowingly miss the target.
+    if (headroomFullness() >= 1)
+        m_plannedResumeTime = MonotonicTime::infinity();
+}
+
+MonotonicTime LatencyTargetedMutatorScheduler::timeToStop()
+{
+    switch (m_state) {
+    case Normal:
+        return MonotonicTime::infinity();
+    case Stopped:
+        return MonotonicTime::now();
+    case Resumed:
+        if (headroomFullness() >= 1)
+            return MonotonicTime::now();
+        return m_plannedStopTime;
+    }
+    
+    RELEASE_ASSERT_NOT_REACHED();
+    return MonotonicTime();
+}
+
+MonotonicTime LatencyTargetedMutatorScheduler::timeToResume()
+{
+    switch (m_state) {
+    case Normal:
+    case Resumed:
+        return MonotonicTime::now();
+    case Stopped:
+        return m_plannedResumeTime;
+    }
+    
+    RELEASE_ASSERT_NOT_REACHED();
+    return MonotonicTime();
+}
+
+void LatencyTargetedMutatorScheduler::log()
+{
+    ASSERT(Options::logGC());
+    dataLog(
+        "a=", format("%.0lf", bytesSinceBeginningOfCycle() / 1024), "kb ",
+        "hf=", format("%.3lf", headroomFullness()), " ",
+        "mp=", format("%.3lf", markingProgress()), " ");
+}
+
+void LatencyTargetedMutatorScheduler::endCollection()
+{
+    MonotonicTime now = MonotonicTime::now();
+    if (m_state == Resumed) {
+        m_mutatorTimeThisCycle += now - m_resumeTime;
+        m_bytesAllocatedWhileResumedThisCycle += m_heap.m_bytesAllocatedThisCycle - m_bytesAllocatedThisCycleAtResume;
+    }
+    m_state = Normal;
+    
+    auto blend = [] (double estimate, double sample) {
+        return estimate ? (estimate + sample) / 2 : sample;
+    };
+    
+    Seconds duration = now - m_collectionStartTime;
+    double bytesVisited = m_heap.bytesVisited();
+    expectedBytesVisited(*m_heap.collectionScope()) = bytesVisited;
+    if (duration)
+        m_markingRate = blend(m_markingRate, bytesVisited / duration.seconds());
+    if (m_mutatorTimeThisCycle)
+        m_allocationRate = blend(m_allocationRate, m_bytesAllocatedWhileResumedThisCycle / m_mutatorTimeThisCycle.seconds());
+    
+    // Most collections are eden collections, so that is what we plan for. A full collection that
+    // needs more room gets it from the headroom.
+    if (m_markingRate && duration) {
+        Seconds expectedDuration = Seconds(m_expectedBytesVisitedInEdenCollection / m_markingRate);
+        double mutatorShare = std::min(std::max(m_mutatorTimeThisCycle / duration, m_target.minimumMutatorUtilization), 1.0);
+        m_expectedBytesAllocatedDuringCollection = m_allocationRate * expectedDuration.seconds() * mutatorShare;
+    }
+}
+
+size_t LatencyTargetedMutatorScheduler::expectedBytesAllocatedDuringCollection()
+{
+    return static_cast<size_t>(m_expectedBytesAllocatedDuringCollection);
+}
+
+double LatencyTargetedMutatorScheduler::bytesSinceBeginningOfCycle()
+{
+    return m_heap.m_bytesAllocatedThisCycle - m_bytesAllocatedThisCycleAtTheBeginning;
+}
+
+double LatencyTargetedMutatorScheduler::headroomFullness()
+{
+    double result = bytesSinceBeginningOfCycle() / (m_bytesAllocatedThisCycleAtTheEnd - m_bytesAllocatedThisCycleAtTheBeginning);
+    
+    // Defend against zero headroom and other floating point dragons.
+    if (!(result >= 0))
+        result = 0;
+    if (!(result <= 1))
+        result = 1;
+    
+    return result;
+}
+
+double LatencyTargetedMutatorScheduler::markingProgress()
+{
+    // Until we have seen a collection like this one, assume that marking is just getting started.
+    double result = m_heap.bytesVisited() / expectedBytesVisited(*m_heap.collectionScope());
+    
+    if (!(result >= 0))
+        result = 0;
+    if (!(result <= 1))
+        result = 1;
+    
+    return result;
+}
+
+double& LatencyTargetedMutatorScheduler::expectedBytesVisited(CollectionScope scope)
+{
+    switch (scope) {
+    case CollectionScope::Eden:
+        return m_expectedBytesVisitedInEdenCollection;
+    case CollectionScope::Full:
+        return m_expectedBytesVisitedInFullCollection;
+    }
+    RELEASE_ASSERT_NOT_REACHED();
+    return m_expectedBytesVisitedInEdenCollection;
+}
+
+MonotonicTime LatencyTargetedMutatorScheduler::planResume(MonotonicTime now)
+{
+    // The world may have been stopped for a while already, and earlier pauses may have used up some
+    // of the window.
+    Seconds pauseBudget = m_target.maximumPause - (now - m_heap.m_stopTime);
+    Seconds windowBudget = m_target.window * (1 - m_target.minimumMutatorUtilization) - m_heap.telemetry().stoppedDurationSince(now - m_target.window);
+    return now + std::max(std::min(pauseBudget, windowBudget), m_minimumIncrement);
+}
+
+} // namespace JSC
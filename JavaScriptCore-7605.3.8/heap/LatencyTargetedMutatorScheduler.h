@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2018 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "CollectionScope.h"
+#include "GCLatencyTarget.h"
+#include "MutatorScheduler.h"
+
+namespace JSC {
+
+class Heap;
+
+// Schedules the collector's synthetic pauses to meet a GCLatencyTarget instead of the global
+// headroom and utilization options. Every increment ends by the time the pause would go over the
+// maximum, or would leave the mutator with less than its share of the window. The mutator then runs
+// until it has made up for that pause. When marking keeps ahead of allocation, the mutator gets to
+// run for longer than its share.
+//
+// Between collections, the scheduler remembers how fast the mutator allocates and how fast the
+// collector marks, and asks the heap to start the next collection early enough that what gets
+// allocated while it runs fits in the space the heap would have let the mutator allocate anyway.
+//
+// If the mutator still outruns the collector, the collector stops the world until it is done. The
+// heap's GCTelemetry reports the pauses that miss the target.
+class LatencyTargetedMutatorScheduler : public MutatorScheduler {
+public:
+    LatencyTargetedMutatorScheduler(Heap&, const GCLatencyTarget&);
+    ~LatencyTargetedMutatorScheduler();
+    
+    State state() const override;
+    
+    void beginCollection() override;
+    
+    void didStop() override;
+    void willResume() override;
+    void didExecuteConstraints() override;
+    void synchronousDrainingDidStall() override;
+    
+    MonotonicTime timeToStop() override;
+    MonotonicTime timeToResume() override;
+    
+    void log() override;
+    
+    void endCollection() override;
+    
+    size_t expectedBytesAllocatedDuringCollection() override;
+
+private:
+    double bytesSinceBeginningOfCycle();
+    double headroomFullness();
+    double markingProgress();
+    double& expectedBytesVisited(CollectionScope);
+    MonotonicTime planResume(MonotonicTime now);
+    
+    Heap& m_heap;
+    GCLatencyTarget m_target;
+    Seconds m_minimumIncrement;
+    State m_state { Normal };
+    
+    MonotonicTime m_collectionStartTime;
+    double m_bytesAllocatedThisCycleAtTheBeginning { 0 };
+    double m_bytesAllocatedThisCycleAtTheEnd { 0 };
+    
+    MonotonicTime m_plannedResumeTime;
+    MonotonicTime m_plannedStopTime;
+    
+    MonotonicTime m_resumeTime;
+    double m_bytesAllocatedThisCycleAtResume { 0 };
+    Seconds m_mutatorTimeThisCycle;
+    double m_bytesAllocatedWhileResumedThisCycle { 0 };
+    
+    // These carry over from one collection to the next.
+    double m_allocationRate { 0 }; // Bytes per second that the mutator allocates while collecting.
+    double m_markingRate { 0 }; // Bytes visited per second from the beginning to the end of a collection.
+    double m_expectedBytesVisitedInEdenCollection { 0 };
+    double m_expectedBytesVisitedInFullCollection { 0 };
+    double m_expectedBytesAllocatedDuringCollection { 0 };
+};
+
+} // namespace JSC
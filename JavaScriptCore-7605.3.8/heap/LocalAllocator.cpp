@@ -27,8 +27,10 @@
 #include "LocalAllocator.h"
 
 #include "AllocatingScope.h"
+#include "AllocationProfiler.h"
 #include "LocalAllocatorInlines.h"
 #include "Options.h"
+#include "VM.h"
 
 namespace JSC {
 
@@ -46,6 +48,7 @@ LocalAllocator::LocalAllocator(LocalAllocator&& other)
     : m_tlc(other.m_tlc)
     , m_directory(other.m_directory)
     , m_cellSize(other.m_cellSize)
+    , m_bytesUntilSample(other.m_bytesUntilSample)
     , m_freeList(WTFMove(other.m_freeList))
     , m_currentBlock(other.m_currentBlock)
     , m_lastActiveBlock(other.m_lastActiveBlock)
@@ -144,6 +147,21 @@ void LocalAllocator::stopAllocatingForGood()
     reset();
 }
 
+void* LocalAllocator::allocateAndSample(GCDeferralContext* deferralContext, AllocationFailureMode failureMode)
+{
+#if ENABLE(SAMPLING_PROFILER)
+    if (AllocationProfiler* profiler = m_directory->heap()->vm()->allocationProfiler()) {
+        m_bytesUntilSample = profiler->nextSampleInterval();
+        void* result = allocateWithoutSampling(deferralContext, failureMode);
+        if (result)
+            profiler->didAllocate(static_cast<HeapCell*>(result), m_cellSize, m_directory->subspace()->name());
+        return result;
+    }
+#endif
+    m_bytesUntilSample = std::numeric_limits<int32_t>::max();
+    return allocateWithoutSampling(deferralContext, failureMode);
+}
+
 void* LocalAllocator::allocateSlowCase(GCDeferralContext* deferralContext, AllocationFailureMode failureMode)
 {
     SuperSamplerScope superSamplerScope(false);
@@ -52,6 +52,10 @@ public:
     
     static ptrdiff_t offsetOfFreeList();
     static ptrdiff_t offsetOfCellSize();
+    static ptrdiff_t offsetOfBytesUntilSample();
+
+    // Makes the next allocation ask the VM's AllocationProfiler when to take a sample.
+    void resetAllocationSampling() { m_bytesUntilSample = 0; }
     
     bool isFreeListedCell(const void*) const;
     
@@ -62,6 +66,8 @@ private:
     
     void reset();
     JS_EXPORT_PRIVATE void* allocateSlowCase(GCDeferralContext*, AllocationFailureMode failureMode);
+    JS_EXPORT_PRIVATE void* allocateAndSample(GCDeferralContext*, AllocationFailureMode);
+    ALWAYS_INLINE void* allocateWithoutSampling(GCDeferralContext*, AllocationFailureMode);
     void didConsumeFreeList();
     void* tryAllocateWithoutCollecting();
     void* tryAllocateIn(MarkedBlock::Handle*);
@@ -71,6 +77,9 @@ private:
     ThreadLocalCache* m_tlc;
     BlockDirectory* m_directory;
     unsigned m_cellSize;
+    // Counts down the bytes allocated until the next allocation sample. Without an AllocationProfiler,
+    // it gets reset to a count so large that it hardly ever runs out.
+    int32_t m_bytesUntilSample { 0 };
     FreeList m_freeList;
     MarkedBlock::Handle* m_currentBlock { nullptr };
     MarkedBlock::Handle* m_lastActiveBlock { nullptr };
@@ -90,5 +99,10 @@ inline ptrdiff_t LocalAllocator::offsetOfCellSize()
     return OBJECT_OFFSETOF(LocalAllocator, m_cellSize);
 }
 
+inline ptrdiff_t LocalAllocator::offsetOfBytesUntilSample()
+{
+    return OBJECT_OFFSETOF(LocalAllocator, m_bytesUntilSample);
+}
+
 } // namespace JSC
 
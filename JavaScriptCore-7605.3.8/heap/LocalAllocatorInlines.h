@@ -30,6 +30,14 @@
 namespace JSC {
 
 ALWAYS_INLINE void* LocalAllocator::allocate(GCDeferralContext* deferralContext, AllocationFailureMode failureMode)
+{
+    m_bytesUntilSample -= static_cast<int32_t>(m_cellSize);
+    if (UNLIKELY(m_bytesUntilSample < 0))
+        return allocateAndSample(deferralContext, failureMode);
+    return allocateWithoutSampling(deferralContext, failureMode);
+}
+
+ALWAYS_INLINE void* LocalAllocator::allocateWithoutSampling(GCDeferralContext* deferralContext, AllocationFailureMode failureMode)
 {
     return m_freeList.allocate(
         [&] () -> HeapCell* {
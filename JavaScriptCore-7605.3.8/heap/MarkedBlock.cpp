@@ -36,6 +36,8 @@
 #include "SuperSampler.h"
 #include "SweepingScope.h"
 #include <wtf/CommaPrinter.h>
+#include <wtf/OSAllocator.h>
+#include <wtf/PageBlock.h>
 
 namespace JSC {
 
@@ -66,6 +68,7 @@ MarkedBlock::Handle::Handle(Heap& heap, AlignedMemoryAllocator* alignedMemoryAll
     m_block = new (NotNull, blockSpace) MarkedBlock(*heap.vm(), *this);
     
     m_weakSet.setContainer(*m_block);
+    m_presweepState.store(PresweepState::None);
     
     heap.didAllocateBlock(blockSize);
 }
@@ -120,6 +123,129 @@ void MarkedBlock::Handle::setIsFreeListed()
     m_isFreeListed = true;
 }
 
+bool MarkedBlock::Handle::schedulePresweep()
+{
+    // Presweeping only looks at mark bits, so it can't handle blocks whose liveness also depends
+    // on newlyAllocated. It also can't touch the directory's bitvectors, which is why empty blocks,
+    // which get bump allocated anyway, and blocks with destructors are left to the mutator.
+    //
+    // Presweeping overwrites dead cells, but sweep() only runs m_weakSet.sweep() when the free list
+    // is taken. Weak finalizers, like the ones JSArrayBufferView uses, still read their dead cells
+    // at that point. So blocks with anything in their WeakSet are left to the mutator too. A WeakSet
+    // can't gain entries for dead cells, so it stays that way until the free list is taken.
+    ASSERT(!space()->isMarking());
+    ASSERT(m_presweepState.load() == PresweepState::None);
+    if (needsDestruction() || m_isFreeListed || isEmpty() || !m_weakSet.isEmpty())
+        return false;
+    if (block().areMarksStale() || block().hasAnyNewlyAllocated())
+        return false;
+    m_presweepState.store(PresweepState::Pending);
+    return true;
+}
+
+void MarkedBlock::Handle::presweep()
+{
+    if (m_presweepState.compareExchangeStrong(PresweepState::Pending, PresweepState::Sweeping) != PresweepState::Pending)
+        return;
+    
+    MarkedBlock& block = this->block();
+    MarkedBlock::Footer& footer = block.footer();
+    size_t cellSize = this->cellSize();
+    bool shouldScribble = scribbleMode() == Scribble;
+    
+    FreeCell* head = nullptr;
+    size_t count = 0;
+    uintptr_t secret;
+    cryptographicallyRandomValues(&secret, sizeof(uintptr_t));
+    for (size_t i = 0; i < m_endAtom; i += m_atomsPerCell) {
+        if (footer.m_marks.get(i))
+            continue;
+        FreeCell* freeCell = reinterpret_cast_ptr<FreeCell*>(&block.atoms()[i]);
+        if (shouldScribble)
+            scribble(freeCell, cellSize);
+        freeCell->setNext(head, secret);
+        head = freeCell;
+        ++count;
+    }
+    
+    m_presweptHead = head;
+    m_presweptSecret = secret;
+    m_presweptBytes = count * cellSize;
+    m_presweepState.store(PresweepState::Done);
+}
+
+bool MarkedBlock::Handle::takePresweptFreeList(FreeList& freeList)
+{
+    if (m_presweepState.loadRelaxed() == PresweepState::None)
+        return false;
+    
+    // If no helper got to this block yet, claim it so that none will.
+    if (m_presweepState.compareExchangeStrong(PresweepState::Pending, PresweepState::None) == PresweepState::Pending)
+        return false;
+    
+    while (m_presweepState.load() == PresweepState::Sweeping)
+        Thread::yield();
+    
+    RELEASE_ASSERT(m_presweepState.load() == PresweepState::Done);
+    ASSERT(!space()->isMarking());
+    m_presweepState.store(PresweepState::None);
+    freeList.initializeList(m_presweptHead, m_presweptSecret, m_presweptBytes);
+    setIsFreeListed();
+    return true;
+}
+
+void MarkedBlock::Handle::discardPresweptFreeList()
+{
+    // The helpers must have finished by now. Dropping the free list is enough: the cells it
+    // threads through are dead, and nothing but a free list reads their contents.
+    ASSERT(m_presweepState.load() != PresweepState::Sweeping);
+    m_presweepState.store(PresweepState::None);
+    m_presweptHead = nullptr;
+}
+
+size_t MarkedBlock::Handle::releaseFreePages()
+{
+    // Dead cells have to stay intact until their destructors have run, and free lists are threaded
+    // through them.
+    if (m_isFreeListed
+        || m_directory->isUnswept(NoLockingNecessary, this)
+        || m_directory->isDestructible(NoLockingNecessary, this))
+        return 0;
+    ASSERT(m_presweepState.load() == PresweepState::None);
+    
+    // The last page also holds the footer, so it never goes away.
+    size_t pageSize = WTF::pageSize();
+    size_t numberOfPages = payloadSize / pageSize;
+    if (!numberOfPages)
+        return 0;
+    
+    char* base = bitwise_cast<char*>(&block());
+    size_t cellSize = this->cellSize();
+    size_t liveBytes = 0;
+    Vector<bool, blockSize / KB> pageIsLive(numberOfPages, false);
+    forEachLiveCell(
+        [&] (size_t, HeapCell* cell, HeapCell::Kind) -> IterationStatus {
+            size_t begin = bitwise_cast<char*>(cell) - base;
+            size_t end = (begin + cellSize - 1) / pageSize;
+            for (size_t page = begin / pageSize; page <= end && page < numberOfPages; ++page)
+                pageIsLive[page] = true;
+            liveBytes += cellSize;
+            return IterationStatus::Continue;
+        });
+    
+    if (liveBytes > Options::sparseBlockUtilization() * payloadSize)
+        return 0;
+    
+    size_t result = 0;
+    for (size_t page = 0; page < numberOfPages; ++page) {
+        if (pageIsLive[page])
+            continue;
+        OSAllocator::hintMemoryNotNeededSoon(base + page * pageSize, pageSize);
+        result += pageSize;
+    }
+    return result;
+}
+
 void MarkedBlock::Handle::stopAllocating(const FreeList& freeList)
 {
     auto locker = holdLock(blockFooter().m_lock);
@@ -433,6 +559,9 @@ void MarkedBlock::Handle::sweep(FreeList* freeList)
         return;
     }
     
+    if (takePresweptFreeList(*freeList))
+        return;
+    
     // Handle the no-destructor specializations here, since we have the most of those. This
     // ensures that they don't get re-specialized for every destructor space.
     
@@ -37,6 +37,7 @@ namespace JSC {
 
 class AlignedMemoryAllocator;    
 class FreeList;
+struct FreeCell;
 class Heap;
 class JSCell;
 class BlockDirectory;
@@ -140,6 +141,20 @@ public:
         
         void unsweepWithNoNewlyAllocated();
         
+        // Parallel sweeping lets helper threads build the free list of a block that has no
+        // destructors ahead of time. The next sweep to free list takes that free list instead of
+        // building its own. Everything else that sweeping does still happens on the mutator, after
+        // the helpers have overwritten the dead cells, so only blocks with an empty WeakSet qualify.
+        bool schedulePresweep();
+        void presweep(); // Safe to call from any thread while the mutator is running.
+        void discardPresweptFreeList();
+        
+        // Hands the pages that only hold dead cells back to the OS if the block is sparse enough,
+        // and returns how many bytes that was. Touching those cells again, for example when the
+        // block is next swept to a free list, gets fresh zero-filled pages. This only works on a
+        // swept block that is not free-listed.
+        size_t releaseFreePages();
+        
         void zap(const FreeList&);
         
         void shrink();
@@ -218,6 +233,10 @@ public:
         
         void setIsFreeListed();
         
+        bool takePresweptFreeList(FreeList&);
+        
+        enum class PresweepState : uint8_t { None, Pending, Sweeping, Done };
+        
         MarkedBlock::Handle* m_prev { nullptr };
         MarkedBlock::Handle* m_next { nullptr };
             
@@ -235,6 +254,11 @@ public:
         MarkedBlock* m_block { nullptr };
         
         SecurityOriginToken m_securityOriginToken { 0 };
+        
+        Atomic<PresweepState> m_presweepState;
+        FreeCell* m_presweptHead { nullptr };
+        uintptr_t m_presweptSecret { 0 };
+        unsigned m_presweptBytes { 0 };
     };
 
 private:    
@@ -23,6 +23,7 @@
 
 #include "BlockDirectoryInlines.h"
 #include "FunctionCodeBlock.h"
+#include "HeapHelperPool.h"
 #include "IncrementalSweeper.h"
 #include "JSObject.h"
 #include "JSCInlines.h"
@@ -269,6 +270,52 @@ void MarkedSpace::prepareForAllocation()
     else
         m_largeAllocationsNurseryOffsetForSweep = 0;
     m_largeAllocationsNurseryOffset = m_largeAllocations.size();
+
+    startParallelSweeping();
+}
+
+void MarkedSpace::startParallelSweeping()
+{
+    stopParallelSweeping();
+
+    if (!Options::useParallelSweeping() || !heapHelperPool().numberOfThreads())
+        return;
+
+    forEachDirectory(
+        [&] (BlockDirectory& directory) -> IterationStatus {
+            directory.appendBlocksToPresweep(m_blocksToPresweep);
+            return IterationStatus::Continue;
+        });
+    if (m_blocksToPresweep.isEmpty())
+        return;
+
+    if (!m_parallelSweepingHelperClient)
+        m_parallelSweepingHelperClient = std::make_unique<ParallelHelperClient>(&heapHelperPool());
+
+    m_presweepCursor.store(0);
+    m_shouldStopParallelSweeping.store(false);
+    m_parallelSweepingHelperClient->setFunction(
+        [this] () {
+            while (!m_shouldStopParallelSweeping.load()) {
+                unsigned index = m_presweepCursor.exchangeAdd(1);
+                if (index >= m_blocksToPresweep.size())
+                    return;
+                m_blocksToPresweep[index]->presweep();
+            }
+        });
+}
+
+void MarkedSpace::stopParallelSweeping()
+{
+    if (m_blocksToPresweep.isEmpty())
+        return;
+
+    m_shouldStopParallelSweeping.store(true);
+    m_parallelSweepingHelperClient->finish();
+
+    for (MarkedBlock::Handle* block : m_blocksToPresweep)
+        block->discardPresweptFreeList();
+    m_blocksToPresweep.clear();
 }
 
 void MarkedSpace::visitWeakSets(SlotVisitor& visitor)
@@ -298,6 +345,7 @@ void MarkedSpace::reapWeakSets()
 void MarkedSpace::stopAllocating()
 {
     ASSERT(!isIterating());
+    stopParallelSweeping();
     forEachDirectory(
         [&] (BlockDirectory& directory) -> IterationStatus {
             directory.stopAllocating();
@@ -308,6 +356,7 @@ void MarkedSpace::stopAllocating()
 void MarkedSpace::stopAllocatingForGood()
 {
     ASSERT(!isIterating());
+    stopParallelSweeping();
     forEachDirectory(
         [&] (BlockDirectory& directory) -> IterationStatus {
             directory.stopAllocatingForGood();
@@ -329,6 +378,15 @@ void MarkedSpace::prepareForConservativeScan()
         });
 }
 
+void MarkedSpace::resetAllocationSampling()
+{
+    forEachDirectory(
+        [&] (BlockDirectory& directory) -> IterationStatus {
+            directory.resetAllocationSampling();
+            return IterationStatus::Continue;
+        });
+}
+
 void MarkedSpace::prepareForMarking()
 {
     if (m_heap->collectionScope() == CollectionScope::Eden)
@@ -389,6 +447,19 @@ void MarkedSpace::shrink()
         });
 }
 
+size_t MarkedSpace::releaseFreePagesInSparseBlocks()
+{
+    // The helpers write free lists into dead cells, so they must be done with this heap first.
+    stopParallelSweeping();
+    
+    size_t result = 0;
+    forEachBlock(
+        [&] (MarkedBlock::Handle* block) {
+            result += block->releaseFreePages();
+        });
+    return result;
+}
+
 void MarkedSpace::beginMarking()
 {
     if (m_heap->collectionScope() == CollectionScope::Full) {
@@ -30,6 +30,7 @@
 #include <wtf/Bag.h>
 #include <wtf/HashSet.h>
 #include <wtf/Noncopyable.h>
+#include <wtf/ParallelHelperPool.h>
 #include <wtf/RetainPtr.h>
 #include <wtf/SentinelLinkedList.h>
 #include <wtf/SinglyLinkedListWithTail.h>
@@ -100,6 +101,12 @@ public:
     
     void prepareForAllocation();
 
+    // Parallel sweeping starts when allocation resumes after a collection, and has to stop
+    // before anything looks at the blocks' allocation state again.
+    void startParallelSweeping();
+    void stopParallelSweeping();
+    size_t numberOfBlocksToPresweep() const { return m_blocksToPresweep.size(); }
+
     void visitWeakSets(SlotVisitor&);
     void reapWeakSets();
 
@@ -117,6 +124,8 @@ public:
     
     void prepareForConservativeScan();
 
+    void resetAllocationSampling();
+
     typedef HashSet<MarkedBlock*>::iterator BlockIterator;
 
     template<typename Functor> void forEachLiveCell(HeapIterationScope&, const Functor&);
@@ -124,6 +133,7 @@ public:
     template<typename Functor> void forEachBlock(const Functor&);
 
     void shrink();
+    JS_EXPORT_PRIVATE size_t releaseFreePagesInSparseBlocks();
     void freeBlock(MarkedBlock::Handle*);
     void freeOrShrinkBlock(MarkedBlock::Handle*);
 
@@ -217,6 +227,11 @@ private:
     Lock m_directoryLock;
     SinglyLinkedListWithTail<BlockDirectory> m_directories;
 
+    std::unique_ptr<ParallelHelperClient> m_parallelSweepingHelperClient;
+    Vector<MarkedBlock::Handle*> m_blocksToPresweep;
+    Atomic<unsigned> m_presweepCursor;
+    Atomic<bool> m_shouldStopParallelSweeping;
+
     friend class HeapVerifier;
 };
 
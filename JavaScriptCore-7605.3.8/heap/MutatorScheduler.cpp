@@ -62,6 +62,11 @@ void MutatorScheduler::log()
 {
 }
 
+size_t MutatorScheduler::expectedBytesAllocatedDuringCollection()
+{
+    return 0;
+}
+
 bool MutatorScheduler::shouldStop()
 {
     return hasElapsed(timeToStop());
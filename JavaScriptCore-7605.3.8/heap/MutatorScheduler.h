@@ -70,6 +70,10 @@ public:
     bool shouldResume(); // Call while stopped, to ask if we should resume now.
     
     virtual void endCollection() = 0;
+    
+    // Asked after every collection. The heap starts the next collection this many bytes early, so
+    // that the mutator can keep allocating while it runs.
+    virtual size_t expectedBytesAllocatedDuringCollection();
 };
 
 } // namespace JSC
@@ -47,6 +47,8 @@
 
 namespace JSC {
 
+static const unsigned heapSnapshotBatchSize = 512;
+
 #if ENABLE(GC_VALIDATION)
 static void validate(JSCell* cell)
 {
@@ -112,6 +114,7 @@ void SlotVisitor::reset()
 {
     m_bytesVisited = 0;
     m_visitCount = 0;
+    flushHeapSnapshotData();
     m_heapSnapshotBuilder = nullptr;
     RELEASE_ASSERT(!m_currentCell);
 }
@@ -223,8 +226,11 @@ void SlotVisitor::appendJSCellOrAuxiliary(HeapCell* heapCell)
 
 void SlotVisitor::appendSlow(JSCell* cell, Dependency dependency)
 {
-    if (UNLIKELY(m_heapSnapshotBuilder))
-        m_heapSnapshotBuilder->appendEdge(m_currentCell, cell);
+    if (UNLIKELY(m_heapSnapshotBuilder)) {
+        m_heapSnapshotEdges.append(HeapSnapshotEdge(m_currentCell, cell));
+        if (m_heapSnapshotEdges.size() >= heapSnapshotBatchSize)
+            flushHeapSnapshotData();
+    }
     
     appendHiddenSlowImpl(cell, dependency);
 }
@@ -385,8 +391,23 @@ ALWAYS_INLINE void SlotVisitor::visitChildren(const JSCell* cell)
     }
     
     if (UNLIKELY(m_heapSnapshotBuilder)) {
-        if (m_isFirstVisit)
-            m_heapSnapshotBuilder->appendNode(const_cast<JSCell*>(cell));
+        if (m_isFirstVisit) {
+            m_heapSnapshotNodes.append(const_cast<JSCell*>(cell));
+            if (m_heapSnapshotNodes.size() >= heapSnapshotBatchSize)
+                flushHeapSnapshotData();
+        }
+    }
+}
+
+void SlotVisitor::flushHeapSnapshotData()
+{
+    if (!m_heapSnapshotNodes.isEmpty()) {
+        m_heapSnapshotBuilder->appendNodes(m_heapSnapshotNodes);
+        m_heapSnapshotNodes.shrink(0);
+    }
+    if (!m_heapSnapshotEdges.isEmpty()) {
+        m_heapSnapshotBuilder->appendEdges(m_heapSnapshotEdges);
+        m_heapSnapshotEdges.shrink(0);
     }
 }
 
@@ -26,6 +26,7 @@
 #pragma once
 
 #include "HandleTypes.h"
+#include "HeapSnapshotBuilder.h"
 #include "IterationStatus.h"
 #include "MarkStack.h"
 #include "VisitRaceKey.h"
@@ -40,7 +41,6 @@ class ConservativeRoots;
 class GCThreadSharedData;
 class Heap;
 class HeapCell;
-class HeapSnapshotBuilder;
 class MarkedBlock;
 class MarkingConstraint;
 class MarkingConstraintSolver;
@@ -201,6 +201,8 @@ private:
     
     void visitChildren(const JSCell*);
     
+    void flushHeapSnapshotData();
+    
     void donateKnownParallel();
     void donateKnownParallel(MarkStackArray& from, MarkStackArray& to);
 
@@ -228,6 +230,8 @@ private:
     Heap& m_heap;
 
     HeapSnapshotBuilder* m_heapSnapshotBuilder { nullptr };
+    Vector<JSCell*> m_heapSnapshotNodes;
+    Vector<HeapSnapshotEdge> m_heapSnapshotEdges;
     JSCell* m_currentCell { nullptr };
     bool m_isFirstVisit { false };
     bool m_mutatorIsStopped { false };
@@ -35,6 +35,11 @@ StopIfNecessaryTimer::StopIfNecessaryTimer(VM* vm)
 {
 }
 
+StopIfNecessaryTimer::~StopIfNecessaryTimer()
+{
+    stop();
+}
+
 void StopIfNecessaryTimer::doWork()
 {
     cancelTimer();
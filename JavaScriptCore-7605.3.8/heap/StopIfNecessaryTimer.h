@@ -35,6 +35,7 @@ class StopIfNecessaryTimer : public JSRunLoopTimer {
 public:
     using Base = JSRunLoopTimer;
     explicit StopIfNecessaryTimer(VM*);
+    ~StopIfNecessaryTimer();
     
     void doWork() override;
     
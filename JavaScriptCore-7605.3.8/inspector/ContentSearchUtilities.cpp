@@ -188,7 +188,7 @@ static String findMagicComment(const String& content, const String& patternStrin
     Vector<int, 4> matches;
     matches.grow(4);
     unsigned result = interpret(bytecodePattern.get(), content, 0, reinterpret_cast<unsigned*>(matches.data()));
-    if (result == offsetNoMatch)
+    if (result == offsetNoMatch || result == offsetHitMatchLimit)
         return String();
 
     ASSERT(matches[2] > 0 && matches[3] > 0);
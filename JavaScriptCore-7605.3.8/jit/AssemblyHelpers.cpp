@@ -611,6 +611,20 @@ void AssemblyHelpers::emitAllocateWithNonNullAllocator(GPRReg resultGPR, const J
         addPtr(scratchGPR, allocatorGPR);
     }
 
+#if ENABLE(SAMPLING_PROFILER)
+    if (vm().allocationProfiler()) {
+        // Count down the bytes until the next sample. The counter is only stored back when we stay on
+        // the fast path, so the slow path sees the same underflow and takes the sample.
+        load32(Address(allocatorGPR, LocalAllocator::offsetOfBytesUntilSample()), scratchGPR);
+        if (allocator.isConstant())
+            sub32(TrustedImm32(allocator.allocator().cellSize(vm().heap)), scratchGPR);
+        else
+            sub32(Address(allocatorGPR, LocalAllocator::offsetOfCellSize()), scratchGPR);
+        slowPath.append(branch32(LessThan, scratchGPR, TrustedImm32(0)));
+        store32(scratchGPR, Address(allocatorGPR, LocalAllocator::offsetOfBytesUntilSample()));
+    }
+#endif
+
     load32(Address(allocatorGPR, LocalAllocator::offsetOfFreeList() + FreeList::offsetOfRemaining()), resultGPR);
     popPath = branchTest32(Zero, resultGPR);
     if (allocator.isConstant())
@@ -721,6 +721,7 @@ namespace JSC {
         MacroAssembler::Call callOperation(C_JITOperation_EL, GPRReg);
         MacroAssembler::Call callOperation(C_JITOperation_EL, TrustedImmPtr);
         MacroAssembler::Call callOperation(C_JITOperation_ESt, Structure*);
+        MacroAssembler::Call callOperation(C_JITOperation_EStAsp, Structure*, AllocationSiteProfile*);
         MacroAssembler::Call callOperation(C_JITOperation_EC, JSCell*);
         MacroAssembler::Call callOperation(C_JITOperation_EZ, int32_t);
         MacroAssembler::Call callOperation(Z_JITOperation_EJZZ, GPRReg, int32_t, int32_t);
@@ -253,6 +253,12 @@ ALWAYS_INLINE MacroAssembler::Call JIT::callOperation(C_JITOperation_ESt operati
     return appendCallWithExceptionCheck(operation);
 }
 
+ALWAYS_INLINE MacroAssembler::Call JIT::callOperation(C_JITOperation_EStAsp operation, Structure* structure, AllocationSiteProfile* allocationSite)
+{
+    setupArgumentsWithExecState(TrustedImmPtr(structure), TrustedImmPtr(allocationSite));
+    return appendCallWithExceptionCheck(operation);
+}
+
 ALWAYS_INLINE MacroAssembler::Call JIT::callOperation(C_JITOperation_EC operation, JSCell* cell)
 {
     setupArgumentsWithExecState(TrustedImmPtr(cell));
@@ -105,8 +105,8 @@ void JIT::emitSlow_op_new_object(Instruction* currentInstruction, Vector<SlowCas
     linkAllSlowCases(iter);
 
     int dst = currentInstruction[1].u.operand;
-    Structure* structure = currentInstruction[3].u.objectAllocationProfile->structure();
-    callOperation(operationNewObject, structure);
+    ObjectAllocationProfile* allocationProfile = currentInstruction[3].u.objectAllocationProfile;
+    callOperation(operationNewObjectWithAllocationSite, allocationProfile->structure(), &allocationProfile->allocationSiteProfile());
     emitStoreCell(dst, returnValueGPR);
 }
 
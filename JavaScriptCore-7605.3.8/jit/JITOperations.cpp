@@ -1328,6 +1328,16 @@ JSCell* JIT_OPERATION operationNewObject(ExecState* exec, Structure* structure)
     return constructEmptyObject(exec, structure);
 }
 
+JSCell* JIT_OPERATION operationNewObjectWithAllocationSite(ExecState* exec, Structure* structure, AllocationSiteProfile* allocationSite)
+{
+    VM& vm = exec->vm();
+    NativeCallFrameTracer tracer(&vm, exec);
+
+    JSObject* result = constructEmptyObject(exec, structure);
+    allocationSite->didAllocate(vm, result);
+    return result;
+}
+
 JSCell* JIT_OPERATION operationNewRegexp(ExecState* exec, JSCell* regexpPtr)
 {
     SuperSamplerScope superSamplerScope(false);
@@ -57,6 +57,13 @@ public:
         return m_registers.at(index);
     }
     
+    // Appended registers must keep the list sorted by register.
+    void append(RegisterAtOffset registerAtOffset)
+    {
+        ASSERT(m_registers.isEmpty() || m_registers.last().reg() < registerAtOffset.reg());
+        m_registers.append(registerAtOffset);
+    }
+
     RegisterAtOffset* find(Reg) const;
     unsigned indexOf(Reg) const; // Returns UINT_MAX if not found.
 
@@ -22,6 +22,7 @@
 
 #include "config.h"
 
+#include "AllocationProfiler.h"
 #include "ArrayBuffer.h"
 #include "ArrayPrototype.h"
 #include "BuiltinNames.h"
@@ -51,9 +52,11 @@
 #include "JSONObject.h"
 #include "JSSourceCode.h"
 #include "JSString.h"
+#include "JSToWasm.h"
 #include "JSTypedArrays.h"
 #include "JSWebAssemblyInstance.h"
 #include "JSWebAssemblyMemory.h"
+#include "JSWebAssemblyModule.h"
 #include "LLIntData.h"
 #include "LLIntThunks.h"
 #include "ObjectConstructor.h"
@@ -72,6 +75,8 @@
 #include "WasmContext.h"
 #include "WasmFaultSignalHandler.h"
 #include "WasmMemory.h"
+#include "WasmModuleSerialization.h"
+#include "WasmToJS.h"
 #include <locale.h>
 #include <math.h>
 #include <stdio.h>
@@ -304,11 +309,14 @@ static EncodedJSValue JSC_HOST_CALL functionLoadModule(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionCheckModuleSyntax(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionPlatformSupportsSamplingProfiler(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionGenerateHeapSnapshot(ExecState*);
+static EncodedJSValue JSC_HOST_CALL functionWriteHeapSnapshot(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionResetSuperSamplerState(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionEnsureArrayStorage(ExecState*);
 #if ENABLE(SAMPLING_PROFILER)
 static EncodedJSValue JSC_HOST_CALL functionStartSamplingProfiler(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionSamplingProfilerStackTraces(ExecState*);
+static EncodedJSValue JSC_HOST_CALL functionStartAllocationProfiler(ExecState*);
+static EncodedJSValue JSC_HOST_CALL functionAllocationProfilerCallTree(ExecState*);
 #endif
 
 static EncodedJSValue JSC_HOST_CALL functionMaxArguments(ExecState*);
@@ -317,6 +325,10 @@ static EncodedJSValue JSC_HOST_CALL functionAsyncTestPassed(ExecState*);
 
 #if ENABLE(WEBASSEMBLY)
 static EncodedJSValue JSC_HOST_CALL functionWebAssemblyMemoryMode(ExecState*);
+#if OS(UNIX)
+static EncodedJSValue JSC_HOST_CALL functionSerializeWebAssemblyModule(ExecState*);
+static EncodedJSValue JSC_HOST_CALL functionDeserializeWebAssemblyModule(ExecState*);
+#endif
 #endif
 
 #if ENABLE(SAMPLING_FLAGS)
@@ -340,6 +352,7 @@ static EncodedJSValue JSC_HOST_CALL functionDollarAgentGetReport(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionDollarAgentLeaving(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionWaitForReport(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionHeapCapacity(ExecState*);
+static EncodedJSValue JSC_HOST_CALL functionRegExpInterpreterFallbackCount(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionFlashHeapAccess(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionDisableRichSourceInfo(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionMallocInALoop(ExecState*);
@@ -544,11 +557,14 @@ protected:
 
         addFunction(vm, "platformSupportsSamplingProfiler", functionPlatformSupportsSamplingProfiler, 0);
         addFunction(vm, "generateHeapSnapshot", functionGenerateHeapSnapshot, 0);
+        addFunction(vm, "writeHeapSnapshot", functionWriteHeapSnapshot, 1);
         addFunction(vm, "resetSuperSamplerState", functionResetSuperSamplerState, 0);
         addFunction(vm, "ensureArrayStorage", functionEnsureArrayStorage, 0);
 #if ENABLE(SAMPLING_PROFILER)
         addFunction(vm, "startSamplingProfiler", functionStartSamplingProfiler, 0);
         addFunction(vm, "samplingProfilerStackTraces", functionSamplingProfilerStackTraces, 0);
+        addFunction(vm, "startAllocationProfiler", functionStartAllocationProfiler, 0);
+        addFunction(vm, "allocationProfilerCallTree", functionAllocationProfilerCallTree, 0);
 #endif
 
         addFunction(vm, "maxArguments", functionMaxArguments, 0);
@@ -558,6 +574,10 @@ protected:
 
 #if ENABLE(WEBASSEMBLY)
         addFunction(vm, "WebAssemblyMemoryMode", functionWebAssemblyMemoryMode, 1);
+#if OS(UNIX)
+        addFunction(vm, "serializeWebAssemblyModule", functionSerializeWebAssemblyModule, 2);
+        addFunction(vm, "deserializeWebAssemblyModule", functionDeserializeWebAssemblyModule, 1);
+#endif
 #endif
 
         if (!arguments.isEmpty()) {
@@ -597,6 +617,7 @@ protected:
         addFunction(vm, "waitForReport", functionWaitForReport, 0);
 
         addFunction(vm, "heapCapacity", functionHeapCapacity, 0);
+        addFunction(vm, "regExpInterpreterFallbackCount", functionRegExpInterpreterFallbackCount, 0);
         addFunction(vm, "flashHeapAccess", functionFlashHeapAccess, 0);
 
         addFunction(vm, "disableRichSourceInfo", functionDisableRichSourceInfo, 0);
@@ -640,6 +661,7 @@ const GlobalObjectMethodTable GlobalObject::s_globalObjectMethodTable = {
     nullptr, // moduleLoaderEvaluate
     nullptr, // promiseRejectionTracker
     nullptr, // defaultLanguage
+    nullptr, // compileStreaming
 };
 
 GlobalObject::GlobalObject(VM& vm, Structure* structure)
@@ -1726,6 +1748,12 @@ EncodedJSValue JSC_HOST_CALL functionHeapCapacity(ExecState* exec)
     return JSValue::encode(jsNumber(vm.heap.capacity()));
 }
 
+EncodedJSValue JSC_HOST_CALL functionRegExpInterpreterFallbackCount(ExecState* exec)
+{
+    VM& vm = exec->vm();
+    return JSValue::encode(jsNumber(vm.regExpInterpreterFallbackCount.load()));
+}
+
 EncodedJSValue JSC_HOST_CALL functionFlashHeapAccess(ExecState* exec)
 {
     VM& vm = exec->vm();
@@ -1964,6 +1992,28 @@ EncodedJSValue JSC_HOST_CALL functionGenerateHeapSnapshot(ExecState* exec)
     return result;
 }
 
+EncodedJSValue JSC_HOST_CALL functionWriteHeapSnapshot(ExecState* exec)
+{
+    VM& vm = exec->vm();
+    JSLockHolder lock(vm);
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    String path = exec->argument(0).toWTFString(exec);
+    RETURN_IF_EXCEPTION(scope, encodedJSValue());
+
+    HeapSnapshotBuilder snapshotBuilder(vm.ensureHeapProfiler());
+    snapshotBuilder.buildSnapshot();
+
+    // Snapshots of large heaps are streamed to the file, rather than built up as one string.
+    FILE* file = fopen(path.utf8().data(), "w");
+    if (!file)
+        return throwVMError(exec, scope, createError(exec, makeString("Could not open ", path)));
+    bool succeeded = snapshotBuilder.writeJSON(file, [] (const HeapSnapshotNode&) { return true; });
+    if (fclose(file) || !succeeded)
+        return throwVMError(exec, scope, createError(exec, makeString("Could not write ", path)));
+    return JSValue::encode(jsUndefined());
+}
+
 EncodedJSValue JSC_HOST_CALL functionResetSuperSamplerState(ExecState*)
 {
     resetSuperSamplerState();
@@ -2003,6 +2053,26 @@ EncodedJSValue JSC_HOST_CALL functionSamplingProfilerStackTraces(ExecState* exec
     scope.releaseAssertNoException();
     return result;
 }
+
+EncodedJSValue JSC_HOST_CALL functionStartAllocationProfiler(ExecState* exec)
+{
+    exec->vm().ensureAllocationProfiler();
+    return JSValue::encode(jsUndefined());
+}
+
+EncodedJSValue JSC_HOST_CALL functionAllocationProfilerCallTree(ExecState* exec)
+{
+    VM& vm = exec->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    if (!vm.allocationProfiler())
+        return JSValue::encode(throwException(exec, scope, createError(exec, ASCIILiteral("Allocation profiler was never started"))));
+
+    String jsonString = vm.allocationProfiler()->callTreeAsJSON();
+    EncodedJSValue result = JSValue::encode(JSONParse(exec, jsonString));
+    scope.releaseAssertNoException();
+    return result;
+}
 #endif // ENABLE(SAMPLING_PROFILER)
 
 EncodedJSValue JSC_HOST_CALL functionMaxArguments(ExecState*)
@@ -2049,6 +2119,43 @@ static EncodedJSValue JSC_HOST_CALL functionWebAssemblyMemoryMode(ExecState* exe
     return throwVMTypeError(exec, scope, ASCIILiteral("WebAssemblyMemoryMode expects either a WebAssembly.Memory or WebAssembly.Instance"));
 }
 
+#if OS(UNIX)
+static EncodedJSValue JSC_HOST_CALL functionSerializeWebAssemblyModule(ExecState* exec)
+{
+    VM& vm = exec->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    auto* module = jsDynamicCast<JSWebAssemblyModule*>(vm, exec->argument(0));
+    if (!module)
+        return throwVMTypeError(exec, scope, ASCIILiteral("serializeWebAssemblyModule expects a WebAssembly.Module"));
+    String path = exec->argument(1).toWTFString(exec);
+    RETURN_IF_EXCEPTION(scope, encodedJSValue());
+
+    // Only the code of modules that have been instantiated is serialized.
+    auto result = Wasm::writeSerializedModuleToFile(module->module(), path.utf8().data());
+    if (!result)
+        return throwVMError(exec, scope, createError(exec, result.error()));
+    return JSValue::encode(jsUndefined());
+}
+
+static EncodedJSValue JSC_HOST_CALL functionDeserializeWebAssemblyModule(ExecState* exec)
+{
+    VM& vm = exec->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    if (!Options::useWebAssembly())
+        return throwVMTypeError(exec, scope, ASCIILiteral("deserializeWebAssemblyModule should only be called if the useWebAssembly option is set"));
+
+    String path = exec->argument(0).toWTFString(exec);
+    RETURN_IF_EXCEPTION(scope, encodedJSValue());
+
+    JSGlobalObject* globalObject = exec->lexicalGlobalObject();
+    auto result = Wasm::readSerializedModuleFromFile(&vm.wasmContext, path.utf8().data(), &Wasm::createJSToWasmWrapper, &Wasm::wasmToJSException);
+    scope.release();
+    return JSValue::encode(JSWebAssemblyModule::createStub(vm, exec, globalObject->WebAssemblyModuleStructure(), WTFMove(result)));
+}
+#endif // OS(UNIX)
+
 #endif // ENABLE(WEBASSEBLY)
 
 // Use SEH for Release builds only to get rid of the crash report dialog
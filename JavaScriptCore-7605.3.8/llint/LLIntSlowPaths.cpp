@@ -533,7 +533,10 @@ LLINT_SLOW_PATH_DECL(stack_check)
 LLINT_SLOW_PATH_DECL(slow_path_new_object)
 {
     LLINT_BEGIN();
-    LLINT_RETURN(constructEmptyObject(exec, pc[3].u.objectAllocationProfile->structure()));
+    ObjectAllocationProfile* profile = pc[3].u.objectAllocationProfile;
+    JSObject* result = constructEmptyObject(exec, profile->structure());
+    profile->allocationSiteProfile().noteAllocation(result);
+    LLINT_RETURN(result);
 }
 
 LLINT_SLOW_PATH_DECL(slow_path_new_array)
@@ -63,7 +63,7 @@ public:
         return m_flags == rhs.m_flags;
     }
 
-    unsigned bits() { return m_flags; }
+    unsigned bits() const { return m_flags; }
 
 private:
     unsigned m_flags { 0 };
@@ -103,6 +103,10 @@ public:
     // providers cache their strings to make this efficient.
     StringView string() const { return m_sourceCode.view(); }
 
+    const UnlinkedSourceCode& source() const { return m_sourceCode; }
+    const String& name() const { return m_name; }
+    const SourceCodeFlags& flags() const { return m_flags; }
+
     bool operator==(const SourceCodeKey& other) const
     {
         return m_hash == other.m_hash
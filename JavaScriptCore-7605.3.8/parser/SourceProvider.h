@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include "CachedBytecode.h"
 #include "SourceOrigin.h"
 #include <wtf/RefCounted.h>
 #include <wtf/text/TextPosition.h>
@@ -77,6 +78,14 @@ namespace JSC {
         void setSourceURLDirective(const String& sourceURL) { m_sourceURLDirective = sourceURL; }
         void setSourceMappingURLDirective(const String& sourceMappingURL) { m_sourceMappingURLDirective = sourceMappingURL; }
 
+        // Embedders that keep their own storage next to the source (e.g. a network cache) can
+        // override these to supply serialized bytecode, and to receive it when the VM is torn
+        // down. The CodeCache validates whatever it is handed, so returning stale bytecode is
+        // safe, just wasteful.
+        virtual RefPtr<CachedBytecode> cachedBytecode() const { return nullptr; }
+        virtual bool wantsCachedBytecode() const { return false; }
+        virtual void cacheBytecode(Ref<CachedBytecode>&&) const { }
+
     private:
         JS_EXPORT_PRIVATE void getID();
 
@@ -94,6 +94,7 @@ namespace JSC {
         CString toUTF8() const;
         
         bool isNull() const { return !m_provider; }
+        SourceProvider* provider() const { return m_provider.get(); }
         int startOffset() const { return m_startOffset; }
         int endOffset() const { return m_endOffset; }
         int length() const { return m_endOffset - m_startOffset; }
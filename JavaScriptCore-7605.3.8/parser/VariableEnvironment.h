@@ -104,6 +104,7 @@ public:
     void markVariableAsCapturedIfDefined(const RefPtr<UniquedStringImpl>& identifier);
     void markVariableAsCaptured(const RefPtr<UniquedStringImpl>& identifier);
     void markAllVariablesAsCaptured();
+    bool isEverythingCaptured() const { return m_isEverythingCaptured; }
     bool hasCapturedVariables() const;
     bool captures(UniquedStringImpl* identifier) const;
     void markVariableAsImported(const RefPtr<UniquedStringImpl>& identifier);
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2018 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <wtf/MallocPtr.h>
+#include <wtf/RefCounted.h>
+#include <wtf/Ref.h>
+
+#if OS(UNIX)
+#include <sys/mman.h>
+#endif
+
+namespace JSC {
+
+// A self-contained blob produced by encodeCodeBlock(). It either owns a malloc'd buffer
+// or a read-only mapping of a cache file. UnlinkedFunctionExecutables decoded from it
+// keep it alive so that function bodies can be decoded lazily, straight out of the
+// mapping, the first time they are called.
+class CachedBytecode : public RefCounted<CachedBytecode> {
+    WTF_MAKE_NONCOPYABLE(CachedBytecode);
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    static Ref<CachedBytecode> create(MallocPtr<uint8_t>&& data, size_t size)
+    {
+        return adoptRef(*new CachedBytecode(WTFMove(data), size));
+    }
+
+#if OS(UNIX)
+    static Ref<CachedBytecode> createFromMappedFile(void* data, size_t size)
+    {
+        return adoptRef(*new CachedBytecode(data, size));
+    }
+#endif
+
+    ~CachedBytecode()
+    {
+#if OS(UNIX)
+        if (m_mappedData)
+            munmap(m_mappedData, m_size);
+#endif
+    }
+
+    const uint8_t* data() const
+    {
+        if (m_mappedData)
+            return static_cast<const uint8_t*>(m_mappedData);
+        return m_ownedData.get();
+    }
+    size_t size() const { return m_size; }
+
+private:
+    CachedBytecode(MallocPtr<uint8_t>&& data, size_t size)
+        : m_ownedData(WTFMove(data))
+        , m_size(size)
+    {
+    }
+
+    CachedBytecode(void* mappedData, size_t size)
+        : m_mappedData(mappedData)
+        , m_size(size)
+    {
+    }
+
+    MallocPtr<uint8_t> m_ownedData;
+    void* m_mappedData { nullptr };
+    size_t m_size;
+};
+
+} // namespace JSC
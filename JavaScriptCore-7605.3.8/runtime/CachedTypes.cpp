@@ -0,0 +1,1166 @@
+/*
+ * Copyright (C) 2018 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "CachedTypes.h"
+
+#include "BuiltinNames.h"
+#include "JSCInlines.h"
+#include "JSFixedArray.h"
+#include "JSTemplateRegistryKey.h"
+#include "SourceCodeKey.h"
+#include "SourceProvider.h"
+#include "SymbolTable.h"
+#include "TemplateRegistryKeyTable.h"
+#include "UnlinkedFunctionCodeBlock.h"
+#include "UnlinkedFunctionExecutable.h"
+#include "UnlinkedInstructionStream.h"
+#include "UnlinkedModuleProgramCodeBlock.h"
+#include "UnlinkedProgramCodeBlock.h"
+#include <mutex>
+#include <wtf/SHA1.h>
+#include <wtf/text/StringHasher.h>
+
+namespace JSC {
+
+// The encoding is a flat, position-independent byte stream in native byte order. It is only
+// ever read back by the exact same build of JSC, so the header carries a version derived from
+// the build, and PODs are copied verbatim.
+//
+// Function code blocks are written as length-prefixed sub-blobs that do not refer to anything
+// outside themselves. That lets the decoder skip over them and decode them on first call, and
+// lets the encoder copy a sub-blob that was never decoded straight into a new cache.
+
+static const uint32_t cachedBytecodeMagic = 0x4243534a; // "JSCB"
+
+enum class CachedRootKind : uint8_t {
+    ProgramCodeBlock,
+    ModuleProgramCodeBlock,
+    FunctionExecutable,
+};
+
+enum class CachedIdentifierKind : uint8_t {
+    Null,
+    String,
+    PrivateName,
+    WellKnownSymbol,
+};
+
+enum class CachedConstantKind : uint8_t {
+    Value,
+    String,
+    SymbolTable,
+    FixedArray,
+    TemplateRegistryKey,
+    IdentifierSet,
+    LinkTimeConstant,
+};
+
+static uint32_t cachedBytecodeVersion()
+{
+    static uint32_t version;
+    static std::once_flag onceFlag;
+    std::call_once(onceFlag, [] {
+        StringHasher hasher;
+        for (const char* character = __DATE__ " " __TIME__; *character; ++character)
+            hasher.addCharacter(*character);
+        hasher.addCharacter(static_cast<UChar>(numOpcodeIDs));
+        for (unsigned i = 0; i < numOpcodeIDs; ++i)
+            hasher.addCharacter(static_cast<UChar>(opcodeLengths[i]));
+        hasher.addCharacter(static_cast<UChar>(sizeof(ExpressionRangeInfo)));
+        hasher.addCharacter(static_cast<UChar>(sizeof(ExpressionRangeInfo::FatPosition)));
+        hasher.addCharacter(static_cast<UChar>(sizeof(VariableEnvironmentEntry)));
+        version = hasher.hashWithTop8BitsMasked();
+    });
+    return version;
+}
+
+static SHA1::Digest computeSourceHash(const SourceCodeKey& key)
+{
+    SHA1 sha1;
+    StringView source = key.string();
+    if (source.is8Bit())
+        sha1.addBytes(source.characters8(), source.length());
+    else
+        sha1.addBytes(reinterpret_cast<const uint8_t*>(source.characters16()), source.length() * sizeof(UChar));
+    SHA1::Digest digest;
+    sha1.computeHash(digest);
+    return digest;
+}
+
+class CachedBytecodeEncoder {
+public:
+    CachedBytecodeEncoder(VM& vm, const SourceCodeKey& key)
+        : m_vm(vm)
+        , m_sourceStartOffset(key.source().startOffset())
+    {
+    }
+
+    bool failed() const { return m_failed; }
+    Vector<uint8_t>& buffer() { return m_buffer; }
+
+    template<typename T>
+    void append(const T& value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Only PODs can be copied into the cache verbatim");
+        m_buffer.append(reinterpret_cast<const uint8_t*>(&value), sizeof(T));
+    }
+
+    template<typename T>
+    void appendVector(const T& vector)
+    {
+        static_assert(std::is_trivially_copyable<typename T::ValueType>::value, "Only PODs can be copied into the cache verbatim");
+        append<uint32_t>(vector.size());
+        m_buffer.append(reinterpret_cast<const uint8_t*>(vector.data()), vector.size() * sizeof(typename T::ValueType));
+    }
+
+    void encodeString(const String& string)
+    {
+        append<bool>(string.isNull());
+        if (string.isNull())
+            return;
+        append<bool>(string.is8Bit());
+        append<uint32_t>(string.length());
+        if (string.is8Bit())
+            m_buffer.append(string.characters8(), string.length());
+        else
+            m_buffer.append(reinterpret_cast<const uint8_t*>(string.characters16()), string.length() * sizeof(UChar));
+    }
+
+    void encodeIdentifier(UniquedStringImpl* uid)
+    {
+        if (!uid) {
+            append(CachedIdentifierKind::Null);
+            return;
+        }
+
+        if (!uid->isSymbol()) {
+            append(CachedIdentifierKind::String);
+            encodeString(String(uid));
+            return;
+        }
+
+        // Symbols only survive a round trip if they are one of the VM's builtin names.
+        const BuiltinNames& builtinNames = m_vm.propertyNames->builtinNames();
+        Identifier identifier = Identifier::fromUid(&m_vm, uid);
+        const Identifier& publicName = builtinNames.lookUpPublicName(identifier);
+        if (!publicName.isEmpty()) {
+            append(CachedIdentifierKind::PrivateName);
+            encodeString(publicName.string());
+            return;
+        }
+
+#define ENCODE_WELL_KNOWN_SYMBOL(name) \
+        if (uid == builtinNames.name##Symbol().impl()) { \
+            append(CachedIdentifierKind::WellKnownSymbol); \
+            encodeString(ASCIILiteral(#name)); \
+            return; \
+        }
+        JSC_COMMON_PRIVATE_IDENTIFIERS_EACH_WELL_KNOWN_SYMBOL(ENCODE_WELL_KNOWN_SYMBOL)
+#undef ENCODE_WELL_KNOWN_SYMBOL
+
+        fail();
+    }
+
+    void encodeIdentifier(const Identifier& identifier)
+    {
+        encodeIdentifier(identifier.impl());
+    }
+
+    void encodeVariableEnvironment(const VariableEnvironment& environment)
+    {
+        static_assert(sizeof(VariableEnvironmentEntry) == sizeof(uint16_t), "VariableEnvironmentEntry is copied as its bits");
+        append<bool>(environment.isEverythingCaptured());
+        append<uint32_t>(environment.size());
+        for (auto& entry : environment) {
+            encodeIdentifier(entry.key.get());
+            append(entry.value);
+        }
+    }
+
+    void encodeSymbolTable(SymbolTable* symbolTable)
+    {
+        append<uint8_t>(symbolTable->scopeType());
+        append<bool>(symbolTable->usesNonStrictEval());
+        append<bool>(symbolTable->isNestedLexicalScope());
+        append<uint32_t>(symbolTable->maxScopeOffset().offsetUnchecked());
+
+        {
+            ConcurrentJSLocker locker(symbolTable->m_lock);
+            append<uint32_t>(symbolTable->size(locker));
+            for (auto iter = symbolTable->begin(locker), end = symbolTable->end(locker); iter != end; ++iter) {
+                encodeIdentifier(iter->key.get());
+                VarOffset varOffset = iter->value.varOffset();
+                append(varOffset.kind());
+                append<uint32_t>(varOffset.rawOffset());
+                append<uint32_t>(iter->value.getAttributes());
+            }
+        }
+
+        ScopedArgumentsTable* arguments = symbolTable->arguments();
+        append<bool>(!!arguments);
+        if (arguments) {
+            append<uint32_t>(arguments->length());
+            for (uint32_t i = 0; i < arguments->length(); ++i)
+                append<uint32_t>(arguments->get(i).offsetUnchecked());
+        }
+    }
+
+    void encodeConstant(JSValue value)
+    {
+        if (!value.isCell()) {
+            append(CachedConstantKind::Value);
+            append<EncodedJSValue>(JSValue::encode(value));
+            return;
+        }
+
+        JSCell* cell = value.asCell();
+        if (cell->isString()) {
+            const StringImpl* impl = asString(cell)->tryGetValueImpl();
+            if (!impl) {
+                fail();
+                return;
+            }
+            append(CachedConstantKind::String);
+            encodeString(const_cast<StringImpl*>(impl));
+            return;
+        }
+
+        if (SymbolTable* symbolTable = jsDynamicCast<SymbolTable*>(m_vm, cell)) {
+            append(CachedConstantKind::SymbolTable);
+            encodeSymbolTable(symbolTable);
+            return;
+        }
+
+        if (JSFixedArray* array = jsDynamicCast<JSFixedArray*>(m_vm, cell)) {
+            append(CachedConstantKind::FixedArray);
+            append<uint32_t>(array->length());
+            for (unsigned i = 0; i < array->length(); ++i)
+                encodeConstant(array->get(i));
+            return;
+        }
+
+        if (JSTemplateRegistryKey* key = jsDynamicCast<JSTemplateRegistryKey*>(m_vm, cell)) {
+            const TemplateRegistryKey& templateKey = key->templateRegistryKey();
+            append(CachedConstantKind::TemplateRegistryKey);
+            append<uint32_t>(templateKey.rawStrings().size());
+            for (const String& rawString : templateKey.rawStrings())
+                encodeString(rawString);
+            append<uint32_t>(templateKey.cookedStrings().size());
+            for (const std::optional<String>& cookedString : templateKey.cookedStrings()) {
+                append<bool>(!!cookedString);
+                if (cookedString)
+                    encodeString(*cookedString);
+            }
+            return;
+        }
+
+        // BigInts and anything else we do not know how to rebuild.
+        fail();
+    }
+
+    void encodeCodeBlock(UnlinkedCodeBlock* codeBlock)
+    {
+        append(codeBlock->codeType());
+        append<bool>(codeBlock->usesEval());
+        append<bool>(codeBlock->isStrictMode());
+        append<bool>(codeBlock->isConstructor());
+        append<bool>(codeBlock->isBuiltinFunction());
+        append(codeBlock->constructorKind());
+        append(codeBlock->scriptMode());
+        append(codeBlock->superBinding());
+        append(codeBlock->parseMode());
+        append(codeBlock->derivedContextType());
+        append<bool>(codeBlock->isArrowFunctionContext());
+        append<bool>(codeBlock->isClassContext());
+        append(codeBlock->evalContextType());
+        append<bool>(codeBlock->wasCompiledWithDebuggingOpcodes());
+
+        append<int>(codeBlock->m_numVars);
+        append<int>(codeBlock->m_numCapturedVars);
+        append<int>(codeBlock->m_numCalleeLocals);
+        append<int>(codeBlock->m_numParameters);
+        append<int>(codeBlock->m_thisRegister.offset());
+        append<int>(codeBlock->m_scopeRegister.offset());
+        append<int>(codeBlock->m_globalObjectRegister.offset());
+        append<bool>(codeBlock->m_hasCapturedVariables);
+        append<bool>(codeBlock->m_hasTailCalls);
+        append<unsigned>(codeBlock->m_lineCount);
+        append<unsigned>(codeBlock->m_endColumn);
+        append(codeBlock->m_didOptimize);
+        append(codeBlock->m_features);
+        encodeString(codeBlock->m_sourceURLDirective);
+        encodeString(codeBlock->m_sourceMappingURLDirective);
+
+        const UnlinkedInstructionStream& instructions = codeBlock->instructions();
+        append<uint32_t>(instructions.count());
+        append<uint32_t>(instructions.m_data.size());
+        m_buffer.append(instructions.m_data.data(), instructions.m_data.size());
+
+        appendVector(codeBlock->m_jumpTargets);
+        appendVector(codeBlock->m_propertyAccessInstructions);
+
+        append<uint32_t>(codeBlock->m_identifiers.size());
+        for (const Identifier& identifier : codeBlock->m_identifiers)
+            encodeIdentifier(identifier);
+
+        append<uint32_t>(codeBlock->m_bitVectors.size());
+        for (const BitVector& bitVector : codeBlock->m_bitVectors) {
+            append<uint32_t>(bitVector.size());
+            for (size_t i = 0; i < bitVector.size(); i += 8) {
+                uint8_t byte = 0;
+                for (size_t bit = 0; bit < 8 && i + bit < bitVector.size(); ++bit)
+                    byte |= bitVector.quickGet(i + bit) << bit;
+                append(byte);
+            }
+        }
+
+        encodeConstants(codeBlock);
+
+        append<uint32_t>(codeBlock->m_arrayProfileCount);
+        append<uint32_t>(codeBlock->m_arrayAllocationProfileCount);
+        append<uint32_t>(codeBlock->m_objectAllocationProfileCount);
+        append<uint32_t>(codeBlock->m_valueProfileCount);
+        append<uint32_t>(codeBlock->m_llintCallLinkInfoCount);
+
+        append<uint32_t>(codeBlock->m_functionDecls.size());
+        for (auto& functionDecl : codeBlock->m_functionDecls)
+            encodeFunctionExecutable(functionDecl.get());
+        append<uint32_t>(codeBlock->m_functionExprs.size());
+        for (auto& functionExpr : codeBlock->m_functionExprs)
+            encodeFunctionExecutable(functionExpr.get());
+
+        appendVector(codeBlock->m_expressionInfo);
+
+        UnlinkedCodeBlock::RareData* rareData = codeBlock->m_rareData.get();
+        append<bool>(!!rareData);
+        if (rareData) {
+            append<uint32_t>(rareData->m_exceptionHandlers.size());
+            for (const UnlinkedHandlerInfo& handler : rareData->m_exceptionHandlers) {
+                append<uint32_t>(handler.start);
+                append<uint32_t>(handler.end);
+                append<uint32_t>(handler.target);
+                append(handler.type());
+            }
+
+            append<uint32_t>(rareData->m_regexps.size());
+            for (auto& regExp : rareData->m_regexps) {
+                encodeString(regExp->pattern());
+                append<uint8_t>(regExp->key().flagsValue);
+            }
+
+            append<uint32_t>(rareData->m_switchJumpTables.size());
+            for (const UnlinkedSimpleJumpTable& jumpTable : rareData->m_switchJumpTables) {
+                appendVector(jumpTable.branchOffsets);
+                append<int32_t>(jumpTable.min);
+            }
+
+            append<uint32_t>(rareData->m_stringSwitchJumpTables.size());
+            for (const UnlinkedStringJumpTable& jumpTable : rareData->m_stringSwitchJumpTables) {
+                append<uint32_t>(jumpTable.offsetTable.size());
+                for (auto& entry : jumpTable.offsetTable) {
+                    encodeString(entry.key.get());
+                    append<int32_t>(entry.value.branchOffset);
+                }
+            }
+
+            appendVector(rareData->m_expressionInfoFatPositions);
+
+            append<uint32_t>(rareData->m_typeProfilerInfoMap.size());
+            for (auto& entry : rareData->m_typeProfilerInfoMap) {
+                append<uint32_t>(entry.key);
+                append<uint32_t>(entry.value.m_startDivot);
+                append<uint32_t>(entry.value.m_endDivot);
+            }
+
+            appendVector(rareData->m_opProfileControlFlowBytecodeOffsets);
+        }
+
+        switch (codeBlock->codeType()) {
+        case GlobalCode: {
+            auto* programCodeBlock = jsCast<UnlinkedProgramCodeBlock*>(codeBlock);
+            encodeVariableEnvironment(programCodeBlock->variableDeclarations());
+            encodeVariableEnvironment(programCodeBlock->lexicalDeclarations());
+            break;
+        }
+        case ModuleCode:
+            append<int>(jsCast<UnlinkedModuleProgramCodeBlock*>(codeBlock)->moduleEnvironmentSymbolTableConstantRegisterOffset());
+            break;
+        case FunctionCode:
+            break;
+        case EvalCode:
+            fail();
+            break;
+        }
+    }
+
+    void encodeFunctionExecutable(UnlinkedFunctionExecutable* executable)
+    {
+        // Builtins and default class constructors are re-created from their own sources.
+        if (!executable->m_parentSourceOverride.isNull()) {
+            fail();
+            return;
+        }
+
+        append<uint32_t>(executable->m_firstLineOffset);
+        append<uint32_t>(executable->m_lineCount);
+        append<uint32_t>(executable->m_unlinkedFunctionNameStart);
+        append<uint32_t>(executable->m_unlinkedBodyStartColumn);
+        append<uint32_t>(executable->m_unlinkedBodyEndColumn);
+        append<uint32_t>(executable->m_startOffset);
+        append<uint32_t>(executable->m_sourceLength);
+        append<uint32_t>(executable->m_parametersStartOffset);
+        append<uint32_t>(executable->m_typeProfilingStartOffset);
+        append<uint32_t>(executable->m_typeProfilingEndOffset);
+        append<uint32_t>(executable->m_parameterCount);
+        append(executable->m_features);
+        append(executable->m_sourceParseMode);
+        append<uint8_t>(executable->m_isInStrictContext);
+        append<uint8_t>(executable->m_hasCapturedVariables);
+        append<uint8_t>(executable->m_isBuiltinFunction);
+        append<uint8_t>(executable->m_constructAbility);
+        append<uint8_t>(executable->m_constructorKind);
+        append<uint8_t>(executable->m_functionMode);
+        append<uint8_t>(executable->m_scriptMode);
+        append<uint8_t>(executable->m_superBinding);
+        append<uint8_t>(executable->m_derivedContextType);
+
+        encodeIdentifier(executable->m_name);
+        encodeIdentifier(executable->m_ecmaName);
+        encodeIdentifier(executable->m_inferredName);
+
+        // Only the text of the class source is ever used, so we record it relative to the
+        // start of the cached source and rebase it onto whichever provider loads it.
+        const SourceCode& classSource = executable->m_classSource;
+        append<bool>(classSource.isNull());
+        if (!classSource.isNull()) {
+            append<int>(classSource.startOffset() - m_sourceStartOffset);
+            append<int>(classSource.endOffset() - m_sourceStartOffset);
+            append<int>(classSource.firstLine().oneBasedInt());
+            append<int>(classSource.startColumn().oneBasedInt());
+        }
+
+        encodeString(executable->m_sourceURLDirective);
+        encodeString(executable->m_sourceMappingURLDirective);
+        encodeVariableEnvironment(executable->m_parentScopeTDZVariables);
+
+        encodeFunctionCodeBlock(executable, CodeForCall);
+        encodeFunctionCodeBlock(executable, CodeForConstruct);
+    }
+
+    void encodeFunctionCodeBlock(UnlinkedFunctionExecutable* executable, CodeSpecializationKind kind)
+    {
+        UnlinkedFunctionCodeBlock* codeBlock = kind == CodeForCall ? executable->m_unlinkedCodeBlockForCall.get() : executable->m_unlinkedCodeBlockForConstruct.get();
+        if (codeBlock) {
+            append<bool>(true);
+            size_t lengthOffset = m_buffer.size();
+            append<uint32_t>(0);
+            encodeCodeBlock(codeBlock);
+            uint32_t length = m_buffer.size() - lengthOffset - sizeof(uint32_t);
+            memcpy(m_buffer.data() + lengthOffset, &length, sizeof(uint32_t));
+            return;
+        }
+
+        // The function was decoded from a cache but never called. Its code block is still
+        // sitting in the old blob in exactly the form we would write it.
+        if (CachedFunctionCodeBlocks* cachedCodeBlocks = executable->m_cachedCodeBlocks.get()) {
+            if (unsigned offset = cachedCodeBlocks->offsetFor(kind)) {
+                const uint8_t* data = cachedCodeBlocks->bytecode->data() + offset;
+                uint32_t length;
+                memcpy(&length, data, sizeof(uint32_t));
+                append<bool>(true);
+                m_buffer.append(data, sizeof(uint32_t) + length);
+                return;
+            }
+        }
+
+        append<bool>(false);
+    }
+
+private:
+    void fail() { m_failed = true; }
+
+    void encodeConstants(UnlinkedCodeBlock* codeBlock)
+    {
+        HashMap<unsigned, unsigned, WTF::IntHash<unsigned>, WTF::UnsignedWithZeroKeyHashTraits<unsigned>> identifierSets;
+        for (unsigned i = 0; i < codeBlock->m_constantIdentifierSets.size(); ++i)
+            identifierSets.add(codeBlock->m_constantIdentifierSets[i].second, i);
+
+        append<uint32_t>(codeBlock->m_constantRegisters.size());
+        for (unsigned i = 0; i < codeBlock->m_constantRegisters.size(); ++i) {
+            append(codeBlock->m_constantsSourceCodeRepresentation[i]);
+
+            auto identifierSet = identifierSets.find(i);
+            if (identifierSet != identifierSets.end()) {
+                const IdentifierSet& set = codeBlock->m_constantIdentifierSets[identifierSet->value].first;
+                append(CachedConstantKind::IdentifierSet);
+                append<uint32_t>(set.size());
+                for (auto& uid : set)
+                    encodeIdentifier(uid.get());
+                continue;
+            }
+
+            bool isLinkTimeConstant = false;
+            for (unsigned type = 0; type < LinkTimeConstantCount; ++type) {
+                if (codeBlock->m_linkTimeConstants[type] && codeBlock->m_linkTimeConstants[type] == i) {
+                    append(CachedConstantKind::LinkTimeConstant);
+                    append<uint32_t>(type);
+                    isLinkTimeConstant = true;
+                    break;
+                }
+            }
+            if (isLinkTimeConstant)
+                continue;
+
+            encodeConstant(codeBlock->m_constantRegisters[i].get());
+        }
+    }
+
+    VM& m_vm;
+    int m_sourceStartOffset;
+    Vector<uint8_t> m_buffer;
+    bool m_failed { false };
+};
+
+class CachedBytecodeDecoder {
+public:
+    CachedBytecodeDecoder(VM& vm, Ref<CachedBytecode>&& bytecode, RefPtr<SourceProvider>&& provider, unsigned sourceStartOffset, size_t start = 0)
+        : m_vm(vm)
+        , m_bytecode(WTFMove(bytecode))
+        , m_provider(WTFMove(provider))
+        , m_sourceStartOffset(sourceStartOffset)
+        , m_cursor(m_bytecode->data() + start)
+        , m_end(m_bytecode->data() + m_bytecode->size())
+    {
+    }
+
+    bool failed() const { return m_failed; }
+    size_t offset() const { return m_cursor - m_bytecode->data(); }
+
+    template<typename T>
+    T read()
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Only PODs can be copied out of the cache verbatim");
+        T result { };
+        if (!canRead(sizeof(T)))
+            return result;
+        memcpy(&result, m_cursor, sizeof(T));
+        m_cursor += sizeof(T);
+        return result;
+    }
+
+    template<typename T>
+    void readVector(T& vector)
+    {
+        uint32_t size = read<uint32_t>();
+        size_t sizeInBytes = static_cast<size_t>(size) * sizeof(typename T::ValueType);
+        if (!canRead(sizeInBytes))
+            return;
+        vector.grow(size);
+        memcpy(vector.data(), m_cursor, sizeInBytes);
+        m_cursor += sizeInBytes;
+    }
+
+    String decodeString()
+    {
+        if (read<bool>())
+            return String();
+        bool is8Bit = read<bool>();
+        uint32_t length = read<uint32_t>();
+        size_t sizeInBytes = static_cast<size_t>(length) * (is8Bit ? sizeof(LChar) : sizeof(UChar));
+        if (!canRead(sizeInBytes))
+            return String();
+        String result;
+        if (is8Bit)
+            result = String(m_cursor, length);
+        else {
+            UChar* characters;
+            result = String::createUninitialized(length, characters);
+            memcpy(characters, m_cursor, sizeInBytes);
+        }
+        m_cursor += sizeInBytes;
+        return result;
+    }
+
+    Identifier decodeIdentifier()
+    {
+        switch (read<CachedIdentifierKind>()) {
+        case CachedIdentifierKind::Null:
+            return Identifier();
+        case CachedIdentifierKind::String: {
+            String string = decodeString();
+            if (string.isNull()) {
+                fail();
+                return Identifier();
+            }
+            return Identifier::fromString(&m_vm, string);
+        }
+        case CachedIdentifierKind::PrivateName: {
+            const BuiltinNames& builtinNames = m_vm.propertyNames->builtinNames();
+            Identifier publicName = Identifier::fromString(&m_vm, decodeString());
+            const Identifier* privateName = builtinNames.lookUpPrivateName(publicName);
+            if (!privateName || builtinNames.lookUpPublicName(*privateName) != publicName) {
+                fail();
+                return Identifier();
+            }
+            return *privateName;
+        }
+        case CachedIdentifierKind::WellKnownSymbol: {
+            const BuiltinNames& builtinNames = m_vm.propertyNames->builtinNames();
+            String name = decodeString();
+#define DECODE_WELL_KNOWN_SYMBOL(symbolName) \
+            if (name == #symbolName) \
+                return builtinNames.symbolName##Symbol();
+            JSC_COMMON_PRIVATE_IDENTIFIERS_EACH_WELL_KNOWN_SYMBOL(DECODE_WELL_KNOWN_SYMBOL)
+#undef DECODE_WELL_KNOWN_SYMBOL
+            break;
+        }
+        }
+        fail();
+        return Identifier();
+    }
+
+    void decodeVariableEnvironment(VariableEnvironment& environment)
+    {
+        bool isEverythingCaptured = read<bool>();
+        uint32_t size = read<uint32_t>();
+        for (uint32_t i = 0; i < size && !m_failed; ++i) {
+            Identifier identifier = decodeIdentifier();
+            VariableEnvironmentEntry entry = read<VariableEnvironmentEntry>();
+            if (identifier.isNull()) {
+                fail();
+                return;
+            }
+            environment.add(identifier).iterator->value = entry;
+        }
+        if (isEverythingCaptured)
+            environment.markAllVariablesAsCaptured();
+    }
+
+    SymbolTable* decodeSymbolTable()
+    {
+        SymbolTable* symbolTable = SymbolTable::create(m_vm);
+        auto scopeType = static_cast<SymbolTable::ScopeType>(read<uint8_t>());
+        symbolTable->setScopeType(scopeType);
+        symbolTable->setUsesNonStrictEval(read<bool>());
+        if (read<bool>() && scopeType == SymbolTable::LexicalScope)
+            symbolTable->markIsNestedLexicalScope();
+        ScopeOffset maxScopeOffset(read<uint32_t>());
+
+        uint32_t size = read<uint32_t>();
+        for (uint32_t i = 0; i < size && !m_failed; ++i) {
+            Identifier identifier = decodeIdentifier();
+            VarKind kind = read<VarKind>();
+            uint32_t rawOffset = read<uint32_t>();
+            unsigned attributes = read<uint32_t>();
+            if (identifier.isNull()) {
+                fail();
+                return nullptr;
+            }
+            symbolTable->add(identifier.impl(), SymbolTableEntry(VarOffset::assemble(kind, rawOffset), attributes));
+        }
+        if (!!maxScopeOffset)
+            symbolTable->didUseScopeOffset(maxScopeOffset);
+
+        if (read<bool>()) {
+            uint32_t length = read<uint32_t>();
+            if (!canRead(static_cast<size_t>(length) * sizeof(uint32_t)))
+                return nullptr;
+            symbolTable->setArgumentsLength(m_vm, length);
+            for (uint32_t i = 0; i < length; ++i)
+                symbolTable->setArgumentOffset(m_vm, i, ScopeOffset(read<uint32_t>()));
+        }
+        return symbolTable;
+    }
+
+    JSValue decodeConstant(CachedConstantKind kind)
+    {
+        switch (kind) {
+        case CachedConstantKind::Value: {
+            JSValue value = JSValue::decode(read<EncodedJSValue>());
+            if (value.isCell()) {
+                fail();
+                return JSValue();
+            }
+            return value;
+        }
+        case CachedConstantKind::String: {
+            String string = decodeString();
+            if (string.isNull()) {
+                fail();
+                return JSValue();
+            }
+            return jsString(&m_vm, string);
+        }
+        case CachedConstantKind::SymbolTable:
+            return decodeSymbolTable();
+        case CachedConstantKind::FixedArray: {
+            uint32_t length = read<uint32_t>();
+            if (!canRead(length))
+                return JSValue();
+            JSFixedArray* array = JSFixedArray::create(m_vm, length);
+            for (uint32_t i = 0; i < length && !m_failed; ++i)
+                array->set(m_vm, i, decodeConstant(read<CachedConstantKind>()));
+            return array;
+        }
+        case CachedConstantKind::TemplateRegistryKey: {
+            TemplateRegistryKey::StringVector rawStrings;
+            uint32_t rawStringCount = read<uint32_t>();
+            for (uint32_t i = 0; i < rawStringCount && !m_failed; ++i)
+                rawStrings.append(decodeString());
+            TemplateRegistryKey::OptionalStringVector cookedStrings;
+            uint32_t cookedStringCount = read<uint32_t>();
+            for (uint32_t i = 0; i < cookedStringCount && !m_failed; ++i) {
+                if (read<bool>())
+                    cookedStrings.append(decodeString());
+                else
+                    cookedStrings.append(std::nullopt);
+            }
+            if (m_failed)
+                return JSValue();
+            return JSTemplateRegistryKey::create(m_vm, m_vm.templateRegistryKeyTable().createKey(WTFMove(rawStrings), WTFMove(cookedStrings)));
+        }
+        case CachedConstantKind::IdentifierSet:
+        case CachedConstantKind::LinkTimeConstant:
+            break;
+        }
+        fail();
+        return JSValue();
+    }
+
+    template<typename CodeBlockType>
+    CodeBlockType* decodeCodeBlock()
+    {
+        CodeType codeType = read<CodeType>();
+        bool usesEval = read<bool>();
+        bool isStrictMode = read<bool>();
+        bool isConstructor = read<bool>();
+        bool isBuiltinFunction = read<bool>();
+        ConstructorKind constructorKind = read<ConstructorKind>();
+        JSParserScriptMode scriptMode = read<JSParserScriptMode>();
+        SuperBinding superBinding = read<SuperBinding>();
+        SourceParseMode parseMode = read<SourceParseMode>();
+        DerivedContextType derivedContextType = read<DerivedContextType>();
+        bool isArrowFunctionContext = read<bool>();
+        bool isClassContext = read<bool>();
+        EvalContextType evalContextType = read<EvalContextType>();
+        DebuggerMode debuggerMode = read<bool>() ? DebuggerOn : DebuggerOff;
+        if (m_failed)
+            return nullptr;
+
+        ExecutableInfo info(usesEval, isStrictMode, isConstructor, isBuiltinFunction, constructorKind, scriptMode, superBinding, parseMode, derivedContextType, isArrowFunctionContext, isClassContext, evalContextType);
+        CodeBlockType* codeBlock = createCodeBlock<CodeBlockType>(codeType, info, debuggerMode);
+        if (!codeBlock) {
+            fail();
+            return nullptr;
+        }
+
+        codeBlock->m_numVars = read<int>();
+        codeBlock->m_numCapturedVars = read<int>();
+        codeBlock->m_numCalleeLocals = read<int>();
+        codeBlock->m_numParameters = read<int>();
+        codeBlock->m_thisRegister = VirtualRegister(read<int>());
+        codeBlock->m_scopeRegister = VirtualRegister(read<int>());
+        codeBlock->m_globalObjectRegister = VirtualRegister(read<int>());
+        codeBlock->m_hasCapturedVariables = read<bool>();
+        codeBlock->m_hasTailCalls = read<bool>();
+        codeBlock->m_lineCount = read<unsigned>();
+        codeBlock->m_endColumn = read<unsigned>();
+        codeBlock->m_didOptimize = read<TriState>();
+        codeBlock->m_features = read<CodeFeatures>();
+        codeBlock->m_sourceURLDirective = decodeString();
+        codeBlock->m_sourceMappingURLDirective = decodeString();
+
+        unsigned instructionCount = read<uint32_t>();
+        uint32_t instructionsSize = read<uint32_t>();
+        if (!canRead(instructionsSize))
+            return nullptr;
+        RefCountedArray<unsigned char> instructions(instructionsSize);
+        memcpy(instructions.data(), m_cursor, instructionsSize);
+        m_cursor += instructionsSize;
+        codeBlock->setInstructions(std::make_unique<UnlinkedInstructionStream>(WTFMove(instructions), instructionCount));
+
+        readVector(codeBlock->m_jumpTargets);
+        readVector(codeBlock->m_propertyAccessInstructions);
+
+        uint32_t identifierCount = read<uint32_t>();
+        for (uint32_t i = 0; i < identifierCount && !m_failed; ++i)
+            codeBlock->addIdentifier(decodeIdentifier());
+
+        uint32_t bitVectorCount = read<uint32_t>();
+        for (uint32_t i = 0; i < bitVectorCount && !m_failed; ++i) {
+            uint32_t size = read<uint32_t>();
+            if (!canRead((size + 7) / 8))
+                break;
+            BitVector bitVector(size);
+            for (uint32_t bit = 0; bit < size; bit += 8) {
+                uint8_t byte = read<uint8_t>();
+                for (uint32_t j = 0; j < 8 && bit + j < size; ++j) {
+                    if (byte & (1 << j))
+                        bitVector.quickSet(bit + j);
+                }
+            }
+            codeBlock->addBitVector(WTFMove(bitVector));
+        }
+
+        decodeConstants(codeBlock);
+
+        codeBlock->m_arrayProfileCount = read<uint32_t>();
+        codeBlock->m_arrayAllocationProfileCount = read<uint32_t>();
+        codeBlock->m_objectAllocationProfileCount = read<uint32_t>();
+        codeBlock->m_valueProfileCount = read<uint32_t>();
+        codeBlock->m_llintCallLinkInfoCount = read<uint32_t>();
+
+        uint32_t functionDeclCount = read<uint32_t>();
+        for (uint32_t i = 0; i < functionDeclCount && !m_failed; ++i) {
+            if (UnlinkedFunctionExecutable* executable = decodeFunctionExecutable())
+                codeBlock->addFunctionDecl(executable);
+        }
+        uint32_t functionExprCount = read<uint32_t>();
+        for (uint32_t i = 0; i < functionExprCount && !m_failed; ++i) {
+            if (UnlinkedFunctionExecutable* executable = decodeFunctionExecutable())
+                codeBlock->addFunctionExpr(executable);
+        }
+
+        readVector(codeBlock->m_expressionInfo);
+
+        if (read<bool>()) {
+            codeBlock->createRareDataIfNecessary();
+            UnlinkedCodeBlock::RareData& rareData = *codeBlock->m_rareData;
+
+            uint32_t handlerCount = read<uint32_t>();
+            for (uint32_t i = 0; i < handlerCount && !m_failed; ++i) {
+                uint32_t start = read<uint32_t>();
+                uint32_t end = read<uint32_t>();
+                uint32_t target = read<uint32_t>();
+                HandlerType type = read<HandlerType>();
+                rareData.m_exceptionHandlers.append(UnlinkedHandlerInfo(start, end, target, type));
+            }
+
+            uint32_t regExpCount = read<uint32_t>();
+            for (uint32_t i = 0; i < regExpCount && !m_failed; ++i) {
+                String pattern = decodeString();
+                RegExpFlags flags = static_cast<RegExpFlags>(read<uint8_t>());
+                if (m_failed || pattern.isNull()) {
+                    fail();
+                    break;
+                }
+                codeBlock->addRegExp(RegExp::create(m_vm, pattern, flags));
+            }
+
+            uint32_t switchJumpTableCount = read<uint32_t>();
+            for (uint32_t i = 0; i < switchJumpTableCount && !m_failed; ++i) {
+                UnlinkedSimpleJumpTable& jumpTable = codeBlock->addSwitchJumpTable();
+                readVector(jumpTable.branchOffsets);
+                jumpTable.min = read<int32_t>();
+            }
+
+            uint32_t stringSwitchJumpTableCount = read<uint32_t>();
+            for (uint32_t i = 0; i < stringSwitchJumpTableCount && !m_failed; ++i) {
+                UnlinkedStringJumpTable& jumpTable = codeBlock->addStringSwitchJumpTable();
+                uint32_t entryCount = read<uint32_t>();
+                for (uint32_t j = 0; j < entryCount && !m_failed; ++j) {
+                    String key = decodeString();
+                    int32_t branchOffset = read<int32_t>();
+                    if (key.isNull()) {
+                        fail();
+                        break;
+                    }
+                    jumpTable.offsetTable.add(key.impl(), UnlinkedStringJumpTable::OffsetLocation { branchOffset });
+                }
+            }
+
+            readVector(rareData.m_expressionInfoFatPositions);
+
+            uint32_t typeProfilerInfoCount = read<uint32_t>();
+            for (uint32_t i = 0; i < typeProfilerInfoCount && !m_failed; ++i) {
+                unsigned instructionOffset = read<uint32_t>();
+                unsigned startDivot = read<uint32_t>();
+                unsigned endDivot = read<uint32_t>();
+                rareData.m_typeProfilerInfoMap.set(instructionOffset, UnlinkedCodeBlock::RareData::TypeProfilerExpressionRange { startDivot, endDivot });
+            }
+
+            readVector(rareData.m_opProfileControlFlowBytecodeOffsets);
+        }
+
+        decodeCodeBlockExtras(codeBlock);
+
+        if (m_failed)
+            return nullptr;
+        return codeBlock;
+    }
+
+    UnlinkedFunctionExecutable* decodeFunctionExecutable()
+    {
+        UnlinkedFunctionExecutable* executable = new (NotNull, allocateCell<UnlinkedFunctionExecutable>(m_vm.heap)) UnlinkedFunctionExecutable(&m_vm, m_vm.unlinkedFunctionExecutableStructure.get());
+        executable->finishCreation(m_vm);
+
+        executable->m_firstLineOffset = read<uint32_t>();
+        executable->m_lineCount = read<uint32_t>();
+        executable->m_unlinkedFunctionNameStart = read<uint32_t>();
+        executable->m_unlinkedBodyStartColumn = read<uint32_t>();
+        executable->m_unlinkedBodyEndColumn = read<uint32_t>();
+        executable->m_startOffset = read<uint32_t>();
+        executable->m_sourceLength = read<uint32_t>();
+        executable->m_parametersStartOffset = read<uint32_t>();
+        executable->m_typeProfilingStartOffset = read<uint32_t>();
+        executable->m_typeProfilingEndOffset = read<uint32_t>();
+        executable->m_parameterCount = read<uint32_t>();
+        executable->m_features = read<CodeFeatures>();
+        executable->m_sourceParseMode = read<SourceParseMode>();
+        executable->m_isInStrictContext = read<uint8_t>();
+        executable->m_hasCapturedVariables = read<uint8_t>();
+        executable->m_isBuiltinFunction = read<uint8_t>();
+        executable->m_constructAbility = read<uint8_t>();
+        executable->m_constructorKind = read<uint8_t>();
+        executable->m_functionMode = read<uint8_t>();
+        executable->m_scriptMode = read<uint8_t>();
+        executable->m_superBinding = read<uint8_t>();
+        executable->m_derivedContextType = read<uint8_t>();
+
+        executable->m_name = decodeIdentifier();
+        executable->m_ecmaName = decodeIdentifier();
+        executable->m_inferredName = decodeIdentifier();
+
+        if (!read<bool>()) {
+            int startOffset = read<int>() + m_sourceStartOffset;
+            int endOffset = read<int>() + m_sourceStartOffset;
+            int firstLine = read<int>();
+            int startColumn = read<int>();
+            if (!m_provider || startOffset < 0 || endOffset < startOffset || static_cast<unsigned>(endOffset) > m_provider->source().length()) {
+                fail();
+                return nullptr;
+            }
+            executable->m_classSource = SourceCode(RefPtr<SourceProvider>(m_provider), startOffset, endOffset, firstLine, startColumn);
+        }
+
+        executable->m_sourceURLDirective = decodeString();
+        executable->m_sourceMappingURLDirective = decodeString();
+        decodeVariableEnvironment(executable->m_parentScopeTDZVariables);
+
+        unsigned codeBlockForCallOffset = skipFunctionCodeBlock();
+        unsigned codeBlockForConstructOffset = skipFunctionCodeBlock();
+        if (m_failed)
+            return nullptr;
+
+        if (codeBlockForCallOffset || codeBlockForConstructOffset) {
+            executable->m_cachedCodeBlocks = std::make_unique<CachedFunctionCodeBlocks>(m_bytecode.copyRef(), RefPtr<SourceProvider>(m_provider), m_sourceStartOffset);
+            executable->m_cachedCodeBlocks->codeBlockForCallOffset = codeBlockForCallOffset;
+            executable->m_cachedCodeBlocks->codeBlockForConstructOffset = codeBlockForConstructOffset;
+        }
+        return executable;
+    }
+
+    bool canRead(size_t size)
+    {
+        if (m_failed || static_cast<size_t>(m_end - m_cursor) < size) {
+            fail();
+            return false;
+        }
+        return true;
+    }
+
+    void fail() { m_failed = true; }
+
+private:
+    template<typename CodeBlockType>
+    CodeBlockType* createCodeBlock(CodeType, const ExecutableInfo&, DebuggerMode);
+
+    void decodeCodeBlockExtras(UnlinkedCodeBlock* codeBlock)
+    {
+        switch (codeBlock->codeType()) {
+        case GlobalCode: {
+            VariableEnvironment variableDeclarations;
+            VariableEnvironment lexicalDeclarations;
+            decodeVariableEnvironment(variableDeclarations);
+            decodeVariableEnvironment(lexicalDeclarations);
+            auto* programCodeBlock = jsCast<UnlinkedProgramCodeBlock*>(codeBlock);
+            programCodeBlock->setVariableDeclarations(variableDeclarations);
+            programCodeBlock->setLexicalDeclarations(lexicalDeclarations);
+            break;
+        }
+        case ModuleCode:
+            jsCast<UnlinkedModuleProgramCodeBlock*>(codeBlock)->setModuleEnvironmentSymbolTableConstantRegisterOffset(read<int>());
+            break;
+        case FunctionCode:
+            break;
+        case EvalCode:
+            fail();
+            break;
+        }
+    }
+
+    void decodeConstants(UnlinkedCodeBlock* codeBlock)
+    {
+        uint32_t constantCount = read<uint32_t>();
+        for (uint32_t i = 0; i < constantCount && !m_failed; ++i) {
+            SourceCodeRepresentation sourceCodeRepresentation = read<SourceCodeRepresentation>();
+            CachedConstantKind kind = read<CachedConstantKind>();
+            switch (kind) {
+            case CachedConstantKind::IdentifierSet: {
+                IdentifierSet set;
+                uint32_t size = read<uint32_t>();
+                for (uint32_t j = 0; j < size && !m_failed; ++j)
+                    set.add(decodeIdentifier().impl());
+                codeBlock->addSetConstant(set);
+                break;
+            }
+            case CachedConstantKind::LinkTimeConstant: {
+                uint32_t type = read<uint32_t>();
+                if (type >= LinkTimeConstantCount || !i) {
+                    fail();
+                    break;
+                }
+                codeBlock->addConstant(static_cast<LinkTimeConstant>(type));
+                break;
+            }
+            default:
+                codeBlock->addConstant(decodeConstant(kind), sourceCodeRepresentation);
+                break;
+            }
+        }
+    }
+
+    // Returns the offset of the code block's length prefix, or zero if there is none.
+    unsigned skipFunctionCodeBlock()
+    {
+        if (!read<bool>())
+            return 0;
+        unsigned offset = this->offset();
+        uint32_t length = read<uint32_t>();
+        if (!canRead(length))
+            return 0;
+        m_cursor += length;
+        return offset;
+    }
+
+    VM& m_vm;
+    Ref<CachedBytecode> m_bytecode;
+    RefPtr<SourceProvider> m_provider;
+    int m_sourceStartOffset;
+    const uint8_t* m_cursor;
+    const uint8_t* m_end;
+    bool m_failed { false };
+};
+
+template<>
+UnlinkedProgramCodeBlock* CachedBytecodeDecoder::createCodeBlock<UnlinkedProgramCodeBlock>(CodeType codeType, const ExecutableInfo& info, DebuggerMode debuggerMode)
+{
+    if (codeType != GlobalCode)
+        return nullptr;
+    return UnlinkedProgramCodeBlock::create(&m_vm, info, debuggerMode);
+}
+
+template<>
+UnlinkedModuleProgramCodeBlock* CachedBytecodeDecoder::createCodeBlock<UnlinkedModuleProgramCodeBlock>(CodeType codeType, const ExecutableInfo& info, DebuggerMode debuggerMode)
+{
+    if (codeType != ModuleCode)
+        return nullptr;
+    return UnlinkedModuleProgramCodeBlock::create(&m_vm, info, debuggerMode);
+}
+
+template<>
+UnlinkedFunctionCodeBlock* CachedBytecodeDecoder::createCodeBlock<UnlinkedFunctionCodeBlock>(CodeType codeType, const ExecutableInfo& info, DebuggerMode debuggerMode)
+{
+    if (codeType != FunctionCode)
+        return nullptr;
+    return UnlinkedFunctionCodeBlock::create(&m_vm, FunctionCode, info, debuggerMode);
+}
+
+RefPtr<CachedBytecode> encodeCodeBlock(VM& vm, const SourceCodeKey& key, JSCell* cell)
+{
+    CachedBytecodeEncoder encoder(vm, key);
+    encoder.append(cachedBytecodeMagic);
+    encoder.append(cachedBytecodeVersion());
+    encoder.append(key.flags().bits());
+    encoder.append<uint32_t>(key.length());
+    encoder.append(computeSourceHash(key));
+    encoder.encodeString(key.name());
+
+    if (auto* programCodeBlock = jsDynamicCast<UnlinkedProgramCodeBlock*>(vm, cell)) {
+        encoder.append(CachedRootKind::ProgramCodeBlock);
+        encoder.encodeCodeBlock(programCodeBlock);
+    } else if (auto* moduleProgramCodeBlock = jsDynamicCast<UnlinkedModuleProgramCodeBlock*>(vm, cell)) {
+        encoder.append(CachedRootKind::ModuleProgramCodeBlock);
+        encoder.encodeCodeBlock(moduleProgramCodeBlock);
+    } else if (auto* executable = jsDynamicCast<UnlinkedFunctionExecutable*>(vm, cell)) {
+        encoder.append(CachedRootKind::FunctionExecutable);
+        encoder.encodeFunctionExecutable(executable);
+    } else
+        return nullptr;
+
+    if (encoder.failed())
+        return nullptr;
+
+    Vector<uint8_t>& buffer = encoder.buffer();
+    auto data = MallocPtr<uint8_t>::malloc(buffer.size());
+    memcpy(data.get(), buffer.data(), buffer.size());
+    return CachedBytecode::create(WTFMove(data), buffer.size());
+}
+
+JSCell* decodeCodeBlock(VM& vm, const SourceCodeKey& key, Ref<CachedBytecode>&& bytecode)
+{
+    DeferGC deferGC(vm.heap);
+    CachedBytecodeDecoder decoder(vm, WTFMove(bytecode), RefPtr<SourceProvider>(key.source().provider()), key.source().startOffset());
+
+    if (decoder.read<uint32_t>() != cachedBytecodeMagic
+        || decoder.read<uint32_t>() != cachedBytecodeVersion()
+        || decoder.read<unsigned>() != key.flags().bits()
+        || decoder.read<uint32_t>() != key.length())
+        return nullptr;
+    if (decoder.read<SHA1::Digest>() != computeSourceHash(key))
+        return nullptr;
+    if (decoder.decodeString() != key.name() || decoder.failed())
+        return nullptr;
+
+    switch (decoder.read<CachedRootKind>()) {
+    case CachedRootKind::ProgramCodeBlock:
+        return decoder.decodeCodeBlock<UnlinkedProgramCodeBlock>();
+    case CachedRootKind::ModuleProgramCodeBlock:
+        return decoder.decodeCodeBlock<UnlinkedModuleProgramCodeBlock>();
+    case CachedRootKind::FunctionExecutable: {
+        UnlinkedFunctionExecutable* executable = decoder.decodeFunctionExecutable();
+        if (decoder.failed())
+            return nullptr;
+        return executable;
+    }
+    }
+    return nullptr;
+}
+
+UnlinkedFunctionCodeBlock* decodeFunctionCodeBlock(VM& vm, CachedFunctionCodeBlocks& cachedCodeBlocks, CodeSpecializationKind kind)
+{
+    unsigned offset = cachedCodeBlocks.offsetFor(kind);
+    if (!offset)
+        return nullptr;
+
+    DeferGC deferGC(vm.heap);
+
+    // Skip the length prefix; it was validated when the executable was decoded.
+    CachedBytecodeDecoder decoder(vm, cachedCodeBlocks.bytecode.copyRef(), RefPtr<SourceProvider>(cachedCodeBlocks.provider), cachedCodeBlocks.sourceStartOffset, offset + sizeof(uint32_t));
+    return decoder.decodeCodeBlock<UnlinkedFunctionCodeBlock>();
+}
+
+} // namespace JSC
@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2018 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "CachedBytecode.h"
+#include "CodeSpecializationKind.h"
+#include <wtf/RefPtr.h>
+
+namespace JSC {
+
+class JSCell;
+class SourceCodeKey;
+class SourceProvider;
+class UnlinkedFunctionCodeBlock;
+class VM;
+
+// Records where an UnlinkedFunctionExecutable's code blocks live inside the CachedBytecode
+// it was decoded from. They are only decoded when the function is first called.
+struct CachedFunctionCodeBlocks {
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    CachedFunctionCodeBlocks(Ref<CachedBytecode>&& bytecode, RefPtr<SourceProvider>&& provider, unsigned sourceStartOffset)
+        : bytecode(WTFMove(bytecode))
+        , provider(WTFMove(provider))
+        , sourceStartOffset(sourceStartOffset)
+    {
+    }
+
+    unsigned& offsetFor(CodeSpecializationKind kind)
+    {
+        return kind == CodeForCall ? codeBlockForCallOffset : codeBlockForConstructOffset;
+    }
+
+    Ref<CachedBytecode> bytecode;
+    RefPtr<SourceProvider> provider;
+    unsigned sourceStartOffset;
+    // Zero means there is no cached code block for that specialization.
+    unsigned codeBlockForCallOffset { 0 };
+    unsigned codeBlockForConstructOffset { 0 };
+};
+
+// Returns nullptr if the cell graph contains something that cannot be serialized. Callers
+// should treat that as "do not cache" rather than as an error.
+RefPtr<CachedBytecode> encodeCodeBlock(VM&, const SourceCodeKey&, JSCell*);
+
+// Returns nullptr if the bytecode was produced by a different build of JSC, or for a
+// different source or set of SourceCodeFlags than the key describes.
+JSCell* decodeCodeBlock(VM&, const SourceCodeKey&, Ref<CachedBytecode>&&);
+
+UnlinkedFunctionCodeBlock* decodeFunctionCodeBlock(VM&, CachedFunctionCodeBlocks&, CodeSpecializationKind);
+
+} // namespace JSC
@@ -26,12 +26,122 @@
 #include "config.h"
 #include "CodeCache.h"
 
+#include "CachedTypes.h"
 #include "IndirectEvalExecutable.h"
 
+#if OS(UNIX)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace JSC {
 
 const double CodeCacheMap::workingSetTime = 10.0;
 
+static bool canUseBytecodeCache(VM& vm)
+{
+    // The profilers and function overrides change the bytecode we would generate in ways
+    // the cached bytecode cannot account for.
+    return Options::useCodeCache()
+        && !vm.typeProfiler()
+        && !vm.controlFlowProfiler()
+        && !Options::functionOverrides();
+}
+
+#if OS(UNIX)
+static CString bytecodeCacheFilePath(const SourceCodeKey& key)
+{
+    // Colliding keys just overwrite each other's files; the contents are validated on load.
+    return String::format("%s/%08x-%08zx.jsbc", Options::diskCachePath(), key.hash(), key.length()).utf8();
+}
+
+static RefPtr<CachedBytecode> readBytecodeCacheFile(const SourceCodeKey& key)
+{
+    int fd = open(bytecodeCacheFilePath(key).data(), O_RDONLY);
+    if (fd == -1)
+        return nullptr;
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) || fileStat.st_size <= 0) {
+        close(fd);
+        return nullptr;
+    }
+
+    size_t size = static_cast<size_t>(fileStat.st_size);
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+        return nullptr;
+    return CachedBytecode::createFromMappedFile(data, size);
+}
+
+static void writeBytecodeCacheFile(const SourceCodeKey& key, const CachedBytecode& bytecode)
+{
+    // Write to a private file and rename it into place, so that concurrent readers either see
+    // the old file or the complete new one.
+    CString path = bytecodeCacheFilePath(key);
+    CString temporaryPath = String::format("%s.%d", path.data(), getpid()).utf8();
+    FILE* file = fopen(temporaryPath.data(), "wb");
+    if (!file)
+        return;
+    bool succeeded = fwrite(bytecode.data(), 1, bytecode.size(), file) == bytecode.size();
+    succeeded = !fclose(file) && succeeded;
+    if (!succeeded || rename(temporaryPath.data(), path.data()))
+        unlink(temporaryPath.data());
+}
+#endif
+
+SourceCodeValue* CodeCacheMap::fetchFromBytecodeCache(VM& vm, const SourceCodeKey& key)
+{
+    if (!canUseBytecodeCache(vm))
+        return nullptr;
+
+    SourceProvider* provider = key.source().provider();
+    RefPtr<CachedBytecode> bytecode = provider->cachedBytecode();
+#if OS(UNIX)
+    if (!bytecode && Options::diskCachePath())
+        bytecode = readBytecodeCacheFile(key);
+#endif
+    if (!bytecode)
+        return nullptr;
+
+    size_t size = bytecode->size();
+    JSCell* cell = decodeCodeBlock(vm, key, bytecode.releaseNonNull());
+    if (!cell)
+        return nullptr;
+
+    AddResult addResult = addCache(key, SourceCodeValue(vm, cell, age(), size));
+    return &addResult.iterator->value;
+}
+
+void CodeCacheMap::writeToBytecodeCache(VM& vm)
+{
+    if (!canUseBytecodeCache(vm))
+        return;
+
+    for (auto& entry : m_map) {
+        SourceProvider* provider = entry.key.source().provider();
+        bool shouldWriteFile = !!Options::diskCachePath();
+        bool shouldNotifyProvider = provider->wantsCachedBytecode();
+        if (!shouldWriteFile && !shouldNotifyProvider)
+            continue;
+
+        RefPtr<CachedBytecode> bytecode = encodeCodeBlock(vm, entry.key, entry.value.cell.get());
+        if (!bytecode || bytecode->size() <= entry.value.cachedBytecodeSize)
+            continue;
+        entry.value.cachedBytecodeSize = bytecode->size();
+
+#if OS(UNIX)
+        if (shouldWriteFile)
+            writeBytecodeCacheFile(entry.key, *bytecode);
+#endif
+        if (shouldNotifyProvider)
+            provider->cacheBytecode(bytecode.releaseNonNull());
+    }
+}
+
 void CodeCacheMap::pruneSlowCase()
 {
     m_minCapacity = std::max(m_size - m_sizeAtLastPrune, static_cast<int64_t>(0));
@@ -59,6 +169,8 @@ UnlinkedCodeBlockType* CodeCache::getUnlinkedGlobalCodeBlock(VM& vm, ExecutableT
         vm.typeProfiler() ? TypeProfilerEnabled::Yes : TypeProfilerEnabled::No, 
         vm.controlFlowProfiler() ? ControlFlowProfilerEnabled::Yes : ControlFlowProfilerEnabled::No);
     SourceCodeValue* cache = m_sourceCode.findCacheAndUpdateAge(key);
+    if (!cache && CacheTypes<UnlinkedCodeBlockType>::canUseBytecodeCache)
+        cache = m_sourceCode.fetchFromBytecodeCache(vm, key);
     if (cache && Options::useCodeCache()) {
         UnlinkedCodeBlockType* unlinkedCodeBlock = jsCast<UnlinkedCodeBlockType*>(cache->cell.get());
         unsigned lineCount = unlinkedCodeBlock->lineCount();
@@ -109,6 +221,8 @@ UnlinkedFunctionExecutable* CodeCache::getUnlinkedGlobalFunctionExecutable(VM& v
         vm.typeProfiler() ? TypeProfilerEnabled::Yes : TypeProfilerEnabled::No, 
         vm.controlFlowProfiler() ? ControlFlowProfilerEnabled::Yes : ControlFlowProfilerEnabled::No);
     SourceCodeValue* cache = m_sourceCode.findCacheAndUpdateAge(key);
+    if (!cache)
+        cache = m_sourceCode.fetchFromBytecodeCache(vm, key);
     if (cache && Options::useCodeCache()) {
         UnlinkedFunctionExecutable* executable = jsCast<UnlinkedFunctionExecutable*>(cache->cell.get());
         source.provider()->setSourceURLDirective(executable->sourceURLDirective());
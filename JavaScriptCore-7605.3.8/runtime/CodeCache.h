@@ -64,14 +64,18 @@ struct SourceCodeValue {
     {
     }
 
-    SourceCodeValue(VM& vm, JSCell* cell, int64_t age)
+    SourceCodeValue(VM& vm, JSCell* cell, int64_t age, size_t cachedBytecodeSize = 0)
         : cell(vm, cell)
         , age(age)
+        , cachedBytecodeSize(cachedBytecodeSize)
     {
     }
 
     Strong<JSCell> cell;
     int64_t age;
+    // Size of the last CachedBytecode this entry was loaded from or written to, so we only
+    // write it back once more of its functions have been compiled.
+    size_t cachedBytecodeSize { 0 };
 };
 
 class CodeCacheMap {
@@ -119,6 +123,11 @@ public:
         return &findResult->value;
     }
 
+    // Second-level lookup in the bytecode cache, used when findCacheAndUpdateAge() misses.
+    // On success the decoded code is added to the map, so the next lookup hits in memory.
+    SourceCodeValue* fetchFromBytecodeCache(VM&, const SourceCodeKey&);
+    void writeToBytecodeCache(VM&);
+
     AddResult addCache(const SourceCodeKey& key, const SourceCodeValue& value)
     {
         prune();
@@ -198,6 +207,7 @@ public:
     UnlinkedFunctionExecutable* getUnlinkedGlobalFunctionExecutable(VM&, const Identifier&, const SourceCode&, DebuggerMode, ParserError&);
 
     void clear() { m_sourceCode.clear(); }
+    void write(VM& vm) { m_sourceCode.writeToBytecodeCache(vm); }
 
 private:
     template <class UnlinkedCodeBlockType, class ExecutableType> 
@@ -212,18 +222,21 @@ template <> struct CacheTypes<UnlinkedProgramCodeBlock> {
     typedef JSC::ProgramNode RootNode;
     static const SourceCodeType codeType = SourceCodeType::ProgramType;
     static const SourceParseMode parseMode = SourceParseMode::ProgramMode;
+    static const bool canUseBytecodeCache = true;
 };
 
 template <> struct CacheTypes<UnlinkedEvalCodeBlock> {
     typedef JSC::EvalNode RootNode;
     static const SourceCodeType codeType = SourceCodeType::EvalType;
     static const SourceParseMode parseMode = SourceParseMode::ProgramMode;
+    static const bool canUseBytecodeCache = false;
 };
 
 template <> struct CacheTypes<UnlinkedModuleProgramCodeBlock> {
     typedef JSC::ModuleProgramNode RootNode;
     static const SourceCodeType codeType = SourceCodeType::ModuleType;
     static const SourceParseMode parseMode = SourceParseMode::ModuleEvaluateMode;
+    static const bool canUseBytecodeCache = true;
 };
 
 template <class UnlinkedCodeBlockType, class ExecutableType>
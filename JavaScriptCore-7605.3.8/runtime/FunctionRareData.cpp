@@ -78,6 +78,7 @@ FunctionRareData::FunctionRareData(VM& vm)
 
 FunctionRareData::~FunctionRareData()
 {
+    Heap::heap(this)->removeAllocationSiteSample(m_objectAllocationProfile.allocationSiteProfile());
 }
 
 void FunctionRareData::initializeObjectAllocationProfile(VM& vm, JSGlobalObject* globalObject, JSObject* prototype, size_t inlineCapacity, JSFunction* constructor)
@@ -41,6 +41,8 @@
 #include "Options.h"
 #include "StructureIDTable.h"
 #include "SuperSampler.h"
+#include "VM.h"
+#include "WasmFaultSignalHandler.h"
 #include "WasmThunks.h"
 #include "WriteBarrier.h"
 #include <mutex>
@@ -73,11 +75,18 @@ void initializeThreading()
         DisallowVMReentry::initialize();
 #endif
         initializeSuperSampler();
+        VM::installLowMemoryHandler();
         Thread& thread = Thread::current();
         thread.setSavedLastStackTop(thread.stack().origin());
 
 #if ENABLE(WEBASSEMBLY)
         Wasm::Thunks::initialize();
+#if OS(LINUX)
+        // On Darwin the embedder opts in to fast memory itself. Linux embedders only have
+        // the C API, so install the fault handler here; otherwise every wasm load and store
+        // would be explicitly bounds checked.
+        Wasm::enableFastMemory();
+#endif
 #endif
     });
 }
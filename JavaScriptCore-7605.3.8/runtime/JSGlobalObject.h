@@ -89,6 +89,7 @@ class JSModuleLoader;
 class JSModuleRecord;
 class JSPromise;
 class JSPromiseConstructor;
+class JSPromiseDeferred;
 class JSPromisePrototype;
 class JSSharedArrayBuffer;
 class JSSharedArrayBufferConstructor;
@@ -214,6 +215,11 @@ struct GlobalObjectMethodTable {
 
     typedef String (*DefaultLanguageFunctionPtr)();
     DefaultLanguageFunctionPtr defaultLanguage;
+
+    // Lets the embedder implement WebAssembly.compileStreaming for its own source objects, e.g.
+    // network responses, by feeding a Wasm::StreamingCompiler as the bytes arrive.
+    typedef void (*CompileStreamingPtr)(JSGlobalObject*, ExecState*, JSPromiseDeferred*, JSValue);
+    CompileStreamingPtr compileStreaming;
 };
 
 class JSGlobalObject : public JSSegmentedVariableObject {
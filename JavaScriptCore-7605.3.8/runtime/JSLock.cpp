@@ -113,6 +113,24 @@ void JSLock::lock(intptr_t lockCount)
         m_lock.lock();
     }
 
+    setOwnerThread(lockCount);
+}
+
+bool JSLock::tryLock()
+{
+    if (UNLIKELY(!m_lock.tryLock())) {
+        if (!currentThreadIsHoldingLock())
+            return false;
+        m_lockCount++;
+        return true;
+    }
+
+    setOwnerThread(1);
+    return true;
+}
+
+void JSLock::setOwnerThread(intptr_t lockCount)
+{
     m_ownerThread = &Thread::current();
     WTF::storeStoreFence();
     m_hasOwnerThread = true;
@@ -83,6 +83,8 @@ public:
     JS_EXPORT_PRIVATE ~JSLock();
 
     JS_EXPORT_PRIVATE void lock();
+    // Like lock(), but returns false instead of waiting when another thread holds the lock.
+    bool tryLock();
     JS_EXPORT_PRIVATE void unlock();
 
     static void lock(ExecState*);
@@ -121,6 +123,7 @@ public:
 
 private:
     void lock(intptr_t lockCount);
+    void setOwnerThread(intptr_t lockCount);
     void unlock(intptr_t unlockCount);
 
     void didAcquireLock();
@@ -215,6 +215,253 @@ JSValue PropertyNameForFunctionCall::value(ExecState* exec) const
     return m_value;
 }
 
+// ------------------------------ FastStringifier --------------------------------
+
+// Serializes values made only of primitives, plain objects and arrays with int32, double or contiguous
+// storage, reading properties straight out of the objects. It never calls into JavaScript, so it gives
+// up as soon as it reaches anything that might (an accessor, a toJSON function, a proxy...), and the
+// caller starts over with the generic Stringifier.
+class FastStringifier {
+    WTF_MAKE_NONCOPYABLE(FastStringifier);
+    WTF_FORBID_HEAP_ALLOCATION;
+public:
+    FastStringifier(ExecState*);
+
+    // Returns the null string if the value has to be stringified by the generic path.
+    String stringify(JSValue);
+
+private:
+    // The enumerable properties of a Structure, in the order JSON.stringify visits them. Each name is
+    // already quoted and followed by a ':'.
+    struct ObjectLayout {
+        Vector<String> quotedPropertyNames;
+        Vector<PropertyOffset> propertyOffsets;
+    };
+
+    bool append(JSValue);
+    bool appendObject(JSObject*);
+    bool appendArray(JSArray*);
+    void appendNumber(double);
+    const ObjectLayout* layoutFor(Structure*);
+
+    // Cycles are left to the generic path, which reports them; this bounds the work done before that.
+    static const unsigned maximumDepth = 512;
+
+    VM& m_vm;
+    JSGlobalObject* const m_globalObject;
+    StringBuilder m_builder;
+    unsigned m_depth { 0 };
+    HashMap<Structure*, std::unique_ptr<ObjectLayout>> m_layouts;
+    Structure* m_lastStructure { nullptr };
+    const ObjectLayout* m_lastLayout { nullptr };
+};
+
+FastStringifier::FastStringifier(ExecState* exec)
+    : m_vm(exec->vm())
+    , m_globalObject(exec->lexicalGlobalObject())
+{
+}
+
+String FastStringifier::stringify(JSValue value)
+{
+    // Objects are only handled if they inherit directly from Object.prototype or Array.prototype, so
+    // these are the only prototypes that need to be checked for toJSON.
+    const Identifier& toJSON = m_vm.propertyNames->toJSON;
+    JSObject* objectPrototype = m_globalObject->objectPrototype();
+    JSObject* arrayPrototype = m_globalObject->arrayPrototype();
+    if (isValidOffset(objectPrototype->structure(m_vm)->get(m_vm, toJSON)) || isValidOffset(arrayPrototype->structure(m_vm)->get(m_vm, toJSON)))
+        return String();
+    // Holes are written as null, which is only right if no prototype can supply an element for them.
+    if (!m_globalObject->arrayPrototypeChainIsSane())
+        return String();
+
+    if (value.isUndefined() || value.isSymbol())
+        return String();
+    if (!append(value))
+        return String();
+    return m_builder.toString();
+}
+
+inline void FastStringifier::appendNumber(double number)
+{
+    if (!std::isfinite(number))
+        m_builder.appendLiteral("null");
+    else
+        m_builder.appendECMAScriptNumber(number);
+}
+
+bool FastStringifier::append(JSValue value)
+{
+    if (value.isInt32()) {
+        m_builder.appendNumber(value.asInt32());
+        return true;
+    }
+    if (value.isDouble()) {
+        appendNumber(value.asDouble());
+        return true;
+    }
+    // Undefined only reaches here as an array element, where it is written as null.
+    if (value.isUndefinedOrNull()) {
+        m_builder.appendLiteral("null");
+        return true;
+    }
+    if (value.isBoolean()) {
+        if (value.isTrue())
+            m_builder.appendLiteral("true");
+        else
+            m_builder.appendLiteral("false");
+        return true;
+    }
+
+    ASSERT(value.isCell());
+    JSCell* cell = value.asCell();
+    switch (cell->type()) {
+    case StringType: {
+        // The string is null if it was a rope that could not be resolved. The generic path will throw.
+        const String& string = asString(cell)->tryGetValue();
+        return !string.isNull() && m_builder.appendQuotedJSONString(string);
+    }
+    case SymbolType:
+        m_builder.appendLiteral("null");
+        return true;
+    case FinalObjectType:
+        return appendObject(asObject(cell));
+    case ArrayType:
+        return appendArray(jsCast<JSArray*>(cell));
+    default:
+        return false;
+    }
+}
+
+bool FastStringifier::appendObject(JSObject* object)
+{
+    Structure* structure = object->structure(m_vm);
+    const ObjectLayout* layout = structure == m_lastStructure ? m_lastLayout : layoutFor(structure);
+    if (!layout)
+        return false;
+    m_lastStructure = structure;
+    m_lastLayout = layout;
+
+    if (UNLIKELY(++m_depth > maximumDepth || !m_vm.isSafeToRecurseSoft()))
+        return false;
+
+    m_builder.append('{');
+    bool needsComma = false;
+    for (unsigned i = 0; i < layout->propertyOffsets.size(); ++i) {
+        JSValue value = object->getDirect(layout->propertyOffsets[i]);
+        if (value.isUndefined() || value.isSymbol())
+            continue;
+        if (needsComma)
+            m_builder.append(',');
+        m_builder.append(layout->quotedPropertyNames[i]);
+        if (!append(value))
+            return false;
+        needsComma = true;
+    }
+    m_builder.append('}');
+
+    --m_depth;
+    return true;
+}
+
+bool FastStringifier::appendArray(JSArray* array)
+{
+    // The original array Structures have no named properties, and Array.prototype as their prototype.
+    if (!m_globalObject->isOriginalArrayStructure(array->structure(m_vm)))
+        return false;
+
+    if (UNLIKELY(++m_depth > maximumDepth || !m_vm.isSafeToRecurseSoft()))
+        return false;
+
+    // stringify() checked that the prototype chain has no indexed properties, so holes are null.
+    Butterfly* butterfly = array->butterfly();
+    unsigned length = array->length();
+    m_builder.append('[');
+    switch (array->indexingType()) {
+    case ArrayWithUndecided:
+        for (unsigned i = 0; i < length; ++i) {
+            if (i)
+                m_builder.append(',');
+            m_builder.appendLiteral("null");
+        }
+        break;
+    case ArrayWithInt32:
+        for (unsigned i = 0; i < length; ++i) {
+            if (i)
+                m_builder.append(',');
+            JSValue value = butterfly->contiguousInt32().at(array, i).get();
+            if (value)
+                m_builder.appendNumber(value.asInt32());
+            else
+                m_builder.appendLiteral("null");
+        }
+        break;
+    case ArrayWithDouble:
+        for (unsigned i = 0; i < length; ++i) {
+            if (i)
+                m_builder.append(',');
+            // Holes are NaN, which is written as null too.
+            appendNumber(butterfly->contiguousDouble().at(array, i));
+        }
+        break;
+    case ArrayWithContiguous:
+        for (unsigned i = 0; i < length; ++i) {
+            if (i)
+                m_builder.append(',');
+            JSValue value = butterfly->contiguous().at(array, i).get();
+            if (!value)
+                m_builder.appendLiteral("null");
+            else if (!append(value))
+                return false;
+        }
+        break;
+    default:
+        return false;
+    }
+    m_builder.append(']');
+
+    --m_depth;
+    return true;
+}
+
+auto FastStringifier::layoutFor(Structure* structure) -> const ObjectLayout*
+{
+    auto addResult = m_layouts.add(structure, nullptr);
+    if (!addResult.isNewEntry)
+        return addResult.iterator->value.get();
+
+    if (structure->hasPolyProto() || structure->storedPrototype() != m_globalObject->objectPrototype())
+        return nullptr;
+    if (hasIndexedProperties(structure->indexingType()))
+        return nullptr;
+    if (structure->hasGetterSetterProperties() || structure->hasCustomGetterSetterProperties())
+        return nullptr;
+    if (isValidOffset(structure->get(m_vm, m_vm.propertyNames->toJSON)))
+        return nullptr;
+
+    PropertyNameArray propertyNames(&m_vm, PropertyNameMode::Strings, PrivateSymbolMode::Exclude);
+    structure->getPropertyNamesFromStructure(m_vm, propertyNames, EnumerationMode());
+
+    auto layout = std::make_unique<ObjectLayout>();
+    layout->quotedPropertyNames.reserveInitialCapacity(propertyNames.size());
+    layout->propertyOffsets.reserveInitialCapacity(propertyNames.size());
+    for (unsigned i = 0; i < propertyNames.size(); ++i) {
+        unsigned attributes;
+        PropertyOffset offset = structure->get(m_vm, propertyNames[i], attributes);
+        if (attributes & (PropertyAttribute::Accessor | PropertyAttribute::CustomAccessor))
+            return nullptr;
+        StringBuilder quotedPropertyName;
+        if (!quotedPropertyName.appendQuotedJSONString(propertyNames[i].string()))
+            return nullptr;
+        quotedPropertyName.append(':');
+        layout->quotedPropertyNames.uncheckedAppend(quotedPropertyName.toString());
+        layout->propertyOffsets.uncheckedAppend(offset);
+    }
+
+    addResult.iterator->value = WTFMove(layout);
+    return addResult.iterator->value.get();
+}
+
 // ------------------------------ Stringifier --------------------------------
 
 Stringifier::Stringifier(ExecState* exec, JSValue replacer, JSValue space)
@@ -264,6 +511,14 @@ JSValue Stringifier::stringify(JSValue value)
 {
     VM& vm = m_exec->vm();
     auto scope = DECLARE_THROW_SCOPE(vm);
+
+    if (Options::useJSONFastStringify() && !m_usingArrayReplacer && m_replacerCallType == CallType::None && m_gap.isEmpty()) {
+        FastStringifier fastStringifier(m_exec);
+        String result = fastStringifier.stringify(value);
+        if (!result.isNull())
+            return jsString(m_exec, result);
+    }
+
     JSObject* object = constructEmptyObject(m_exec);
     RETURN_IF_EXCEPTION(scope, jsNull());
 
@@ -32,7 +32,9 @@
 #include "JSObject.h"
 #include "JSString.h"
 
+#include <wtf/Condition.h>
 #include <wtf/MainThread.h>
+#include <wtf/NeverDestroyed.h>
 #include <wtf/Threading.h>
 
 #if USE(GLIB_EVENT_LOOP)
@@ -121,11 +123,40 @@ void JSRunLoopTimer::cancelTimer()
 
 #else
 
+namespace {
+
+// All timers that are not driven by a RunLoop, whether they are fired by the embedder or by the timer thread.
+struct TimerQueue {
+    Lock lock;
+    Condition condition;
+    HashSet<JSRunLoopTimer*> timers;
+    RefPtr<Thread> thread;
+};
+
+TimerQueue& timerQueue()
+{
+    static NeverDestroyed<TimerQueue> queue;
+    return queue;
+}
+
+} // anonymous namespace
+
 JSRunLoopTimer::JSRunLoopTimer(VM* vm)
     : m_vm(vm)
     , m_apiLock(&vm->apiLock())
     , m_timer(RunLoop::current(), this, &JSRunLoopTimer::timerDidFireCallback)
+    , m_fireTime(MonotonicTime::now() + s_decade)
+    , m_usesTimerQueue(Options::useManualJSRunLoopTimers() || Options::useJSRunLoopTimerThread())
 {
+    if (m_usesTimerQueue) {
+        TimerQueue& queue = timerQueue();
+        auto locker = holdLock(queue.lock);
+        queue.timers.add(this);
+        if (Options::useJSRunLoopTimerThread() && !Options::useManualJSRunLoopTimers() && !queue.thread)
+            queue.thread = Thread::create("JSC Timer Thread", timerThreadMain);
+        return;
+    }
+
 #if USE(GLIB_EVENT_LOOP)
     m_timer.setPriority(RunLoopSourcePriority::JavascriptTimer);
     m_timer.setName("[JavaScriptCore] JSRunLoopTimer");
@@ -135,6 +166,21 @@ JSRunLoopTimer::JSRunLoopTimer(VM* vm)
 
 JSRunLoopTimer::~JSRunLoopTimer()
 {
+    // Subclasses should have already called stop(). This only makes sure that the queue never holds on to a dead timer.
+    stop();
+}
+
+void JSRunLoopTimer::stop()
+{
+    if (!m_usesTimerQueue)
+        return;
+
+    // Holding the API lock guarantees that fireNextDueTimer() isn't in the middle of firing this timer.
+    // It also rechecks that the timer is still in the queue after taking the API lock, so it won't fire it afterwards.
+    std::lock_guard<JSLock> lock(*m_apiLock);
+    TimerQueue& queue = timerQueue();
+    auto locker = holdLock(queue.lock);
+    queue.timers.remove(this);
 }
 
 void JSRunLoopTimer::timerDidFireCallback()
@@ -143,9 +189,32 @@ void JSRunLoopTimer::timerDidFireCallback()
     timerDidFire();
 }
 
+Seconds JSRunLoopTimer::secondsUntilFire() const
+{
+    if (!m_usesTimerQueue)
+        return m_timer.secondsUntilFire();
+
+    TimerQueue& queue = timerQueue();
+    auto locker = holdLock(queue.lock);
+    return std::max(m_fireTime - MonotonicTime::now(), 0_s);
+}
+
+void JSRunLoopTimer::setSecondsUntilFire(Seconds intervalInSeconds)
+{
+    if (!m_usesTimerQueue) {
+        m_timer.startOneShot(intervalInSeconds);
+        return;
+    }
+
+    TimerQueue& queue = timerQueue();
+    auto locker = holdLock(queue.lock);
+    m_fireTime = MonotonicTime::now() + std::max(intervalInSeconds, 0_s);
+    queue.condition.notifyOne();
+}
+
 void JSRunLoopTimer::scheduleTimer(Seconds intervalInSeconds)
 {
-    m_timer.startOneShot(intervalInSeconds);
+    setSecondsUntilFire(intervalInSeconds);
     m_isScheduled = true;
 
     auto locker = holdLock(m_timerCallbacksLock);
@@ -155,10 +224,70 @@ void JSRunLoopTimer::scheduleTimer(Seconds intervalInSeconds)
 
 void JSRunLoopTimer::cancelTimer()
 {
-    m_timer.startOneShot(s_decade);
+    setSecondsUntilFire(s_decade);
     m_isScheduled = false;
 }
 
+bool JSRunLoopTimer::fireNextDueTimer(VM* vm, MonotonicTime& nextFireTime)
+{
+    TimerQueue& queue = timerQueue();
+    JSRunLoopTimer* dueTimer = nullptr;
+    RefPtr<JSLock> apiLock;
+    {
+        auto locker = holdLock(queue.lock);
+        MonotonicTime now = MonotonicTime::now();
+        nextFireTime = MonotonicTime::infinity();
+        for (JSRunLoopTimer* timer : queue.timers) {
+            if (vm && timer->m_vm != vm)
+                continue;
+            if (!dueTimer && timer->m_fireTime <= now) {
+                dueTimer = timer;
+                continue;
+            }
+            nextFireTime = std::min(nextFireTime, timer->m_fireTime);
+        }
+        if (!dueTimer)
+            return false;
+        apiLock = dueTimer->m_apiLock;
+    }
+
+    // We can't wait for the API lock while holding the queue lock, since the VM's thread may need the queue
+    // lock to schedule a timer. So check that the timer is still alive and due once we have the API lock.
+    std::lock_guard<JSLock> lock(*apiLock);
+    {
+        auto locker = holdLock(queue.lock);
+        if (!queue.timers.contains(dueTimer) || dueTimer->m_apiLock != apiLock || dueTimer->m_fireTime > MonotonicTime::now())
+            return true;
+        dueTimer->m_fireTime = MonotonicTime::now() + s_decade;
+    }
+    dueTimer->timerDidFire();
+    return true;
+}
+
+Seconds JSRunLoopTimer::fireDueTimers(VM& vm)
+{
+    MonotonicTime nextFireTime;
+    while (fireNextDueTimer(&vm, nextFireTime)) { }
+    return std::max(nextFireTime - MonotonicTime::now(), 0_s);
+}
+
+void JSRunLoopTimer::timerThreadMain()
+{
+    TimerQueue& queue = timerQueue();
+    while (true) {
+        MonotonicTime nextFireTime;
+        while (fireNextDueTimer(nullptr, nextFireTime)) { }
+
+        auto locker = holdLock(queue.lock);
+        // A timer may have been scheduled since we looked, so find the earliest fire time again while holding the lock.
+        nextFireTime = MonotonicTime::infinity();
+        for (JSRunLoopTimer* timer : queue.timers)
+            nextFireTime = std::min(nextFireTime, timer->m_fireTime);
+        if (nextFireTime > MonotonicTime::now())
+            queue.condition.waitUntil(queue.lock, nextFireTime);
+    }
+}
+
 #endif
 
 void JSRunLoopTimer::addTimerSetNotification(TimerNotificationCallback callback)
@@ -27,6 +27,7 @@
 
 #include <wtf/HashSet.h>
 #include <wtf/Lock.h>
+#include <wtf/MonotonicTime.h>
 #include <wtf/RefPtr.h>
 #include <wtf/RetainPtr.h>
 #include <wtf/RunLoop.h>
@@ -61,6 +62,15 @@ public:
     void cancelTimer();
     bool isScheduled() const { return m_isScheduled; }
 
+    // Timers that fireDueTimers() or the timer thread may fire have to call this at the start of the
+    // most derived destructor. Once the destructor of a subclass has run, doWork() can no longer be
+    // called safely, so the timer must be out of the queue by then.
+#if USE(CF)
+    void stop() { }
+#else
+    JS_EXPORT_PRIVATE void stop();
+#endif
+
     // Note: The only thing the timer notification callback cannot do is
     // call scheduleTimer(). This will cause a deadlock. It would not
     // be hard to make this work, however, there are no clients that need
@@ -70,6 +80,10 @@ public:
 
 #if USE(CF)
     JS_EXPORT_PRIVATE void setRunLoop(CFRunLoopRef);
+#else
+    // When Options::useManualJSRunLoopTimers() is set, timers only fire when the embedder calls this.
+    // It fires the timers of the VM that are due and returns how long it is until the next one is.
+    JS_EXPORT_PRIVATE static Seconds fireDueTimers(VM&);
 #endif // USE(CF)
 
 protected:
@@ -87,7 +101,13 @@ protected:
 
     Lock m_shutdownMutex;
 #else
+    Seconds secondsUntilFire() const;
+    void setSecondsUntilFire(Seconds);
+
     RunLoop::Timer<JSRunLoopTimer> m_timer;
+    // Timers that don't use m_timer are fired by fireDueTimers(), either from the embedder or from the timer thread.
+    MonotonicTime m_fireTime;
+    bool m_usesTimerQueue;
 #endif
 
     Lock m_timerCallbacksLock;
@@ -95,6 +115,11 @@ protected:
     
 private:
     void timerDidFire();
+
+#if !USE(CF)
+    static bool fireNextDueTimer(VM*, MonotonicTime& nextFireTime);
+    static void timerThreadMain();
+#endif
 };
     
 } // namespace JSC
@@ -29,6 +29,7 @@
 
 #include "ButterflyInlines.h"
 #include "CodeBlock.h"
+#include "DeferGC.h"
 #include "JSArray.h"
 #include "JSString.h"
 #include "Lexer.h"
@@ -38,6 +39,14 @@
 #include <wtf/ASCIICType.h>
 #include <wtf/dtoa.h>
 
+#if COMPILER(GCC_OR_CLANG) && CPU(X86_SSE2)
+#include <emmintrin.h>
+#define HAVE_LITERAL_PARSER_SIMD 1
+#elif COMPILER(GCC_OR_CLANG) && CPU(ARM64)
+#include <arm_neon.h>
+#define HAVE_LITERAL_PARSER_SIMD 1
+#endif
+
 namespace JSC {
 
 template <typename CharType>
@@ -48,6 +57,145 @@ static ALWAYS_INLINE bool isJSONWhiteSpace(const CharType& c)
     return c == ' ' || c == 0x9 || c == 0xA || c == 0xD;
 }
 
+#if HAVE(LITERAL_PARSER_SIMD)
+// The operations the lexer needs to test 16 bytes of characters at once. Comparisons are unsigned,
+// and produce masks with every bit of a lane set where they hold.
+template <typename CharType> struct CharacterVector;
+
+#if CPU(X86_SSE2)
+template <> struct CharacterVector<LChar> {
+    typedef __m128i Type;
+    static const unsigned length = 16;
+
+    static Type load(const LChar* characters) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(characters)); }
+    static Type splat(LChar character) { return _mm_set1_epi8(character); }
+    static Type equal(Type a, Type b) { return _mm_cmpeq_epi8(a, b); }
+    static Type lessThanOrEqual(Type a, Type b) { return _mm_cmpeq_epi8(_mm_subs_epu8(a, b), _mm_setzero_si128()); }
+    static Type subtract(Type a, Type b) { return _mm_sub_epi8(a, b); }
+    static Type bitOr(Type a, Type b) { return _mm_or_si128(a, b); }
+    static Type bitNot(Type a) { return _mm_xor_si128(a, _mm_set1_epi8(-1)); }
+
+    // Returns the index of the first lane set in mask, or length if there is none.
+    static unsigned firstSetLane(Type mask)
+    {
+        unsigned bits = _mm_movemask_epi8(mask);
+        return bits ? __builtin_ctz(bits) : length;
+    }
+};
+
+template <> struct CharacterVector<UChar> {
+    typedef __m128i Type;
+    static const unsigned length = 8;
+
+    static Type load(const UChar* characters) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(characters)); }
+    static Type splat(UChar character) { return _mm_set1_epi16(character); }
+    static Type equal(Type a, Type b) { return _mm_cmpeq_epi16(a, b); }
+    static Type lessThanOrEqual(Type a, Type b) { return _mm_cmpeq_epi16(_mm_subs_epu16(a, b), _mm_setzero_si128()); }
+    static Type subtract(Type a, Type b) { return _mm_sub_epi16(a, b); }
+    static Type bitOr(Type a, Type b) { return _mm_or_si128(a, b); }
+    static Type bitNot(Type a) { return _mm_xor_si128(a, _mm_set1_epi16(-1)); }
+
+    static unsigned firstSetLane(Type mask)
+    {
+        // There are two mask bits per lane.
+        unsigned bits = _mm_movemask_epi8(mask);
+        return bits ? __builtin_ctz(bits) / 2 : length;
+    }
+};
+#else
+template <> struct CharacterVector<LChar> {
+    typedef uint8x16_t Type;
+    static const unsigned length = 16;
+
+    static Type load(const LChar* characters) { return vld1q_u8(characters); }
+    static Type splat(LChar character) { return vdupq_n_u8(character); }
+    static Type equal(Type a, Type b) { return vceqq_u8(a, b); }
+    static Type lessThanOrEqual(Type a, Type b) { return vcleq_u8(a, b); }
+    static Type subtract(Type a, Type b) { return vsubq_u8(a, b); }
+    static Type bitOr(Type a, Type b) { return vorrq_u8(a, b); }
+    static Type bitNot(Type a) { return vmvnq_u8(a); }
+
+    static unsigned firstSetLane(Type mask)
+    {
+        // NEON can't gather one bit per lane, so narrow each lane to four bits instead.
+        uint64_t bits = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(mask), 4)), 0);
+        return bits ? __builtin_ctzll(bits) / 4 : length;
+    }
+};
+
+template <> struct CharacterVector<UChar> {
+    typedef uint16x8_t Type;
+    static const unsigned length = 8;
+
+    static Type load(const UChar* characters) { return vld1q_u16(reinterpret_cast<const uint16_t*>(characters)); }
+    static Type splat(UChar character) { return vdupq_n_u16(character); }
+    static Type equal(Type a, Type b) { return vceqq_u16(a, b); }
+    static Type lessThanOrEqual(Type a, Type b) { return vcleq_u16(a, b); }
+    static Type subtract(Type a, Type b) { return vsubq_u16(a, b); }
+    static Type bitOr(Type a, Type b) { return vorrq_u16(a, b); }
+    static Type bitNot(Type a) { return vmvnq_u16(a); }
+
+    static unsigned firstSetLane(Type mask)
+    {
+        uint64_t bits = vget_lane_u64(vreinterpret_u64_u8(vmovn_u16(mask)), 0);
+        return bits ? __builtin_ctzll(bits) / 8 : length;
+    }
+};
+#endif
+
+// Skips whole vectors of characters for which matches() holds. stop() returns the lanes of a vector
+// where it may not hold; it may be conservative, in which case those characters are checked one at a
+// time. Returns once fewer than a vector of characters remain, or at the first that doesn't match.
+template <typename CharType, typename VectorFunctor, typename CharacterFunctor>
+static ALWAYS_INLINE const CharType* skipVectorsWhile(const CharType* ptr, const CharType* end, const VectorFunctor& stop, const CharacterFunctor& matches)
+{
+    typedef CharacterVector<CharType> Characters;
+    while (static_cast<size_t>(end - ptr) >= Characters::length) {
+        unsigned lane = Characters::firstSetLane(stop(Characters::load(ptr)));
+        ptr += lane;
+        if (lane == Characters::length)
+            continue;
+        if (!matches(*ptr))
+            return ptr;
+        ++ptr;
+    }
+    return ptr;
+}
+#endif
+
+template <typename CharType>
+static ALWAYS_INLINE const CharType* skipJSONWhiteSpace(const CharType* ptr, const CharType* end)
+{
+    // Compact JSON has no white space between tokens, so don't set up any vectors in that case.
+    if (ptr == end || !isJSONWhiteSpace(*ptr))
+        return ptr;
+#if HAVE(LITERAL_PARSER_SIMD)
+    typedef CharacterVector<CharType> Characters;
+    ptr = skipVectorsWhile(ptr, end, [] (typename Characters::Type c) {
+        typename Characters::Type spaceOrTab = Characters::bitOr(Characters::equal(c, Characters::splat(' ')), Characters::equal(c, Characters::splat('\t')));
+        typename Characters::Type newline = Characters::bitOr(Characters::equal(c, Characters::splat('\n')), Characters::equal(c, Characters::splat('\r')));
+        return Characters::bitNot(Characters::bitOr(spaceOrTab, newline));
+    }, isJSONWhiteSpace<CharType>);
+#endif
+    while (ptr < end && isJSONWhiteSpace(*ptr))
+        ++ptr;
+    return ptr;
+}
+
+template <typename CharType>
+static ALWAYS_INLINE const CharType* skipASCIIDigits(const CharType* ptr, const CharType* end)
+{
+#if HAVE(LITERAL_PARSER_SIMD)
+    typedef CharacterVector<CharType> Characters;
+    ptr = skipVectorsWhile(ptr, end, [] (typename Characters::Type c) {
+        return Characters::bitNot(Characters::lessThanOrEqual(Characters::subtract(c, Characters::splat('0')), Characters::splat(9)));
+    }, isASCIIDigit<CharType>);
+#endif
+    while (ptr < end && isASCIIDigit(*ptr))
+        ++ptr;
+    return ptr;
+}
+
 template <typename CharType>
 bool LiteralParser<CharType>::tryJSONPParse(Vector<JSONPData>& results, bool needsFullSourceInfo)
 {
@@ -172,6 +320,106 @@ ALWAYS_INLINE const Identifier LiteralParser<CharType>::makeIdentifier(const UCh
     return m_recentIdentifiers[characters[0]];
 }
 
+template <typename CharType>
+template <typename TokenCharType>
+ALWAYS_INLINE const Identifier LiteralParser<CharType>::makePropertyName(const TokenCharType* characters, size_t length, unsigned& shapeIndex, unsigned propertyIndex)
+{
+    // Objects usually repeat the keys of an earlier object with the same first key, so check against
+    // that shape's names before atomizing the key.
+    if (!propertyIndex) {
+        for (shapeIndex = 0; shapeIndex < m_objectShapes.size(); ++shapeIndex) {
+            const Identifier& propertyName = m_objectShapes[shapeIndex].propertyNames[0];
+            if (Identifier::equal(propertyName.impl(), characters, length))
+                return propertyName;
+        }
+        shapeIndex = noObjectShape;
+    } else if (shapeIndex < m_objectShapes.size()) {
+        const ObjectShape& shape = m_objectShapes[shapeIndex];
+        if (propertyIndex < shape.propertyNames.size() && Identifier::equal(shape.propertyNames[propertyIndex].impl(), characters, length))
+            return shape.propertyNames[propertyIndex];
+        shapeIndex = noObjectShape;
+    }
+    return makeIdentifier(characters, length);
+}
+
+template <typename CharType>
+JSObject* LiteralParser<CharType>::constructObject(unsigned shapeIndex, const Identifier* propertyNames, MarkedArgumentBuffer& values, unsigned firstValue, unsigned propertyCount, bool hasUnderscoreProto)
+{
+    VM& vm = m_exec->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    if (shapeIndex < m_objectShapes.size()) {
+        const ObjectShape& shape = m_objectShapes[shapeIndex];
+        Structure* structure = shape.structure.get();
+        // Nested objects may have replaced the shape since the keys were checked against it. The stores
+        // below don't update inferred types, so structures that have them go through putDirect() instead.
+        if (shape.propertyNames.size() == propertyCount && std::equal(propertyNames, propertyNames + propertyCount, shape.propertyNames.begin())
+            && !structure->hasInferredTypes()) {
+            DeferGC deferGC(vm.heap);
+            Butterfly* butterfly = structure->outOfLineCapacity() ? Butterfly::create(vm, nullptr, structure) : nullptr;
+            JSObject* object = JSFinalObject::create(m_exec, structure, butterfly);
+            for (unsigned i = 0; i < propertyCount; ++i)
+                object->putDirect(vm, shape.propertyOffsets[i], values.at(firstValue + i));
+            return object;
+        }
+    }
+
+    JSObject* object = constructEmptyObject(m_exec);
+    bool canRecordShape = !hasUnderscoreProto;
+    for (unsigned i = 0; i < propertyCount; ++i) {
+        PropertyName propertyName = propertyNames[i];
+        JSValue value = values.at(firstValue + i);
+        if (m_mode != StrictJSON && propertyName == vm.propertyNames->underscoreProto) {
+            CodeBlock* codeBlock = m_exec->codeBlock();
+            PutPropertySlot slot(object, codeBlock ? codeBlock->isStrictMode() : false);
+            object->methodTable(vm)->put(object, m_exec, propertyName, value, slot);
+        } else if (std::optional<uint32_t> index = parseIndex(propertyName)) {
+            object->putDirectIndex(m_exec, index.value(), value);
+            canRecordShape = false;
+        } else
+            object->putDirect(vm, propertyName, value);
+        RETURN_IF_EXCEPTION(scope, nullptr);
+    }
+
+    if (canRecordShape)
+        recordObjectShape(object, propertyNames, propertyCount);
+    return object;
+}
+
+template <typename CharType>
+void LiteralParser<CharType>::recordObjectShape(JSObject* object, const Identifier* propertyNames, unsigned propertyCount)
+{
+    VM& vm = m_exec->vm();
+    Structure* structure = object->structure(vm);
+    if (propertyCount > maximumObjectShapeSize || structure->isDictionary())
+        return;
+
+    ObjectShape shape;
+    shape.propertyNames.reserveInitialCapacity(propertyCount);
+    shape.propertyOffsets.reserveInitialCapacity(propertyCount);
+    for (unsigned i = 0; i < propertyCount; ++i) {
+        PropertyOffset offset = structure->get(vm, propertyNames[i]);
+        if (!isValidOffset(offset))
+            return;
+        shape.propertyNames.uncheckedAppend(propertyNames[i]);
+        shape.propertyOffsets.uncheckedAppend(offset);
+    }
+    shape.structure.set(vm, structure);
+
+    // Replace the shape that starts with the same key, since makePropertyName() only finds the first.
+    for (auto& existingShape : m_objectShapes) {
+        if (existingShape.propertyNames[0] == propertyNames[0]) {
+            existingShape = WTFMove(shape);
+            return;
+        }
+    }
+    if (m_objectShapes.size() < maximumObjectShapes) {
+        m_objectShapes.append(WTFMove(shape));
+        return;
+    }
+    m_objectShapes[m_nextObjectShapeToReplace++ % maximumObjectShapes] = WTFMove(shape);
+}
+
 template <typename CharType>
 template <ParserMode mode> TokenType LiteralParser<CharType>::Lexer::lex(LiteralParserToken<CharType>& token)
 {
@@ -179,8 +427,7 @@ template <ParserMode mode> TokenType LiteralParser<CharType>::Lexer::lex(Literal
     m_currentTokenID++;
 #endif
 
-    while (m_ptr < m_end && isJSONWhiteSpace(*m_ptr))
-        ++m_ptr;
+    m_ptr = skipJSONWhiteSpace(m_ptr, m_end);
 
     ASSERT(m_ptr <= m_end);
     if (m_ptr >= m_end) {
@@ -356,13 +603,32 @@ template <ParserMode mode, typename CharType, UChar terminator> static ALWAYS_IN
     return (c >= ' ' && (mode == StrictJSON || c <= 0xff) && c != '\\' && c != terminator) || (c == '\t' && mode != StrictJSON);
 }
 
+template <ParserMode mode, char terminator, typename CharType> static ALWAYS_INLINE const CharType* skipSafeStringCharacters(const CharType* ptr, const CharType* end)
+{
+#if HAVE(LITERAL_PARSER_SIMD)
+    typedef CharacterVector<CharType> Characters;
+    ptr = skipVectorsWhile(ptr, end, [] (typename Characters::Type c) {
+        // Tabs are below ' ', so this stops at them even where they are safe.
+        typename Characters::Type stop = Characters::bitOr(Characters::lessThanOrEqual(c, Characters::splat(0x1f)),
+            Characters::bitOr(Characters::equal(c, Characters::splat('\\')), Characters::equal(c, Characters::splat(terminator))));
+        if (sizeof(CharType) == 2 && mode != StrictJSON)
+            stop = Characters::bitOr(stop, Characters::bitNot(Characters::lessThanOrEqual(c, Characters::splat(0xff))));
+        return stop;
+    }, [] (CharType c) {
+        return isSafeStringCharacter<mode, CharType, terminator>(c);
+    });
+#endif
+    while (ptr < end && isSafeStringCharacter<mode, CharType, terminator>(*ptr))
+        ++ptr;
+    return ptr;
+}
+
 template <typename CharType>
 template <ParserMode mode, char terminator> ALWAYS_INLINE TokenType LiteralParser<CharType>::Lexer::lexString(LiteralParserToken<CharType>& token)
 {
     ++m_ptr;
     const CharType* runStart = m_ptr;
-    while (m_ptr < m_end && isSafeStringCharacter<mode, CharType, terminator>(*m_ptr))
-        ++m_ptr;
+    m_ptr = skipSafeStringCharacters<mode, terminator>(m_ptr, m_end);
     if (LIKELY(m_ptr < m_end && *m_ptr == terminator)) {
         setParserTokenString<CharType>(token, runStart);
         token.stringLength = m_ptr - runStart;
@@ -380,8 +646,7 @@ template <ParserMode mode, char terminator> TokenType LiteralParser<CharType>::L
     goto slowPathBegin;
     do {
         runStart = m_ptr;
-        while (m_ptr < m_end && isSafeStringCharacter<mode, CharType, terminator>(*m_ptr))
-            ++m_ptr;
+        m_ptr = skipSafeStringCharacters<mode, terminator>(m_ptr, m_end);
         if (!m_builder.isEmpty())
             m_builder.append(runStart, m_ptr - runStart);
 
@@ -504,8 +769,7 @@ TokenType LiteralParser<CharType>::Lexer::lexNumber(LiteralParserToken<CharType>
     else if (m_ptr < m_end && *m_ptr >= '1' && *m_ptr <= '9') { // [1-9]
         ++m_ptr;
         // [0-9]*
-        while (m_ptr < m_end && isASCIIDigit(*m_ptr))
-            ++m_ptr;
+        m_ptr = skipASCIIDigits(m_ptr, m_end);
     } else {
         m_lexErrorMessage = ASCIILiteral("Invalid number");
         return TokError;
@@ -522,8 +786,7 @@ TokenType LiteralParser<CharType>::Lexer::lexNumber(LiteralParserToken<CharType>
         }
 
         ++m_ptr;
-        while (m_ptr < m_end && isASCIIDigit(*m_ptr))
-            ++m_ptr;
+        m_ptr = skipASCIIDigits(m_ptr, m_end);
     } else if (m_ptr < m_end && (*m_ptr != 'e' && *m_ptr != 'E') && (m_ptr - token.start) <= NumberOfDigitsForSafeInt32) {
         int32_t result = 0;
         token.type = TokNumber;
@@ -565,8 +828,7 @@ TokenType LiteralParser<CharType>::Lexer::lexNumber(LiteralParserToken<CharType>
         }
         
         ++m_ptr;
-        while (m_ptr < m_end && isASCIIDigit(*m_ptr))
-            ++m_ptr;
+        m_ptr = skipASCIIDigits(m_ptr, m_end);
     }
     
     token.type = TokNumber;
@@ -586,7 +848,15 @@ JSValue LiteralParser<CharType>::parse(ParserState initialState)
     JSValue lastValue;
     Vector<ParserState, 16, UnsafeVectorOverflow> stateStack;
     Vector<Identifier, 16, UnsafeVectorOverflow> identifierStack;
-    HashSet<JSObject*> visitedUnderscoreProto;
+    // Objects are only constructed once their closing brace is reached. Until then their property
+    // values are kept on objectStack, and their names on identifierStack.
+    struct PendingObject {
+        unsigned firstValue;
+        unsigned firstPropertyName;
+        unsigned shape;
+        bool hasUnderscoreProto;
+    };
+    Vector<PendingObject, 16, UnsafeVectorOverflow> pendingObjects;
     while (1) {
         switch(state) {
             startParseArray:
@@ -633,16 +903,15 @@ JSValue LiteralParser<CharType>::parse(ParserState initialState)
             }
             startParseObject:
             case StartParseObject: {
-                JSObject* object = constructEmptyObject(m_exec);
-                objectStack.appendWithCrashOnOverflow(object);
-
                 TokenType type = m_lexer.next();
                 if (type == TokString || (m_mode != StrictJSON && type == TokIdentifier)) {
+                    PendingObject pendingObject { static_cast<unsigned>(objectStack.size()), static_cast<unsigned>(identifierStack.size()), noObjectShape, false };
                     typename Lexer::LiteralParserTokenPtr identifierToken = m_lexer.currentToken();
                     if (identifierToken->stringIs8Bit)
-                        identifierStack.append(makeIdentifier(identifierToken->stringToken8, identifierToken->stringLength));
+                        identifierStack.append(makePropertyName(identifierToken->stringToken8, identifierToken->stringLength, pendingObject.shape, 0));
                     else
-                        identifierStack.append(makeIdentifier(identifierToken->stringToken16, identifierToken->stringLength));
+                        identifierStack.append(makePropertyName(identifierToken->stringToken16, identifierToken->stringLength, pendingObject.shape, 0));
+                    pendingObjects.append(pendingObject);
 
                     // Check for colon
                     if (m_lexer.next() != TokColon) {
@@ -659,8 +928,7 @@ JSValue LiteralParser<CharType>::parse(ParserState initialState)
                     return JSValue();
                 }
                 m_lexer.next();
-                lastValue = objectStack.last();
-                objectStack.removeLast();
+                lastValue = constructEmptyObject(m_exec);
                 break;
             }
             doParseObjectStartExpression:
@@ -670,11 +938,13 @@ JSValue LiteralParser<CharType>::parse(ParserState initialState)
                     m_parseErrorMessage = ASCIILiteral("Property name must be a string literal");
                     return JSValue();
                 }
+                PendingObject& pendingObject = pendingObjects.last();
+                unsigned propertyIndex = identifierStack.size() - pendingObject.firstPropertyName;
                 typename Lexer::LiteralParserTokenPtr identifierToken = m_lexer.currentToken();
                 if (identifierToken->stringIs8Bit)
-                    identifierStack.append(makeIdentifier(identifierToken->stringToken8, identifierToken->stringLength));
+                    identifierStack.append(makePropertyName(identifierToken->stringToken8, identifierToken->stringLength, pendingObject.shape, propertyIndex));
                 else
-                    identifierStack.append(makeIdentifier(identifierToken->stringToken16, identifierToken->stringLength));
+                    identifierStack.append(makePropertyName(identifierToken->stringToken16, identifierToken->stringLength, pendingObject.shape, propertyIndex));
 
                 // Check for colon
                 if (m_lexer.next() != TokColon) {
@@ -688,24 +958,15 @@ JSValue LiteralParser<CharType>::parse(ParserState initialState)
             }
             case DoParseObjectEndExpression:
             {
-                JSObject* object = asObject(objectStack.last());
-                PropertyName ident = identifierStack.last();
-                if (m_mode != StrictJSON && ident == vm.propertyNames->underscoreProto) {
-                    if (!visitedUnderscoreProto.add(object).isNewEntry) {
+                PendingObject& pendingObject = pendingObjects.last();
+                if (m_mode != StrictJSON && identifierStack.last() == vm.propertyNames->underscoreProto) {
+                    if (pendingObject.hasUnderscoreProto) {
                         m_parseErrorMessage = ASCIILiteral("Attempted to redefine __proto__ property");
                         return JSValue();
                     }
-                    CodeBlock* codeBlock = m_exec->codeBlock();
-                    PutPropertySlot slot(object, codeBlock ? codeBlock->isStrictMode() : false);
-                    objectStack.last().put(m_exec, ident, lastValue, slot);
-                } else {
-                    if (std::optional<uint32_t> index = parseIndex(ident))
-                        object->putDirectIndex(m_exec, index.value(), lastValue);
-                    else
-                        object->putDirect(vm, ident, lastValue);
+                    pendingObject.hasUnderscoreProto = true;
                 }
-                RETURN_IF_EXCEPTION(scope, JSValue());
-                identifierStack.removeLast();
+                objectStack.appendWithCrashOnOverflow(lastValue);
                 if (m_lexer.currentToken()->type == TokComma)
                     goto doParseObjectStartExpression;
                 if (m_lexer.currentToken()->type != TokRBrace) {
@@ -713,8 +974,14 @@ JSValue LiteralParser<CharType>::parse(ParserState initialState)
                     return JSValue();
                 }
                 m_lexer.next();
-                lastValue = objectStack.last();
-                objectStack.removeLast();
+                unsigned propertyCount = identifierStack.size() - pendingObject.firstPropertyName;
+                JSObject* object = constructObject(pendingObject.shape, identifierStack.data() + pendingObject.firstPropertyName, objectStack, pendingObject.firstValue, propertyCount, pendingObject.hasUnderscoreProto);
+                RETURN_IF_EXCEPTION(scope, JSValue());
+                identifierStack.shrink(pendingObject.firstPropertyName);
+                while (objectStack.size() > pendingObject.firstValue)
+                    objectStack.removeLast();
+                pendingObjects.removeLast();
+                lastValue = object;
                 break;
             }
             startParseExpression:
@@ -27,12 +27,17 @@
 
 #include "Identifier.h"
 #include "JSCJSValue.h"
+#include "PropertyOffset.h"
+#include "Strong.h"
 #include <array>
 #include <wtf/text/StringBuilder.h>
 #include <wtf/text/WTFString.h>
 
 namespace JSC {
 
+class MarkedArgumentBuffer;
+class Structure;
+
 typedef enum { StrictJSON, NonStrictJSON, JSONP } ParserMode;
 
 enum JSONPPathEntryType {
@@ -199,6 +204,22 @@ private:
     std::array<Identifier, MaximumCachableCharacter> m_recentIdentifiers;
     ALWAYS_INLINE const Identifier makeIdentifier(const LChar* characters, size_t length);
     ALWAYS_INLINE const Identifier makeIdentifier(const UChar* characters, size_t length);
+
+    // The property names of an object built by the generic path, and where its final Structure
+    // keeps them. Later objects with the same keys are allocated with that Structure directly.
+    struct ObjectShape {
+        Vector<Identifier> propertyNames;
+        Vector<PropertyOffset> propertyOffsets;
+        Strong<Structure> structure;
+    };
+    static const unsigned noObjectShape = UINT_MAX;
+    static const unsigned maximumObjectShapes = 8;
+    static const unsigned maximumObjectShapeSize = 64;
+    Vector<ObjectShape> m_objectShapes;
+    unsigned m_nextObjectShapeToReplace { 0 };
+    template <typename TokenCharType> ALWAYS_INLINE const Identifier makePropertyName(const TokenCharType* characters, size_t length, unsigned& shapeIndex, unsigned propertyIndex);
+    JSObject* constructObject(unsigned shapeIndex, const Identifier* propertyNames, MarkedArgumentBuffer& values, unsigned firstValue, unsigned propertyCount, bool hasUnderscoreProto);
+    void recordObjectShape(JSObject*, const Identifier* propertyNames, unsigned propertyCount);
 };
 
 } // namespace JSC
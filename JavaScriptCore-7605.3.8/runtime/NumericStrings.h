@@ -66,6 +66,15 @@ public:
         entry.value = String::number(i);
         return entry.value;
     }
+
+    void clear()
+    {
+        doubleCache.fill(CacheEntry<double>());
+        intCache.fill(CacheEntry<int>());
+        unsignedCache.fill(CacheEntry<unsigned>());
+        smallIntCache.fill(String());
+    }
+
 private:
     static const size_t cacheSize = 64;
 
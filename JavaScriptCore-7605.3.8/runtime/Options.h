@@ -122,7 +122,11 @@ constexpr bool enableAsyncIteration = false;
     v(bool, useBaselineJIT, true, Normal, "allows the baseline JIT to be used if true") \
     v(bool, useDFGJIT, true, Normal, "allows the DFG JIT to be used if true") \
     v(bool, useRegExpJIT, true, Normal, "allows the RegExp JIT to be used if true") \
+    v(bool, useRegExpJITLiteralScan, true, Normal, "lets RegExp JIT code skip to input positions that can start a match by scanning for literal characters the pattern requires") \
+    v(bool, useLinearRegExpMatcher, true, Normal, "reruns RegExp matches that exceed the backtracking step limit with the linear-time matcher, when the pattern has no backreferences or lookarounds") \
+    v(bool, forceLinearRegExpMatcher, false, Normal, "matches every RegExp that the linear-time matcher supports with it instead of backtracking") \
     v(bool, useDOMJIT, true, Normal, "allows the DOMJIT to be used if true") \
+    v(bool, useJSONFastStringify, true, Normal, "lets JSON.stringify serialize plain objects and arrays straight from their Structures and butterflies when there is no replacer or gap") \
     \
     v(bool, reportMustSucceedExecutableAllocations, false, Normal, nullptr) \
     \
@@ -157,6 +161,9 @@ constexpr bool enableAsyncIteration = false;
     /* dumpDisassembly implies dumpDFGDisassembly. */ \
     v(bool, dumpDisassembly, false, Normal, "dumps disassembly of all JIT compiled code upon compilation") \
     v(bool, asyncDisassembly, false, Normal, nullptr) \
+    v(bool, logJITCodeForPerf, false, Configurable, "writes /tmp/perf-<pid>.map entries for all JIT compiled code so that Linux perf can symbolize it") \
+    v(bool, useJITDump, false, Configurable, "when logJITCodeForPerf is set, also writes the code to jit-<pid>.dump for perf inject --jit") \
+    v(optionString, jitDumpDirectory, nullptr, Normal, "directory for the jit-<pid>.dump file, the current directory by default") \
     v(bool, dumpDFGDisassembly, false, Normal, "dumps disassembly of DFG function upon compilation") \
     v(bool, dumpFTLDisassembly, false, Normal, "dumps disassembly of FTL function upon compilation") \
     v(bool, dumpAllDFGNodes, false, Normal, nullptr) \
@@ -204,6 +211,11 @@ constexpr bool enableAsyncIteration = false;
     v(bool, testTheFTL, false, Normal, nullptr) \
     v(bool, verboseSanitizeStack, false, Normal, nullptr) \
     v(bool, useGenerationalGC, true, Normal, nullptr) \
+    v(bool, usePretenuring, false, Normal, "If true, the optimizing JITs allocate objects from sites whose objects tend to survive eden collections directly into the old generation. Pretenured allocations are not inlined yet.") \
+    v(unsigned, allocationSiteSamplingInterval, 8, Normal, "number of allocations an allocation site skips between survival samples") \
+    v(unsigned, pretenuringSampleWindow, 4, Normal, "number of survival samples an allocation site needs before it can be pretenured") \
+    v(double, pretenuringSurvivalRate, 0.9, Normal, "fraction of an allocation site's samples that must survive for it to be pretenured") \
+    v(unsigned, maximumPretenuringUndos, 2, Normal, "number of times an allocation site may be pretenured and then found to allocate short-lived objects before it is never pretenured again") \
     v(bool, useConcurrentBarriers, true, Normal, nullptr) \
     v(bool, useConcurrentGC, true, Normal, nullptr) \
     v(bool, collectContinuously, false, Normal, nullptr) \
@@ -227,6 +239,9 @@ constexpr bool enableAsyncIteration = false;
     v(bool, useStochasticMutatorScheduler, true, Normal, nullptr) \
     v(double, minimumGCPauseMS, 0.3, Normal, nullptr) \
     v(double, gcPauseScale, 0.3, Normal, nullptr) \
+    v(double, gcMaximumPauseMS, 0, Normal, "if positive, the concurrent GC schedules its pauses to be no longer than this") \
+    v(double, gcMinimumMutatorUtilization, 0.5, Normal, "the share of every gcMutatorUtilizationWindowMS that the mutator gets while collecting, if gcMaximumPauseMS is set") \
+    v(double, gcMutatorUtilizationWindowMS, 10, Normal, nullptr) \
     v(double, gcIncrementBytes, 10000, Normal, nullptr) \
     v(double, gcIncrementMaxBytes, 100000, Normal, nullptr) \
     v(double, gcIncrementScale, 0, Normal, nullptr) \
@@ -237,6 +252,7 @@ constexpr bool enableAsyncIteration = false;
     v(bool, useBumpAllocator, true, Normal, nullptr) \
     v(bool, stealEmptyBlocksFromOtherAllocators, true, Normal, nullptr) \
     v(bool, tradeDestructorBlocks, true, Normal, nullptr) \
+    v(bool, useParallelSweeping, true, Normal, "If true, GC helper threads build the free lists of blocks without destructors after each collection, before the allocators get to them.") \
     v(bool, eagerlyUpdateTopCallFrame, false, Normal, nullptr) \
     \
     v(bool, useOSREntryToDFG, true, Normal, nullptr) \
@@ -360,11 +376,14 @@ constexpr bool enableAsyncIteration = false;
     v(unsigned, opaqueRootMergeThreshold, 1000, Normal, nullptr) \
     v(double, minHeapUtilization, 0.8, Normal, nullptr) \
     v(double, minMarkedBlockUtilization, 0.9, Normal, nullptr) \
+    v(double, sparseBlockUtilization, 0.5, Normal, "Blocks that are at most this full get the pages that only hold dead cells returned to the OS by Heap::releaseFragmentedMemory().") \
     v(unsigned, slowPathAllocsBetweenGCs, 0, Normal, "force a GC on every Nth slow path alloc, where N is specified by this option") \
     \
     v(double, percentCPUPerMBForFullTimer, 0.0003125, Normal, nullptr) \
     v(double, percentCPUPerMBForEdenTimer, 0.0025, Normal, nullptr) \
     v(double, collectionTimerMaxPercentCPU, 0.05, Normal, nullptr) \
+    v(bool, useManualJSRunLoopTimers, false, Normal, "Fire GC, sweeping and other VM timers only when the embedder calls JSContextGroupFireDueTimers(). Ignored with CoreFoundation.") \
+    v(bool, useJSRunLoopTimerThread, false, Normal, "Fire GC, sweeping and other VM timers from a dedicated thread rather than from the RunLoop of the thread that created the VM. Ignored with CoreFoundation.") \
     \
     v(bool, forceWeakRandomSeed, false, Normal, nullptr) \
     v(unsigned, forcedWeakRandomSeed, 0, Normal, nullptr) \
@@ -384,6 +403,8 @@ constexpr bool enableAsyncIteration = false;
     v(bool, logHeapStatisticsAtExit, false, Normal, nullptr) \
     v(bool, forceCodeBlockToJettisonDueToOldAge, false, Normal, "If true, this means that anytime we can jettison a CodeBlock due to old age, we do.") \
     v(bool, useEagerCodeBlockJettisonTiming, false, Normal, "If true, the time slices for jettisoning a CodeBlock due to old age are shrunk significantly.") \
+    v(bool, useUnlinkedCodeBlockJettisoning, true, Normal, "If true, the bytecode of functions that have not been linked for a number of full collections is thrown away, and regenerated from source when needed.") \
+    v(unsigned, unlinkedCodeBlockMaxAge, 7, Normal, "Number of full collections after which the bytecode of a function that has not been linked or found running since is thrown away.") \
     \
     v(bool, useTypeProfiler, false, Normal, nullptr) \
     v(bool, useControlFlowProfiler, false, Normal, nullptr) \
@@ -395,6 +416,8 @@ constexpr bool enableAsyncIteration = false;
     v(unsigned, samplingProfilerTopBytecodesCount, 40, Normal, "Number of top bytecodes to report when using the command line interface.") \
     v(optionString, samplingProfilerPath, nullptr, Normal, "The path to the directory to write sampiling profiler output to. This probably will not work with WK2 unless the path is in the whitelist.") \
     v(bool, sampleCCode, false, Normal, "Causes the sampling profiler to record profiling data for C frames.") \
+    v(bool, useAllocationProfiler, false, Normal, "If true, samples allocations and records the JS stacks that made them.") \
+    v(unsigned, allocationProfilerSampleInterval, 512 * 1024, Normal, "Average number of bytes allocated between two samples of the allocation profiler.") \
     \
     v(bool, alwaysGeneratePCToCodeOriginMap, false, Normal, "This will make sure we always generate a PCToCodeOriginMap for JITed code.") \
     \
@@ -457,8 +480,13 @@ constexpr bool enableAsyncIteration = false;
     \
     v(bool, useSourceProviderCache, true, Normal, "If false, the parser will not use the source provider cache. It's good to verify everything works when this is false. Because the cache is so successful, it can mask bugs.") \
     v(bool, useCodeCache, true, Normal, "If false, the unlinked byte code cache will not be used.") \
+    v(optionString, diskCachePath, nullptr, Normal, "If set, unlinked byte code is written to and loaded from files in this directory.") \
+    v(optionString, profileCachePath, nullptr, Normal, "If set, value, array and arith profiles of hot functions and the tier they reached are loaded from this file at startup and written back to it when the VM is destroyed.") \
+    v(double, profileCacheThresholdScale, 0.1, Normal, "scale the warm-up thresholds of functions that the profile cache saw reach a tier to this ratio between 0.0 (compile ASAP) and 1.0 (compile like normal).") \
     \
     v(bool, useWebAssembly, true, Normal, "Expose the WebAssembly global object.") \
+    v(bool, useWebAssemblySIMD, false, Normal, "Allow 128-bit SIMD types and instructions in WebAssembly code, if the CPU supports them. Only a subset of the proposal is implemented, and v128 is not yet allowed in signatures or globals.") \
+    v(bool, useWebAssemblyThreads, true, Normal, "Allow shared WebAssembly memories and the atomic memory instructions.") \
     \
     v(bool, enableSpectreMitigations, true, Restricted, "Enable Spectre mitigations.") \
     v(bool, enableSpectreGadgets, false, Restricted, "enable gadgets to test Spectre mitigations.") \
@@ -472,6 +500,8 @@ constexpr bool enableAsyncIteration = false;
     v(unsigned, webAssemblyOMGOptimizationLevel, Options::defaultB3OptLevel(), Normal, "B3 Optimization level for OMG Web Assembly module compilations.") \
     \
     v(bool, useBBQTierUpChecks, true, Normal, "Enables tier up checks for our BBQ code.") \
+    v(bool, useRelocatableBBQCode, false, Normal, "Record the relocations of BBQ code so that compiled WebAssembly modules can be serialized. Relocatable code can't use jump tables or constant pools, so only turn this on when modules will be serialized.") \
+    v(bool, useWebAssemblySinglePassTier, false, Normal, "Compile WebAssembly functions with the single-pass baseline compiler instead of BBQ, falling back to BBQ for functions it doesn't support. Single-pass code tiers up straight to OMG.") \
     v(unsigned, webAssemblyOMGTierUpCount, 5000, Normal, "The countdown before we tier up a function to OMG.") \
     v(unsigned, webAssemblyLoopDecrement, 15, Normal, "The amount the tier up countdown is decremented on each loop backedge.") \
     v(unsigned, webAssemblyFunctionEntryDecrement, 1, Normal, "The amount the tier up countdown is decremented on each function entry.") \
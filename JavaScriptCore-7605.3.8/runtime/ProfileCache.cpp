@@ -0,0 +1,340 @@
+/*
+ * Copyright (C) 2018 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "ProfileCache.h"
+
+#include "ArithProfile.h"
+#include "CodeBlock.h"
+#include "CodeBlockSet.h"
+#include "Interpreter.h"
+#include "JSCInlines.h"
+#include <stdio.h>
+#include <wtf/ProcessID.h>
+#include <wtf/text/CString.h>
+
+namespace JSC {
+
+namespace ProfileCacheInternal {
+static const bool verbose = false;
+static const uint32_t magic = 0x4a534350; // 'JSCP'
+static const uint32_t version = 1;
+}
+
+class ProfileCacheEncoder {
+public:
+    template<typename T>
+    void encode(T value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "");
+        m_buffer.append(reinterpret_cast<const uint8_t*>(&value), sizeof(T));
+    }
+
+    const Vector<uint8_t>& buffer() const { return m_buffer; }
+
+private:
+    Vector<uint8_t> m_buffer;
+};
+
+class ProfileCacheDecoder {
+public:
+    ProfileCacheDecoder(const Vector<uint8_t>& buffer)
+        : m_buffer(buffer)
+    {
+    }
+
+    template<typename T>
+    bool decode(T& result)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "");
+        if (m_buffer.size() - m_offset < sizeof(T))
+            return false;
+        memcpy(&result, m_buffer.data() + m_offset, sizeof(T));
+        m_offset += sizeof(T);
+        return true;
+    }
+
+    // Counts come from the file, so make sure they cannot make us allocate more than the file could hold.
+    bool decodeCount(unsigned& result, size_t elementSize)
+    {
+        return decode(result) && result <= (m_buffer.size() - m_offset) / elementSize;
+    }
+
+    bool atEnd() const { return m_offset == m_buffer.size(); }
+
+private:
+    const Vector<uint8_t>& m_buffer;
+    size_t m_offset { 0 };
+};
+
+ProfileCache::ProfileCache()
+{
+    load();
+}
+
+ProfileCache::Key ProfileCache::keyFor(CodeBlock& codeBlock)
+{
+    return Key(codeBlock.hash().hash(), codeBlock.ownerScriptExecutable()->source().length());
+}
+
+void ProfileCache::seed(CodeBlock& codeBlock)
+{
+    if (m_entries.isEmpty())
+        return;
+
+    auto iter = m_entries.find(keyFor(codeBlock));
+    if (iter == m_entries.end())
+        return;
+
+    const Entry& entry = iter->value;
+    if (entry.instructionCount != codeBlock.instructions().size()
+        || entry.valueProfiles.size() != codeBlock.totalNumberOfValueProfiles())
+        return;
+
+    {
+        ConcurrentJSLocker locker(codeBlock.m_lock);
+
+        for (unsigned i = 0; i < entry.valueProfiles.size(); ++i)
+            mergeSpeculation(codeBlock.getFromAllValueProfiles(i).m_prediction, entry.valueProfiles[i]);
+
+        for (const ArrayProfileSnapshot& snapshot : entry.arrayProfiles) {
+            ArrayProfile* profile = codeBlock.getOrAddArrayProfile(locker, snapshot.bytecodeOffset);
+            profile->observeArrayMode(snapshot.observedArrayModes);
+            if (snapshot.mayStoreToHole)
+                *profile->addressOfMayStoreToHole() = true;
+            if (snapshot.outOfBounds)
+                profile->setOutOfBounds();
+        }
+    }
+
+    for (const ArithProfileSnapshot& snapshot : entry.arithProfiles) {
+        if (snapshot.bytecodeOffset >= codeBlock.instructions().size())
+            continue;
+        if (ArithProfile* profile = codeBlock.arithProfileForBytecodeOffset(snapshot.bytecodeOffset))
+            *profile = ArithProfile::fromInt(profile->bits() | snapshot.bits);
+    }
+
+    codeBlock.setProfileCacheTier(entry.tier);
+
+    if (ProfileCacheInternal::verbose)
+        dataLog("Seeded ", codeBlock, " from the profile cache, it reached ", JITCode::typeName(entry.tier), " before\n");
+}
+
+void ProfileCache::record(CodeBlock& codeBlock)
+{
+    // Only the LLInt and baseline CodeBlocks own profiles; optimized CodeBlocks point back at them.
+    if (codeBlock.alternative())
+        return;
+
+    CodeBlock* replacement = codeBlock.replacement();
+    JITCode::JITType tier = replacement ? replacement->jitType() : codeBlock.jitType();
+    if (tier < JITCode::DFGJIT && codeBlock.unlinkedCodeBlock()->didOptimize() == TrueTriState)
+        tier = JITCode::DFGJIT;
+
+    Key key = keyFor(codeBlock);
+    unsigned instructionCount = codeBlock.instructions().size();
+
+    // A function that was seeded from an entry already carries that entry's profiles, so there is
+    // nothing to merge except the tier, which a short run may not have reached again.
+    auto iter = m_entries.find(key);
+    if (iter != m_entries.end() && iter->value.instructionCount == instructionCount)
+        tier = std::max(tier, iter->value.tier);
+
+    // Code that never left the LLInt is not worth starting early.
+    if (tier < JITCode::BaselineJIT)
+        return;
+
+    codeBlock.updateAllPredictions();
+
+    Entry entry;
+    entry.instructionCount = instructionCount;
+    entry.tier = tier;
+
+    ConcurrentJSLocker locker(codeBlock.m_lock);
+
+    entry.valueProfiles.reserveInitialCapacity(codeBlock.totalNumberOfValueProfiles());
+    for (unsigned i = 0; i < codeBlock.totalNumberOfValueProfiles(); ++i)
+        entry.valueProfiles.uncheckedAppend(codeBlock.getFromAllValueProfiles(i).m_prediction);
+
+    const ArrayProfileVector& arrayProfiles = codeBlock.arrayProfiles();
+    for (unsigned i = 0; i < arrayProfiles.size(); ++i) {
+        const ArrayProfile& profile = arrayProfiles[i];
+        ArrayModes observedArrayModes = profile.observedArrayModes(locker);
+        bool mayStoreToHole = profile.mayStoreToHole(locker);
+        bool outOfBounds = profile.outOfBounds(locker);
+        if (!observedArrayModes && !mayStoreToHole && !outOfBounds)
+            continue;
+        entry.arrayProfiles.append(ArrayProfileSnapshot { profile.bytecodeOffset(), observedArrayModes, mayStoreToHole, outOfBounds });
+    }
+
+    Instruction* begin = codeBlock.instructions().begin();
+    Instruction* end = codeBlock.instructions().end();
+    for (Instruction* pc = begin; pc != end;) {
+        OpcodeID opcodeID = Interpreter::getOpcodeID(*pc);
+        if (ArithProfile* profile = codeBlock.arithProfileForPC(pc))
+            entry.arithProfiles.append(ArithProfileSnapshot { static_cast<unsigned>(pc - begin), profile->bits() });
+        pc += opcodeLengths[opcodeID];
+    }
+
+    m_entries.set(key, WTFMove(entry));
+}
+
+void ProfileCache::load()
+{
+    const char* path = Options::profileCachePath();
+    if (!path)
+        return;
+
+    FILE* file = fopen(path, "rb");
+    if (!file)
+        return;
+
+    Vector<uint8_t> buffer;
+    uint8_t chunk[4096];
+    while (size_t bytesRead = fread(chunk, 1, sizeof(chunk), file))
+        buffer.append(chunk, bytesRead);
+    fclose(file);
+
+    ProfileCacheDecoder decoder(buffer);
+    uint32_t magic;
+    uint32_t version;
+    unsigned numberOfEntries;
+    if (!decoder.decode(magic) || magic != ProfileCacheInternal::magic
+        || !decoder.decode(version) || version != ProfileCacheInternal::version
+        || !decoder.decode(numberOfEntries))
+        return;
+
+    auto decodeEntry = [&] (Key& key, Entry& entry) -> bool {
+        uint8_t tier;
+        if (!decoder.decode(key.first) || !decoder.decode(key.second)
+            || !decoder.decode(entry.instructionCount) || !decoder.decode(tier) || tier > JITCode::FTLJIT)
+            return false;
+        entry.tier = static_cast<JITCode::JITType>(tier);
+
+        unsigned count;
+        if (!decoder.decodeCount(count, sizeof(SpeculatedType)))
+            return false;
+        entry.valueProfiles.resize(count);
+        for (SpeculatedType& prediction : entry.valueProfiles) {
+            if (!decoder.decode(prediction))
+                return false;
+        }
+
+        if (!decoder.decodeCount(count, sizeof(unsigned) + sizeof(ArrayModes) + sizeof(uint8_t)))
+            return false;
+        entry.arrayProfiles.resize(count);
+        for (ArrayProfileSnapshot& snapshot : entry.arrayProfiles) {
+            uint8_t flags;
+            if (!decoder.decode(snapshot.bytecodeOffset) || snapshot.bytecodeOffset >= entry.instructionCount
+                || !decoder.decode(snapshot.observedArrayModes) || !decoder.decode(flags))
+                return false;
+            snapshot.mayStoreToHole = flags & 1;
+            snapshot.outOfBounds = flags & 2;
+        }
+
+        if (!decoder.decodeCount(count, sizeof(unsigned) + sizeof(uint32_t)))
+            return false;
+        entry.arithProfiles.resize(count);
+        for (ArithProfileSnapshot& snapshot : entry.arithProfiles) {
+            if (!decoder.decode(snapshot.bytecodeOffset) || snapshot.bytecodeOffset >= entry.instructionCount
+                || !decoder.decode(snapshot.bits))
+                return false;
+        }
+        return true;
+    };
+
+    HashMap<Key, Entry> entries;
+    for (unsigned i = 0; i < numberOfEntries; ++i) {
+        Key key;
+        Entry entry;
+        if (!decodeEntry(key, entry) || !HashMap<Key, Entry>::isValidKey(key))
+            return;
+        entries.set(key, WTFMove(entry));
+    }
+    if (!decoder.atEnd())
+        return;
+
+    m_entries = WTFMove(entries);
+
+    if (ProfileCacheInternal::verbose)
+        dataLog("Loaded ", m_entries.size(), " entries from the profile cache at ", path, "\n");
+}
+
+void ProfileCache::write(VM& vm)
+{
+    const char* path = Options::profileCachePath();
+    if (!path)
+        return;
+
+    {
+        auto codeBlockSetLocker = holdLock(vm.heap.codeBlockSet().getLock());
+        vm.heap.forEachCodeBlockIgnoringJITPlans(codeBlockSetLocker, [&] (CodeBlock* codeBlock) {
+            record(*codeBlock);
+        });
+    }
+
+    ProfileCacheEncoder encoder;
+    encoder.encode(ProfileCacheInternal::magic);
+    encoder.encode(ProfileCacheInternal::version);
+    encoder.encode(static_cast<unsigned>(m_entries.size()));
+    for (auto& iter : m_entries) {
+        const Entry& entry = iter.value;
+        encoder.encode(iter.key.first);
+        encoder.encode(iter.key.second);
+        encoder.encode(entry.instructionCount);
+        encoder.encode(static_cast<uint8_t>(entry.tier));
+        encoder.encode(static_cast<unsigned>(entry.valueProfiles.size()));
+        for (SpeculatedType prediction : entry.valueProfiles)
+            encoder.encode(prediction);
+        encoder.encode(static_cast<unsigned>(entry.arrayProfiles.size()));
+        for (const ArrayProfileSnapshot& snapshot : entry.arrayProfiles) {
+            encoder.encode(snapshot.bytecodeOffset);
+            encoder.encode(snapshot.observedArrayModes);
+            encoder.encode(static_cast<uint8_t>((snapshot.mayStoreToHole ? 1 : 0) | (snapshot.outOfBounds ? 2 : 0)));
+        }
+        encoder.encode(static_cast<unsigned>(entry.arithProfiles.size()));
+        for (const ArithProfileSnapshot& snapshot : entry.arithProfiles) {
+            encoder.encode(snapshot.bytecodeOffset);
+            encoder.encode(snapshot.bits);
+        }
+    }
+
+    // Write to a private file and rename it into place, so that a process starting up at the
+    // same time either sees the old cache or the complete new one.
+    CString temporaryPath = String::format("%s.%d", path, static_cast<int>(getCurrentProcessID())).utf8();
+    FILE* file = fopen(temporaryPath.data(), "wb");
+    if (!file)
+        return;
+    const Vector<uint8_t>& buffer = encoder.buffer();
+    bool succeeded = fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+    succeeded = !fclose(file) && succeeded;
+    if (!succeeded || rename(temporaryPath.data(), path))
+        remove(temporaryPath.data());
+
+    if (ProfileCacheInternal::verbose)
+        dataLog("Wrote ", m_entries.size(), " entries to the profile cache at ", path, "\n");
+}
+
+} // namespace JSC
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2018 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "ArrayProfile.h"
+#include "JITCode.h"
+#include "SpeculatedType.h"
+#include <wtf/HashMap.h>
+#include <wtf/Vector.h>
+
+namespace JSC {
+
+class CodeBlock;
+class VM;
+
+// The profile cache remembers what the profiling tiers learned about hot functions so that a
+// new process can start from there instead of re-learning it. Entries are keyed by the
+// CodeBlockHash (a hash of the function's source text and specialization kind) and the length
+// of that source, and are only applied to CodeBlocks whose bytecode has the same shape.
+//
+// Seeding a CodeBlock merges the cached value, array and arith profiles into its own and lowers
+// its tier-up thresholds by Options::profileCacheThresholdScale() for every tier the function
+// reached before. Speculation is still checked as usual, so a stale entry can only cost OSR exits.
+class ProfileCache {
+    WTF_MAKE_FAST_ALLOCATED;
+    WTF_MAKE_NONCOPYABLE(ProfileCache);
+public:
+    ProfileCache();
+
+    void seed(CodeBlock&);
+    void write(VM&);
+
+private:
+    typedef std::pair<unsigned, unsigned> Key;
+
+    struct ArrayProfileSnapshot {
+        unsigned bytecodeOffset;
+        ArrayModes observedArrayModes;
+        bool mayStoreToHole;
+        bool outOfBounds;
+    };
+
+    struct ArithProfileSnapshot {
+        unsigned bytecodeOffset;
+        uint32_t bits;
+    };
+
+    struct Entry {
+        unsigned instructionCount { 0 };
+        JITCode::JITType tier { JITCode::None };
+        Vector<SpeculatedType> valueProfiles;
+        Vector<ArrayProfileSnapshot> arrayProfiles;
+        Vector<ArithProfileSnapshot> arithProfiles;
+    };
+
+    static Key keyFor(CodeBlock&);
+    void record(CodeBlock&);
+    void load();
+
+    HashMap<Key, Entry> m_entries;
+};
+
+} // namespace JSC
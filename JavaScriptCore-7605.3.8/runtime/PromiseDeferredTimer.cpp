@@ -43,6 +43,11 @@ PromiseDeferredTimer::PromiseDeferredTimer(VM& vm)
 {
 }
 
+PromiseDeferredTimer::~PromiseDeferredTimer()
+{
+    stop();
+}
+
 void PromiseDeferredTimer::doWork()
 {
     ASSERT(m_vm->currentThreadIsHoldingAPILock());
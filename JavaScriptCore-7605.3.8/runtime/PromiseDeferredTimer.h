@@ -43,6 +43,7 @@ public:
     using Base = JSRunLoopTimer;
 
     PromiseDeferredTimer(VM&);
+    ~PromiseDeferredTimer();
 
     void doWork() override;
 
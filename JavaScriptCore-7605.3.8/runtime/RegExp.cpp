@@ -29,7 +29,9 @@
 #include "RegExpInlines.h"
 #include "Yarr.h"
 #include "YarrJIT.h"
+#include "YarrLinearMatcher.h"
 #include <wtf/Assertions.h>
+#include <wtf/CompilationThread.h>
 
 namespace JSC {
 
@@ -243,6 +245,8 @@ size_t RegExp::estimatedSize(JSCell* cell)
 {
     RegExp* thisObject = static_cast<RegExp*>(cell);
     size_t regexDataSize = thisObject->m_regExpBytecode ? thisObject->m_regExpBytecode->estimatedSizeInBytes() : 0;
+    if (thisObject->m_linearPattern)
+        regexDataSize += thisObject->m_linearPattern->estimatedSizeInBytes();
 #if ENABLE(YARR_JIT)
     regexDataSize += thisObject->m_regExpJITCode.size();
 #endif
@@ -285,6 +289,47 @@ void RegExp::byteCodeCompileIfNecessary(VM* vm)
     m_regExpBytecode = byteCodeCompilePattern(vm, pattern);
 }
 
+bool RegExp::linearCompileIfNecessary(VM* vm)
+{
+    // Compiler threads get here through matchConcurrently(), which already holds m_lock.
+    ConcurrentJSLocker locker(isCompilationThread() ? nullptr : &m_lock);
+
+    if (m_linearPattern)
+        return true;
+    if (m_linearCompileFailed || !Options::useLinearRegExpMatcher())
+        return false;
+
+    Yarr::YarrPattern pattern(m_patternString, m_flags, m_constructionErrorCode, vm->stackLimit());
+    if (hasError(m_constructionErrorCode)) {
+        RELEASE_ASSERT_NOT_REACHED();
+#if COMPILER_QUIRK(CONSIDERS_UNREACHABLE_CODE)
+        m_state = ParseError;
+        return false;
+#endif
+    }
+    ASSERT(m_numSubpatterns == pattern.m_numSubpatterns);
+
+    m_linearPattern = Yarr::linearCompile(pattern);
+    m_linearCompileFailed = !m_linearPattern;
+    return !m_linearCompileFailed;
+}
+
+bool RegExp::compileLinearPatternIfForced(Yarr::YarrPattern& pattern)
+{
+    if (!Options::forceLinearRegExpMatcher() || m_linearCompileFailed)
+        return false;
+
+    if (!m_linearPattern)
+        m_linearPattern = Yarr::linearCompile(pattern);
+    if (!m_linearPattern) {
+        m_linearCompileFailed = true;
+        return false;
+    }
+
+    m_state = LinearCode;
+    return true;
+}
+
 void RegExp::compile(VM* vm, Yarr::YarrCharSize charSize)
 {
     ConcurrentJSLocker locker(m_lock);
@@ -305,8 +350,11 @@ void RegExp::compile(VM* vm, Yarr::YarrCharSize charSize)
         m_state = ByteCode;
     }
 
+    if (compileLinearPatternIfForced(pattern))
+        return;
+
 #if ENABLE(YARR_JIT)
-    if (!pattern.m_containsBackreferences && !pattern.containsUnsignedLengthPattern() && VM::canUseRegExpJIT()) {
+    if (!pattern.containsUnsignedLengthPattern() && VM::canUseRegExpJIT()) {
         Yarr::jitCompile(pattern, charSize, vm, m_regExpJITCode);
         if (!m_regExpJITCode.isFallBack()) {
             m_state = JITCode;
@@ -361,8 +409,11 @@ void RegExp::compileMatchOnly(VM* vm, Yarr::YarrCharSize charSize)
         m_state = ByteCode;
     }
 
+    if (compileLinearPatternIfForced(pattern))
+        return;
+
 #if ENABLE(YARR_JIT)
-    if (!pattern.m_containsBackreferences && !pattern.containsUnsignedLengthPattern() && VM::canUseRegExpJIT()) {
+    if (!pattern.containsUnsignedLengthPattern() && VM::canUseRegExpJIT()) {
         Yarr::jitCompile(pattern, charSize, vm, m_regExpJITCode, Yarr::MatchOnly);
         if (!m_regExpJITCode.isFallBack()) {
             m_state = JITCode;
@@ -407,6 +458,8 @@ void RegExp::deleteCode()
     m_regExpJITCode.clear();
 #endif
     m_regExpBytecode = nullptr;
+    m_linearPattern = nullptr;
+    m_linearCompileFailed = false;
 }
 
 #if ENABLE(YARR_JIT_DEBUG)
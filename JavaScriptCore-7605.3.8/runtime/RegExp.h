@@ -135,10 +135,14 @@ private:
         ParseError,
         JITCode,
         ByteCode,
+        LinearCode,
         NotCompiled
     };
 
     void byteCodeCompileIfNecessary(VM*);
+    bool linearCompileIfNecessary(VM*);
+    bool compileLinearPatternIfForced(Yarr::YarrPattern&);
+    int matchAfterHittingMatchLimit(VM&, const String&, unsigned startOffset, int* offsetVector);
 
     void compile(VM*, Yarr::YarrCharSize);
     void compileIfNecessary(VM&, Yarr::YarrCharSize);
@@ -171,6 +175,8 @@ private:
     Yarr::YarrCodeBlock m_regExpJITCode;
 #endif
     std::unique_ptr<Yarr::BytecodePattern> m_regExpBytecode;
+    std::unique_ptr<Yarr::LinearPattern> m_linearPattern;
+    bool m_linearCompileFailed { false };
 };
 
 } // namespace JSC
@@ -27,6 +27,7 @@
 #include "Yarr.h"
 #include "YarrInterpreter.h"
 #include "YarrJIT.h"
+#include "YarrLinearMatcher.h"
 
 #define REGEXP_FUNC_TEST_DATA_GEN 0
 
@@ -164,6 +165,7 @@ ALWAYS_INLINE int RegExp::matchInline(VM& vm, const String& s, unsigned startOff
         if (result == Yarr::JSRegExpJITCodeFailure) {
             // JIT'ed code couldn't handle expression, so punt back to the interpreter.
             byteCodeCompileIfNecessary(&vm);
+            vm.regExpInterpreterFallbackCount++;
             result = Yarr::interpret(m_regExpBytecode.get(), s, startOffset, reinterpret_cast<unsigned*>(offsetVector));
         }
 
@@ -171,8 +173,19 @@ ALWAYS_INLINE int RegExp::matchInline(VM& vm, const String& s, unsigned startOff
         matchCompareWithInterpreter(s, startOffset, offsetVector, result);
 #endif
     } else
+#endif
+    if (m_state == LinearCode)
+        result = Yarr::linearMatch(m_linearPattern.get(), s, startOffset, reinterpret_cast<unsigned*>(offsetVector));
+    else {
+#if ENABLE(YARR_JIT)
+        if (m_regExpJITCode.isFallBack())
+            vm.regExpInterpreterFallbackCount++;
 #endif
         result = Yarr::interpret(m_regExpBytecode.get(), s, startOffset, reinterpret_cast<unsigned*>(offsetVector));
+    }
+
+    if (result == Yarr::JSRegExpErrorHitLimit)
+        result = matchAfterHittingMatchLimit(vm, s, startOffset, offsetVector);
 
     // FIXME: The YARR engine should handle unsigned or size_t length matches.
     // The YARR Interpreter is "unsigned" clean, while the YARR JIT hasn't been addressed.
@@ -232,6 +245,15 @@ ALWAYS_INLINE bool RegExp::hasMatchOnlyCodeFor(Yarr::YarrCharSize charSize)
     return false;
 }
 
+ALWAYS_INLINE int RegExp::matchAfterHittingMatchLimit(VM& vm, const String& s, unsigned startOffset, int* offsetVector)
+{
+    // Backtracking gave up on this input. Patterns that can be matched in linear time get a
+    // real answer from the linear matcher; the rest still report no match.
+    if (!linearCompileIfNecessary(&vm))
+        return -1;
+    return Yarr::linearMatch(m_linearPattern.get(), s, startOffset, reinterpret_cast<unsigned*>(offsetVector));
+}
+
 ALWAYS_INLINE void RegExp::compileIfNecessaryMatchOnly(VM& vm, Yarr::YarrCharSize charSize)
 {
     if (hasMatchOnlyCodeFor(charSize))
@@ -250,6 +272,7 @@ ALWAYS_INLINE MatchResult RegExp::matchInline(VM& vm, const String& s, unsigned
     ASSERT(m_state != ParseError);
     compileIfNecessaryMatchOnly(vm, s.is8Bit() ? Yarr::Char8 : Yarr::Char16);
 
+    bool hitMatchLimit = false;
 #if ENABLE(YARR_JIT)
     MatchResult result;
 
@@ -275,11 +298,15 @@ ALWAYS_INLINE MatchResult RegExp::matchInline(VM& vm, const String& s, unsigned
         if (!result)
             m_rtMatchOnlyFoundCount++;
 #endif
-        if (result.start != static_cast<size_t>(Yarr::JSRegExpJITCodeFailure))
+        if (result.start == static_cast<size_t>(Yarr::JSRegExpErrorHitLimit))
+            hitMatchLimit = true;
+        else if (result.start != static_cast<size_t>(Yarr::JSRegExpJITCodeFailure))
             return result;
-
-        // JIT'ed code couldn't handle expression, so punt back to the interpreter.
-        byteCodeCompileIfNecessary(&vm);
+        else {
+            // JIT'ed code couldn't handle expression, so punt back to the interpreter.
+            byteCodeCompileIfNecessary(&vm);
+            vm.regExpInterpreterFallbackCount++;
+        }
     }
 #endif
 
@@ -288,7 +315,20 @@ ALWAYS_INLINE MatchResult RegExp::matchInline(VM& vm, const String& s, unsigned
     Vector<int, 32> nonReturnedOvector;
     nonReturnedOvector.grow(offsetVectorSize);
     offsetVector = nonReturnedOvector.data();
-    int r = Yarr::interpret(m_regExpBytecode.get(), s, startOffset, reinterpret_cast<unsigned*>(offsetVector));
+    int r;
+    if (m_state == LinearCode)
+        r = Yarr::linearMatch(m_linearPattern.get(), s, startOffset, reinterpret_cast<unsigned*>(offsetVector));
+    else if (hitMatchLimit)
+        r = matchAfterHittingMatchLimit(vm, s, startOffset, offsetVector);
+    else {
+#if ENABLE(YARR_JIT)
+        if (m_regExpJITCode.isFallBack())
+            vm.regExpInterpreterFallbackCount++;
+#endif
+        r = Yarr::interpret(m_regExpBytecode.get(), s, startOffset, reinterpret_cast<unsigned*>(offsetVector));
+        if (r == Yarr::JSRegExpErrorHitLimit)
+            r = matchAfterHittingMatchLimit(vm, s, startOffset, offsetVector);
+    }
 #if REGEXP_FUNC_TEST_DATA_GEN
     RegExpFunctionalTestCollector::get()->outputOneTest(this, s, startOffset, offsetVector, result);
 #endif
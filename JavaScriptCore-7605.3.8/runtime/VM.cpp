@@ -29,6 +29,7 @@
 #include "config.h"
 #include "VM.h"
 
+#include "AllocationProfiler.h"
 #include "ArgList.h"
 #include "ArrayBufferNeuteringWatchpoint.h"
 #include "BuiltinExecutables.h"
@@ -109,6 +110,7 @@
 #include "ProfilerDatabase.h"
 #include "ProgramCodeBlock.h"
 #include "ProgramExecutable.h"
+#include "ProfileCache.h"
 #include "PromiseDeferredTimer.h"
 #include "PropertyMapHashTable.h"
 #include "RegExpCache.h"
@@ -136,7 +138,10 @@
 #include "WeakGCMapInlines.h"
 #include "WebAssemblyFunction.h"
 #include "WebAssemblyWrapperFunction.h"
+#include <mutex>
 #include <wtf/CurrentTime.h>
+#include <wtf/MemoryFootprint.h>
+#include <wtf/MemoryPressureHandler.h>
 #include <wtf/ProcessID.h>
 #include <wtf/ReadWriteLock.h>
 #include <wtf/SimpleStats.h>
@@ -274,6 +279,7 @@ VM::VM(VMType vmType, HeapType heapType)
     , propertyTableSpace ISO_SUBSPACE_INIT(heap, destructibleCellHeapCellType.get(), PropertyTable)
     , structureRareDataSpace ISO_SUBSPACE_INIT(heap, destructibleCellHeapCellType.get(), StructureRareData)
     , structureSpace ISO_SUBSPACE_INIT(heap, destructibleCellHeapCellType.get(), Structure)
+    , unlinkedFunctionExecutableSpace ISO_SUBSPACE_INIT(heap, destructibleCellHeapCellType.get(), UnlinkedFunctionExecutable)
     , weakSetSpace ISO_SUBSPACE_INIT(heap, destructibleObjectHeapCellType.get(), JSWeakSet)
     , weakMapSpace ISO_SUBSPACE_INIT(heap, destructibleObjectHeapCellType.get(), JSWeakMap)
 #if ENABLE(WEBASSEMBLY)
@@ -284,6 +290,7 @@ VM::VM(VMType vmType, HeapType heapType)
     , executableToCodeBlockEdgesWithFinalizers(executableToCodeBlockEdgeSpace)
     , inferredTypesWithFinalizers(inferredTypeSpace)
     , inferredValuesWithFinalizers(inferredValueSpace)
+    , unlinkedFunctionExecutablesWithFinalizers(unlinkedFunctionExecutableSpace)
     , evalCodeBlockSpace ISO_SUBSPACE_INIT(heap, destructibleCellHeapCellType.get(), EvalCodeBlock)
     , functionCodeBlockSpace ISO_SUBSPACE_INIT(heap, destructibleCellHeapCellType.get(), FunctionCodeBlock)
     , moduleProgramCodeBlockSpace ISO_SUBSPACE_INIT(heap, destructibleCellHeapCellType.get(), ModuleProgramCodeBlock)
@@ -441,11 +448,16 @@ VM::VM(VMType vmType, HeapType heapType)
             m_samplingProfiler->registerForReportAtExit();
         m_samplingProfiler->start();
     }
+    if (Options::useAllocationProfiler())
+        ensureAllocationProfiler();
 #endif // ENABLE(SAMPLING_PROFILER)
 
     if (Options::alwaysGeneratePCToCodeOriginMap())
         setShouldBuildPCToCodeOriginMapping();
 
+    if (Options::profileCachePath())
+        m_profileCache = std::make_unique<ProfileCache>();
+
     if (Options::watchdog()) {
         Watchdog& watchdog = ensureWatchdog();
         watchdog.setTimeLimit(Seconds::fromMilliseconds(Options::watchdog()));
@@ -477,12 +489,18 @@ VM::~VM()
 #endif
     if (UNLIKELY(m_watchdog))
         m_watchdog->willDestroyVM(this);
-    m_traps.willDestroyVM();
+    // The low memory handler fires traps at the VMs it finds in the VMInspector, so we leave it before
+    // our traps shut down.
     VMInspector::instance().remove(this);
+    m_traps.willDestroyVM();
 
     // Never GC, ever again.
     heap.incrementDeferralDepth();
 
+    m_codeCache->write(*this);
+    if (m_profileCache)
+        m_profileCache->write(*this);
+
 #if ENABLE(SAMPLING_PROFILER)
     if (m_samplingProfiler) {
         m_samplingProfiler->reportDataToOptionFile();
@@ -626,6 +644,20 @@ SamplingProfiler& VM::ensureSamplingProfiler(RefPtr<Stopwatch>&& stopwatch)
         m_samplingProfiler = adoptRef(new SamplingProfiler(*this, WTFMove(stopwatch)));
     return *m_samplingProfiler;
 }
+
+AllocationProfiler& VM::ensureAllocationProfiler()
+{
+    if (!m_allocationProfiler) {
+        m_allocationProfiler = std::make_unique<AllocationProfiler>(*this, Options::allocationProfilerSampleInterval());
+
+        // Allocators that have been counting down without a profiler are nowhere near their next sample.
+        heap.objectSpace().resetAllocationSampling();
+
+        // Code that we compiled so far does not count down in its inline allocation sequences.
+        deleteAllLinkedCode(DeleteAllCodeIfNotCollecting);
+    }
+    return *m_allocationProfiler;
+}
 #endif // ENABLE(SAMPLING_PROFILER)
 
 #if ENABLE(JIT)
@@ -745,6 +777,102 @@ void VM::deleteAllCode(DeleteAllCodeEffort effort)
     });
 }
 
+size_t VM::shrinkFootprint()
+{
+    ASSERT(currentThreadIsHoldingAPILock());
+    RELEASE_ASSERT(!entryScope);
+
+    m_isShrinkFootprintPending = false;
+
+    std::optional<size_t> footprintBefore = memoryFootprint();
+#if ENABLE(ASSEMBLER)
+    size_t executableBytesBefore = ExecutableAllocator::committedByteCount();
+#endif
+
+    m_codeCache->clear();
+    m_regExpCache->deleteAllCode();
+    clearSourceProviderCaches();
+    structureCache.clear();
+    stringCache.clear();
+    numericStrings.clear();
+    dateInstanceCache.reset();
+    if (m_hasOwnPropertyCache)
+        m_hasOwnPropertyCache->clear();
+
+    // Every executable goes back to having no code. Functions get reparsed from their SourceProvider
+    // the next time they are called.
+    heap.deleteAllCodeBlocks(PreventCollectionAndDeleteAllCode);
+    heap.deleteAllUnlinkedCodeBlocks(PreventCollectionAndDeleteAllCode);
+
+    // The full collection destroys the CodeBlocks that we just dropped, which frees their JIT code.
+    // The executable allocator decommits the pages that this leaves empty.
+    size_t heapBytes = heap.releaseFragmentedMemory();
+
+    // Have bmalloc's scavenger decommit its free memory now rather than on its own schedule.
+    WTF::releaseFastMallocFreeMemory();
+
+    size_t result;
+    std::optional<size_t> footprintAfter = memoryFootprint();
+    if (footprintBefore && footprintAfter)
+        result = *footprintBefore > *footprintAfter ? *footprintBefore - *footprintAfter : 0;
+    else {
+        result = heapBytes;
+#if ENABLE(ASSEMBLER)
+        size_t executableBytesAfter = ExecutableAllocator::committedByteCount();
+        if (executableBytesBefore > executableBytesAfter)
+            result += executableBytesBefore - executableBytesAfter;
+#endif
+    }
+
+    if (Options::logGC())
+        dataLog("[VM<", RawPointer(this), ">: shrinking the footprint reclaimed ", result / 1024, "kb]\n");
+    return result;
+}
+
+void VM::shrinkFootprintWhenIdle()
+{
+    if (m_isShrinkFootprintPending)
+        return;
+    m_isShrinkFootprintPending = true;
+    whenIdle([this] () {
+        shrinkFootprint();
+    });
+}
+
+void VM::installLowMemoryHandler()
+{
+    static std::once_flag onceFlag;
+    std::call_once(onceFlag, [] {
+        MemoryPressureHandler& memoryPressureHandler = MemoryPressureHandler::singleton();
+        memoryPressureHandler.setLowMemoryHandler([previousHandler = memoryPressureHandler.takeLowMemoryHandler()] (Critical critical, Synchronous synchronous) {
+            if (previousHandler)
+                previousHandler(critical, synchronous);
+
+            // A VM removes itself from the VMInspector while holding its API lock, so we must not wait for
+            // an API lock while holding the VMInspector's lock. VMs whose lock we can't take right away are
+            // running on another thread, and get a trap instead of making us wait for their script to finish.
+            Vector<Ref<JSLock>> lockedAPILocks;
+            {
+                auto locker = holdLock(VMInspector::instance().getLock());
+                VMInspector::instance().iterate(locker, [&] (VM& vm) {
+                    JSLock& apiLock = vm.apiLock();
+                    if (apiLock.tryLock())
+                        lockedAPILocks.append(apiLock);
+                    else
+                        vm.notifyNeedShrinkFootprint();
+                    return VMInspector::FunctorStatus::Continue;
+                });
+            }
+
+            // Holding the API lock keeps the VM alive.
+            for (auto& apiLock : lockedAPILocks) {
+                apiLock->vm()->shrinkFootprintWhenIdle();
+                apiLock->unlock();
+            }
+        });
+    });
+}
+
 SourceProviderCache* VM::addSourceProviderCache(SourceProvider* sourceProvider)
 {
     auto addResult = sourceProviderCacheMap.add(sourceProvider, nullptr);
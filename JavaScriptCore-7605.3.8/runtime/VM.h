@@ -87,10 +87,14 @@ using WTF::SimpleStats;
 
 namespace JSC {
 
+#if ENABLE(SAMPLING_PROFILER)
+class AllocationProfiler;
+#endif
 class BuiltinExecutables;
 class BytecodeIntrinsicRegistry;
 class CodeBlock;
 class CodeCache;
+class ProfileCache;
 class CommonIdentifiers;
 class CustomGetterSetter;
 class DOMAttributeGetterSetter;
@@ -277,6 +281,9 @@ public:
 #if ENABLE(SAMPLING_PROFILER)
     SamplingProfiler* samplingProfiler() { return m_samplingProfiler.get(); }
     JS_EXPORT_PRIVATE SamplingProfiler& ensureSamplingProfiler(RefPtr<Stopwatch>&&);
+
+    AllocationProfiler* allocationProfiler() { return m_allocationProfiler.get(); }
+    JS_EXPORT_PRIVATE AllocationProfiler& ensureAllocationProfiler();
 #endif
 
 private:
@@ -358,6 +365,7 @@ public:
     IsoSubspace propertyTableSpace;
     IsoSubspace structureRareDataSpace;
     IsoSubspace structureSpace;
+    IsoSubspace unlinkedFunctionExecutableSpace;
     IsoSubspace weakSetSpace;
     IsoSubspace weakMapSpace;
 #if ENABLE(WEBASSEMBLY)
@@ -369,6 +377,7 @@ public:
     IsoCellSet executableToCodeBlockEdgesWithFinalizers;
     IsoCellSet inferredTypesWithFinalizers;
     IsoCellSet inferredValuesWithFinalizers;
+    IsoCellSet unlinkedFunctionExecutablesWithFinalizers;
     
     struct SpaceAndFinalizerSet {
         IsoSubspace space;
@@ -684,6 +693,9 @@ public:
     RegExpCache* m_regExpCache;
     BumpPointerAllocator m_regExpAllocator;
     ConcurrentJSLock m_regExpAllocatorLock;
+    // Number of matches that ran in the Yarr interpreter because JIT compilation or JIT code failed.
+    // Matches that never tried the JIT are not counted.
+    std::atomic<unsigned> regExpInterpreterFallbackCount { 0 };
 
 #if ENABLE(YARR_JIT_ALL_PARENS_EXPRESSIONS)
     static constexpr size_t patternContextBufferSize = 8192; // Space allocated to save nested parenthesis context
@@ -722,12 +734,24 @@ public:
 
     JSLock& apiLock() { return *m_apiLock; }
     CodeCache* codeCache() { return m_codeCache.get(); }
+    ProfileCache* profileCache() { return m_profileCache.get(); }
 
     JS_EXPORT_PRIVATE void whenIdle(std::function<void()>);
 
     JS_EXPORT_PRIVATE void deleteAllCode(DeleteAllCodeEffort);
     JS_EXPORT_PRIVATE void deleteAllLinkedCode(DeleteAllCodeEffort);
 
+    // Throws away everything that the VM can recreate on demand (compiled code, bytecode and caches)
+    // and returns the freed memory to the OS. Returns the number of bytes reclaimed. Must not be called
+    // while JavaScript is running; use shrinkFootprintWhenIdle() for that.
+    JS_EXPORT_PRIVATE size_t shrinkFootprint();
+    JS_EXPORT_PRIVATE void shrinkFootprintWhenIdle();
+
+    // Makes WTF::MemoryPressureHandler shrink the footprint of every VM in the process, after calling
+    // any low memory handler that the embedder installed before. initializeThreading() calls this, and
+    // calling it again does nothing.
+    JS_EXPORT_PRIVATE static void installLowMemoryHandler();
+
     WatchpointSet* ensureWatchpointSetForImpureProperty(const Identifier&);
     void registerWatchpointForImpureProperty(const Identifier&, Watchpoint*);
     
@@ -778,6 +802,10 @@ public:
     void notifyNeedDebuggerBreak() { m_traps.fireTrap(VMTraps::NeedDebuggerBreak); }
     void notifyNeedTermination() { m_traps.fireTrap(VMTraps::NeedTermination); }
     void notifyNeedWatchdogCheck() { m_traps.fireTrap(VMTraps::NeedWatchdogCheck); }
+    // Heap::finalize() may run on the thread that holds the API lock.
+    void notifyNeedHeapLimitCheck() { m_traps.fireTrapWithoutInvalidation(VMTraps::NeedHeapLimitCheck); }
+    // The low memory handler may run on any thread, and does not need optimized code to be thrown away.
+    void notifyNeedShrinkFootprint() { m_traps.fireTrapWithoutInvalidation(VMTraps::NeedShrinkFootprint); }
 
 #if ENABLE(EXCEPTION_SCOPE_VERIFICATION)
     StackTrace* nativeStackTraceOfLastThrow() const { return m_nativeStackTraceOfLastThrow.get(); }
@@ -875,6 +903,7 @@ private:
     bool m_globalConstRedeclarationShouldThrow { true };
     bool m_shouldBuildPCToCodeOriginMapping { false };
     std::unique_ptr<CodeCache> m_codeCache;
+    std::unique_ptr<ProfileCache> m_profileCache;
     std::unique_ptr<BuiltinExecutables> m_builtinExecutables;
     HashMap<String, RefPtr<WatchpointSet>> m_impurePropertyWatchpointSets;
     std::unique_ptr<TypeProfiler> m_typeProfiler;
@@ -886,6 +915,7 @@ private:
     size_t m_sizeOfLastScratchBuffer { 0 };
     InlineWatchpointSet m_primitiveGigacageEnabled;
     FunctionHasExecutedCache m_functionHasExecutedCache;
+    bool m_isShrinkFootprintPending { false };
     std::unique_ptr<ControlFlowProfiler> m_controlFlowProfiler;
     unsigned m_controlFlowProfilerEnabledCount;
     Deque<std::unique_ptr<QueuedTask>> m_microtaskQueue;
@@ -895,6 +925,7 @@ private:
     std::unique_ptr<HeapProfiler> m_heapProfiler;
 #if ENABLE(SAMPLING_PROFILER)
     RefPtr<SamplingProfiler> m_samplingProfiler;
+    std::unique_ptr<AllocationProfiler> m_allocationProfiler;
 #endif
     std::unique_ptr<ShadowChicken> m_shadowChicken;
     std::unique_ptr<BytecodeIntrinsicRegistry> m_bytecodeIntrinsicRegistry;
@@ -289,11 +289,22 @@ void VMTraps::willDestroyVM()
 void VMTraps::fireTrap(VMTraps::EventType eventType)
 {
     ASSERT(!vm().currentThreadIsHoldingAPILock());
+    setTrap(eventType, true);
+}
+
+void VMTraps::fireTrapWithoutInvalidation(VMTraps::EventType eventType)
+{
+    setTrap(eventType, false);
+}
+
+void VMTraps::setTrap(VMTraps::EventType eventType, bool shouldInvalidateCodeBlocks)
+{
     {
         auto locker = holdLock(*m_lock);
         ASSERT(!m_isShuttingDown);
         setTrapForEvent(locker, eventType);
-        m_needToInvalidatedCodeBlocks = true;
+        if (shouldInvalidateCodeBlocks)
+            m_needToInvalidatedCodeBlocks = true;
     }
     
 #if ENABLE(SIGNAL_BASED_VM_TRAPS)
@@ -342,6 +353,24 @@ void VMTraps::handleTraps(ExecState* exec, VMTraps::Mask mask)
             throwException(exec, scope, createTerminatedExecutionException(&vm));
             return;
 
+        case NeedHeapLimitCheck:
+            switch (vm.heap.checkHardHeapLimit(exec)) {
+            case Heap::HardHeapLimitAction::Continue:
+                continue;
+            case Heap::HardHeapLimitAction::ThrowOutOfMemoryError:
+                throwOutOfMemoryError(exec, scope);
+                return;
+            case Heap::HardHeapLimitAction::Terminate:
+                throwException(exec, scope, createTerminatedExecutionException(&vm));
+                return;
+            }
+            RELEASE_ASSERT_NOT_REACHED();
+            return;
+
+        case NeedShrinkFootprint:
+            vm.shrinkFootprintWhenIdle();
+            continue;
+
         default:
             RELEASE_ASSERT_NOT_REACHED();
         }
@@ -53,6 +53,8 @@ public:
         NeedDebuggerBreak,
         NeedTermination,
         NeedWatchdogCheck,
+        NeedHeapLimitCheck,
+        NeedShrinkFootprint,
         NumberOfEventTypes, // This entry must be last in this list.
         Invalid
     };
@@ -104,6 +106,9 @@ public:
     }
 
     JS_EXPORT_PRIVATE void fireTrap(EventType);
+    // Unlike fireTrap(), this may be called by the thread that holds the API lock, and it leaves the
+    // optimized code on the stack alone. The trap is handled at the next trap check.
+    void fireTrapWithoutInvalidation(EventType);
 
     void handleTraps(ExecState*, VMTraps::Mask);
 
@@ -129,6 +134,7 @@ private:
     }
 
     EventType takeTopPriorityTrap(Mask);
+    void setTrap(EventType, bool shouldInvalidateCodeBlocks);
 
 #if ENABLE(SIGNAL_BASED_VM_TRAPS)
     class SignalSender;
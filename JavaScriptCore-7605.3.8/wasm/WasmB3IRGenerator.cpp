@@ -29,10 +29,13 @@
 #if ENABLE(WEBASSEMBLY)
 
 #include "AllowMacroScratchRegisterUsageIf.h"
+#include "B3AtomicValue.h"
 #include "B3BasicBlockInlines.h"
 #include "B3CCallValue.h"
 #include "B3Compile.h"
+#include "B3Const128Value.h"
 #include "B3ConstPtrValue.h"
+#include "B3FenceValue.h"
 #include "B3FixSSA.h"
 #include "B3Generate.h"
 #include "B3InsertionSet.h"
@@ -203,6 +206,25 @@ public:
     PartialResult WARN_UNUSED_RETURN addOp(ExpressionType left, ExpressionType right, ExpressionType& result);
     PartialResult WARN_UNUSED_RETURN addSelect(ExpressionType condition, ExpressionType nonZero, ExpressionType zero, ExpressionType& result);
 
+    // SIMD
+    ExpressionType addSIMDConstant(v128_t);
+    PartialResult WARN_UNUSED_RETURN addSIMDLoad(ExpressionType pointer, ExpressionType& result, uint32_t offset);
+    PartialResult WARN_UNUSED_RETURN addSIMDStore(ExpressionType pointer, ExpressionType value, uint32_t offset);
+    PartialResult WARN_UNUSED_RETURN addSIMDSplat(SIMDLane, ExpressionType scalar, ExpressionType& result);
+    PartialResult WARN_UNUSED_RETURN addSIMDExtractLane(SIMDLane, uint8_t laneIndex, ExpressionType vector, ExpressionType& result);
+    PartialResult WARN_UNUSED_RETURN addSIMDReplaceLane(SIMDLane, uint8_t laneIndex, ExpressionType vector, ExpressionType scalar, ExpressionType& result);
+    PartialResult WARN_UNUSED_RETURN addSIMDUnary(SIMDOpType, ExpressionType value, ExpressionType& result);
+    PartialResult WARN_UNUSED_RETURN addSIMDBinary(SIMDOpType, ExpressionType left, ExpressionType right, ExpressionType& result);
+
+    // Atomics
+    PartialResult WARN_UNUSED_RETURN atomicLoad(AtomicOpType, ExpressionType pointer, ExpressionType& result, uint32_t offset);
+    PartialResult WARN_UNUSED_RETURN atomicStore(AtomicOpType, ExpressionType pointer, ExpressionType value, uint32_t offset);
+    PartialResult WARN_UNUSED_RETURN atomicBinaryRMW(AtomicOpType, ExpressionType pointer, ExpressionType value, ExpressionType& result, uint32_t offset);
+    PartialResult WARN_UNUSED_RETURN atomicCompareExchange(AtomicOpType, ExpressionType pointer, ExpressionType expected, ExpressionType value, ExpressionType& result, uint32_t offset);
+    PartialResult WARN_UNUSED_RETURN atomicWait(AtomicOpType, ExpressionType pointer, ExpressionType value, ExpressionType timeout, ExpressionType& result, uint32_t offset);
+    PartialResult WARN_UNUSED_RETURN atomicNotify(AtomicOpType, ExpressionType pointer, ExpressionType count, ExpressionType& result, uint32_t offset);
+    PartialResult WARN_UNUSED_RETURN atomicFence();
+
     // Control flow
     ControlData WARN_UNUSED_RETURN addTopLevel(Type signature);
     ControlData WARN_UNUSED_RETURN addBlock(Type signature);
@@ -230,12 +252,19 @@ public:
 
 private:
     void emitExceptionCheck(CCallHelpers&, ExceptionType);
+    void emitJumpToThunk(CCallHelpers&, Relocation::Target);
+
+    Value* relocatablePointer(Relocation::Target, const void*, Origin);
+    Value* relocatableInt32(Relocation::Target, int32_t);
 
     void emitTierUpCheck(uint32_t decrementCount, Origin);
 
     enum class ShouldMask { Yes, No };
     ExpressionType emitCheckAndPreparePointer(ExpressionType pointer, uint32_t offset, uint32_t sizeOfOp, ShouldMask);
     B3::Kind memoryKind(B3::Opcode memoryOp);
+    ExpressionType emitAtomicCheckAndPreparePointer(AtomicOpType, ExpressionType pointer, uint32_t offset);
+    ExpressionType truncateAtomicOperand(AtomicOpType, ExpressionType);
+    ExpressionType extendAtomicResult(AtomicOpType, ExpressionType);
     ExpressionType emitLoadOp(LoadOpType, ExpressionType pointer, uint32_t offset);
     void emitStoreOp(StoreOpType, ExpressionType pointer, ExpressionType value, uint32_t offset);
 
@@ -263,6 +292,7 @@ private:
     BasicBlock* m_currentBlock { nullptr };
     Vector<Variable*> m_locals;
     Vector<UnlinkedWasmToWasmCall>& m_unlinkedWasmToWasmCalls; // List each call site and the function index whose address it should be patched with.
+    Vector<Relocation>* m_relocations { nullptr }; // Only set if we are generating relocatable code.
     HashMap<ValueKey, Value*> m_constantPool;
     InsertionSet m_constantInsertionValues;
     GPRReg m_memoryBaseGPR { InvalidGPRReg };
@@ -282,6 +312,90 @@ private:
     uint32_t m_maxNumJSCallArguments { 0 };
 };
 
+static int32_t growMemory(void* callFrame, Instance* instance, int32_t delta)
+{
+    instance->storeTopCallFrame(callFrame);
+
+    if (delta < 0)
+        return -1;
+
+    auto grown = instance->memory()->grow(PageCount(delta));
+    if (!grown) {
+        switch (grown.error()) {
+        case Memory::GrowFailReason::InvalidDelta:
+        case Memory::GrowFailReason::InvalidGrowSize:
+        case Memory::GrowFailReason::WouldExceedMaximum:
+        case Memory::GrowFailReason::OutOfMemory:
+        case Memory::GrowFailReason::SharedMemory:
+            return -1;
+        }
+        RELEASE_ASSERT_NOT_REACHED();
+    }
+
+    return grown.value().pageCount();
+}
+
+static int32_t atomicWait32(void* callFrame, Instance* instance, void* address, int32_t expected, int64_t timeout)
+{
+    instance->storeTopCallFrame(callFrame);
+    return instance->atomicWait32(address, expected, timeout);
+}
+
+static int32_t atomicWait64(void* callFrame, Instance* instance, void* address, int64_t expected, int64_t timeout)
+{
+    instance->storeTopCallFrame(callFrame);
+    return instance->atomicWait64(address, expected, timeout);
+}
+
+static int32_t atomicNotify(void* callFrame, Instance* instance, void* address, int32_t count)
+{
+    instance->storeTopCallFrame(callFrame);
+    return instance->atomicNotify(address, count);
+}
+
+// FIXME: This should use the popcnt instruction if SSE4 is available but we don't have code to detect SSE4 yet.
+// see: https://bugs.webkit.org/show_bug.cgi?id=165363
+static uint32_t popcountInt32(int32_t value)
+{
+    return __builtin_popcount(value);
+}
+
+static uint64_t popcountInt64(int64_t value)
+{
+    return __builtin_popcountll(value);
+}
+
+void* addressOfRelocationTarget(Relocation::Target target)
+{
+    switch (target) {
+    case Relocation::Target::GrowMemory:
+        return bitwise_cast<void*>(growMemory);
+    case Relocation::Target::AtomicWait32:
+        return bitwise_cast<void*>(atomicWait32);
+    case Relocation::Target::AtomicWait64:
+        return bitwise_cast<void*>(atomicWait64);
+    case Relocation::Target::AtomicNotify:
+        return bitwise_cast<void*>(atomicNotify);
+    case Relocation::Target::PopcountInt32:
+        return bitwise_cast<void*>(popcountInt32);
+    case Relocation::Target::PopcountInt64:
+        return bitwise_cast<void*>(popcountInt64);
+    case Relocation::Target::ThrowException:
+        return Thunks::singleton().stub(throwExceptionFromWasmThunkGenerator).code().executableAddress();
+    case Relocation::Target::ThrowStackOverflow:
+        return Thunks::singleton().stub(throwStackOverflowFromWasmThunkGenerator).code().executableAddress();
+    case Relocation::Target::TriggerOMGTierUp:
+        return Thunks::singleton().stub(triggerOMGTierUpThunkGenerator).code().executableAddress();
+    case Relocation::Target::Callee:
+    case Relocation::Target::TierUpCount:
+    case Relocation::Target::SignatureIndex:
+    case Relocation::Target::Function:
+        break;
+    }
+    RELEASE_ASSERT_NOT_REACHED();
+    return nullptr;
+}
+
 // Memory accesses in WebAssembly have unsigned 32-bit offsets, whereas they have signed 32-bit offsets in B3.
 int32_t B3IRGenerator::fixupPointerPlusOffset(ExpressionType& ptr, uint32_t offset)
 {
@@ -334,6 +448,9 @@ B3IRGenerator::B3IRGenerator(const ModuleInformation& info, Procedure& procedure
 {
     m_currentBlock = m_proc.addBlock();
 
+    if (m_proc.needsRelocatableCode())
+        m_relocations = &compilation->relocations;
+
     // FIXME we don't really need to pin registers here if there's no memory. It makes wasm -> wasm thunks simpler for now. https://bugs.webkit.org/show_bug.cgi?id=166623
     const PinnedRegisterInfo& pinnedRegs = PinnedRegisterInfo::get();
 
@@ -439,8 +556,9 @@ B3IRGenerator::B3IRGenerator(const ModuleInformation& info, Procedure& procedure
                 if (UNLIKELY(needUnderflowCheck))
                     overflow.append(jit.branchPtr(CCallHelpers::Above, scratch1, fp));
                 overflow.append(jit.branchPtr(CCallHelpers::Below, scratch1, scratch2));
-                jit.addLinkTask([overflow] (LinkBuffer& linkBuffer) {
-                    linkBuffer.link(overflow, CodeLocationLabel(Thunks::singleton().stub(throwStackOverflowFromWasmThunkGenerator).code()));
+                params.addLatePath([=] (CCallHelpers& jit) {
+                    overflow.link(&jit);
+                    this->emitJumpToThunk(jit, Relocation::Target::ThrowStackOverflow);
                 });
             } else if (m_usesInstanceValue && Context::useFastTLS()) {
                 // No overflow check is needed, but the instance values still needs to be correct.
@@ -501,13 +619,63 @@ void B3IRGenerator::restoreWebAssemblyGlobalState(RestoreCachedStackLimit restor
 void B3IRGenerator::emitExceptionCheck(CCallHelpers& jit, ExceptionType type)
 {
     jit.move(CCallHelpers::TrustedImm32(static_cast<uint32_t>(type)), GPRInfo::argumentGPR1);
-    auto jumpToExceptionStub = jit.jump();
+    emitJumpToThunk(jit, Relocation::Target::ThrowException);
+}
 
-    jit.addLinkTask([jumpToExceptionStub] (LinkBuffer& linkBuffer) {
-        linkBuffer.link(jumpToExceptionStub, CodeLocationLabel(Thunks::singleton().stub(throwExceptionFromWasmThunkGenerator).code()));
+void B3IRGenerator::emitJumpToThunk(CCallHelpers& jit, Relocation::Target target)
+{
+    if (!m_relocations) {
+        auto jumpToThunk = jit.jump();
+        jit.addLinkTask([jumpToThunk, target] (LinkBuffer& linkBuffer) {
+            linkBuffer.link(jumpToThunk, CodeLocationLabel(addressOfRelocationTarget(target)));
+        });
+        return;
+    }
+
+    // Relocatable code may be copied away from the thunk, so we need a jump we can repatch.
+    auto jumpToThunk = jit.patchableJump();
+    Vector<Relocation>* relocations = m_relocations;
+    jit.addLinkTask([jumpToThunk, target, relocations] (LinkBuffer& linkBuffer) {
+        linkBuffer.link(jumpToThunk.m_jump, CodeLocationLabel(addressOfRelocationTarget(target)));
+        relocations->append({ linkBuffer.locationOf(jumpToThunk), target, 0 });
     });
 }
 
+Value* B3IRGenerator::relocatablePointer(Relocation::Target target, const void* pointer, Origin origin)
+{
+    if (!m_relocations)
+        return m_currentBlock->appendNew<ConstPtrValue>(m_proc, origin, pointer);
+
+    PatchpointValue* patchpoint = m_currentBlock->appendNew<PatchpointValue>(m_proc, pointerType(), origin);
+    patchpoint->effects = Effects::none();
+    Vector<Relocation>* relocations = m_relocations;
+    patchpoint->setGenerator([=] (CCallHelpers& jit, const StackmapGenerationParams& params) {
+        CCallHelpers::DataLabelPtr label = jit.moveWithPatch(CCallHelpers::TrustedImmPtr(pointer), params[0].gpr());
+        jit.addLinkTask([=] (LinkBuffer& linkBuffer) {
+            relocations->append({ linkBuffer.locationOf(label).labelAtOffset(0), target, 0 });
+        });
+    });
+    return patchpoint;
+}
+
+Value* B3IRGenerator::relocatableInt32(Relocation::Target target, int32_t value)
+{
+    if (!m_relocations)
+        return m_currentBlock->appendNew<Const32Value>(m_proc, origin(), value);
+
+    PatchpointValue* patchpoint = m_currentBlock->appendNew<PatchpointValue>(m_proc, Int32, origin());
+    patchpoint->effects = Effects::none();
+    Vector<Relocation>* relocations = m_relocations;
+    patchpoint->setGenerator([=] (CCallHelpers& jit, const StackmapGenerationParams& params) {
+        // Not every MacroAssembler can patch a 32-bit move, so this materializes a patchable pointer.
+        CCallHelpers::DataLabelPtr label = jit.moveWithPatch(CCallHelpers::TrustedImmPtr(static_cast<size_t>(static_cast<uint32_t>(value))), params[0].gpr());
+        jit.addLinkTask([=] (LinkBuffer& linkBuffer) {
+            relocations->append({ linkBuffer.locationOf(label).labelAtOffset(0), target, static_cast<uint32_t>(value) });
+        });
+    });
+    return patchpoint;
+}
+
 Value* B3IRGenerator::constant(B3::Type type, uint64_t bits, std::optional<Origin> maybeOrigin)
 {
     auto result = m_constantPool.ensure(ValueKey(opcodeForConstant(type), type, static_cast<int64_t>(bits)), [&] {
@@ -533,7 +701,12 @@ auto B3IRGenerator::addLocal(Type type, uint32_t count) -> PartialResult
     for (uint32_t i = 0; i < count; ++i) {
         Variable* local = m_proc.addVariable(toB3Type(type));
         m_locals.uncheckedAppend(local);
-        m_currentBlock->appendNew<VariableValue>(m_proc, Set, Origin(), local, constant(toB3Type(type), 0, Origin()));
+        Value* initialValue;
+        if (type == V128)
+            initialValue = m_currentBlock->appendNew<Const128Value>(m_proc, Origin(), v128_t());
+        else
+            initialValue = constant(toB3Type(type), 0, Origin());
+        m_currentBlock->appendNew<VariableValue>(m_proc, Set, Origin(), local, initialValue);
     }
     return { };
 }
@@ -572,29 +745,8 @@ auto B3IRGenerator::addUnreachable() -> PartialResult
 
 auto B3IRGenerator::addGrowMemory(ExpressionType delta, ExpressionType& result) -> PartialResult
 {
-    int32_t (*growMemory)(void*, Instance*, int32_t) = [] (void* callFrame, Instance* instance, int32_t delta) -> int32_t {
-        instance->storeTopCallFrame(callFrame);
-
-        if (delta < 0)
-            return -1;
-
-        auto grown = instance->memory()->grow(PageCount(delta));
-        if (!grown) {
-            switch (grown.error()) {
-            case Memory::GrowFailReason::InvalidDelta:
-            case Memory::GrowFailReason::InvalidGrowSize:
-            case Memory::GrowFailReason::WouldExceedMaximum:
-            case Memory::GrowFailReason::OutOfMemory:
-                return -1;
-            }
-            RELEASE_ASSERT_NOT_REACHED();
-        }
-
-        return grown.value().pageCount();
-    };
-
     result = m_currentBlock->appendNew<CCallValue>(m_proc, Int32, origin(),
-        m_currentBlock->appendNew<ConstPtrValue>(m_proc, origin(), bitwise_cast<void*>(growMemory)),
+        relocatablePointer(Relocation::Target::GrowMemory, bitwise_cast<void*>(growMemory), origin()),
         m_currentBlock->appendNew<B3::Value>(m_proc, B3::FramePointer, origin()), instanceValue(), delta);
 
     restoreWebAssemblyGlobalState(RestoreCachedStackLimit::No, m_info.memory, instanceValue(), m_proc, m_currentBlock);
@@ -903,10 +1055,285 @@ auto B3IRGenerator::store(StoreOpType op, ExpressionType pointer, ExpressionType
 
 auto B3IRGenerator::addSelect(ExpressionType condition, ExpressionType nonZero, ExpressionType zero, ExpressionType& result) -> PartialResult
 {
+    if (zero->type() == B3::V128) {
+        // Air has no conditional vector move, so blend the two sides with an all-ones or all-zeros mask.
+        Value* isNonZero = m_currentBlock->appendNew<Value>(m_proc, NotEqual, origin(), condition, constant(Int32, 0));
+        Value* scalarMask = m_currentBlock->appendNew<Value>(m_proc, Sub, origin(), constant(Int32, 0), isNonZero);
+        Value* mask = m_currentBlock->appendNew<SIMDValue>(m_proc, origin(), VectorSplat, B3::V128, SIMDLane::i32x4, scalarMask);
+        Value* takeNonZero = m_currentBlock->appendNew<SIMDValue>(m_proc, origin(), VectorAnd, B3::V128, SIMDLane::v128, nonZero, mask);
+        Value* takeZero = m_currentBlock->appendNew<SIMDValue>(m_proc, origin(), VectorAndnot, B3::V128, SIMDLane::v128, mask, zero);
+        result = m_currentBlock->appendNew<SIMDValue>(m_proc, origin(), VectorOr, B3::V128, SIMDLane::v128, takeNonZero, takeZero);
+        return { };
+    }
+
     result = m_currentBlock->appendNew<Value>(m_proc, B3::Select, origin(), condition, nonZero, zero);
     return { };
 }
 
+B3IRGenerator::ExpressionType B3IRGenerator::addSIMDConstant(v128_t value)
+{
+    return m_currentBlock->appendNew<Const128Value>(m_proc, origin(), value);
+}
+
+auto B3IRGenerator::addSIMDLoad(ExpressionType pointer, ExpressionType& result, uint32_t uoffset) -> PartialResult
+{
+    ASSERT(pointer->type() == Int32);
+
+    if (UNLIKELY(sumOverflows<uint32_t>(uoffset, sizeof(v128_t)))) {
+        B3::PatchpointValue* throwException = m_currentBlock->appendNew<B3::PatchpointValue>(m_proc, B3::Void, origin());
+        throwException->setGenerator([this] (CCallHelpers& jit, const B3::StackmapGenerationParams&) {
+            this->emitExceptionCheck(jit, ExceptionType::OutOfBoundsMemoryAccess);
+        });
+        result = addSIMDConstant(v128_t());
+        return { };
+    }
+
+    pointer = emitCheckAndPreparePointer(pointer, uoffset, sizeof(v128_t), ShouldMask::Yes);
+    int32_t offset = fixupPointerPlusOffset(pointer, uoffset);
+    result = m_currentBlock->appendNew<MemoryValue>(m_proc, memoryKind(Load), B3::V128, origin(), pointer, offset);
+    return { };
+}
+
+auto B3IRGenerator::addSIMDStore(ExpressionType pointer, ExpressionType value, uint32_t uoffset) -> PartialResult
+{
+    ASSERT(pointer->type() == Int32);
+
+    if (UNLIKELY(sumOverflows<uint32_t>(uoffset, sizeof(v128_t)))) {
+        B3::PatchpointValue* throwException = m_currentBlock->appendNew<B3::PatchpointValue>(m_proc, B3::Void, origin());
+        throwException->setGenerator([this] (CCallHelpers& jit, const B3::StackmapGenerationParams&) {
+            this->emitExceptionCheck(jit, ExceptionType::OutOfBoundsMemoryAccess);
+        });
+        return { };
+    }
+
+    pointer = emitCheckAndPreparePointer(pointer, uoffset, sizeof(v128_t), ShouldMask::No);
+    int32_t offset = fixupPointerPlusOffset(pointer, uoffset);
+    m_currentBlock->appendNew<MemoryValue>(m_proc, memoryKind(Store), origin(), value, pointer, offset);
+    return { };
+}
+
+auto B3IRGenerator::addSIMDSplat(SIMDLane lane, ExpressionType scalar, ExpressionType& result) -> PartialResult
+{
+    result = m_currentBlock->appendNew<SIMDValue>(m_proc, origin(), VectorSplat, B3::V128, lane, scalar);
+    return { };
+}
+
+auto B3IRGenerator::addSIMDExtractLane(SIMDLane lane, uint8_t laneIndex, ExpressionType vector, ExpressionType& result) -> PartialResult
+{
+    result = m_currentBlock->appendNew<SIMDValue>(m_proc, origin(), VectorExtractLane, elementType(lane), lane, laneIndex, vector);
+    return { };
+}
+
+auto B3IRGenerator::addSIMDReplaceLane(SIMDLane lane, uint8_t laneIndex, ExpressionType vector, ExpressionType scalar, ExpressionType& result) -> PartialResult
+{
+    result = m_currentBlock->appendNew<SIMDValue>(m_proc, origin(), VectorReplaceLane, B3::V128, lane, laneIndex, vector, scalar);
+    return { };
+}
+
+auto B3IRGenerator::addSIMDUnary(SIMDOpType op, ExpressionType value, ExpressionType& result) -> PartialResult
+{
+    switch (op) {
+#define CREATE_CASE(name, id, b3op, lane) \
+    case SIMDOpType::name: \
+        result = m_currentBlock->appendNew<SIMDValue>(m_proc, origin(), b3op, B3::V128, SIMDLane::lane, value); \
+        return { };
+    FOR_EACH_WASM_SIMD_UNARY_OP(CREATE_CASE)
+#undef CREATE_CASE
+    default:
+        break;
+    }
+    RELEASE_ASSERT_NOT_REACHED();
+    return { };
+}
+
+auto B3IRGenerator::addSIMDBinary(SIMDOpType op, ExpressionType left, ExpressionType right, ExpressionType& result) -> PartialResult
+{
+    // wasm's v128.andnot computes left & ~right, while B3's VectorAndnot computes ~left & right.
+    if (op == SIMDOpType::V128Andnot)
+        std::swap(left, right);
+
+    switch (op) {
+#define CREATE_CASE(name, id, b3op, lane) \
+    case SIMDOpType::name: \
+        result = m_currentBlock->appendNew<SIMDValue>(m_proc, origin(), b3op, B3::V128, SIMDLane::lane, left, right); \
+        return { };
+    FOR_EACH_WASM_SIMD_BINARY_OP(CREATE_CASE)
+#undef CREATE_CASE
+    default:
+        break;
+    }
+    RELEASE_ASSERT_NOT_REACHED();
+    return { };
+}
+
+inline Value* B3IRGenerator::emitAtomicCheckAndPreparePointer(AtomicOpType op, ExpressionType pointer, uint32_t offset)
+{
+    ASSERT(pointer->type() == Int32);
+    ASSERT(m_memoryBaseGPR);
+
+    // B3's atomic operations can't trap, so unlike other accesses these are explicitly bounds checked against the
+    // current size even in signaling mode. The effective address is computed in 64 bits, so it can't overflow.
+    uint32_t accessBytes = bytes(atomicWidth(op));
+    Value* memoryObject = m_currentBlock->appendNew<MemoryValue>(m_proc, Load, pointerType(), origin(), instanceValue(), safeCast<int32_t>(Instance::offsetOfMemory()));
+    Value* size = m_currentBlock->appendNew<MemoryValue>(m_proc, Load, Int64, origin(), memoryObject, safeCast<int32_t>(Memory::offsetOfSize()));
+    Value* address = m_currentBlock->appendNew<Value>(m_proc, Add, origin(),
+        m_currentBlock->appendNew<Value>(m_proc, ZExt32, origin(), pointer),
+        m_currentBlock->appendNew<Const64Value>(m_proc, origin(), offset));
+
+    {
+        CheckValue* check = m_currentBlock->appendNew<CheckValue>(m_proc, Check, origin(),
+            m_currentBlock->appendNew<Value>(m_proc, Above, origin(),
+                m_currentBlock->appendNew<Value>(m_proc, Add, origin(), address, m_currentBlock->appendNew<Const64Value>(m_proc, origin(), accessBytes)),
+                size));
+
+        check->setGenerator([=] (CCallHelpers& jit, const B3::StackmapGenerationParams&) {
+            this->emitExceptionCheck(jit, ExceptionType::OutOfBoundsMemoryAccess);
+        });
+    }
+
+    if (accessBytes > 1) {
+        CheckValue* check = m_currentBlock->appendNew<CheckValue>(m_proc, Check, origin(),
+            m_currentBlock->appendNew<Value>(m_proc, BitAnd, origin(), address, m_currentBlock->appendNew<Const64Value>(m_proc, origin(), accessBytes - 1)));
+
+        check->setGenerator([=] (CCallHelpers& jit, const B3::StackmapGenerationParams&) {
+            this->emitExceptionCheck(jit, ExceptionType::UnalignedMemoryAccess);
+        });
+    }
+
+    return m_currentBlock->appendNew<WasmAddressValue>(m_proc, origin(), address, m_memoryBaseGPR);
+}
+
+static B3::Opcode atomicB3Opcode(AtomicOpType op)
+{
+    switch (op) {
+#define CREATE_CASE(name, id, b3op, width, type) case AtomicOpType::name: return b3op;
+    FOR_EACH_WASM_ATOMIC_OP(CREATE_CASE)
+#undef CREATE_CASE
+    }
+    RELEASE_ASSERT_NOT_REACHED();
+    return Oops;
+}
+
+// B3 performs subwidth accesses on Int32 operands, so the narrow i64 operations wrap their operands first.
+inline Value* B3IRGenerator::truncateAtomicOperand(AtomicOpType op, ExpressionType value)
+{
+    if (value->type() == Int64 && atomicWidth(op) != Width64)
+        return m_currentBlock->appendNew<Value>(m_proc, Trunc, origin(), value);
+    return value;
+}
+
+// Subwidth B3 atomics sign extend their results, but wasm's are always zero extended.
+inline Value* B3IRGenerator::extendAtomicResult(AtomicOpType op, ExpressionType value)
+{
+    switch (atomicWidth(op)) {
+    case Width8:
+    case Width16:
+        value = m_currentBlock->appendNew<Value>(m_proc, BitAnd, origin(), value,
+            m_currentBlock->appendNew<Const32Value>(m_proc, origin(), static_cast<int32_t>(mask(atomicWidth(op)))));
+        break;
+    case Width32:
+    case Width64:
+        break;
+    }
+    if (toB3Type(atomicValueType(op)) == Int64 && value->type() == Int32)
+        return m_currentBlock->appendNew<Value>(m_proc, ZExt32, origin(), value);
+    return value;
+}
+
+auto B3IRGenerator::atomicLoad(AtomicOpType op, ExpressionType pointer, ExpressionType& result, uint32_t offset) -> PartialResult
+{
+    Value* address = emitAtomicCheckAndPreparePointer(op, pointer, offset);
+    switch (atomicWidth(op)) {
+    case Width8:
+        result = m_currentBlock->appendNew<MemoryValue>(m_proc, Load8Z, origin(), address, 0, HeapRange::top(), HeapRange::top());
+        break;
+    case Width16:
+        result = m_currentBlock->appendNew<MemoryValue>(m_proc, Load16Z, origin(), address, 0, HeapRange::top(), HeapRange::top());
+        break;
+    case Width32:
+        result = m_currentBlock->appendNew<MemoryValue>(m_proc, Load, Int32, origin(), address, 0, HeapRange::top(), HeapRange::top());
+        break;
+    case Width64:
+        result = m_currentBlock->appendNew<MemoryValue>(m_proc, Load, Int64, origin(), address, 0, HeapRange::top(), HeapRange::top());
+        break;
+    }
+    result = extendAtomicResult(op, result);
+    return { };
+}
+
+auto B3IRGenerator::atomicStore(AtomicOpType op, ExpressionType pointer, ExpressionType value, uint32_t offset) -> PartialResult
+{
+    Value* address = emitAtomicCheckAndPreparePointer(op, pointer, offset);
+    m_currentBlock->appendNew<MemoryValue>(m_proc, storeOpcode(GP, atomicWidth(op)), origin(), truncateAtomicOperand(op, value), address, 0, HeapRange::top(), HeapRange::top());
+    return { };
+}
+
+auto B3IRGenerator::atomicBinaryRMW(AtomicOpType op, ExpressionType pointer, ExpressionType value, ExpressionType& result, uint32_t offset) -> PartialResult
+{
+    Value* address = emitAtomicCheckAndPreparePointer(op, pointer, offset);
+    result = m_currentBlock->appendNew<AtomicValue>(m_proc, atomicB3Opcode(op), origin(), atomicWidth(op), truncateAtomicOperand(op, value), address);
+    result = extendAtomicResult(op, result);
+    return { };
+}
+
+auto B3IRGenerator::atomicCompareExchange(AtomicOpType op, ExpressionType pointer, ExpressionType expected, ExpressionType value, ExpressionType& result, uint32_t offset) -> PartialResult
+{
+    Value* address = emitAtomicCheckAndPreparePointer(op, pointer, offset);
+    expected = truncateAtomicOperand(op, expected);
+    Width width = atomicWidth(op);
+    // The expected value is wrapped to the access width before it is compared.
+    if (width == Width8 || width == Width16)
+        expected = m_currentBlock->appendNew<Value>(m_proc, BitAnd, origin(), expected, m_currentBlock->appendNew<Const32Value>(m_proc, origin(), static_cast<int32_t>(mask(width))));
+    result = m_currentBlock->appendNew<AtomicValue>(m_proc, AtomicStrongCAS, origin(), width, expected, truncateAtomicOperand(op, value), address);
+    result = extendAtomicResult(op, result);
+    return { };
+}
+
+auto B3IRGenerator::atomicWait(AtomicOpType op, ExpressionType pointer, ExpressionType value, ExpressionType timeout, ExpressionType& result, uint32_t offset) -> PartialResult
+{
+    Value* address = emitAtomicCheckAndPreparePointer(op, pointer, offset);
+
+    Value* waitFunction;
+    if (op == AtomicOpType::MemoryAtomicWait32)
+        waitFunction = relocatablePointer(Relocation::Target::AtomicWait32, bitwise_cast<void*>(atomicWait32), origin());
+    else {
+        ASSERT(op == AtomicOpType::MemoryAtomicWait64);
+        waitFunction = relocatablePointer(Relocation::Target::AtomicWait64, bitwise_cast<void*>(atomicWait64), origin());
+    }
+
+    result = m_currentBlock->appendNew<CCallValue>(m_proc, Int32, origin(),
+        waitFunction,
+        m_currentBlock->appendNew<B3::Value>(m_proc, B3::FramePointer, origin()), instanceValue(), address, value, timeout);
+
+    {
+        CheckValue* check = m_currentBlock->appendNew<CheckValue>(m_proc, Check, origin(),
+            m_currentBlock->appendNew<Value>(m_proc, LessThan, origin(), result, m_currentBlock->appendNew<Const32Value>(m_proc, origin(), 0)));
+
+        check->setGenerator([=] (CCallHelpers& jit, const B3::StackmapGenerationParams&) {
+            this->emitExceptionCheck(jit, ExceptionType::AtomicWaitNotAllowed);
+        });
+    }
+
+    return { };
+}
+
+auto B3IRGenerator::atomicNotify(AtomicOpType op, ExpressionType pointer, ExpressionType count, ExpressionType& result, uint32_t offset) -> PartialResult
+{
+    Value* address = emitAtomicCheckAndPreparePointer(op, pointer, offset);
+
+    result = m_currentBlock->appendNew<CCallValue>(m_proc, Int32, origin(),
+        relocatablePointer(Relocation::Target::AtomicNotify, bitwise_cast<void*>(Wasm::atomicNotify), origin()),
+        m_currentBlock->appendNew<B3::Value>(m_proc, B3::FramePointer, origin()), instanceValue(), address, count);
+
+    return { };
+}
+
+auto B3IRGenerator::atomicFence() -> PartialResult
+{
+    m_currentBlock->appendNew<FenceValue>(m_proc, origin());
+    return { };
+}
+
 B3IRGenerator::ExpressionType B3IRGenerator::addConstant(Type type, uint64_t value)
 {
     return constant(toB3Type(type), value);
@@ -918,7 +1345,9 @@ void B3IRGenerator::emitTierUpCheck(uint32_t decrementCount, Origin origin)
         return;
 
     ASSERT(m_tierUp);
-    Value* countDownLocation = constant(pointerType(), reinterpret_cast<uint64_t>(m_tierUp), origin);
+    Value* countDownLocation = m_relocations
+        ? relocatablePointer(Relocation::Target::TierUpCount, m_tierUp, origin)
+        : constant(pointerType(), reinterpret_cast<uint64_t>(m_tierUp), origin);
     Value* oldCountDown = m_currentBlock->appendNew<MemoryValue>(m_proc, Load, Int32, origin, countDownLocation);
     Value* newCountDown = m_currentBlock->appendNew<Value>(m_proc, Sub, origin, oldCountDown, constant(Int32, decrementCount, origin));
     m_currentBlock->appendNew<MemoryValue>(m_proc, Store, origin, newCountDown, countDownLocation);
@@ -932,6 +1361,7 @@ void B3IRGenerator::emitTierUpCheck(uint32_t decrementCount, Origin origin)
 
     patch->append(newCountDown, ValueRep::SomeRegister);
     patch->append(oldCountDown, ValueRep::SomeRegister);
+    Vector<Relocation>* relocations = m_relocations;
     patch->setGenerator([=] (CCallHelpers& jit, const StackmapGenerationParams& params) {
         MacroAssembler::Jump tierUp = jit.branch32(MacroAssembler::Above, params[0].gpr(), params[1].gpr());
         MacroAssembler::Label tierUpResume = jit.label();
@@ -952,7 +1382,8 @@ void B3IRGenerator::emitTierUpCheck(uint32_t decrementCount, Origin origin)
 
             jit.addLinkTask([=] (LinkBuffer& linkBuffer) {
                 MacroAssembler::repatchNearCall(linkBuffer.locationOfNearCall(call), CodeLocationLabel(Thunks::singleton().stub(triggerOMGTierUpThunkGenerator).code()));
-
+                if (relocations)
+                    relocations->append({ linkBuffer.locationOfNearCall(call).labelAtOffset(0), Relocation::Target::TriggerOMGTierUp, 0 });
             });
         });
     });
@@ -1100,6 +1531,7 @@ auto B3IRGenerator::addCall(uint32_t functionIndex, const Signature& signature,
 
     Type returnType = signature.returnType();
     Vector<UnlinkedWasmToWasmCall>* unlinkedWasmToWasmCalls = &m_unlinkedWasmToWasmCalls;
+    Vector<Relocation>* relocations = m_relocations;
 
     if (m_info.isImportedFunctionFromFunctionIndexSpace(functionIndex)) {
         m_maxNumJSCallArguments = std::max(m_maxNumJSCallArguments, static_cast<uint32_t>(args.size()));
@@ -1122,11 +1554,13 @@ auto B3IRGenerator::addCall(uint32_t functionIndex, const Signature& signature,
                 // We pessimistically assume we could be calling to something that is bounds checking.
                 // FIXME: We shouldn't have to do this: https://bugs.webkit.org/show_bug.cgi?id=172181
                 patchpoint->clobberLate(PinnedRegisterInfo::get().toSave(MemoryMode::BoundsChecking));
-                patchpoint->setGenerator([unlinkedWasmToWasmCalls, functionIndex] (CCallHelpers& jit, const B3::StackmapGenerationParams&) {
+                patchpoint->setGenerator([unlinkedWasmToWasmCalls, relocations, functionIndex] (CCallHelpers& jit, const B3::StackmapGenerationParams&) {
                     AllowMacroScratchRegisterUsage allowScratch(jit);
                     CCallHelpers::Call call = jit.threadSafePatchableNearCall();
-                    jit.addLinkTask([unlinkedWasmToWasmCalls, call, functionIndex] (LinkBuffer& linkBuffer) {
+                    jit.addLinkTask([unlinkedWasmToWasmCalls, relocations, call, functionIndex] (LinkBuffer& linkBuffer) {
                         unlinkedWasmToWasmCalls->append({ linkBuffer.locationOfNearCall(call), functionIndex });
+                        if (relocations)
+                            relocations->append({ linkBuffer.locationOfNearCall(call).labelAtOffset(0), Relocation::Target::Function, functionIndex });
                     });
                 });
             });
@@ -1174,11 +1608,13 @@ auto B3IRGenerator::addCall(uint32_t functionIndex, const Signature& signature,
                 patchpoint->effects.writesPinned = true;
                 patchpoint->effects.readsPinned = true;
 
-                patchpoint->setGenerator([unlinkedWasmToWasmCalls, functionIndex] (CCallHelpers& jit, const B3::StackmapGenerationParams&) {
+                patchpoint->setGenerator([unlinkedWasmToWasmCalls, relocations, functionIndex] (CCallHelpers& jit, const B3::StackmapGenerationParams&) {
                     AllowMacroScratchRegisterUsage allowScratch(jit);
                     CCallHelpers::Call call = jit.threadSafePatchableNearCall();
-                    jit.addLinkTask([unlinkedWasmToWasmCalls, call, functionIndex] (LinkBuffer& linkBuffer) {
+                    jit.addLinkTask([unlinkedWasmToWasmCalls, relocations, call, functionIndex] (LinkBuffer& linkBuffer) {
                         unlinkedWasmToWasmCalls->append({ linkBuffer.locationOfNearCall(call), functionIndex });
+                        if (relocations)
+                            relocations->append({ linkBuffer.locationOfNearCall(call).labelAtOffset(0), Relocation::Target::Function, functionIndex });
                     });
                 });
             });
@@ -1255,7 +1691,8 @@ auto B3IRGenerator::addCallIndirect(const Signature& signature, Vector<Expressio
 
         // Check the signature matches the value we expect.
         {
-            ExpressionType expectedSignatureIndex = m_currentBlock->appendNew<Const32Value>(m_proc, origin(), SignatureInformation::get(signature));
+            // SignatureIndices are only unique within a process.
+            ExpressionType expectedSignatureIndex = relocatableInt32(Relocation::Target::SignatureIndex, SignatureInformation::get(signature));
             CheckValue* check = m_currentBlock->appendNew<CheckValue>(m_proc, Check, origin(),
                 m_currentBlock->appendNew<Value>(m_proc, NotEqual, origin(), calleeSignatureIndex, expectedSignatureIndex));
 
@@ -1414,6 +1851,9 @@ Expected<std::unique_ptr<InternalFunction>, String> parseAndCompile(CompilationC
         ? Options::webAssemblyBBQOptimizationLevel()
         : Options::webAssemblyOMGOptimizationLevel());
 
+    // Only BBQ code is serialized with its module. OMG code is regenerated as functions get hot.
+    procedure.setNeedsRelocatableCode(compilationMode == CompilationMode::BBQMode && Options::useRelocatableBBQCode());
+
     B3IRGenerator irGenerator(info, procedure, result.get(), unlinkedWasmToWasmCalls, mode, compilationMode, functionIndex, tierUp, throwWasmException);
     FunctionParser<B3IRGenerator> parser(irGenerator, functionStart, functionLength, signature, info);
     WASM_FAIL_IF_HELPER_FAILS(parser.parse());
@@ -1569,10 +2009,7 @@ auto B3IRGenerator::addOp<OpType::I64Ctz>(ExpressionType arg, ExpressionType& re
 template<>
 auto B3IRGenerator::addOp<OpType::I32Popcnt>(ExpressionType arg, ExpressionType& result) -> PartialResult
 {
-    // FIXME: This should use the popcnt instruction if SSE4 is available but we don't have code to detect SSE4 yet.
-    // see: https://bugs.webkit.org/show_bug.cgi?id=165363
-    uint32_t (*popcount)(int32_t) = [] (int32_t value) -> uint32_t { return __builtin_popcount(value); };
-    Value* funcAddress = m_currentBlock->appendNew<ConstPtrValue>(m_proc, origin(), bitwise_cast<void*>(popcount));
+    Value* funcAddress = relocatablePointer(Relocation::Target::PopcountInt32, bitwise_cast<void*>(popcountInt32), origin());
     result = m_currentBlock->appendNew<CCallValue>(m_proc, Int32, origin(), Effects::none(), funcAddress, arg);
     return { };
 }
@@ -1580,10 +2017,7 @@ auto B3IRGenerator::addOp<OpType::I32Popcnt>(ExpressionType arg, ExpressionType&
 template<>
 auto B3IRGenerator::addOp<OpType::I64Popcnt>(ExpressionType arg, ExpressionType& result) -> PartialResult
 {
-    // FIXME: This should use the popcnt instruction if SSE4 is available but we don't have code to detect SSE4 yet.
-    // see: https://bugs.webkit.org/show_bug.cgi?id=165363
-    uint64_t (*popcount)(int64_t) = [] (int64_t value) -> uint64_t { return __builtin_popcountll(value); };
-    Value* funcAddress = m_currentBlock->appendNew<ConstPtrValue>(m_proc, origin(), bitwise_cast<void*>(popcount));
+    Value* funcAddress = relocatablePointer(Relocation::Target::PopcountInt64, bitwise_cast<void*>(popcountInt64), origin());
     result = m_currentBlock->appendNew<CCallValue>(m_proc, Int64, origin(), Effects::none(), funcAddress, arg);
     return { };
 }
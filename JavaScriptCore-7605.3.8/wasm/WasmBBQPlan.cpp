@@ -36,6 +36,7 @@
 #include "WasmFaultSignalHandler.h"
 #include "WasmMemory.h"
 #include "WasmModuleParser.h"
+#include "WasmSinglePassGenerator.h"
 #include "WasmTierUpCount.h"
 #include "WasmValidate.h"
 #include <wtf/DataLog.h>
@@ -267,19 +268,34 @@ void BBQPlan::compileFunctions(CompilationEffort effort)
 
         m_unlinkedWasmToWasmCalls[functionIndex] = Vector<UnlinkedWasmToWasmCall>();
         TierUpCount* tierUp = Options::useBBQTierUpChecks() ? &m_tierUpCounts[functionIndex] : nullptr;
-        auto parseAndCompileResult = parseAndCompile(m_compilationContexts[functionIndex], functionStart, functionLength, signature, m_unlinkedWasmToWasmCalls[functionIndex], m_moduleInformation.get(), m_mode, CompilationMode::BBQMode, functionIndex, tierUp, m_throwWasmException);
+        std::unique_ptr<InternalFunction> function;
+        if (Options::useWebAssemblySinglePassTier()) {
+            function = parseAndCompileSinglePass(m_compilationContexts[functionIndex], functionStart, functionLength, signature, m_unlinkedWasmToWasmCalls[functionIndex], m_moduleInformation.get(), m_mode, functionIndex, tierUp, m_throwWasmException);
+            if (function)
+                m_hasSinglePassCode = true;
+            else {
+                // The function uses something the single-pass tier doesn't handle, so start over with B3.
+                m_unlinkedWasmToWasmCalls[functionIndex] = Vector<UnlinkedWasmToWasmCall>();
+                m_compilationContexts[functionIndex] = CompilationContext();
+            }
+        }
 
-        if (UNLIKELY(!parseAndCompileResult)) {
-            auto locker = holdLock(m_lock);
-            if (!m_errorMessage) {
-                // Multiple compiles could fail simultaneously. We arbitrarily choose the first.
-                fail(locker, makeString(parseAndCompileResult.error(), ", in function at index ", String::number(functionIndex))); // FIXME make this an Expected.
+        if (!function) {
+            auto parseAndCompileResult = parseAndCompile(m_compilationContexts[functionIndex], functionStart, functionLength, signature, m_unlinkedWasmToWasmCalls[functionIndex], m_moduleInformation.get(), m_mode, CompilationMode::BBQMode, functionIndex, tierUp, m_throwWasmException);
+
+            if (UNLIKELY(!parseAndCompileResult)) {
+                auto locker = holdLock(m_lock);
+                if (!m_errorMessage) {
+                    // Multiple compiles could fail simultaneously. We arbitrarily choose the first.
+                    fail(locker, makeString(parseAndCompileResult.error(), ", in function at index ", String::number(functionIndex))); // FIXME make this an Expected.
+                }
+                m_currentIndex = functionLocations.size();
+                return;
             }
-            m_currentIndex = functionLocations.size();
-            return;
+            function = WTFMove(*parseAndCompileResult);
         }
 
-        m_wasmInternalFunctions[functionIndex] = WTFMove(*parseAndCompileResult);
+        m_wasmInternalFunctions[functionIndex] = WTFMove(function);
 
         if (m_exportedFunctionIndices.contains(functionIndex)) {
             auto locker = holdLock(m_lock);
@@ -310,6 +326,11 @@ void BBQPlan::complete(const AbstractLocker& locker)
                 m_wasmInternalFunctions[functionIndex]->entrypoint.compilation = std::make_unique<B3::Compilation>(
                     FINALIZE_CODE(linkBuffer, ("WebAssembly function[%i] %s", functionIndex, SignatureInformation::get(signatureIndex).toString().ascii().data())),
                     WTFMove(context.wasmEntrypointByproducts));
+
+                if (Options::useRelocatableBBQCode()) {
+                    InternalFunction& function = *m_wasmInternalFunctions[functionIndex];
+                    function.relocations.append({ function.calleeMoveLocation.labelAtOffset(0), Relocation::Target::Callee, 0 });
+                }
             }
 
             if (auto embedderToWasmInternalFunction = m_embedderToWasmInternalFunctions.get(functionIndex)) {
@@ -344,6 +365,20 @@ void BBQPlan::complete(const AbstractLocker& locker)
     }
 }
 
+Vector<Vector<Relocation>> BBQPlan::takeRelocations()
+{
+    RELEASE_ASSERT(!failed() && !hasWork());
+    Vector<Vector<Relocation>> relocations;
+    // Single-pass code embeds absolute addresses without recording them.
+    if (!Options::useRelocatableBBQCode() || m_hasSinglePassCode)
+        return relocations;
+
+    relocations.reserveInitialCapacity(m_wasmInternalFunctions.size());
+    for (auto& function : m_wasmInternalFunctions)
+        relocations.uncheckedAppend(WTFMove(function->relocations));
+    return relocations;
+}
+
 void BBQPlan::work(CompilationEffort effort)
 {
     switch (m_state) {
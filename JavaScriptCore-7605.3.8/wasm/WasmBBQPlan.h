@@ -106,6 +106,9 @@ public:
         return WTFMove(m_tierUpCounts);
     }
 
+    // Empty unless the code was compiled to be relocatable.
+    Vector<Vector<Relocation>> takeRelocations();
+
     enum class State : uint8_t {
         Initial,
         Validated,
@@ -150,6 +153,7 @@ private:
     const AsyncWork m_asyncWork;
     uint8_t m_numberOfActiveThreads { 0 };
     uint32_t m_currentIndex { 0 };
+    std::atomic<bool> m_hasSinglePassCode { false };
 };
 
 
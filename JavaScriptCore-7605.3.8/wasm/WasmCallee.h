@@ -51,6 +51,7 @@ public:
     }
 
     MacroAssemblerCodePtr entrypoint() const { return m_entrypoint.compilation->code(); }
+    MacroAssemblerCodeRef codeRef() const { return m_entrypoint.compilation->codeRef(); }
 
     RegisterAtOffsetList* calleeSaveRegisters() { return &m_entrypoint.calleeSaveRegisters; }
     IndexOrName indexOrName() const { return m_indexOrName; }
@@ -73,6 +73,7 @@ CodeBlock::CodeBlock(Context* context, MemoryMode mode, ModuleInformation& modul
         m_wasmToWasmExitStubs = m_plan->takeWasmToWasmExitStubs();
         m_wasmToWasmCallsites = m_plan->takeWasmToWasmCallsites();
         m_tierUpCounts = m_plan->takeTierUpCounts();
+        m_relocations = m_plan->takeRelocations();
 
         setCompilationFinished();
     }), WTFMove(createEmbedderWrapper), throwWasmException));
@@ -83,6 +84,12 @@ CodeBlock::CodeBlock(Context* context, MemoryMode mode, ModuleInformation& modul
     worklist.enqueue(makeRef(*m_plan.get()));
 }
 
+CodeBlock::CodeBlock(MemoryMode mode, ModuleInformation& moduleInformation)
+    : m_calleeCount(moduleInformation.internalFunctionCount())
+    , m_mode(mode)
+{
+}
+
 CodeBlock::~CodeBlock() { }
 
 void CodeBlock::waitUntilFinished()
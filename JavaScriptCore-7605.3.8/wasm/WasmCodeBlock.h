@@ -45,6 +45,7 @@ struct Context;
 class BBQPlan;
 class OMGPlan;
 struct ModuleInformation;
+struct Relocation;
 struct UnlinkedWasmToWasmCall;
 typedef void** WasmEntrypointLoadLocation;
 enum class MemoryMode : uint8_t;
@@ -115,9 +116,13 @@ public:
 
     ~CodeBlock();
 private:
+    friend class ModuleDecoder;
+    friend class ModuleEncoder;
     friend class OMGPlan;
 
     CodeBlock(Context*, MemoryMode, ModuleInformation&, CreateEmbedderWrapper&&, ThrowWasmException);
+    // Used when loading a serialized module. The ModuleDecoder populates the CodeBlock.
+    CodeBlock(MemoryMode, ModuleInformation&);
     void setCompilationFinished();
     unsigned m_calleeCount;
     MemoryMode m_mode;
@@ -128,6 +133,7 @@ private:
     Vector<TierUpCount> m_tierUpCounts;
     Vector<Vector<UnlinkedWasmToWasmCall>> m_wasmToWasmCallsites;
     Vector<MacroAssemblerCodeRef> m_wasmToWasmExitStubs;
+    Vector<Vector<Relocation>> m_relocations; // Relocations of the BBQ code in m_callees, if it is relocatable.
     RefPtr<BBQPlan> m_plan;
     std::atomic<bool> m_compilationFinished { false };
     String m_errorMessage;
@@ -40,7 +40,9 @@ namespace Wasm {
     macro(Unreachable, "Unreachable code should not be executed") \
     macro(DivisionByZero, "Division by zero") \
     macro(IntegerOverflow, "Integer overflow") \
-    macro(StackOverflow, "Stack overflow")
+    macro(StackOverflow, "Stack overflow") \
+    macro(UnalignedMemoryAccess, "Unaligned atomic memory access") \
+    macro(AtomicWaitNotAllowed, "Atomic wait is not allowed on unshared memory or on this thread")
 
 enum class ExceptionType : uint32_t {
 #define MAKE_ENUM(enumName, error) enumName,
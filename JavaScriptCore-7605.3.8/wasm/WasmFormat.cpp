@@ -29,6 +29,8 @@
 
 #if ENABLE(WEBASSEMBLY)
 
+#include "MacroAssembler.h"
+#include "Options.h"
 #include "WasmMemory.h"
 #include <wtf/CheckedArithmetic.h>
 #include <wtf/FastMalloc.h>
@@ -61,6 +63,15 @@ Segment::Ptr Segment::adoptPtr(Segment* segment)
     return Ptr(segment, &Segment::destroy);
 }
 
+bool isSIMDEnabled()
+{
+#if CPU(X86_64)
+    return Options::useWebAssemblySIMD() && MacroAssembler::supportsVectorOperations();
+#else
+    return false;
+#endif
+}
+
 String makeString(const Name& characters)
 {
     String result = String::fromUTF8(characters);
@@ -61,12 +61,16 @@ inline bool isValueType(Type type)
     case I64:
     case F32:
     case F64:
+    case V128:
         return true;
     default:
         break;
     }
     return false;
 }
+
+// v128 and the SIMD opcodes are only accepted when this returns true.
+bool isSIMDEnabled();
     
 enum class ExternalKind : uint8_t {
     // FIXME auto-generate this. https://bugs.webkit.org/show_bug.cgi?id=165231
@@ -260,6 +264,30 @@ struct UnlinkedWasmToWasmCall {
     size_t functionIndexSpace;
 };
 
+// Relocatable BBQ code records every process-specific value it embeds when it is linked, so that
+// the code can be serialized and fixed up again when it is loaded into another process.
+struct Relocation {
+    enum class Target : uint8_t {
+        Callee, // The boxed Callee stored by the prologue.
+        TierUpCount, // The function's TierUpCount.
+        SignatureIndex, // The SignatureIndex a call_indirect expects. The argument is its value.
+        Function, // A direct call. The argument is the callee's function index space.
+        GrowMemory,
+        AtomicWait32,
+        AtomicWait64,
+        AtomicNotify,
+        PopcountInt32,
+        PopcountInt64,
+        ThrowException,
+        ThrowStackOverflow,
+        TriggerOMGTierUp,
+    };
+
+    CodeLocationLabel location;
+    Target target;
+    uint32_t argument;
+};
+
 struct Entrypoint {
     std::unique_ptr<B3::Compilation> compilation;
     RegisterAtOffsetList calleeSaveRegisters;
@@ -268,6 +296,7 @@ struct Entrypoint {
 struct InternalFunction {
     CodeLocationDataLabelPtr calleeMoveLocation;
     Entrypoint entrypoint;
+    Vector<Relocation> relocations;
 };
 
 using WasmEntrypointLoadLocation = void**;
@@ -27,6 +27,8 @@
 
 #if ENABLE(WEBASSEMBLY)
 
+#include "B3SIMDValue.h"
+#include "B3Width.h"
 #include "WasmParser.h"
 #include <wtf/DataLog.h>
 
@@ -39,6 +41,39 @@ enum class BlockType {
     TopLevel
 };
 
+inline B3::SIMDLane simdLane(SIMDOpType op)
+{
+    switch (op) {
+#define CREATE_CASE(name, id, b3op, lane) case SIMDOpType::name: return B3::SIMDLane::lane;
+    FOR_EACH_WASM_SIMD_OP(CREATE_CASE)
+#undef CREATE_CASE
+    }
+    RELEASE_ASSERT_NOT_REACHED();
+    return B3::SIMDLane::v128;
+}
+
+inline B3::Width atomicWidth(AtomicOpType op)
+{
+    switch (op) {
+#define CREATE_CASE(name, id, b3op, width, type) case AtomicOpType::name: return B3::width;
+    FOR_EACH_WASM_ATOMIC_OP(CREATE_CASE)
+#undef CREATE_CASE
+    }
+    RELEASE_ASSERT_NOT_REACHED();
+    return B3::Width8;
+}
+
+inline Type atomicValueType(AtomicOpType op)
+{
+    switch (op) {
+#define CREATE_CASE(name, id, b3op, width, type) case AtomicOpType::name: return type;
+    FOR_EACH_WASM_ATOMIC_OP(CREATE_CASE)
+#undef CREATE_CASE
+    }
+    RELEASE_ASSERT_NOT_REACHED();
+    return Void;
+}
+
 template<typename Context>
 class FunctionParser : public Parser<void> {
 public:
@@ -64,6 +99,13 @@ private:
     PartialResult WARN_UNUSED_RETURN parseBody();
     PartialResult WARN_UNUSED_RETURN parseExpression();
     PartialResult WARN_UNUSED_RETURN parseUnreachableExpression();
+    PartialResult WARN_UNUSED_RETURN parseSIMDExpression();
+    PartialResult WARN_UNUSED_RETURN parseUnreachableSIMDExpression();
+    PartialResult WARN_UNUSED_RETURN parseSIMDOpcode(SIMDOpType&);
+    PartialResult WARN_UNUSED_RETURN parseAtomicExpression();
+    PartialResult WARN_UNUSED_RETURN parseUnreachableAtomicExpression();
+    PartialResult WARN_UNUSED_RETURN parseAtomicOpcode(AtomicOpType&);
+    PartialResult WARN_UNUSED_RETURN parseAtomicMemoryImmediates(AtomicOpType, uint32_t& offset);
     PartialResult WARN_UNUSED_RETURN unifyControl(Vector<ExpressionType>&, unsigned level);
 
 #define WASM_TRY_POP_EXPRESSION_STACK_INTO(result, what) do {                               \
@@ -518,6 +560,12 @@ auto FunctionParser<Context>::parseExpression() -> PartialResult
 
         return { };
     }
+
+    case SimdPrefix:
+        return parseSIMDExpression();
+
+    case AtomicPrefix:
+        return parseAtomicExpression();
     }
 
     ASSERT_NOT_REACHED();
@@ -636,6 +684,12 @@ auto FunctionParser<Context>::parseUnreachableExpression() -> PartialResult
         return { };
     }
 
+    case SimdPrefix:
+        return parseUnreachableSIMDExpression();
+
+    case AtomicPrefix:
+        return parseUnreachableAtomicExpression();
+
     // no immediate cases
     FOR_EACH_WASM_BINARY_OP(CREATE_CASE)
     FOR_EACH_WASM_UNARY_OP(CREATE_CASE)
@@ -651,6 +705,300 @@ auto FunctionParser<Context>::parseUnreachableExpression() -> PartialResult
     RELEASE_ASSERT_NOT_REACHED();
 }
 
+template<typename Context>
+auto FunctionParser<Context>::parseSIMDOpcode(SIMDOpType& result) -> PartialResult
+{
+    uint32_t op;
+    WASM_PARSER_FAIL_IF(!parseVarUInt32(op), "can't decode SIMD opcode");
+    WASM_PARSER_FAIL_IF(!isValidSIMDOpType(op), "invalid SIMD opcode ", op);
+    result = static_cast<SIMDOpType>(op);
+    WASM_PARSER_FAIL_IF(!isSIMDEnabled(), "SIMD opcode ", makeString(result), " isn't supported");
+    return { };
+}
+
+template<typename Context>
+auto FunctionParser<Context>::parseSIMDExpression() -> PartialResult
+{
+    SIMDOpType op;
+    WASM_FAIL_IF_HELPER_FAILS(parseSIMDOpcode(op));
+    B3::SIMDLane lane = simdLane(op);
+
+    switch (op) {
+    case SIMDOpType::V128Load: {
+        uint32_t alignment;
+        uint32_t offset;
+        ExpressionType pointer;
+        ExpressionType result;
+        WASM_PARSER_FAIL_IF(!parseVarUInt32(alignment), "can't get v128.load alignment");
+        WASM_PARSER_FAIL_IF(alignment > 4, "byte alignment ", 1ull << alignment, " exceeds v128.load's natural alignment 16");
+        WASM_PARSER_FAIL_IF(!parseVarUInt32(offset), "can't get v128.load offset");
+        WASM_TRY_POP_EXPRESSION_STACK_INTO(pointer, "v128.load pointer");
+        WASM_TRY_ADD_TO_CONTEXT(addSIMDLoad(pointer, result, offset));
+        m_expressionStack.append(result);
+        return { };
+    }
+
+    case SIMDOpType::V128Store: {
+        uint32_t alignment;
+        uint32_t offset;
+        ExpressionType value;
+        ExpressionType pointer;
+        WASM_PARSER_FAIL_IF(!parseVarUInt32(alignment), "can't get v128.store alignment");
+        WASM_PARSER_FAIL_IF(alignment > 4, "byte alignment ", 1ull << alignment, " exceeds v128.store's natural alignment 16");
+        WASM_PARSER_FAIL_IF(!parseVarUInt32(offset), "can't get v128.store offset");
+        WASM_TRY_POP_EXPRESSION_STACK_INTO(value, "v128.store value");
+        WASM_TRY_POP_EXPRESSION_STACK_INTO(pointer, "v128.store pointer");
+        WASM_TRY_ADD_TO_CONTEXT(addSIMDStore(pointer, value, offset));
+        return { };
+    }
+
+    case SIMDOpType::V128Const: {
+        B3::v128_t constant;
+        WASM_PARSER_FAIL_IF(!parseUInt64(constant.u64x2[0]) || !parseUInt64(constant.u64x2[1]), "can't parse 128-bit vector constant");
+        m_expressionStack.append(m_context.addSIMDConstant(constant));
+        return { };
+    }
+
+#define CREATE_CASE(name, id, b3op, lane) case SIMDOpType::name:
+    FOR_EACH_WASM_SIMD_SPLAT_OP(CREATE_CASE) {
+        ExpressionType scalar;
+        ExpressionType result;
+        WASM_TRY_POP_EXPRESSION_STACK_INTO(scalar, "splat scalar");
+        WASM_TRY_ADD_TO_CONTEXT(addSIMDSplat(lane, scalar, result));
+        m_expressionStack.append(result);
+        return { };
+    }
+
+    FOR_EACH_WASM_SIMD_EXTRACT_LANE_OP(CREATE_CASE) {
+        uint8_t laneIndex;
+        ExpressionType vector;
+        ExpressionType result;
+        WASM_PARSER_FAIL_IF(!parseUInt8(laneIndex), "can't get ", makeString(op), "'s lane index");
+        WASM_PARSER_FAIL_IF(laneIndex >= B3::elementCount(lane), makeString(op), "'s lane index ", laneIndex, " exceeds lane count ", B3::elementCount(lane));
+        WASM_TRY_POP_EXPRESSION_STACK_INTO(vector, "extract_lane vector");
+        WASM_TRY_ADD_TO_CONTEXT(addSIMDExtractLane(lane, laneIndex, vector, result));
+        m_expressionStack.append(result);
+        return { };
+    }
+
+    FOR_EACH_WASM_SIMD_REPLACE_LANE_OP(CREATE_CASE) {
+        uint8_t laneIndex;
+        ExpressionType vector;
+        ExpressionType scalar;
+        ExpressionType result;
+        WASM_PARSER_FAIL_IF(!parseUInt8(laneIndex), "can't get ", makeString(op), "'s lane index");
+        WASM_PARSER_FAIL_IF(laneIndex >= B3::elementCount(lane), makeString(op), "'s lane index ", laneIndex, " exceeds lane count ", B3::elementCount(lane));
+        WASM_TRY_POP_EXPRESSION_STACK_INTO(scalar, "replace_lane scalar");
+        WASM_TRY_POP_EXPRESSION_STACK_INTO(vector, "replace_lane vector");
+        WASM_TRY_ADD_TO_CONTEXT(addSIMDReplaceLane(lane, laneIndex, vector, scalar, result));
+        m_expressionStack.append(result);
+        return { };
+    }
+
+    FOR_EACH_WASM_SIMD_UNARY_OP(CREATE_CASE) {
+        ExpressionType value;
+        ExpressionType result;
+        WASM_TRY_POP_EXPRESSION_STACK_INTO(value, "SIMD unary");
+        WASM_TRY_ADD_TO_CONTEXT(addSIMDUnary(op, value, result));
+        m_expressionStack.append(result);
+        return { };
+    }
+
+    FOR_EACH_WASM_SIMD_BINARY_OP(CREATE_CASE) {
+        ExpressionType right;
+        ExpressionType left;
+        ExpressionType result;
+        WASM_TRY_POP_EXPRESSION_STACK_INTO(right, "SIMD binary right");
+        WASM_TRY_POP_EXPRESSION_STACK_INTO(left, "SIMD binary left");
+        WASM_TRY_ADD_TO_CONTEXT(addSIMDBinary(op, left, right, result));
+        m_expressionStack.append(result);
+        return { };
+    }
+#undef CREATE_CASE
+    }
+
+    ASSERT_NOT_REACHED();
+    return { };
+}
+
+template<typename Context>
+auto FunctionParser<Context>::parseUnreachableSIMDExpression() -> PartialResult
+{
+    SIMDOpType op;
+    WASM_FAIL_IF_HELPER_FAILS(parseSIMDOpcode(op));
+
+#define CREATE_CASE(name, id, b3op, lane) case SIMDOpType::name:
+    switch (op) {
+    // two immediate cases
+    FOR_EACH_WASM_SIMD_MEMORY_LOAD_OP(CREATE_CASE)
+    FOR_EACH_WASM_SIMD_MEMORY_STORE_OP(CREATE_CASE) {
+        uint32_t unused;
+        WASM_PARSER_FAIL_IF(!parseVarUInt32(unused), "can't get first immediate for ", makeString(op), " in unreachable context");
+        WASM_PARSER_FAIL_IF(!parseVarUInt32(unused), "can't get second immediate for ", makeString(op), " in unreachable context");
+        return { };
+    }
+
+    case SIMDOpType::V128Const: {
+        uint64_t unused;
+        WASM_PARSER_FAIL_IF(!parseUInt64(unused) || !parseUInt64(unused), "can't parse 128-bit vector constant in unreachable context");
+        return { };
+    }
+
+    // lane index cases
+    FOR_EACH_WASM_SIMD_EXTRACT_LANE_OP(CREATE_CASE)
+    FOR_EACH_WASM_SIMD_REPLACE_LANE_OP(CREATE_CASE) {
+        uint8_t unused;
+        WASM_PARSER_FAIL_IF(!parseUInt8(unused), "can't get lane index for ", makeString(op), " in unreachable context");
+        return { };
+    }
+
+    // no immediate cases
+    FOR_EACH_WASM_SIMD_SPLAT_OP(CREATE_CASE)
+    FOR_EACH_WASM_SIMD_UNARY_OP(CREATE_CASE)
+    FOR_EACH_WASM_SIMD_BINARY_OP(CREATE_CASE) {
+        return { };
+    }
+    }
+#undef CREATE_CASE
+    RELEASE_ASSERT_NOT_REACHED();
+}
+
+template<typename Context>
+auto FunctionParser<Context>::parseAtomicOpcode(AtomicOpType& result) -> PartialResult
+{
+    uint32_t op;
+    WASM_PARSER_FAIL_IF(!parseVarUInt32(op), "can't decode atomic opcode");
+    WASM_PARSER_FAIL_IF(!isValidAtomicOpType(op), "invalid atomic opcode ", op);
+    result = static_cast<AtomicOpType>(op);
+    WASM_PARSER_FAIL_IF(!Options::useWebAssemblyThreads(), "atomic opcode ", makeString(result), " isn't supported");
+    return { };
+}
+
+template<typename Context>
+auto FunctionParser<Context>::parseAtomicMemoryImmediates(AtomicOpType op, uint32_t& offset) -> PartialResult
+{
+    // Unlike other memory accesses, atomics must declare exactly their natural alignment.
+    uint32_t alignment;
+    uint32_t naturalAlignment = B3::bytes(atomicWidth(op));
+    WASM_PARSER_FAIL_IF(!parseVarUInt32(alignment), "can't get ", makeString(op), "'s alignment");
+    WASM_PARSER_FAIL_IF(alignment >= 32 || (1u << alignment) != naturalAlignment, "byte alignment ", 1ull << std::min(alignment, 63u), " doesn't match ", makeString(op), "'s natural alignment ", naturalAlignment);
+    WASM_PARSER_FAIL_IF(!parseVarUInt32(offset), "can't get ", makeString(op), "'s offset");
+    return { };
+}
+
+template<typename Context>
+auto FunctionParser<Context>::parseAtomicExpression() -> PartialResult
+{
+    AtomicOpType op;
+    WASM_FAIL_IF_HELPER_FAILS(parseAtomicOpcode(op));
+
+    if (op == AtomicOpType::AtomicFence) {
+        uint8_t reserved;
+        WASM_PARSER_FAIL_IF(!parseUInt8(reserved), "can't parse reserved byte for atomic.fence");
+        WASM_PARSER_FAIL_IF(reserved, "reserved byte for atomic.fence must be zero");
+        WASM_TRY_ADD_TO_CONTEXT(atomicFence());
+        return { };
+    }
+
+    uint32_t offset;
+    WASM_FAIL_IF_HELPER_FAILS(parseAtomicMemoryImmediates(op, offset));
+
+    switch (op) {
+    case AtomicOpType::MemoryAtomicNotify: {
+        ExpressionType pointer;
+        ExpressionType count;
+        ExpressionType result;
+        WASM_TRY_POP_EXPRESSION_STACK_INTO(count, "memory.atomic.notify count");
+        WASM_TRY_POP_EXPRESSION_STACK_INTO(pointer, "memory.atomic.notify pointer");
+        WASM_TRY_ADD_TO_CONTEXT(atomicNotify(op, pointer, count, result, offset));
+        m_expressionStack.append(result);
+        return { };
+    }
+
+    case AtomicOpType::MemoryAtomicWait32:
+    case AtomicOpType::MemoryAtomicWait64: {
+        ExpressionType pointer;
+        ExpressionType value;
+        ExpressionType timeout;
+        ExpressionType result;
+        WASM_TRY_POP_EXPRESSION_STACK_INTO(timeout, "memory.atomic.wait timeout");
+        WASM_TRY_POP_EXPRESSION_STACK_INTO(value, "memory.atomic.wait value");
+        WASM_TRY_POP_EXPRESSION_STACK_INTO(pointer, "memory.atomic.wait pointer");
+        WASM_TRY_ADD_TO_CONTEXT(atomicWait(op, pointer, value, timeout, result, offset));
+        m_expressionStack.append(result);
+        return { };
+    }
+
+    case AtomicOpType::AtomicFence:
+        break;
+
+#define CREATE_CASE(name, id, b3op, width, type) case AtomicOpType::name:
+    FOR_EACH_WASM_ATOMIC_LOAD_OP(CREATE_CASE) {
+        ExpressionType pointer;
+        ExpressionType result;
+        WASM_TRY_POP_EXPRESSION_STACK_INTO(pointer, "atomic load pointer");
+        WASM_TRY_ADD_TO_CONTEXT(atomicLoad(op, pointer, result, offset));
+        m_expressionStack.append(result);
+        return { };
+    }
+
+    FOR_EACH_WASM_ATOMIC_STORE_OP(CREATE_CASE) {
+        ExpressionType pointer;
+        ExpressionType value;
+        WASM_TRY_POP_EXPRESSION_STACK_INTO(value, "atomic store value");
+        WASM_TRY_POP_EXPRESSION_STACK_INTO(pointer, "atomic store pointer");
+        WASM_TRY_ADD_TO_CONTEXT(atomicStore(op, pointer, value, offset));
+        return { };
+    }
+
+    FOR_EACH_WASM_ATOMIC_RMW_OP(CREATE_CASE) {
+        ExpressionType pointer;
+        ExpressionType value;
+        ExpressionType result;
+        WASM_TRY_POP_EXPRESSION_STACK_INTO(value, "atomic rmw value");
+        WASM_TRY_POP_EXPRESSION_STACK_INTO(pointer, "atomic rmw pointer");
+        WASM_TRY_ADD_TO_CONTEXT(atomicBinaryRMW(op, pointer, value, result, offset));
+        m_expressionStack.append(result);
+        return { };
+    }
+
+    FOR_EACH_WASM_ATOMIC_CMPXCHG_OP(CREATE_CASE) {
+        ExpressionType pointer;
+        ExpressionType expected;
+        ExpressionType value;
+        ExpressionType result;
+        WASM_TRY_POP_EXPRESSION_STACK_INTO(value, "atomic cmpxchg replacement value");
+        WASM_TRY_POP_EXPRESSION_STACK_INTO(expected, "atomic cmpxchg expected value");
+        WASM_TRY_POP_EXPRESSION_STACK_INTO(pointer, "atomic cmpxchg pointer");
+        WASM_TRY_ADD_TO_CONTEXT(atomicCompareExchange(op, pointer, expected, value, result, offset));
+        m_expressionStack.append(result);
+        return { };
+    }
+#undef CREATE_CASE
+    }
+
+    ASSERT_NOT_REACHED();
+    return { };
+}
+
+template<typename Context>
+auto FunctionParser<Context>::parseUnreachableAtomicExpression() -> PartialResult
+{
+    AtomicOpType op;
+    WASM_FAIL_IF_HELPER_FAILS(parseAtomicOpcode(op));
+
+    if (op == AtomicOpType::AtomicFence) {
+        uint8_t unused;
+        WASM_PARSER_FAIL_IF(!parseUInt8(unused), "can't parse reserved byte for atomic.fence in unreachable context");
+        return { };
+    }
+
+    uint32_t unused;
+    WASM_PARSER_FAIL_IF(!parseVarUInt32(unused), "can't get first immediate for ", makeString(op), " in unreachable context");
+    WASM_PARSER_FAIL_IF(!parseVarUInt32(unused), "can't get second immediate for ", makeString(op), " in unreachable context");
+    return { };
+}
+
 } } // namespace JSC::Wasm
 
 #endif // ENABLE(WEBASSEMBLY)
@@ -30,7 +30,10 @@
 
 #include "Register.h"
 #include "WasmModuleInformation.h"
+#include <wtf/Atomics.h>
 #include <wtf/CheckedArithmetic.h>
+#include <wtf/MonotonicTime.h>
+#include <wtf/ParkingLot.h>
 
 namespace JSC { namespace Wasm {
 
@@ -41,22 +44,23 @@ size_t globalMemoryByteSize(Module& module)
 }
 }
 
-Instance::Instance(Context* context, Ref<Module>&& module, EntryFrame** pointerToTopEntryFrame, void** pointerToActualStackLimit, StoreTopCallFrameCallback&& storeTopCallFrame)
+Instance::Instance(Context* context, Ref<Module>&& module, EntryFrame** pointerToTopEntryFrame, void** pointerToActualStackLimit, StoreTopCallFrameCallback&& storeTopCallFrame, ParkCallback&& park)
     : m_context(context)
     , m_module(WTFMove(module))
     , m_globals(MallocPtr<uint64_t>::malloc(globalMemoryByteSize(m_module.get())))
     , m_pointerToTopEntryFrame(pointerToTopEntryFrame)
     , m_pointerToActualStackLimit(pointerToActualStackLimit)
     , m_storeTopCallFrame(WTFMove(storeTopCallFrame))
+    , m_park(WTFMove(park))
     , m_numImportFunctions(m_module->moduleInformation().importFunctionCount())
 {
     for (unsigned i = 0; i < m_numImportFunctions; ++i)
         new (importFunctionInfo(i)) ImportFunctionInfo();
 }
 
-Ref<Instance> Instance::create(Context* context, Ref<Module>&& module, EntryFrame** pointerToTopEntryFrame, void** pointerToActualStackLimit, StoreTopCallFrameCallback&& storeTopCallFrame)
+Ref<Instance> Instance::create(Context* context, Ref<Module>&& module, EntryFrame** pointerToTopEntryFrame, void** pointerToActualStackLimit, StoreTopCallFrameCallback&& storeTopCallFrame, ParkCallback&& park)
 {
-    return adoptRef(*new (NotNull, fastMalloc(allocationSize(module->moduleInformation().importFunctionCount()))) Instance(context, WTFMove(module), pointerToTopEntryFrame, pointerToActualStackLimit, WTFMove(storeTopCallFrame)));
+    return adoptRef(*new (NotNull, fastMalloc(allocationSize(module->moduleInformation().importFunctionCount()))) Instance(context, WTFMove(module), pointerToTopEntryFrame, pointerToActualStackLimit, WTFMove(storeTopCallFrame), WTFMove(park)));
 }
 
 Instance::~Instance() { }
@@ -66,6 +70,52 @@ size_t Instance::extraMemoryAllocated() const
     return globalMemoryByteSize(m_module.get()) + allocationSize(m_numImportFunctions);
 }
 
+template<typename ValueType>
+int32_t Instance::atomicWait(ValueType* address, ValueType expected, int64_t timeoutInNanoseconds)
+{
+    if (!m_memory || !m_memory->isShared())
+        return -1;
+
+    // Waiters are keyed on the address alone, so wasm and Atomics.wait / Atomics.wake on the same SharedArrayBuffer interoperate.
+    Seconds timeout = timeoutInNanoseconds < 0 ? Seconds::infinity() : Seconds::fromNanoseconds(timeoutInNanoseconds);
+    bool didPassValidation = false;
+    ParkingLot::ParkResult result;
+    bool didPark = m_park(scopedLambda<void()>([&] {
+        result = ParkingLot::parkConditionally(
+            address,
+            [&] () -> bool {
+                didPassValidation = WTF::atomicLoad(address) == expected;
+                return didPassValidation;
+            },
+            [] () { },
+            MonotonicTime::now() + timeout);
+    }));
+    if (!didPark)
+        return -1;
+    if (!didPassValidation)
+        return 1;
+    if (!result.wasUnparked)
+        return 2;
+    return 0;
+}
+
+int32_t Instance::atomicWait32(void* address, int32_t expected, int64_t timeoutInNanoseconds)
+{
+    return atomicWait(static_cast<int32_t*>(address), expected, timeoutInNanoseconds);
+}
+
+int32_t Instance::atomicWait64(void* address, int64_t expected, int64_t timeoutInNanoseconds)
+{
+    return atomicWait(static_cast<int64_t*>(address), expected, timeoutInNanoseconds);
+}
+
+int32_t Instance::atomicNotify(void* address, int32_t count)
+{
+    if (!m_memory || !m_memory->isShared())
+        return 0;
+    return ParkingLot::unparkCount(address, static_cast<uint32_t>(count));
+}
+
 } } // namespace JSC::Wasm
 
 #endif // ENABLE(WEBASSEMBLY)
@@ -34,6 +34,7 @@
 #include <wtf/Optional.h>
 #include <wtf/Ref.h>
 #include <wtf/RefPtr.h>
+#include <wtf/ScopedLambda.h>
 #include <wtf/ThreadSafeRefCounted.h>
 
 namespace JSC { namespace Wasm {
@@ -43,8 +44,11 @@ struct Context;
 class Instance : public ThreadSafeRefCounted<Instance> {
 public:
     using StoreTopCallFrameCallback = WTF::Function<void(void*)>;
+    // memory.atomic.wait hands the embedder a functor which parks the current thread. The embedder returns false if
+    // this thread may not block, otherwise it calls the functor after releasing anything it can't hold while parked.
+    using ParkCallback = WTF::Function<bool(const ScopedLambda<void()>&)>;
 
-    static Ref<Instance> create(Context*, Ref<Module>&&, EntryFrame** pointerToTopEntryFrame, void** pointerToActualStackLimit, StoreTopCallFrameCallback&&);
+    static Ref<Instance> create(Context*, Ref<Module>&&, EntryFrame** pointerToTopEntryFrame, void** pointerToActualStackLimit, StoreTopCallFrameCallback&&, ParkCallback&&);
 
     void finalizeCreation(void* owner, Ref<CodeBlock>&& codeBlock)
     {
@@ -119,8 +123,16 @@ public:
         m_storeTopCallFrame(callFrame);
     }
 
+    // The address has already been bounds and alignment checked. wait returns 0 when woken, 1 if the value didn't
+    // match, 2 on timeout (a negative timeout never expires) and -1 if it should trap. notify returns how many waiters it woke.
+    int32_t atomicWait32(void* address, int32_t expected, int64_t timeoutInNanoseconds);
+    int32_t atomicWait64(void* address, int64_t expected, int64_t timeoutInNanoseconds);
+    int32_t atomicNotify(void* address, int32_t count);
+
 private:
-    Instance(Context*, Ref<Module>&&, EntryFrame**, void**, StoreTopCallFrameCallback&&);
+    Instance(Context*, Ref<Module>&&, EntryFrame**, void**, StoreTopCallFrameCallback&&, ParkCallback&&);
+
+    template<typename ValueType> int32_t atomicWait(ValueType* address, ValueType expected, int64_t timeoutInNanoseconds);
     
     static size_t allocationSize(Checked<size_t> numImportFunctions)
     {
@@ -138,6 +150,7 @@ private:
     void** m_pointerToActualStackLimit { nullptr };
     void* m_cachedStackLimit { bitwise_cast<void*>(std::numeric_limits<uintptr_t>::max()) };
     StoreTopCallFrameCallback m_storeTopCallFrame;
+    ParkCallback m_park;
     unsigned m_numImportFunctions { 0 };
 };
 
@@ -32,8 +32,9 @@
 
 #include <wtf/Expected.h>
 #include <wtf/Function.h>
-#include <wtf/RefCounted.h>
+#include <wtf/Lock.h>
 #include <wtf/RefPtr.h>
+#include <wtf/ThreadSafeRefCounted.h>
 
 namespace WTF {
 class PrintStream;
@@ -43,7 +44,7 @@ namespace JSC {
 
 namespace Wasm {
 
-class Memory : public RefCounted<Memory> {
+class Memory : public ThreadSafeRefCounted<Memory> {
     WTF_MAKE_NONCOPYABLE(Memory);
     WTF_MAKE_FAST_ALLOCATED;
 public:
@@ -56,7 +57,9 @@ public:
     enum GrowSuccess { GrowSuccessTag };
 
     static RefPtr<Memory> create();
-    static RefPtr<Memory> create(PageCount initial, PageCount maximum, WTF::Function<void(NotifyPressure)>&& notifyMemoryPressure, WTF::Function<void(SyncTryToReclaim)>&& syncTryToReclaimMemory, WTF::Function<void(GrowSuccess, PageCount, PageCount)>&& growSuccessCallback);
+    enum class SharingMode { Default, Shared };
+
+    static RefPtr<Memory> create(PageCount initial, PageCount maximum, SharingMode, WTF::Function<void(NotifyPressure)>&& notifyMemoryPressure, WTF::Function<void(SyncTryToReclaim)>&& syncTryToReclaimMemory, WTF::Function<void(GrowSuccess, PageCount, PageCount)>&& growSuccessCallback);
 
     ~Memory();
 
@@ -72,16 +75,20 @@ public:
     PageCount maximum() const { return m_maximum; }
 
     MemoryMode mode() const { return m_mode; }
+    // Shared memories always have a maximum, but can't grow: every agent caches the size, and the
+    // grow callbacks belong to the agent that created the memory.
+    bool isShared() const { return m_sharingMode == SharingMode::Shared; }
 
     enum class GrowFailReason {
         InvalidDelta,
         InvalidGrowSize,
         WouldExceedMaximum,
         OutOfMemory,
+        SharedMemory,
     };
     Expected<PageCount, GrowFailReason> grow(PageCount);
 
-    void check() {  ASSERT(!deletionHasBegun()); }
+    void check() { ASSERT(refCount()); }
 
     static ptrdiff_t offsetOfMemory() { return OBJECT_OFFSETOF(Memory, m_memory); }
     static ptrdiff_t offsetOfSize() { return OBJECT_OFFSETOF(Memory, m_size); }
@@ -89,8 +96,8 @@ public:
 
 private:
     Memory();
-    Memory(void* memory, PageCount initial, PageCount maximum, size_t mappedCapacity, MemoryMode, WTF::Function<void(NotifyPressure)>&& notifyMemoryPressure, WTF::Function<void(SyncTryToReclaim)>&& syncTryToReclaimMemory, WTF::Function<void(GrowSuccess, PageCount, PageCount)>&& growSuccessCallback);
-    Memory(PageCount initial, PageCount maximum, WTF::Function<void(NotifyPressure)>&& notifyMemoryPressure, WTF::Function<void(SyncTryToReclaim)>&& syncTryToReclaimMemory, WTF::Function<void(GrowSuccess, PageCount, PageCount)>&& growSuccessCallback);
+    Memory(void* memory, PageCount initial, PageCount maximum, size_t mappedCapacity, MemoryMode, SharingMode, WTF::Function<void(NotifyPressure)>&& notifyMemoryPressure, WTF::Function<void(SyncTryToReclaim)>&& syncTryToReclaimMemory, WTF::Function<void(GrowSuccess, PageCount, PageCount)>&& growSuccessCallback);
+    Memory(PageCount initial, PageCount maximum, SharingMode, WTF::Function<void(NotifyPressure)>&& notifyMemoryPressure, WTF::Function<void(SyncTryToReclaim)>&& syncTryToReclaimMemory, WTF::Function<void(GrowSuccess, PageCount, PageCount)>&& growSuccessCallback);
 
     // FIXME: we cache these on the instances to avoid a load on instance->instance calls. This will require updating all the instances when grow is called. https://bugs.webkit.org/show_bug.cgi?id=177305
     void* m_memory { nullptr };
@@ -100,6 +107,8 @@ private:
     PageCount m_maximum;
     size_t m_mappedCapacity { 0 };
     MemoryMode m_mode { MemoryMode::BoundsChecking };
+    SharingMode m_sharingMode { SharingMode::Default };
+    Lock m_growLock;
     WTF::Function<void(NotifyPressure)> m_notifyMemoryPressure;
     WTF::Function<void(SyncTryToReclaim)> m_syncTryToReclaimMemory;
     WTF::Function<void(GrowSuccess, PageCount, PageCount)> m_growSuccessCallback;
@@ -30,6 +30,7 @@
 
 #include "WasmBBQPlanInlines.h"
 #include "WasmModuleInformation.h"
+#include "WasmStreamingPlan.h"
 #include "WasmWorklist.h"
 
 namespace JSC { namespace Wasm {
@@ -46,7 +47,8 @@ Wasm::SignatureIndex Module::signatureIndexFromFunctionIndexSpace(unsigned funct
     return m_moduleInformation->signatureIndexFromFunctionIndexSpace(functionIndexSpace);
 }
 
-static Module::ValidationResult makeValidationResult(BBQPlan& plan)
+template<typename PlanType>
+static Module::ValidationResult makeValidationResult(PlanType& plan)
 {
     ASSERT(!plan.hasWork());
     if (plan.failed())
@@ -54,11 +56,12 @@ static Module::ValidationResult makeValidationResult(BBQPlan& plan)
     return Module::ValidationResult(Module::create(plan.takeModuleInformation()));
 }
 
+template<typename PlanType>
 static Plan::CompletionTask makeValidationCallback(Module::AsyncValidationCallback&& callback)
 {
     return createSharedTask<Plan::CallbackType>([callback = WTFMove(callback)] (Plan& plan) {
         ASSERT(!plan.hasWork());
-        callback->run(makeValidationResult(static_cast<BBQPlan&>(plan)));
+        callback->run(makeValidationResult(static_cast<PlanType&>(plan)));
     });
 }
 
@@ -71,10 +74,16 @@ Module::ValidationResult Module::validateSync(Context* context, Vector<uint8_t>&
 
 void Module::validateAsync(Context* context, Vector<uint8_t>&& source, Module::AsyncValidationCallback&& callback)
 {
-    Ref<Plan> plan = adoptRef(*new BBQPlan(context, WTFMove(source), BBQPlan::Validation, makeValidationCallback(WTFMove(callback)), nullptr, nullptr));
+    Ref<Plan> plan = adoptRef(*new BBQPlan(context, WTFMove(source), BBQPlan::Validation, makeValidationCallback<BBQPlan>(WTFMove(callback)), nullptr, nullptr));
     Wasm::ensureWorklist().enqueue(WTFMove(plan));
 }
 
+Ref<StreamingPlan> Module::validateStreaming(Context* context, Module::AsyncValidationCallback&& callback)
+{
+    // The plan enqueues itself on the Worklist once the first function body has arrived.
+    return adoptRef(*new StreamingPlan(context, makeValidationCallback<StreamingPlan>(WTFMove(callback))));
+}
+
 Ref<CodeBlock> Module::getOrCreateCodeBlock(Context* context, MemoryMode mode, CreateEmbedderWrapper&& createEmbedderWrapper, ThrowWasmException throwWasmException)
 {
     RefPtr<CodeBlock> codeBlock;
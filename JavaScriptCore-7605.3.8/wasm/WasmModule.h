@@ -40,6 +40,7 @@ namespace JSC { namespace Wasm {
 struct Context;
 struct ModuleInformation;
 class Plan;
+class StreamingPlan;
 
 using SignatureIndex = uint32_t;
 
@@ -51,6 +52,8 @@ public:
 
     static ValidationResult validateSync(Context*, Vector<uint8_t>&& source);
     static void validateAsync(Context*, Vector<uint8_t>&& source, Module::AsyncValidationCallback&&);
+    // The caller feeds the returned plan with the module's bytes as they arrive.
+    JS_EXPORT_PRIVATE static Ref<StreamingPlan> validateStreaming(Context*, Module::AsyncValidationCallback&&);
 
     static Ref<Module> create(Ref<ModuleInformation>&& moduleInformation)
     {
@@ -67,6 +70,9 @@ public:
 
     CodeBlock* codeBlockFor(MemoryMode mode) { return m_codeBlocks[static_cast<uint8_t>(mode)].get(); }
 private:
+    friend class ModuleDecoder;
+    friend class ModuleEncoder;
+
     Ref<CodeBlock> getOrCreateCodeBlock(Context*, MemoryMode, CreateEmbedderWrapper&&, ThrowWasmException);
 
     Module(Ref<ModuleInformation>&&);
@@ -50,6 +50,16 @@ ModuleInformation::ModuleInformation(Vector<uint8_t>&& sourceBytes)
 }
 ModuleInformation::~ModuleInformation() { }
 
+void ModuleInformation::setStreamedSource(Vector<uint8_t>&& sourceBytes)
+{
+    ASSERT(source.isEmpty());
+    source = WTFMove(sourceBytes);
+    if (Options::useEagerWebAssemblyModuleHashing()) {
+        hash = sha1(source);
+        nameSection->setHash(hash);
+    }
+}
+
 } } // namespace JSC::Wasm
 
 #endif // ENABLE(WEBASSEMBLY)
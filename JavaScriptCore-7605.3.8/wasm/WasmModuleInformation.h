@@ -38,9 +38,13 @@ struct ModuleInformation : public ThreadSafeRefCounted<ModuleInformation> {
     ModuleInformation(const ModuleInformation&) = delete;
     ModuleInformation(ModuleInformation&&) = delete;
 
-    ModuleInformation(Vector<uint8_t>&& sourceBytes);
+    JS_EXPORT_PRIVATE ModuleInformation(Vector<uint8_t>&& sourceBytes);
 
     JS_EXPORT_PRIVATE ~ModuleInformation();
+
+    // Streaming compilation parses a module before all of its bytes are known. The complete
+    // binary is handed over once the last chunk has arrived.
+    void setStreamedSource(Vector<uint8_t>&& sourceBytes);
     
     size_t functionIndexSpaceSize() const { return importFunctionSignatureIndices.size() + internalFunctionSignatureIndices.size(); }
     bool isImportedFunctionFromFunctionIndexSpace(size_t functionIndex) const
@@ -58,8 +62,8 @@ struct ModuleInformation : public ThreadSafeRefCounted<ModuleInformation> {
     uint32_t importFunctionCount() const { return importFunctionSignatureIndices.size(); }
     uint32_t internalFunctionCount() const { return internalFunctionSignatureIndices.size(); }
 
-    const Vector<uint8_t> source;
-    const std::optional<CString> hash;
+    Vector<uint8_t> source;
+    std::optional<CString> hash;
 
     Vector<Import> imports;
     Vector<SignatureIndex> importFunctionSignatureIndices;
@@ -73,25 +73,7 @@ auto ModuleParser::parse() -> Result
 
         auto end = m_offset + sectionLength;
 
-        switch (section) {
-#define WASM_SECTION_PARSE(NAME, ID, DESCRIPTION)                   \
-        case Section::NAME: {                                       \
-            WASM_FAIL_IF_HELPER_FAILS(parse ## NAME());             \
-            break;                                                  \
-        }
-        FOR_EACH_KNOWN_WASM_SECTION(WASM_SECTION_PARSE)
-#undef WASM_SECTION_PARSE
-
-        case Section::Custom: {
-            WASM_FAIL_IF_HELPER_FAILS(parseCustom(sectionLength));
-            break;
-        }
-
-        case Section::Begin: {
-            RELEASE_ASSERT_NOT_REACHED();
-            break;
-        }
-        }
+        WASM_FAIL_IF_HELPER_FAILS(parseSectionPayload(section, sectionLength));
 
         WASM_PARSER_FAIL_IF(end != m_offset, "parsing ended before the end of ", section, " section");
 
@@ -103,6 +85,39 @@ auto ModuleParser::parse() -> Result
     return { };
 }
 
+auto ModuleParser::parseSection(Section section) -> Result
+{
+    WASM_PARSER_FAIL_IF(length() > maxModuleSize, section, " section of size ", length(), " is too large, maximum module size is ", maxModuleSize);
+    WASM_FAIL_IF_HELPER_FAILS(parseSectionPayload(section, length()));
+    WASM_PARSER_FAIL_IF(m_offset != length(), "parsing ended before the end of ", section, " section");
+    return { };
+}
+
+auto ModuleParser::parseSectionPayload(Section section, uint32_t sectionLength) -> PartialResult
+{
+    switch (section) {
+#define WASM_SECTION_PARSE(NAME, ID, DESCRIPTION)                   \
+    case Section::NAME: {                                           \
+        WASM_FAIL_IF_HELPER_FAILS(parse ## NAME());                 \
+        break;                                                      \
+    }
+    FOR_EACH_KNOWN_WASM_SECTION(WASM_SECTION_PARSE)
+#undef WASM_SECTION_PARSE
+
+    case Section::Custom: {
+        WASM_FAIL_IF_HELPER_FAILS(parseCustom(sectionLength));
+        break;
+    }
+
+    case Section::Begin: {
+        RELEASE_ASSERT_NOT_REACHED();
+        break;
+    }
+    }
+
+    return { };
+}
+
 auto ModuleParser::parseType() -> PartialResult
 {
     uint32_t count;
@@ -127,6 +142,7 @@ auto ModuleParser::parseType() -> PartialResult
         for (unsigned i = 0; i < argumentCount; ++i) {
             Type argumentType;
             WASM_PARSER_FAIL_IF(!parseResultType(argumentType), "can't get ", i, "th argument Type");
+            WASM_PARSER_FAIL_IF(argumentType == V128, i, "th argument Type is v128, which isn't allowed in function signatures");
             signature->argument(i) = argumentType;
         }
 
@@ -136,6 +152,7 @@ auto ModuleParser::parseType() -> PartialResult
         if (returnCount) {
             Type value;
             WASM_PARSER_FAIL_IF(!parseValueType(value), "can't get ", i, "th Type's return value");
+            WASM_PARSER_FAIL_IF(value == V128, i, "th Type's return value is v128, which isn't allowed in function signatures");
             returnType = static_cast<Type>(value);
         } else
             returnType = Type::Void;
@@ -237,15 +254,18 @@ auto ModuleParser::parseFunction() -> PartialResult
     return { };
 }
 
-auto ModuleParser::parseResizableLimits(uint32_t& initial, std::optional<uint32_t>& maximum) -> PartialResult
+auto ModuleParser::parseResizableLimits(uint32_t& initial, std::optional<uint32_t>& maximum, bool& isShared) -> PartialResult
 {
     ASSERT(!maximum);
 
-    uint8_t flags;
-    WASM_PARSER_FAIL_IF(!parseVarUInt1(flags), "can't parse resizable limits flags");
+    // Bit 0 says a maximum is present, bit 1 that the memory is shared. Shared memories must have a maximum.
+    uint32_t flags;
+    WASM_PARSER_FAIL_IF(!parseVarUInt32(flags), "can't parse resizable limits flags");
+    WASM_PARSER_FAIL_IF(flags > 1 && !(flags == 3 && Options::useWebAssemblyThreads()), "resizable limits has invalid flags ", flags);
+    isShared = flags & 2;
     WASM_PARSER_FAIL_IF(!parseVarUInt32(initial), "can't parse resizable limits initial page count");
 
-    if (flags) {
+    if (flags & 1) {
         uint32_t maximumInt;
         WASM_PARSER_FAIL_IF(!parseVarUInt32(maximumInt), "can't parse resizable limits maximum page count");
         WASM_PARSER_FAIL_IF(initial > maximumInt, "resizable limits has a initial page count of ", initial, " which is greater than its maximum ", maximumInt);
@@ -267,9 +287,11 @@ auto ModuleParser::parseTableHelper(bool isImport) -> PartialResult
 
     uint32_t initial;
     std::optional<uint32_t> maximum;
-    PartialResult limits = parseResizableLimits(initial, maximum);
+    bool isShared;
+    PartialResult limits = parseResizableLimits(initial, maximum, isShared);
     if (UNLIKELY(!limits))
         return makeUnexpected(WTFMove(limits.error()));
+    WASM_PARSER_FAIL_IF(isShared, "Table can't be shared");
     WASM_PARSER_FAIL_IF(initial > maxTableEntries, "Table's initial page count of ", initial, " is too big, maximum ", maxTableEntries);
 
     ASSERT(!maximum || *maximum >= initial);
@@ -304,10 +326,11 @@ auto ModuleParser::parseMemoryHelper(bool isImport) -> PartialResult
 
     PageCount initialPageCount;
     PageCount maximumPageCount;
+    bool isShared;
     {
         uint32_t initial;
         std::optional<uint32_t> maximum;
-        PartialResult limits = parseResizableLimits(initial, maximum);
+        PartialResult limits = parseResizableLimits(initial, maximum, isShared);
         if (UNLIKELY(!limits))
             return makeUnexpected(WTFMove(limits.error()));
         ASSERT(!maximum || *maximum >= initial);
@@ -323,7 +346,7 @@ auto ModuleParser::parseMemoryHelper(bool isImport) -> PartialResult
     ASSERT(initialPageCount);
     ASSERT(!maximumPageCount || maximumPageCount >= initialPageCount);
 
-    m_info->memory = MemoryInformation(initialPageCount, maximumPageCount, isImport);
+    m_info->memory = MemoryInformation(initialPageCount, maximumPageCount, isShared, isImport);
     return { };
 }
 
@@ -556,6 +579,7 @@ auto ModuleParser::parseGlobalType(Global& global) -> PartialResult
 {
     uint8_t mutability;
     WASM_PARSER_FAIL_IF(!parseValueType(global.type), "can't get Global's value type");
+    WASM_PARSER_FAIL_IF(global.type == V128, "Global's value type can't be v128");
     WASM_PARSER_FAIL_IF(!parseVarUInt1(mutability), "can't get Global type's mutability");
     global.mutability = static_cast<Global::Mutability>(mutability);
     return { };
@@ -30,6 +30,7 @@
 #include "WasmFormat.h"
 #include "WasmOps.h"
 #include "WasmParser.h"
+#include "WasmSections.h"
 #include <wtf/Optional.h>
 #include <wtf/Vector.h>
 
@@ -40,12 +41,19 @@ public:
     ModuleParser(const uint8_t* sourceBuffer, size_t sourceLength, ModuleInformation& info)
         : Parser(sourceBuffer, sourceLength)
         , m_info(info)
+        , m_memoryCount(!!info.memory)
+        , m_tableCount(!!info.tableInformation)
     {
     }
 
     Result WARN_UNUSED_RETURN parse();
 
+    // Parses a single section whose payload is exactly this parser's buffer. This lets the
+    // StreamingParser hand sections over one at a time as their bytes arrive.
+    Result WARN_UNUSED_RETURN parseSection(Section);
+
 private:
+    PartialResult WARN_UNUSED_RETURN parseSectionPayload(Section, uint32_t sectionLength);
 
 #define WASM_SECTION_DECLARE_PARSER(NAME, ID, DESCRIPTION) PartialResult WARN_UNUSED_RETURN parse ## NAME();
     FOR_EACH_KNOWN_WASM_SECTION(WASM_SECTION_DECLARE_PARSER)
@@ -55,12 +63,12 @@ private:
     PartialResult WARN_UNUSED_RETURN parseGlobalType(Global&);
     PartialResult WARN_UNUSED_RETURN parseMemoryHelper(bool isImport);
     PartialResult WARN_UNUSED_RETURN parseTableHelper(bool isImport);
-    PartialResult WARN_UNUSED_RETURN parseResizableLimits(uint32_t& initial, std::optional<uint32_t>& maximum);
+    PartialResult WARN_UNUSED_RETURN parseResizableLimits(uint32_t& initial, std::optional<uint32_t>& maximum, bool& isShared);
     PartialResult WARN_UNUSED_RETURN parseInitExpr(uint8_t&, uint64_t&, Type& initExprType);
 
     Ref<ModuleInformation> m_info;
-    uint32_t m_memoryCount { 0 };
-    uint32_t m_tableCount { 0 };
+    uint32_t m_memoryCount;
+    uint32_t m_tableCount;
 };
 
 } } // namespace JSC::Wasm
@@ -0,0 +1,543 @@
+/*
+ * Copyright (C) 2018 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "WasmModuleSerialization.h"
+
+#if ENABLE(WEBASSEMBLY)
+
+#include "B3Compilation.h"
+#include "CalleeBits.h"
+#include "ExecutableAllocator.h"
+#include "LinkBuffer.h"
+#include "WasmB3IRGenerator.h"
+#include "WasmBinding.h"
+#include "WasmCallee.h"
+#include "WasmCodeBlock.h"
+#include "WasmContext.h"
+#include "WasmModuleInformation.h"
+#include "WasmModuleParser.h"
+#include "WasmThunks.h"
+#include <mutex>
+#include <wtf/HashMap.h>
+#include <wtf/text/StringHasher.h>
+
+#if OS(UNIX)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace JSC { namespace Wasm {
+
+static const uint32_t serializedModuleMagic = 0x6d736177; // "wasm" backwards.
+
+// The serialized code bakes in the engine's code generation choices, so any build or
+// configuration that could generate different code has to produce a different version.
+static uint32_t serializedModuleVersion()
+{
+    static uint32_t version;
+    static std::once_flag onceFlag;
+    std::call_once(onceFlag, [] {
+        StringHasher hasher;
+        for (const char* character = __DATE__ " " __TIME__; *character; ++character)
+            hasher.addCharacter(*character);
+        hasher.addCharacter(static_cast<UChar>(sizeof(void*)));
+        hasher.addCharacter(static_cast<UChar>(Context::useFastTLS()));
+        hasher.addCharacter(static_cast<UChar>(Options::useBBQTierUpChecks()));
+        hasher.addCharacter(static_cast<UChar>(Options::enableSpectreMitigations()));
+        hasher.addCharacter(static_cast<UChar>(Options::webAssemblyBBQOptimizationLevel()));
+        hasher.addCharacter(static_cast<UChar>(Options::reservedZoneSize()));
+        hasher.addCharacter(static_cast<UChar>(Options::reservedZoneSize() >> 16));
+#if CPU(X86_64)
+        hasher.addCharacter(static_cast<UChar>(MacroAssembler::supportsFloatingPointRounding()));
+        hasher.addCharacter(static_cast<UChar>(MacroAssembler::supportsAVX()));
+        hasher.addCharacter(static_cast<UChar>(MacroAssembler::supportsVectorOperations()));
+#endif
+        version = hasher.hashWithTop8BitsMasked();
+    });
+    return version;
+}
+
+class ModuleEncoder {
+public:
+    ModuleEncoder(Module& module)
+        : m_module(module)
+        , m_info(module.moduleInformation())
+    {
+        for (uint32_t i = 0; i < m_info.usedSignatures.size(); ++i)
+            m_moduleSignatureIndices.add(SignatureInformation::get(m_info.usedSignatures[i].get()), i);
+    }
+
+    Expected<Vector<uint8_t>, String> encodeModule()
+    {
+        Vector<RefPtr<CodeBlock>> codeBlocks;
+        {
+            auto locker = holdLock(m_module.m_lock);
+            for (auto& codeBlock : m_module.m_codeBlocks) {
+                if (codeBlock && codeBlock->runnable())
+                    codeBlocks.append(codeBlock);
+            }
+        }
+        if (codeBlocks.isEmpty())
+            return makeUnexpected(String(ASCIILiteral("WebAssembly module has not been compiled")));
+
+        append(serializedModuleMagic);
+        append(serializedModuleVersion());
+        appendVector(m_info.source);
+        append<uint8_t>(codeBlocks.size());
+        for (auto& codeBlock : codeBlocks) {
+            if (auto error = encodeCodeBlock(*codeBlock))
+                return makeUnexpected(WTFMove(*error));
+        }
+        return WTFMove(m_buffer);
+    }
+
+private:
+    template<typename T>
+    void append(const T& value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Only PODs can be copied into a serialized module verbatim");
+        m_buffer.append(reinterpret_cast<const uint8_t*>(&value), sizeof(T));
+    }
+
+    template<typename T>
+    void appendVector(const T& vector)
+    {
+        static_assert(std::is_trivially_copyable<typename T::ValueType>::value, "Only PODs can be copied into a serialized module verbatim");
+        append<uint32_t>(vector.size());
+        m_buffer.append(reinterpret_cast<const uint8_t*>(vector.data()), vector.size() * sizeof(typename T::ValueType));
+    }
+
+    std::optional<String> encodeCodeBlock(CodeBlock& codeBlock)
+    {
+        // Holding the lock keeps OMG tier-up from repatching the code while we copy it.
+        auto locker = holdLock(codeBlock.m_lock);
+        if (codeBlock.m_relocations.size() != codeBlock.m_calleeCount)
+            return String(ASCIILiteral("WebAssembly module was compiled without relocations, which requires the useRelocatableBBQCode option"));
+
+        append(codeBlock.mode());
+        for (unsigned calleeIndex = 0; calleeIndex < codeBlock.m_calleeCount; ++calleeIndex) {
+            Callee& callee = *codeBlock.m_callees[calleeIndex];
+            MacroAssemblerCodeRef codeRef = callee.codeRef();
+            const uint8_t* start = codeRef.code().dataLocation<const uint8_t*>();
+            append<uint32_t>(codeRef.size());
+            m_buffer.append(start, codeRef.size());
+            append<bool>(codeBlock.m_embedderCallees.contains(calleeIndex));
+
+            const Vector<Relocation>& relocations = codeBlock.m_relocations[calleeIndex];
+            append<uint32_t>(relocations.size());
+            for (const Relocation& relocation : relocations) {
+                append<uint32_t>(relocation.location.dataLocation<const uint8_t*>() - start);
+                append(relocation.target);
+                uint32_t argument = relocation.argument;
+                if (relocation.target == Relocation::Target::SignatureIndex) {
+                    ASSERT(m_moduleSignatureIndices.contains(argument));
+                    argument = m_moduleSignatureIndices.get(argument);
+                }
+                append(argument);
+            }
+
+            RegisterAtOffsetList& calleeSaveRegisters = *callee.calleeSaveRegisters();
+            append<uint32_t>(calleeSaveRegisters.size());
+            for (const RegisterAtOffset& registerAtOffset : calleeSaveRegisters) {
+                append<uint8_t>(registerAtOffset.reg().index());
+                append<int32_t>(registerAtOffset.offset());
+            }
+        }
+        return std::nullopt;
+    }
+
+    Module& m_module;
+    const ModuleInformation& m_info;
+    // SignatureIndices are only unique within a process, so the code refers to the module's own signature indices.
+    HashMap<SignatureIndex, uint32_t, DefaultHash<SignatureIndex>::Hash, WTF::UnsignedWithZeroKeyHashTraits<SignatureIndex>> m_moduleSignatureIndices;
+    Vector<uint8_t> m_buffer;
+};
+
+// The bytes that applying a relocation rewrites, relative to its location.
+struct PatchedBytes {
+    int32_t begin;
+    int32_t end;
+};
+
+static PatchedBytes patchedBytes(Relocation::Target target)
+{
+    switch (target) {
+    case Relocation::Target::Function:
+    case Relocation::Target::TriggerOMGTierUp:
+        // A near call is located at its return address, right after the call's offset.
+        return { -4, 0 };
+    case Relocation::Target::ThrowException:
+    case Relocation::Target::ThrowStackOverflow:
+#if CPU(X86_64)
+        return { -4, 0 };
+#else
+        return { 0, 4 };
+#endif
+    case Relocation::Target::Callee:
+    case Relocation::Target::TierUpCount:
+    case Relocation::Target::SignatureIndex:
+    case Relocation::Target::GrowMemory:
+    case Relocation::Target::AtomicWait32:
+    case Relocation::Target::AtomicWait64:
+    case Relocation::Target::AtomicNotify:
+    case Relocation::Target::PopcountInt32:
+    case Relocation::Target::PopcountInt64:
+        // A moveWithPatch() of a pointer.
+#if CPU(X86_64)
+        return { -static_cast<int32_t>(sizeof(void*)), 0 };
+#else
+        return { 0, static_cast<int32_t>(3 * sizeof(int)) };
+#endif
+    }
+    RELEASE_ASSERT_NOT_REACHED();
+    return { 0, 0 };
+}
+
+class ModuleDecoder {
+public:
+    ModuleDecoder(const uint8_t* data, size_t size)
+        : m_cursor(data)
+        , m_end(data + size)
+    {
+    }
+
+    Module::ValidationResult decodeModule(Context*, CreateEmbedderWrapper& createEmbedderWrapper, ThrowWasmException throwWasmException)
+    {
+        uint32_t magic = read<uint32_t>();
+        uint32_t version = read<uint32_t>();
+        if (failed() || magic != serializedModuleMagic || version != serializedModuleVersion())
+            return makeUnexpected(String(ASCIILiteral("serialized WebAssembly module was produced by a different build")));
+
+        uint32_t sourceSize = read<uint32_t>();
+        if (!canRead(sourceSize))
+            return makeUnexpected(corruptedError());
+        Vector<uint8_t> source;
+        source.append(m_cursor, sourceSize);
+        m_cursor += sourceSize;
+
+        // The function bodies were validated when the code was compiled, and the version check
+        // guarantees that this engine produced the file, so we only need the module's sections.
+        Ref<ModuleInformation> info = adoptRef(*new ModuleInformation(WTFMove(source)));
+        {
+            ModuleParser moduleParser(info->source.data(), info->source.size(), info);
+            auto parseResult = moduleParser.parse();
+            if (!parseResult)
+                return makeUnexpected(WTFMove(parseResult.error()));
+        }
+
+        if (throwWasmException)
+            Thunks::singleton().setThrowWasmException(throwWasmException);
+
+        Ref<Module> module = Module::create(info.copyRef());
+        uint8_t codeBlockCount = read<uint8_t>();
+        for (uint8_t i = 0; i < codeBlockCount; ++i) {
+            uint8_t mode = read<uint8_t>();
+            if (failed() || mode >= NumberOfMemoryModes || module->m_codeBlocks[mode])
+                return makeUnexpected(corruptedError());
+            RefPtr<CodeBlock> codeBlock = decodeCodeBlock(info, static_cast<MemoryMode>(mode), createEmbedderWrapper);
+            if (!codeBlock)
+                return makeUnexpected(m_errorMessage.isNull() ? corruptedError() : m_errorMessage);
+            module->m_codeBlocks[mode] = WTFMove(codeBlock);
+        }
+        if (failed() || m_cursor != m_end)
+            return makeUnexpected(corruptedError());
+        return Module::ValidationResult(WTFMove(module));
+    }
+
+private:
+    template<typename T>
+    T read()
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Only PODs can be copied out of a serialized module verbatim");
+        T result { };
+        if (!canRead(sizeof(T)))
+            return result;
+        memcpy(&result, m_cursor, sizeof(T));
+        m_cursor += sizeof(T);
+        return result;
+    }
+
+    bool canRead(size_t size)
+    {
+        if (m_failed || static_cast<size_t>(m_end - m_cursor) < size) {
+            m_failed = true;
+            return false;
+        }
+        return true;
+    }
+
+    bool failed() const { return m_failed; }
+
+    static String corruptedError() { return String(ASCIILiteral("serialized WebAssembly module is corrupted")); }
+
+    RefPtr<CodeBlock> decodeCodeBlock(ModuleInformation& info, MemoryMode mode, CreateEmbedderWrapper& createEmbedderWrapper)
+    {
+        auto* result = new (NotNull, fastMalloc(sizeof(CodeBlock))) CodeBlock(mode, info);
+        Ref<CodeBlock> codeBlock = adoptRef(*result);
+        unsigned calleeCount = codeBlock->m_calleeCount;
+
+        for (unsigned importIndex = 0; importIndex < info.importFunctionCount(); ++importIndex) {
+            auto binding = wasmToWasm(importIndex);
+            if (UNLIKELY(!binding)) {
+                m_errorMessage = ASCIILiteral("Out of executable memory while loading a serialized WebAssembly module");
+                return nullptr;
+            }
+            codeBlock->m_wasmToWasmExitStubs.append(binding.value());
+        }
+
+        codeBlock->m_callees.resize(calleeCount);
+        codeBlock->m_optimizedCallees.resize(calleeCount);
+        codeBlock->m_wasmIndirectCallEntryPoints.resize(calleeCount);
+        codeBlock->m_tierUpCounts.resize(calleeCount);
+        codeBlock->m_wasmToWasmCallsites.resize(calleeCount);
+        codeBlock->m_relocations.resize(calleeCount);
+
+        Vector<bool> hasEmbedderEntrypoint(calleeCount);
+        for (unsigned calleeIndex = 0; calleeIndex < calleeCount; ++calleeIndex) {
+            uint32_t codeSize = read<uint32_t>();
+            if (!codeSize || !canRead(codeSize))
+                return nullptr;
+
+            // We copy the code into the JIT region rather than mapping the file executable, so that it is
+            // accounted for and protected like all other JIT code.
+            RefPtr<ExecutableMemoryHandle> executableMemory = ExecutableAllocator::singleton().allocate(codeSize, codeBlock.ptr(), JITCompilationCanFail);
+            if (!executableMemory) {
+                m_errorMessage = ASCIILiteral("Out of executable memory while loading a serialized WebAssembly module");
+                return nullptr;
+            }
+            uint8_t* start = static_cast<uint8_t*>(executableMemory->start());
+            performJITMemcpy(start, m_cursor, codeSize);
+            m_cursor += codeSize;
+
+            hasEmbedderEntrypoint[calleeIndex] = read<bool>();
+
+            uint32_t relocationCount = read<uint32_t>();
+            if (!canRead(static_cast<size_t>(relocationCount) * (sizeof(uint32_t) + sizeof(Relocation::Target) + sizeof(uint32_t))))
+                return nullptr;
+            Vector<Relocation>& relocations = codeBlock->m_relocations[calleeIndex];
+            relocations.reserveInitialCapacity(relocationCount);
+            for (uint32_t i = 0; i < relocationCount; ++i) {
+                uint32_t offset = read<uint32_t>();
+                auto target = read<Relocation::Target>();
+                uint32_t argument = read<uint32_t>();
+                if (target > Relocation::Target::TriggerOMGTierUp)
+                    return nullptr;
+                PatchedBytes patched = patchedBytes(target);
+                if (static_cast<int64_t>(offset) + patched.begin < 0 || static_cast<int64_t>(offset) + patched.end > codeSize)
+                    return nullptr;
+                if (target == Relocation::Target::SignatureIndex && argument >= info.usedSignatures.size())
+                    return nullptr;
+                if (target == Relocation::Target::Function && argument >= info.functionIndexSpaceSize())
+                    return nullptr;
+                relocations.uncheckedAppend(Relocation { CodeLocationLabel(start + offset), target, argument });
+            }
+
+            Entrypoint entrypoint;
+            uint32_t calleeSaveRegisterCount = read<uint32_t>();
+            for (uint32_t i = 0; i < calleeSaveRegisterCount; ++i) {
+                uint8_t regIndex = read<uint8_t>();
+                int32_t offset = read<int32_t>();
+                if (failed() || regIndex >= Reg::maxIndex())
+                    return nullptr;
+                Reg reg = Reg::fromIndex(regIndex);
+                if (entrypoint.calleeSaveRegisters.size() && !(entrypoint.calleeSaveRegisters.at(entrypoint.calleeSaveRegisters.size() - 1).reg() < reg))
+                    return nullptr;
+                entrypoint.calleeSaveRegisters.append(RegisterAtOffset(reg, offset));
+            }
+            if (failed())
+                return nullptr;
+
+            entrypoint.compilation = std::make_unique<B3::Compilation>(MacroAssemblerCodeRef(executableMemory.releaseNonNull()), nullptr);
+            size_t functionIndexSpace = calleeIndex + info.importFunctionCount();
+            codeBlock->m_callees[calleeIndex] = Callee::create(WTFMove(entrypoint), functionIndexSpace, info.nameSection->get(functionIndexSpace));
+            codeBlock->m_wasmIndirectCallEntryPoints[calleeIndex] = codeBlock->m_callees[calleeIndex]->entrypoint().executableAddress();
+        }
+
+        // Every callee exists now, so direct calls can be pointed at their targets.
+        for (unsigned calleeIndex = 0; calleeIndex < calleeCount; ++calleeIndex) {
+            for (Relocation& relocation : codeBlock->m_relocations[calleeIndex])
+                applyRelocation(codeBlock.get(), info, calleeIndex, relocation);
+            MacroAssemblerCodeRef codeRef = codeBlock->m_callees[calleeIndex]->codeRef();
+            MacroAssembler::cacheFlush(codeRef.code().dataLocation(), codeRef.size());
+        }
+
+        for (unsigned calleeIndex = 0; calleeIndex < calleeCount; ++calleeIndex) {
+            if (!hasEmbedderEntrypoint[calleeIndex])
+                continue;
+            if (!createEmbedderEntrypoint(codeBlock.get(), info, calleeIndex, createEmbedderWrapper))
+                return nullptr;
+        }
+
+        codeBlock->setCompilationFinished();
+        return WTFMove(codeBlock);
+    }
+
+    MacroAssemblerCodePtr entrypointForFunctionIndexSpace(CodeBlock& codeBlock, const ModuleInformation& info, size_t functionIndexSpace)
+    {
+        if (info.isImportedFunctionFromFunctionIndexSpace(functionIndexSpace))
+            return codeBlock.m_wasmToWasmExitStubs[functionIndexSpace].code();
+        return codeBlock.m_callees[functionIndexSpace - info.importFunctionCount()]->entrypoint();
+    }
+
+    void applyRelocation(CodeBlock& codeBlock, const ModuleInformation& info, unsigned calleeIndex, Relocation& relocation)
+    {
+        switch (relocation.target) {
+        case Relocation::Target::Callee:
+            MacroAssembler::repatchPointer(relocation.location.dataLabelPtrAtOffset(0), CalleeBits::boxWasm(codeBlock.m_callees[calleeIndex].get()));
+            return;
+        case Relocation::Target::TierUpCount:
+            MacroAssembler::repatchPointer(relocation.location.dataLabelPtrAtOffset(0), &codeBlock.m_tierUpCounts[calleeIndex]);
+            return;
+        case Relocation::Target::SignatureIndex:
+            // Keep the relocation in terms of this process, in case the module is serialized again.
+            relocation.argument = SignatureInformation::get(info.usedSignatures[relocation.argument].get());
+            MacroAssembler::repatchPointer(relocation.location.dataLabelPtrAtOffset(0), bitwise_cast<void*>(static_cast<uintptr_t>(relocation.argument)));
+            return;
+        case Relocation::Target::Function: {
+            CodeLocationNearCall call = relocation.location.nearCallAtOffset(0, NearCallMode::Regular);
+            MacroAssembler::repatchNearCall(call, CodeLocationLabel(entrypointForFunctionIndexSpace(codeBlock, info, relocation.argument)));
+            codeBlock.m_wasmToWasmCallsites[calleeIndex].append({ call, relocation.argument });
+            return;
+        }
+        case Relocation::Target::GrowMemory:
+        case Relocation::Target::AtomicWait32:
+        case Relocation::Target::AtomicWait64:
+        case Relocation::Target::AtomicNotify:
+        case Relocation::Target::PopcountInt32:
+        case Relocation::Target::PopcountInt64:
+            MacroAssembler::repatchPointer(relocation.location.dataLabelPtrAtOffset(0), addressOfRelocationTarget(relocation.target));
+            return;
+        case Relocation::Target::ThrowException:
+        case Relocation::Target::ThrowStackOverflow:
+            MacroAssembler::repatchJump(relocation.location.jumpAtOffset(0), CodeLocationLabel(addressOfRelocationTarget(relocation.target)));
+            return;
+        case Relocation::Target::TriggerOMGTierUp:
+            MacroAssembler::repatchNearCall(relocation.location.nearCallAtOffset(0, NearCallMode::Regular), CodeLocationLabel(addressOfRelocationTarget(relocation.target)));
+            return;
+        }
+        RELEASE_ASSERT_NOT_REACHED();
+    }
+
+    bool createEmbedderEntrypoint(CodeBlock& codeBlock, const ModuleInformation& info, unsigned calleeIndex, CreateEmbedderWrapper& createEmbedderWrapper)
+    {
+        // Embedder entrypoints are not serialized; they are cheap to regenerate and embed process-specific values.
+        SignatureIndex signatureIndex = info.internalFunctionSignatureIndices[calleeIndex];
+        CompilationContext context;
+        Vector<UnlinkedWasmToWasmCall> calls;
+        std::unique_ptr<InternalFunction> function = createEmbedderWrapper(context, SignatureInformation::get(signatureIndex), &calls, info, codeBlock.mode(), calleeIndex);
+
+        LinkBuffer linkBuffer(*context.embedderEntrypointJIT, nullptr, JITCompilationCanFail);
+        if (UNLIKELY(linkBuffer.didFailToAllocate())) {
+            m_errorMessage = ASCIILiteral("Out of executable memory while loading a serialized WebAssembly module");
+            return false;
+        }
+        function->entrypoint.compilation = std::make_unique<B3::Compilation>(
+            FINALIZE_CODE(linkBuffer, ("Embedder->WebAssembly entrypoint[%i] %s", calleeIndex, SignatureInformation::get(signatureIndex).toString().ascii().data())),
+            WTFMove(context.embedderEntrypointByproducts));
+
+        Ref<Callee> callee = Callee::create(WTFMove(function->entrypoint));
+        MacroAssembler::repatchPointer(function->calleeMoveLocation, CalleeBits::boxWasm(callee.ptr()));
+        for (auto& call : calls) {
+            MacroAssembler::repatchNearCall(call.callLocation, CodeLocationLabel(entrypointForFunctionIndexSpace(codeBlock, info, call.functionIndexSpace)));
+            codeBlock.m_wasmToWasmCallsites[calleeIndex].append(call);
+        }
+        codeBlock.m_embedderCallees.set(calleeIndex, WTFMove(callee));
+        return true;
+    }
+
+    const uint8_t* m_cursor;
+    const uint8_t* m_end;
+    bool m_failed { false };
+    String m_errorMessage;
+};
+
+Expected<Vector<uint8_t>, String> serializeModule(Module& module)
+{
+    // Without rounding instructions B3 lowers ceil and floor to calls whose targets we do not record.
+    if (!MacroAssembler::supportsFloatingPointRounding())
+        return makeUnexpected(String(ASCIILiteral("WebAssembly modules can only be serialized on CPUs with floating point rounding instructions")));
+
+    ModuleEncoder encoder(module);
+    return encoder.encodeModule();
+}
+
+Module::ValidationResult deserializeModule(Context* context, const uint8_t* data, size_t size, CreateEmbedderWrapper&& createEmbedderWrapper, ThrowWasmException throwWasmException)
+{
+    ModuleDecoder decoder(data, size);
+    return decoder.decodeModule(context, createEmbedderWrapper, throwWasmException);
+}
+
+#if OS(UNIX)
+Expected<void, String> writeSerializedModuleToFile(Module& module, const char* path)
+{
+    auto serialized = serializeModule(module);
+    if (!serialized)
+        return makeUnexpected(WTFMove(serialized.error()));
+
+    // Write to a private file and rename it into place, so that concurrent readers either see
+    // the old file or the complete new one.
+    CString temporaryPath = String::format("%s.%d", path, getpid()).utf8();
+    FILE* file = fopen(temporaryPath.data(), "wb");
+    if (!file)
+        return makeUnexpected(WTF::makeString("could not open ", temporaryPath.data()));
+    bool succeeded = fwrite(serialized->data(), 1, serialized->size(), file) == serialized->size();
+    succeeded = !fclose(file) && succeeded;
+    if (!succeeded || rename(temporaryPath.data(), path)) {
+        unlink(temporaryPath.data());
+        return makeUnexpected(WTF::makeString("could not write ", path));
+    }
+    return { };
+}
+
+Module::ValidationResult readSerializedModuleFromFile(Context* context, const char* path, CreateEmbedderWrapper&& createEmbedderWrapper, ThrowWasmException throwWasmException)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd == -1)
+        return makeUnexpected(WTF::makeString("could not open ", path));
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) || fileStat.st_size <= 0) {
+        close(fd);
+        return makeUnexpected(WTF::makeString("could not read ", path));
+    }
+
+    size_t size = static_cast<size_t>(fileStat.st_size);
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+        return makeUnexpected(WTF::makeString("could not map ", path));
+
+    auto result = deserializeModule(context, static_cast<const uint8_t*>(data), size, WTFMove(createEmbedderWrapper), throwWasmException);
+    munmap(data, size);
+    return result;
+}
+#endif // OS(UNIX)
+
+} } // namespace JSC::Wasm
+
+#endif // ENABLE(WEBASSEMBLY)
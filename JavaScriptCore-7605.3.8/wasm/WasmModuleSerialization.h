@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2018 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#if ENABLE(WEBASSEMBLY)
+
+#include "WasmEmbedder.h"
+#include "WasmModule.h"
+#include <wtf/Expected.h>
+#include <wtf/Vector.h>
+#include <wtf/text/WTFString.h>
+
+namespace JSC { namespace Wasm {
+
+// A serialized module holds the module's bytes and the relocatable BBQ code of each of its
+// runnable CodeBlocks. It can only be loaded by the build of the engine that produced it.
+JS_EXPORT_PRIVATE Expected<Vector<uint8_t>, String> serializeModule(Module&);
+JS_EXPORT_PRIVATE Module::ValidationResult deserializeModule(Context*, const uint8_t*, size_t, CreateEmbedderWrapper&&, ThrowWasmException);
+
+#if OS(UNIX)
+JS_EXPORT_PRIVATE Expected<void, String> writeSerializedModuleToFile(Module&, const char* path);
+JS_EXPORT_PRIVATE Module::ValidationResult readSerializedModuleFromFile(Context*, const char* path, CreateEmbedderWrapper&&, ThrowWasmException);
+#endif
+
+} } // namespace JSC::Wasm
+
+#endif // ENABLE(WEBASSEMBLY)
@@ -39,8 +39,13 @@ struct NameSection : public ThreadSafeRefCounted<NameSection> {
 
 public:
     NameSection(const std::optional<CString> &hash)
-        : moduleHash(hash ? hash->length() : 3)
     {
+        setHash(hash);
+    }
+
+    void setHash(const std::optional<CString> &hash)
+    {
+        moduleHash.resize(hash ? hash->length() : 3);
         if (hash) {
             for (size_t i = 0; i < hash->length(); ++i)
                 moduleHash[i] = static_cast<uint8_t>(*(hash->data() + i));
@@ -264,6 +264,8 @@ ALWAYS_INLINE bool Parser<SuccessType>::parseResultType(Type& result)
     if (!isValidType(value))
         return false;
     result = static_cast<Type>(value);
+    if (result == V128 && !isSIMDEnabled())
+        return false;
     return true;
 }
 
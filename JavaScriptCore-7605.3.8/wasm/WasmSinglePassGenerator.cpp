@@ -0,0 +1,2229 @@
+/*
+ * Copyright (C) 2018 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "WasmSinglePassGenerator.h"
+
+#if ENABLE(WEBASSEMBLY)
+
+#include "CCallHelpers.h"
+#include "JSCInlines.h"
+#include "LinkBuffer.h"
+#include "WasmCallingConvention.h"
+#include "WasmContext.h"
+#include "WasmExceptionType.h"
+#include "WasmFunctionParser.h"
+#include "WasmInstance.h"
+#include "WasmMemory.h"
+#include "WasmThunks.h"
+#include <limits>
+#include <wtf/ListDump.h>
+
+namespace JSC { namespace Wasm {
+
+#if CPU(X86_64)
+
+namespace {
+namespace WasmSinglePassGeneratorInternal {
+static const bool verbose = false;
+
+// Operands are loaded from their frame slots into these registers for the duration of a single
+// operation, and the result is stored back to a frame slot before the next one. Integer division
+// and shifts need their operands in specific registers, which these are chosen to match.
+static const GPRReg leftGPR = X86Registers::eax;
+static const GPRReg rightGPR = X86Registers::ecx;
+static const GPRReg extraGPR = X86Registers::edx;
+static const GPRReg scratchGPR = GPRInfo::nonPreservedNonArgumentGPR;
+static const FPRReg leftFPR = FPRInfo::fpRegT0;
+static const FPRReg rightFPR = FPRInfo::fpRegT1;
+static const FPRReg scratchFPR = FPRInfo::fpRegT2;
+}
+}
+
+using namespace WasmSinglePassGeneratorInternal;
+
+class SinglePassGenerator {
+public:
+    class Value {
+    public:
+        enum class Kind : uint8_t {
+            None,
+            Constant,
+            Temporary,
+        };
+
+        constexpr Value()
+            : m_bits(0)
+            , m_slot(0)
+            , m_type(Void)
+            , m_kind(Kind::None)
+        {
+        }
+
+        static Value constant(Type type, uint64_t bits)
+        {
+            Value result;
+            result.m_kind = Kind::Constant;
+            result.m_type = type;
+            result.m_bits = bits;
+            return result;
+        }
+
+        static Value temporary(Type type, uint32_t slot)
+        {
+            Value result;
+            result.m_kind = Kind::Temporary;
+            result.m_type = type;
+            result.m_slot = slot;
+            return result;
+        }
+
+        // Reinterpretations and wrapping don't need any code: the low bits of the slot already hold the result.
+        Value withType(Type type) const
+        {
+            Value result = *this;
+            result.m_type = type;
+            if (type == I32 || type == F32)
+                result.m_bits = static_cast<uint32_t>(m_bits);
+            return result;
+        }
+
+        Kind kind() const { return m_kind; }
+        Type type() const { return m_type; }
+        bool isConstant() const { return m_kind == Kind::Constant; }
+        bool isTemporary() const { return m_kind == Kind::Temporary; }
+        uint32_t slot() const { ASSERT(isTemporary()); return m_slot; }
+        uint64_t bits() const { return m_bits; }
+
+        bool operator==(const Value& other) const
+        {
+            return m_kind == other.m_kind && m_type == other.m_type && m_slot == other.m_slot && m_bits == other.m_bits;
+        }
+        bool operator!=(const Value& other) const { return !(*this == other); }
+
+        void dump(PrintStream& out) const
+        {
+            switch (m_kind) {
+            case Kind::None:
+                out.print("<none>");
+                return;
+            case Kind::Constant:
+                out.print(makeString(m_type), "(", RawPointer(bitwise_cast<void*>(m_bits)), ")");
+                return;
+            case Kind::Temporary:
+                out.print(makeString(m_type), "@", m_slot);
+                return;
+            }
+        }
+
+    private:
+        uint64_t m_bits;
+        uint32_t m_slot;
+        Type m_type;
+        Kind m_kind;
+    };
+
+    class ControlData {
+    public:
+        ControlData(BlockType type, Type signature, uint32_t stackHeight)
+            : m_blockType(type)
+            , m_signature(signature)
+            , m_stackHeight(stackHeight)
+        {
+        }
+
+        ControlData()
+        {
+        }
+
+        void dump(PrintStream& out) const
+        {
+            switch (type()) {
+            case BlockType::If:
+                out.print("If:       ");
+                break;
+            case BlockType::Block:
+                out.print("Block:    ");
+                break;
+            case BlockType::Loop:
+                out.print("Loop:     ");
+                break;
+            case BlockType::TopLevel:
+                out.print("TopLevel: ");
+                break;
+            }
+            out.print("result slot ", m_stackHeight);
+        }
+
+        BlockType type() const { return m_blockType; }
+        Type signature() const { return m_signature; }
+        Type branchTargetSignature() const { return type() == BlockType::Loop ? Void : signature(); }
+
+    private:
+        friend class SinglePassGenerator;
+
+        void convertIfToBlock()
+        {
+            ASSERT(type() == BlockType::If);
+            m_blockType = BlockType::Block;
+        }
+
+        BlockType m_blockType { BlockType::Block };
+        Type m_signature { Void };
+        // The operand stack height when the block was entered, which is also the slot that receives its result.
+        uint32_t m_stackHeight { 0 };
+        MacroAssembler::Label m_loopHeader;
+        MacroAssembler::Jump m_elseJump;
+        MacroAssembler::JumpList m_branches;
+    };
+
+    typedef Value ExpressionType;
+    typedef ControlData ControlType;
+    typedef Vector<ExpressionType, 1> ExpressionList;
+    typedef FunctionParser<SinglePassGenerator>::ControlEntry ControlEntry;
+
+    static const ExpressionType emptyExpression;
+
+    typedef String ErrorType;
+    typedef Unexpected<ErrorType> UnexpectedResult;
+    typedef Expected<void, ErrorType> PartialResult;
+
+    template <typename ...Args>
+    NEVER_INLINE UnexpectedResult WARN_UNUSED_RETURN fail(Args... args) const
+    {
+        using namespace FailureHelper; // See ADL comment in WasmParser.h.
+        return UnexpectedResult(makeString(ASCIILiteral("WebAssembly.Module failed compiling: "), makeString(args)...));
+    }
+#define WASM_COMPILE_FAIL_IF(condition, ...) do { \
+        if (UNLIKELY(condition))                  \
+            return fail(__VA_ARGS__);             \
+    } while (0)
+
+    SinglePassGenerator(const ModuleInformation&, CCallHelpers&, InternalFunction*, Vector<UnlinkedWasmToWasmCall>&, MemoryMode, uint32_t functionIndex, TierUpCount*, ThrowWasmException);
+
+    bool isUnsupported() const { return m_unsupported; }
+
+    PartialResult WARN_UNUSED_RETURN addArguments(const Signature&);
+    PartialResult WARN_UNUSED_RETURN addLocal(Type, uint32_t);
+    ExpressionType addConstant(Type, uint64_t);
+
+    // Locals
+    PartialResult WARN_UNUSED_RETURN getLocal(uint32_t index, ExpressionType& result);
+    PartialResult WARN_UNUSED_RETURN setLocal(uint32_t index, ExpressionType value);
+
+    // Globals
+    PartialResult WARN_UNUSED_RETURN getGlobal(uint32_t index, ExpressionType& result);
+    PartialResult WARN_UNUSED_RETURN setGlobal(uint32_t index, ExpressionType value);
+
+    // Memory
+    PartialResult WARN_UNUSED_RETURN load(LoadOpType, ExpressionType pointer, ExpressionType& result, uint32_t offset);
+    PartialResult WARN_UNUSED_RETURN store(StoreOpType, ExpressionType pointer, ExpressionType value, uint32_t offset);
+    PartialResult WARN_UNUSED_RETURN addGrowMemory(ExpressionType delta, ExpressionType& result);
+    PartialResult WARN_UNUSED_RETURN addCurrentMemory(ExpressionType& result);
+
+    // Basic operators
+    template<OpType op>
+    PartialResult WARN_UNUSED_RETURN addOp(ExpressionType arg, ExpressionType& result) { return addUnaryOp(op, arg, result); }
+    template<OpType op>
+    PartialResult WARN_UNUSED_RETURN addOp(ExpressionType left, ExpressionType right, ExpressionType& result) { return addBinaryOp(op, left, right, result); }
+    PartialResult WARN_UNUSED_RETURN addSelect(ExpressionType condition, ExpressionType nonZero, ExpressionType zero, ExpressionType& result);
+
+    // SIMD and atomics are left to BBQ.
+    ExpressionType addSIMDConstant(B3::v128_t) { m_unsupported = true; return emptyExpression; }
+    PartialResult WARN_UNUSED_RETURN addSIMDLoad(ExpressionType, ExpressionType&, uint32_t) { return unsupported(); }
+    PartialResult WARN_UNUSED_RETURN addSIMDStore(ExpressionType, ExpressionType, uint32_t) { return unsupported(); }
+    PartialResult WARN_UNUSED_RETURN addSIMDSplat(B3::SIMDLane, ExpressionType, ExpressionType&) { return unsupported(); }
+    PartialResult WARN_UNUSED_RETURN addSIMDExtractLane(B3::SIMDLane, uint8_t, ExpressionType, ExpressionType&) { return unsupported(); }
+    PartialResult WARN_UNUSED_RETURN addSIMDReplaceLane(B3::SIMDLane, uint8_t, ExpressionType, ExpressionType, ExpressionType&) { return unsupported(); }
+    PartialResult WARN_UNUSED_RETURN addSIMDUnary(SIMDOpType, ExpressionType, ExpressionType&) { return unsupported(); }
+    PartialResult WARN_UNUSED_RETURN addSIMDBinary(SIMDOpType, ExpressionType, ExpressionType, ExpressionType&) { return unsupported(); }
+    PartialResult WARN_UNUSED_RETURN atomicLoad(AtomicOpType, ExpressionType, ExpressionType&, uint32_t) { return unsupported(); }
+    PartialResult WARN_UNUSED_RETURN atomicStore(AtomicOpType, ExpressionType, ExpressionType, uint32_t) { return unsupported(); }
+    PartialResult WARN_UNUSED_RETURN atomicBinaryRMW(AtomicOpType, ExpressionType, ExpressionType, ExpressionType&, uint32_t) { return unsupported(); }
+    PartialResult WARN_UNUSED_RETURN atomicCompareExchange(AtomicOpType, ExpressionType, ExpressionType, ExpressionType, ExpressionType&, uint32_t) { return unsupported(); }
+    PartialResult WARN_UNUSED_RETURN atomicWait(AtomicOpType, ExpressionType, ExpressionType, ExpressionType, ExpressionType&, uint32_t) { return unsupported(); }
+    PartialResult WARN_UNUSED_RETURN atomicNotify(AtomicOpType, ExpressionType, ExpressionType, ExpressionType&, uint32_t) { return unsupported(); }
+    PartialResult WARN_UNUSED_RETURN atomicFence() { return unsupported(); }
+
+    // Control flow
+    ControlData WARN_UNUSED_RETURN addTopLevel(Type signature);
+    ControlData WARN_UNUSED_RETURN addBlock(Type signature);
+    ControlData WARN_UNUSED_RETURN addLoop(Type signature);
+    PartialResult WARN_UNUSED_RETURN addIf(ExpressionType condition, Type signature, ControlData& result);
+    PartialResult WARN_UNUSED_RETURN addElse(ControlData&, const ExpressionList&);
+    PartialResult WARN_UNUSED_RETURN addElseToUnreachable(ControlData&);
+
+    PartialResult WARN_UNUSED_RETURN addReturn(const ControlData&, const ExpressionList& returnValues);
+    PartialResult WARN_UNUSED_RETURN addBranch(ControlData&, ExpressionType condition, const ExpressionList& returnValues);
+    PartialResult WARN_UNUSED_RETURN addSwitch(ExpressionType condition, const Vector<ControlData*>& targets, ControlData& defaultTargets, const ExpressionList& expressionStack);
+    PartialResult WARN_UNUSED_RETURN endBlock(ControlEntry&, ExpressionList& expressionStack);
+    PartialResult WARN_UNUSED_RETURN addEndToUnreachable(ControlEntry&);
+
+    // Calls
+    PartialResult WARN_UNUSED_RETURN addCall(uint32_t calleeIndex, const Signature&, Vector<ExpressionType>& args, ExpressionType& result);
+    PartialResult WARN_UNUSED_RETURN addCallIndirect(const Signature&, Vector<ExpressionType>& args, ExpressionType& result);
+    PartialResult WARN_UNUSED_RETURN addUnreachable();
+
+    void dump(const Vector<ControlEntry>& controlStack, const ExpressionList* expressionStack);
+    void setParser(FunctionParser<SinglePassGenerator>*) { }
+
+    void finalize();
+
+private:
+    enum class RestoreCachedStackLimit { No, Yes };
+
+    PartialResult WARN_UNUSED_RETURN unsupported()
+    {
+        m_unsupported = true;
+        return fail("unsupported by the single-pass tier");
+    }
+
+    static bool isSupportedType(Type type) { return type == Void || type == I32 || type == I64 || type == F32 || type == F64; }
+    static bool isFloatingPoint(Type type) { return type == F32 || type == F64; }
+    static bool isSupportedSignature(const Signature&);
+
+    static CCallHelpers::Address addressOfSlot(uint32_t slot)
+    {
+        return CCallHelpers::Address(GPRInfo::callFrameRegister, -static_cast<int32_t>((slot + 1) * sizeof(Register)));
+    }
+    static uint32_t slotForLocal(uint32_t index) { return index + 1; }
+
+    ExpressionType allocateTemporary(Type);
+    void consume(ExpressionType);
+
+    void materialize(ExpressionType, GPRReg);
+    void materialize(ExpressionType, FPRReg);
+    void storeResult(GPRReg, ExpressionType result);
+    void storeResult(FPRReg, ExpressionType result);
+    void emitCopy(ExpressionType source, uint32_t slot);
+    void loadInstance(GPRReg);
+
+    void addExceptionCheck(ExceptionType, MacroAssembler::Jump);
+    void emitTierUpCheck(uint32_t decrementCount);
+    void restoreWebAssemblyGlobalState(RestoreCachedStackLimit);
+    void emitCCall(void* function);
+
+    static uint32_t sizeOfLoadOp(LoadOpType);
+    static uint32_t sizeOfStoreOp(StoreOpType);
+    CCallHelpers::BaseIndex emitCheckAndPreparePointer(ExpressionType pointer, uint32_t offset, uint32_t sizeOfOperation, bool isLoad);
+
+    PartialResult WARN_UNUSED_RETURN addUnaryOp(OpType, ExpressionType arg, ExpressionType& result);
+    PartialResult WARN_UNUSED_RETURN addBinaryOp(OpType, ExpressionType left, ExpressionType right, ExpressionType& result);
+    PartialResult WARN_UNUSED_RETURN addIntegerDivision(OpType, ExpressionType left, ExpressionType right, ExpressionType& result);
+    PartialResult WARN_UNUSED_RETURN addFloatingPointMinMax(OpType, ExpressionType left, ExpressionType right, ExpressionType& result);
+    PartialResult WARN_UNUSED_RETURN addTruncation(OpType, ExpressionType arg, ExpressionType& result);
+
+    void emitCopyForBranch(ControlData& target, const ExpressionList&);
+    void emitJumpTo(ControlData& target);
+    template<typename Functor>
+    void emitSwitchTree(GPRReg index, unsigned begin, unsigned end, const Functor& jumpToCase);
+    void emitReturn(ExpressionType);
+    void emitCallArguments(const Signature&, const Vector<ExpressionType>& args);
+    void storeCallResult(const Signature&, ExpressionType& result);
+
+    const ModuleInformation& m_info;
+    CCallHelpers& m_jit;
+    InternalFunction* m_compilation;
+    Vector<UnlinkedWasmToWasmCall>& m_unlinkedWasmToWasmCalls;
+    MemoryMode m_mode;
+    uint32_t m_functionIndex;
+    TierUpCount* m_tierUp;
+
+    GPRReg m_memoryBaseGPR { InvalidGPRReg };
+    GPRReg m_memorySizeGPR { InvalidGPRReg };
+    GPRReg m_indexingMaskGPR { InvalidGPRReg };
+    GPRReg m_wasmContextInstanceGPR { InvalidGPRReg };
+
+    const Signature* m_signature { nullptr };
+    Vector<Type> m_localTypes;
+    // Slot 0 holds the instance, followed by the locals and then the operand stack.
+    uint32_t m_stackHeight { 0 };
+    uint32_t m_maxStackHeight { 0 };
+    unsigned m_callArgumentAreaSize { 0 };
+    uint32_t m_maxNumJSCallArguments { 0 };
+    bool m_makesCalls { false };
+    bool m_unsupported { false };
+
+    MacroAssembler::Jump m_frameSetupJump;
+    MacroAssembler::Label m_frameSetupDone;
+    Vector<std::pair<MacroAssembler::Jump, MacroAssembler::Label>> m_tierUpChecks;
+    Vector<std::pair<ExceptionType, MacroAssembler::Jump>> m_exceptionChecks;
+};
+
+const SinglePassGenerator::ExpressionType SinglePassGenerator::emptyExpression;
+
+SinglePassGenerator::SinglePassGenerator(const ModuleInformation& info, CCallHelpers& jit, InternalFunction* compilation, Vector<UnlinkedWasmToWasmCall>& unlinkedWasmToWasmCalls, MemoryMode mode, uint32_t functionIndex, TierUpCount* tierUp, ThrowWasmException throwWasmException)
+    : m_info(info)
+    , m_jit(jit)
+    , m_compilation(compilation)
+    , m_unlinkedWasmToWasmCalls(unlinkedWasmToWasmCalls)
+    , m_mode(mode)
+    , m_functionIndex(functionIndex)
+    , m_tierUp(tierUp)
+{
+    const PinnedRegisterInfo& pinnedRegs = PinnedRegisterInfo::get();
+    m_memoryBaseGPR = pinnedRegs.baseMemoryPointer;
+    if (!Context::useFastTLS())
+        m_wasmContextInstanceGPR = pinnedRegs.wasmContextInstancePointer;
+    if (mode != MemoryMode::Signaling) {
+        ASSERT(!pinnedRegs.sizeRegisters[0].sizeOffset);
+        m_indexingMaskGPR = pinnedRegs.indexingMask;
+        m_memorySizeGPR = pinnedRegs.sizeRegisters[0].sizeRegister;
+    }
+
+    if (throwWasmException)
+        Thunks::singleton().setThrowWasmException(throwWasmException);
+
+    if (info.memory && mode == MemoryMode::Signaling) {
+        // FaultSignalHandler needs the thunk to exist so that it can jump to it.
+        if (UNLIKELY(!Thunks::singleton().stub(throwExceptionFromWasmThunkGenerator)))
+            CRASH();
+    }
+}
+
+bool SinglePassGenerator::isSupportedSignature(const Signature& signature)
+{
+    if (!isSupportedType(signature.returnType()))
+        return false;
+    for (unsigned i = 0; i < signature.argumentCount(); ++i) {
+        if (!isSupportedType(signature.argument(i)))
+            return false;
+    }
+    return true;
+}
+
+auto SinglePassGenerator::addArguments(const Signature& signature) -> PartialResult
+{
+    if (!isSupportedSignature(signature))
+        return unsupported();
+
+    m_signature = &signature;
+    for (unsigned i = 0; i < signature.argumentCount(); ++i)
+        m_localTypes.append(signature.argument(i));
+    return { };
+}
+
+auto SinglePassGenerator::addLocal(Type type, uint32_t count) -> PartialResult
+{
+    if (!isSupportedType(type) || m_localTypes.size() + static_cast<uint64_t>(count) > maxFunctionLocals)
+        return unsupported();
+
+    WASM_COMPILE_FAIL_IF(!m_localTypes.tryReserveCapacity(m_localTypes.size() + count), "can't allocate memory for ", m_localTypes.size() + count, " locals");
+    for (uint32_t i = 0; i < count; ++i)
+        m_localTypes.uncheckedAppend(type);
+    return { };
+}
+
+auto SinglePassGenerator::addConstant(Type type, uint64_t value) -> ExpressionType
+{
+    return Value::constant(type, value);
+}
+
+auto SinglePassGenerator::allocateTemporary(Type type) -> ExpressionType
+{
+    ExpressionType result = Value::temporary(type, m_stackHeight++);
+    m_maxStackHeight = std::max(m_maxStackHeight, m_stackHeight);
+    return result;
+}
+
+void SinglePassGenerator::consume(ExpressionType value)
+{
+    // Operands are always popped off the top of the stack, so the lowest temporary consumed is the new height.
+    if (value.isTemporary())
+        m_stackHeight = std::min(m_stackHeight, value.slot());
+}
+
+void SinglePassGenerator::materialize(ExpressionType value, GPRReg gpr)
+{
+    bool is32Bit = value.type() == I32 || value.type() == F32;
+    if (value.isTemporary()) {
+        if (is32Bit)
+            m_jit.load32(addressOfSlot(value.slot()), gpr);
+        else
+            m_jit.load64(addressOfSlot(value.slot()), gpr);
+        return;
+    }
+    if (is32Bit)
+        m_jit.move(CCallHelpers::TrustedImm32(static_cast<int32_t>(value.bits())), gpr);
+    else
+        m_jit.move(CCallHelpers::TrustedImm64(value.bits()), gpr);
+}
+
+void SinglePassGenerator::materialize(ExpressionType value, FPRReg fpr)
+{
+    ASSERT(isFloatingPoint(value.type()));
+    if (value.isTemporary()) {
+        if (value.type() == F32)
+            m_jit.loadFloat(addressOfSlot(value.slot()), fpr);
+        else
+            m_jit.loadDouble(addressOfSlot(value.slot()), fpr);
+        return;
+    }
+    materialize(value, scratchGPR);
+    if (value.type() == F32)
+        m_jit.move32ToFloat(scratchGPR, fpr);
+    else
+        m_jit.move64ToDouble(scratchGPR, fpr);
+}
+
+void SinglePassGenerator::storeResult(GPRReg gpr, ExpressionType result)
+{
+    if (result.type() == I32 || result.type() == F32)
+        m_jit.store32(gpr, addressOfSlot(result.slot()));
+    else
+        m_jit.store64(gpr, addressOfSlot(result.slot()));
+}
+
+void SinglePassGenerator::storeResult(FPRReg fpr, ExpressionType result)
+{
+    if (result.type() == F32)
+        m_jit.storeFloat(fpr, addressOfSlot(result.slot()));
+    else
+        m_jit.storeDouble(fpr, addressOfSlot(result.slot()));
+}
+
+void SinglePassGenerator::emitCopy(ExpressionType source, uint32_t slot)
+{
+    if (source.isTemporary()) {
+        if (source.slot() == slot)
+            return;
+        m_jit.load64(addressOfSlot(source.slot()), leftGPR);
+    } else
+        m_jit.move(CCallHelpers::TrustedImm64(source.bits()), leftGPR);
+    m_jit.store64(leftGPR, addressOfSlot(slot));
+}
+
+void SinglePassGenerator::loadInstance(GPRReg gpr)
+{
+    m_jit.loadPtr(addressOfSlot(0), gpr);
+}
+
+void SinglePassGenerator::addExceptionCheck(ExceptionType type, MacroAssembler::Jump jump)
+{
+    m_exceptionChecks.append({ type, jump });
+}
+
+void SinglePassGenerator::emitTierUpCheck(uint32_t decrementCount)
+{
+    if (!m_tierUp)
+        return;
+
+    m_jit.move(CCallHelpers::TrustedImmPtr(m_tierUp), scratchGPR);
+    m_jit.load32(CCallHelpers::Address(scratchGPR), leftGPR);
+    m_jit.move(leftGPR, rightGPR);
+    m_jit.sub32(CCallHelpers::TrustedImm32(decrementCount), rightGPR);
+    m_jit.store32(rightGPR, CCallHelpers::Address(scratchGPR));
+    MacroAssembler::Jump tierUp = m_jit.branch32(MacroAssembler::Above, rightGPR, leftGPR);
+    m_tierUpChecks.append({ tierUp, m_jit.label() });
+}
+
+void SinglePassGenerator::restoreWebAssemblyGlobalState(RestoreCachedStackLimit restoreCachedStackLimit)
+{
+    GPRReg instance = leftGPR;
+    loadInstance(instance);
+    if (Context::useFastTLS())
+        m_jit.storeWasmContextInstance(instance);
+    else
+        m_jit.move(instance, m_wasmContextInstanceGPR);
+
+    if (restoreCachedStackLimit == RestoreCachedStackLimit::Yes) {
+        // The Instance caches the stack limit, but also knows where its canonical location is.
+        m_jit.loadPtr(CCallHelpers::Address(instance, Instance::offsetOfPointerToActualStackLimit()), scratchGPR);
+        m_jit.loadPtr(CCallHelpers::Address(scratchGPR), scratchGPR);
+        m_jit.storePtr(scratchGPR, CCallHelpers::Address(instance, Instance::offsetOfCachedStackLimit()));
+    }
+
+    if (!!m_info.memory) {
+        const PinnedRegisterInfo& pinnedRegs = PinnedRegisterInfo::get();
+        const auto& sizeRegs = pinnedRegs.sizeRegisters;
+        GPRReg baseMemory = pinnedRegs.baseMemoryPointer;
+        ASSERT(sizeRegs.size() == 1);
+        ASSERT(!sizeRegs[0].sizeOffset);
+        m_jit.loadPtr(CCallHelpers::Address(instance, Instance::offsetOfMemory()), baseMemory);
+        m_jit.loadPtr(CCallHelpers::Address(baseMemory, Memory::offsetOfSize()), sizeRegs[0].sizeRegister);
+        m_jit.loadPtr(CCallHelpers::Address(baseMemory, Memory::offsetOfIndexingMask()), pinnedRegs.indexingMask);
+        m_jit.loadPtr(CCallHelpers::Address(baseMemory, Memory::offsetOfMemory()), baseMemory);
+    }
+}
+
+void SinglePassGenerator::emitCCall(void* function)
+{
+    m_jit.move(CCallHelpers::TrustedImmPtr(function), scratchGPR);
+    m_jit.call(scratchGPR);
+}
+
+auto SinglePassGenerator::getLocal(uint32_t index, ExpressionType& result) -> PartialResult
+{
+    ASSERT(index < m_localTypes.size());
+    result = allocateTemporary(m_localTypes[index]);
+    m_jit.load64(addressOfSlot(slotForLocal(index)), leftGPR);
+    m_jit.store64(leftGPR, addressOfSlot(result.slot()));
+    return { };
+}
+
+auto SinglePassGenerator::setLocal(uint32_t index, ExpressionType value) -> PartialResult
+{
+    ASSERT(index < m_localTypes.size());
+    // tee_local leaves the value on the operand stack, and we can't tell it apart from set_local, so the
+    // value is never consumed here. At worst this leaves one slot unused until the enclosing block ends.
+    emitCopy(value, slotForLocal(index));
+    return { };
+}
+
+auto SinglePassGenerator::getGlobal(uint32_t index, ExpressionType& result) -> PartialResult
+{
+    Type type = m_info.globals[index].type;
+    if (!isSupportedType(type))
+        return unsupported();
+
+    result = allocateTemporary(type);
+    loadInstance(scratchGPR);
+    m_jit.loadPtr(CCallHelpers::Address(scratchGPR, Instance::offsetOfGlobals()), scratchGPR);
+    m_jit.load64(CCallHelpers::Address(scratchGPR, index * sizeof(Register)), leftGPR);
+    storeResult(leftGPR, result);
+    return { };
+}
+
+auto SinglePassGenerator::setGlobal(uint32_t index, ExpressionType value) -> PartialResult
+{
+    Type type = m_info.globals[index].type;
+    if (!isSupportedType(type))
+        return unsupported();
+
+    materialize(value, leftGPR);
+    consume(value);
+    loadInstance(scratchGPR);
+    m_jit.loadPtr(CCallHelpers::Address(scratchGPR, Instance::offsetOfGlobals()), scratchGPR);
+    if (type == I32 || type == F32)
+        m_jit.store32(leftGPR, CCallHelpers::Address(scratchGPR, index * sizeof(Register)));
+    else
+        m_jit.store64(leftGPR, CCallHelpers::Address(scratchGPR, index * sizeof(Register)));
+    return { };
+}
+
+uint32_t SinglePassGenerator::sizeOfLoadOp(LoadOpType op)
+{
+    switch (op) {
+    case LoadOpType::I32Load8S:
+    case LoadOpType::I32Load8U:
+    case LoadOpType::I64Load8S:
+    case LoadOpType::I64Load8U:
+        return 1;
+    case LoadOpType::I32Load16S:
+    case LoadOpType::I64Load16S:
+    case LoadOpType::I32Load16U:
+    case LoadOpType::I64Load16U:
+        return 2;
+    case LoadOpType::I32Load:
+    case LoadOpType::I64Load32S:
+    case LoadOpType::I64Load32U:
+    case LoadOpType::F32Load:
+        return 4;
+    case LoadOpType::I64Load:
+    case LoadOpType::F64Load:
+        return 8;
+    }
+    RELEASE_ASSERT_NOT_REACHED();
+}
+
+uint32_t SinglePassGenerator::sizeOfStoreOp(StoreOpType op)
+{
+    switch (op) {
+    case StoreOpType::I32Store8:
+    case StoreOpType::I64Store8:
+        return 1;
+    case StoreOpType::I32Store16:
+    case StoreOpType::I64Store16:
+        return 2;
+    case StoreOpType::I32Store:
+    case StoreOpType::I64Store32:
+    case StoreOpType::F32Store:
+        return 4;
+    case StoreOpType::I64Store:
+    case StoreOpType::F64Store:
+        return 8;
+    }
+    RELEASE_ASSERT_NOT_REACHED();
+}
+
+// Leaves the zero extended pointer in leftGPR. This mirrors the checks B3 emits for WasmBoundsCheck.
+CCallHelpers::BaseIndex SinglePassGenerator::emitCheckAndPreparePointer(ExpressionType pointer, uint32_t offset, uint32_t sizeOfOperation, bool isLoad)
+{
+    materialize(pointer, leftGPR);
+    m_jit.zeroExtend32ToPtr(leftGPR, leftGPR);
+
+    uint64_t lastByteOffset = static_cast<uint64_t>(offset) + sizeOfOperation - 1;
+    switch (m_mode) {
+    case MemoryMode::BoundsChecking:
+        m_jit.move(CCallHelpers::TrustedImm64(lastByteOffset), scratchGPR);
+        m_jit.add64(leftGPR, scratchGPR);
+        addExceptionCheck(ExceptionType::OutOfBoundsMemoryAccess, m_jit.branch64(MacroAssembler::AboveOrEqual, scratchGPR, m_memorySizeGPR));
+        if (isLoad && Options::enableSpectreMitigations())
+            m_jit.and32(m_indexingMaskGPR, leftGPR);
+        break;
+    case MemoryMode::Signaling:
+        // We've virtually mapped 4GiB+redzone for this memory. Only the user-allocated pages are addressable,
+        // contiguously in range [0, current], and everything above is mapped PROT_NONE. We don't need to
+        // emit a bounds check if the offset can't take us past the redzone.
+        if (offset >= Memory::fastMappedRedzoneBytes()) {
+            uint64_t maximum = m_info.memory.maximum() ? m_info.memory.maximum().bytes() : std::numeric_limits<uint32_t>::max();
+            m_jit.move(CCallHelpers::TrustedImm64(lastByteOffset), scratchGPR);
+            m_jit.add64(leftGPR, scratchGPR);
+            m_jit.move(CCallHelpers::TrustedImm64(maximum), extraGPR);
+            addExceptionCheck(ExceptionType::OutOfBoundsMemoryAccess, m_jit.branch64(MacroAssembler::AboveOrEqual, scratchGPR, extraGPR));
+        }
+        break;
+    }
+
+    // Memory accesses in WebAssembly have unsigned 32-bit offsets, whereas they have signed 32-bit offsets in the MacroAssembler.
+    if (static_cast<uint64_t>(offset) > static_cast<uint64_t>(std::numeric_limits<int32_t>::max())) {
+        m_jit.move(CCallHelpers::TrustedImm64(offset), scratchGPR);
+        m_jit.add64(scratchGPR, leftGPR);
+        offset = 0;
+    }
+    return CCallHelpers::BaseIndex(m_memoryBaseGPR, leftGPR, CCallHelpers::TimesOne, offset);
+}
+
+auto SinglePassGenerator::load(LoadOpType op, ExpressionType pointer, ExpressionType& result, uint32_t offset) -> PartialResult
+{
+    ASSERT(pointer.type() == I32);
+    consume(pointer);
+
+    Type resultType;
+    switch (op) {
+    case LoadOpType::I32Load8S:
+    case LoadOpType::I32Load8U:
+    case LoadOpType::I32Load16S:
+    case LoadOpType::I32Load16U:
+    case LoadOpType::I32Load:
+        resultType = I32;
+        break;
+    case LoadOpType::I64Load8S:
+    case LoadOpType::I64Load8U:
+    case LoadOpType::I64Load16S:
+    case LoadOpType::I64Load16U:
+    case LoadOpType::I64Load32S:
+    case LoadOpType::I64Load32U:
+    case LoadOpType::I64Load:
+        resultType = I64;
+        break;
+    case LoadOpType::F32Load:
+        resultType = F32;
+        break;
+    case LoadOpType::F64Load:
+        resultType = F64;
+        break;
+    }
+
+    if (UNLIKELY(sumOverflows<uint32_t>(offset, sizeOfLoadOp(op)))) {
+        // An access this far out of bounds still validates, so it has to trap when it runs.
+        addExceptionCheck(ExceptionType::OutOfBoundsMemoryAccess, m_jit.jump());
+        result = addConstant(resultType, 0);
+        return { };
+    }
+
+    CCallHelpers::BaseIndex address = emitCheckAndPreparePointer(pointer, offset, sizeOfLoadOp(op), true);
+    result = allocateTemporary(resultType);
+
+    // Floating point values are loaded as their bit patterns.
+    switch (op) {
+    case LoadOpType::I32Load8S:
+        m_jit.load8SignedExtendTo32(address, leftGPR);
+        break;
+    case LoadOpType::I64Load8S:
+        m_jit.load8SignedExtendTo32(address, leftGPR);
+        m_jit.signExtend32ToPtr(leftGPR, leftGPR);
+        break;
+    case LoadOpType::I32Load8U:
+    case LoadOpType::I64Load8U:
+        m_jit.load8(address, leftGPR);
+        break;
+    case LoadOpType::I32Load16S:
+        m_jit.load16SignedExtendTo32(address, leftGPR);
+        break;
+    case LoadOpType::I64Load16S:
+        m_jit.load16SignedExtendTo32(address, leftGPR);
+        m_jit.signExtend32ToPtr(leftGPR, leftGPR);
+        break;
+    case LoadOpType::I32Load16U:
+    case LoadOpType::I64Load16U:
+        m_jit.load16(address, leftGPR);
+        break;
+    case LoadOpType::I32Load:
+    case LoadOpType::I64Load32U:
+    case LoadOpType::F32Load:
+        m_jit.load32(address, leftGPR);
+        break;
+    case LoadOpType::I64Load32S:
+        m_jit.load32(address, leftGPR);
+        m_jit.signExtend32ToPtr(leftGPR, leftGPR);
+        break;
+    case LoadOpType::I64Load:
+    case LoadOpType::F64Load:
+        m_jit.load64(address, leftGPR);
+        break;
+    }
+    storeResult(leftGPR, result);
+    return { };
+}
+
+auto SinglePassGenerator::store(StoreOpType op, ExpressionType pointer, ExpressionType value, uint32_t offset) -> PartialResult
+{
+    ASSERT(pointer.type() == I32);
+    consume(value);
+    consume(pointer);
+
+    if (UNLIKELY(sumOverflows<uint32_t>(offset, sizeOfStoreOp(op)))) {
+        // An access this far out of bounds still validates, so it has to trap when it runs.
+        addExceptionCheck(ExceptionType::OutOfBoundsMemoryAccess, m_jit.jump());
+        return { };
+    }
+
+    materialize(value, rightGPR);
+    CCallHelpers::BaseIndex address = emitCheckAndPreparePointer(pointer, offset, sizeOfStoreOp(op), false);
+
+    switch (op) {
+    case StoreOpType::I32Store8:
+    case StoreOpType::I64Store8:
+        m_jit.store8(rightGPR, address);
+        break;
+    case StoreOpType::I32Store16:
+    case StoreOpType::I64Store16:
+        m_jit.store16(rightGPR, address);
+        break;
+    case StoreOpType::I32Store:
+    case StoreOpType::I64Store32:
+    case StoreOpType::F32Store:
+        m_jit.store32(rightGPR, address);
+        break;
+    case StoreOpType::I64Store:
+    case StoreOpType::F64Store:
+        m_jit.store64(rightGPR, address);
+        break;
+    }
+    return { };
+}
+
+auto SinglePassGenerator::addGrowMemory(ExpressionType delta, ExpressionType& result) -> PartialResult
+{
+    materialize(delta, GPRInfo::argumentGPR2);
+    consume(delta);
+    result = allocateTemporary(I32);
+
+    m_jit.move(GPRInfo::callFrameRegister, GPRInfo::argumentGPR0);
+    loadInstance(GPRInfo::argumentGPR1);
+    emitCCall(addressOfRelocationTarget(Relocation::Target::GrowMemory));
+    storeResult(GPRInfo::returnValueGPR, result);
+
+    restoreWebAssemblyGlobalState(RestoreCachedStackLimit::No);
+    return { };
+}
+
+auto SinglePassGenerator::addCurrentMemory(ExpressionType& result) -> PartialResult
+{
+    static_assert(sizeof(decltype(static_cast<Memory*>(nullptr)->size())) == sizeof(uint64_t), "codegen relies on this size");
+
+    result = allocateTemporary(I32);
+    loadInstance(scratchGPR);
+    m_jit.loadPtr(CCallHelpers::Address(scratchGPR, Instance::offsetOfMemory()), scratchGPR);
+    m_jit.load64(CCallHelpers::Address(scratchGPR, Memory::offsetOfSize()), leftGPR);
+    constexpr uint32_t shiftValue = 16;
+    static_assert(PageCount::pageSize == 1ull << shiftValue, "This must hold for the code below to be correct.");
+    m_jit.urshift64(CCallHelpers::TrustedImm32(shiftValue), leftGPR);
+    storeResult(leftGPR, result);
+    return { };
+}
+
+auto SinglePassGenerator::addSelect(ExpressionType condition, ExpressionType nonZero, ExpressionType zero, ExpressionType& result) -> PartialResult
+{
+    // Both operands have the same type, so we can select between their raw bits.
+    materialize(nonZero, leftGPR);
+    materialize(zero, rightGPR);
+    materialize(condition, extraGPR);
+    consume(condition);
+    consume(zero);
+    consume(nonZero);
+    result = allocateTemporary(nonZero.type());
+    m_jit.moveConditionallyTest32(MacroAssembler::Zero, extraGPR, CCallHelpers::TrustedImm32(-1), rightGPR, leftGPR);
+    m_jit.store64(leftGPR, addressOfSlot(result.slot()));
+    return { };
+}
+
+auto SinglePassGenerator::addUnaryOp(OpType op, ExpressionType arg, ExpressionType& result) -> PartialResult
+{
+    switch (op) {
+    case OpType::I32WrapI64:
+    case OpType::I32ReinterpretF32:
+        result = arg.withType(I32);
+        return { };
+    case OpType::I64ReinterpretF64:
+        result = arg.withType(I64);
+        return { };
+    case OpType::F32ReinterpretI32:
+        result = arg.withType(F32);
+        return { };
+    case OpType::F64ReinterpretI64:
+        result = arg.withType(F64);
+        return { };
+
+    case OpType::I32TruncSF32:
+    case OpType::I32TruncSF64:
+    case OpType::I32TruncUF32:
+    case OpType::I32TruncUF64:
+    case OpType::I64TruncSF32:
+    case OpType::I64TruncSF64:
+    case OpType::I64TruncUF32:
+    case OpType::I64TruncUF64:
+        return addTruncation(op, arg, result);
+
+    case OpType::F32Ceil:
+    case OpType::F32Floor:
+    case OpType::F32Trunc:
+    case OpType::F32Nearest:
+    case OpType::F64Ceil:
+    case OpType::F64Floor:
+    case OpType::F64Trunc:
+    case OpType::F64Nearest:
+        if (!MacroAssembler::supportsFloatingPointRounding())
+            return unsupported();
+        break;
+
+    default:
+        break;
+    }
+
+    // Operations on integers and on the bits of floating point values.
+    switch (op) {
+    case OpType::I32Clz:
+    case OpType::I32Ctz:
+    case OpType::I32Eqz:
+    case OpType::I32Popcnt:
+    case OpType::I64Clz:
+    case OpType::I64Ctz:
+    case OpType::I64Eqz:
+    case OpType::I64Popcnt:
+    case OpType::I64ExtendSI32:
+    case OpType::I64ExtendUI32:
+    case OpType::F32Abs:
+    case OpType::F32Neg:
+    case OpType::F64Abs:
+    case OpType::F64Neg: {
+        materialize(arg, leftGPR);
+        consume(arg);
+        switch (op) {
+        case OpType::I32Clz:
+            result = allocateTemporary(I32);
+            m_jit.countLeadingZeros32(leftGPR, leftGPR);
+            break;
+        case OpType::I32Ctz:
+            result = allocateTemporary(I32);
+            m_jit.countTrailingZeros32(leftGPR, leftGPR);
+            break;
+        case OpType::I32Eqz:
+            result = allocateTemporary(I32);
+            m_jit.compare32(MacroAssembler::Equal, leftGPR, CCallHelpers::TrustedImm32(0), leftGPR);
+            break;
+        case OpType::I32Popcnt:
+            result = allocateTemporary(I32);
+            if (MacroAssembler::supportsCountPopulation()) {
+                m_jit.countPopulation32(leftGPR, leftGPR);
+                break;
+            }
+            m_jit.move(leftGPR, GPRInfo::argumentGPR0);
+            emitCCall(addressOfRelocationTarget(Relocation::Target::PopcountInt32));
+            m_jit.move(GPRInfo::returnValueGPR, leftGPR);
+            break;
+        case OpType::I64Clz:
+            result = allocateTemporary(I64);
+            m_jit.countLeadingZeros64(leftGPR, leftGPR);
+            break;
+        case OpType::I64Ctz:
+            result = allocateTemporary(I64);
+            m_jit.countTrailingZeros64(leftGPR, leftGPR);
+            break;
+        case OpType::I64Eqz:
+            result = allocateTemporary(I32);
+            m_jit.compare64(MacroAssembler::Equal, leftGPR, CCallHelpers::TrustedImm32(0), leftGPR);
+            break;
+        case OpType::I64Popcnt:
+            result = allocateTemporary(I64);
+            if (MacroAssembler::supportsCountPopulation()) {
+                m_jit.countPopulation64(leftGPR, leftGPR);
+                break;
+            }
+            m_jit.move(leftGPR, GPRInfo::argumentGPR0);
+            emitCCall(addressOfRelocationTarget(Relocation::Target::PopcountInt64));
+            m_jit.move(GPRInfo::returnValueGPR, leftGPR);
+            break;
+        case OpType::I64ExtendSI32:
+            result = allocateTemporary(I64);
+            m_jit.signExtend32ToPtr(leftGPR, leftGPR);
+            break;
+        case OpType::I64ExtendUI32:
+            // materialize() already zero extended the value.
+            result = allocateTemporary(I64);
+            break;
+        case OpType::F32Abs:
+            result = allocateTemporary(F32);
+            m_jit.and32(CCallHelpers::TrustedImm32(0x7fffffff), leftGPR);
+            break;
+        case OpType::F32Neg:
+            result = allocateTemporary(F32);
+            m_jit.xor32(CCallHelpers::TrustedImm32(0x80000000), leftGPR);
+            break;
+        case OpType::F64Abs:
+            result = allocateTemporary(F64);
+            m_jit.move(CCallHelpers::TrustedImm64(std::numeric_limits<int64_t>::max()), scratchGPR);
+            m_jit.and64(scratchGPR, leftGPR);
+            break;
+        case OpType::F64Neg:
+            result = allocateTemporary(F64);
+            m_jit.xor64(CCallHelpers::TrustedImm64(std::numeric_limits<int64_t>::min()), leftGPR);
+            break;
+        default:
+            RELEASE_ASSERT_NOT_REACHED();
+        }
+        storeResult(leftGPR, result);
+        return { };
+    }
+
+    // Conversions from integers.
+    case OpType::F32ConvertSI32:
+    case OpType::F32ConvertUI32:
+    case OpType::F32ConvertSI64:
+    case OpType::F32ConvertUI64:
+    case OpType::F64ConvertSI32:
+    case OpType::F64ConvertUI32:
+    case OpType::F64ConvertSI64:
+    case OpType::F64ConvertUI64: {
+        materialize(arg, leftGPR);
+        consume(arg);
+        switch (op) {
+        case OpType::F32ConvertSI32:
+            result = allocateTemporary(F32);
+            m_jit.convertInt32ToFloat(leftGPR, leftFPR);
+            break;
+        case OpType::F32ConvertUI32:
+            // The value is zero extended, so converting it as a 64-bit integer gives the unsigned result.
+            result = allocateTemporary(F32);
+            m_jit.convertInt64ToFloat(leftGPR, leftFPR);
+            break;
+        case OpType::F32ConvertSI64:
+            result = allocateTemporary(F32);
+            m_jit.convertInt64ToFloat(leftGPR, leftFPR);
+            break;
+        case OpType::F32ConvertUI64:
+            result = allocateTemporary(F32);
+            m_jit.convertUInt64ToFloat(leftGPR, leftFPR, scratchGPR);
+            break;
+        case OpType::F64ConvertSI32:
+            result = allocateTemporary(F64);
+            m_jit.convertInt32ToDouble(leftGPR, leftFPR);
+            break;
+        case OpType::F64ConvertUI32:
+            result = allocateTemporary(F64);
+            m_jit.convertInt64ToDouble(leftGPR, leftFPR);
+            break;
+        case OpType::F64ConvertSI64:
+            result = allocateTemporary(F64);
+            m_jit.convertInt64ToDouble(leftGPR, leftFPR);
+            break;
+        case OpType::F64ConvertUI64:
+            result = allocateTemporary(F64);
+            m_jit.convertUInt64ToDouble(leftGPR, leftFPR, scratchGPR);
+            break;
+        default:
+            RELEASE_ASSERT_NOT_REACHED();
+        }
+        storeResult(leftFPR, result);
+        return { };
+    }
+
+    // Floating point arithmetic.
+    case OpType::F32Ceil:
+    case OpType::F32Floor:
+    case OpType::F32Trunc:
+    case OpType::F32Nearest:
+    case OpType::F32Sqrt:
+    case OpType::F32DemoteF64:
+    case OpType::F64Ceil:
+    case OpType::F64Floor:
+    case OpType::F64Trunc:
+    case OpType::F64Nearest:
+    case OpType::F64Sqrt:
+    case OpType::F64PromoteF32: {
+        materialize(arg, leftFPR);
+        consume(arg);
+        switch (op) {
+        case OpType::F32Ceil:
+            result = allocateTemporary(F32);
+            m_jit.ceilFloat(leftFPR, leftFPR);
+            break;
+        case OpType::F32Floor:
+            result = allocateTemporary(F32);
+            m_jit.floorFloat(leftFPR, leftFPR);
+            break;
+        case OpType::F32Trunc:
+            result = allocateTemporary(F32);
+            m_jit.roundTowardZeroFloat(leftFPR, leftFPR);
+            break;
+        case OpType::F32Nearest:
+            result = allocateTemporary(F32);
+            m_jit.roundTowardNearestIntFloat(leftFPR, leftFPR);
+            break;
+        case OpType::F32Sqrt:
+            result = allocateTemporary(F32);
+            m_jit.sqrtFloat(leftFPR, leftFPR);
+            break;
+        case OpType::F32DemoteF64:
+            result = allocateTemporary(F32);
+            m_jit.convertDoubleToFloat(leftFPR, leftFPR);
+            break;
+        case OpType::F64Ceil:
+            result = allocateTemporary(F64);
+            m_jit.ceilDouble(leftFPR, leftFPR);
+            break;
+        case OpType::F64Floor:
+            result = allocateTemporary(F64);
+            m_jit.floorDouble(leftFPR, leftFPR);
+            break;
+        case OpType::F64Trunc:
+            result = allocateTemporary(F64);
+            m_jit.roundTowardZeroDouble(leftFPR, leftFPR);
+            break;
+        case OpType::F64Nearest:
+            result = allocateTemporary(F64);
+            m_jit.roundTowardNearestIntDouble(leftFPR, leftFPR);
+            break;
+        case OpType::F64Sqrt:
+            result = allocateTemporary(F64);
+            m_jit.sqrtDouble(leftFPR, leftFPR);
+            break;
+        case OpType::F64PromoteF32:
+            result = allocateTemporary(F64);
+            m_jit.convertFloatToDouble(leftFPR, leftFPR);
+            break;
+        default:
+            RELEASE_ASSERT_NOT_REACHED();
+        }
+        storeResult(leftFPR, result);
+        return { };
+    }
+
+    default:
+        break;
+    }
+
+    return unsupported();
+}
+
+auto SinglePassGenerator::addTruncation(OpType op, ExpressionType arg, ExpressionType& result) -> PartialResult
+{
+    materialize(arg, leftFPR);
+    consume(arg);
+
+    // The argument is in range if it is below max and above (or at) min. NaN is never in range.
+    bool isFloat = arg.type() == F32;
+    bool minIsInclusive;
+    uint64_t max;
+    uint64_t min;
+    switch (op) {
+    case OpType::I32TruncSF32:
+        max = bitwise_cast<uint32_t>(-static_cast<float>(std::numeric_limits<int32_t>::min()));
+        min = bitwise_cast<uint32_t>(static_cast<float>(std::numeric_limits<int32_t>::min()));
+        minIsInclusive = true;
+        break;
+    case OpType::I32TruncSF64:
+        max = bitwise_cast<uint64_t>(-static_cast<double>(std::numeric_limits<int32_t>::min()));
+        min = bitwise_cast<uint64_t>(static_cast<double>(std::numeric_limits<int32_t>::min()));
+        minIsInclusive = true;
+        break;
+    case OpType::I32TruncUF32:
+        max = bitwise_cast<uint32_t>(static_cast<float>(std::numeric_limits<int32_t>::min()) * static_cast<float>(-2.0));
+        min = bitwise_cast<uint32_t>(static_cast<float>(-1.0));
+        minIsInclusive = false;
+        break;
+    case OpType::I32TruncUF64:
+        max = bitwise_cast<uint64_t>(static_cast<double>(std::numeric_limits<int32_t>::min()) * -2.0);
+        min = bitwise_cast<uint64_t>(-1.0);
+        minIsInclusive = false;
+        break;
+    case OpType::I64TruncSF32:
+        max = bitwise_cast<uint32_t>(-static_cast<float>(std::numeric_limits<int64_t>::min()));
+        min = bitwise_cast<uint32_t>(static_cast<float>(std::numeric_limits<int64_t>::min()));
+        minIsInclusive = true;
+        break;
+    case OpType::I64TruncSF64:
+        max = bitwise_cast<uint64_t>(-static_cast<double>(std::numeric_limits<int64_t>::min()));
+        min = bitwise_cast<uint64_t>(static_cast<double>(std::numeric_limits<int64_t>::min()));
+        minIsInclusive = true;
+        break;
+    case OpType::I64TruncUF32:
+        max = bitwise_cast<uint32_t>(static_cast<float>(std::numeric_limits<int64_t>::min()) * static_cast<float>(-2.0));
+        min = bitwise_cast<uint32_t>(static_cast<float>(-1.0));
+        minIsInclusive = false;
+        break;
+    case OpType::I64TruncUF64:
+        max = bitwise_cast<uint64_t>(static_cast<double>(std::numeric_limits<int64_t>::min()) * -2.0);
+        min = bitwise_cast<uint64_t>(-1.0);
+        minIsInclusive = false;
+        break;
+    default:
+        RELEASE_ASSERT_NOT_REACHED();
+    }
+
+    auto branch = [&] (MacroAssembler::DoubleCondition condition) {
+        return isFloat ? m_jit.branchFloat(condition, leftFPR, rightFPR) : m_jit.branchDouble(condition, leftFPR, rightFPR);
+    };
+    materialize(addConstant(arg.type(), max), rightFPR);
+    addExceptionCheck(ExceptionType::OutOfBoundsTrunc, branch(MacroAssembler::DoubleGreaterThanOrEqualOrUnordered));
+    materialize(addConstant(arg.type(), min), rightFPR);
+    addExceptionCheck(ExceptionType::OutOfBoundsTrunc, branch(minIsInclusive ? MacroAssembler::DoubleLessThanOrUnordered : MacroAssembler::DoubleLessThanOrEqualOrUnordered));
+
+    switch (op) {
+    case OpType::I32TruncSF32:
+        result = allocateTemporary(I32);
+        m_jit.truncateFloatToInt32(leftFPR, leftGPR);
+        break;
+    case OpType::I32TruncSF64:
+        result = allocateTemporary(I32);
+        m_jit.truncateDoubleToInt32(leftFPR, leftGPR);
+        break;
+    case OpType::I32TruncUF32:
+        result = allocateTemporary(I32);
+        m_jit.truncateFloatToUint32(leftFPR, leftGPR);
+        break;
+    case OpType::I32TruncUF64:
+        result = allocateTemporary(I32);
+        m_jit.truncateDoubleToUint32(leftFPR, leftGPR);
+        break;
+    case OpType::I64TruncSF32:
+        result = allocateTemporary(I64);
+        m_jit.truncateFloatToInt64(leftFPR, leftGPR);
+        break;
+    case OpType::I64TruncSF64:
+        result = allocateTemporary(I64);
+        m_jit.truncateDoubleToInt64(leftFPR, leftGPR);
+        break;
+    case OpType::I64TruncUF32:
+        result = allocateTemporary(I64);
+        materialize(addConstant(F32, bitwise_cast<uint32_t>(static_cast<float>(std::numeric_limits<uint64_t>::max() - std::numeric_limits<int64_t>::max()))), rightFPR);
+        m_jit.truncateFloatToUint64(leftFPR, leftGPR, scratchFPR, rightFPR);
+        break;
+    case OpType::I64TruncUF64:
+        result = allocateTemporary(I64);
+        materialize(addConstant(F64, bitwise_cast<uint64_t>(static_cast<double>(std::numeric_limits<uint64_t>::max() - std::numeric_limits<int64_t>::max()))), rightFPR);
+        m_jit.truncateDoubleToUint64(leftFPR, leftGPR, scratchFPR, rightFPR);
+        break;
+    default:
+        RELEASE_ASSERT_NOT_REACHED();
+    }
+    storeResult(leftGPR, result);
+    return { };
+}
+
+auto SinglePassGenerator::addIntegerDivision(OpType op, ExpressionType left, ExpressionType right, ExpressionType& result) -> PartialResult
+{
+    static_assert(leftGPR == X86Registers::eax && extraGPR == X86Registers::edx, "x86 division uses eax and edx");
+
+    bool is64Bit = left.type() == I64;
+    materialize(left, leftGPR);
+    materialize(right, rightGPR);
+    consume(right);
+    consume(left);
+    result = allocateTemporary(left.type());
+
+    addExceptionCheck(ExceptionType::DivisionByZero, is64Bit ? m_jit.branchTest64(MacroAssembler::Zero, rightGPR) : m_jit.branchTest32(MacroAssembler::Zero, rightGPR));
+
+    auto branchIfNotMinusOne = [&] {
+        return is64Bit ? m_jit.branch64(MacroAssembler::NotEqual, rightGPR, CCallHelpers::TrustedImm32(-1)) : m_jit.branch32(MacroAssembler::NotEqual, rightGPR, CCallHelpers::TrustedImm32(-1));
+    };
+    auto signedDivide = [&] {
+        if (is64Bit) {
+            m_jit.x86ConvertToQuadWord64();
+            m_jit.x86Div64(rightGPR);
+        } else {
+            m_jit.x86ConvertToDoubleWord32();
+            m_jit.x86Div32(rightGPR);
+        }
+    };
+    auto unsignedDivide = [&] {
+        m_jit.move(CCallHelpers::TrustedImm32(0), extraGPR);
+        if (is64Bit)
+            m_jit.x86UDiv64(rightGPR);
+        else
+            m_jit.x86UDiv32(rightGPR);
+    };
+
+    switch (op) {
+    case OpType::I32DivS:
+    case OpType::I64DivS: {
+        MacroAssembler::Jump notMinusOne = branchIfNotMinusOne();
+        if (is64Bit) {
+            m_jit.move(CCallHelpers::TrustedImm64(std::numeric_limits<int64_t>::min()), scratchGPR);
+            addExceptionCheck(ExceptionType::IntegerOverflow, m_jit.branch64(MacroAssembler::Equal, leftGPR, scratchGPR));
+        } else
+            addExceptionCheck(ExceptionType::IntegerOverflow, m_jit.branch32(MacroAssembler::Equal, leftGPR, CCallHelpers::TrustedImm32(std::numeric_limits<int32_t>::min())));
+        notMinusOne.link(&m_jit);
+        signedDivide();
+        storeResult(leftGPR, result);
+        break;
+    }
+    case OpType::I32RemS:
+    case OpType::I64RemS: {
+        // INT_MIN % -1 would trap in the hardware, but it is 0 in WebAssembly.
+        MacroAssembler::Jump notMinusOne = branchIfNotMinusOne();
+        m_jit.move(CCallHelpers::TrustedImm32(0), extraGPR);
+        MacroAssembler::Jump done = m_jit.jump();
+        notMinusOne.link(&m_jit);
+        signedDivide();
+        done.link(&m_jit);
+        storeResult(extraGPR, result);
+        break;
+    }
+    case OpType::I32DivU:
+    case OpType::I64DivU:
+        unsignedDivide();
+        storeResult(leftGPR, result);
+        break;
+    case OpType::I32RemU:
+    case OpType::I64RemU:
+        unsignedDivide();
+        storeResult(extraGPR, result);
+        break;
+    default:
+        RELEASE_ASSERT_NOT_REACHED();
+    }
+    return { };
+}
+
+auto SinglePassGenerator::addFloatingPointMinMax(OpType op, ExpressionType left, ExpressionType right, ExpressionType& result) -> PartialResult
+{
+    bool isFloat = left.type() == F32;
+    bool isMin = op == OpType::F32Min || op == OpType::F64Min;
+    materialize(left, leftFPR);
+    materialize(right, rightFPR);
+    consume(right);
+    consume(left);
+    result = allocateTemporary(left.type());
+
+    auto branch = [&] (MacroAssembler::DoubleCondition condition) {
+        return isFloat ? m_jit.branchFloat(condition, leftFPR, rightFPR) : m_jit.branchDouble(condition, leftFPR, rightFPR);
+    };
+
+    MacroAssembler::JumpList done;
+    MacroAssembler::Jump leftWins = branch(isMin ? MacroAssembler::DoubleLessThan : MacroAssembler::DoubleGreaterThan);
+    MacroAssembler::Jump rightWins = branch(isMin ? MacroAssembler::DoubleGreaterThan : MacroAssembler::DoubleLessThan);
+    MacroAssembler::Jump equal = branch(MacroAssembler::DoubleEqual);
+
+    // One of the operands is NaN, and adding them propagates it.
+    if (isFloat)
+        m_jit.addFloat(rightFPR, leftFPR);
+    else
+        m_jit.addDouble(rightFPR, leftFPR);
+    done.append(m_jit.jump());
+
+    // The operands are equal but may be zeros of different signs: min(0, -0) is -0 and max(0, -0) is 0.
+    equal.link(&m_jit);
+    if (isFloat) {
+        m_jit.moveFloatTo32(leftFPR, leftGPR);
+        m_jit.moveFloatTo32(rightFPR, rightGPR);
+        if (isMin)
+            m_jit.or32(rightGPR, leftGPR);
+        else
+            m_jit.and32(rightGPR, leftGPR);
+        m_jit.move32ToFloat(leftGPR, leftFPR);
+    } else {
+        m_jit.moveDoubleTo64(leftFPR, leftGPR);
+        m_jit.moveDoubleTo64(rightFPR, rightGPR);
+        if (isMin)
+            m_jit.or64(rightGPR, leftGPR);
+        else
+            m_jit.and64(rightGPR, leftGPR);
+        m_jit.move64ToDouble(leftGPR, leftFPR);
+    }
+    done.append(m_jit.jump());
+
+    rightWins.link(&m_jit);
+    m_jit.moveDouble(rightFPR, leftFPR);
+
+    leftWins.link(&m_jit);
+    done.link(&m_jit);
+    storeResult(leftFPR, result);
+    return { };
+}
+
+auto SinglePassGenerator::addBinaryOp(OpType op, ExpressionType left, ExpressionType right, ExpressionType& result) -> PartialResult
+{
+    switch (op) {
+    case OpType::I32DivS:
+    case OpType::I32DivU:
+    case OpType::I32RemS:
+    case OpType::I32RemU:
+    case OpType::I64DivS:
+    case OpType::I64DivU:
+    case OpType::I64RemS:
+    case OpType::I64RemU:
+        return addIntegerDivision(op, left, right, result);
+
+    case OpType::F32Min:
+    case OpType::F32Max:
+    case OpType::F64Min:
+    case OpType::F64Max:
+        return addFloatingPointMinMax(op, left, right, result);
+
+    case OpType::F32Add:
+    case OpType::F32Sub:
+    case OpType::F32Mul:
+    case OpType::F32Div:
+    case OpType::F64Add:
+    case OpType::F64Sub:
+    case OpType::F64Mul:
+    case OpType::F64Div: {
+        materialize(left, leftFPR);
+        materialize(right, rightFPR);
+        consume(right);
+        consume(left);
+        result = allocateTemporary(left.type());
+        switch (op) {
+        case OpType::F32Add:
+            m_jit.addFloat(rightFPR, leftFPR);
+            break;
+        case OpType::F32Sub:
+            m_jit.subFloat(rightFPR, leftFPR);
+            break;
+        case OpType::F32Mul:
+            m_jit.mulFloat(rightFPR, leftFPR);
+            break;
+        case OpType::F32Div:
+            m_jit.divFloat(rightFPR, leftFPR);
+            break;
+        case OpType::F64Add:
+            m_jit.addDouble(rightFPR, leftFPR);
+            break;
+        case OpType::F64Sub:
+            m_jit.subDouble(rightFPR, leftFPR);
+            break;
+        case OpType::F64Mul:
+            m_jit.mulDouble(rightFPR, leftFPR);
+            break;
+        case OpType::F64Div:
+            m_jit.divDouble(rightFPR, leftFPR);
+            break;
+        default:
+            RELEASE_ASSERT_NOT_REACHED();
+        }
+        storeResult(leftFPR, result);
+        return { };
+    }
+
+    case OpType::F32Eq:
+    case OpType::F32Ne:
+    case OpType::F32Lt:
+    case OpType::F32Gt:
+    case OpType::F32Le:
+    case OpType::F32Ge:
+    case OpType::F64Eq:
+    case OpType::F64Ne:
+    case OpType::F64Lt:
+    case OpType::F64Gt:
+    case OpType::F64Le:
+    case OpType::F64Ge: {
+        materialize(left, leftFPR);
+        materialize(right, rightFPR);
+        consume(right);
+        consume(left);
+        result = allocateTemporary(I32);
+        if (left.type() == F32) {
+            // Widening is exact, so comparing the doubles gives the same answer.
+            m_jit.convertFloatToDouble(leftFPR, leftFPR);
+            m_jit.convertFloatToDouble(rightFPR, rightFPR);
+        }
+        MacroAssembler::DoubleCondition condition;
+        switch (op) {
+        case OpType::F32Eq:
+        case OpType::F64Eq:
+            condition = MacroAssembler::DoubleEqual;
+            break;
+        case OpType::F32Ne:
+        case OpType::F64Ne:
+            condition = MacroAssembler::DoubleNotEqualOrUnordered;
+            break;
+        case OpType::F32Lt:
+        case OpType::F64Lt:
+            condition = MacroAssembler::DoubleLessThan;
+            break;
+        case OpType::F32Gt:
+        case OpType::F64Gt:
+            condition = MacroAssembler::DoubleGreaterThan;
+            break;
+        case OpType::F32Le:
+        case OpType::F64Le:
+            condition = MacroAssembler::DoubleLessThanOrEqual;
+            break;
+        case OpType::F32Ge:
+        case OpType::F64Ge:
+            condition = MacroAssembler::DoubleGreaterThanOrEqual;
+            break;
+        default:
+            RELEASE_ASSERT_NOT_REACHED();
+        }
+        m_jit.compareDouble(condition, leftFPR, rightFPR, leftGPR);
+        storeResult(leftGPR, result);
+        return { };
+    }
+
+    case OpType::F32Copysign:
+    case OpType::F64Copysign: {
+        materialize(left, leftGPR);
+        materialize(right, rightGPR);
+        consume(right);
+        consume(left);
+        result = allocateTemporary(left.type());
+        if (left.type() == F32) {
+            m_jit.and32(CCallHelpers::TrustedImm32(0x7fffffff), leftGPR);
+            m_jit.and32(CCallHelpers::TrustedImm32(0x80000000), rightGPR);
+            m_jit.or32(rightGPR, leftGPR);
+        } else {
+            m_jit.move(CCallHelpers::TrustedImm64(std::numeric_limits<int64_t>::max()), scratchGPR);
+            m_jit.and64(scratchGPR, leftGPR);
+            m_jit.move(CCallHelpers::TrustedImm64(std::numeric_limits<int64_t>::min()), scratchGPR);
+            m_jit.and64(scratchGPR, rightGPR);
+            m_jit.or64(rightGPR, leftGPR);
+        }
+        storeResult(leftGPR, result);
+        return { };
+    }
+
+    default:
+        break;
+    }
+
+    // Everything else operates on two integers and leaves its result in leftGPR.
+    materialize(left, leftGPR);
+    materialize(right, rightGPR);
+    consume(right);
+    consume(left);
+    result = emptyExpression;
+
+    auto compare = [&] (MacroAssembler::RelationalCondition condition) {
+        result = allocateTemporary(I32);
+        if (left.type() == I64)
+            m_jit.compare64(condition, leftGPR, rightGPR, leftGPR);
+        else
+            m_jit.compare32(condition, leftGPR, rightGPR, leftGPR);
+    };
+
+    switch (op) {
+    case OpType::I32Add:
+        m_jit.add32(rightGPR, leftGPR);
+        break;
+    case OpType::I32Sub:
+        m_jit.sub32(rightGPR, leftGPR);
+        break;
+    case OpType::I32Mul:
+        m_jit.mul32(rightGPR, leftGPR);
+        break;
+    case OpType::I32And:
+        m_jit.and32(rightGPR, leftGPR);
+        break;
+    case OpType::I32Or:
+        m_jit.or32(rightGPR, leftGPR);
+        break;
+    case OpType::I32Xor:
+        m_jit.xor32(rightGPR, leftGPR);
+        break;
+    case OpType::I32Shl:
+        m_jit.lshift32(rightGPR, leftGPR);
+        break;
+    case OpType::I32ShrS:
+        m_jit.rshift32(rightGPR, leftGPR);
+        break;
+    case OpType::I32ShrU:
+        m_jit.urshift32(rightGPR, leftGPR);
+        break;
+    case OpType::I32Rotl:
+        m_jit.rotateLeft32(rightGPR, leftGPR);
+        break;
+    case OpType::I32Rotr:
+        m_jit.rotateRight32(rightGPR, leftGPR);
+        break;
+    case OpType::I64Add:
+        m_jit.add64(rightGPR, leftGPR);
+        break;
+    case OpType::I64Sub:
+        m_jit.sub64(rightGPR, leftGPR);
+        break;
+    case OpType::I64Mul:
+        m_jit.mul64(rightGPR, leftGPR);
+        break;
+    case OpType::I64And:
+        m_jit.and64(rightGPR, leftGPR);
+        break;
+    case OpType::I64Or:
+        m_jit.or64(rightGPR, leftGPR);
+        break;
+    case OpType::I64Xor:
+        m_jit.xor64(rightGPR, leftGPR);
+        break;
+    case OpType::I64Shl:
+        m_jit.lshift64(rightGPR, leftGPR);
+        break;
+    case OpType::I64ShrS:
+        m_jit.rshift64(rightGPR, leftGPR);
+        break;
+    case OpType::I64ShrU:
+        m_jit.urshift64(rightGPR, leftGPR);
+        break;
+    case OpType::I64Rotl:
+        m_jit.rotateLeft64(rightGPR, leftGPR);
+        break;
+    case OpType::I64Rotr:
+        m_jit.rotateRight64(rightGPR, leftGPR);
+        break;
+    case OpType::I32Eq:
+    case OpType::I64Eq:
+        compare(MacroAssembler::Equal);
+        break;
+    case OpType::I32Ne:
+    case OpType::I64Ne:
+        compare(MacroAssembler::NotEqual);
+        break;
+    case OpType::I32LtS:
+    case OpType::I64LtS:
+        compare(MacroAssembler::LessThan);
+        break;
+    case OpType::I32LeS:
+    case OpType::I64LeS:
+        compare(MacroAssembler::LessThanOrEqual);
+        break;
+    case OpType::I32GtS:
+    case OpType::I64GtS:
+        compare(MacroAssembler::GreaterThan);
+        break;
+    case OpType::I32GeS:
+    case OpType::I64GeS:
+        compare(MacroAssembler::GreaterThanOrEqual);
+        break;
+    case OpType::I32LtU:
+    case OpType::I64LtU:
+        compare(MacroAssembler::Below);
+        break;
+    case OpType::I32LeU:
+    case OpType::I64LeU:
+        compare(MacroAssembler::BelowOrEqual);
+        break;
+    case OpType::I32GtU:
+    case OpType::I64GtU:
+        compare(MacroAssembler::Above);
+        break;
+    case OpType::I32GeU:
+    case OpType::I64GeU:
+        compare(MacroAssembler::AboveOrEqual);
+        break;
+    default:
+        return unsupported();
+    }
+
+    if (result == emptyExpression)
+        result = allocateTemporary(left.type());
+    storeResult(leftGPR, result);
+    return { };
+}
+
+auto SinglePassGenerator::addTopLevel(Type signature) -> ControlData
+{
+    if (!isSupportedType(signature))
+        m_unsupported = true;
+
+    m_stackHeight = slotForLocal(m_localTypes.size());
+    m_maxStackHeight = m_stackHeight;
+
+    m_jit.emitFunctionPrologue();
+
+    CodeLocationDataLabelPtr* calleeMoveLocation = &m_compilation->calleeMoveLocation;
+    MacroAssembler::DataLabelPtr moveLocation = m_jit.moveWithPatch(CCallHelpers::TrustedImmPtr(nullptr), leftGPR);
+    m_jit.addLinkTask([calleeMoveLocation, moveLocation] (LinkBuffer& linkBuffer) {
+        *calleeMoveLocation = linkBuffer.locationOf(moveLocation);
+    });
+    m_jit.store64(leftGPR, CCallHelpers::Address(GPRInfo::callFrameRegister, CallFrameSlot::callee * sizeof(Register)));
+    // Stack walking treats a non-null CodeBlock slot as a JS CodeBlock, so clear it.
+    m_jit.store64(CCallHelpers::TrustedImm32(0), CCallHelpers::Address(GPRInfo::callFrameRegister, CallFrameSlot::codeBlock * sizeof(Register)));
+
+    // The frame size isn't known until the whole function has been generated, so the frame is set up by an out of line stub.
+    m_frameSetupJump = m_jit.jump();
+    m_frameSetupDone = m_jit.label();
+
+    // Spill the arguments to their local slots.
+    const WasmCallingConvention& callingConvention = wasmCallingConvention();
+    size_t gpArgumentCount = 0;
+    size_t fpArgumentCount = 0;
+    size_t stackOffset = WasmCallingConvention::headerSizeInBytes();
+    for (unsigned i = 0; i < m_signature->argumentCount(); ++i) {
+        Type type = m_signature->argument(i);
+        CCallHelpers::Address local = addressOfSlot(slotForLocal(i));
+        if (isFloatingPoint(type)) {
+            if (fpArgumentCount < callingConvention.m_fprArgs.size()) {
+                m_jit.storeDouble(callingConvention.m_fprArgs[fpArgumentCount++].fpr(), local);
+                continue;
+            }
+        } else if (gpArgumentCount < callingConvention.m_gprArgs.size()) {
+            m_jit.store64(callingConvention.m_gprArgs[gpArgumentCount++].gpr(), local);
+            continue;
+        }
+        m_jit.load64(CCallHelpers::Address(GPRInfo::callFrameRegister, stackOffset), leftGPR);
+        m_jit.store64(leftGPR, local);
+        stackOffset += sizeof(Register);
+    }
+
+    if (Context::useFastTLS())
+        m_jit.loadWasmContextInstance(leftGPR);
+    else
+        m_jit.move(m_wasmContextInstanceGPR, leftGPR);
+    m_jit.storePtr(leftGPR, addressOfSlot(0));
+
+    // Declared locals start out as zero.
+    uint32_t firstLocal = slotForLocal(m_signature->argumentCount());
+    uint32_t localsEnd = slotForLocal(m_localTypes.size());
+    if (localsEnd - firstLocal <= 16) {
+        for (uint32_t slot = firstLocal; slot < localsEnd; ++slot)
+            m_jit.store64(CCallHelpers::TrustedImm32(0), addressOfSlot(slot));
+    } else {
+        // Slots grow downwards, so walk from the last local up to the first one.
+        m_jit.move(CCallHelpers::TrustedImm32(0), leftGPR);
+        m_jit.addPtr(CCallHelpers::TrustedImm32(addressOfSlot(localsEnd - 1).offset), GPRInfo::callFrameRegister, scratchGPR);
+        m_jit.addPtr(CCallHelpers::TrustedImm32(addressOfSlot(firstLocal - 1).offset), GPRInfo::callFrameRegister, rightGPR);
+        MacroAssembler::Label loop = m_jit.label();
+        m_jit.store64(leftGPR, CCallHelpers::Address(scratchGPR));
+        m_jit.addPtr(CCallHelpers::TrustedImm32(sizeof(Register)), scratchGPR);
+        m_jit.branchPtr(MacroAssembler::NotEqual, scratchGPR, rightGPR).linkTo(loop, &m_jit);
+    }
+
+    emitTierUpCheck(TierUpCount::functionEntryDecrement());
+
+    return ControlData(BlockType::TopLevel, signature, m_stackHeight);
+}
+
+auto SinglePassGenerator::addBlock(Type signature) -> ControlData
+{
+    if (!isSupportedType(signature))
+        m_unsupported = true;
+    return ControlData(BlockType::Block, signature, m_stackHeight);
+}
+
+auto SinglePassGenerator::addLoop(Type signature) -> ControlData
+{
+    if (!isSupportedType(signature))
+        m_unsupported = true;
+    ControlData result(BlockType::Loop, signature, m_stackHeight);
+    result.m_loopHeader = m_jit.label();
+    emitTierUpCheck(TierUpCount::loopDecrement());
+    return result;
+}
+
+auto SinglePassGenerator::addIf(ExpressionType condition, Type signature, ControlData& result) -> PartialResult
+{
+    if (!isSupportedType(signature))
+        return unsupported();
+
+    materialize(condition, leftGPR);
+    consume(condition);
+    result = ControlData(BlockType::If, signature, m_stackHeight);
+    result.m_elseJump = m_jit.branchTest32(MacroAssembler::Zero, leftGPR);
+    return { };
+}
+
+auto SinglePassGenerator::addElse(ControlData& data, const ExpressionList& currentStack) -> PartialResult
+{
+    if (data.signature() != Void)
+        emitCopy(currentStack.last(), data.m_stackHeight);
+    data.m_branches.append(m_jit.jump());
+    return addElseToUnreachable(data);
+}
+
+auto SinglePassGenerator::addElseToUnreachable(ControlData& data) -> PartialResult
+{
+    ASSERT(data.type() == BlockType::If);
+    data.m_elseJump.link(&m_jit);
+    data.convertIfToBlock();
+    m_stackHeight = data.m_stackHeight;
+    return { };
+}
+
+void SinglePassGenerator::emitReturn(ExpressionType value)
+{
+    switch (value.type()) {
+    case Void:
+        break;
+    case I32:
+    case I64:
+        materialize(value, GPRInfo::returnValueGPR);
+        break;
+    case F32:
+    case F64:
+        materialize(value, FPRInfo::returnValueFPR);
+        break;
+    default:
+        RELEASE_ASSERT_NOT_REACHED();
+    }
+    m_jit.emitFunctionEpilogue();
+    m_jit.ret();
+}
+
+auto SinglePassGenerator::addReturn(const ControlData&, const ExpressionList& returnValues) -> PartialResult
+{
+    ASSERT(returnValues.size() <= 1);
+    emitReturn(returnValues.isEmpty() ? emptyExpression : returnValues.last());
+    return { };
+}
+
+void SinglePassGenerator::emitCopyForBranch(ControlData& target, const ExpressionList& expressionStack)
+{
+    if (target.branchTargetSignature() != Void)
+        emitCopy(expressionStack.last(), target.m_stackHeight);
+}
+
+void SinglePassGenerator::emitJumpTo(ControlData& target)
+{
+    if (target.type() == BlockType::Loop)
+        m_jit.jump().linkTo(target.m_loopHeader, &m_jit);
+    else
+        target.m_branches.append(m_jit.jump());
+}
+
+auto SinglePassGenerator::addBranch(ControlData& target, ExpressionType condition, const ExpressionList& returnValues) -> PartialResult
+{
+    if (condition == emptyExpression) {
+        emitCopyForBranch(target, returnValues);
+        emitJumpTo(target);
+        return { };
+    }
+
+    materialize(condition, leftGPR);
+    consume(condition);
+    if (target.branchTargetSignature() == Void) {
+        MacroAssembler::Jump taken = m_jit.branchTest32(MacroAssembler::NonZero, leftGPR);
+        if (target.type() == BlockType::Loop)
+            taken.linkTo(target.m_loopHeader, &m_jit);
+        else
+            target.m_branches.append(taken);
+        return { };
+    }
+
+    MacroAssembler::Jump notTaken = m_jit.branchTest32(MacroAssembler::Zero, leftGPR);
+    emitCopyForBranch(target, returnValues);
+    emitJumpTo(target);
+    notTaken.link(&m_jit);
+    return { };
+}
+
+template<typename Functor>
+void SinglePassGenerator::emitSwitchTree(GPRReg index, unsigned begin, unsigned end, const Functor& jumpToCase)
+{
+    ASSERT(begin < end);
+    if (end - begin == 1) {
+        jumpToCase(begin, m_jit.jump());
+        return;
+    }
+
+    unsigned middle = begin + (end - begin) / 2;
+    MacroAssembler::Jump upperHalf = m_jit.branch32(MacroAssembler::AboveOrEqual, index, CCallHelpers::TrustedImm32(middle));
+    emitSwitchTree(index, begin, middle, jumpToCase);
+    upperHalf.link(&m_jit);
+    emitSwitchTree(index, middle, end, jumpToCase);
+}
+
+auto SinglePassGenerator::addSwitch(ExpressionType condition, const Vector<ControlData*>& targets, ControlData& defaultTarget, const ExpressionList& expressionStack) -> PartialResult
+{
+    materialize(condition, leftGPR);
+    consume(condition);
+
+    // Each distinct target gets one stub that moves the result into place and jumps to the target.
+    Vector<ControlData*> stubTargets;
+    Vector<MacroAssembler::JumpList> stubJumps;
+    auto jumpToStub = [&] (ControlData* target, MacroAssembler::Jump jump) {
+        size_t index = stubTargets.find(target);
+        if (index == notFound) {
+            index = stubTargets.size();
+            stubTargets.append(target);
+            stubJumps.append(MacroAssembler::JumpList());
+        }
+        stubJumps[index].append(jump);
+    };
+
+    if (targets.isEmpty())
+        jumpToStub(&defaultTarget, m_jit.jump());
+    else {
+        jumpToStub(&defaultTarget, m_jit.branch32(MacroAssembler::AboveOrEqual, leftGPR, CCallHelpers::TrustedImm32(targets.size())));
+        emitSwitchTree(leftGPR, 0, targets.size(), [&] (unsigned index, MacroAssembler::Jump jump) {
+            jumpToStub(targets[index], jump);
+        });
+    }
+
+    for (size_t i = 0; i < stubTargets.size(); ++i) {
+        stubJumps[i].link(&m_jit);
+        emitCopyForBranch(*stubTargets[i], expressionStack);
+        emitJumpTo(*stubTargets[i]);
+    }
+    return { };
+}
+
+auto SinglePassGenerator::endBlock(ControlEntry& entry, ExpressionList& expressionStack) -> PartialResult
+{
+    ControlData& data = entry.controlData;
+    if (data.signature() != Void)
+        emitCopy(expressionStack.last(), data.m_stackHeight);
+    return addEndToUnreachable(entry);
+}
+
+auto SinglePassGenerator::addEndToUnreachable(ControlEntry& entry) -> PartialResult
+{
+    ControlData& data = entry.controlData;
+    if (data.type() == BlockType::If)
+        data.m_elseJump.link(&m_jit);
+    data.m_branches.link(&m_jit);
+
+    m_stackHeight = data.m_stackHeight;
+    ExpressionType result = emptyExpression;
+    if (data.signature() != Void) {
+        result = allocateTemporary(data.signature());
+        ASSERT(result.slot() == data.m_stackHeight);
+    }
+
+    if (data.type() == BlockType::TopLevel) {
+        emitReturn(result);
+        return { };
+    }
+
+    if (result != emptyExpression)
+        entry.enclosedExpressionStack.append(result);
+    return { };
+}
+
+void SinglePassGenerator::emitCallArguments(const Signature& signature, const Vector<ExpressionType>& args)
+{
+    const WasmCallingConvention& callingConvention = wasmCallingConvention();
+    size_t gpArgumentCount = 0;
+    size_t fpArgumentCount = 0;
+    size_t stackOffset = WasmCallingConvention::headerSizeInBytes() - sizeof(CallerFrameAndPC);
+
+    // Stack arguments go first since they are moved through scratchGPR, which FP constants also use.
+    Vector<std::pair<ExpressionType, Reg>> registerArguments;
+    for (unsigned i = 0; i < args.size(); ++i) {
+        ExpressionType argument = args[i].withType(signature.argument(i));
+        if (isFloatingPoint(argument.type())) {
+            if (fpArgumentCount < callingConvention.m_fprArgs.size()) {
+                registerArguments.append({ argument, callingConvention.m_fprArgs[fpArgumentCount++] });
+                continue;
+            }
+        } else if (gpArgumentCount < callingConvention.m_gprArgs.size()) {
+            registerArguments.append({ argument, callingConvention.m_gprArgs[gpArgumentCount++] });
+            continue;
+        }
+        materialize(argument, scratchGPR);
+        m_jit.store64(scratchGPR, CCallHelpers::Address(MacroAssembler::stackPointerRegister, stackOffset));
+        stackOffset += sizeof(Register);
+    }
+    m_callArgumentAreaSize = std::max<unsigned>(m_callArgumentAreaSize, WTF::roundUpToMultipleOf(stackAlignmentBytes(), stackOffset));
+
+    for (auto& argument : registerArguments) {
+        if (argument.second.isGPR())
+            materialize(argument.first, argument.second.gpr());
+        else
+            materialize(argument.first, argument.second.fpr());
+    }
+
+    for (const ExpressionType& argument : args)
+        consume(argument);
+}
+
+void SinglePassGenerator::storeCallResult(const Signature& signature, ExpressionType& result)
+{
+    Type returnType = signature.returnType();
+    if (returnType == Void) {
+        result = emptyExpression;
+        return;
+    }
+
+    result = allocateTemporary(returnType);
+    if (isFloatingPoint(returnType))
+        storeResult(FPRInfo::returnValueFPR, result);
+    else
+        storeResult(GPRInfo::returnValueGPR, result);
+}
+
+auto SinglePassGenerator::addCall(uint32_t functionIndex, const Signature& signature, Vector<ExpressionType>& args, ExpressionType& result) -> PartialResult
+{
+    ASSERT(signature.argumentCount() == args.size());
+    if (!isSupportedSignature(signature))
+        return unsupported();
+
+    m_makesCalls = true;
+    Vector<UnlinkedWasmToWasmCall>* unlinkedWasmToWasmCalls = &m_unlinkedWasmToWasmCalls;
+    auto emitWasmToWasmCall = [&] {
+        CCallHelpers::Call call = m_jit.threadSafePatchableNearCall();
+        m_jit.addLinkTask([unlinkedWasmToWasmCalls, call, functionIndex] (LinkBuffer& linkBuffer) {
+            unlinkedWasmToWasmCalls->append({ linkBuffer.locationOfNearCall(call), functionIndex });
+        });
+    };
+
+    if (!m_info.isImportedFunctionFromFunctionIndexSpace(functionIndex)) {
+        emitCallArguments(signature, args);
+        emitWasmToWasmCall();
+        storeCallResult(signature, result);
+        return { };
+    }
+
+    m_maxNumJSCallArguments = std::max(m_maxNumJSCallArguments, static_cast<uint32_t>(args.size()));
+
+    emitCallArguments(signature, args);
+
+    // The target instance is 0 unless the call is wasm->wasm. The argument registers are live, so only
+    // leftGPR and scratchGPR, which are not argument registers, can be used here.
+    loadInstance(leftGPR);
+    m_jit.loadPtr(CCallHelpers::Address(leftGPR, Instance::offsetOfTargetInstance(functionIndex)), scratchGPR);
+    MacroAssembler::Jump isEmbedderCall = m_jit.branchTestPtr(MacroAssembler::Zero, scratchGPR);
+    emitWasmToWasmCall();
+    MacroAssembler::Jump done = m_jit.jump();
+
+    // Calls out to the embedder go through the stub the Instance holds for the import.
+    isEmbedderCall.link(&m_jit);
+    m_jit.loadPtr(CCallHelpers::Address(leftGPR, Instance::offsetOfWasmToEmbedderStubExecutableAddress(functionIndex)), scratchGPR);
+    m_jit.call(scratchGPR);
+    done.link(&m_jit);
+
+    storeCallResult(signature, result);
+
+    // The call could have been to another WebAssembly instance, and / or could have modified our Memory.
+    restoreWebAssemblyGlobalState(RestoreCachedStackLimit::Yes);
+    return { };
+}
+
+auto SinglePassGenerator::addCallIndirect(const Signature& signature, Vector<ExpressionType>& args, ExpressionType& result) -> PartialResult
+{
+    ExpressionType calleeIndex = args.takeLast();
+    ASSERT(signature.argumentCount() == args.size());
+    if (!isSupportedSignature(signature))
+        return unsupported();
+
+    m_makesCalls = true;
+    // Note: call indirect can call either WebAssemblyFunction or WebAssemblyWrapperFunction. Because
+    // WebAssemblyWrapperFunction is like calling into the embedder, we conservatively assume all call indirects
+    // can be to the embedder for our stack check calculation.
+    m_maxNumJSCallArguments = std::max(m_maxNumJSCallArguments, static_cast<uint32_t>(args.size()));
+
+    GPRReg instanceGPR = extraGPR;
+    GPRReg tableGPR = scratchGPR;
+    GPRReg callableFunctionGPR = rightGPR;
+    materialize(calleeIndex, leftGPR);
+    consume(calleeIndex);
+    loadInstance(instanceGPR);
+    m_jit.loadPtr(CCallHelpers::Address(instanceGPR, Instance::offsetOfTable()), tableGPR);
+
+    // Check the index we are looking for is valid.
+    addExceptionCheck(ExceptionType::OutOfBoundsCallIndirect, m_jit.branch32(MacroAssembler::AboveOrEqual, leftGPR, CCallHelpers::Address(tableGPR, Table::offsetOfLength())));
+    m_jit.zeroExtend32ToPtr(leftGPR, leftGPR);
+    if (Options::enableSpectreMitigations())
+        m_jit.and32(CCallHelpers::Address(tableGPR, Table::offsetOfMask()), leftGPR);
+
+    // Compute the offset in the table index space we are looking for.
+    static_assert(sizeof(CallableFunction) == 2 * sizeof(void*), "The scale below relies on this");
+    m_jit.loadPtr(CCallHelpers::Address(tableGPR, Table::offsetOfFunctions()), callableFunctionGPR);
+    m_jit.lshift64(CCallHelpers::TrustedImm32(4), leftGPR);
+    m_jit.addPtr(leftGPR, callableFunctionGPR);
+    m_jit.urshift64(CCallHelpers::TrustedImm32(4), leftGPR);
+
+    // Check that the CallableFunction is initialized. We trap if it isn't. An "invalid" SignatureIndex indicates it's not initialized.
+    static_assert(sizeof(CallableFunction::signatureIndex) == sizeof(uint32_t), "Load codegen assumes i32");
+    CCallHelpers::Address calleeSignatureIndex(callableFunctionGPR, OBJECT_OFFSETOF(CallableFunction, signatureIndex));
+    addExceptionCheck(ExceptionType::NullTableEntry, m_jit.branch32(MacroAssembler::Equal, calleeSignatureIndex, CCallHelpers::TrustedImm32(Signature::invalidIndex)));
+    // Check the signature matches the value we expect.
+    addExceptionCheck(ExceptionType::BadSignature, m_jit.branch32(MacroAssembler::NotEqual, calleeSignatureIndex, CCallHelpers::TrustedImm32(SignatureInformation::get(signature))));
+
+    // Do a context switch if needed.
+    {
+        GPRReg newContextInstance = tableGPR;
+        m_jit.loadPtr(CCallHelpers::Address(tableGPR, Table::offsetOfInstances()), newContextInstance);
+        m_jit.loadPtr(CCallHelpers::BaseIndex(newContextInstance, leftGPR, CCallHelpers::timesPtr()), newContextInstance);
+        MacroAssembler::Jump isSameContextInstance = m_jit.branchPtr(MacroAssembler::Equal, newContextInstance, instanceGPR);
+
+        const PinnedRegisterInfo& pinnedRegs = PinnedRegisterInfo::get();
+        const auto& sizeRegs = pinnedRegs.sizeRegisters;
+        GPRReg baseMemory = pinnedRegs.baseMemoryPointer;
+        m_jit.loadPtr(CCallHelpers::Address(instanceGPR, Instance::offsetOfCachedStackLimit()), baseMemory);
+        m_jit.storePtr(baseMemory, CCallHelpers::Address(newContextInstance, Instance::offsetOfCachedStackLimit()));
+        m_jit.storeWasmContextInstance(newContextInstance);
+        m_jit.loadPtr(CCallHelpers::Address(newContextInstance, Instance::offsetOfMemory()), baseMemory); // Memory*.
+        ASSERT(sizeRegs.size() == 1);
+        ASSERT(!sizeRegs[0].sizeOffset);
+        m_jit.loadPtr(CCallHelpers::Address(baseMemory, Memory::offsetOfIndexingMask()), pinnedRegs.indexingMask); // Indexing mask.
+        m_jit.loadPtr(CCallHelpers::Address(baseMemory, Memory::offsetOfSize()), sizeRegs[0].sizeRegister); // Memory size.
+        m_jit.loadPtr(CCallHelpers::Address(baseMemory, Memory::offsetOfMemory()), baseMemory); // Memory::void*.
+
+        isSameContextInstance.link(&m_jit);
+    }
+
+    // Keep the callee's entrypoint in a frame slot above the operand stack while the arguments are marshalled.
+    uint32_t calleeCodeSlot = m_stackHeight;
+    for (const ExpressionType& argument : args) {
+        if (argument.isTemporary())
+            calleeCodeSlot = std::max(calleeCodeSlot, argument.slot() + 1);
+    }
+    m_maxStackHeight = std::max(m_maxStackHeight, calleeCodeSlot + 1);
+    m_jit.loadPtr(CCallHelpers::Address(callableFunctionGPR, OBJECT_OFFSETOF(CallableFunction, code)), leftGPR);
+    m_jit.loadPtr(CCallHelpers::Address(leftGPR), leftGPR);
+    m_jit.storePtr(leftGPR, addressOfSlot(calleeCodeSlot));
+
+    emitCallArguments(signature, args);
+    m_jit.loadPtr(addressOfSlot(calleeCodeSlot), leftGPR);
+    m_jit.call(leftGPR);
+
+    storeCallResult(signature, result);
+    restoreWebAssemblyGlobalState(RestoreCachedStackLimit::Yes);
+    return { };
+}
+
+auto SinglePassGenerator::addUnreachable() -> PartialResult
+{
+    addExceptionCheck(ExceptionType::Unreachable, m_jit.jump());
+    return { };
+}
+
+void SinglePassGenerator::dump(const Vector<ControlEntry>& controlStack, const ExpressionList* expressionStack)
+{
+    dataLogLn("Stack height: ", m_stackHeight);
+    for (size_t i = controlStack.size(); i--;) {
+        dataLogLn("  ", controlStack[i].controlData, ": ", listDump(*expressionStack));
+        expressionStack = &controlStack[i].enclosedExpressionStack;
+    }
+    dataLogLn();
+}
+
+void SinglePassGenerator::finalize()
+{
+    // Allocate the frame and check for stack overflow.
+    m_frameSetupJump.link(&m_jit);
+    const Checked<int32_t> frameSize = WTF::roundUpToMultipleOf(stackAlignmentBytes(), (Checked<uint32_t>(m_maxStackHeight) * sizeof(Register) + m_callArgumentAreaSize).unsafeGet());
+    const unsigned minimumParentCheckSize = WTF::roundUpToMultipleOf(stackAlignmentBytes(), 1024);
+    const unsigned extraFrameSize = WTF::roundUpToMultipleOf(stackAlignmentBytes(), std::max<uint32_t>(
+        // See B3IRGenerator's prologue: leaf functions with small frames rely on their caller's check.
+        minimumParentCheckSize,
+        (Checked<uint32_t>(m_maxNumJSCallArguments) * sizeof(Register) + jscCallingConvention().headerSizeInBytes()).unsafeGet()
+    ));
+    const int32_t checkSize = m_makesCalls ? (frameSize + extraFrameSize).unsafeGet() : frameSize.unsafeGet();
+    bool needUnderflowCheck = static_cast<unsigned>(checkSize) > Options::reservedZoneSize();
+    bool needsOverflowCheck = m_makesCalls || frameSize >= minimumParentCheckSize || needUnderflowCheck;
+
+    m_jit.addPtr(CCallHelpers::TrustedImm32(-frameSize.unsafeGet()), GPRInfo::callFrameRegister, MacroAssembler::stackPointerRegister);
+    if (needsOverflowCheck) {
+        GPRReg contextInstance = leftGPR;
+        if (Context::useFastTLS())
+            m_jit.loadWasmContextInstance(contextInstance);
+        else
+            contextInstance = m_wasmContextInstanceGPR;
+
+        m_jit.loadPtr(CCallHelpers::Address(contextInstance, Instance::offsetOfCachedStackLimit()), leftGPR);
+        m_jit.addPtr(CCallHelpers::TrustedImm32(-checkSize), GPRInfo::callFrameRegister, scratchGPR);
+        MacroAssembler::JumpList overflow;
+        if (UNLIKELY(needUnderflowCheck))
+            overflow.append(m_jit.branchPtr(CCallHelpers::Above, scratchGPR, GPRInfo::callFrameRegister));
+        overflow.append(m_jit.branchPtr(CCallHelpers::Below, scratchGPR, leftGPR));
+        m_jit.addLinkTask([overflow] (LinkBuffer& linkBuffer) {
+            linkBuffer.link(overflow, CodeLocationLabel(Thunks::singleton().stub(throwStackOverflowFromWasmThunkGenerator).code()));
+        });
+    }
+    m_jit.jump().linkTo(m_frameSetupDone, &m_jit);
+
+    // The thunk preserves all registers, and nothing is live in a register at a tier up check anyway.
+    for (auto& check : m_tierUpChecks) {
+        check.first.link(&m_jit);
+        m_jit.move(CCallHelpers::TrustedImm32(m_functionIndex), GPRInfo::argumentGPR1);
+        MacroAssembler::Call call = m_jit.nearCall();
+        m_jit.jump().linkTo(check.second, &m_jit);
+        m_jit.addLinkTask([call] (LinkBuffer& linkBuffer) {
+            MacroAssembler::repatchNearCall(linkBuffer.locationOfNearCall(call), CodeLocationLabel(Thunks::singleton().stub(triggerOMGTierUpThunkGenerator).code()));
+        });
+    }
+
+    // Emit one throwing stub per exception type.
+    Vector<std::pair<ExceptionType, MacroAssembler::JumpList>> exceptionStubs;
+    for (auto& check : m_exceptionChecks) {
+        size_t index = 0;
+        while (index < exceptionStubs.size() && exceptionStubs[index].first != check.first)
+            ++index;
+        if (index == exceptionStubs.size())
+            exceptionStubs.append({ check.first, MacroAssembler::JumpList() });
+        exceptionStubs[index].second.append(check.second);
+    }
+    for (auto& stub : exceptionStubs) {
+        stub.second.link(&m_jit);
+        m_jit.move(CCallHelpers::TrustedImm32(static_cast<uint32_t>(stub.first)), GPRInfo::argumentGPR1);
+        MacroAssembler::Jump jumpToThunk = m_jit.jump();
+        m_jit.addLinkTask([jumpToThunk] (LinkBuffer& linkBuffer) {
+            linkBuffer.link(jumpToThunk, CodeLocationLabel(Thunks::singleton().stub(throwExceptionFromWasmThunkGenerator).code()));
+        });
+    }
+}
+
+#endif // CPU(X86_64)
+
+std::unique_ptr<InternalFunction> parseAndCompileSinglePass(CompilationContext& compilationContext, const uint8_t* functionStart, size_t functionLength, const Signature& signature, Vector<UnlinkedWasmToWasmCall>& unlinkedWasmToWasmCalls, const ModuleInformation& info, MemoryMode mode, uint32_t functionIndex, TierUpCount* tierUp, ThrowWasmException throwWasmException)
+{
+#if CPU(X86_64)
+    auto result = std::make_unique<InternalFunction>();
+
+    compilationContext.embedderEntrypointJIT = std::make_unique<CCallHelpers>();
+    compilationContext.wasmEntrypointJIT = std::make_unique<CCallHelpers>();
+
+    SinglePassGenerator generator(info, *compilationContext.wasmEntrypointJIT, result.get(), unlinkedWasmToWasmCalls, mode, functionIndex, tierUp, throwWasmException);
+    FunctionParser<SinglePassGenerator> parser(generator, functionStart, functionLength, signature, info);
+    auto parseResult = parser.parse();
+    if (!parseResult || generator.isUnsupported()) {
+        // The function was already validated, so the only way to get here is to use something we don't compile.
+        dataLogLnIf(WasmSinglePassGeneratorInternal::verbose, "Single-pass tier can't compile function ", functionIndex, parseResult ? String() : parseResult.error());
+        return nullptr;
+    }
+
+    generator.finalize();
+    compilationContext.wasmEntrypointByproducts = std::make_unique<B3::OpaqueByproducts>();
+    return result;
+#else
+    UNUSED_PARAM(compilationContext);
+    UNUSED_PARAM(functionStart);
+    UNUSED_PARAM(functionLength);
+    UNUSED_PARAM(signature);
+    UNUSED_PARAM(unlinkedWasmToWasmCalls);
+    UNUSED_PARAM(info);
+    UNUSED_PARAM(mode);
+    UNUSED_PARAM(functionIndex);
+    UNUSED_PARAM(tierUp);
+    UNUSED_PARAM(throwWasmException);
+    return nullptr;
+#endif
+}
+
+} } // namespace JSC::Wasm
+
+#endif // ENABLE(WEBASSEMBLY)
@@ -0,0 +1,303 @@
+/*
+ * Copyright (C) 2018 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "WasmStreamingParser.h"
+
+#if ENABLE(WEBASSEMBLY)
+
+#include "WasmLimits.h"
+#include "WasmModuleParser.h"
+#include "WasmOps.h"
+#include <wtf/DataLog.h>
+#include <wtf/LEBDecoder.h>
+#include <wtf/text/StringConcatenateNumbers.h>
+
+namespace JSC { namespace Wasm {
+
+namespace WasmStreamingParserInternal {
+static const bool verbose = false;
+}
+
+static const size_t moduleHeaderSize = 8;
+// A varuint32 never takes more than 5 bytes.
+static const size_t maxVarUInt32Size = 5;
+
+const char* StreamingParser::stateString(State state)
+{
+    switch (state) {
+    case State::ModuleHeader: return "ModuleHeader";
+    case State::SectionID: return "SectionID";
+    case State::SectionSize: return "SectionSize";
+    case State::SectionPayload: return "SectionPayload";
+    case State::CodeSectionSize: return "CodeSectionSize";
+    case State::FunctionSize: return "FunctionSize";
+    case State::FunctionPayload: return "FunctionPayload";
+    case State::Finished: return "Finished";
+    case State::FatalError: return "FatalError";
+    }
+    RELEASE_ASSERT_NOT_REACHED();
+}
+
+StreamingParser::StreamingParser(ModuleInformation& info, StreamingParserClient& client)
+    : m_info(info)
+    , m_client(client)
+{
+}
+
+auto StreamingParser::fail(String&& message) -> State
+{
+    m_errorMessage = makeString("WebAssembly.Module doesn't parse at byte ", String::number(m_offset), ": ", message);
+    m_state = State::FatalError;
+    dataLogLnIf(WasmStreamingParserInternal::verbose, "failing with message: ", m_errorMessage);
+    return m_state;
+}
+
+auto StreamingParser::decodeVarUInt32(size_t limit, uint32_t& result) -> DecodeResult
+{
+    ASSERT(limit <= m_source.size());
+    size_t offset = m_offset;
+    if (WTF::LEBDecoder::decodeUInt32(m_source.data(), limit, offset, result)) {
+        m_offset = offset;
+        return DecodeResult::Success;
+    }
+    // The number may simply be cut off by the end of the current chunk.
+    if (limit == m_source.size() && limit - m_offset < maxVarUInt32Size)
+        return DecodeResult::NeedMoreBytes;
+    return DecodeResult::Failure;
+}
+
+auto StreamingParser::parseModuleHeader() -> State
+{
+    if (availableBytes() < moduleHeaderSize)
+        return m_state;
+
+    const uint8_t* header = m_source.data() + m_offset;
+    if (header[0] || header[1] != 'a' || header[2] != 's' || header[3] != 'm')
+        return fail(ASCIILiteral("modules doesn't start with '\\0asm'"));
+    uint32_t versionNumber = header[4] | header[5] << 8 | header[6] << 16 | static_cast<uint32_t>(header[7]) << 24;
+    if (versionNumber != expectedVersionNumber)
+        return fail(makeString("unexpected version number ", String::number(versionNumber), " expected ", String::number(expectedVersionNumber)));
+
+    m_offset += moduleHeaderSize;
+    return m_state = State::SectionID;
+}
+
+auto StreamingParser::parseSectionID() -> State
+{
+    if (!availableBytes())
+        return m_state;
+
+    uint8_t sectionByte = m_source[m_offset];
+    if (sectionByte & 0x80)
+        return fail(ASCIILiteral("can't get section byte"));
+
+    Section section = Section::Custom;
+    if (!decodeSection(sectionByte, section))
+        return fail(makeString("invalid section ", String::number(sectionByte)));
+    ASSERT(section != Section::Begin);
+    if (!validateOrder(m_previousKnownSection, section))
+        return fail(WTF::makeString("invalid section order, ", makeString(m_previousKnownSection), " followed by ", makeString(section)));
+
+    ++m_offset;
+    m_section = section;
+    if (isKnownSection(section))
+        m_previousKnownSection = section;
+    return m_state = State::SectionSize;
+}
+
+auto StreamingParser::parseSectionSize() -> State
+{
+    switch (decodeVarUInt32(m_source.size(), m_sectionLength)) {
+    case DecodeResult::NeedMoreBytes:
+        return m_state;
+    case DecodeResult::Failure:
+        return fail(WTF::makeString("can't get ", makeString(m_section), " section's length"));
+    case DecodeResult::Success:
+        break;
+    }
+
+    if (m_sectionLength > maxModuleSize - m_offset)
+        return fail(makeString(makeString(m_section), " section of size ", String::number(m_sectionLength), " would overflow the maximum module size ", String::number(maxModuleSize)));
+
+    m_sectionEnd = m_offset + m_sectionLength;
+    if (m_section == Section::Code)
+        return m_state = State::CodeSectionSize;
+    return m_state = State::SectionPayload;
+}
+
+auto StreamingParser::parseSectionPayload() -> State
+{
+    if (availableBytes() < m_sectionLength)
+        return m_state;
+
+    dataLogLnIf(WasmStreamingParserInternal::verbose, "parsing ", makeString(m_section), " section at byte ", m_offset, " of length ", m_sectionLength);
+    ModuleParser moduleParser(m_source.data() + m_offset, m_sectionLength, m_info);
+    auto parseResult = moduleParser.parseSection(m_section);
+    if (!parseResult)
+        return fail(makeString("in ", makeString(m_section), " section, ", parseResult.error()));
+
+    m_offset = m_sectionEnd;
+    return m_state = State::SectionID;
+}
+
+auto StreamingParser::parseCodeSectionSize() -> State
+{
+    switch (decodeVarUInt32(std::min(m_source.size(), m_sectionEnd), m_functionCount)) {
+    case DecodeResult::NeedMoreBytes:
+        return m_state;
+    case DecodeResult::Failure:
+        return fail(ASCIILiteral("can't get Code section's count"));
+    case DecodeResult::Success:
+        break;
+    }
+
+    if (m_functionCount != m_info->functionLocationInBinary.size())
+        return fail(makeString("Code section count ", String::number(m_functionCount), " doesn't match the declared number of functions ", String::number(m_info->functionLocationInBinary.size())));
+
+    m_client.didStartCodeSection(m_functionCount);
+    return m_state = State::FunctionSize;
+}
+
+auto StreamingParser::parseFunctionSize() -> State
+{
+    if (m_functionIndex == m_functionCount) {
+        if (m_offset != m_sectionEnd)
+            return fail(ASCIILiteral("parsing ended before the end of Code section"));
+        return m_state = State::SectionID;
+    }
+
+    switch (decodeVarUInt32(std::min(m_source.size(), m_sectionEnd), m_functionSize)) {
+    case DecodeResult::NeedMoreBytes:
+        return m_state;
+    case DecodeResult::Failure:
+        return fail(makeString("can't get ", String::number(m_functionIndex), "th Code function's size"));
+    case DecodeResult::Success:
+        break;
+    }
+
+    if (m_functionSize > m_sectionEnd - m_offset)
+        return fail(makeString("Code function's size ", String::number(m_functionSize), " exceeds the Code section's remaining size ", String::number(m_sectionEnd - m_offset)));
+    if (m_functionSize > maxFunctionSize)
+        return fail(makeString("Code function's size ", String::number(m_functionSize), " is too big"));
+
+    m_info->functionLocationInBinary[m_functionIndex].start = m_offset;
+    m_info->functionLocationInBinary[m_functionIndex].end = m_offset + m_functionSize;
+    return m_state = State::FunctionPayload;
+}
+
+auto StreamingParser::parseFunctionPayload() -> State
+{
+    if (availableBytes() < m_functionSize)
+        return m_state;
+
+    Vector<uint8_t> functionBody;
+    if (!functionBody.tryReserveCapacity(m_functionSize))
+        return fail(makeString("can't allocate enough memory for ", String::number(m_functionIndex), "th Code function's ", String::number(m_functionSize), " bytes"));
+    functionBody.append(m_source.data() + m_offset, m_functionSize);
+
+    m_offset += m_functionSize;
+    m_client.didReceiveFunctionData(m_functionIndex++, WTFMove(functionBody));
+    return m_state = State::FunctionSize;
+}
+
+auto StreamingParser::addBytes(const uint8_t* bytes, size_t length) -> State
+{
+    ASSERT(m_state != State::Finished);
+    if (m_state == State::FatalError)
+        return m_state;
+
+    if (length > maxModuleSize - m_source.size())
+        return fail(makeString("module size ", String::number(m_source.size() + length), " is too large, maximum ", String::number(maxModuleSize)));
+    if (!m_source.tryAppend(bytes, length))
+        return fail(makeString("can't allocate enough memory for ", String::number(m_source.size() + length), " module bytes"));
+
+    while (true) {
+        State previousState = m_state;
+        size_t previousOffset = m_offset;
+
+        switch (m_state) {
+        case State::ModuleHeader:
+            parseModuleHeader();
+            break;
+        case State::SectionID:
+            parseSectionID();
+            break;
+        case State::SectionSize:
+            parseSectionSize();
+            break;
+        case State::SectionPayload:
+            parseSectionPayload();
+            break;
+        case State::CodeSectionSize:
+            parseCodeSectionSize();
+            break;
+        case State::FunctionSize:
+            parseFunctionSize();
+            break;
+        case State::FunctionPayload:
+            parseFunctionPayload();
+            break;
+        case State::Finished:
+        case State::FatalError:
+            return m_state;
+        }
+
+        if (m_state == previousState && m_offset == previousOffset) {
+            dataLogLnIf(WasmStreamingParserInternal::verbose, "waiting for more bytes in state ", stateString(m_state), " at byte ", m_offset);
+            return m_state;
+        }
+    }
+}
+
+auto StreamingParser::finalize() -> State
+{
+    switch (m_state) {
+    case State::ModuleHeader:
+        return fail(makeString("expected a module of at least ", String::number(moduleHeaderSize), " bytes"));
+    case State::SectionID:
+        break;
+    case State::SectionSize:
+    case State::SectionPayload:
+    case State::CodeSectionSize:
+    case State::FunctionSize:
+    case State::FunctionPayload:
+        return fail(WTF::makeString("module ended in the middle of its ", makeString(m_section), " section"));
+    case State::Finished:
+    case State::FatalError:
+        return m_state;
+    }
+
+    if (m_functionIndex != m_info->functionLocationInBinary.size())
+        return fail(makeString("module declares ", String::number(m_info->functionLocationInBinary.size()), " functions but only defines ", String::number(m_functionIndex)));
+
+    ASSERT(m_offset == m_source.size());
+    m_info->setStreamedSource(WTFMove(m_source));
+    return m_state = State::Finished;
+}
+
+} } // namespace JSC::Wasm
+
+#endif // ENABLE(WEBASSEMBLY)
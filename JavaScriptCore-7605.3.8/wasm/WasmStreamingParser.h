@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2018 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#if ENABLE(WEBASSEMBLY)
+
+#include "WasmModuleInformation.h"
+#include "WasmSections.h"
+#include <wtf/Vector.h>
+#include <wtf/text/WTFString.h>
+
+namespace JSC { namespace Wasm {
+
+class StreamingParserClient {
+public:
+    virtual ~StreamingParserClient() { }
+
+    // Called once the Code section's function count has been read. Every non-Code section
+    // that precedes it, and therefore everything function validation depends on, has been
+    // parsed into the ModuleInformation by then.
+    virtual void didStartCodeSection(uint32_t functionCount) = 0;
+
+    // Called as soon as the bytes of a function body are complete. The body is a copy, so
+    // it stays valid while the parser keeps receiving bytes.
+    virtual void didReceiveFunctionData(uint32_t functionIndex, Vector<uint8_t>&& functionBody) = 0;
+};
+
+// Parses a module whose bytes arrive in arbitrarily sized chunks. Module level sections are
+// handed to the ModuleParser once their payload is complete, while the Code section is
+// split up so that each function body reaches the client without waiting for the rest of
+// the section.
+class StreamingParser {
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    enum class State : uint8_t {
+        ModuleHeader,
+        SectionID,
+        SectionSize,
+        SectionPayload,
+        CodeSectionSize,
+        FunctionSize,
+        FunctionPayload,
+        Finished,
+        FatalError,
+    };
+
+    JS_EXPORT_PRIVATE StreamingParser(ModuleInformation&, StreamingParserClient&);
+
+    JS_EXPORT_PRIVATE State addBytes(const uint8_t*, size_t);
+    // Must be called once the last chunk has been added. On success, the complete binary
+    // becomes the ModuleInformation's source.
+    JS_EXPORT_PRIVATE State finalize();
+
+    State state() const { return m_state; }
+    const String& errorMessage() const { return m_errorMessage; }
+
+private:
+    static const char* stateString(State);
+
+    enum class DecodeResult : uint8_t { Success, NeedMoreBytes, Failure };
+    DecodeResult decodeVarUInt32(size_t limit, uint32_t& result);
+    size_t availableBytes() const { return m_source.size() - m_offset; }
+
+    State fail(String&&);
+    State parseModuleHeader();
+    State parseSectionID();
+    State parseSectionSize();
+    State parseSectionPayload();
+    State parseCodeSectionSize();
+    State parseFunctionSize();
+    State parseFunctionPayload();
+
+    Ref<ModuleInformation> m_info;
+    StreamingParserClient& m_client;
+
+    // Every byte received so far. Offsets recorded in the ModuleInformation are relative to
+    // its start, exactly as if the module had been parsed in one go.
+    Vector<uint8_t> m_source;
+    size_t m_offset { 0 };
+
+    State m_state { State::ModuleHeader };
+    Section m_section { Section::Begin };
+    Section m_previousKnownSection { Section::Begin };
+    uint32_t m_sectionLength { 0 };
+    size_t m_sectionEnd { 0 };
+
+    uint32_t m_functionCount { 0 };
+    uint32_t m_functionIndex { 0 };
+    uint32_t m_functionSize { 0 };
+
+    String m_errorMessage;
+};
+
+} } // namespace JSC::Wasm
+
+#endif // ENABLE(WEBASSEMBLY)
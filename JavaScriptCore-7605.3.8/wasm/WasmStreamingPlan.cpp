@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2018 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "WasmStreamingPlan.h"
+
+#if ENABLE(WEBASSEMBLY)
+
+#include "WasmValidate.h"
+#include "WasmWorklist.h"
+#include <wtf/DataLog.h>
+#include <wtf/Locker.h>
+#include <wtf/text/StringConcatenateNumbers.h>
+
+namespace JSC { namespace Wasm {
+
+namespace WasmStreamingPlanInternal {
+static const bool verbose = false;
+}
+
+StreamingPlan::StreamingPlan(Context* context, CompletionTask&& task)
+    : Base(context, adoptRef(*new ModuleInformation(Vector<uint8_t>())), WTFMove(task))
+    , m_streamingParser(m_moduleInformation.get(), *this)
+{
+}
+
+StreamingPlan::~StreamingPlan() { }
+
+void StreamingPlan::didStartCodeSection(uint32_t functionCount)
+{
+    dataLogLnIf(WasmStreamingPlanInternal::verbose, "Starting Code section with ", functionCount, " functions");
+    // No compilation thread can be running yet, since nothing has been enqueued.
+    auto locker = holdLock(m_lock);
+    ASSERT(!m_availableFunctionCount);
+    if (!m_functionBodies.tryReserveCapacity(functionCount)) {
+        fail(locker, makeString("Failed allocating enough space for ", String::number(functionCount), " WebAssembly function bodies"));
+        return;
+    }
+    m_functionBodies.resize(functionCount);
+}
+
+void StreamingPlan::didReceiveFunctionData(uint32_t functionIndex, Vector<uint8_t>&& functionBody)
+{
+    auto locker = holdLock(m_lock);
+    if (isComplete())
+        return;
+    ASSERT(functionIndex == m_availableFunctionCount);
+    m_functionBodies[functionIndex] = WTFMove(functionBody);
+    ++m_availableFunctionCount;
+}
+
+void StreamingPlan::addBytes(const uint8_t* bytes, size_t length)
+{
+    uint32_t previousAvailableFunctionCount = m_availableFunctionCount;
+    if (m_streamingParser.addBytes(bytes, length) == StreamingParser::State::FatalError) {
+        auto locker = holdLock(m_lock);
+        if (!isComplete())
+            fail(locker, String(m_streamingParser.errorMessage()));
+        return;
+    }
+
+    if (m_availableFunctionCount != previousAvailableFunctionCount)
+        ensureWorklist().enqueueMoreWork(*this);
+}
+
+void StreamingPlan::finalize()
+{
+    StreamingParser::State state = m_streamingParser.finalize();
+    auto locker = holdLock(m_lock);
+    if (isComplete())
+        return;
+
+    if (state == StreamingParser::State::FatalError) {
+        fail(locker, String(m_streamingParser.errorMessage()));
+        return;
+    }
+
+    ASSERT(state == StreamingParser::State::Finished);
+    m_state = State::Finalized;
+    completeIfFinished(locker);
+}
+
+void StreamingPlan::cancel()
+{
+    auto locker = holdLock(m_lock);
+    if (!isComplete())
+        fail(locker, ASCIILiteral("WebAssembly streaming compilation was cancelled"));
+}
+
+class StreamingPlan::ThreadCountHolder {
+public:
+    ThreadCountHolder(StreamingPlan& plan)
+        : m_plan(plan)
+    {
+        LockHolder locker(m_plan.m_lock);
+        m_plan.m_numberOfActiveThreads++;
+    }
+
+    ~ThreadCountHolder()
+    {
+        LockHolder locker(m_plan.m_lock);
+        m_plan.m_numberOfActiveThreads--;
+        m_plan.completeIfFinished(locker);
+    }
+
+    StreamingPlan& m_plan;
+};
+
+void StreamingPlan::validateFunctions(CompilationEffort effort)
+{
+    ThreadCountHolder holder(*this);
+
+    size_t bytesValidated = 0;
+    while (true) {
+        if (effort == Partial && bytesValidated >= Options::webAssemblyPartialCompileLimit())
+            return;
+
+        uint32_t functionIndex;
+        Vector<uint8_t> functionBody;
+        {
+            auto locker = holdLock(m_lock);
+            if (isComplete() || m_currentIndex >= m_availableFunctionCount)
+                return;
+            functionIndex = m_currentIndex++;
+            functionBody = WTFMove(m_functionBodies[functionIndex]);
+        }
+
+        SignatureIndex signatureIndex = m_moduleInformation->internalFunctionSignatureIndices[functionIndex];
+        const Signature& signature = SignatureInformation::get(signatureIndex);
+        auto validationResult = validateFunction(functionBody.data(), functionBody.size(), signature, m_moduleInformation.get());
+        if (UNLIKELY(!validationResult)) {
+            auto locker = holdLock(m_lock);
+            if (!isComplete()) {
+                // Multiple validations could fail simultaneously. We arbitrarily choose the first.
+                fail(locker, makeString(validationResult.error(), ", in function at index ", String::number(functionIndex))); // FIXME make this an Expected.
+            }
+            return;
+        }
+
+        bytesValidated += functionBody.size();
+    }
+}
+
+void StreamingPlan::work(CompilationEffort effort)
+{
+    validateFunctions(effort);
+}
+
+void StreamingPlan::completeIfFinished(const AbstractLocker& locker)
+{
+    if (m_state == State::Finalized && !m_numberOfActiveThreads && m_currentIndex == m_availableFunctionCount)
+        complete(locker);
+}
+
+void StreamingPlan::complete(const AbstractLocker& locker)
+{
+    dataLogLnIf(WasmStreamingPlanInternal::verbose, "Starting Completion");
+    if (!isComplete()) {
+        m_state = State::Completed;
+        m_functionBodies.clear();
+        runCompletionTasks(locker);
+    }
+}
+
+} } // namespace JSC::Wasm
+
+#endif // ENABLE(WEBASSEMBLY)
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2018 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#if ENABLE(WEBASSEMBLY)
+
+#include "WasmPlan.h"
+#include "WasmStreamingParser.h"
+#include <wtf/Vector.h>
+
+namespace JSC { namespace Wasm {
+
+// Validates a module while its bytes are still arriving. The module level sections are parsed
+// on the thread that feeds the plan, and each function body is handed to the Wasm Worklist as
+// soon as its Code section entry is complete, so validation overlaps with the download.
+class StreamingPlan final : public Plan, public StreamingParserClient {
+public:
+    using Base = Plan;
+
+    // Note: CompletionTask should not hold a reference to the Plan otherwise there will be a reference cycle.
+    JS_EXPORT_PRIVATE StreamingPlan(Context*, CompletionTask&&);
+    JS_EXPORT_PRIVATE ~StreamingPlan();
+
+    // These must all be called from the thread that owns the stream.
+    JS_EXPORT_PRIVATE void addBytes(const uint8_t*, size_t);
+    JS_EXPORT_PRIVATE void finalize();
+    JS_EXPORT_PRIVATE void cancel();
+
+    Ref<ModuleInformation>&& takeModuleInformation()
+    {
+        RELEASE_ASSERT(!failed() && !hasWork());
+        return WTFMove(m_moduleInformation);
+    }
+
+    enum class State : uint8_t {
+        Streaming,
+        Finalized,
+        Completed // We should only move to Completed if we are holding the lock.
+    };
+
+    // Running out of work is only temporary while we are streaming. The plan is put back on the
+    // Worklist whenever more function bodies arrive.
+    bool hasWork() const override { return m_state != State::Completed && m_currentIndex < m_availableFunctionCount; }
+    void work(CompilationEffort) override;
+    bool multiThreaded() const override { return true; }
+
+private:
+    class ThreadCountHolder;
+    friend class ThreadCountHolder;
+    // For some reason friendship doesn't extend to parent classes...
+    using Base::m_lock;
+
+    void didStartCodeSection(uint32_t functionCount) override;
+    void didReceiveFunctionData(uint32_t functionIndex, Vector<uint8_t>&& functionBody) override;
+
+    void validateFunctions(CompilationEffort);
+    void completeIfFinished(const AbstractLocker&);
+
+    bool isComplete() const override { return m_state == State::Completed; }
+    void complete(const AbstractLocker&) override;
+
+    StreamingParser m_streamingParser;
+    // Sized once the Code section starts, so that storing a newly arrived body never moves
+    // the bodies that compilation threads are looking at.
+    Vector<Vector<uint8_t>> m_functionBodies;
+    State m_state { State::Streaming };
+    uint8_t m_numberOfActiveThreads { 0 };
+    uint32_t m_availableFunctionCount { 0 };
+    uint32_t m_currentIndex { 0 };
+};
+
+} } // namespace JSC::Wasm
+
+#endif // ENABLE(WEBASSEMBLY)
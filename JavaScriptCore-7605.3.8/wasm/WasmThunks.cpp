@@ -88,6 +88,27 @@ MacroAssemblerCodeRef triggerOMGTierUpThunkGenerator(const AbstractLocker&)
     // We also want to spill x30 since that holds our return pc.
     registersToSpill.set(ARM64Registers::x30);
 #endif
+
+#if CPU(X86_64)
+    // The tier up check can happen with V128 values live in any FPR, and preserveRegistersToStackForCall()
+    // would only save their low 64 bits. So we save all 128 bits of every FPR ourselves.
+    RegisterSet vectorsToSpill;
+    for (FPRReg reg = MacroAssembler::firstFPRegister(); reg <= MacroAssembler::lastFPRegister(); reg = MacroAssembler::nextFPRegister(reg)) {
+        if (!registersToSpill.get(reg))
+            continue;
+        vectorsToSpill.set(reg);
+        registersToSpill.clear(reg);
+    }
+    const unsigned vectorSize = 16;
+    unsigned numberOfStackBytesUsedForVectorPreservation = WTF::roundUpToMultipleOf(stackAlignmentBytes(), vectorsToSpill.numberOfSetRegisters() * vectorSize);
+    jit.subPtr(MacroAssembler::TrustedImm32(numberOfStackBytesUsedForVectorPreservation), MacroAssembler::stackPointerRegister);
+    unsigned vectorIndex = 0;
+    for (FPRReg reg = MacroAssembler::firstFPRegister(); reg <= MacroAssembler::lastFPRegister(); reg = MacroAssembler::nextFPRegister(reg)) {
+        if (vectorsToSpill.get(reg))
+            jit.storeVector(reg, MacroAssembler::Address(MacroAssembler::stackPointerRegister, vectorIndex++ * vectorSize));
+    }
+#endif
+
     unsigned numberOfStackBytesUsedForRegisterPreservation = ScratchRegisterAllocator::preserveRegistersToStackForCall(jit, registersToSpill, extraPaddingBytes);
 
     jit.loadWasmContextInstance(GPRInfo::argumentGPR0);
@@ -98,6 +119,15 @@ MacroAssemblerCodeRef triggerOMGTierUpThunkGenerator(const AbstractLocker&)
 
     ScratchRegisterAllocator::restoreRegistersFromStackForCall(jit, registersToSpill, RegisterSet(), numberOfStackBytesUsedForRegisterPreservation, extraPaddingBytes);
 
+#if CPU(X86_64)
+    vectorIndex = 0;
+    for (FPRReg reg = MacroAssembler::firstFPRegister(); reg <= MacroAssembler::lastFPRegister(); reg = MacroAssembler::nextFPRegister(reg)) {
+        if (vectorsToSpill.get(reg))
+            jit.loadVector(MacroAssembler::Address(MacroAssembler::stackPointerRegister, vectorIndex++ * vectorSize), reg);
+    }
+    jit.addPtr(MacroAssembler::TrustedImm32(numberOfStackBytesUsedForVectorPreservation), MacroAssembler::stackPointerRegister);
+#endif
+
     jit.ret();
     LinkBuffer linkBuffer(jit, GLOBAL_THUNK_ID);
     return FINALIZE_CODE(linkBuffer, ("Trigger OMG tier up"));
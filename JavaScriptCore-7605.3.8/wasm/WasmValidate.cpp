@@ -119,6 +119,25 @@ public:
     Result WARN_UNUSED_RETURN addOp(ExpressionType left, ExpressionType right, ExpressionType& result);
     Result WARN_UNUSED_RETURN addSelect(ExpressionType condition, ExpressionType nonZero, ExpressionType zero, ExpressionType& result);
 
+    // SIMD
+    ExpressionType addSIMDConstant(B3::v128_t) { return V128; }
+    Result WARN_UNUSED_RETURN addSIMDLoad(ExpressionType pointer, ExpressionType& result, uint32_t offset);
+    Result WARN_UNUSED_RETURN addSIMDStore(ExpressionType pointer, ExpressionType value, uint32_t offset);
+    Result WARN_UNUSED_RETURN addSIMDSplat(B3::SIMDLane, ExpressionType scalar, ExpressionType& result);
+    Result WARN_UNUSED_RETURN addSIMDExtractLane(B3::SIMDLane, uint8_t laneIndex, ExpressionType vector, ExpressionType& result);
+    Result WARN_UNUSED_RETURN addSIMDReplaceLane(B3::SIMDLane, uint8_t laneIndex, ExpressionType vector, ExpressionType scalar, ExpressionType& result);
+    Result WARN_UNUSED_RETURN addSIMDUnary(SIMDOpType, ExpressionType value, ExpressionType& result);
+    Result WARN_UNUSED_RETURN addSIMDBinary(SIMDOpType, ExpressionType left, ExpressionType right, ExpressionType& result);
+
+    // Atomics
+    Result WARN_UNUSED_RETURN atomicLoad(AtomicOpType, ExpressionType pointer, ExpressionType& result, uint32_t offset);
+    Result WARN_UNUSED_RETURN atomicStore(AtomicOpType, ExpressionType pointer, ExpressionType value, uint32_t offset);
+    Result WARN_UNUSED_RETURN atomicBinaryRMW(AtomicOpType, ExpressionType pointer, ExpressionType value, ExpressionType& result, uint32_t offset);
+    Result WARN_UNUSED_RETURN atomicCompareExchange(AtomicOpType, ExpressionType pointer, ExpressionType expected, ExpressionType value, ExpressionType& result, uint32_t offset);
+    Result WARN_UNUSED_RETURN atomicWait(AtomicOpType, ExpressionType pointer, ExpressionType value, ExpressionType timeout, ExpressionType& result, uint32_t offset);
+    Result WARN_UNUSED_RETURN atomicNotify(AtomicOpType, ExpressionType pointer, ExpressionType count, ExpressionType& result, uint32_t offset);
+    Result WARN_UNUSED_RETURN atomicFence() { return { }; }
+
     // Control flow
     ControlData WARN_UNUSED_RETURN addTopLevel(Type signature);
     ControlData WARN_UNUSED_RETURN addBlock(Type signature);
@@ -234,6 +253,133 @@ auto Validate::addSelect(ExpressionType condition, ExpressionType nonZero, Expre
     return { };
 }
 
+static Type scalarTypeForLane(B3::SIMDLane lane)
+{
+    switch (lane) {
+    case B3::SIMDLane::i8x16:
+    case B3::SIMDLane::i16x8:
+    case B3::SIMDLane::i32x4:
+        return I32;
+    case B3::SIMDLane::i64x2:
+        return I64;
+    case B3::SIMDLane::f32x4:
+        return F32;
+    case B3::SIMDLane::f64x2:
+        return F64;
+    case B3::SIMDLane::v128:
+        break;
+    }
+    RELEASE_ASSERT_NOT_REACHED();
+    return Void;
+}
+
+auto Validate::addSIMDLoad(ExpressionType pointer, ExpressionType& result, uint32_t) -> Result
+{
+    WASM_VALIDATOR_FAIL_IF(!hasMemory(), "v128.load instruction without memory");
+    WASM_VALIDATOR_FAIL_IF(pointer != I32, "v128.load pointer must be i32, got ", pointer);
+    result = V128;
+    return { };
+}
+
+auto Validate::addSIMDStore(ExpressionType pointer, ExpressionType value, uint32_t) -> Result
+{
+    WASM_VALIDATOR_FAIL_IF(!hasMemory(), "v128.store instruction without memory");
+    WASM_VALIDATOR_FAIL_IF(pointer != I32, "v128.store pointer must be i32, got ", pointer);
+    WASM_VALIDATOR_FAIL_IF(value != V128, "v128.store value must be v128, got ", value);
+    return { };
+}
+
+auto Validate::addSIMDSplat(B3::SIMDLane lane, ExpressionType scalar, ExpressionType& result) -> Result
+{
+    WASM_VALIDATOR_FAIL_IF(scalar != scalarTypeForLane(lane), "splat scalar must be ", scalarTypeForLane(lane), ", got ", scalar);
+    result = V128;
+    return { };
+}
+
+auto Validate::addSIMDExtractLane(B3::SIMDLane lane, uint8_t, ExpressionType vector, ExpressionType& result) -> Result
+{
+    WASM_VALIDATOR_FAIL_IF(vector != V128, "extract_lane vector must be v128, got ", vector);
+    result = scalarTypeForLane(lane);
+    return { };
+}
+
+auto Validate::addSIMDReplaceLane(B3::SIMDLane lane, uint8_t, ExpressionType vector, ExpressionType scalar, ExpressionType& result) -> Result
+{
+    WASM_VALIDATOR_FAIL_IF(vector != V128, "replace_lane vector must be v128, got ", vector);
+    WASM_VALIDATOR_FAIL_IF(scalar != scalarTypeForLane(lane), "replace_lane scalar must be ", scalarTypeForLane(lane), ", got ", scalar);
+    result = V128;
+    return { };
+}
+
+auto Validate::addSIMDUnary(SIMDOpType op, ExpressionType value, ExpressionType& result) -> Result
+{
+    WASM_VALIDATOR_FAIL_IF(value != V128, makeString(op), " operand must be v128, got ", value);
+    result = V128;
+    return { };
+}
+
+auto Validate::addSIMDBinary(SIMDOpType op, ExpressionType left, ExpressionType right, ExpressionType& result) -> Result
+{
+    WASM_VALIDATOR_FAIL_IF(left != V128, makeString(op), " left operand must be v128, got ", left);
+    WASM_VALIDATOR_FAIL_IF(right != V128, makeString(op), " right operand must be v128, got ", right);
+    result = V128;
+    return { };
+}
+
+auto Validate::atomicLoad(AtomicOpType op, ExpressionType pointer, ExpressionType& result, uint32_t) -> Result
+{
+    WASM_VALIDATOR_FAIL_IF(!hasMemory(), makeString(op), " instruction without memory");
+    WASM_VALIDATOR_FAIL_IF(pointer != I32, makeString(op), " pointer must be i32, got ", pointer);
+    result = atomicValueType(op);
+    return { };
+}
+
+auto Validate::atomicStore(AtomicOpType op, ExpressionType pointer, ExpressionType value, uint32_t) -> Result
+{
+    WASM_VALIDATOR_FAIL_IF(!hasMemory(), makeString(op), " instruction without memory");
+    WASM_VALIDATOR_FAIL_IF(pointer != I32, makeString(op), " pointer must be i32, got ", pointer);
+    WASM_VALIDATOR_FAIL_IF(value != atomicValueType(op), makeString(op), " value must be ", atomicValueType(op), ", got ", value);
+    return { };
+}
+
+auto Validate::atomicBinaryRMW(AtomicOpType op, ExpressionType pointer, ExpressionType value, ExpressionType& result, uint32_t) -> Result
+{
+    WASM_VALIDATOR_FAIL_IF(!hasMemory(), makeString(op), " instruction without memory");
+    WASM_VALIDATOR_FAIL_IF(pointer != I32, makeString(op), " pointer must be i32, got ", pointer);
+    WASM_VALIDATOR_FAIL_IF(value != atomicValueType(op), makeString(op), " value must be ", atomicValueType(op), ", got ", value);
+    result = atomicValueType(op);
+    return { };
+}
+
+auto Validate::atomicCompareExchange(AtomicOpType op, ExpressionType pointer, ExpressionType expected, ExpressionType value, ExpressionType& result, uint32_t) -> Result
+{
+    WASM_VALIDATOR_FAIL_IF(!hasMemory(), makeString(op), " instruction without memory");
+    WASM_VALIDATOR_FAIL_IF(pointer != I32, makeString(op), " pointer must be i32, got ", pointer);
+    WASM_VALIDATOR_FAIL_IF(expected != atomicValueType(op), makeString(op), " expected value must be ", atomicValueType(op), ", got ", expected);
+    WASM_VALIDATOR_FAIL_IF(value != atomicValueType(op), makeString(op), " replacement value must be ", atomicValueType(op), ", got ", value);
+    result = atomicValueType(op);
+    return { };
+}
+
+auto Validate::atomicWait(AtomicOpType op, ExpressionType pointer, ExpressionType value, ExpressionType timeout, ExpressionType& result, uint32_t) -> Result
+{
+    WASM_VALIDATOR_FAIL_IF(!hasMemory(), makeString(op), " instruction without memory");
+    WASM_VALIDATOR_FAIL_IF(pointer != I32, makeString(op), " pointer must be i32, got ", pointer);
+    WASM_VALIDATOR_FAIL_IF(value != atomicValueType(op), makeString(op), " expected value must be ", atomicValueType(op), ", got ", value);
+    WASM_VALIDATOR_FAIL_IF(timeout != I64, makeString(op), " timeout must be i64, got ", timeout);
+    result = I32;
+    return { };
+}
+
+auto Validate::atomicNotify(AtomicOpType op, ExpressionType pointer, ExpressionType count, ExpressionType& result, uint32_t) -> Result
+{
+    WASM_VALIDATOR_FAIL_IF(!hasMemory(), makeString(op), " instruction without memory");
+    WASM_VALIDATOR_FAIL_IF(pointer != I32, makeString(op), " pointer must be i32, got ", pointer);
+    WASM_VALIDATOR_FAIL_IF(count != I32, makeString(op), " count must be i32, got ", count);
+    result = I32;
+    return { };
+}
+
 auto Validate::addIf(ExpressionType condition, Type signature, ControlType& result) -> Result
 {
     WASM_VALIDATOR_FAIL_IF(condition != I32, "if condition must be i32, got ", condition);
@@ -47,6 +47,9 @@ public:
     ~Worklist();
 
     JS_EXPORT_PRIVATE void enqueue(Ref<Plan>);
+    // Plans that receive their input incrementally run out of work whenever they catch up with it.
+    // This puts such a plan back on the queue, unless it is still there.
+    void enqueueMoreWork(Ref<Plan>);
     void stopAllPlansForContext(Context&);
 
     JS_EXPORT_PRIVATE void completePlanSynchronously(Plan&);
@@ -40,6 +40,8 @@ class Wasm:
         self.preamble = wasm["preamble"]
         self.types = wasm["type"]
         self.opcodes = wasm["opcode"]
+        self.simdOpcodes = wasm["simd"]
+        self.atomicOpcodes = wasm["atomic"]
         self.header = """/*
  * Copyright (C) 2016-2017 Apple Inc. All rights reserved.
  *
@@ -75,6 +77,16 @@ class Wasm:
             if filter(self.opcodes[op]):
                 yield ret(op)
 
+    def simdOpcodeIterator(self, filter):
+        for op in sorted(self.simdOpcodes.iterkeys(), key=lambda op: self.simdOpcodes[op]["value"]):
+            if filter(self.simdOpcodes[op]):
+                yield {"name": op, "opcode": self.simdOpcodes[op]}
+
+    def atomicOpcodeIterator(self, filter):
+        for op in sorted(self.atomicOpcodes.iterkeys(), key=lambda op: self.atomicOpcodes[op]["value"]):
+            if filter(self.atomicOpcodes[op]):
+                yield {"name": op, "opcode": self.atomicOpcodes[op]}
+
     def toCpp(self, name):
         camelCase = re.sub(r'([^a-z0-9].)', lambda c: c.group(0)[1].upper(), name)
         CamelCase = camelCase[:1].upper() + camelCase[1:]
@@ -84,6 +84,61 @@ defines.append("\n\n")
 
 defines = "".join(defines)
 
+
+def simdMacroizer(filter):
+    for op in wasm.simdOpcodeIterator(filter):
+        b3op = op["opcode"]["b3op"] if isSimple(op["opcode"]) else "Oops"
+        yield " \\\n    macro(" + wasm.toCpp(op["name"]) + ", " + hex(int(op["opcode"]["value"])) + ", " + b3op + ", " + op["opcode"]["lane"] + ")"
+
+simdDefines = ["#define FOR_EACH_WASM_SIMD_SPECIAL_OP(macro)"]
+simdDefines.extend([op for op in simdMacroizer(lambda op: op["category"] == "special")])
+simdDefines.append("\n\n#define FOR_EACH_WASM_SIMD_MEMORY_LOAD_OP(macro)")
+simdDefines.extend([op for op in simdMacroizer(lambda op: op["category"] == "memory" and len(op["return"]) == 1)])
+simdDefines.append("\n\n#define FOR_EACH_WASM_SIMD_MEMORY_STORE_OP(macro)")
+simdDefines.extend([op for op in simdMacroizer(lambda op: op["category"] == "memory" and len(op["return"]) == 0)])
+simdDefines.append("\n\n#define FOR_EACH_WASM_SIMD_SPLAT_OP(macro)")
+simdDefines.extend([op for op in simdMacroizer(lambda op: op["category"] == "splat")])
+simdDefines.append("\n\n#define FOR_EACH_WASM_SIMD_EXTRACT_LANE_OP(macro)")
+simdDefines.extend([op for op in simdMacroizer(lambda op: op["category"] == "extract_lane")])
+simdDefines.append("\n\n#define FOR_EACH_WASM_SIMD_REPLACE_LANE_OP(macro)")
+simdDefines.extend([op for op in simdMacroizer(lambda op: op["category"] == "replace_lane")])
+simdDefines.append("\n\n#define FOR_EACH_WASM_SIMD_UNARY_OP(macro)")
+simdDefines.extend([op for op in simdMacroizer(lambda op: isUnary(op))])
+simdDefines.append("\n\n#define FOR_EACH_WASM_SIMD_BINARY_OP(macro)")
+simdDefines.extend([op for op in simdMacroizer(lambda op: isBinary(op))])
+simdDefines.append("\n\n")
+
+simdDefines = "".join(simdDefines)
+
+
+def atomicValueType(op):
+    if op["category"] in ["atomic.store", "atomic.wait"]:
+        return wasm.toCpp(op["parameter"][1])
+    if len(op["return"]):
+        return wasm.toCpp(op["return"][0])
+    return "Void"
+
+
+def atomicMacroizer(filter):
+    for op in wasm.atomicOpcodeIterator(filter):
+        b3op = op["opcode"].get("b3op", "Oops")
+        width = "Width" + str(op["opcode"]["width"]) if op["opcode"]["width"] else "Width8"
+        yield " \\\n    macro(" + wasm.toCpp(op["name"]) + ", " + hex(int(op["opcode"]["value"])) + ", " + b3op + ", " + width + ", " + atomicValueType(op["opcode"]) + ")"
+
+atomicDefines = ["#define FOR_EACH_WASM_ATOMIC_SPECIAL_OP(macro)"]
+atomicDefines.extend([op for op in atomicMacroizer(lambda op: op["category"] in ["atomic.notify", "atomic.wait", "atomic.fence"])])
+atomicDefines.append("\n\n#define FOR_EACH_WASM_ATOMIC_LOAD_OP(macro)")
+atomicDefines.extend([op for op in atomicMacroizer(lambda op: op["category"] == "atomic.load")])
+atomicDefines.append("\n\n#define FOR_EACH_WASM_ATOMIC_STORE_OP(macro)")
+atomicDefines.extend([op for op in atomicMacroizer(lambda op: op["category"] == "atomic.store")])
+atomicDefines.append("\n\n#define FOR_EACH_WASM_ATOMIC_RMW_OP(macro)")
+atomicDefines.extend([op for op in atomicMacroizer(lambda op: op["category"] == "atomic.rmw")])
+atomicDefines.append("\n\n#define FOR_EACH_WASM_ATOMIC_CMPXCHG_OP(macro)")
+atomicDefines.extend([op for op in atomicMacroizer(lambda op: op["category"] == "atomic.cmpxchg")])
+atomicDefines.append("\n\n")
+
+atomicDefines = "".join(atomicDefines)
+
 opValueSet = set([op for op in wasm.opcodeIterator(lambda op: True, lambda op: opcodes[op]["value"])])
 maxOpValue = max(opValueSet)
 
@@ -236,6 +291,89 @@ enum class StoreOpType : uint8_t {
 
 #undef CREATE_ENUM_VALUE
 
+// SIMD instructions are encoded as OpType::SimdPrefix followed by a varuint32 SIMDOpType. Their
+// macros pass the lane shape (a B3::SIMDLane) in place of the index.
+""" + simdDefines + """#define FOR_EACH_WASM_SIMD_OP(macro) \\
+    FOR_EACH_WASM_SIMD_SPECIAL_OP(macro) \\
+    FOR_EACH_WASM_SIMD_MEMORY_LOAD_OP(macro) \\
+    FOR_EACH_WASM_SIMD_MEMORY_STORE_OP(macro) \\
+    FOR_EACH_WASM_SIMD_SPLAT_OP(macro) \\
+    FOR_EACH_WASM_SIMD_EXTRACT_LANE_OP(macro) \\
+    FOR_EACH_WASM_SIMD_REPLACE_LANE_OP(macro) \\
+    FOR_EACH_WASM_SIMD_UNARY_OP(macro) \\
+    FOR_EACH_WASM_SIMD_BINARY_OP(macro)
+
+#define CREATE_ENUM_VALUE(name, id, b3op, lane) name = id,
+enum class SIMDOpType : uint32_t {
+    FOR_EACH_WASM_SIMD_OP(CREATE_ENUM_VALUE)
+};
+#undef CREATE_ENUM_VALUE
+
+template<typename Int>
+inline bool isValidSIMDOpType(Int i)
+{
+    switch (i) {
+#define CREATE_CASE(name, id, b3op, lane) case id:
+    FOR_EACH_WASM_SIMD_OP(CREATE_CASE)
+        return true;
+#undef CREATE_CASE
+    default:
+        break;
+    }
+    return false;
+}
+
+#define CREATE_CASE(name, id, b3op, lane) case SIMDOpType::name: return #name;
+inline const char* makeString(SIMDOpType op)
+{
+    switch (op) {
+    FOR_EACH_WASM_SIMD_OP(CREATE_CASE)
+    }
+    RELEASE_ASSERT_NOT_REACHED();
+    return nullptr;
+}
+#undef CREATE_CASE
+
+// Atomic instructions are encoded as OpType::AtomicPrefix followed by a varuint32 AtomicOpType. Their
+// macros also pass the B3::Width of the memory access and the wasm Type of the value being accessed.
+""" + atomicDefines + """#define FOR_EACH_WASM_ATOMIC_OP(macro) \\
+    FOR_EACH_WASM_ATOMIC_SPECIAL_OP(macro) \\
+    FOR_EACH_WASM_ATOMIC_LOAD_OP(macro) \\
+    FOR_EACH_WASM_ATOMIC_STORE_OP(macro) \\
+    FOR_EACH_WASM_ATOMIC_RMW_OP(macro) \\
+    FOR_EACH_WASM_ATOMIC_CMPXCHG_OP(macro)
+
+#define CREATE_ENUM_VALUE(name, id, b3op, width, type) name = id,
+enum class AtomicOpType : uint32_t {
+    FOR_EACH_WASM_ATOMIC_OP(CREATE_ENUM_VALUE)
+};
+#undef CREATE_ENUM_VALUE
+
+template<typename Int>
+inline bool isValidAtomicOpType(Int i)
+{
+    switch (i) {
+#define CREATE_CASE(name, id, b3op, width, type) case id:
+    FOR_EACH_WASM_ATOMIC_OP(CREATE_CASE)
+        return true;
+#undef CREATE_CASE
+    default:
+        break;
+    }
+    return false;
+}
+
+#define CREATE_CASE(name, id, b3op, width, type) case AtomicOpType::name: return #name;
+inline const char* makeString(AtomicOpType op)
+{
+    switch (op) {
+    FOR_EACH_WASM_ATOMIC_OP(CREATE_CASE)
+    }
+    RELEASE_ASSERT_NOT_REACHED();
+    return nullptr;
+}
+#undef CREATE_CASE
+
 inline bool isControlOp(OpType op)
 {
     switch (op) {
@@ -36,6 +36,8 @@
 #include "JSWebAssemblyLinkError.h"
 #include "JSWebAssemblyMemory.h"
 #include "JSWebAssemblyModule.h"
+#include "ReleaseHeapAccessScope.h"
+#include "TypedArrayController.h"
 #include "WebAssemblyModuleRecord.h"
 #include "WebAssemblyToJSCallee.h"
 #include <wtf/StdLibExtras.h>
@@ -168,9 +170,17 @@ JSWebAssemblyInstance* JSWebAssemblyInstance::create(VM& vm, ExecState* exec, JS
         vm.topCallFrame = bitwise_cast<ExecState*>(topCallFrame);
     };
 
+    auto park = [&vm] (const ScopedLambda<void()>& parkThread) -> bool {
+        if (!vm.m_typedArrayController->isAtomicsWaitAllowedOnCurrentThread())
+            return false;
+        ReleaseHeapAccessScope releaseHeapAccessScope(vm.heap);
+        parkThread();
+        return true;
+    };
+
     // FIXME: These objects could be pretty big we should try to throw OOM here.
     auto* jsInstance = new (NotNull, allocateCell<JSWebAssemblyInstance>(vm.heap)) JSWebAssemblyInstance(vm, instanceStructure, 
-        Wasm::Instance::create(&vm.wasmContext, WTFMove(module), &vm.topEntryFrame, vm.addressOfSoftStackLimit(), WTFMove(storeTopCallFrame)));
+        Wasm::Instance::create(&vm.wasmContext, WTFMove(module), &vm.topEntryFrame, vm.addressOfSoftStackLimit(), WTFMove(storeTopCallFrame), WTFMove(park)));
     jsInstance->finishCreation(vm, jsModule, moduleNamespace);
     RETURN_IF_EXCEPTION(throwScope, nullptr);
 
@@ -280,6 +290,9 @@ JSWebAssemblyInstance* JSWebAssemblyInstance::create(VM& vm, ExecState* exec, JS
             if (!memory)
                 return exception(createJSWebAssemblyLinkError(exec, vm, importFailMessage(import, "Memory import", "is not an instance of WebAssembly.Memory")));
 
+            if (memory->memory().isShared() != moduleInformation.memory.isShared())
+                return exception(createJSWebAssemblyLinkError(exec, vm, importFailMessage(import, "Memory import", moduleInformation.memory.isShared() ? "is not shared but the module requires a shared memory" : "is shared but the module requires an unshared memory")));
+
             Wasm::PageCount declaredInitial = moduleInformation.memory.initial();
             Wasm::PageCount importedInitial = memory->memory().initial();
             if (importedInitial < declaredInitial)
@@ -343,7 +356,8 @@ JSWebAssemblyInstance* JSWebAssemblyInstance::create(VM& vm, ExecState* exec, JS
             auto* jsMemory = JSWebAssemblyMemory::create(exec, vm, exec->lexicalGlobalObject()->WebAssemblyMemoryStructure());
             RETURN_IF_EXCEPTION(throwScope, nullptr);
 
-            RefPtr<Wasm::Memory> memory = Wasm::Memory::create(moduleInformation.memory.initial(), moduleInformation.memory.maximum(),
+            Wasm::Memory::SharingMode sharingMode = moduleInformation.memory.isShared() ? Wasm::Memory::SharingMode::Shared : Wasm::Memory::SharingMode::Default;
+            RefPtr<Wasm::Memory> memory = Wasm::Memory::create(moduleInformation.memory.initial(), moduleInformation.memory.maximum(), sharingMode,
                 [&vm] (Wasm::Memory::NotifyPressure) { vm.heap.collectAsync(CollectionScope::Full); },
                 [&vm] (Wasm::Memory::SyncTryToReclaim) { vm.heap.collectSync(CollectionScope::Full); },
                 [&vm, jsMemory] (Wasm::Memory::GrowSuccess, Wasm::PageCount oldPageCount, Wasm::PageCount newPageCount) { jsMemory->growSuccessCallback(vm, oldPageCount, newPageCount); });
@@ -58,7 +58,8 @@ JSWebAssemblyMemory* JSWebAssemblyMemory::create(ExecState* exec, VM& vm, Struct
 void JSWebAssemblyMemory::adopt(Ref<Wasm::Memory>&& memory)
 {
     m_memory.swap(memory);
-    ASSERT(m_memory->refCount() == 1);
+    // A shared memory may already be referenced by instances running in other agents.
+    ASSERT(m_memory->refCount() == 1 || m_memory->isShared());
     m_memory->check();
 }
 
@@ -83,7 +84,9 @@ JSArrayBuffer* JSWebAssemblyMemory::buffer(VM& vm, JSGlobalObject* globalObject)
     auto destructor = [protectedMemory = WTFMove(protectedMemory)] (void*) { };
     m_buffer = ArrayBuffer::createFromBytes(memory().memory(), memory().size(), WTFMove(destructor));
     m_buffer->makeWasmMemory();
-    m_bufferWrapper.set(vm, this, JSArrayBuffer::create(vm, globalObject->m_arrayBufferStructure.get(), m_buffer.get()));
+    if (memory().isShared())
+        m_buffer->makeShared();
+    m_bufferWrapper.set(vm, this, JSArrayBuffer::create(vm, globalObject->arrayBufferStructure(m_buffer->sharingMode()), m_buffer.get()));
     RELEASE_ASSERT(m_bufferWrapper);
     return m_bufferWrapper.get();
 }
@@ -107,6 +110,9 @@ Wasm::PageCount JSWebAssemblyMemory::grow(VM& vm, ExecState* exec, uint32_t delt
         case Wasm::Memory::GrowFailReason::OutOfMemory:
             throwException(exec, throwScope, createOutOfMemoryError(exec));
             break;
+        case Wasm::Memory::GrowFailReason::SharedMemory:
+            throwException(exec, throwScope, createRangeError(exec, ASCIILiteral("WebAssembly.Memory.grow can't grow a shared memory")));
+            break;
         }
         return Wasm::PageCount();
     }
@@ -117,8 +123,9 @@ Wasm::PageCount JSWebAssemblyMemory::grow(VM& vm, ExecState* exec, uint32_t delt
 void JSWebAssemblyMemory::growSuccessCallback(VM& vm, Wasm::PageCount oldPageCount, Wasm::PageCount newPageCount)
 {
     // We need to clear out the old array buffer because it might now be pointing to stale memory.
-    // Neuter the old array.
+    // Neuter the old array. Shared memories don't grow, so this is never a SharedArrayBuffer.
     if (m_buffer) {
+        ASSERT(!memory().isShared());
         m_buffer->neuter(vm);
         m_buffer = nullptr;
         m_bufferWrapper.clear();
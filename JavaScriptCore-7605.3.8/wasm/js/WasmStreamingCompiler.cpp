@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2018 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "WasmStreamingCompiler.h"
+
+#if ENABLE(WEBASSEMBLY)
+
+#include "CatchScope.h"
+#include "Exception.h"
+#include "JSCInlines.h"
+#include "JSPromiseDeferred.h"
+#include "JSWebAssemblyModule.h"
+#include "PromiseDeferredTimer.h"
+#include "StrongInlines.h"
+#include "WasmModule.h"
+#include "WasmStreamingPlan.h"
+
+namespace JSC { namespace Wasm {
+
+static Module::AsyncValidationCallback makeStreamingValidationCallback(VM& vm, JSGlobalObject* globalObject, JSPromiseDeferred* promise)
+{
+    return createSharedTask<Module::CallbackType>([promise, globalObject, &vm] (Module::ValidationResult&& result) mutable {
+        vm.promiseDeferredTimer->scheduleWorkSoon(promise, [promise, globalObject, result = WTFMove(result), &vm] () mutable {
+            auto scope = DECLARE_CATCH_SCOPE(vm);
+            ExecState* exec = globalObject->globalExec();
+            JSValue module = JSWebAssemblyModule::createStub(vm, exec, globalObject->WebAssemblyModuleStructure(), WTFMove(result));
+            if (UNLIKELY(scope.exception())) {
+                Exception* exception = scope.exception();
+                scope.clearException();
+                promise->reject(exec, exception->value());
+                CLEAR_AND_RETURN_IF_EXCEPTION(scope, void());
+                return;
+            }
+
+            promise->resolve(exec, module);
+            CLEAR_AND_RETURN_IF_EXCEPTION(scope, void());
+        });
+    });
+}
+
+StreamingCompiler::StreamingCompiler(VM& vm, ExecState* exec, JSPromiseDeferred* promise)
+    : m_promise(vm, promise)
+    , m_plan(Module::validateStreaming(&vm.wasmContext, makeStreamingValidationCallback(vm, exec->lexicalGlobalObject(), promise)))
+{
+    Vector<Strong<JSCell>> dependencies;
+    dependencies.append(Strong<JSCell>(vm, exec->lexicalGlobalObject()));
+    vm.promiseDeferredTimer->addPendingPromise(promise, WTFMove(dependencies));
+}
+
+Ref<StreamingCompiler> StreamingCompiler::create(VM& vm, ExecState* exec, JSPromiseDeferred* promise)
+{
+    return adoptRef(*new StreamingCompiler(vm, exec, promise));
+}
+
+StreamingCompiler::~StreamingCompiler()
+{
+    // If the embedder drops us without finalizing, nobody will ever settle the promise.
+    if (!m_isDone)
+        m_plan->cancel();
+}
+
+void StreamingCompiler::addBytes(const uint8_t* bytes, size_t length)
+{
+    ASSERT(!m_isDone);
+    m_plan->addBytes(bytes, length);
+}
+
+void StreamingCompiler::finalize()
+{
+    ASSERT(!m_isDone);
+    m_isDone = true;
+    m_plan->finalize();
+}
+
+void StreamingCompiler::fail(ExecState* exec, JSValue error)
+{
+    if (m_isDone)
+        return;
+    m_isDone = true;
+    // Rejecting the promise takes it off the pending list, so the plan's own failure report is dropped.
+    m_promise->reject(exec, error);
+    m_plan->cancel();
+}
+
+} } // namespace JSC::Wasm
+
+#endif // ENABLE(WEBASSEMBLY)
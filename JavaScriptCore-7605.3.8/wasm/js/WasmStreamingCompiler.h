@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2018 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#if ENABLE(WEBASSEMBLY)
+
+#include "Strong.h"
+#include <wtf/Ref.h>
+#include <wtf/RefCounted.h>
+
+namespace JSC {
+
+class ExecState;
+class JSPromiseDeferred;
+class JSValue;
+class VM;
+
+namespace Wasm {
+
+class StreamingPlan;
+
+// Backs WebAssembly.compileStreaming. The embedder feeds the module's bytes as they arrive and the
+// promise resolves to a WebAssembly.Module once the bytes have been finalized and validated. All
+// of these functions must be called on the VM's thread while holding the API lock.
+class StreamingCompiler : public RefCounted<StreamingCompiler> {
+public:
+    JS_EXPORT_PRIVATE static Ref<StreamingCompiler> create(VM&, ExecState*, JSPromiseDeferred*);
+    JS_EXPORT_PRIVATE ~StreamingCompiler();
+
+    JS_EXPORT_PRIVATE void addBytes(const uint8_t*, size_t);
+    JS_EXPORT_PRIVATE void finalize();
+    // Rejects the promise with the given value, e.g. because fetching the bytes failed.
+    JS_EXPORT_PRIVATE void fail(ExecState*, JSValue);
+
+private:
+    StreamingCompiler(VM&, ExecState*, JSPromiseDeferred*);
+
+    bool m_isDone { false };
+    Strong<JSPromiseDeferred> m_promise;
+    Ref<StreamingPlan> m_plan;
+};
+
+} } // namespace JSC::Wasm
+
+#endif // ENABLE(WEBASSEMBLY)
@@ -66,6 +66,7 @@ static Expected<MacroAssemblerCodeRef, BindingFailure> handleBadI64Use(VM* vm, J
         case Void:
         case Func:
         case Anyfunc:
+        case V128:
             RELEASE_ASSERT_NOT_REACHED();
 
         case I64: {
@@ -168,6 +169,7 @@ Expected<MacroAssemblerCodeRef, BindingFailure> wasmToJS(VM* vm, Bag<CallLinkInf
             case Void:
             case Func:
             case Anyfunc:
+            case V128:
             case I64:
                 RELEASE_ASSERT_NOT_REACHED();
             case I32: {
@@ -241,6 +243,7 @@ Expected<MacroAssemblerCodeRef, BindingFailure> wasmToJS(VM* vm, Bag<CallLinkInf
                     case Void:
                     case Func:
                     case Anyfunc:
+                    case V128:
                     case I64:
                         RELEASE_ASSERT_NOT_REACHED();
                     case I32:
@@ -268,6 +271,7 @@ Expected<MacroAssemblerCodeRef, BindingFailure> wasmToJS(VM* vm, Bag<CallLinkInf
                 switch (signature.returnType()) {
                 case Func:
                 case Anyfunc:
+                case V128:
                 case I64:
                     RELEASE_ASSERT_NOT_REACHED();
                     break;
@@ -371,6 +375,7 @@ Expected<MacroAssemblerCodeRef, BindingFailure> wasmToJS(VM* vm, Bag<CallLinkInf
             case Void:
             case Func:
             case Anyfunc:
+            case V128:
             case I64:
                 RELEASE_ASSERT_NOT_REACHED(); // Handled above.
             case I32: {
@@ -437,6 +442,7 @@ Expected<MacroAssemblerCodeRef, BindingFailure> wasmToJS(VM* vm, Bag<CallLinkInf
             case Void:
             case Func:
             case Anyfunc:
+            case V128:
             case I64:
                 RELEASE_ASSERT_NOT_REACHED(); // Handled above.
             case I32:
@@ -523,6 +529,7 @@ Expected<MacroAssemblerCodeRef, BindingFailure> wasmToJS(VM* vm, Bag<CallLinkInf
         break;
     case Func:
     case Anyfunc:
+    case V128:
         // For the JavaScript embedding, imports with these types in their signature return are a WebAssembly.Module validation error.
         RELEASE_ASSERT_NOT_REACHED();
         break;
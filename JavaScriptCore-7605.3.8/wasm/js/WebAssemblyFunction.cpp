@@ -105,6 +105,7 @@ static EncodedJSValue JSC_HOST_CALL callWebAssemblyFunction(ExecState* exec)
         case Wasm::I64:
         case Wasm::Func:
         case Wasm::Anyfunc:
+        case Wasm::V128:
             RELEASE_ASSERT_NOT_REACHED();
         }
         RETURN_IF_EXCEPTION(scope, encodedJSValue());
@@ -170,6 +171,7 @@ static EncodedJSValue JSC_HOST_CALL callWebAssemblyFunction(ExecState* exec)
     case Wasm::I64:
     case Wasm::Func:
     case Wasm::Anyfunc:
+    case Wasm::V128:
         RELEASE_ASSERT_NOT_REACHED();
     }
 
@@ -96,10 +96,23 @@ static EncodedJSValue JSC_HOST_CALL constructJSWebAssemblyMemory(ExecState* exec
         }
     }
 
+    Wasm::Memory::SharingMode sharingMode = Wasm::Memory::SharingMode::Default;
+    if (Options::useWebAssemblyThreads()) {
+        JSValue sharedValue = memoryDescriptor->get(exec, Identifier::fromString(&vm, "shared"));
+        RETURN_IF_EXCEPTION(throwScope, encodedJSValue());
+        bool shared = sharedValue.toBoolean(exec);
+        RETURN_IF_EXCEPTION(throwScope, encodedJSValue());
+        if (shared) {
+            if (!maximumPageCount)
+                return JSValue::encode(throwException(exec, throwScope, createTypeError(exec, ASCIILiteral("WebAssembly.Memory with 'shared' set must also specify a 'maximum' page count"))));
+            sharingMode = Wasm::Memory::SharingMode::Shared;
+        }
+    }
+
     auto* jsMemory = JSWebAssemblyMemory::create(exec, vm, exec->lexicalGlobalObject()->WebAssemblyMemoryStructure());
     RETURN_IF_EXCEPTION(throwScope, encodedJSValue());
 
-    RefPtr<Wasm::Memory> memory = Wasm::Memory::create(initialPageCount, maximumPageCount,
+    RefPtr<Wasm::Memory> memory = Wasm::Memory::create(initialPageCount, maximumPageCount, sharingMode,
         [&vm] (Wasm::Memory::NotifyPressure) { vm.heap.collectAsync(CollectionScope::Full); },
         [&vm] (Wasm::Memory::SyncTryToReclaim) { vm.heap.collectSync(CollectionScope::Full); },
         [&vm, jsMemory] (Wasm::Memory::GrowSuccess, Wasm::PageCount oldPageCount, Wasm::PageCount newPageCount) { jsMemory->growSuccessCallback(vm, oldPageCount, newPageCount); });
@@ -31,6 +31,7 @@
 #include "CatchScope.h"
 #include "Exception.h"
 #include "FunctionPrototype.h"
+#include "IteratorOperations.h"
 #include "JSCInlines.h"
 #include "JSPromiseDeferred.h"
 #include "JSToWasm.h"
@@ -42,6 +43,7 @@
 #include "StrongInlines.h"
 #include "ThrowScope.h"
 #include "WasmBBQPlan.h"
+#include "WasmStreamingCompiler.h"
 #include "WasmToJS.h"
 #include "WasmWorklist.h"
 #include "WebAssemblyInstanceConstructor.h"
@@ -52,6 +54,7 @@ using JSC::Wasm::BBQPlan;
 
 namespace JSC {
 static EncodedJSValue JSC_HOST_CALL webAssemblyCompileFunc(ExecState*);
+static EncodedJSValue JSC_HOST_CALL webAssemblyCompileStreamingFunc(ExecState*);
 static EncodedJSValue JSC_HOST_CALL webAssemblyInstantiateFunc(ExecState*);
 static EncodedJSValue JSC_HOST_CALL webAssemblyValidateFunc(ExecState*);
 }
@@ -64,9 +67,10 @@ const ClassInfo WebAssemblyPrototype::s_info = { "WebAssembly", &Base::s_info, &
 
 /* Source for WebAssemblyPrototype.lut.h
  @begin prototypeTableWebAssembly
- compile     webAssemblyCompileFunc     DontEnum|Function 1
- instantiate webAssemblyInstantiateFunc DontEnum|Function 1
- validate    webAssemblyValidateFunc    DontEnum|Function 1
+ compile          webAssemblyCompileFunc          DontEnum|Function 1
+ compileStreaming webAssemblyCompileStreamingFunc DontEnum|Function 1
+ instantiate      webAssemblyInstantiateFunc      DontEnum|Function 1
+ validate         webAssemblyValidateFunc         DontEnum|Function 1
  @end
  */
 
@@ -120,6 +124,49 @@ static EncodedJSValue JSC_HOST_CALL webAssemblyCompileFunc(ExecState* exec)
     }
 }
 
+static EncodedJSValue JSC_HOST_CALL webAssemblyCompileStreamingFunc(ExecState* exec)
+{
+    VM& vm = exec->vm();
+    auto throwScope = DECLARE_THROW_SCOPE(vm);
+    auto* globalObject = exec->lexicalGlobalObject();
+
+    JSPromiseDeferred* promise = JSPromiseDeferred::create(exec, globalObject);
+    RETURN_IF_EXCEPTION(throwScope, encodedJSValue());
+
+    {
+        auto catchScope = DECLARE_CATCH_SCOPE(vm);
+
+        if (auto compileStreaming = globalObject->globalObjectMethodTable()->compileStreaming) {
+            compileStreaming(globalObject, exec, promise, exec->argument(0));
+            if (UNLIKELY(catchScope.exception()))
+                reject(exec, catchScope, promise);
+            return JSValue::encode(promise->promise());
+        }
+
+        // Without an embedder provided source, accept any iterable of BufferSource chunks.
+        // Each chunk is parsed as soon as the iterator produces it.
+        Ref<Wasm::StreamingCompiler> compiler = Wasm::StreamingCompiler::create(vm, exec, promise);
+        forEachInIterable(exec, exec->argument(0), [&] (VM& vm, ExecState* exec, JSValue chunk) {
+            auto scope = DECLARE_THROW_SCOPE(vm);
+            uint8_t* base;
+            size_t byteSize;
+            std::tie(base, byteSize) = getWasmBufferFromValue(exec, chunk);
+            RETURN_IF_EXCEPTION(scope, void());
+            compiler->addBytes(base, byteSize);
+        });
+
+        if (UNLIKELY(catchScope.exception())) {
+            Exception* exception = catchScope.exception();
+            catchScope.clearException();
+            compiler->fail(exec, exception->value());
+            CLEAR_AND_RETURN_IF_EXCEPTION(catchScope, JSValue::encode(promise->promise()));
+        } else
+            compiler->finalize();
+
+        return JSValue::encode(promise->promise());
+    }
+}
+
 enum class Resolve { WithInstance, WithModuleAndInstance };
 static void resolve(VM& vm, ExecState* exec, JSPromiseDeferred* promise, JSWebAssemblyInstance* instance, JSWebAssemblyModule* module, Ref<Wasm::CodeBlock>&& codeBlock, Resolve resolveKind)
 {
@@ -126,7 +126,7 @@ int RegularExpression::match(const String& str, int startFrom, int* matchLength)
         result = JSC::Yarr::offsetNoMatch;
     }
 
-    if (result == JSC::Yarr::offsetNoMatch) {
+    if (result == JSC::Yarr::offsetNoMatch || result == JSC::Yarr::offsetHitMatchLimit) {
         d->lastMatchLength = -1;
         return -1;
     }
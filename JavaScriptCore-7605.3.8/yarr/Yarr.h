@@ -59,6 +59,10 @@ enum JSRegExpResult {
     JSRegExpErrorInternal = -5,
 };
 
+// What the interpreter and the JIT return instead of a match offset when they gave up on the
+// input after taking matchLimit steps.
+static const unsigned offsetHitMatchLimit = static_cast<unsigned>(JSRegExpErrorHitLimit);
+
 enum YarrCharSize {
     Char8,
     Char16
@@ -73,5 +77,7 @@ enum class BuiltInCharacterClassID : unsigned {
 };
 
 struct BytecodePattern;
+class LinearPattern;
+struct YarrPattern;
 
 } } // namespace JSC::Yarr
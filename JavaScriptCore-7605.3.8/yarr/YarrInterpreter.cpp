@@ -1621,7 +1621,9 @@ public:
 
         if (pattern->m_lock)
             pattern->m_lock->unlock();
-        
+
+        if (result == JSRegExpErrorHitLimit)
+            return offsetHitMatchLimit;
         return output[0];
     }
 
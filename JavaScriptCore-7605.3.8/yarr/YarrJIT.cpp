@@ -32,6 +32,7 @@
 #include "VM.h"
 #include "Yarr.h"
 #include "YarrCanonicalize.h"
+#include <mutex>
 
 #if ENABLE(YARR_JIT)
 
@@ -39,6 +40,56 @@ using namespace WTF;
 
 namespace JSC { namespace Yarr {
 
+// Returns the smallest code unit that is equivalent to ch under the rules YarrInterpreter uses to
+// match backreferences case insensitively (see ES 6.0, 21.2.2.8.2). For non-Unicode patterns ASCII
+// characters are never allowed to match non-ASCII ones.
+static UChar canonicalRepresentativeForBackReference(UChar32 ch, CanonicalMode canonicalMode)
+{
+    if (canonicalMode == CanonicalMode::UCS2 && isASCII(ch))
+        return toASCIIUpper(ch);
+
+    auto isCandidate = [&] (UChar32 equivalent) {
+        return U_IS_BMP(equivalent) && (canonicalMode == CanonicalMode::Unicode || !isASCII(equivalent));
+    };
+
+    UChar32 representative = ch;
+    const CanonicalizationRange* info = canonicalRangeInfoFor(ch, canonicalMode);
+    switch (info->type) {
+    case CanonicalizeUnique:
+        break;
+    case CanonicalizeSet:
+        for (const UChar32* set = canonicalCharacterSetInfo(info->value, canonicalMode); *set; ++set) {
+            if (*set < representative && isCandidate(*set))
+                representative = *set;
+        }
+        break;
+    default: {
+        UChar32 pair = getCanonicalPair(info, ch);
+        if (pair < representative && isCandidate(pair))
+            representative = pair;
+        break;
+    }
+    }
+    return representative;
+}
+
+// A table mapping every UTF-16 code unit to its canonical representative, so that JIT code can compare
+// two characters of a backreference ignoring case with a pair of loads.
+static const UChar* backReferenceCanonicalizationTable(CanonicalMode canonicalMode)
+{
+    static std::once_flag onceFlags[2];
+    static UChar* tables[2];
+
+    unsigned tableIndex = canonicalMode == CanonicalMode::UCS2 ? 0 : 1;
+    std::call_once(onceFlags[tableIndex], [&] {
+        UChar* table = static_cast<UChar*>(fastMalloc(0x10000 * sizeof(UChar)));
+        for (UChar32 ch = 0; ch <= 0xffff; ++ch)
+            table[ch] = canonicalRepresentativeForBackReference(ch, canonicalMode);
+        tables[tableIndex] = table;
+    });
+    return tables[tableIndex];
+}
+
 template<YarrJITCompileMode compileMode>
 class YarrGenerator : private MacroAssembler {
     friend void jitCompile(VM*, YarrCodeBlock& jitObject, const String& pattern, unsigned& numSubpatterns, const char*& error, bool ignoreCase, bool multiline);
@@ -83,6 +134,7 @@ class YarrGenerator : private MacroAssembler {
 
 #define HAVE_INITIAL_START_REG
 #define JIT_UNICODE_EXPRESSIONS
+#define JIT_LITERAL_SCAN
 #elif CPU(MIPS)
     static const RegisterID input = MIPSRegisters::a0;
     static const RegisterID index = MIPSRegisters::a1;
@@ -152,8 +204,19 @@ class YarrGenerator : private MacroAssembler {
 
     const TrustedImm32 supplementaryPlanesBase = TrustedImm32(0x10000);
     const TrustedImm32 surrogateTagMask = TrustedImm32(0xfffffc00);
+
+    // Used to compare a vector's worth of input at a time when scanning for literal characters.
+    // Everything the scan emits is SSE2, so it is always available.
+    static const FPRegisterID scanCharacterVector0 = X86Registers::xmm0;
+    static const FPRegisterID scanCharacterVector1 = X86Registers::xmm1;
+    static const FPRegisterID scanInputVector = X86Registers::xmm2;
+    static const FPRegisterID scanMatchVector = X86Registers::xmm3;
 #define HAVE_INITIAL_START_REG
 #define JIT_UNICODE_EXPRESSIONS
+#if !OS(WINDOWS)
+// regT2 is callee save on Windows, and only preserved when the pattern has nested subpatterns.
+#define JIT_LITERAL_SCAN
+#endif
 #endif
 
 #if ENABLE(YARR_JIT_ALL_PARENS_EXPRESSIONS)
@@ -574,7 +637,159 @@ class YarrGenerator : private MacroAssembler {
 
         return branch32(NotEqual, character, Imm32(ch));
     }
-    
+
+#ifdef JIT_LITERAL_SCAN
+    template<size_t inlineCapacity>
+    bool canScanFor(const Vector<UChar, inlineCapacity>& characters)
+    {
+        if (characters.isEmpty() || !Options::useRegExpJITLiteralScan())
+            return false;
+        if (m_charSize == Char8) {
+            for (UChar ch : characters) {
+                if (ch > 0xff)
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    // Fills the vectors that scanForCharacters() compares the input against.
+    void loadScanCharacters(const UChar* characters, unsigned characterCount)
+    {
+#if CPU(X86_64)
+        ASSERT(characterCount <= 2);
+        for (unsigned i = 0; i < characterCount; ++i) {
+            FPRegisterID characterVector = i ? scanCharacterVector1 : scanCharacterVector0;
+            move(TrustedImm32(characters[i]), regT2);
+            if (m_charSize == Char8)
+                vectorSplatInt8x16(regT2, characterVector);
+            else
+                vectorSplatInt16x8(regT2, characterVector);
+        }
+#else
+        UNUSED_PARAM(characters);
+        UNUSED_PARAM(characterCount);
+#endif
+    }
+
+    // Advances position to the first index no greater than limit that holds one of the given
+    // characters, or jumps to notFound if there is none. limit must be less than length. On x86-64
+    // this compares 16 bytes of input at a time against the vectors filled by loadScanCharacters().
+    void scanForCharacters(RegisterID position, RegisterID limit, const UChar* characters, unsigned characterCount, JumpList& notFound)
+    {
+        Scale scale = m_charSize == Char8 ? TimesOne : TimesTwo;
+        JumpList found;
+
+#if CPU(X86_64)
+        unsigned charactersPerVector = m_charSize == Char8 ? 16 : 8;
+
+        Label vectorLoop(this);
+        move(position, regT2);
+        add32(TrustedImm32(charactersPerVector), regT2);
+        Jump notEnoughInputForVector = branch32(Above, regT2, length);
+        loadVector(BaseIndex(input, position, scale), scanInputVector);
+        moveVector(scanInputVector, scanMatchVector);
+        if (m_charSize == Char8)
+            vectorEqualInt8x16(scanCharacterVector0, scanMatchVector);
+        else
+            vectorEqualInt16x8(scanCharacterVector0, scanMatchVector);
+        if (characterCount > 1) {
+            if (m_charSize == Char8)
+                vectorEqualInt8x16(scanCharacterVector1, scanInputVector);
+            else
+                vectorEqualInt16x8(scanCharacterVector1, scanInputVector);
+            vectorOr(scanInputVector, scanMatchVector);
+        }
+        vectorMoveMaskInt8x16(scanMatchVector, regT2);
+        Jump foundInVector = branchTest32(NonZero, regT2);
+        add32(TrustedImm32(charactersPerVector), position);
+        branch32(BelowOrEqual, position, limit).linkTo(vectorLoop, this);
+        notFound.append(jump());
+
+        foundInVector.link(this);
+        countTrailingZeros32(regT2, regT2);
+        if (m_charSize != Char8)
+            urshift32(TrustedImm32(1), regT2);
+        add32(regT2, position);
+        notFound.append(branch32(Above, position, limit));
+        found.append(jump());
+
+        notEnoughInputForVector.link(this);
+#endif
+
+        Label characterLoop(this);
+        notFound.append(branch32(Above, position, limit));
+        if (m_charSize == Char8)
+            load8(BaseIndex(input, position, scale), regT2);
+        else
+            load16Unaligned(BaseIndex(input, position, scale), regT2);
+        for (unsigned i = 0; i < characterCount; ++i)
+            found.append(branch32(Equal, regT2, Imm32(characters[i])));
+        add32(TrustedImm32(1), position);
+        jump(characterLoop);
+
+        found.link(this);
+    }
+
+    // Returns failure straight away if the input after the start index doesn't contain the
+    // pattern's required literal. This is checked once per call, so it never scans further than
+    // a successful match would have to. It runs after the call frame has been set up.
+    void generateRequiredLiteralCheck()
+    {
+        const Vector<UChar>& literal = m_pattern.m_requiredLiteral;
+        Scale scale = m_charSize == Char8 ? TimesOne : TimesTwo;
+        int32_t characterSize = m_charSize == Char8 ? sizeof(LChar) : sizeof(UChar);
+
+        JumpList notFound;
+        notFound.append(branch32(Below, length, Imm32(literal.size())));
+        move(index, regT0);
+        move(length, regT1);
+        sub32(Imm32(literal.size()), regT1);
+        loadScanCharacters(literal.data(), 1);
+
+        Label tryNextCandidate(this);
+        scanForCharacters(regT0, regT1, literal.data(), 1, notFound);
+        JumpList mismatch;
+        for (unsigned i = 1; i < literal.size(); ++i) {
+            BaseIndex address(input, regT0, scale, i * characterSize);
+            if (m_charSize == Char8)
+                load8(address, regT2);
+            else
+                load16Unaligned(address, regT2);
+            mismatch.append(branch32(NotEqual, regT2, Imm32(literal[i])));
+        }
+        Jump found = jump();
+
+        mismatch.link(this);
+        add32(TrustedImm32(1), regT0);
+        jump(tryNextCandidate);
+
+        notFound.link(this);
+        removeCallFrame();
+        generateFailReturn();
+        found.link(this);
+    }
+
+    // Emitted at the head of the body's only alternative: moves the input position forwards to
+    // the next start index that holds one of the pattern's leading characters.
+    void generateLeadingCharacterScan(PatternAlternative* alternative)
+    {
+        unsigned minimumSize = alternative->m_minimumSize;
+        ASSERT(minimumSize);
+
+        move(index, regT0);
+        sub32(Imm32(minimumSize), regT0);
+        move(length, regT1);
+        sub32(Imm32(minimumSize), regT1);
+        scanForCharacters(regT0, regT1, m_pattern.m_leadingCharacters.data(), m_pattern.m_leadingCharacters.size(), m_leadingCharactersNotFound);
+
+        if (!m_pattern.m_body->m_hasFixedSize)
+            setMatchStart(regT0);
+        move(regT0, index);
+        add32(Imm32(minimumSize), index);
+    }
+#endif
+
     void storeToFrame(RegisterID reg, unsigned frameLocation)
     {
         poke(reg, frameLocation);
@@ -651,7 +866,7 @@ class YarrGenerator : private MacroAssembler {
 
         if (!m_hitMatchLimit.empty()) {
             m_hitMatchLimit.link(this);
-            move(TrustedImmPtr((void*)static_cast<size_t>(-1)), returnRegister);
+            move(TrustedImmPtr((void*)static_cast<size_t>(JSRegExpErrorHitLimit)), returnRegister);
         }
 
         finishExiting.link(this);
@@ -794,6 +1009,10 @@ class YarrGenerator : private MacroAssembler {
         // characters but matched.
         Jump m_zeroLengthMatch;
 
+        // Used by the end node of generic parentheses to record where backtracking
+        // continues into the alternatives of the most recent iteration.
+        Label m_backtrackIntoLastIteration;
+
         // This flag is used to null out the second pattern character, when
         // two are fused to match a pair together.
         bool m_isDeadCode;
@@ -1686,7 +1905,208 @@ class YarrGenerator : private MacroAssembler {
     {
         backtrackTermDefault(opIndex);
     }
-    
+
+#if CPU(ARM64) || CPU(X86_64)
+    // Backreferences compare the input against the text last captured by the referenced
+    // subpattern, one code unit at a time. The caller checks that the capture is set and
+    // not empty; captures the referencing term is nested inside of never get here (see
+    // opCompileAlternative), since those always match the empty string.
+    //
+    // Matches a single repetition of the backreference, advancing index past it. On failure
+    // we jump to failures with index pointing somewhere inside the repetition.
+    void matchBackReference(size_t opIndex, JumpList& failures, RegisterID character, RegisterID patternIndex, RegisterID patternCharacter)
+    {
+        YarrOp& op = m_ops[opIndex];
+        PatternTerm* term = op.m_term;
+        unsigned subpatternId = term->backReferenceSubpatternId;
+
+        Address patternStart(output, (subpatternId << 1) * sizeof(int));
+        Address patternEnd(output, ((subpatternId << 1) + 1) * sizeof(int));
+
+        // Check that the whole repetition is available.
+        load32(patternStart, patternIndex);
+        load32(patternEnd, patternCharacter);
+        sub32(patternIndex, patternCharacter);
+        add32(index, patternCharacter);
+        failures.append(branch32(Above, patternCharacter, length));
+
+        Label loop(this);
+        BaseIndex patternAddress(input, patternIndex, m_charSize == Char8 ? TimesOne : TimesTwo);
+        BaseIndex inputAddress = negativeOffsetIndexedAddress(m_checkedOffset - term->inputPosition, character);
+        if (m_charSize == Char8) {
+            load8(patternAddress, patternCharacter);
+            load8(inputAddress, character);
+        } else {
+            load16Unaligned(patternAddress, patternCharacter);
+            load16Unaligned(inputAddress, character);
+        }
+
+        JumpList charactersMatch;
+        charactersMatch.append(branch32(Equal, character, patternCharacter));
+        if (m_pattern.ignoreCase()) {
+            // Compare the canonical representatives of both characters. The table is indexed by
+            // code unit, so case insensitive matches of surrogate pairs are left to the interpreter.
+            pushToSave(patternIndex);
+            move(TrustedImmPtr(backReferenceCanonicalizationTable(m_canonicalMode)), patternIndex);
+            load16(BaseIndex(patternIndex, character, TimesTwo), character);
+            load16(BaseIndex(patternIndex, patternCharacter, TimesTwo), patternCharacter);
+            popToRestore(patternIndex);
+            charactersMatch.append(branch32(Equal, character, patternCharacter));
+
+            if (m_decodeSurrogatePairs) {
+                for (RegisterID reg : { character, patternCharacter }) {
+                    Jump notSurrogate = branch32(Below, reg, TrustedImm32(0xd800));
+                    m_abortExecution.append(branch32(BelowOrEqual, reg, TrustedImm32(0xdfff)));
+                    notSurrogate.link(this);
+                }
+            }
+        }
+        failures.append(jump());
+
+        charactersMatch.link(this);
+        add32(TrustedImm32(1), index);
+        add32(TrustedImm32(1), patternIndex);
+        branch32(NotEqual, patternIndex, patternEnd).linkTo(loop, this);
+    }
+
+    // Jumps to skip if the referenced subpattern did not participate in the match or captured the
+    // empty string, in which case the backreference matches the empty string.
+    void jumpIfBackReferenceIsEmpty(PatternTerm* term, JumpList& skip, RegisterID patternStart, RegisterID patternEnd)
+    {
+        unsigned subpatternId = term->backReferenceSubpatternId;
+
+        load32(Address(output, (subpatternId << 1) * sizeof(int)), patternStart);
+        skip.append(branch32(Equal, patternStart, TrustedImm32(-1)));
+        load32(Address(output, ((subpatternId << 1) + 1) * sizeof(int)), patternEnd);
+        skip.append(branch32(Equal, patternStart, patternEnd));
+    }
+
+    void generateBackReference(size_t opIndex)
+    {
+        YarrOp& op = m_ops[opIndex];
+        PatternTerm* term = op.m_term;
+
+        const RegisterID character = regT0;
+        const RegisterID patternIndex = regT1;
+        const RegisterID patternCharacter = regT2;
+        const RegisterID countRegister = regT1;
+
+        JumpList matched;
+
+        switch (term->quantityType) {
+        case QuantifierFixedCount: {
+            storeToFrame(index, term->frameLocation + BackTrackInfoBackReference::beginIndex());
+            jumpIfBackReferenceIsEmpty(term, matched, patternIndex, patternCharacter);
+
+            if (term->quantityMaxCount == 1) {
+                matchBackReference(opIndex, op.m_jumps, character, patternIndex, patternCharacter);
+                break;
+            }
+
+            storeToFrame(TrustedImm32(0), term->frameLocation + BackTrackInfoBackReference::matchAmountIndex());
+            Label loop(this);
+            matchBackReference(opIndex, op.m_jumps, character, patternIndex, patternCharacter);
+            loadFromFrame(term->frameLocation + BackTrackInfoBackReference::matchAmountIndex(), countRegister);
+            add32(TrustedImm32(1), countRegister);
+            storeToFrame(countRegister, term->frameLocation + BackTrackInfoBackReference::matchAmountIndex());
+            branch32(NotEqual, countRegister, Imm32(term->quantityMaxCount.unsafeGet())).linkTo(loop, this);
+            break;
+        }
+
+        case QuantifierGreedy: {
+            storeToFrame(TrustedImm32(0), term->frameLocation + BackTrackInfoBackReference::matchAmountIndex());
+            jumpIfBackReferenceIsEmpty(term, matched, patternIndex, patternCharacter);
+
+            // Match as many repetitions as we can. A partial repetition is undone by restoring
+            // the index recorded at its start.
+            JumpList incompleteMatch;
+            Label loop(this);
+            storeToFrame(index, term->frameLocation + BackTrackInfoBackReference::beginIndex());
+            matchBackReference(opIndex, incompleteMatch, character, patternIndex, patternCharacter);
+            loadFromFrame(term->frameLocation + BackTrackInfoBackReference::matchAmountIndex(), countRegister);
+            add32(TrustedImm32(1), countRegister);
+            storeToFrame(countRegister, term->frameLocation + BackTrackInfoBackReference::matchAmountIndex());
+            if (term->quantityMaxCount != quantifyInfinite) {
+                branch32(NotEqual, countRegister, Imm32(term->quantityMaxCount.unsafeGet())).linkTo(loop, this);
+                matched.append(jump());
+            } else
+                jump(loop);
+
+            incompleteMatch.link(this);
+            loadFromFrame(term->frameLocation + BackTrackInfoBackReference::beginIndex(), index);
+            break;
+        }
+
+        case QuantifierNonGreedy:
+            // Start out matching nothing; backtracking adds one repetition at a time.
+            storeToFrame(index, term->frameLocation + BackTrackInfoBackReference::beginIndex());
+            storeToFrame(TrustedImm32(0), term->frameLocation + BackTrackInfoBackReference::matchAmountIndex());
+            break;
+        }
+
+        matched.link(this);
+        op.m_reentry = label();
+    }
+    void backtrackBackReference(size_t opIndex)
+    {
+        YarrOp& op = m_ops[opIndex];
+        PatternTerm* term = op.m_term;
+
+        const RegisterID character = regT0;
+        const RegisterID patternIndex = regT1;
+        const RegisterID patternCharacter = regT2;
+        const RegisterID countRegister = regT0;
+
+        switch (term->quantityType) {
+        case QuantifierFixedCount:
+            m_backtrackingState.append(op.m_jumps);
+            m_backtrackingState.link(this);
+            loadFromFrame(term->frameLocation + BackTrackInfoBackReference::beginIndex(), index);
+            m_backtrackingState.fallthrough();
+            break;
+
+        case QuantifierGreedy: {
+            // Give back one repetition at a time.
+            m_backtrackingState.link(this);
+            loadFromFrame(term->frameLocation + BackTrackInfoBackReference::matchAmountIndex(), countRegister);
+            m_backtrackingState.append(branchTest32(Zero, countRegister));
+            sub32(TrustedImm32(1), countRegister);
+            storeToFrame(countRegister, term->frameLocation + BackTrackInfoBackReference::matchAmountIndex());
+
+            unsigned subpatternId = term->backReferenceSubpatternId;
+            load32(Address(output, ((subpatternId << 1) + 1) * sizeof(int)), patternCharacter);
+            sub32(Address(output, (subpatternId << 1) * sizeof(int)), patternCharacter);
+            sub32(patternCharacter, index);
+            jump(op.m_reentry);
+            break;
+        }
+
+        case QuantifierNonGreedy: {
+            // Take one more repetition, unless we already have the maximum or there is nothing to repeat.
+            JumpList nonGreedyFailures;
+
+            m_backtrackingState.link(this);
+            if (term->quantityMaxCount != quantifyInfinite) {
+                loadFromFrame(term->frameLocation + BackTrackInfoBackReference::matchAmountIndex(), countRegister);
+                nonGreedyFailures.append(branch32(Equal, countRegister, Imm32(term->quantityMaxCount.unsafeGet())));
+            }
+            jumpIfBackReferenceIsEmpty(term, nonGreedyFailures, patternIndex, patternCharacter);
+
+            matchBackReference(opIndex, nonGreedyFailures, character, patternIndex, patternCharacter);
+            loadFromFrame(term->frameLocation + BackTrackInfoBackReference::matchAmountIndex(), countRegister);
+            add32(TrustedImm32(1), countRegister);
+            storeToFrame(countRegister, term->frameLocation + BackTrackInfoBackReference::matchAmountIndex());
+            jump(op.m_reentry);
+
+            nonGreedyFailures.link(this);
+            loadFromFrame(term->frameLocation + BackTrackInfoBackReference::beginIndex(), index);
+            m_backtrackingState.fallthrough();
+            break;
+        }
+        }
+    }
+#endif
+
     // Code generation/backtracking for simple terms
     // (pattern characters, character classes, and assertions).
     // These methods farm out work to the set of functions above.
@@ -1749,7 +2169,11 @@ class YarrGenerator : private MacroAssembler {
         case PatternTerm::TypeParentheticalAssertion:
             RELEASE_ASSERT_NOT_REACHED();
         case PatternTerm::TypeBackReference:
-            m_shouldFallBack = true;
+#if CPU(ARM64) || CPU(X86_64)
+            generateBackReference(opIndex);
+#else
+            RELEASE_ASSERT_NOT_REACHED();
+#endif
             break;
         case PatternTerm::TypeDotStarEnclosure:
             generateDotStarEnclosure(opIndex);
@@ -1820,7 +2244,11 @@ class YarrGenerator : private MacroAssembler {
             break;
 
         case PatternTerm::TypeBackReference:
-            m_shouldFallBack = true;
+#if CPU(ARM64) || CPU(X86_64)
+            backtrackBackReference(opIndex);
+#else
+            RELEASE_ASSERT_NOT_REACHED();
+#endif
             break;
         }
     }
@@ -1870,6 +2298,10 @@ class YarrGenerator : private MacroAssembler {
                 // We will reenter after the check, and assume the input position to have been
                 // set as appropriate to this alternative.
                 op.m_reentry = label();
+#ifdef JIT_LITERAL_SCAN
+                if (m_scanForLeadingCharacters)
+                    generateLeadingCharacterScan(alternative);
+#endif
 
                 m_checkedOffset += alternative->m_minimumSize;
                 break;
@@ -1952,8 +2384,10 @@ class YarrGenerator : private MacroAssembler {
                 PatternDisjunction* disjunction = term->parentheses.disjunction;
 
                 // Calculate how much input we need to check for, and if non-zero check.
+                // Fixed count parentheses that match once have had their minimum size
+                // checked already; generic ones check their input on every iteration.
                 op.m_checkAdjust = Checked<unsigned>(alternative->m_minimumSize);
-                if ((term->quantityType == QuantifierFixedCount) && (term->type != PatternTerm::TypeParentheticalAssertion))
+                if ((term->quantityType == QuantifierFixedCount) && (term->quantityMaxCount == 1) && (term->type != PatternTerm::TypeParentheticalAssertion))
                     op.m_checkAdjust -= disjunction->m_minimumSize;
                 if (op.m_checkAdjust)
                     op.m_jumps.append(jumpIfNoAvailableInput(op.m_checkAdjust.unsafeGet()));
@@ -2000,7 +2434,7 @@ class YarrGenerator : private MacroAssembler {
 
                 // Calculate how much input we need to check for, and if non-zero check.
                 op.m_checkAdjust = alternative->m_minimumSize;
-                if ((term->quantityType == QuantifierFixedCount) && (term->type != PatternTerm::TypeParentheticalAssertion))
+                if ((term->quantityType == QuantifierFixedCount) && (term->quantityMaxCount == 1) && (term->type != PatternTerm::TypeParentheticalAssertion))
                     op.m_checkAdjust -= disjunction->m_minimumSize;
                 if (op.m_checkAdjust)
                     op.m_jumps.append(jumpIfNoAvailableInput(op.m_checkAdjust.unsafeGet()));
@@ -2177,43 +2611,44 @@ class YarrGenerator : private MacroAssembler {
                 PatternTerm* term = op.m_term;
                 unsigned parenthesesFrameLocation = term->frameLocation;
 
-                // Upon entry to a Greedy quantified set of parenthese store the index.
-                // We'll use this for two purposes:
-                //  - To indicate which iteration we are on of mathing the remainder of
-                //    the expression after the parentheses - the first, including the
-                //    match within the parentheses, or the second having skipped over them.
+                // Every iteration of generic parentheses pushes a ParenContext holding the
+                // state needed to backtrack out of it: the index at its start, the number of
+                // completed iterations and the captures and stack frame of the previous one.
+                //
+                // Upon entry to a set of parentheses we'll store the index in the frame at
+                // the start of each iteration. We'll use this for two purposes:
+                //  - To indicate whether we are matching the remainder of the expression
+                //    after the parentheses, or having skipped over them (-1).
                 //  - To check for empty matches, which must be rejected.
                 //
-                // At the head of a NonGreedy set of parentheses we'll immediately set the
-                // value on the stack to -1 (indicating a match skipping the subpattern),
-                // and plant a jump to the end. We'll also plant a label to backtrack to
-                // to reenter the subpattern later, with a store to set up index on the
-                // second iteration.
+                // At the head of a NonGreedy set of parentheses that may match nothing,
+                // we'll immediately set the value on the stack to -1 (indicating a match
+                // skipping the subpattern), and plant a jump to the end. Backtracking into
+                // the end will jump to the reentry label to run another iteration.
                 //
                 // FIXME: for capturing parens, could use the index in the capture array?
-                if (term->quantityType == QuantifierGreedy || term->quantityType == QuantifierNonGreedy) {
-                    storeToFrame(TrustedImm32(0), parenthesesFrameLocation + BackTrackInfoParentheses::matchAmountIndex());
-                    storeToFrame(TrustedImmPtr(0), parenthesesFrameLocation + BackTrackInfoParentheses::parenContextHeadIndex());
+                storeToFrame(TrustedImm32(0), parenthesesFrameLocation + BackTrackInfoParentheses::matchAmountIndex());
+                storeToFrame(TrustedImmPtr(0), parenthesesFrameLocation + BackTrackInfoParentheses::parenContextHeadIndex());
 
-                    if (term->quantityType == QuantifierNonGreedy) {
-                        storeToFrame(TrustedImm32(-1), parenthesesFrameLocation + BackTrackInfoParentheses::beginIndex());
-                        op.m_jumps.append(jump());
-                    }
-                    
-                    op.m_reentry = label();
-                    RegisterID currParenContextReg = regT0;
-                    RegisterID newParenContextReg = regT1;
-
-                    loadFromFrame(parenthesesFrameLocation + BackTrackInfoParentheses::parenContextHeadIndex(), currParenContextReg);
-                    allocateParenContext(newParenContextReg);
-                    storePtr(currParenContextReg, newParenContextReg);
-                    storeToFrame(newParenContextReg, parenthesesFrameLocation + BackTrackInfoParentheses::parenContextHeadIndex());
-                    saveParenContext(newParenContextReg, regT2, term->parentheses.subpatternId, term->parentheses.lastSubpatternId, parenthesesFrameLocation);
-                    storeToFrame(index, parenthesesFrameLocation + BackTrackInfoParentheses::beginIndex());
+                if (term->quantityType == QuantifierNonGreedy && !term->quantityMinCount) {
+                    storeToFrame(TrustedImm32(-1), parenthesesFrameLocation + BackTrackInfoParentheses::beginIndex());
+                    op.m_jumps.append(jump());
                 }
 
+                op.m_reentry = label();
+                RegisterID currParenContextReg = regT0;
+                RegisterID newParenContextReg = regT1;
+
+                loadFromFrame(parenthesesFrameLocation + BackTrackInfoParentheses::parenContextHeadIndex(), currParenContextReg);
+                allocateParenContext(newParenContextReg);
+                storePtr(currParenContextReg, newParenContextReg);
+                storeToFrame(newParenContextReg, parenthesesFrameLocation + BackTrackInfoParentheses::parenContextHeadIndex());
+                saveParenContext(newParenContextReg, regT2, term->parentheses.subpatternId, term->parentheses.lastSubpatternId, parenthesesFrameLocation);
+                storeToFrame(index, parenthesesFrameLocation + BackTrackInfoParentheses::beginIndex());
+
                 // If the parenthese are capturing, store the starting index value to the
-                // captures array, offsetting as necessary.
+                // captures array, offsetting as necessary. Unlike 'Once' parentheses, the
+                // minimum size of a fixed count is not checked before entering them.
                 //
                 // FIXME: could avoid offsetting this value in JIT code, apply
                 // offsets only afterwards, at the point the results array is
@@ -2221,8 +2656,6 @@ class YarrGenerator : private MacroAssembler {
                 if (term->capture() && compileMode == IncludeSubpatterns) {
                     const RegisterID indexTemporary = regT0;
                     unsigned inputOffset = (m_checkedOffset - term->inputPosition).unsafeGet();
-                    if (term->quantityType == QuantifierFixedCount)
-                        inputOffset += term->parentheses.disjunction->m_minimumSize;
                     if (inputOffset) {
                         move(index, indexTemporary);
                         sub32(Imm32(inputOffset), indexTemporary);
@@ -2274,19 +2707,23 @@ class YarrGenerator : private MacroAssembler {
                         setSubpatternEnd(index, term->parentheses.subpatternId);
                 }
 
-                // If the parentheses are quantified Greedy then add a label to jump back
-                // to if get a failed match from after the parentheses. For NonGreedy
-                // parentheses, link the jump from before the subpattern to here.
-                if (term->quantityType == QuantifierGreedy) {
+                // If the parentheses are quantified Greedy or have a fixed count, loop back
+                // for another iteration until we reach the maximum, and add a label to jump
+                // back to if get a failed match from after the parentheses. NonGreedy
+                // parentheses only loop until they reach their minimum; link the jump from
+                // before the subpattern to here.
+                if (term->quantityType == QuantifierNonGreedy) {
+                    if (term->quantityMinCount)
+                        branch32(Below, countTemporary, Imm32(term->quantityMinCount.unsafeGet())).linkTo(beginOp.m_reentry, this);
+                    else
+                        beginOp.m_jumps.link(this);
+                } else {
                     if (term->quantityMaxCount != quantifyInfinite)
                         branch32(Below, countTemporary, Imm32(term->quantityMaxCount.unsafeGet())).linkTo(beginOp.m_reentry, this);
                     else
                         jump(beginOp.m_reentry);
                     
                     op.m_reentry = label();
-                } else if (term->quantityType == QuantifierNonGreedy) {
-                    YarrOp& beginOp = m_ops[op.m_previousOp];
-                    beginOp.m_jumps.link(this);
                 }
 #else // !YARR_JIT_ALL_PARENS_EXPRESSIONS
                 RELEASE_ASSERT_NOT_REACHED();
@@ -2577,6 +3014,9 @@ class YarrGenerator : private MacroAssembler {
                     // We jump to here if we iterate to the point that there is insufficient input to
                     // run any matches, and need to return a failure state from JIT code.
                     matchFailed.link(this);
+#ifdef JIT_LITERAL_SCAN
+                    m_leadingCharactersNotFound.link(this);
+#endif
                 }
 
                 lastStickyAlternativeFailures.link(this);
@@ -2840,46 +3280,63 @@ class YarrGenerator : private MacroAssembler {
 #if ENABLE(YARR_JIT_ALL_PARENS_EXPRESSIONS)
                 PatternTerm* term = op.m_term;
                 unsigned parenthesesFrameLocation = term->frameLocation;
+                YarrOp& endOp = m_ops[op.m_nextOp];
 
-                if (term->quantityType != QuantifierFixedCount) {
-                    m_backtrackingState.link(this);
+                // We get here when an iteration fails to match. Pop its ParenContext,
+                // restoring the state from before it started.
+                m_backtrackingState.link(this);
 
-                    if (term->quantityType == QuantifierGreedy) {
-                        RegisterID currParenContextReg = regT0;
-                        RegisterID newParenContextReg = regT1;
+                RegisterID currParenContextReg = regT0;
+                RegisterID newParenContextReg = regT1;
 
-                        loadFromFrame(parenthesesFrameLocation + BackTrackInfoParentheses::parenContextHeadIndex(), currParenContextReg);
+                loadFromFrame(parenthesesFrameLocation + BackTrackInfoParentheses::parenContextHeadIndex(), currParenContextReg);
 
-                        restoreParenContext(currParenContextReg, regT2, term->parentheses.subpatternId, term->parentheses.lastSubpatternId, parenthesesFrameLocation);
+                restoreParenContext(currParenContextReg, regT2, term->parentheses.subpatternId, term->parentheses.lastSubpatternId, parenthesesFrameLocation);
 
-                        freeParenContext(currParenContextReg, newParenContextReg);
-                        storeToFrame(newParenContextReg, parenthesesFrameLocation + BackTrackInfoParentheses::parenContextHeadIndex());
-                        const RegisterID countTemporary = regT0;
-                        loadFromFrame(parenthesesFrameLocation + BackTrackInfoParentheses::matchAmountIndex(), countTemporary);
-                        Jump zeroLengthMatch = branchTest32(Zero, countTemporary);
+                freeParenContext(currParenContextReg, newParenContextReg);
+                storeToFrame(newParenContextReg, parenthesesFrameLocation + BackTrackInfoParentheses::parenContextHeadIndex());
+                const RegisterID countTemporary = regT0;
+                loadFromFrame(parenthesesFrameLocation + BackTrackInfoParentheses::matchAmountIndex(), countTemporary);
+                Jump zeroLengthMatch = branchTest32(Zero, countTemporary);
 
-                        sub32(TrustedImm32(1), countTemporary);
-                        storeToFrame(countTemporary, parenthesesFrameLocation + BackTrackInfoParentheses::matchAmountIndex());
+                sub32(TrustedImm32(1), countTemporary);
+                storeToFrame(countTemporary, parenthesesFrameLocation + BackTrackInfoParentheses::matchAmountIndex());
 
-                        jump(m_ops[op.m_nextOp].m_reentry);
+                // The last completed iteration started at the index saved in its context,
+                // which is now at the head of the list.
+                loadFromFrame(parenthesesFrameLocation + BackTrackInfoParentheses::parenContextHeadIndex(), newParenContextReg);
+                load32(Address(newParenContextReg, ParenContext::beginOffset()), newParenContextReg);
+                storeToFrame(newParenContextReg, parenthesesFrameLocation + BackTrackInfoParentheses::beginIndex());
 
-                        zeroLengthMatch.link(this);
+                // Greedy parentheses that have reached their minimum go on to match the
+                // remainder of the expression after the iterations completed so far. In all
+                // other cases, backtrack into the last completed iteration.
+                if (term->quantityType == QuantifierGreedy) {
+                    if (term->quantityMinCount)
+                        branch32(Below, countTemporary, Imm32((term->quantityMinCount - 1).unsafeGet())).linkTo(endOp.m_backtrackIntoLastIteration, this);
+                    jump(endOp.m_reentry);
+                } else
+                    jump(endOp.m_backtrackIntoLastIteration);
 
+                zeroLengthMatch.link(this);
+
+                // If no iterations completed, Greedy parentheses with a minimum count of zero
+                // match the remainder of the expression skipping the subpattern. Everything
+                // else backtracks out of the parentheses.
+                if (term->quantityType == QuantifierGreedy) {
+                    if (!term->quantityMinCount) {
                         // Clear the flag in the stackframe indicating we didn't run through the subpattern.
                         storeToFrame(TrustedImm32(-1), parenthesesFrameLocation + BackTrackInfoParentheses::beginIndex());
 
-                        jump(m_ops[op.m_nextOp].m_reentry);
-                    }
-
-                    // If Greedy, jump to the end.
-                    if (term->quantityType == QuantifierGreedy) {
-                        // A backtrack from after the parentheses, when skipping the subpattern,
-                        // will jump back to here.
-                        op.m_jumps.link(this);
+                        jump(endOp.m_reentry);
                     }
 
-                    m_backtrackingState.fallthrough();
+                    // A backtrack from after the parentheses, when skipping the subpattern,
+                    // will jump back to here.
+                    op.m_jumps.link(this);
                 }
+
+                m_backtrackingState.fallthrough();
 #else // !YARR_JIT_ALL_PARENS_EXPRESSIONS
                 RELEASE_ASSERT_NOT_REACHED();
 #endif
@@ -2888,34 +3345,37 @@ class YarrGenerator : private MacroAssembler {
             case OpParenthesesSubpatternEnd: {
 #if ENABLE(YARR_JIT_ALL_PARENS_EXPRESSIONS)
                 PatternTerm* term = op.m_term;
+                unsigned parenthesesFrameLocation = term->frameLocation;
+                YarrOp& beginOp = m_ops[op.m_previousOp];
 
-                if (term->quantityType != QuantifierFixedCount) {
-                    m_backtrackingState.link(this);
+                m_backtrackingState.link(this);
 
+                if (term->quantityType == QuantifierGreedy) {
                     // Check whether we should backtrack back into the parentheses, or if we
                     // are currently in a state where we had skipped over the subpattern
-                    // (in which case the flag value on the stack will be -1).
-                    unsigned parenthesesFrameLocation = term->frameLocation;
+                    // (in which case the flag value on the stack will be -1). For Greedy
+                    // parentheses, we skip after having already tried going through the
+                    // subpattern, so if we get here we're done.
                     Jump hadSkipped = branch32(Equal, Address(stackPointerRegister, (parenthesesFrameLocation  + BackTrackInfoParentheses::beginIndex()) * sizeof(void*)), TrustedImm32(-1));
-
-                    if (term->quantityType == QuantifierGreedy) {
-                        // For Greedy parentheses, we skip after having already tried going
-                        // through the subpattern, so if we get here we're done.
-                        YarrOp& beginOp = m_ops[op.m_previousOp];
-                        beginOp.m_jumps.append(hadSkipped);
-                    } else {
-                        // For NonGreedy parentheses, we try skipping the subpattern first,
-                        // so if we get here we need to try running through the subpattern
-                        // next. Jump back to the start of the parentheses in the forwards
-                        // matching path.
-                        ASSERT(term->quantityType == QuantifierNonGreedy);
-                        YarrOp& beginOp = m_ops[op.m_previousOp];
-                        hadSkipped.linkTo(beginOp.m_reentry, this);
-                    }
-
-                    m_backtrackingState.fallthrough();
+                    beginOp.m_jumps.append(hadSkipped);
+                } else if (term->quantityType == QuantifierNonGreedy) {
+                    // For NonGreedy parentheses, we try matching the remainder of the
+                    // expression first, so if we get here we need to try running through
+                    // the subpattern once more, unless we have reached the maximum. Jump
+                    // back to the start of the parentheses in the forwards matching path.
+                    if (term->quantityMaxCount != quantifyInfinite) {
+                        const RegisterID countTemporary = regT0;
+                        loadFromFrame(parenthesesFrameLocation + BackTrackInfoParentheses::matchAmountIndex(), countTemporary);
+                        branch32(Below, countTemporary, Imm32(term->quantityMaxCount.unsafeGet())).linkTo(beginOp.m_reentry, this);
+                    } else
+                        jump(beginOp.m_reentry);
                 }
 
+                // Backtrack into the alternatives of the last iteration. The begin node
+                // also jumps here after popping the context of an iteration that failed.
+                op.m_backtrackIntoLastIteration = label();
+                m_backtrackingState.fallthrough();
+
                 m_backtrackingState.append(op.m_jumps);
 #else // !YARR_JIT_ALL_PARENS_EXPRESSIONS
                 RELEASE_ASSERT_NOT_REACHED();
@@ -2984,7 +3444,7 @@ class YarrGenerator : private MacroAssembler {
     // the parentheses.
     // Supported types of parentheses are 'Once' (quantityMaxCount == 1),
     // 'Terminal' (non-capturing parentheses quantified as greedy
-    // and infinite), and 0 based greedy quantified parentheses.
+    // and infinite), and generic parentheses with any other quantifier.
     // Alternatives will use the 'Simple' set of ops if either the
     // subpattern is terminal (in which case we will never need to
     // backtrack), or if the subpattern only contains one alternative.
@@ -2996,19 +3456,7 @@ class YarrGenerator : private MacroAssembler {
         YarrOpCode alternativeNextOpCode = OpSimpleNestedAlternativeNext;
         YarrOpCode alternativeEndOpCode = OpSimpleNestedAlternativeEnd;
 
-        // We can currently only compile quantity 1 subpatterns that are
-        // not copies. We generate a copy in the case of a range quantifier,
-        // e.g. /(?:x){3,9}/, or /(?:x)+/ (These are effectively expanded to
-        // /(?:x){3,3}(?:x){0,6}/ and /(?:x)(?:x)*/ repectively). The problem
-        // comes where the subpattern is capturing, in which case we would
-        // need to restore the capture from the first subpattern upon a
-        // failure in the second.
-        if (term->quantityMinCount && term->quantityMinCount != term->quantityMaxCount) {
-            if (Options::dumpCompiledRegExpPatterns())
-                dataLogF("Can't JIT a variable counted parenthesis with a non-zero minimum\n");
-            m_shouldFallBack = true;
-            return;
-        } if (term->quantityMaxCount == 1 && !term->parentheses.isCopy) {
+        if (term->quantityMaxCount == 1 && !term->parentheses.isCopy) {
             // Select the 'Once' nodes.
             parenthesesBeginOpCode = OpParenthesesSubpatternOnceBegin;
             parenthesesEndOpCode = OpParenthesesSubpatternOnceEnd;
@@ -3025,9 +3473,14 @@ class YarrGenerator : private MacroAssembler {
             parenthesesEndOpCode = OpParenthesesSubpatternTerminalEnd;
         } else {
 #if ENABLE(YARR_JIT_ALL_PARENS_EXPRESSIONS)
-            // We only handle generic parenthesis with greedy counts.
-            if (term->quantityType != QuantifierGreedy) {
-                // This subpattern is not supported by the JIT.
+            // Range quantifiers with a non-zero minimum only get here when the pattern
+            // was too large to expand them into a fixed count and a copy quantified from
+            // zero. Iterations before the minimum is reached may match the empty string,
+            // but the nested alternatives reject zero length matches for any parentheses
+            // that aren't fixed count, so we can only handle these if that can't happen.
+            if (term->quantityMinCount && term->quantityType != QuantifierFixedCount && !term->parentheses.disjunction->m_minimumSize) {
+                if (Options::dumpCompiledRegExpPatterns())
+                    dataLogF("Can't JIT a variable counted parenthesis with a non-zero minimum that can match the empty string\n");
                 m_shouldFallBack = true;
                 return;
             }
@@ -3057,6 +3510,8 @@ class YarrGenerator : private MacroAssembler {
         m_ops.append(alternativeBeginOpCode);
         m_ops.last().m_previousOp = notFound;
         m_ops.last().m_term = term;
+        if (term->capture())
+            m_enclosingSubpatternIds.append(term->parentheses.subpatternId);
         Vector<std::unique_ptr<PatternAlternative>>& alternatives = term->parentheses.disjunction->m_alternatives;
         for (unsigned i = 0; i < alternatives.size(); ++i) {
             size_t lastOpIndex = m_ops.size() - 1;
@@ -3075,6 +3530,8 @@ class YarrGenerator : private MacroAssembler {
             thisOp.m_previousOp = lastOpIndex;
             thisOp.m_term = term;
         }
+        if (term->capture())
+            m_enclosingSubpatternIds.removeLast();
         YarrOp& lastOp = m_ops.last();
         ASSERT(lastOp.m_op == alternativeNextOpCode);
         lastOp.m_op = alternativeEndOpCode;
@@ -3161,6 +3618,22 @@ class YarrGenerator : private MacroAssembler {
                 opCompileParentheticalAssertion(term);
                 break;
 
+            case PatternTerm::TypeBackReference:
+                // A backreference nested inside of the subpattern it refers to always matches
+                // the empty string, so it doesn't need any code.
+                if (m_enclosingSubpatternIds.contains(term->backReferenceSubpatternId))
+                    break;
+#if CPU(ARM64) || CPU(X86_64)
+                // Match-only code doesn't record the captures we need; jitCompile() hands these
+                // patterns to the IncludeSubpatterns generator instead.
+                if (compileMode == MatchOnly)
+                    m_shouldFallBack = true;
+#else
+                m_shouldFallBack = true;
+#endif
+                m_ops.append(term);
+                break;
+
             default:
                 m_ops.append(term);
             }
@@ -3465,6 +3938,20 @@ public:
 #endif
         }
 
+        // The scans use regT1, which aliases freelistSizeRegister on some platforms, so they have to
+        // come after initParenContextFreeList().
+#ifdef JIT_LITERAL_SCAN
+        if (canScanFor(m_pattern.m_requiredLiteral))
+            generateRequiredLiteralCheck();
+
+        PatternDisjunction* body = m_pattern.m_body;
+        if (!m_pattern.sticky() && body->m_alternatives.size() == 1 && !body->m_alternatives[0]->onceThrough()
+            && body->m_alternatives[0]->m_minimumSize && canScanFor(m_pattern.m_leadingCharacters)) {
+            m_scanForLeadingCharacters = true;
+            loadScanCharacters(m_pattern.m_leadingCharacters.data(), m_pattern.m_leadingCharacters.size());
+        }
+#endif
+
         generate();
         backtrack();
 
@@ -3523,10 +4010,17 @@ private:
     JumpList m_hitMatchLimit;
     Vector<Call> m_tryReadUnicodeCharacterCalls;
     Label m_tryReadUnicodeCharacterEntry;
+#ifdef JIT_LITERAL_SCAN
+    bool m_scanForLeadingCharacters { false };
+    JumpList m_leadingCharactersNotFound;
+#endif
 
     // The regular expression expressed as a linear sequence of operations.
     Vector<YarrOp, 128> m_ops;
 
+    // The capturing subpatterns enclosing the alternative currently being compiled into m_ops.
+    Vector<unsigned, 8> m_enclosingSubpatternIds;
+
     // This records the current input offset being applied due to the current
     // set of alternatives we are nested within. E.g. when matching the
     // character 'b' within the regular expression /abc/, we will know that
@@ -3545,6 +4039,15 @@ private:
 
 void jitCompile(YarrPattern& pattern, YarrCharSize charSize, VM* vm, YarrCodeBlock& jitObject, YarrJITCompileMode mode)
 {
+    if (mode == MatchOnly && pattern.m_containsBackreferences) {
+        // Backreferences need the captures, which match-only code doesn't record. Share the
+        // code that does, and have match-only callers give it a scratch output vector.
+        if (charSize == Char8 ? !jitObject.has8BitCode() : !jitObject.has16BitCode())
+            YarrGenerator<IncludeSubpatterns>(vm, pattern, charSize).compile(jitObject);
+        jitObject.setMatchOnlyUsesSubpatternCode((pattern.m_numSubpatterns + 1) * 2);
+        return;
+    }
+
     if (mode == MatchOnly)
         YarrGenerator<MatchOnly>(vm, pattern, charSize).compile(jitObject);
     else
@@ -87,11 +87,15 @@ public:
     void set8BitCode(MacroAssemblerCodeRef ref) { m_ref8 = ref; }
     void set16BitCode(MacroAssemblerCodeRef ref) { m_ref16 = ref; }
 
-    bool has8BitCodeMatchOnly() { return m_matchOnly8.size(); }
-    bool has16BitCodeMatchOnly() { return m_matchOnly16.size(); }
+    bool has8BitCodeMatchOnly() { return m_matchOnly8.size() || (m_matchOnlyOutputSize && has8BitCode()); }
+    bool has16BitCodeMatchOnly() { return m_matchOnly16.size() || (m_matchOnlyOutputSize && has16BitCode()); }
     void set8BitCodeMatchOnly(MacroAssemblerCodeRef matchOnly) { m_matchOnly8 = matchOnly; }
     void set16BitCodeMatchOnly(MacroAssemblerCodeRef matchOnly) { m_matchOnly16 = matchOnly; }
 
+    // Patterns that need their captures to match, like those with backreferences, have no
+    // match-only code. Match-only callers run the regular code with a scratch output vector.
+    void setMatchOnlyUsesSubpatternCode(unsigned outputSize) { m_matchOnlyOutputSize = outputSize; }
+
 #if ENABLE(YARR_JIT_ALL_PARENS_EXPRESSIONS)
     bool usesPatternContextBuffer() { return m_usesPatternContextBuffer; }
     void setUsesPaternContextBuffer() { m_usesPatternContextBuffer = true; }
@@ -111,12 +115,20 @@ public:
     MatchResult execute(const LChar* input, unsigned start, unsigned length, void* freeParenContext, unsigned parenContextSize)
     {
         ASSERT(has8BitCodeMatchOnly());
+        if (m_matchOnlyOutputSize) {
+            Vector<int, 32> output(m_matchOnlyOutputSize);
+            return execute(input, start, length, output.data(), freeParenContext, parenContextSize);
+        }
         return MatchResult(reinterpret_cast<YarrJITCodeMatchOnly8>(m_matchOnly8.code().executableAddress())(input, start, length, 0, freeParenContext, parenContextSize));
     }
 
     MatchResult execute(const UChar* input, unsigned start, unsigned length, void* freeParenContext, unsigned parenContextSize)
     {
         ASSERT(has16BitCodeMatchOnly());
+        if (m_matchOnlyOutputSize) {
+            Vector<int, 32> output(m_matchOnlyOutputSize);
+            return execute(input, start, length, output.data(), freeParenContext, parenContextSize);
+        }
         return MatchResult(reinterpret_cast<YarrJITCodeMatchOnly16>(m_matchOnly16.code().executableAddress())(input, start, length, 0, freeParenContext, parenContextSize));
     }
 #else
@@ -135,12 +147,20 @@ public:
     MatchResult execute(const LChar* input, unsigned start, unsigned length)
     {
         ASSERT(has8BitCodeMatchOnly());
+        if (m_matchOnlyOutputSize) {
+            Vector<int, 32> output(m_matchOnlyOutputSize);
+            return execute(input, start, length, output.data());
+        }
         return MatchResult(reinterpret_cast<YarrJITCodeMatchOnly8>(m_matchOnly8.code().executableAddress())(input, start, length));
     }
 
     MatchResult execute(const UChar* input, unsigned start, unsigned length)
     {
         ASSERT(has16BitCodeMatchOnly());
+        if (m_matchOnlyOutputSize) {
+            Vector<int, 32> output(m_matchOnlyOutputSize);
+            return execute(input, start, length, output.data());
+        }
         return MatchResult(reinterpret_cast<YarrJITCodeMatchOnly16>(m_matchOnly16.code().executableAddress())(input, start, length));
     }
 #endif
@@ -190,6 +210,7 @@ public:
         m_ref16 = MacroAssemblerCodeRef();
         m_matchOnly8 = MacroAssemblerCodeRef();
         m_matchOnly16 = MacroAssemblerCodeRef();
+        m_matchOnlyOutputSize = 0;
         m_needFallBack = false;
     }
 
@@ -198,6 +219,7 @@ private:
     MacroAssemblerCodeRef m_ref16;
     MacroAssemblerCodeRef m_matchOnly8;
     MacroAssemblerCodeRef m_matchOnly16;
+    unsigned m_matchOnlyOutputSize { 0 };
     bool m_needFallBack;
 #if ENABLE(YARR_JIT_ALL_PARENS_EXPRESSIONS)
     bool m_usesPatternContextBuffer;
@@ -0,0 +1,610 @@
+/*
+ * Copyright (C) 2018 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "YarrLinearMatcher.h"
+
+#include "Yarr.h"
+#include <algorithm>
+#include <wtf/text/WTFString.h>
+
+namespace JSC { namespace Yarr {
+
+using OpCode = LinearPattern::OpCode;
+using Instruction = LinearPattern::Instruction;
+
+// Each pending thread keeps a copy of the output vector, so the size of the program times the number
+// of output slots bounds the memory used by a match.
+static const unsigned maximumInstructionCount = 4096;
+static const unsigned maximumThreadStateSize = 64 * 1024;
+
+LinearPattern::LinearPattern(Vector<Instruction>&& instructions, YarrPattern& pattern)
+    : m_instructions(WTFMove(instructions))
+    , m_flags(pattern.m_flags)
+    , m_numSubpatterns(pattern.m_numSubpatterns)
+{
+    m_instructions.shrinkToFit();
+
+    newlineCharacterClass = pattern.newlineCharacterClass();
+    if (unicode() && ignoreCase())
+        wordcharCharacterClass = pattern.wordUnicodeIgnoreCaseCharCharacterClass();
+    else
+        wordcharCharacterClass = pattern.wordcharCharacterClass();
+
+    m_userCharacterClasses.swap(pattern.m_userCharacterClasses);
+    m_userCharacterClasses.shrinkToFit();
+}
+
+class LinearCompiler {
+public:
+    LinearCompiler(YarrPattern& pattern)
+        : m_pattern(pattern)
+    {
+    }
+
+    std::unique_ptr<LinearPattern> compile()
+    {
+        if (m_pattern.m_containsBackreferences)
+            return nullptr;
+
+        // In unicode mode, the interpreter and the JIT can evaluate an assertion between the halves
+        // of a surrogate pair, which a matcher that reads whole code points never does.
+        if (m_pattern.unicode()) {
+            bool containsAssertion = false;
+            bool canMatchNonBMPCharacter = false;
+            scanDisjunction(m_pattern.m_body, containsAssertion, canMatchNonBMPCharacter);
+            if (containsAssertion && canMatchNonBMPCharacter)
+                return nullptr;
+        }
+
+        emitSaveInputPosition(0);
+        if (!emitDisjunction(m_pattern.m_body))
+            return nullptr;
+        emitSaveInputPosition(1);
+        emit(OpCode::Match);
+
+        if (m_instructions.size() * (m_pattern.m_numSubpatterns + 1) * 2 > maximumThreadStateSize)
+            return nullptr;
+
+        return std::make_unique<LinearPattern>(WTFMove(m_instructions), m_pattern);
+    }
+
+private:
+    unsigned emit(OpCode opCode)
+    {
+        m_instructions.append(Instruction(opCode));
+        return m_instructions.size() - 1;
+    }
+
+    bool programTooLarge() const { return m_instructions.size() > maximumInstructionCount; }
+
+    static bool characterClassCanMatchNonBMPCharacter(PatternTerm& term)
+    {
+        return term.invert() || term.characterClass->m_anyCharacter || term.characterClass->m_hasNonBMPCharacters;
+    }
+
+    static void scanDisjunction(PatternDisjunction* disjunction, bool& containsAssertion, bool& canMatchNonBMPCharacter)
+    {
+        for (auto& alternative : disjunction->m_alternatives) {
+            for (PatternTerm& term : alternative->m_terms) {
+                switch (term.type) {
+                case PatternTerm::TypeAssertionBOL:
+                case PatternTerm::TypeAssertionEOL:
+                case PatternTerm::TypeAssertionWordBoundary:
+                    containsAssertion = true;
+                    break;
+                case PatternTerm::TypePatternCharacter:
+                    if (!U_IS_BMP(term.patternCharacter))
+                        canMatchNonBMPCharacter = true;
+                    break;
+                case PatternTerm::TypeCharacterClass:
+                    if (characterClassCanMatchNonBMPCharacter(term))
+                        canMatchNonBMPCharacter = true;
+                    break;
+                case PatternTerm::TypeParenthesesSubpattern:
+                case PatternTerm::TypeParentheticalAssertion:
+                    scanDisjunction(term.parentheses.disjunction, containsAssertion, canMatchNonBMPCharacter);
+                    break;
+                default:
+                    break;
+                }
+            }
+        }
+    }
+
+    void emitSaveInputPosition(unsigned slot)
+    {
+        m_instructions[emit(OpCode::SaveInputPosition)].slot = slot;
+    }
+
+    void emitClearSubpatterns(unsigned firstSubpatternId, unsigned lastSubpatternId)
+    {
+        Instruction& instruction = m_instructions[emit(OpCode::ClearSubpatterns)];
+        instruction.slot = firstSubpatternId;
+        instruction.lastSubpatternId = lastSubpatternId;
+    }
+
+    unsigned emitJump(unsigned target = 0)
+    {
+        unsigned jump = emit(OpCode::Jump);
+        m_instructions[jump].target = target;
+        return jump;
+    }
+
+    // The split tries the atom that follows it first when preferAtom is set, and the
+    // code after the atom first otherwise. linkSplitExit() fills in the latter.
+    unsigned emitSplit(bool preferAtom)
+    {
+        unsigned split = emit(OpCode::Split);
+        if (preferAtom)
+            m_instructions[split].target = split + 1;
+        else
+            m_instructions[split].alternativeTarget = split + 1;
+        return split;
+    }
+
+    void linkSplitExit(unsigned split)
+    {
+        Instruction& instruction = m_instructions[split];
+        if (instruction.target == split + 1)
+            instruction.alternativeTarget = m_instructions.size();
+        else
+            instruction.target = m_instructions.size();
+    }
+
+    bool emitDisjunction(PatternDisjunction* disjunction)
+    {
+        Vector<unsigned> jumpsToEnd;
+        auto& alternatives = disjunction->m_alternatives;
+        for (unsigned i = 0; i < alternatives.size(); ++i) {
+            bool isLastAlternative = i + 1 == alternatives.size();
+            unsigned split = isLastAlternative ? 0 : emitSplit(true);
+
+            for (PatternTerm& term : alternatives[i]->m_terms) {
+                if (!emitTerm(term) || programTooLarge())
+                    return false;
+            }
+
+            if (!isLastAlternative) {
+                jumpsToEnd.append(emitJump());
+                linkSplitExit(split);
+            }
+        }
+
+        for (unsigned jump : jumpsToEnd)
+            m_instructions[jump].target = m_instructions.size();
+        return true;
+    }
+
+    template<typename EmitAtomFunctor>
+    bool emitQuantified(PatternTerm& term, const EmitAtomFunctor& emitAtom)
+    {
+        unsigned maxCount = term.quantityMaxCount.unsafeGet();
+        unsigned minCount = term.quantityType == QuantifierFixedCount ? maxCount : term.quantityMinCount.unsafeGet();
+        bool greedy = term.quantityType == QuantifierGreedy;
+
+        for (unsigned i = 0; i < minCount; ++i) {
+            if (!emitAtom() || programTooLarge())
+                return false;
+        }
+
+        if (maxCount == quantifyInfinite) {
+            unsigned split = emitSplit(greedy);
+            if (!emitAtom())
+                return false;
+            emitJump(split);
+            linkSplitExit(split);
+            return true;
+        }
+
+        Vector<unsigned> splits;
+        for (unsigned i = minCount; i < maxCount; ++i) {
+            splits.append(emitSplit(greedy));
+            if (!emitAtom() || programTooLarge())
+                return false;
+        }
+        for (unsigned split : splits)
+            linkSplitExit(split);
+        return true;
+    }
+
+    bool emitTerm(PatternTerm& term)
+    {
+        switch (term.type) {
+        case PatternTerm::TypeAssertionBOL:
+            emit(OpCode::AssertionBOL);
+            return true;
+
+        case PatternTerm::TypeAssertionEOL:
+            emit(OpCode::AssertionEOL);
+            return true;
+
+        case PatternTerm::TypeAssertionWordBoundary:
+            m_instructions[emit(OpCode::AssertionWordBoundary)].invert = term.invert();
+            return true;
+
+        case PatternTerm::TypePatternCharacter: {
+            // Case-insensitive characters with more than two forms were turned into character
+            // classes by the YarrPattern. Like the interpreter, compare the rest against both cases.
+            UChar32 character = term.patternCharacter;
+            UChar32 lowerCase = character;
+            UChar32 upperCase = character;
+            if (m_pattern.ignoreCase()) {
+                lowerCase = u_tolower(character);
+                upperCase = u_toupper(character);
+            }
+            return emitQuantified(term, [&] {
+                if (lowerCase != upperCase) {
+                    Instruction& instruction = m_instructions[emit(OpCode::CasedCharacter)];
+                    instruction.character = lowerCase;
+                    instruction.otherCaseCharacter = upperCase;
+                } else
+                    m_instructions[emit(OpCode::Character)].character = character;
+                return true;
+            });
+        }
+
+        case PatternTerm::TypeCharacterClass:
+            // Fixed-count classes step over the input one code unit per iteration in the
+            // interpreter and the JIT, even when an iteration matched a surrogate pair.
+            if (m_pattern.unicode() && term.quantityType == QuantifierFixedCount && term.quantityMaxCount.unsafeGet() > 1
+                && characterClassCanMatchNonBMPCharacter(term))
+                return false;
+            return emitQuantified(term, [&] {
+                Instruction& instruction = m_instructions[emit(OpCode::CharacterClass)];
+                instruction.characterClass = term.characterClass;
+                instruction.invert = term.invert();
+                return true;
+            });
+
+        case PatternTerm::TypeForwardReference:
+            // A reference to a group that hasn't matched yet always matches the empty string.
+            return true;
+
+        case PatternTerm::TypeParenthesesSubpattern:
+            return emitParentheses(term);
+
+        case PatternTerm::TypeBackReference:
+        case PatternTerm::TypeParentheticalAssertion:
+        case PatternTerm::TypeDotStarEnclosure:
+            return false;
+        }
+
+        RELEASE_ASSERT_NOT_REACHED();
+        return false;
+    }
+
+    bool emitParentheses(PatternTerm& term)
+    {
+        PatternDisjunction* disjunction = term.parentheses.disjunction;
+
+        // Yarr fails an iteration that matched the empty string, unless the iteration was required.
+        // A Pike VM can't tell threads apart by where their current iteration started.
+        if (term.quantityType != QuantifierFixedCount && !disjunction->m_minimumSize)
+            return false;
+
+        unsigned subpatternId = term.parentheses.subpatternId;
+        unsigned lastSubpatternId = term.parentheses.lastSubpatternId;
+        bool capture = term.capture();
+        bool isOnce = term.quantityMaxCount.unsafeGet() == 1 && !term.parentheses.isCopy;
+        auto emitContents = [&] {
+            // Every iteration of parentheses that can repeat starts with their captures cleared.
+            if (!isOnce && lastSubpatternId >= subpatternId)
+                emitClearSubpatterns(subpatternId, lastSubpatternId);
+            if (capture)
+                emitSaveInputPosition(subpatternId << 1);
+            if (!emitDisjunction(disjunction))
+                return false;
+            if (capture)
+                emitSaveInputPosition((subpatternId << 1) + 1);
+            return true;
+        };
+
+        if (capture && isOnce && term.quantityType == QuantifierGreedy) {
+            // When the interpreter and the JIT backtrack out of a greedy (...)?, they clear its
+            // captures, including those left by earlier iterations of an enclosing quantifier.
+            unsigned split = emitSplit(true);
+            if (!emitContents())
+                return false;
+            unsigned jumpToEnd = emitJump();
+            linkSplitExit(split);
+            emitClearSubpatterns(subpatternId, subpatternId);
+            m_instructions[jumpToEnd].target = m_instructions.size();
+            return true;
+        }
+
+        return emitQuantified(term, emitContents);
+    }
+
+    YarrPattern& m_pattern;
+    Vector<Instruction> m_instructions;
+};
+
+static bool testCharacterClass(const CharacterClass* characterClass, UChar32 character)
+{
+    if (characterClass->m_anyCharacter)
+        return true;
+
+    bool isASCIICharacter = isASCII(character);
+    const Vector<UChar32>& matches = isASCIICharacter ? characterClass->m_matches : characterClass->m_matchesUnicode;
+    if (std::binary_search(matches.begin(), matches.end(), character))
+        return true;
+
+    const Vector<CharacterRange>& ranges = isASCIICharacter ? characterClass->m_ranges : characterClass->m_rangesUnicode;
+    auto range = std::upper_bound(ranges.begin(), ranges.end(), character, [] (UChar32 character, const CharacterRange& range) {
+        return character < range.begin;
+    });
+    return range != ranges.begin() && character <= (range - 1)->end;
+}
+
+template<typename CharType>
+class LinearMatcher {
+public:
+    LinearMatcher(LinearPattern* pattern, const CharType* input, unsigned length, unsigned start, unsigned* output)
+        : m_pattern(*pattern)
+        , m_input(input)
+        , m_length(length)
+        , m_start(start)
+        , m_output(output)
+        , m_outputSize((pattern->m_numSubpatterns + 1) * 2)
+    {
+        for (ThreadList& threads : m_threadLists)
+            threads.initialize(pattern->m_instructions.size(), m_outputSize);
+        m_captures.grow(m_outputSize);
+    }
+
+    unsigned match()
+    {
+        for (unsigned i = 0; i < m_outputSize; ++i)
+            m_output[i] = offsetNoMatch;
+
+        bool matched = false;
+        for (unsigned position = m_start; position <= m_length; ++position) {
+            ThreadList& threads = threadListAt(position);
+
+            // Threads started at later positions have a lower priority, so stop starting
+            // them once something matched.
+            bool canStartThread = !matched && (position == m_start || !m_pattern.sticky());
+            if (canStartThread) {
+                for (unsigned i = 0; i < m_outputSize; ++i)
+                    m_captures[i] = offsetNoMatch;
+                addThread(threads, 0, position);
+            } else if (threads.isEmpty() && threadListAt(position + 1).isEmpty())
+                break;
+
+            UChar32 character = 0;
+            unsigned width = 0;
+            if (position < m_length)
+                readCharacter(position, character, width);
+
+            for (unsigned i = 0; i < threads.size(); ++i) {
+                unsigned pc = threads.instructionAt(i);
+                const Instruction& instruction = m_pattern.m_instructions[pc];
+                if (instruction.opCode == OpCode::Match) {
+                    // Anything after this thread in the list has a lower priority.
+                    memcpy(m_output, threads.capturesAt(i), m_outputSize * sizeof(unsigned));
+                    matched = true;
+                    break;
+                }
+
+                if (!width || !matchesCharacter(instruction, character))
+                    continue;
+
+                memcpy(m_captures.data(), threads.capturesAt(i), m_outputSize * sizeof(unsigned));
+                addThread(threadListAt(position + width), pc + 1, position + width);
+            }
+
+            threads.clear();
+        }
+
+        return m_output[0];
+    }
+
+private:
+    // A sparse set of instructions reached at one input position, in priority order, with the
+    // captures of the thread that reached each of them.
+    class ThreadList {
+    public:
+        void initialize(unsigned instructionCount, unsigned outputSize)
+        {
+            m_outputSize = outputSize;
+            m_indexOfInstruction.grow(instructionCount);
+            m_instructions.reserveInitialCapacity(instructionCount);
+            m_captures.grow(instructionCount * outputSize);
+        }
+
+        bool isEmpty() const { return m_instructions.isEmpty(); }
+        unsigned size() const { return m_instructions.size(); }
+        unsigned instructionAt(unsigned index) const { return m_instructions[index]; }
+        unsigned* capturesAt(unsigned index) { return m_captures.data() + index * m_outputSize; }
+
+        bool contains(unsigned pc) const
+        {
+            unsigned index = m_indexOfInstruction[pc];
+            return index < m_instructions.size() && m_instructions[index] == pc;
+        }
+
+        unsigned add(unsigned pc)
+        {
+            m_indexOfInstruction[pc] = m_instructions.size();
+            m_instructions.append(pc);
+            return m_instructions.size() - 1;
+        }
+
+        void clear() { m_instructions.shrink(0); }
+
+    private:
+        unsigned m_outputSize { 0 };
+        Vector<unsigned> m_indexOfInstruction;
+        Vector<unsigned> m_instructions;
+        Vector<unsigned> m_captures;
+    };
+
+    // A pending alternative of a Split, or a capture to restore once the
+    // instructions after a SaveInputPosition have been explored.
+    struct PendingWork {
+        unsigned pc;
+        unsigned slot;
+        unsigned savedValue;
+    };
+    static const unsigned noSlot = UINT_MAX;
+
+    ThreadList& threadListAt(unsigned position) { return m_threadLists[position % 3]; }
+
+    void readCharacter(unsigned position, UChar32& character, unsigned& width)
+    {
+        character = m_input[position];
+        width = 1;
+        if (m_pattern.unicode() && U16_IS_LEAD(character) && position + 1 < m_length && U16_IS_TRAIL(m_input[position + 1])) {
+            character = U16_GET_SUPPLEMENTARY(character, m_input[position + 1]);
+            width = 2;
+        }
+    }
+
+    bool matchesCharacter(const Instruction& instruction, UChar32 character)
+    {
+        switch (instruction.opCode) {
+        case OpCode::Character:
+            return character == instruction.character;
+        case OpCode::CasedCharacter:
+            return character == instruction.character || character == instruction.otherCaseCharacter;
+        case OpCode::CharacterClass:
+            return testCharacterClass(instruction.characterClass, character) != instruction.invert;
+        default:
+            return false;
+        }
+    }
+
+    bool matchesAssertion(const Instruction& instruction, unsigned position)
+    {
+        switch (instruction.opCode) {
+        case OpCode::AssertionBOL:
+            return !position || (m_pattern.multiline() && testCharacterClass(m_pattern.newlineCharacterClass, m_input[position - 1]));
+        case OpCode::AssertionEOL:
+            return position == m_length || (m_pattern.multiline() && testCharacterClass(m_pattern.newlineCharacterClass, m_input[position]));
+        case OpCode::AssertionWordBoundary: {
+            bool previousIsWordchar = position && testCharacterClass(m_pattern.wordcharCharacterClass, m_input[position - 1]);
+            bool nextIsWordchar = position < m_length && testCharacterClass(m_pattern.wordcharCharacterClass, m_input[position]);
+            return (previousIsWordchar != nextIsWordchar) != instruction.invert;
+        }
+        default:
+            RELEASE_ASSERT_NOT_REACHED();
+            return false;
+        }
+    }
+
+    void saveCapture(unsigned slot, unsigned value)
+    {
+        m_pendingWork.append({ 0, slot, m_captures[slot] });
+        m_captures[slot] = value;
+    }
+
+    // Follows the instructions that don't consume input, in priority order, and adds every thread
+    // that is waiting on a character or has matched. The first thread to reach an instruction
+    // at a given position wins; the ones that get there later would behave the same from there on.
+    void addThread(ThreadList& threads, unsigned startPC, unsigned position)
+    {
+        m_pendingWork.append({ startPC, noSlot, 0 });
+        while (!m_pendingWork.isEmpty()) {
+            PendingWork work = m_pendingWork.takeLast();
+            if (work.slot != noSlot) {
+                m_captures[work.slot] = work.savedValue;
+                continue;
+            }
+
+            for (unsigned pc = work.pc; !threads.contains(pc);) {
+                unsigned index = threads.add(pc);
+                const Instruction& instruction = m_pattern.m_instructions[pc];
+                switch (instruction.opCode) {
+                case OpCode::Jump:
+                    pc = instruction.target;
+                    continue;
+                case OpCode::Split:
+                    m_pendingWork.append({ instruction.alternativeTarget, noSlot, 0 });
+                    pc = instruction.target;
+                    continue;
+                case OpCode::SaveInputPosition:
+                    saveCapture(instruction.slot, position);
+                    ++pc;
+                    continue;
+                case OpCode::ClearSubpatterns:
+                    for (unsigned slot = instruction.slot << 1; slot < (instruction.lastSubpatternId + 1) << 1; ++slot)
+                        saveCapture(slot, offsetNoMatch);
+                    ++pc;
+                    continue;
+                case OpCode::AssertionBOL:
+                case OpCode::AssertionEOL:
+                case OpCode::AssertionWordBoundary:
+                    if (!matchesAssertion(instruction, position))
+                        break;
+                    ++pc;
+                    continue;
+                case OpCode::Character:
+                case OpCode::CasedCharacter:
+                case OpCode::CharacterClass:
+                case OpCode::Match:
+                    memcpy(threads.capturesAt(index), m_captures.data(), m_outputSize * sizeof(unsigned));
+                    break;
+                }
+                break;
+            }
+        }
+    }
+
+    LinearPattern& m_pattern;
+    const CharType* m_input;
+    unsigned m_length;
+    unsigned m_start;
+    unsigned* m_output;
+    unsigned m_outputSize;
+
+    ThreadList m_threadLists[3];
+    Vector<unsigned> m_captures;
+    Vector<PendingWork, 16> m_pendingWork;
+};
+
+std::unique_ptr<LinearPattern> linearCompile(YarrPattern& pattern)
+{
+    return LinearCompiler(pattern).compile();
+}
+
+unsigned linearMatch(LinearPattern* pattern, const String& input, unsigned start, unsigned* output)
+{
+    if (input.is8Bit())
+        return LinearMatcher<LChar>(pattern, input.characters8(), input.length(), start, output).match();
+    return LinearMatcher<UChar>(pattern, input.characters16(), input.length(), start, output).match();
+}
+
+unsigned linearMatch(LinearPattern* pattern, const LChar* input, unsigned length, unsigned start, unsigned* output)
+{
+    return LinearMatcher<LChar>(pattern, input, length, start, output).match();
+}
+
+unsigned linearMatch(LinearPattern* pattern, const UChar* input, unsigned length, unsigned start, unsigned* output)
+{
+    return LinearMatcher<UChar>(pattern, input, length, start, output).match();
+}
+
+} } // namespace JSC::Yarr
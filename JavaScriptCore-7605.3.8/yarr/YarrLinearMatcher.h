@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2018 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "YarrPattern.h"
+#include <wtf/Vector.h>
+
+namespace JSC { namespace Yarr {
+
+// A LinearPattern is a YarrPattern compiled for a Pike VM. Instead of backtracking, the matcher runs
+// every thread of the pattern in lock step over the input, and drops a thread as soon as a thread with
+// higher priority reaches the same instruction at the same position. Matching time is bounded by the
+// length of the input times the size of the program, so RegExps fall back to it when backtracking
+// exceeds its step budget. Thread priorities follow the order in which Yarr backtracks, so matches and
+// captures come out the same as with the JIT or the interpreter.
+//
+// Patterns with backreferences or lookarounds cannot be matched without backtracking. Neither can
+// quantified parentheses whose contents can match the empty string, since Yarr rejects empty
+// iterations based on where each iteration started. linearCompile() returns nullptr for these.
+class LinearPattern {
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    enum class OpCode : uint8_t {
+        Character,
+        CasedCharacter,
+        CharacterClass,
+        AssertionBOL,
+        AssertionEOL,
+        AssertionWordBoundary,
+        Split,
+        Jump,
+        SaveInputPosition,
+        ClearSubpatterns,
+        Match,
+    };
+
+    struct Instruction {
+        Instruction(OpCode opCode)
+            : opCode(opCode)
+        {
+        }
+
+        OpCode opCode;
+        bool invert { false };
+        UChar32 character { 0 }; // Character, or the lower case form of a CasedCharacter.
+        UChar32 otherCaseCharacter { 0 };
+        CharacterClass* characterClass { nullptr };
+        unsigned target { 0 }; // Jump, and the preferred successor of a Split.
+        unsigned alternativeTarget { 0 };
+        unsigned slot { 0 }; // Output slot for SaveInputPosition, first subpattern id for ClearSubpatterns.
+        unsigned lastSubpatternId { 0 };
+    };
+
+    LinearPattern(Vector<Instruction>&& instructions, YarrPattern&);
+
+    size_t estimatedSizeInBytes() const { return m_instructions.capacity() * sizeof(Instruction); }
+
+    bool ignoreCase() const { return m_flags & FlagIgnoreCase; }
+    bool multiline() const { return m_flags & FlagMultiline; }
+    bool sticky() const { return m_flags & FlagSticky; }
+    bool unicode() const { return m_flags & FlagUnicode; }
+
+    Vector<Instruction> m_instructions;
+    RegExpFlags m_flags;
+    unsigned m_numSubpatterns;
+
+    CharacterClass* newlineCharacterClass;
+    CharacterClass* wordcharCharacterClass;
+
+private:
+    Vector<std::unique_ptr<CharacterClass>> m_userCharacterClasses;
+};
+
+JS_EXPORT_PRIVATE std::unique_ptr<LinearPattern> linearCompile(YarrPattern&);
+JS_EXPORT_PRIVATE unsigned linearMatch(LinearPattern*, const String& input, unsigned start, unsigned* output);
+unsigned linearMatch(LinearPattern*, const LChar* input, unsigned length, unsigned start, unsigned* output);
+unsigned linearMatch(LinearPattern*, const UChar* input, unsigned length, unsigned start, unsigned* output);
+
+} } // namespace JSC::Yarr
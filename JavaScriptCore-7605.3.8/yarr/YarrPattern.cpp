@@ -1064,7 +1064,94 @@ public:
         }
     }
 
+    // Find characters that the JIT can scan for before running the body of the pattern. Only
+    // patterns with a single top-level alternative are considered; for these, every match must
+    // begin with one of the alternative's leading characters, and must contain any run of literal
+    // characters that appears at its top level.
+    void findScanLiterals()
+    {
+        Vector<std::unique_ptr<PatternAlternative>>& alternatives = m_pattern.m_body->m_alternatives;
+        if (alternatives.size() != 1)
+            return;
+
+        PatternAlternative* alternative = alternatives[0].get();
+        Vector<PatternTerm>& terms = alternative->m_terms;
+
+        // A dot star enclosure moves the start of the match back to the beginning of the line.
+        if (!alternative->onceThrough() && (terms.isEmpty() || terms.last().type != PatternTerm::TypeDotStarEnclosure)) {
+            if (!collectLeadingCharacters(alternative, m_pattern.m_leadingCharacters))
+                m_pattern.m_leadingCharacters.clear();
+        }
+
+        Vector<UChar> literal;
+        auto finishLiteral = [&] {
+            if (literal.size() > m_pattern.m_requiredLiteral.size())
+                m_pattern.m_requiredLiteral = literal;
+            literal.shrink(0);
+        };
+
+        for (PatternTerm& term : terms) {
+            if (term.type != PatternTerm::TypePatternCharacter
+                || term.quantityType != QuantifierFixedCount
+                || !isScannableCharacter(term.patternCharacter)
+                || (m_pattern.ignoreCase() && isASCIIAlpha(term.patternCharacter))) {
+                finishLiteral();
+                continue;
+            }
+
+            for (unsigned i = 0; i < term.quantityMaxCount.unsafeGet() && literal.size() < maximumRequiredLiteralLength; ++i)
+                literal.append(term.patternCharacter);
+        }
+        finishLiteral();
+    }
+
 private:
+    static const unsigned maximumLeadingCharacters = 2;
+    static const unsigned maximumRequiredLiteralLength = 32;
+
+    static bool isScannableCharacter(UChar32 ch)
+    {
+        return U_IS_BMP(ch) && !U16_IS_SURROGATE(ch);
+    }
+
+    bool collectLeadingCharacters(PatternAlternative* alternative, Vector<UChar, 2>& characters)
+    {
+        if (alternative->m_terms.isEmpty())
+            return false;
+
+        PatternTerm& term = alternative->m_terms[0];
+        if (!term.quantityMinCount)
+            return false;
+
+        switch (term.type) {
+        case PatternTerm::TypePatternCharacter: {
+            UChar32 ch = term.patternCharacter;
+            if (!isScannableCharacter(ch))
+                return false;
+            // Case insensitive non-ASCII characters with more than one case are turned into
+            // character classes, so only ASCII letters need both of their cases here.
+            if (m_pattern.ignoreCase() && isASCIIAlpha(ch)) {
+                characters.appendIfNotContains(toASCIILower(ch));
+                characters.appendIfNotContains(toASCIIUpper(ch));
+            } else
+                characters.appendIfNotContains(ch);
+            return characters.size() <= maximumLeadingCharacters;
+        }
+
+        case PatternTerm::TypeParenthesesSubpattern: {
+            PatternDisjunction* disjunction = term.parentheses.disjunction;
+            for (auto& nestedAlternative : disjunction->m_alternatives) {
+                if (!collectLeadingCharacters(nestedAlternative.get(), characters))
+                    return false;
+            }
+            return true;
+        }
+
+        default:
+            return false;
+        }
+    }
+
     bool isSafeToRecurse() const
     {
         if (!m_stackLimit)
@@ -1115,6 +1202,7 @@ ErrorCode YarrPattern::compile(const String& patternString, void* stackLimit)
     constructor.checkForTerminalParentheses();
     constructor.optimizeDotStarWrappedExpressions();
     constructor.optimizeBOL();
+    constructor.findScanLiterals();
 
     {
         ErrorCode error = constructor.setupOffsets();
@@ -1494,6 +1582,20 @@ void YarrPattern::dumpPattern(PrintStream& out, const String& patternString)
     out.print(":\n");
     if (m_body->m_callFrameSize)
         out.print("    callframe size: ", m_body->m_callFrameSize, "\n");
+    if (!m_leadingCharacters.isEmpty()) {
+        out.print("    leading characters:");
+        for (UChar ch : m_leadingCharacters) {
+            out.print(" ");
+            dumpUChar32(out, ch);
+        }
+        out.print("\n");
+    }
+    if (!m_requiredLiteral.isEmpty()) {
+        out.print("    required literal: ");
+        for (UChar ch : m_requiredLiteral)
+            dumpUChar32(out, ch);
+        out.print("\n");
+    }
     m_body->dump(out, this);
 }
 
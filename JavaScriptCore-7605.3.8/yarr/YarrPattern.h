@@ -381,6 +381,8 @@ struct YarrPattern {
         m_disjunctions.clear();
         m_userCharacterClasses.clear();
         m_captureGroupNames.shrink(0);
+        m_leadingCharacters.clear();
+        m_requiredLiteral.clear();
     }
 
     bool containsIllegalBackReference()
@@ -514,6 +516,11 @@ struct YarrPattern {
     Vector<String> m_captureGroupNames;
     HashMap<String, unsigned> m_namedGroupToParenIndex;
 
+    // Facts the JIT uses to skip over input that cannot contain a match. Every match starts with one
+    // of m_leadingCharacters (when it is not empty), and contains m_requiredLiteral.
+    Vector<UChar, 2> m_leadingCharacters;
+    Vector<UChar> m_requiredLiteral;
+
 private:
     ErrorCode compile(const String& patternString, void* stackLimit);
 
@@ -554,8 +561,8 @@ private:
         uintptr_t begin; // Not really needed for greedy quantifiers.
         uintptr_t matchAmount; // Not really needed for fixed quantifiers.
 
-        unsigned beginIndex() { return offsetof(BackTrackInfoBackReference, begin) / sizeof(uintptr_t); }
-        unsigned matchAmountIndex() { return offsetof(BackTrackInfoBackReference, matchAmount) / sizeof(uintptr_t); }
+        static unsigned beginIndex() { return offsetof(BackTrackInfoBackReference, begin) / sizeof(uintptr_t); }
+        static unsigned matchAmountIndex() { return offsetof(BackTrackInfoBackReference, matchAmount) / sizeof(uintptr_t); }
     };
 
     struct BackTrackInfoAlternative {
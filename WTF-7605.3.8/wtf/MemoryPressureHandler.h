@@ -77,6 +77,8 @@ public:
     {
         m_lowMemoryHandler = WTFMove(handler);
     }
+    // Lets a client that installs its own handler call the one it replaces.
+    LowMemoryHandler takeLowMemoryHandler() { return WTFMove(m_lowMemoryHandler); }
 
     bool isUnderMemoryPressure() const
     {
@@ -14,6 +14,12 @@
 
 #include "WTFString.h"
 
+#if COMPILER(GCC_OR_CLANG) && CPU(X86_SSE2)
+#include <emmintrin.h>
+#elif COMPILER(GCC_OR_CLANG) && CPU(ARM64)
+#include <arm_neon.h>
+#endif
+
 namespace WTF {
 
 // This table driven escaping is ported from SpiderMonkey.
@@ -52,27 +58,66 @@ static const constexpr LChar escapedFormsForJSON[0x100] = {
     0,   0,   0,   0,   0,   0,   0,   0,
 };
 
+template<typename OutputCharacterType, typename InputCharacterType>
+ALWAYS_INLINE static void appendQuotedJSONCharacter(OutputCharacterType*& output, InputCharacterType character)
+{
+    auto escaped = escapedFormsForJSON[character & 0xFF];
+    if (LIKELY(!escaped || character > 0xFF)) {
+        *output++ = character;
+        return;
+    }
+
+    *output++ = '\\';
+    *output++ = escaped;
+    if (UNLIKELY(escaped == 'u')) {
+        *output++ = '0';
+        *output++ = '0';
+        *output++ = upperNibbleToLowercaseASCIIHexDigit(character);
+        *output++ = lowerNibbleToLowercaseASCIIHexDigit(character);
+    }
+}
+
 template<typename OutputCharacterType, typename InputCharacterType>
 ALWAYS_INLINE static void appendQuotedJSONStringInternal(OutputCharacterType*& output, const InputCharacterType* input, unsigned length)
 {
-    for (auto* end = input + length; input != end; ++input) {
-        auto character = *input;
-        auto escaped = escapedFormsForJSON[character & 0xFF];
-        if (LIKELY(!escaped || character > 0xFF)) {
-            *output++ = character;
-            continue;
-        }
+    for (auto* end = input + length; input != end; ++input)
+        appendQuotedJSONCharacter(output, *input);
+}
 
-        *output++ = '\\';
-        *output++ = escaped;
-        if (UNLIKELY(escaped == 'u')) {
-            *output++ = '0';
-            *output++ = '0';
-            *output++ = upperNibbleToLowercaseASCIIHexDigit(character);
-            *output++ = lowerNibbleToLowercaseASCIIHexDigit(character);
-        }
+#if COMPILER(GCC_OR_CLANG) && (CPU(X86_SSE2) || CPU(ARM64))
+// Most 8-bit strings need few escapes, so copy them 16 characters at a time up to the next character
+// that needs one. The caller reserved 6 output characters per input character, so storing a whole
+// vector past the escape is safe.
+ALWAYS_INLINE static void appendQuotedJSONStringInternal(LChar*& output, const LChar* input, unsigned length)
+{
+    const size_t stride = 16;
+    const LChar* end = input + length;
+    while (static_cast<size_t>(end - input) >= stride) {
+#if CPU(X86_SSE2)
+        __m128i characters = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input));
+        __m128i controlCharacters = _mm_cmpeq_epi8(_mm_subs_epu8(characters, _mm_set1_epi8(0x1F)), _mm_setzero_si128());
+        __m128i quotesOrBackslashes = _mm_or_si128(_mm_cmpeq_epi8(characters, _mm_set1_epi8('"')), _mm_cmpeq_epi8(characters, _mm_set1_epi8('\\')));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output), characters);
+        unsigned mask = _mm_movemask_epi8(_mm_or_si128(controlCharacters, quotesOrBackslashes));
+        size_t unescapedLength = mask ? __builtin_ctz(mask) : stride;
+#else
+        uint8x16_t characters = vld1q_u8(input);
+        uint8x16_t controlCharacters = vcleq_u8(characters, vdupq_n_u8(0x1F));
+        uint8x16_t quotesOrBackslashes = vorrq_u8(vceqq_u8(characters, vdupq_n_u8('"')), vceqq_u8(characters, vdupq_n_u8('\\')));
+        vst1q_u8(output, characters);
+        // NEON has no instruction that gathers one bit per lane, so narrow each lane to four bits.
+        uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(vorrq_u8(controlCharacters, quotesOrBackslashes)), 4)), 0);
+        size_t unescapedLength = mask ? __builtin_ctzll(mask) / 4 : stride;
+#endif
+        output += unescapedLength;
+        input += unescapedLength;
+        if (unescapedLength < stride)
+            appendQuotedJSONCharacter(output, *input++);
     }
+    for (; input != end; ++input)
+        appendQuotedJSONCharacter(output, *input);
 }
+#endif
 
 bool StringBuilder::appendQuotedJSONString(const String& string)
 {
@@ -54,7 +54,7 @@ inline std::tuple<int, std::optional<int>> toSystemSignal(Signal signal)
     switch (signal) {
     case Signal::BadAccess: return std::make_tuple(SIGSEGV, SIGBUS);
     case Signal::Ill: return std::make_tuple(SIGILL, std::nullopt);
-    case Signal::Usr: return std::make_tuple(SIGILL, std::nullopt);
+    case Signal::Usr: return std::make_tuple(SIGUSR2, std::nullopt);
     default: break;
     }
     RELEASE_ASSERT_NOT_REACHED();